@@ -0,0 +1,110 @@
+/**
+ * Fundamentals :: Benchmarks :: Benchmark Data
+ * Author: Quinn Mortimer
+ *
+ * This file contains the pieces shared by all of the benchmarks: the sizes
+ * they run at, and the keys and values they fill the containers with.
+ */
+/**
+ * Every benchmark takes the number of elements as its only argument, and runs
+ * at every power of ten from 100 up to FUNDAMENTALS_BENCH_MAX_SIZE (which the
+ * build sets, see Benchmarks/CMakeLists.txt).
+ *
+ * The keys are the numbers 0, 1, 2... scrambled by multiplying them by a large
+ * odd number. Multiplying by an odd number can be undone, so no two numbers
+ * below 2^32 scramble to the same key, but consecutive numbers end up far
+ * apart. That keeps the hash maps from seeing their keys in a neat order that
+ * real keys wouldn't have. Keys for lookups that should miss are made from
+ * the numbers after the ones that were inserted, so they are never present.
+ *
+ * The string keys are the scrambled number with a prefix in front, which makes
+ * them long enough that std::string keeps them on the heap rather than inside
+ * the string itself, like most real string keys.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#ifndef Fundamentals_BenchmarkData_hpp_
+#define Fundamentals_BenchmarkData_hpp_
+
+#ifndef FUNDAMENTALS_BENCH_MAX_SIZE
+#define FUNDAMENTALS_BENCH_MAX_SIZE 100000000
+#endif
+
+// The first size benchmarked, and the factor between each size and the next
+#define FUNDAMENTALS_BENCH_MIN_SIZE 100
+#define FUNDAMENTALS_BENCH_SIZE_STEP 10
+
+/**
+ * Adds every benchmarked size as an argument to a benchmark.
+ * @param	bench	The benchmark to add the sizes to
+ */
+inline void benchSizes(benchmark::internal::Benchmark* bench) {
+	for (int64_t size = FUNDAMENTALS_BENCH_MIN_SIZE; size <= FUNDAMENTALS_BENCH_MAX_SIZE; size *= FUNDAMENTALS_BENCH_SIZE_STEP) {
+		bench->Arg(size);
+	}
+}
+
+/**
+ * Scrambles a number so that consecutive numbers are far apart.
+ * @param	index	The number to scramble
+ * @return	The scrambled number, which is different for every index below 2^32
+ */
+inline uint32_t benchScramble(size_t index) {
+	return static_cast<uint32_t>(index) * 2654435761u;
+}
+
+/**
+ * Makes the key or value for a given number.
+ * This is only declared here, and specialised for each type that is used.
+ * @param	index	The number to make a key for
+ * @return	The key
+ */
+template <typename T>
+T benchKey(size_t index);
+
+template <>
+inline int benchKey<int>(size_t index) {
+	return static_cast<int>(benchScramble(index));
+}
+
+template <>
+inline std::string benchKey<std::string>(size_t index) {
+	return "fundamentals:" + std::to_string(benchScramble(index));
+}
+
+/**
+ * Makes the keys for a range of numbers.
+ * @param	first	The first number to make a key for
+ * @param	count	How many keys to make
+ * @return	The keys for first, first + 1, ..., first + count - 1
+ */
+template <typename T>
+std::vector<T> benchKeys(size_t first, size_t count) {
+	std::vector<T> keys;
+	keys.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		keys.push_back(benchKey<T>(first + i));
+	}
+	return keys;
+}
+
+/**
+ * Gives a number that depends on an element, so that a benchmark can add up
+ * everything it visits and the compiler can't skip the visits.
+ * @param	value	The element visited
+ * @return	A number taken from the element
+ */
+inline size_t benchTouch(int value) {
+	return static_cast<size_t>(value);
+}
+inline size_t benchTouch(const std::string& value) {
+	return value.size();
+}
+
+#endif // Fundamentals_BenchmarkData_hpp_
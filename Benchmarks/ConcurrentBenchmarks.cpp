@@ -0,0 +1,155 @@
+/**
+ * Fundamentals :: Benchmarks :: Concurrent Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks the hash maps that can be shared between threads, at
+ * every power of two from 1 to 64 threads.
+ */
+/**
+ * ConcurrentHashMap and ReadMostlyHashMap are compared against what they are
+ * meant to replace, a std::unordered_map behind a single reader-writer lock.
+ * Every thread works on the same map, which thread 0 fills before the timing
+ * starts. Google Benchmark waits for all of the threads to be ready before
+ * any of them begin, so none of them can see the map half-filled.
+ *
+ * There are two workloads. One only looks keys up, and the other changes one
+ * key for every nine that it looks up. ReadMostlyHashMap copies the whole
+ * table for every change, so it is only run with the first.
+ *
+ * The items processed counter is per thread, so Google Benchmark reports the
+ * total across all threads as the throughput.
+ */
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "ConcurrentHashMap.hpp"
+#include "ReadMostlyHashMap.hpp"
+
+// The number of keys in the shared map
+#define FUNDAMENTALS_BENCH_CONCURRENT_KEYS 100000
+// The number of operations each thread makes per iteration
+#define FUNDAMENTALS_BENCH_CONCURRENT_BATCH 1000
+// One in this many operations changes a key in the mixed workload
+#define FUNDAMENTALS_BENCH_CONCURRENT_WRITE_EVERY 10
+
+/**
+ * A std::unordered_map with a single lock around it.
+ */
+class LockedUnorderedMap {
+	public:
+		bool find(int key, int& out) const {
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+			auto entry = m_map.find(key);
+			if (entry == m_map.end()) {
+				return false;
+			}
+			out = entry->second;
+			return true;
+		}
+		void set(int key, int value) {
+			std::unique_lock<std::shared_mutex> lock(m_mutex);
+			m_map[key] = value;
+		}
+		
+	private:
+		mutable std::shared_mutex m_mutex;
+		std::unordered_map<int, int> m_map;
+};
+
+// Changing a key, under the name each map gives it
+void benchSet(LockedUnorderedMap& map, int key, int value) {
+	map.set(key, value);
+}
+void benchSet(ConcurrentHashMap<int, int>& map, int key, int value) {
+	map.insert_or_assign(key, value);
+}
+void benchSet(ReadMostlyHashMap<int, int>& map, int key, int value) {
+	map.set(key, value);
+}
+
+/**
+ * Makes the shared map for a benchmark, filled with every key.
+ * @return	The filled map
+ */
+template <typename Map>
+std::unique_ptr<Map> benchSharedMap() {
+	std::unique_ptr<Map> map(new Map());
+	for (size_t i = 0; i < FUNDAMENTALS_BENCH_CONCURRENT_KEYS; ++i) {
+		benchSet(*map, benchKey<int>(i), static_cast<int>(i));
+	}
+	return map;
+}
+// ReadMostlyHashMap copies its table for every change, so filling it one key
+// at a time would take far too long. It is given a full table instead.
+template <>
+std::unique_ptr<ReadMostlyHashMap<int, int>> benchSharedMap<ReadMostlyHashMap<int, int>>() {
+	ReadMostlyHashMap<int, int>::table_type table;
+	for (size_t i = 0; i < FUNDAMENTALS_BENCH_CONCURRENT_KEYS; ++i) {
+		table.set(benchKey<int>(i), static_cast<int>(i));
+	}
+	return std::unique_ptr<ReadMostlyHashMap<int, int>>(new ReadMostlyHashMap<int, int>(table));
+}
+
+/**
+ * Runs the workload for one thread, on the map that thread 0 made.
+ * @param	state	The benchmark's state
+ * @param	writeEvery	One in this many operations change a key, or 0 for none
+ */
+template <typename Map>
+void benchConcurrent(benchmark::State& state, size_t writeEvery) {
+	static std::unique_ptr<Map> map;
+	if (state.thread_index() == 0) {
+		map = benchSharedMap<Map>();
+	}
+	
+	// Each thread starts at a different place in the keys
+	size_t next = state.thread_index() * (FUNDAMENTALS_BENCH_CONCURRENT_KEYS / state.threads());
+	for (auto _ : state) {
+		size_t found = 0;
+		for (size_t i = 0; i < FUNDAMENTALS_BENCH_CONCURRENT_BATCH; ++i) {
+			int key = benchKey<int>(next);
+			if (writeEvery != 0 && i % writeEvery == 0) {
+				benchSet(*map, key, static_cast<int>(i));
+			}
+			else {
+				int value;
+				found += map->find(key, value);
+			}
+			next = (next + 1) % FUNDAMENTALS_BENCH_CONCURRENT_KEYS;
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * FUNDAMENTALS_BENCH_CONCURRENT_BATCH);
+	
+	if (state.thread_index() == 0) {
+		map.reset();
+	}
+}
+
+/**
+ * Measures threads that only look keys up.
+ */
+template <typename Map>
+void BM_ConcurrentRead(benchmark::State& state) {
+	benchConcurrent<Map>(state, 0);
+}
+
+/**
+ * Measures threads that mostly look keys up, but sometimes change them.
+ */
+template <typename Map>
+void BM_ConcurrentMixed(benchmark::State& state) {
+	benchConcurrent<Map>(state, FUNDAMENTALS_BENCH_CONCURRENT_WRITE_EVERY);
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentRead, LockedUnorderedMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentRead, ConcurrentHashMap<int, int>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentRead, ReadMostlyHashMap<int, int>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentMixed, LockedUnorderedMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentMixed, ConcurrentHashMap<int, int>)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,134 @@
+/**
+ * Fundamentals :: Benchmarks :: Euclidean Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks the GCD and modular inverse functions in Euclidean.hpp
+ * against std::gcd.
+ */
+/**
+ * Every benchmark runs over arrays of random 64-bit numbers, made from the
+ * same seed each time. The scalar functions are called on each pair in a
+ * loop, and are wrapped in small function objects so that one benchmark
+ * template can run all of them. gcdMany is run on one thread, to compare its
+ * lanes with binaryGcd in a loop, and on every hardware thread.
+ */
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "DynamicArray.hpp"
+#include "Euclidean.hpp"
+
+// The modulus the modular inverse benchmarks use, which is prime.
+#define FUNDAMENTALS_BENCH_MODULUS 1000000007
+
+// ------------- //
+// GCD Functions //
+// ------------- //
+struct StdGcdFunction {
+	uint64_t operator()(uint64_t a, uint64_t b) const {
+		return std::gcd(a, b);
+	}
+};
+struct EuclideanGcdFunction {
+	uint64_t operator()(uint64_t a, uint64_t b) const {
+		return gcd(a, b);
+	}
+};
+struct BinaryGcdFunction {
+	uint64_t operator()(uint64_t a, uint64_t b) const {
+		return binaryGcd(a, b);
+	}
+};
+
+/**
+ * Makes an array of random 64-bit numbers.
+ * @param	size	The number of numbers
+ * @param	seed	The seed to make them from
+ * @return	The numbers
+ */
+inline DynamicArray<uint64_t> benchNumbers(size_t size, uint64_t seed) {
+	std::mt19937_64 random(seed);
+	DynamicArray<uint64_t> numbers(size);
+	for (size_t i = 0; i < size; ++i) {
+		numbers[i] = random();
+	}
+	return numbers;
+}
+
+// ---------- //
+// Benchmarks //
+// ---------- //
+/**
+ * Measures finding the GCD of each pair of numbers one at a time.
+ */
+template <typename Function>
+void BM_Gcd(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const DynamicArray<uint64_t> a = benchNumbers(size, 1);
+	const DynamicArray<uint64_t> b = benchNumbers(size, 2);
+	DynamicArray<uint64_t> divisors(size);
+	for (auto _ : state) {
+		for (size_t i = 0; i < size; ++i) {
+			divisors[i] = Function()(a[i], b[i]);
+		}
+		benchmark::DoNotOptimize(divisors.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures finding the GCD of every pair of numbers with gcdMany.
+ */
+void BM_GcdMany(benchmark::State& state, size_t threads) {
+	const size_t size = state.range(0);
+	const DynamicArray<uint64_t> a = benchNumbers(size, 1);
+	const DynamicArray<uint64_t> b = benchNumbers(size, 2);
+	for (auto _ : state) {
+		DynamicArray<uint64_t> divisors = gcdMany(a, b, threads);
+		benchmark::DoNotOptimize(divisors.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures finding the inverse of each number one at a time.
+ */
+void BM_ModularInverse(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const DynamicArray<uint64_t> values = benchNumbers(size, 3);
+	DynamicArray<uint64_t> inverses(size);
+	for (auto _ : state) {
+		for (size_t i = 0; i < size; ++i) {
+			inverses[i] = modularInverse(values[i], FUNDAMENTALS_BENCH_MODULUS);
+		}
+		benchmark::DoNotOptimize(inverses.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures finding the inverse of every number with modularInverseMany on
+ * every hardware thread.
+ */
+void BM_ModularInverseMany(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const DynamicArray<uint64_t> values = benchNumbers(size, 3);
+	for (auto _ : state) {
+		DynamicArray<uint64_t> inverses = modularInverseMany(values, FUNDAMENTALS_BENCH_MODULUS);
+		benchmark::DoNotOptimize(inverses.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK_TEMPLATE(BM_Gcd, StdGcdFunction)->Apply(benchSizes);
+BENCHMARK_TEMPLATE(BM_Gcd, EuclideanGcdFunction)->Apply(benchSizes);
+BENCHMARK_TEMPLATE(BM_Gcd, BinaryGcdFunction)->Apply(benchSizes);
+BENCHMARK_CAPTURE(BM_GcdMany, single_thread, 1)->Apply(benchSizes);
+BENCHMARK_CAPTURE(BM_GcdMany, all_threads, 0)->Apply(benchSizes)->UseRealTime();
+BENCHMARK(BM_ModularInverse)->Apply(benchSizes);
+BENCHMARK(BM_ModularInverseMany)->Apply(benchSizes)->UseRealTime();
@@ -0,0 +1,174 @@
+/**
+ * Fundamentals :: Benchmarks :: Graph Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks building a Graph and running the algorithms in
+ * GraphAlgorithms.hpp on it.
+ */
+/**
+ * The standard road network datasets (such as those from the 9th DIMACS
+ * implementation challenge, like USA-road-d.NY.gr) are too large to keep in
+ * the repository. To benchmark on one, set the environment variable
+ * FUNDAMENTALS_BENCH_GRAPH to the path of its .gr file, and every benchmark
+ * is also registered with "dimacs" in its name, running on that graph.
+ *
+ * Otherwise the graphs are square grids at each benchmarked number of
+ * vertices, with edges both ways between neighbours and scrambled weights
+ * from 1 to 1000. Like a road network, a grid has few edges per vertex and a
+ * large diameter, which is what makes the frontiers of these searches small
+ * and their number of levels large.
+ *
+ * Every search starts from vertex 0. The graph for each size is only built
+ * once and kept for all the benchmarks that use it, except for the benchmark
+ * of building it.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "DynamicArray.hpp"
+#include "Graph.hpp"
+#include "GraphAlgorithms.hpp"
+
+// The environment variable giving a DIMACS graph to benchmark on
+#define FUNDAMENTALS_BENCH_GRAPH_VARIABLE "FUNDAMENTALS_BENCH_GRAPH"
+
+/**
+ * Makes the edges of a square grid with about a number of vertices.
+ * @param	size	The number of vertices wanted
+ * @param	vertices	Set to the number of vertices in the grid
+ * @return	The edges of the grid
+ */
+inline DynamicArray<Graph_Edge<uint32_t>> benchGridEdges(size_t size, size_t& vertices) {
+	const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(size)));
+	vertices = side * side;
+	
+	DynamicArray<Graph_Edge<uint32_t>> edges;
+	edges.reserve(4 * vertices);
+	auto add = [&](size_t from, size_t to) {
+		uint32_t weight = 1 + benchScramble(edges.size()) % 1000;
+		edges.push_back(Graph_Edge<uint32_t>{static_cast<uint32_t>(from), static_cast<uint32_t>(to), weight});
+		edges.push_back(Graph_Edge<uint32_t>{static_cast<uint32_t>(to), static_cast<uint32_t>(from), weight});
+	};
+	for (size_t row = 0; row < side; ++row) {
+		for (size_t column = 0; column < side; ++column) {
+			size_t v = row * side + column;
+			if (column + 1 < side) {
+				add(v, v + 1);
+			}
+			if (row + 1 < side) {
+				add(v, v + side);
+			}
+		}
+	}
+	
+	return edges;
+}
+
+/**
+ * Gives the graph a benchmark runs on, building it the first time.
+ * @param	size	The number of vertices of the grid, or 0 for the DIMACS
+ * 	graph
+ * @return	The graph
+ */
+inline const Graph<uint32_t>& benchGraph(size_t size) {
+	static std::map<size_t, std::unique_ptr<Graph<uint32_t>>> graphs;
+	
+	std::unique_ptr<Graph<uint32_t>>& graph = graphs[size];
+	if (!graph) {
+		// Only the latest graph is kept, since the largest take gigabytes
+		for (auto& entry : graphs) {
+			entry.second.reset();
+		}
+		if (size == 0) {
+			graph.reset(new Graph<uint32_t>(loadDimacsGraph(std::getenv(FUNDAMENTALS_BENCH_GRAPH_VARIABLE))));
+		}
+		else {
+			size_t vertices = 0;
+			DynamicArray<Graph_Edge<uint32_t>> edges = benchGridEdges(size, vertices);
+			graph.reset(new Graph<uint32_t>(vertices, edges));
+		}
+	}
+	
+	return *graph;
+}
+
+// ----------- //
+// Benchmarks //
+// ----------- //
+/**
+ * Measures building a grid graph from its list of edges.
+ */
+void BM_GraphBuild(benchmark::State& state) {
+	size_t vertices = 0;
+	const DynamicArray<Graph_Edge<uint32_t>> edges = benchGridEdges(state.range(0), vertices);
+	for (auto _ : state) {
+		Graph<uint32_t> graph(vertices, edges);
+		benchmark::DoNotOptimize(graph.edgeCount());
+	}
+	state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+/**
+ * Measures finding the shortest paths to every vertex with dijkstra.
+ */
+void BM_Dijkstra(benchmark::State& state) {
+	const Graph<uint32_t>& graph = benchGraph(state.range(0));
+	for (auto _ : state) {
+		GraphPaths<uint32_t> paths = dijkstra(graph, 0);
+		benchmark::DoNotOptimize(paths.distances.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+/**
+ * Measures a breadth-first search from one vertex, on every hardware thread.
+ */
+void BM_BreadthFirstSearch(benchmark::State& state) {
+	const Graph<uint32_t>& graph = benchGraph(state.range(0));
+	for (auto _ : state) {
+		DynamicArray<uint32_t> levels = breadthFirstSearch(graph, 0);
+		benchmark::DoNotOptimize(levels.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+/**
+ * Measures finding the shortest distances to every vertex with bellmanFord,
+ * on every hardware thread.
+ */
+void BM_BellmanFord(benchmark::State& state) {
+	const Graph<uint32_t>& graph = benchGraph(state.range(0));
+	for (auto _ : state) {
+		DynamicArray<uint32_t> distances = bellmanFord(graph, 0);
+		benchmark::DoNotOptimize(distances.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+// Registers each benchmark at every size
+BENCHMARK(BM_GraphBuild)->Apply(benchSizes);
+BENCHMARK(BM_Dijkstra)->Apply(benchSizes);
+BENCHMARK(BM_BreadthFirstSearch)->Apply(benchSizes)->UseRealTime();
+BENCHMARK(BM_BellmanFord)->Apply(benchSizes)->UseRealTime();
+
+/**
+ * Registers the benchmarks on the DIMACS graph, if there is one.
+ */
+static const bool benchDimacsRegistered = []() {
+	if (std::getenv(FUNDAMENTALS_BENCH_GRAPH_VARIABLE) == nullptr) {
+		return false;
+	}
+	
+	benchmark::RegisterBenchmark("BM_Dijkstra/dimacs", BM_Dijkstra)->Arg(0);
+	benchmark::RegisterBenchmark("BM_BreadthFirstSearch/dimacs", BM_BreadthFirstSearch)->Arg(0)->UseRealTime();
+	benchmark::RegisterBenchmark("BM_BellmanFord/dimacs", BM_BellmanFord)->Arg(0)->UseRealTime();
+	return true;
+}();
@@ -0,0 +1,573 @@
+/**
+ * Fundamentals :: Benchmarks :: Hash Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks HashMap and RobinHoodHashMap against
+ * std::unordered_map, and HashSet against std::unordered_set.
+ */
+/**
+ * HashMap is benchmarked with each of its probing policies. The two kinds of
+ * container have different names for the same operations (insert versus
+ * emplace, remove versus erase), so the benchmarks call small overloaded
+ * functions that pick the right one for each.
+ *
+ * Neither HashMap nor HashSet has iterators, so iterating over them means
+ * fetching their values or elements as a vector, which is what code using
+ * them has to do. The batched lookups (find_many and contains_many) are
+ * benchmarked on their own, to compare with looking up the same keys one at
+ * a time.
+ *
+ * Building a container from a whole range at once is compared with inserting
+ * the same keys one at a time, and HashMap and HashSet are also built with
+ * insert_range hashing the keys on every hardware thread.
+ *
+ * The two probing policies are also compared at fixed load factors. A map
+ * grows as keys are added, so the ordinary benchmarks see whatever load each
+ * size happens to leave it at. The load benchmarks instead fill an array of a
+ * fixed capacity to each load from 0.5 up to 0.875, which is the load Swiss
+ * tables like SimdProbe are built for, and then time lookups that hit and
+ * miss.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "HashMap.hpp"
+#include "HashProbes.hpp"
+#include "HashSet.hpp"
+#include "RobinHoodHashMap.hpp"
+
+// Maps from each key type to int, so the registration macros below only have
+// a single parameter to fill in
+template <typename Key>
+using PerturbHashMap = HashMap<Key, int, PerturbProbe>;
+template <typename Key>
+using SimdHashMap = HashMap<Key, int, SimdProbe>;
+template <typename Key>
+using RobinHoodMap = RobinHoodHashMap<Key, int>;
+template <typename Key>
+using StdUnorderedMap = std::unordered_map<Key, int>;
+
+// -------------- //
+// Map Operations //
+// -------------- //
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void benchInsert(HashMap<Key, Value, Probe, Hash, Allocator>& map, const Key& key, const Value& value) {
+	map.insert(key, value);
+}
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void benchInsert(RobinHoodHashMap<Key, Value, Hash, Allocator>& map, const Key& key, const Value& value) {
+	map.insert(key, value);
+}
+template <typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void benchInsert(std::unordered_map<Key, Value, Hash, Equal, Allocator>& map, const Key& key, const Value& value) {
+	map.emplace(key, value);
+}
+
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool benchFind(const HashMap<Key, Value, Probe, Hash, Allocator>& map, const Key& key) {
+	return map.find(key) != nullptr;
+}
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool benchFind(const RobinHoodHashMap<Key, Value, Hash, Allocator>& map, const Key& key) {
+	return map.find(key) != nullptr;
+}
+template <typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+bool benchFind(const std::unordered_map<Key, Value, Hash, Equal, Allocator>& map, const Key& key) {
+	return map.find(key) != map.end();
+}
+
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void benchErase(HashMap<Key, Value, Probe, Hash, Allocator>& map, const Key& key) {
+	map.remove(key);
+}
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void benchErase(RobinHoodHashMap<Key, Value, Hash, Allocator>& map, const Key& key) {
+	map.remove(key);
+}
+template <typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+void benchErase(std::unordered_map<Key, Value, Hash, Equal, Allocator>& map, const Key& key) {
+	map.erase(key);
+}
+
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+size_t benchIterate(const HashMap<Key, Value, Probe, Hash, Allocator>& map) {
+	size_t total = 0;
+	for (const Value& value : map.values()) {
+		total += benchTouch(value);
+	}
+	return total;
+}
+template <typename Key, typename Value, typename Hash, typename Allocator>
+size_t benchIterate(const RobinHoodHashMap<Key, Value, Hash, Allocator>& map) {
+	size_t total = 0;
+	for (const Value& value : map.values()) {
+		total += benchTouch(value);
+	}
+	return total;
+}
+template <typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+size_t benchIterate(const std::unordered_map<Key, Value, Hash, Equal, Allocator>& map) {
+	size_t total = 0;
+	for (const auto& entry : map) {
+		total += benchTouch(entry.second);
+	}
+	return total;
+}
+
+// -------------- //
+// Set Operations //
+// -------------- //
+template <typename T, typename Hash, typename Allocator>
+void benchInsert(HashSet<T, Hash, Allocator>& set, const T& elem) {
+	set.insert(elem);
+}
+template <typename T, typename Hash, typename Equal, typename Allocator>
+void benchInsert(std::unordered_set<T, Hash, Equal, Allocator>& set, const T& elem) {
+	set.insert(elem);
+}
+
+template <typename T, typename Hash, typename Allocator>
+bool benchFind(const HashSet<T, Hash, Allocator>& set, const T& elem) {
+	return set.contains(elem);
+}
+template <typename T, typename Hash, typename Equal, typename Allocator>
+bool benchFind(const std::unordered_set<T, Hash, Equal, Allocator>& set, const T& elem) {
+	return set.find(elem) != set.end();
+}
+
+template <typename T, typename Hash, typename Allocator>
+void benchErase(HashSet<T, Hash, Allocator>& set, const T& elem) {
+	set.remove(elem);
+}
+template <typename T, typename Hash, typename Equal, typename Allocator>
+void benchErase(std::unordered_set<T, Hash, Equal, Allocator>& set, const T& elem) {
+	set.erase(elem);
+}
+
+template <typename T, typename Hash, typename Allocator>
+size_t benchIterate(const HashSet<T, Hash, Allocator>& set) {
+	size_t total = 0;
+	for (const T& elem : set.elements()) {
+		total += benchTouch(elem);
+	}
+	return total;
+}
+template <typename T, typename Hash, typename Equal, typename Allocator>
+size_t benchIterate(const std::unordered_set<T, Hash, Equal, Allocator>& set) {
+	size_t total = 0;
+	for (const T& elem : set) {
+		total += benchTouch(elem);
+	}
+	return total;
+}
+
+// The maps are filled with each key mapped to its position
+template <typename Map, typename Key>
+void benchAdd(Map& map, const Key& key, size_t index) {
+	benchInsert(map, key, static_cast<int>(index));
+}
+template <typename T, typename Hash, typename Allocator>
+void benchAdd(HashSet<T, Hash, Allocator>& set, const T& elem, size_t) {
+	benchInsert(set, elem);
+}
+template <typename T, typename Hash, typename Equal, typename Allocator>
+void benchAdd(std::unordered_set<T, Hash, Equal, Allocator>& set, const T& elem, size_t) {
+	benchInsert(set, elem);
+}
+
+/**
+ * Makes a map or set holding the given keys.
+ * @param	keys	The keys to add
+ * @return	The filled container
+ */
+template <typename Container, typename Key>
+Container benchFilled(const std::vector<Key>& keys) {
+	Container container;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		benchAdd(container, keys[i], i);
+	}
+	return container;
+}
+
+/**
+ * Makes the range that a map or set is built from in one go. For maps, each
+ * key is paired with its position, as with benchAdd.
+ * The container is only passed to pick the right overload.
+ * @param	keys	The keys to put in the range
+ * @return	The range
+ */
+template <typename Map, typename Key>
+std::vector<std::pair<Key, int>> benchRange(const Map*, const std::vector<Key>& keys) {
+	std::vector<std::pair<Key, int>> range;
+	range.reserve(keys.size());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		range.emplace_back(keys[i], static_cast<int>(i));
+	}
+	return range;
+}
+template <typename T, typename Hash, typename Allocator>
+std::vector<T> benchRange(const HashSet<T, Hash, Allocator>*, const std::vector<T>& keys) {
+	return keys;
+}
+template <typename T, typename Hash, typename Equal, typename Allocator>
+std::vector<T> benchRange(const std::unordered_set<T, Hash, Equal, Allocator>*, const std::vector<T>& keys) {
+	return keys;
+}
+
+// The capacities and loads, in thousandths, that the load benchmarks run at
+#define HASH_LOAD_MIN_CAPACITY (1 << 12)
+#define HASH_LOAD_MAX_CAPACITY (1 << 24)
+#define HASH_LOAD_CAPACITY_STEP 16
+#define HASH_LOAD_MIN 500
+#define HASH_LOAD_MAX 875
+#define HASH_LOAD_STEP 125
+
+/**
+ * Adds every capacity and load to a load benchmark, as pairs of arguments.
+ *
+ * The capacities stop at FUNDAMENTALS_BENCH_MAX_SIZE, like the sizes of the
+ * other benchmarks.
+ *
+ * @param	bench	The benchmark to add the arguments to
+ */
+inline void benchLoads(benchmark::internal::Benchmark* bench) {
+	bench->ArgNames({ "capacity", "load" });
+	for (int64_t capacity = HASH_LOAD_MIN_CAPACITY; capacity <= HASH_LOAD_MAX_CAPACITY && capacity <= FUNDAMENTALS_BENCH_MAX_SIZE; capacity *= HASH_LOAD_CAPACITY_STEP) {
+		for (int64_t load = HASH_LOAD_MIN; load <= HASH_LOAD_MAX; load += HASH_LOAD_STEP) {
+			bench->Args({ capacity, load });
+		}
+	}
+}
+
+/**
+ * Makes a HashMap with a given capacity, filled with keys up to a given load.
+ *
+ * The maximum load factor is raised to the highest load benchmarked, so that
+ * the array isn't grown on the way there.
+ *
+ * @param	keys	The keys to add, which must be few enough for the capacity
+ * @param	capacity	The number of slots the array should have
+ * @return	The filled map, or nothing if the array came out at another size
+ */
+template <typename Map, typename Key>
+std::optional<Map> benchLoaded(const std::vector<Key>& keys, size_t capacity) {
+	std::optional<Map> map;
+	map.emplace();
+	map->max_load_factor(HASH_LOAD_MAX / 1000.0f);
+	map->reserve(keys.size());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		benchAdd(*map, keys[i], i);
+	}
+	
+	if (map->capacity() != capacity) {
+		map.reset();
+	}
+	return map;
+}
+
+// ---------- //
+// Benchmarks //
+// ---------- //
+/**
+ * Measures adding distinct keys to an empty container.
+ */
+template <typename Container, typename Key>
+void BM_HashInsert(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace();
+		for (size_t i = 0; i < size; ++i) {
+			benchAdd(*container, keys[i], i);
+		}
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures building a container from a range of distinct keys.
+ */
+template <typename Container, typename Key>
+void BM_HashBuild(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const auto range = benchRange(static_cast<const Container*>(nullptr), benchKeys<Key>(0, size));
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace(range.begin(), range.end());
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures building a container from a range of distinct keys, hashing them
+ * on every hardware thread.
+ */
+template <typename Container, typename Key>
+void BM_HashBuildParallel(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const auto range = benchRange(static_cast<const Container*>(nullptr), benchKeys<Key>(0, size));
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace();
+		container->insert_range(range.begin(), range.end(), 0);
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up keys that are all present.
+ */
+template <typename Container, typename Key>
+void BM_HashLookupHit(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	const Container container = benchFilled<Container>(keys);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (const Key& key : keys) {
+			found += benchFind(container, key);
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up keys that are all missing.
+ */
+template <typename Container, typename Key>
+void BM_HashLookupMiss(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Container container = benchFilled<Container>(benchKeys<Key>(0, size));
+	std::vector<Key> missing = benchKeys<Key>(size, size);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (const Key& key : missing) {
+			found += benchFind(container, key);
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures removing every key from a full container.
+ */
+template <typename Container, typename Key>
+void BM_HashErase(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	const Container original = benchFilled<Container>(keys);
+	std::optional<Container> container;
+	for (auto _ : state) {
+		state.PauseTiming();
+		container.emplace(original);
+		state.ResumeTiming();
+		for (const Key& key : keys) {
+			benchErase(*container, key);
+		}
+		benchmark::DoNotOptimize(*container);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures visiting every value or element.
+ */
+template <typename Container, typename Key>
+void BM_HashIterate(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Container container = benchFilled<Container>(benchKeys<Key>(0, size));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(benchIterate(container));
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures copying a whole container.
+ */
+template <typename Container, typename Key>
+void BM_HashCopy(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Container original = benchFilled<Container>(benchKeys<Key>(0, size));
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace(original);
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up keys that are all present with HashMap::find_many.
+ */
+template <typename Map, typename Key>
+void BM_HashFindMany(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	const Map map = benchFilled<Map>(keys);
+	std::vector<const int*> results(size);
+	for (auto _ : state) {
+		map.find_many(keys.data(), size, results.data());
+		benchmark::DoNotOptimize(results.data());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up elements that are all present with
+ * HashSet::contains_many.
+ */
+template <typename Set, typename Key>
+void BM_HashContainsMany(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	const Set set = benchFilled<Set>(keys);
+	std::unique_ptr<bool[]> results(new bool[size]);
+	for (auto _ : state) {
+		set.contains_many(keys.data(), size, results.get());
+		benchmark::DoNotOptimize(results.get());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up keys that are all present, in a map filled to a load.
+ */
+template <typename Map, typename Key>
+void BM_HashLoadHit(benchmark::State& state) {
+	const size_t capacity = state.range(0);
+	const size_t size = capacity * state.range(1) / 1000;
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	const std::optional<Map> map = benchLoaded<Map>(keys, capacity);
+	if (!map) {
+		state.SkipWithError("The map did not have the expected capacity");
+		return;
+	}
+	for (auto _ : state) {
+		size_t found = 0;
+		for (const Key& key : keys) {
+			found += benchFind(*map, key);
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up keys that are all missing, in a map filled to a load.
+ */
+template <typename Map, typename Key>
+void BM_HashLoadMiss(benchmark::State& state) {
+	const size_t capacity = state.range(0);
+	const size_t size = capacity * state.range(1) / 1000;
+	const std::optional<Map> map = benchLoaded<Map>(benchKeys<Key>(0, size), capacity);
+	if (!map) {
+		state.SkipWithError("The map did not have the expected capacity");
+		return;
+	}
+	std::vector<Key> missing = benchKeys<Key>(size, size);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (const Key& key : missing) {
+			found += benchFind(*map, key);
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Registers a benchmark for a container template with both key types
+#define HASH_BENCHMARK(name, Container) \
+	BENCHMARK_TEMPLATE(name, Container<int>, int)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(name, Container<std::string>, std::string)->Apply(benchSizes)
+// The same, for benchmarks that take a capacity and a load
+#define HASH_LOAD_BENCHMARK(name, Container) \
+	BENCHMARK_TEMPLATE(name, Container<int>, int)->Apply(benchLoads); \
+	BENCHMARK_TEMPLATE(name, Container<std::string>, std::string)->Apply(benchLoads)
+// The same, for benchmarks that start threads of their own
+#define HASH_THREADED_BENCHMARK(name, Container) \
+	BENCHMARK_TEMPLATE(name, Container<int>, int)->Apply(benchSizes)->UseRealTime(); \
+	BENCHMARK_TEMPLATE(name, Container<std::string>, std::string)->Apply(benchSizes)->UseRealTime()
+
+// Maps
+HASH_BENCHMARK(BM_HashInsert, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashInsert, PerturbHashMap);
+HASH_BENCHMARK(BM_HashInsert, SimdHashMap);
+HASH_BENCHMARK(BM_HashInsert, RobinHoodMap);
+HASH_BENCHMARK(BM_HashBuild, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashBuild, PerturbHashMap);
+HASH_BENCHMARK(BM_HashBuild, SimdHashMap);
+HASH_THREADED_BENCHMARK(BM_HashBuildParallel, PerturbHashMap);
+HASH_THREADED_BENCHMARK(BM_HashBuildParallel, SimdHashMap);
+HASH_BENCHMARK(BM_HashLookupHit, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashLookupHit, PerturbHashMap);
+HASH_BENCHMARK(BM_HashLookupHit, SimdHashMap);
+HASH_BENCHMARK(BM_HashLookupHit, RobinHoodMap);
+HASH_BENCHMARK(BM_HashLookupMiss, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashLookupMiss, PerturbHashMap);
+HASH_BENCHMARK(BM_HashLookupMiss, SimdHashMap);
+HASH_BENCHMARK(BM_HashLookupMiss, RobinHoodMap);
+HASH_BENCHMARK(BM_HashErase, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashErase, PerturbHashMap);
+HASH_BENCHMARK(BM_HashErase, SimdHashMap);
+HASH_BENCHMARK(BM_HashErase, RobinHoodMap);
+HASH_BENCHMARK(BM_HashIterate, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashIterate, PerturbHashMap);
+HASH_BENCHMARK(BM_HashIterate, SimdHashMap);
+HASH_BENCHMARK(BM_HashIterate, RobinHoodMap);
+HASH_BENCHMARK(BM_HashCopy, StdUnorderedMap);
+HASH_BENCHMARK(BM_HashCopy, PerturbHashMap);
+HASH_BENCHMARK(BM_HashCopy, SimdHashMap);
+HASH_BENCHMARK(BM_HashCopy, RobinHoodMap);
+HASH_BENCHMARK(BM_HashFindMany, PerturbHashMap);
+HASH_BENCHMARK(BM_HashFindMany, SimdHashMap);
+HASH_BENCHMARK(BM_HashFindMany, RobinHoodMap);
+HASH_LOAD_BENCHMARK(BM_HashLoadHit, PerturbHashMap);
+HASH_LOAD_BENCHMARK(BM_HashLoadHit, SimdHashMap);
+HASH_LOAD_BENCHMARK(BM_HashLoadMiss, PerturbHashMap);
+HASH_LOAD_BENCHMARK(BM_HashLoadMiss, SimdHashMap);
+
+// Sets
+HASH_BENCHMARK(BM_HashInsert, std::unordered_set);
+HASH_BENCHMARK(BM_HashInsert, HashSet);
+HASH_BENCHMARK(BM_HashBuild, std::unordered_set);
+HASH_BENCHMARK(BM_HashBuild, HashSet);
+HASH_THREADED_BENCHMARK(BM_HashBuildParallel, HashSet);
+HASH_BENCHMARK(BM_HashLookupHit, std::unordered_set);
+HASH_BENCHMARK(BM_HashLookupHit, HashSet);
+HASH_BENCHMARK(BM_HashLookupMiss, std::unordered_set);
+HASH_BENCHMARK(BM_HashLookupMiss, HashSet);
+HASH_BENCHMARK(BM_HashErase, std::unordered_set);
+HASH_BENCHMARK(BM_HashErase, HashSet);
+HASH_BENCHMARK(BM_HashIterate, std::unordered_set);
+HASH_BENCHMARK(BM_HashIterate, HashSet);
+HASH_BENCHMARK(BM_HashCopy, std::unordered_set);
+HASH_BENCHMARK(BM_HashCopy, HashSet);
+HASH_BENCHMARK(BM_HashContainsMany, HashSet);
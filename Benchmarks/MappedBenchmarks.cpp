@@ -0,0 +1,109 @@
+/**
+ * Fundamentals :: Benchmarks :: Mapped Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks opening and using DynamicArray and HashMap files saved
+ * for MappedArray and MappedHashMap.
+ */
+/**
+ * Opening a saved map is meant to replace building the map again, so it is
+ * benchmarked at the same sizes as BM_HashBuild in HashBenchmarks.cpp, and
+ * lookups in it are benchmarked the same way as BM_HashLookupHit. Only int
+ * keys are used, since strings can't be saved.
+ *
+ * Each benchmark saves its file in the working directory before it starts
+ * timing, and removes it at the end. The file will usually still be in the
+ * page cache from being written, so these measure the mapping rather than the
+ * disk.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "DynamicArray.hpp"
+#include "HashMap.hpp"
+#include "MappedArray.hpp"
+#include "MappedHashMap.hpp"
+
+// The file each benchmark saves to
+#define MAPPED_BENCH_PATH "fundamentals_bench_mapped.bin"
+
+/**
+ * Saves a map of the keys for a number of elements, each mapped to its index.
+ * @param	size	The number of keys
+ * @return	The keys, in the order they were inserted
+ */
+inline std::vector<int> mappedBenchSaveMap(size_t size) {
+	std::vector<int> keys = benchKeys<int>(0, size);
+	HashMap<int, int> map;
+	for (size_t i = 0; i < size; ++i) {
+		map.insert(keys[i], static_cast<int>(i));
+	}
+	map.save(MAPPED_BENCH_PATH);
+	return keys;
+}
+
+// ----------- //
+// Benchmarks //
+// ----------- //
+/**
+ * Measures opening a saved map.
+ */
+void BM_MappedHashMapOpen(benchmark::State& state) {
+	mappedBenchSaveMap(state.range(0));
+	for (auto _ : state) {
+		MappedHashMap<int, int> map(MAPPED_BENCH_PATH);
+		benchmark::DoNotOptimize(map.size());
+	}
+	std::remove(MAPPED_BENCH_PATH);
+}
+
+/**
+ * Measures looking up keys that are all present in a saved map, including
+ * reading in the pages of the file on the first pass.
+ */
+void BM_MappedHashMapLookupHit(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const std::vector<int> keys = mappedBenchSaveMap(size);
+	const MappedHashMap<int, int> map(MAPPED_BENCH_PATH);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (int key : keys) {
+			found += map.find(key) != nullptr;
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+	std::remove(MAPPED_BENCH_PATH);
+}
+
+/**
+ * Measures opening a saved array and adding up all of its elements.
+ */
+void BM_MappedArrayOpenAndSum(benchmark::State& state) {
+	const size_t size = state.range(0);
+	DynamicArray<int> array;
+	for (int key : benchKeys<int>(0, size)) {
+		array.push_back(key);
+	}
+	array.save(MAPPED_BENCH_PATH);
+	for (auto _ : state) {
+		const MappedArray<int> mapped(MAPPED_BENCH_PATH);
+		size_t total = 0;
+		for (int value : mapped) {
+			total += benchTouch(value);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+	std::remove(MAPPED_BENCH_PATH);
+}
+
+// Registers each benchmark at every size
+BENCHMARK(BM_MappedHashMapOpen)->Apply(benchSizes);
+BENCHMARK(BM_MappedHashMapLookupHit)->Apply(benchSizes);
+BENCHMARK(BM_MappedArrayOpenAndSum)->Apply(benchSizes);
@@ -0,0 +1,220 @@
+/**
+ * Fundamentals :: Benchmarks :: Ordered Map Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks BTreeMap against std::map.
+ */
+/**
+ * Both maps are benchmarked on inserting keys one at a time, building from a
+ * whole range at once, looking up keys that are present, walking through
+ * every key in order, and scanning short ranges of keys from a starting key.
+ * The two have different names for the same operations, so the benchmarks
+ * call small overloaded functions that pick the right one for each, as in
+ * HashBenchmarks.cpp.
+ */
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BTreeMap.hpp"
+#include "BenchmarkData.hpp"
+
+// The number of keys visited from each starting key in BM_OrderedRangeScan.
+#define FUNDAMENTALS_BENCH_SCAN_LENGTH 100
+// The number of starting keys BM_OrderedRangeScan scans from.
+#define FUNDAMENTALS_BENCH_SCAN_COUNT 1000
+
+// Maps from each key type to int, so the registration macro below only has a
+// single parameter to fill in
+template <typename Key>
+using BTreeOrderedMap = BTreeMap<Key, int>;
+template <typename Key>
+using StdMap = std::map<Key, int>;
+
+// -------------- //
+// Map Operations //
+// -------------- //
+template <typename Key, typename Value, typename Compare>
+void benchInsert(BTreeMap<Key, Value, Compare>& map, const Key& key, const Value& value) {
+	map.insert(key, value);
+}
+template <typename Key, typename Value, typename Compare, typename Allocator>
+void benchInsert(std::map<Key, Value, Compare, Allocator>& map, const Key& key, const Value& value) {
+	map.emplace(key, value);
+}
+
+template <typename Key, typename Value, typename Compare>
+bool benchFind(const BTreeMap<Key, Value, Compare>& map, const Key& key) {
+	return map.find(key) != nullptr;
+}
+template <typename Key, typename Value, typename Compare, typename Allocator>
+bool benchFind(const std::map<Key, Value, Compare, Allocator>& map, const Key& key) {
+	return map.find(key) != map.end();
+}
+
+template <typename Key, typename Value, typename Compare>
+size_t benchIterate(const BTreeMap<Key, Value, Compare>& map) {
+	size_t total = 0;
+	for (auto it = map.begin(); it != map.end(); ++it) {
+		total += benchTouch(it.key()) + it.value();
+	}
+	return total;
+}
+template <typename Key, typename Value, typename Compare, typename Allocator>
+size_t benchIterate(const std::map<Key, Value, Compare, Allocator>& map) {
+	size_t total = 0;
+	for (const auto& pair : map) {
+		total += benchTouch(pair.first) + pair.second;
+	}
+	return total;
+}
+
+template <typename Key, typename Value, typename Compare>
+size_t benchScan(const BTreeMap<Key, Value, Compare>& map, const Key& start, size_t length) {
+	size_t total = 0;
+	for (auto it = map.lower_bound(start); it != map.end() && length > 0; ++it, --length) {
+		total += it.value();
+	}
+	return total;
+}
+template <typename Key, typename Value, typename Compare, typename Allocator>
+size_t benchScan(const std::map<Key, Value, Compare, Allocator>& map, const Key& start, size_t length) {
+	size_t total = 0;
+	for (auto it = map.lower_bound(start); it != map.end() && length > 0; ++it, --length) {
+		total += it->second;
+	}
+	return total;
+}
+
+/**
+ * Makes a map holding the given keys, each mapped to its position.
+ * @param	keys	The keys to add
+ * @return	The filled map
+ */
+template <typename Map, typename Key>
+Map benchFilled(const std::vector<Key>& keys) {
+	Map map;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		benchInsert(map, keys[i], static_cast<int>(i));
+	}
+	return map;
+}
+
+// ---------- //
+// Benchmarks //
+// ---------- //
+/**
+ * Measures adding distinct keys in scrambled order to an empty map.
+ */
+template <typename Map, typename Key>
+void BM_OrderedInsert(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	std::optional<Map> map;
+	for (auto _ : state) {
+		map.emplace();
+		for (size_t i = 0; i < size; ++i) {
+			benchInsert(*map, keys[i], static_cast<int>(i));
+		}
+		benchmark::DoNotOptimize(*map);
+		state.PauseTiming();
+		map.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures building a map from a range of distinct keys in sorted order.
+ */
+template <typename Map, typename Key>
+void BM_OrderedBuildSorted(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	std::sort(keys.begin(), keys.end());
+	std::vector<std::pair<Key, int>> range;
+	range.reserve(size);
+	for (size_t i = 0; i < size; ++i) {
+		range.emplace_back(keys[i], static_cast<int>(i));
+	}
+	std::optional<Map> map;
+	for (auto _ : state) {
+		map.emplace(range.begin(), range.end());
+		benchmark::DoNotOptimize(*map);
+		state.PauseTiming();
+		map.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures looking up keys that are all present.
+ */
+template <typename Map, typename Key>
+void BM_OrderedLookupHit(benchmark::State& state) {
+	const size_t size = state.range(0);
+	std::vector<Key> keys = benchKeys<Key>(0, size);
+	const Map map = benchFilled<Map>(keys);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (const Key& key : keys) {
+			found += benchFind(map, key);
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures visiting every key and value in order.
+ */
+template <typename Map, typename Key>
+void BM_OrderedIterate(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Map map = benchFilled<Map>(benchKeys<Key>(0, size));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(benchIterate(map));
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures finding a key and visiting the values of the keys from it onwards.
+ */
+template <typename Map, typename Key>
+void BM_OrderedRangeScan(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Map map = benchFilled<Map>(benchKeys<Key>(0, size));
+	std::vector<Key> starts = benchKeys<Key>(size, FUNDAMENTALS_BENCH_SCAN_COUNT);
+	for (auto _ : state) {
+		size_t total = 0;
+		for (const Key& start : starts) {
+			total += benchScan(map, start, FUNDAMENTALS_BENCH_SCAN_LENGTH);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * FUNDAMENTALS_BENCH_SCAN_COUNT);
+}
+
+// Registers a benchmark for a map template with both key types
+#define ORDERED_BENCHMARK(name, Map) \
+	BENCHMARK_TEMPLATE(name, Map<int>, int)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(name, Map<std::string>, std::string)->Apply(benchSizes)
+
+ORDERED_BENCHMARK(BM_OrderedInsert, StdMap);
+ORDERED_BENCHMARK(BM_OrderedInsert, BTreeOrderedMap);
+ORDERED_BENCHMARK(BM_OrderedBuildSorted, StdMap);
+ORDERED_BENCHMARK(BM_OrderedBuildSorted, BTreeOrderedMap);
+ORDERED_BENCHMARK(BM_OrderedLookupHit, StdMap);
+ORDERED_BENCHMARK(BM_OrderedLookupHit, BTreeOrderedMap);
+ORDERED_BENCHMARK(BM_OrderedIterate, StdMap);
+ORDERED_BENCHMARK(BM_OrderedIterate, BTreeOrderedMap);
+ORDERED_BENCHMARK(BM_OrderedRangeScan, StdMap);
+ORDERED_BENCHMARK(BM_OrderedRangeScan, BTreeOrderedMap);
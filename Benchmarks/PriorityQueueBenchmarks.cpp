@@ -0,0 +1,80 @@
+/**
+ * Fundamentals :: Benchmarks :: Priority Queue Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks PriorityQueue, with 2, 4 and 8 children per element,
+ * against std::priority_queue.
+ */
+/**
+ * std::priority_queue is a binary heap in a std::vector, so it is compared
+ * with each arity of PriorityQueue on the same work: pushing the benchmark
+ * keys one at a time and then popping them all, and building a queue from
+ * all of the keys at once.
+ *
+ * Both queues have the same interface, so one benchmark template can run
+ * all of them.
+ */
+
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "PriorityQueue.hpp"
+
+/**
+ * Measures pushing keys in scrambled order into an empty queue, then popping
+ * all of them.
+ */
+template <typename Queue, typename Key>
+void BM_PriorityQueuePushPop(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const std::vector<Key> keys = benchKeys<Key>(0, size);
+	for (auto _ : state) {
+		Queue queue;
+		for (const Key& key : keys) {
+			queue.push(key);
+		}
+		while (!queue.empty()) {
+			benchmark::DoNotOptimize(queue.top());
+			queue.pop();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+/**
+ * Measures building a queue from a range of keys in scrambled order.
+ */
+template <typename Queue, typename Key>
+void BM_PriorityQueueHeapify(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const std::vector<Key> keys = benchKeys<Key>(0, size);
+	for (auto _ : state) {
+		Queue queue(keys.begin(), keys.end());
+		benchmark::DoNotOptimize(queue.top());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Registers each benchmark for a queue of each key type
+#define PRIORITYQUEUE_BENCHMARK(Queue) \
+	BENCHMARK_TEMPLATE(BM_PriorityQueuePushPop, Queue<int>, int)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(BM_PriorityQueuePushPop, Queue<std::string>, std::string)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(BM_PriorityQueueHeapify, Queue<int>, int)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(BM_PriorityQueueHeapify, Queue<std::string>, std::string)->Apply(benchSizes)
+
+template <typename T>
+using BinaryPriorityQueue = PriorityQueue<T, std::less<T>, 2>;
+template <typename T>
+using QuaternaryPriorityQueue = PriorityQueue<T, std::less<T>, 4>;
+template <typename T>
+using OctonaryPriorityQueue = PriorityQueue<T, std::less<T>, 8>;
+template <typename T>
+using StdPriorityQueue = std::priority_queue<T>;
+
+PRIORITYQUEUE_BENCHMARK(StdPriorityQueue);
+PRIORITYQUEUE_BENCHMARK(BinaryPriorityQueue);
+PRIORITYQUEUE_BENCHMARK(QuaternaryPriorityQueue);
+PRIORITYQUEUE_BENCHMARK(OctonaryPriorityQueue);
@@ -0,0 +1,355 @@
+/**
+ * Fundamentals :: Benchmarks :: Sequence Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks the arrays and lists against their counterparts in the
+ * standard library: DynamicArray and SmallArray against std::vector,
+ * CircularArray against std::deque, and LinkedList and UnrolledList against
+ * std::list.
+ */
+/**
+ * Each benchmark is a template over the container, so exactly the same code
+ * runs for ours and for the standard library's, and they only differ in name.
+ * They are all registered with int and std::string elements.
+ *
+ * Containers are built outside of the timed part wherever a benchmark needs
+ * one to start with, and are destroyed outside of it as well, so that only the
+ * operation being measured is counted.
+ *
+ * The lists are also benchmarked inserting and removing at an iterator in the
+ * middle, which is where UnrolledList has to split and merge its nodes. The
+ * three lists return different things from their insert and remove methods,
+ * so the benchmarks call small overloaded functions that keep an iterator to
+ * the same position for each.
+ */
+
+#include <deque>
+#include <list>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "CircularArray.hpp"
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
+#include "SmallArray.hpp"
+#include "UnrolledList.hpp"
+
+// SmallArray takes its inline size as a second parameter, which the
+// registration macros below can't pass
+template <typename T>
+using SmallArray16 = SmallArray<T, 16>;
+
+// Not every container here names its element type, so find it from begin()
+template <typename Container>
+using ElementOf = typename std::decay<decltype(*std::declval<const Container&>().begin())>::type;
+
+/**
+ * Makes a container holding the elements for 0, 1, ..., size - 1.
+ * @param	size	The number of elements
+ * @return	The filled container
+ */
+template <typename Container>
+Container benchFilled(size_t size) {
+	typedef ElementOf<Container> T;
+	Container container;
+	for (size_t i = 0; i < size; ++i) {
+		container.push_back(benchKey<T>(i));
+	}
+	return container;
+}
+
+// Each of these inserts or removes at an iterator into a list, and gives back
+// an iterator to the element that followed the insertion or removal
+template <typename T, typename Allocator>
+typename std::list<T, Allocator>::iterator benchInsertAt(std::list<T, Allocator>& list, typename std::list<T, Allocator>::iterator location, const T& value) {
+	list.insert(location, value);
+	return location;
+}
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::iterator benchInsertAt(LinkedList<T, Allocator>& list, typename LinkedList<T, Allocator>::iterator location, const T& value) {
+	list.insert(location, value);
+	return location;
+}
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator benchInsertAt(UnrolledList<T, K>& list, typename UnrolledList<T, K>::iterator location, const T& value) {
+	// Inserting can move elements between nodes, so location isn't valid
+	// afterwards, but the iterator to the inserted element is
+	typename UnrolledList<T, K>::iterator inserted = list.insert(location, value);
+	return ++inserted;
+}
+
+template <typename T, typename Allocator>
+typename std::list<T, Allocator>::iterator benchRemoveAt(std::list<T, Allocator>& list, typename std::list<T, Allocator>::iterator location) {
+	return list.erase(location);
+}
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::iterator benchRemoveAt(LinkedList<T, Allocator>& list, typename LinkedList<T, Allocator>::iterator location) {
+	typename LinkedList<T, Allocator>::iterator next = location;
+	++next;
+	list.remove(location);
+	return next;
+}
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator benchRemoveAt(UnrolledList<T, K>& list, typename UnrolledList<T, K>::iterator location) {
+	return list.remove(location);
+}
+
+/**
+ * Finds the iterator to an element of a list by walking to it.
+ * @param	list	The list to look in
+ * @param	index	The position of the element
+ * @return	An iterator to the element
+ */
+template <typename List>
+typename List::iterator benchIteratorAt(List& list, size_t index) {
+	typename List::iterator it = list.begin();
+	for (size_t i = 0; i < index; ++i) {
+		++it;
+	}
+	return it;
+}
+
+/**
+ * Measures building a container by adding elements to the back.
+ */
+template <typename Container>
+void BM_PushBack(benchmark::State& state) {
+	typedef ElementOf<Container> T;
+	const size_t size = state.range(0);
+	std::vector<T> values = benchKeys<T>(0, size);
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace();
+		for (const T& value : values) {
+			container->push_back(value);
+		}
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures building a container by adding elements to the front.
+ */
+template <typename Container>
+void BM_PushFront(benchmark::State& state) {
+	typedef ElementOf<Container> T;
+	const size_t size = state.range(0);
+	std::vector<T> values = benchKeys<T>(0, size);
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace();
+		for (const T& value : values) {
+			container->push_front(value);
+		}
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures visiting every element in order.
+ */
+template <typename Container>
+void BM_Iterate(benchmark::State& state) {
+	typedef ElementOf<Container> T;
+	const size_t size = state.range(0);
+	const Container container = benchFilled<Container>(size);
+	for (auto _ : state) {
+		size_t total = 0;
+		for (const T& value : container) {
+			total += benchTouch(value);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures reading elements by index, in a scrambled order.
+ */
+template <typename Container>
+void BM_RandomAccess(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Container container = benchFilled<Container>(size);
+	std::vector<size_t> indices;
+	indices.reserve(size);
+	for (size_t i = 0; i < size; ++i) {
+		indices.push_back(benchScramble(i) % size);
+	}
+	for (auto _ : state) {
+		size_t total = 0;
+		for (size_t index : indices) {
+			total += benchTouch(container[index]);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures emptying a container by removing elements from the back.
+ */
+template <typename Container>
+void BM_PopBack(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Container original = benchFilled<Container>(size);
+	std::optional<Container> container;
+	for (auto _ : state) {
+		state.PauseTiming();
+		container.emplace(original);
+		state.ResumeTiming();
+		for (size_t i = 0; i < size; ++i) {
+			container->pop_back();
+		}
+		benchmark::DoNotOptimize(*container);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures inserting elements into the middle of a list, all in front of the
+ * same element.
+ *
+ * The list starts out with as many elements as are inserted, and walking to
+ * the middle of it isn't timed.
+ */
+template <typename List>
+void BM_InsertMiddle(benchmark::State& state) {
+	typedef ElementOf<List> T;
+	const size_t size = state.range(0);
+	const List original = benchFilled<List>(size);
+	std::vector<T> values = benchKeys<T>(size, size);
+	std::optional<List> list;
+	for (auto _ : state) {
+		state.PauseTiming();
+		list.emplace(original);
+		typename List::iterator location = benchIteratorAt(*list, size / 2);
+		state.ResumeTiming();
+		for (const T& value : values) {
+			location = benchInsertAt(*list, location, value);
+		}
+		benchmark::DoNotOptimize(*list);
+		state.PauseTiming();
+		list.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+/**
+ * Measures removing the middle half of a list, one element at a time from an
+ * iterator.
+ *
+ * Walking to the first element removed isn't timed.
+ */
+template <typename List>
+void BM_RemoveMiddle(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const size_t count = size / 2;
+	const List original = benchFilled<List>(size);
+	std::optional<List> list;
+	for (auto _ : state) {
+		state.PauseTiming();
+		list.emplace(original);
+		typename List::iterator location = benchIteratorAt(*list, size / 4);
+		state.ResumeTiming();
+		for (size_t i = 0; i < count; ++i) {
+			location = benchRemoveAt(*list, location);
+		}
+		benchmark::DoNotOptimize(*list);
+		state.PauseTiming();
+		list.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+/**
+ * Measures copying a whole container.
+ */
+template <typename Container>
+void BM_Copy(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const Container original = benchFilled<Container>(size);
+	std::optional<Container> container;
+	for (auto _ : state) {
+		container.emplace(original);
+		benchmark::DoNotOptimize(*container);
+		state.PauseTiming();
+		container.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Registers a benchmark for a container template with both element types
+#define SEQUENCE_BENCHMARK(name, Container) \
+	BENCHMARK_TEMPLATE(name, Container<int>)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(name, Container<std::string>)->Apply(benchSizes)
+
+// Arrays
+SEQUENCE_BENCHMARK(BM_PushBack, std::vector);
+SEQUENCE_BENCHMARK(BM_PushBack, DynamicArray);
+SEQUENCE_BENCHMARK(BM_PushBack, SmallArray16);
+SEQUENCE_BENCHMARK(BM_Iterate, std::vector);
+SEQUENCE_BENCHMARK(BM_Iterate, DynamicArray);
+SEQUENCE_BENCHMARK(BM_Iterate, SmallArray16);
+SEQUENCE_BENCHMARK(BM_RandomAccess, std::vector);
+SEQUENCE_BENCHMARK(BM_RandomAccess, DynamicArray);
+SEQUENCE_BENCHMARK(BM_RandomAccess, SmallArray16);
+SEQUENCE_BENCHMARK(BM_PopBack, std::vector);
+SEQUENCE_BENCHMARK(BM_PopBack, DynamicArray);
+SEQUENCE_BENCHMARK(BM_PopBack, SmallArray16);
+SEQUENCE_BENCHMARK(BM_Copy, std::vector);
+SEQUENCE_BENCHMARK(BM_Copy, DynamicArray);
+SEQUENCE_BENCHMARK(BM_Copy, SmallArray16);
+
+// Double-ended arrays
+SEQUENCE_BENCHMARK(BM_PushBack, std::deque);
+SEQUENCE_BENCHMARK(BM_PushBack, CircularArray);
+SEQUENCE_BENCHMARK(BM_PushFront, std::deque);
+SEQUENCE_BENCHMARK(BM_PushFront, CircularArray);
+SEQUENCE_BENCHMARK(BM_Iterate, std::deque);
+SEQUENCE_BENCHMARK(BM_Iterate, CircularArray);
+SEQUENCE_BENCHMARK(BM_RandomAccess, std::deque);
+SEQUENCE_BENCHMARK(BM_RandomAccess, CircularArray);
+SEQUENCE_BENCHMARK(BM_PopBack, std::deque);
+SEQUENCE_BENCHMARK(BM_PopBack, CircularArray);
+SEQUENCE_BENCHMARK(BM_Copy, std::deque);
+SEQUENCE_BENCHMARK(BM_Copy, CircularArray);
+
+// Lists
+SEQUENCE_BENCHMARK(BM_PushBack, std::list);
+SEQUENCE_BENCHMARK(BM_PushBack, LinkedList);
+SEQUENCE_BENCHMARK(BM_PushBack, UnrolledList);
+SEQUENCE_BENCHMARK(BM_PushFront, std::list);
+SEQUENCE_BENCHMARK(BM_PushFront, LinkedList);
+SEQUENCE_BENCHMARK(BM_PushFront, UnrolledList);
+SEQUENCE_BENCHMARK(BM_Iterate, std::list);
+SEQUENCE_BENCHMARK(BM_Iterate, LinkedList);
+SEQUENCE_BENCHMARK(BM_Iterate, UnrolledList);
+SEQUENCE_BENCHMARK(BM_PopBack, std::list);
+SEQUENCE_BENCHMARK(BM_PopBack, LinkedList);
+SEQUENCE_BENCHMARK(BM_PopBack, UnrolledList);
+SEQUENCE_BENCHMARK(BM_InsertMiddle, std::list);
+SEQUENCE_BENCHMARK(BM_InsertMiddle, LinkedList);
+SEQUENCE_BENCHMARK(BM_InsertMiddle, UnrolledList);
+SEQUENCE_BENCHMARK(BM_RemoveMiddle, std::list);
+SEQUENCE_BENCHMARK(BM_RemoveMiddle, LinkedList);
+SEQUENCE_BENCHMARK(BM_RemoveMiddle, UnrolledList);
+SEQUENCE_BENCHMARK(BM_Copy, std::list);
+SEQUENCE_BENCHMARK(BM_Copy, LinkedList);
+SEQUENCE_BENCHMARK(BM_Copy, UnrolledList);
@@ -0,0 +1,119 @@
+/**
+ * Fundamentals :: Benchmarks :: Sorting Benchmarks
+ * Author: Quinn Mortimer
+ *
+ * This file benchmarks the sorting algorithms in Sorting.hpp against
+ * std::sort, and against std::sort with std::execution::par when the
+ * standard library's parallel algorithms are available.
+ */
+/**
+ * Every sort is run over a DynamicArray of the benchmark keys, which are in
+ * scrambled order (see BenchmarkData.hpp). The array is refilled with the
+ * unsorted keys outside of the timed part before each run. radixSort only
+ * sorts integers, so it is only registered with int keys.
+ *
+ * Each algorithm is wrapped in a small function object, so that one benchmark
+ * template can run all of them.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if FUNDAMENTALS_BENCH_STD_PARALLEL
+#include <execution>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.hpp"
+#include "DynamicArray.hpp"
+#include "Sorting.hpp"
+
+// -------- //
+// Sorters //
+// -------- //
+struct IntrosortSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		introsort(first, last);
+	}
+};
+struct HeapSortSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		heapSort(first, last);
+	}
+};
+struct MergeSortSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		mergeSort(first, last);
+	}
+};
+struct ParallelMergeSortSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		parallelMergeSort(first, last);
+	}
+};
+struct RadixSortSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		radixSort(first, last);
+	}
+};
+struct StdSortSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		std::sort(first, last);
+	}
+};
+#if FUNDAMENTALS_BENCH_STD_PARALLEL
+struct StdSortParSorter {
+	template <typename RandomIt>
+	void operator()(RandomIt first, RandomIt last) const {
+		std::sort(std::execution::par, first, last);
+	}
+};
+#endif
+
+// ----------- //
+// Benchmarks //
+// ----------- //
+/**
+ * Measures sorting an array of keys in scrambled order.
+ */
+template <typename Sorter, typename Key>
+void BM_Sort(benchmark::State& state) {
+	const size_t size = state.range(0);
+	const std::vector<Key> keys = benchKeys<Key>(0, size);
+	DynamicArray<Key> array(size);
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::copy(keys.begin(), keys.end(), array.begin());
+		state.ResumeTiming();
+		Sorter()(array.begin(), array.end());
+		benchmark::DoNotOptimize(array.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Registers a benchmark for a sorter with both key types
+#define SORT_BENCHMARK(Sorter) \
+	BENCHMARK_TEMPLATE(BM_Sort, Sorter, int)->Apply(benchSizes); \
+	BENCHMARK_TEMPLATE(BM_Sort, Sorter, std::string)->Apply(benchSizes)
+// The same, for sorters that start threads of their own
+#define SORT_THREADED_BENCHMARK(Sorter) \
+	BENCHMARK_TEMPLATE(BM_Sort, Sorter, int)->Apply(benchSizes)->UseRealTime(); \
+	BENCHMARK_TEMPLATE(BM_Sort, Sorter, std::string)->Apply(benchSizes)->UseRealTime()
+
+SORT_BENCHMARK(StdSortSorter);
+SORT_BENCHMARK(IntrosortSorter);
+SORT_BENCHMARK(HeapSortSorter);
+SORT_BENCHMARK(MergeSortSorter);
+SORT_THREADED_BENCHMARK(ParallelMergeSortSorter);
+#if FUNDAMENTALS_BENCH_STD_PARALLEL
+SORT_THREADED_BENCHMARK(StdSortParSorter);
+#endif
+BENCHMARK_TEMPLATE(BM_Sort, RadixSortSorter, int)->Apply(benchSizes);
@@ -0,0 +1,517 @@
+/**
+ * Fundamentals :: Algorithms :: Graph
+ * Author: Quinn Mortimer
+ *
+ * This file contains a directed, weighted graph stored in compressed sparse
+ * row form, for the C++ versions of the graph algorithms (see
+ * GraphAlgorithms.hpp), along with ways to build one.
+ */
+/**
+ * The Python versions keep a dictionary of vertices, each with its own list
+ * of edge objects, which is easy to read but has to follow a pointer for
+ * every vertex and every edge. A Graph instead numbers its vertices from 0
+ * and keeps all of the edges in a few flat arrays:
+ *
+ * - The targets of the edges out of vertex v are a contiguous block of one
+ *   array, starting at offset v of another, and ending where the block for
+ *   v + 1 starts. Their weights are at the same positions of a third array.
+ * - The sources of the edges into each vertex are kept the same way, which
+ *   lets a breadth-first search work backwards from unvisited vertices.
+ *
+ * Visiting a vertex's edges is then a read of adjacent memory, and the
+ * targets are kept apart from the weights so that searches that don't need
+ * the weights don't read them. The graph can't be changed once it's built.
+ *
+ * Vertices are numbered with 32-bit integers, which is enough for every road
+ * network there is, while edges are counted with size_t, so a graph can have
+ * more than 2^32 of them.
+ *
+ * Vertices with other names, such as strings, can be given numbers with a
+ * GraphBuilder, which keeps a HashMap from each name to its number. Road
+ * networks in the DIMACS shortest path challenge format (.gr files) can be
+ * read with loadDimacsGraph.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "Checks.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "HashMap.hpp"
+#include "Hashing.hpp"
+
+#ifndef Fundamentals_Graph_hpp_
+#define Fundamentals_Graph_hpp_
+
+// The vertex number that stands for no vertex at all, so no graph can have
+// this many vertices.
+#define GRAPH_NO_VERTEX UINT32_MAX
+// The longest line loadDimacsGraph can read, including the line break.
+#define GRAPH_DIMACS_LINE_LENGTH 256
+
+/**
+ * A directed edge from one vertex to another, for building a Graph.
+ */
+template <typename Weight>
+struct Graph_Edge {
+	uint32_t from;
+	uint32_t to;
+	Weight weight;
+};
+
+/**
+ * A directed, weighted graph in compressed sparse row form.
+ */
+template <typename Weight = uint32_t>
+class Graph {
+	public:
+		typedef uint32_t vertex_type;
+		typedef size_t size_type;
+		typedef Weight weight_type;
+		typedef Graph_Edge<Weight> edge_type;
+		
+		// Constructors
+		Graph();
+		Graph(size_type vertices, const DynamicArray<edge_type>& edges);
+		
+		// Access to current size
+		size_type vertexCount() const;
+		size_type edgeCount() const;
+		
+		// Edges out of a vertex
+		// - The edges out of v are numbered from edgesBegin(v) up to edgesEnd(v)
+		size_type edgesBegin(vertex_type v) const;
+		size_type edgesEnd(vertex_type v) const;
+		size_type outDegree(vertex_type v) const;
+		vertex_type target(size_type edge) const;
+		const Weight& weight(size_type edge) const;
+		
+		// Edges into a vertex
+		// - The edges into v are numbered from inEdgesBegin(v) up to
+		//   inEdgesEnd(v), separately from the edges out of vertices
+		size_type inEdgesBegin(vertex_type v) const;
+		size_type inEdgesEnd(vertex_type v) const;
+		size_type inDegree(vertex_type v) const;
+		vertex_type source(size_type inEdge) const;
+		
+	private:
+		// Where each vertex's block of edges out of it starts, with the total
+		// number of edges at the end.
+		DynamicArray<size_type> m_offsets;
+		// The target and weight of each edge out of a vertex.
+		DynamicArray<vertex_type> m_targets;
+		DynamicArray<Weight> m_weights;
+		// The same as m_offsets, for the edges into each vertex.
+		DynamicArray<size_type> m_inOffsets;
+		// The source of each edge into a vertex.
+		DynamicArray<vertex_type> m_sources;
+};
+
+/**
+ * Gives numbers to named vertices, and collects edges between them to build
+ * a Graph from.
+ */
+template <typename Key, typename Weight = uint32_t, typename Hash = DefaultHashFor<Key>>
+class GraphBuilder {
+	public:
+		typedef uint32_t vertex_type;
+		typedef size_t size_type;
+		typedef Hash hash_type;
+		
+		// Constructor
+		explicit GraphBuilder(const hash_type& hash = hash_type());
+		
+		// Access to current size
+		size_type vertexCount() const;
+		size_type edgeCount() const;
+		
+		// Adding vertices and edges
+		vertex_type addVertex(const Key& key);
+		void addEdge(const Key& from, const Key& to, const Weight& weight);
+		
+		// Looking up vertices
+		bool hasVertex(const Key& key) const;
+		vertex_type index(const Key& key) const;
+		const Key& key(vertex_type index) const;
+		
+		// Building the graph
+		Graph<Weight> build() const;
+		
+	private:
+		// The number of each vertex, by name.
+		HashMap<Key, vertex_type, PerturbProbe, Hash> m_indices;
+		// The name of each vertex, by number.
+		DynamicArray<Key> m_keys;
+		// The edges added so far, between vertex numbers.
+		DynamicArray<Graph_Edge<Weight>> m_edges;
+};
+
+// -------------- //
+// Graph Methods //
+// -------------- //
+/**
+ * Creates a graph with no vertices.
+ */
+template <typename Weight>
+Graph<Weight>::Graph()
+	: m_offsets(1, 0), m_inOffsets(1, 0)
+{}
+/**
+ * Creates a graph from a list of edges.
+ *
+ * The edges are sorted into blocks by vertex with a counting sort, so this
+ * takes time in proportion to the number of vertices and edges. The edges
+ * out of each vertex stay in the order they are in the list.
+ *
+ * @throws	OutOfBoundsError	when an edge is from or to a vertex >= vertices,
+ * 	or vertices is GRAPH_NO_VERTEX or more
+ * @param	vertices	The number of vertices, numbered from 0
+ * @param	edges	The edges of the graph
+ */
+template <typename Weight>
+Graph<Weight>::Graph(size_type vertices, const DynamicArray<edge_type>& edges)
+	: m_offsets(vertices + 1, 0), m_targets(edges.size()), m_weights(edges.size()),
+	m_inOffsets(vertices + 1, 0), m_sources(edges.size())
+{
+	if (vertices >= GRAPH_NO_VERTEX) {
+		throw OutOfBoundsError();
+	}
+	
+	for (const edge_type& edge : edges) {
+		if (edge.from >= vertices || edge.to >= vertices) {
+			throw OutOfBoundsError();
+		}
+		++m_offsets[edge.from + 1];
+		++m_inOffsets[edge.to + 1];
+	}
+	for (size_type v = 0; v < vertices; ++v) {
+		m_offsets[v + 1] += m_offsets[v];
+		m_inOffsets[v + 1] += m_inOffsets[v];
+	}
+	
+	// Each vertex's next free position in each of the blocks
+	DynamicArray<size_type> next(vertices);
+	DynamicArray<size_type> inNext(vertices);
+	for (size_type v = 0; v < vertices; ++v) {
+		next[v] = m_offsets[v];
+		inNext[v] = m_inOffsets[v];
+	}
+	for (const edge_type& edge : edges) {
+		size_type position = next[edge.from]++;
+		m_targets[position] = edge.to;
+		m_weights[position] = edge.weight;
+		m_sources[inNext[edge.to]++] = edge.from;
+	}
+}
+
+/**
+ * Reports the number of vertices in the graph.
+ * @return	The number of vertices, which are numbered from 0
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::vertexCount() const {
+	return m_offsets.size() - 1;
+}
+/**
+ * Reports the number of edges in the graph.
+ * @return	The number of edges
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::edgeCount() const {
+	return m_targets.size();
+}
+
+/**
+ * Gives the number of the first edge out of a vertex.
+ * @throws	OutOfBoundsError	when v is not a vertex of the graph
+ * @param	v	The vertex
+ * @return	The number of its first edge
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::edgesBegin(vertex_type v) const {
+	FUNDAMENTALS_CHECK_BOUNDS(v < vertexCount());
+	
+	return m_offsets[v];
+}
+/**
+ * Gives the number just past the last edge out of a vertex.
+ * @throws	OutOfBoundsError	when v is not a vertex of the graph
+ * @param	v	The vertex
+ * @return	The number just past its last edge
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::edgesEnd(vertex_type v) const {
+	FUNDAMENTALS_CHECK_BOUNDS(v < vertexCount());
+	
+	return m_offsets[v + 1];
+}
+/**
+ * Reports the number of edges out of a vertex.
+ * @throws	OutOfBoundsError	when v is not a vertex of the graph
+ * @param	v	The vertex
+ * @return	The number of edges out of it
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::outDegree(vertex_type v) const {
+	return edgesEnd(v) - edgesBegin(v);
+}
+/**
+ * Gives the vertex an edge goes to.
+ * @throws	OutOfBoundsError	when edge is not an edge of the graph
+ * @param	edge	The number of the edge
+ * @return	The vertex it goes to
+ */
+template <typename Weight>
+typename Graph<Weight>::vertex_type Graph<Weight>::target(size_type edge) const {
+	return m_targets[edge];
+}
+/**
+ * Gives the weight of an edge.
+ * @throws	OutOfBoundsError	when edge is not an edge of the graph
+ * @param	edge	The number of the edge
+ * @return	A constant reference to its weight
+ */
+template <typename Weight>
+const Weight& Graph<Weight>::weight(size_type edge) const {
+	return m_weights[edge];
+}
+
+/**
+ * Gives the number of the first edge into a vertex.
+ * @throws	OutOfBoundsError	when v is not a vertex of the graph
+ * @param	v	The vertex
+ * @return	The number of its first edge in
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::inEdgesBegin(vertex_type v) const {
+	FUNDAMENTALS_CHECK_BOUNDS(v < vertexCount());
+	
+	return m_inOffsets[v];
+}
+/**
+ * Gives the number just past the last edge into a vertex.
+ * @throws	OutOfBoundsError	when v is not a vertex of the graph
+ * @param	v	The vertex
+ * @return	The number just past its last edge in
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::inEdgesEnd(vertex_type v) const {
+	FUNDAMENTALS_CHECK_BOUNDS(v < vertexCount());
+	
+	return m_inOffsets[v + 1];
+}
+/**
+ * Reports the number of edges into a vertex.
+ * @throws	OutOfBoundsError	when v is not a vertex of the graph
+ * @param	v	The vertex
+ * @return	The number of edges into it
+ */
+template <typename Weight>
+typename Graph<Weight>::size_type Graph<Weight>::inDegree(vertex_type v) const {
+	return inEdgesEnd(v) - inEdgesBegin(v);
+}
+/**
+ * Gives the vertex an edge into another comes from.
+ * @throws	OutOfBoundsError	when inEdge is not an edge of the graph
+ * @param	inEdge	The number of the edge, counting edges into vertices
+ * @return	The vertex it comes from
+ */
+template <typename Weight>
+typename Graph<Weight>::vertex_type Graph<Weight>::source(size_type inEdge) const {
+	return m_sources[inEdge];
+}
+
+// --------------------- //
+// GraphBuilder Methods //
+// --------------------- //
+/**
+ * Creates a builder with no vertices or edges.
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	hash	The hash function for the vertex names
+ */
+template <typename Key, typename Weight, typename Hash>
+GraphBuilder<Key, Weight, Hash>::GraphBuilder(const hash_type& hash)
+	: m_indices(hash)
+{}
+
+/**
+ * Reports the number of vertices added so far.
+ * @return	The number of vertices
+ */
+template <typename Key, typename Weight, typename Hash>
+typename GraphBuilder<Key, Weight, Hash>::size_type GraphBuilder<Key, Weight, Hash>::vertexCount() const {
+	return m_keys.size();
+}
+/**
+ * Reports the number of edges added so far.
+ * @return	The number of edges
+ */
+template <typename Key, typename Weight, typename Hash>
+typename GraphBuilder<Key, Weight, Hash>::size_type GraphBuilder<Key, Weight, Hash>::edgeCount() const {
+	return m_edges.size();
+}
+
+/**
+ * Adds a vertex, if there isn't one with its name already.
+ *
+ * Vertices are numbered in the order they are first added, from 0.
+ *
+ * @throws	OutOfBoundsError	when there are already GRAPH_NO_VERTEX vertices
+ * @param	key	The name of the vertex
+ * @return	The number of the vertex
+ */
+template <typename Key, typename Weight, typename Hash>
+typename GraphBuilder<Key, Weight, Hash>::vertex_type GraphBuilder<Key, Weight, Hash>::addVertex(const Key& key) {
+	const vertex_type* found = m_indices.find(key);
+	if (found != nullptr) {
+		return *found;
+	}
+	if (m_keys.size() >= GRAPH_NO_VERTEX) {
+		throw OutOfBoundsError();
+	}
+	
+	vertex_type index = static_cast<vertex_type>(m_keys.size());
+	m_keys.push_back(key);
+	m_indices.insert(key, index);
+	return index;
+}
+/**
+ * Adds a directed edge, adding either of its vertices that isn't there yet.
+ * @throws	OutOfBoundsError	when a vertex needs to be added and there are
+ * 	already GRAPH_NO_VERTEX vertices
+ * @param	from	The name of the vertex the edge comes from
+ * @param	to	The name of the vertex the edge goes to
+ * @param	weight	The weight of the edge
+ */
+template <typename Key, typename Weight, typename Hash>
+void GraphBuilder<Key, Weight, Hash>::addEdge(const Key& from, const Key& to, const Weight& weight) {
+	vertex_type fromIndex = addVertex(from);
+	vertex_type toIndex = addVertex(to);
+	m_edges.push_back(Graph_Edge<Weight>{fromIndex, toIndex, weight});
+}
+
+/**
+ * Checks if a vertex has been added.
+ * @param	key	The name of the vertex
+ * @return	Whether there is a vertex with that name
+ */
+template <typename Key, typename Weight, typename Hash>
+bool GraphBuilder<Key, Weight, Hash>::hasVertex(const Key& key) const {
+	return m_indices.find(key) != nullptr;
+}
+/**
+ * Gives the number of a vertex.
+ * @throws	MissingKeyError	when there is no vertex with that name
+ * @param	key	The name of the vertex
+ * @return	The number of the vertex in the built graph
+ */
+template <typename Key, typename Weight, typename Hash>
+typename GraphBuilder<Key, Weight, Hash>::vertex_type GraphBuilder<Key, Weight, Hash>::index(const Key& key) const {
+	return m_indices.getValue(key);
+}
+/**
+ * Gives the name of a vertex.
+ * @throws	OutOfBoundsError	when there is no vertex with that number
+ * @param	index	The number of the vertex
+ * @return	A constant reference to the name of the vertex
+ */
+template <typename Key, typename Weight, typename Hash>
+const Key& GraphBuilder<Key, Weight, Hash>::key(vertex_type index) const {
+	return m_keys[index];
+}
+
+/**
+ * Builds a graph of the vertices and edges added so far.
+ * @return	The graph, whose vertex numbers are those given by index
+ */
+template <typename Key, typename Weight, typename Hash>
+Graph<Weight> GraphBuilder<Key, Weight, Hash>::build() const {
+	return Graph<Weight>(m_keys.size(), m_edges);
+}
+
+// ------------- //
+// DIMACS Files //
+// ------------- //
+/**
+ * Reads a graph from a file in the DIMACS shortest path challenge format.
+ *
+ * This is the format the standard road network datasets are published in.
+ * Each line is one of:
+ * - `c ...`, a comment.
+ * - `p sp <vertices> <edges>`, once, before any edges.
+ * - `a <from> <to> <weight>`, a directed edge. Vertices are numbered from 1.
+ *
+ * Vertex n in the file is vertex n - 1 in the graph.
+ *
+ * @throws	FileError	when the file can't be opened or read
+ * @throws	FileFormatError	when a line isn't one of the above, or an edge
+ * 	is to a vertex that isn't in the graph
+ * @param	path	The path of the file
+ * @return	The graph in the file
+ */
+template <typename Weight = uint32_t>
+Graph<Weight> loadDimacsGraph(const std::string& path) {
+	std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "r"), &std::fclose);
+	if (!file) {
+		throw FileError();
+	}
+	
+	unsigned long long vertices = 0;
+	bool sized = false;
+	DynamicArray<Graph_Edge<Weight>> edges;
+	
+	char line[GRAPH_DIMACS_LINE_LENGTH];
+	while (std::fgets(line, sizeof(line), file.get()) != nullptr) {
+		if (line[0] == 'c' || line[0] == '\n' || line[0] == '\r') {
+			continue;
+		}
+		if (line[0] == 'p') {
+			unsigned long long count = 0;
+			if (sized || std::sscanf(line, "p sp %llu %llu", &vertices, &count) != 2 || vertices >= GRAPH_NO_VERTEX) {
+				throw FileFormatError();
+			}
+			edges.reserve(count);
+			sized = true;
+			continue;
+		}
+		if (line[0] != 'a' || !sized) {
+			throw FileFormatError();
+		}
+		
+		char* at = line + 1;
+		char* end = nullptr;
+		unsigned long long from = std::strtoull(at, &end, 10);
+		unsigned long long to = std::strtoull(end, &at, 10);
+		if (at == end || from < 1 || from > vertices || to < 1 || to > vertices) {
+			throw FileFormatError();
+		}
+		Weight weight;
+		if (std::is_floating_point<Weight>::value) {
+			weight = static_cast<Weight>(std::strtod(at, &end));
+		}
+		else {
+			weight = static_cast<Weight>(std::strtoll(at, &end, 10));
+		}
+		if (at == end) {
+			throw FileFormatError();
+		}
+		
+		edges.push_back(Graph_Edge<Weight>{static_cast<uint32_t>(from - 1), static_cast<uint32_t>(to - 1), weight});
+	}
+	if (std::ferror(file.get())) {
+		throw FileError();
+	}
+	if (!sized) {
+		throw FileFormatError();
+	}
+	
+	return Graph<Weight>(vertices, edges);
+}
+
+#endif // Fundamentals_Graph_hpp_
@@ -0,0 +1,438 @@
+/**
+ * Fundamentals :: Algorithms :: Graph Algorithms
+ * Author: Quinn Mortimer
+ *
+ * This file contains C++ versions of the graph algorithms, which run on a
+ * Graph (see Graph.hpp).
+ */
+/**
+ * The Python files next to this one are the readable reference for each
+ * algorithm. These are the same algorithms with the changes that make them
+ * fast on large graphs:
+ *
+ * - dijkstra keeps the vertices it hasn't finished with in an
+ *   IndexedPriorityQueue (see PriorityQueue.hpp) with 4 children per entry,
+ *   so when a shorter path to a vertex is found its place in the queue is
+ *   moved up with decrease_key, rather than it being added again.
+ * - breadthFirstSearch is direction-optimizing. While the frontier (the
+ *   vertices found at the last level) is small, it looks along the edges out
+ *   of the frontier as usual. Once the frontier has more edges out of it than
+ *   a fraction of the edges left unexplored, it switches to looking along the
+ *   edges into each vertex not yet found for one from the frontier, stopping
+ *   at the first. Each level is split between several threads.
+ * - bellmanFord only relaxes the edges out of the vertices whose distance
+ *   went down in the last round, rather than every edge in every round. Each
+ *   round's vertices are split between several threads, which lower the
+ *   distances with atomic compare-and-swap.
+ *
+ * All of them are given the number of threads to use, or 0 for one per
+ * hardware thread. The threads only do work that can't throw exceptions, other
+ * than running out of memory, which ends the program.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Checks.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "Graph.hpp"
+#include "PriorityQueue.hpp"
+#include "Threads.hpp"
+
+#ifndef Fundamentals_GraphAlgorithms_hpp_
+#define Fundamentals_GraphAlgorithms_hpp_
+
+// The number of children of each entry in dijkstra's priority queue.
+#define GRAPH_HEAP_ARITY 4
+// The level breadthFirstSearch gives vertices it never finds.
+#define GRAPH_UNREACHED UINT32_MAX
+// breadthFirstSearch switches to searching backwards from unfound vertices
+// once the frontier has more than 1/GRAPH_BFS_ALPHA of the unexplored edges
+// out of it, and back to searching forwards once the frontier has fewer than
+// 1/GRAPH_BFS_BETA of the vertices.
+#define GRAPH_BFS_ALPHA 14
+#define GRAPH_BFS_BETA 24
+
+/**
+ * The shortest paths from one vertex to all the others.
+ *
+ * A vertex with no path to it has the greatest Weight as its distance and
+ * GRAPH_NO_VERTEX as its parent, as does the start vertex.
+ */
+template <typename Weight>
+struct GraphPaths {
+	// The length of the shortest path to each vertex.
+	DynamicArray<Weight> distances;
+	// The vertex before each vertex on its shortest path.
+	DynamicArray<uint32_t> parents;
+};
+
+/**
+ * A barrier that several threads wait at until all of them have arrived.
+ */
+class GraphBarrier {
+	public:
+		explicit GraphBarrier(size_t threads);
+		
+		void wait();
+		
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		// The number of threads that wait at the barrier.
+		size_t m_threads;
+		// The number of threads waiting at it now.
+		size_t m_waiting;
+		// The number of times all of the threads have arrived.
+		size_t m_generation;
+};
+
+// --------------------- //
+// GraphBarrier Methods //
+// --------------------- //
+/**
+ * Creates a barrier for a number of threads.
+ * @param	threads	The number of threads that will wait at it
+ */
+inline GraphBarrier::GraphBarrier(size_t threads)
+	: m_threads(threads), m_waiting(0), m_generation(0)
+{}
+
+/**
+ * Waits until every thread has called wait. The barrier can then be used
+ * again straight away.
+ */
+inline void GraphBarrier::wait() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	size_t generation = m_generation;
+	
+	if (++m_waiting == m_threads) {
+		m_waiting = 0;
+		++m_generation;
+		m_condition.notify_all();
+		return;
+	}
+	
+	m_condition.wait(lock, [&]() { return m_generation != generation; });
+}
+
+// ----------- //
+// Algorithms //
+// ----------- //
+/**
+ * Works out how many threads to split a graph algorithm between.
+ * @param	threads	The number of threads asked for, or 0 for one per hardware
+ * 	thread
+ * @param	vertices	The number of vertices in the graph
+ * @return	The number of threads, at least 1 and at most the vertices
+ */
+inline size_t graphThreads(size_t threads, size_t vertices) {
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads > vertices) {
+		threads = vertices;
+	}
+	return threads == 0 ? 1 : threads;
+}
+
+/**
+ * Finds the shortest paths from one vertex to the others with Dijkstra's
+ * algorithm.
+ *
+ * Every edge must have a weight of at least zero. When a target is given,
+ * the search stops as soon as the shortest path to it is known, and the
+ * paths to vertices further away may be missing or longer than the shortest.
+ *
+ * @throws	OutOfBoundsError	when start is not a vertex of the graph
+ * @param	graph	The graph to search
+ * @param	start	The vertex the paths start at
+ * @param	target	The vertex to stop at, or GRAPH_NO_VERTEX to find the
+ * 	paths to every vertex
+ * @return	The shortest paths
+ */
+template <typename Weight>
+GraphPaths<Weight> dijkstra(const Graph<Weight>& graph, uint32_t start, uint32_t target = GRAPH_NO_VERTEX) {
+	const size_t vertices = graph.vertexCount();
+	FUNDAMENTALS_CHECK_BOUNDS(start < vertices);
+	
+	GraphPaths<Weight> paths{DynamicArray<Weight>(vertices, std::numeric_limits<Weight>::max()), DynamicArray<uint32_t>(vertices, GRAPH_NO_VERTEX)};
+	IndexedPriorityQueue<Weight, std::greater<Weight>, GRAPH_HEAP_ARITY> queue(vertices);
+	
+	paths.distances[start] = Weight();
+	queue.push(start, Weight());
+	while (!queue.empty()) {
+		uint32_t v = static_cast<uint32_t>(queue.top());
+		queue.pop();
+		if (v == target) {
+			break;
+		}
+		
+		const Weight distance = paths.distances[v];
+		for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+			uint32_t next = graph.target(e);
+			Weight nextDistance = distance + graph.weight(e);
+			if (nextDistance < paths.distances[next]) {
+				paths.distances[next] = nextDistance;
+				paths.parents[next] = v;
+				if (queue.contains(next)) {
+					queue.decrease_key(next, nextDistance);
+				}
+				else {
+					queue.push(next, nextDistance);
+				}
+			}
+		}
+	}
+	
+	return paths;
+}
+
+/**
+ * Gives the shortest path to a vertex, following its parents back.
+ * @throws	OutOfBoundsError	when target is not a vertex of the paths
+ * @param	paths	The shortest paths from dijkstra
+ * @param	target	The vertex the path ends at
+ * @return	The vertices on the path, from the start to target, or no
+ * 	vertices if there is no path to target
+ */
+template <typename Weight>
+DynamicArray<uint32_t> shortestPath(const GraphPaths<Weight>& paths, uint32_t target) {
+	DynamicArray<uint32_t> path;
+	if (paths.distances[target] == std::numeric_limits<Weight>::max()) {
+		return path;
+	}
+	
+	for (uint32_t v = target; v != GRAPH_NO_VERTEX; v = paths.parents[v]) {
+		path.push_back(v);
+	}
+	for (size_t i = 0, j = path.size() - 1; i < j; ++i, --j) {
+		std::swap(path[i], path[j]);
+	}
+	
+	return path;
+}
+
+/**
+ * Finds how many edges away from one vertex every other vertex is, with a
+ * direction-optimizing breadth-first search.
+ * @throws	OutOfBoundsError	when start is not a vertex of the graph
+ * @param	graph	The graph to search
+ * @param	start	The vertex to search from
+ * @param	threads	The number of threads to use, or 0 for one per hardware
+ * 	thread
+ * @return	The fewest edges on a path to each vertex, or GRAPH_UNREACHED for
+ * 	vertices with no path to them
+ */
+template <typename Weight>
+DynamicArray<uint32_t> breadthFirstSearch(const Graph<Weight>& graph, uint32_t start, size_t threads = 0) {
+	const size_t vertices = graph.vertexCount();
+	FUNDAMENTALS_CHECK_BOUNDS(start < vertices);
+	threads = graphThreads(threads, vertices);
+	
+	std::unique_ptr<std::atomic<uint32_t>[]> levels(new std::atomic<uint32_t>[vertices]);
+	for (size_t v = 0; v < vertices; ++v) {
+		levels[v].store(GRAPH_UNREACHED, std::memory_order_relaxed);
+	}
+	levels[start].store(0, std::memory_order_relaxed);
+	
+	// The frontier, and each thread's share of the next one with the number
+	// of edges out of it
+	std::vector<uint32_t> frontier(1, start);
+	std::vector<std::vector<uint32_t>> found(threads);
+	std::vector<size_t> foundEdges(threads);
+	std::vector<size_t> offsets(threads);
+	
+	// Shared decisions, made by thread 0 between levels
+	bool forwards = true;
+	bool done = false;
+	size_t unexploredEdges = graph.edgeCount() - graph.outDegree(start);
+	GraphBarrier barrier(threads);
+	
+	runThreads(threads, [&](size_t thread) noexcept {
+		for (uint32_t level = 0; !done; ++level) {
+			std::vector<uint32_t>& mine = found[thread];
+			size_t edges = 0;
+			
+			if (forwards) {
+				// Claim the unfound targets of this thread's share of the frontier
+				for (size_t i = thread * frontier.size() / threads; i < (thread + 1) * frontier.size() / threads; ++i) {
+					uint32_t v = frontier[i];
+					for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+						uint32_t next = graph.target(e);
+						uint32_t unreached = GRAPH_UNREACHED;
+						if (levels[next].load(std::memory_order_relaxed) == GRAPH_UNREACHED && levels[next].compare_exchange_strong(unreached, level + 1, std::memory_order_relaxed)) {
+							mine.push_back(next);
+							edges += graph.outDegree(next);
+						}
+					}
+				}
+			}
+			else {
+				// Look for a parent in the frontier for each unfound vertex in
+				// this thread's share of them all, which only it writes to
+				for (size_t v = thread * vertices / threads; v < (thread + 1) * vertices / threads; ++v) {
+					if (levels[v].load(std::memory_order_relaxed) != GRAPH_UNREACHED) {
+						continue;
+					}
+					for (size_t e = graph.inEdgesBegin(v); e < graph.inEdgesEnd(v); ++e) {
+						if (levels[graph.source(e)].load(std::memory_order_relaxed) == level) {
+							levels[v].store(level + 1, std::memory_order_relaxed);
+							mine.push_back(static_cast<uint32_t>(v));
+							edges += graph.outDegree(v);
+							break;
+						}
+					}
+				}
+			}
+			foundEdges[thread] = edges;
+			barrier.wait();
+			
+			if (thread == 0) {
+				size_t size = 0;
+				size_t frontierEdges = 0;
+				for (size_t t = 0; t < threads; ++t) {
+					offsets[t] = size;
+					size += found[t].size();
+					frontierEdges += foundEdges[t];
+				}
+				frontier.resize(size);
+				unexploredEdges -= frontierEdges;
+				
+				if (forwards && frontierEdges > unexploredEdges / GRAPH_BFS_ALPHA) {
+					forwards = false;
+				}
+				else if (!forwards && size < vertices / GRAPH_BFS_BETA) {
+					forwards = true;
+				}
+				done = size == 0;
+			}
+			barrier.wait();
+			
+			for (size_t i = 0; i < mine.size(); ++i) {
+				frontier[offsets[thread] + i] = mine[i];
+			}
+			mine.clear();
+			barrier.wait();
+		}
+	});
+	
+	DynamicArray<uint32_t> result(vertices);
+	for (size_t v = 0; v < vertices; ++v) {
+		result[v] = levels[v].load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+/**
+ * Finds the shortest distances from one vertex to all the others with the
+ * Bellman-Ford algorithm.
+ *
+ * Unlike dijkstra, this allows edges with weights less than zero. Weight
+ * must be a type std::atomic supports, such as an integer or double.
+ *
+ * @throws	OutOfBoundsError	when start is not a vertex of the graph
+ * @throws	NegativeCycleError	when there is a path from start to a cycle
+ * 	with weights adding up to less than zero
+ * @param	graph	The graph to search
+ * @param	start	The vertex the paths start at
+ * @param	threads	The number of threads to use, or 0 for one per hardware
+ * 	thread
+ * @return	The length of the shortest path to each vertex, or the greatest
+ * 	Weight for vertices with no path to them
+ */
+template <typename Weight>
+DynamicArray<Weight> bellmanFord(const Graph<Weight>& graph, uint32_t start, size_t threads = 0) {
+	static_assert(std::is_arithmetic<Weight>::value, "bellmanFord needs weights that std::atomic supports");
+	
+	const size_t vertices = graph.vertexCount();
+	FUNDAMENTALS_CHECK_BOUNDS(start < vertices);
+	threads = graphThreads(threads, vertices);
+	
+	std::unique_ptr<std::atomic<Weight>[]> distances(new std::atomic<Weight>[vertices]);
+	// Whether each vertex is in the next round's frontier already
+	std::unique_ptr<std::atomic<bool>[]> queued(new std::atomic<bool>[vertices]);
+	for (size_t v = 0; v < vertices; ++v) {
+		distances[v].store(std::numeric_limits<Weight>::max(), std::memory_order_relaxed);
+		queued[v].store(false, std::memory_order_relaxed);
+	}
+	distances[start].store(Weight(), std::memory_order_relaxed);
+	
+	std::vector<uint32_t> frontier(1, start);
+	std::vector<std::vector<uint32_t>> found(threads);
+	std::vector<size_t> offsets(threads);
+	
+	// Shared decisions, made by thread 0 between rounds
+	bool done = false;
+	bool negativeCycle = false;
+	GraphBarrier barrier(threads);
+	
+	runThreads(threads, [&](size_t thread) noexcept {
+		for (size_t round = 1; !done; ++round) {
+			std::vector<uint32_t>& mine = found[thread];
+			
+			// A vertex's distance can go down again while its edges are being
+			// relaxed, but then it is queued for the next round
+			for (size_t i = thread * frontier.size() / threads; i < (thread + 1) * frontier.size() / threads; ++i) {
+				uint32_t v = frontier[i];
+				const Weight distance = distances[v].load(std::memory_order_relaxed);
+				for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+					uint32_t next = graph.target(e);
+					Weight nextDistance = distance + graph.weight(e);
+					Weight known = distances[next].load(std::memory_order_relaxed);
+					while (nextDistance < known && !distances[next].compare_exchange_weak(known, nextDistance, std::memory_order_relaxed)) {
+					}
+					if (nextDistance < known && !queued[next].exchange(true, std::memory_order_relaxed)) {
+						mine.push_back(next);
+					}
+				}
+			}
+			barrier.wait();
+			
+			if (thread == 0) {
+				size_t size = 0;
+				for (size_t t = 0; t < threads; ++t) {
+					offsets[t] = size;
+					size += found[t].size();
+				}
+				frontier.resize(size);
+				
+				// Without a negative cycle, every distance is final after
+				// vertices - 1 rounds, so the round after that changes nothing
+				negativeCycle = size > 0 && round >= vertices;
+				done = size == 0 || negativeCycle;
+			}
+			barrier.wait();
+			
+			for (size_t i = 0; i < mine.size(); ++i) {
+				frontier[offsets[thread] + i] = mine[i];
+				queued[mine[i]].store(false, std::memory_order_relaxed);
+			}
+			mine.clear();
+			barrier.wait();
+		}
+	});
+	
+	if (negativeCycle) {
+		throw NegativeCycleError();
+	}
+	
+	DynamicArray<Weight> result(vertices);
+	for (size_t v = 0; v < vertices; ++v) {
+		result[v] = distances[v].load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+#endif // Fundamentals_GraphAlgorithms_hpp_
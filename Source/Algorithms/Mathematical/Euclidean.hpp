@@ -0,0 +1,360 @@
+/**
+ * Fundamentals :: Algorithms :: Euclidean Algorithms
+ * Author: Quinn Mortimer
+ *
+ * This file contains C++ versions of the Euclidean algorithms, on the
+ * built-in integer types, and on whole arrays of 64-bit integers at once.
+ */
+/**
+ * euclidean.py next to this file is the readable reference for each
+ * algorithm. These are the same algorithms, along with the changes that make
+ * them fast over many numbers:
+ *
+ * - gcd and extendedGcd are gcd and gcd_extended_iterative from the Python
+ *   file. They are constexpr, so they can be used in constant expressions,
+ *   and as there, the GCD they give is never negative.
+ * - binaryGcd is Stein's algorithm, which only shifts and subtracts. Every
+ *   step of the Euclidean algorithm is a division, which takes dozens of
+ *   cycles. Stein's algorithm takes out the factors of two that both numbers
+ *   share, then repeatedly replaces the larger number with the difference of
+ *   the two, with all its factors of two taken out by counting its trailing
+ *   zeros. The steps don't branch on which number is larger, so they don't
+ *   depend on the branch predictor guessing right.
+ * - modularInverse runs extendedGcd on a number and the modulus, and gives
+ *   the coefficient of the number, which is its inverse when the GCD is one.
+ * - gcdMany runs binaryGcd on EUCLIDEAN_LANES pairs of numbers side by side,
+ *   one step of each in turn, until every one of them is done. The steps of
+ *   different pairs don't depend on each other, so the processor can work on
+ *   all of them at once, and where the target has vector instructions for
+ *   them the compiler can put the lanes into one register. The array is
+ *   split between several threads too.
+ * - modularInverseMany splits the array between several threads.
+ *
+ * The functions that take arrays are given the number of threads to use, or
+ * 0 for one per hardware thread.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
+
+#include "Checks.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "Threads.hpp"
+
+#ifndef Fundamentals_Euclidean_hpp_
+#define Fundamentals_Euclidean_hpp_
+
+// The number of pairs gcdMany works on side by side.
+#define EUCLIDEAN_LANES 4
+// The fewest numbers the functions on arrays give each thread. Below this,
+// the cost of starting a thread is more than the time it saves.
+#define EUCLIDEAN_PARALLEL_CUTOFF 16384
+
+/**
+ * The result of the extended Euclidean algorithm for two integers a and b,
+ * where a * x + b * y = divisor.
+ */
+template <typename Integer>
+struct EuclideanBezout {
+	// The Bezout coefficients of a and b.
+	Integer x;
+	Integer y;
+	// The greatest common divisor of a and b.
+	Integer divisor;
+};
+
+/**
+ * Gives the magnitude of an integer.
+ * @param	value	The integer
+ * @return	value, or -value if it is negative
+ */
+template <typename Integer>
+constexpr Integer euclideanAbs(Integer value) {
+	if constexpr (std::is_signed<Integer>::value) {
+		return value < 0 ? -value : value;
+	}
+	else {
+		return value;
+	}
+}
+
+/**
+ * Counts the zeros below the lowest one bit of a number.
+ * @param	value	The number, which can't be 0
+ * @return	The number of trailing zeros
+ */
+constexpr unsigned euclideanTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+	unsigned zeros = 0;
+	while ((value & 1) == 0) {
+		value >>= 1;
+		++zeros;
+	}
+	return zeros;
+#endif
+}
+
+/**
+ * Clamps the number of threads for a function on an array.
+ * @param	threads	The number of threads asked for, or 0 for one per
+ * 	hardware thread
+ * @param	size	The number of elements in the array
+ * @return	The number of threads to use, which is at least one
+ */
+inline size_t euclideanThreads(size_t threads, size_t size) {
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads > size / EUCLIDEAN_PARALLEL_CUTOFF) {
+		threads = size / EUCLIDEAN_PARALLEL_CUTOFF;
+	}
+	return threads == 0 ? 1 : threads;
+}
+
+// ------------------ //
+// Scalar Algorithms //
+// ------------------ //
+/**
+ * Finds the greatest common divisor of two integers with the Euclidean
+ * algorithm.
+ *
+ * For signed types, the magnitude of the result has to fit in the type, so
+ * this isn't defined when either integer is the least value of the type.
+ *
+ * @param	a	The first integer
+ * @param	b	The second integer
+ * @return	The greatest common divisor, which is never negative, and is 0 if
+ * 	both integers are
+ */
+template <typename Integer>
+constexpr Integer gcd(Integer a, Integer b) {
+	static_assert(std::is_integral<Integer>::value, "gcd only works on integers");
+	
+	while (b != 0) {
+		Integer r = a % b;
+		a = b;
+		b = r;
+	}
+	
+	return euclideanAbs(a);
+}
+/**
+ * Finds the greatest common divisor of two integers and their Bezout
+ * coefficients with the extended Euclidean algorithm.
+ *
+ * The coefficients can be negative, so this is only for signed types.
+ *
+ * @param	a	The first integer
+ * @param	b	The second integer
+ * @return	The coefficients x and y, and the divisor, which is never
+ * 	negative, such that a * x + b * y is the divisor
+ */
+template <typename Integer>
+constexpr EuclideanBezout<Integer> extendedGcd(Integer a, Integer b) {
+	static_assert(std::is_integral<Integer>::value && std::is_signed<Integer>::value, "extendedGcd only works on signed integers");
+	
+	Integer x0 = 1, x1 = 0;
+	Integer y0 = 0, y1 = 1;
+	
+	while (b != 0) {
+		Integer q = a / b;
+		Integer x = x0 - q * x1;
+		x0 = x1;
+		x1 = x;
+		Integer y = y0 - q * y1;
+		y0 = y1;
+		y1 = y;
+		
+		Integer r = a % b;
+		a = b;
+		b = r;
+	}
+	
+	if (a < 0) {
+		return EuclideanBezout<Integer>{-x0, -y0, -a};
+	}
+	return EuclideanBezout<Integer>{x0, y0, a};
+}
+/**
+ * Finds the greatest common divisor of two integers with Stein's algorithm.
+ * @param	a	The first integer
+ * @param	b	The second integer
+ * @return	The greatest common divisor, which is 0 if both integers are
+ */
+constexpr uint64_t binaryGcd(uint64_t a, uint64_t b) {
+	if (a == 0) {
+		return b;
+	}
+	if (b == 0) {
+		return a;
+	}
+	
+	// The factors of two that both share are put back at the end
+	const unsigned shift = euclideanTrailingZeros(a | b);
+	a >>= euclideanTrailingZeros(a);
+	b >>= euclideanTrailingZeros(b);
+	
+	// Both are odd, so their difference is even, and not zero until they meet
+	while (a != b) {
+		uint64_t difference = a > b ? a - b : b - a;
+		a = a < b ? a : b;
+		b = difference >> euclideanTrailingZeros(difference);
+	}
+	
+	return a << shift;
+}
+/**
+ * Finds the inverse of a number modulo another, which is the number that
+ * gives 1 modulo the modulus when multiplied with it.
+ *
+ * Only numbers that share no factors with the modulus have inverses, so this
+ * gives 0 for the others, which is never an inverse (unless the modulus is 1,
+ * when every number is 0).
+ *
+ * The coefficients are kept in signed 64-bit integers, so the modulus has to
+ * fit in one.
+ *
+ * @throws	InvalidModulusError	when modulus is 0 or above INT64_MAX
+ * @param	value	The number to invert
+ * @param	modulus	The modulus
+ * @return	The inverse, from 0 up to modulus - 1, or 0 if there is none
+ */
+constexpr uint64_t modularInverse(uint64_t value, uint64_t modulus) {
+	if (modulus == 0 || modulus > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+		throw InvalidModulusError();
+	}
+	
+	EuclideanBezout<int64_t> result = extendedGcd(static_cast<int64_t>(value % modulus), static_cast<int64_t>(modulus));
+	if (result.divisor != 1) {
+		return 0;
+	}
+	
+	return result.x < 0 ? static_cast<uint64_t>(result.x + static_cast<int64_t>(modulus)) : static_cast<uint64_t>(result.x);
+}
+
+// ----------------- //
+// Array Algorithms //
+// ----------------- //
+/**
+ * Finds the greatest common divisors of a stretch of pairs of numbers, with
+ * Stein's algorithm on EUCLIDEAN_LANES pairs at a time.
+ *
+ * Each step of a group of pairs shifts and subtracts every one of them that
+ * isn't finished yet, and keeps the ones that are as they are, without
+ * branching on either.
+ *
+ * @param	a	The first numbers
+ * @param	b	The second numbers
+ * @param	divisors	Where the divisors are written
+ * @param	count	The number of pairs
+ */
+inline void gcdLanes(const uint64_t* a, const uint64_t* b, uint64_t* divisors, size_t count) {
+	// Or-ing this in before counting trailing zeros means 0 never has to be
+	// counted, and it only changes the count for numbers that are 0
+	const uint64_t top = uint64_t(1) << 63;
+	
+	size_t i = 0;
+	for (; i + EUCLIDEAN_LANES <= count; i += EUCLIDEAN_LANES) {
+		uint64_t odd[EUCLIDEAN_LANES];
+		uint64_t rest[EUCLIDEAN_LANES];
+		unsigned shifts[EUCLIDEAN_LANES];
+		for (size_t lane = 0; lane < EUCLIDEAN_LANES; ++lane) {
+			// The GCD of 0 and b is b, which is what the steps give for b and b
+			uint64_t x = a[i + lane] != 0 ? a[i + lane] : b[i + lane];
+			uint64_t y = b[i + lane] != 0 ? b[i + lane] : x;
+			shifts[lane] = euclideanTrailingZeros(x | y | top);
+			odd[lane] = x >> euclideanTrailingZeros(x | top);
+			rest[lane] = y;
+		}
+		
+		// A lane is finished once the rest of it is 0
+		uint64_t unfinished;
+		do {
+			unfinished = 0;
+			for (size_t lane = 0; lane < EUCLIDEAN_LANES; ++lane) {
+				uint64_t x = odd[lane];
+				uint64_t y = rest[lane] >> euclideanTrailingZeros(rest[lane] | top);
+				uint64_t low = x < y ? x : y;
+				uint64_t high = x < y ? y : x;
+				odd[lane] = rest[lane] != 0 ? low : x;
+				rest[lane] = rest[lane] != 0 ? high - low : 0;
+				unfinished |= rest[lane];
+			}
+		} while (unfinished != 0);
+		
+		for (size_t lane = 0; lane < EUCLIDEAN_LANES; ++lane) {
+			divisors[i + lane] = odd[lane] << shifts[lane];
+		}
+	}
+	
+	for (; i < count; ++i) {
+		divisors[i] = binaryGcd(a[i], b[i]);
+	}
+}
+/**
+ * Finds the greatest common divisor of each pair of numbers at the same
+ * position in two arrays.
+ * @throws	OutOfBoundsError	when the arrays are different sizes
+ * @param	a	The first numbers
+ * @param	b	The second numbers
+ * @param	threads	The number of threads to use, or 0 for one per hardware
+ * 	thread
+ * @return	The divisors, in the same order as the pairs
+ */
+inline DynamicArray<uint64_t> gcdMany(const DynamicArray<uint64_t>& a, const DynamicArray<uint64_t>& b, size_t threads = 0) {
+	FUNDAMENTALS_CHECK_BOUNDS(a.size() == b.size());
+	
+	const size_t size = a.size();
+	DynamicArray<uint64_t> divisors(size);
+	threads = euclideanThreads(threads, size);
+	if (size == 0) {
+		return divisors;
+	}
+	
+	const uint64_t* first = a.begin();
+	const uint64_t* second = b.begin();
+	uint64_t* out = divisors.begin();
+	runThreads(threads, [&](size_t thread) {
+		const size_t start = thread * size / threads;
+		const size_t end = (thread + 1) * size / threads;
+		gcdLanes(first + start, second + start, out + start, end - start);
+	});
+	
+	return divisors;
+}
+/**
+ * Finds the inverse of each number in an array modulo the same modulus.
+ * @throws	InvalidModulusError	when modulus is 0 or above INT64_MAX
+ * @param	values	The numbers to invert
+ * @param	modulus	The modulus
+ * @param	threads	The number of threads to use, or 0 for one per hardware
+ * 	thread
+ * @return	The inverses, in the same order as the numbers, with 0 for those
+ * 	that have none
+ */
+inline DynamicArray<uint64_t> modularInverseMany(const DynamicArray<uint64_t>& values, uint64_t modulus, size_t threads = 0) {
+	// Checked here, so the threads can't throw
+	if (modulus == 0 || modulus > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+		throw InvalidModulusError();
+	}
+	
+	const size_t size = values.size();
+	DynamicArray<uint64_t> inverses(size);
+	threads = euclideanThreads(threads, size);
+	
+	runThreads(threads, [&](size_t thread) {
+		for (size_t i = thread * size / threads; i < (thread + 1) * size / threads; ++i) {
+			inverses[i] = modularInverse(values[i], modulus);
+		}
+	});
+	
+	return inverses;
+}
+
+#endif // Fundamentals_Euclidean_hpp_
@@ -0,0 +1,651 @@
+/**
+ * Fundamentals :: Algorithms :: Sorting
+ * Author: Quinn Mortimer
+ *
+ * This file contains C++ versions of the sorting algorithms, which sort any
+ * range of random access iterators, such as those of DynamicArray.
+ */
+/**
+ * The Python files next to this one are the readable reference for each
+ * algorithm. These are the same algorithms with the changes that make them
+ * fast on real machines:
+ *
+ * - introsort is quicksort, with two changes. Small partitions are finished
+ *   with insertion sort, which is faster than quicksort on a handful of
+ *   elements. And if the partitions keep coming out lopsided, the rest of
+ *   that part of the range is heap sorted instead, so a bad input can never
+ *   take quadratic time.
+ * - mergeSort is a bottom-up merge sort. It insertion sorts short runs, then
+ *   merges pairs of runs back and forth between the range and a buffer, so no
+ *   elements are copied except by the merges themselves.
+ * - parallelMergeSort splits the range into one share per thread and merge
+ *   sorts each share at the same time. Each merge after that is split between
+ *   the threads too: for any position in the output of a merge, a binary
+ *   search finds how many of its elements come from each run, so every
+ *   thread can be given an equal stretch of the output to fill.
+ * - radixSort sorts integers by one byte of them at a time, starting at the
+ *   lowest, without comparing them at all. It counts the bytes for every pass
+ *   in a single read of the range, and skips the passes where every element
+ *   has the same byte.
+ *
+ * introsort and heapSort are not stable: equal elements can end up in a
+ * different order than they started in. The merge sorts are stable.
+ *
+ * parallelMergeSort calls the comparison from all of its threads at once, so
+ * it must be safe to call concurrently. If the comparison throws, the
+ * exception is passed on after every thread has stopped, and the range is
+ * left with unspecified values.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Threads.hpp"
+
+#ifndef Fundamentals_Sorting_hpp_
+#define Fundamentals_Sorting_hpp_
+
+// The longest partition or run that is insertion sorted rather than split
+// any further.
+#define SORTING_INSERTION_CUTOFF 16
+// The fewest elements parallelMergeSort gives each thread. Below this, the
+// cost of starting a thread is more than the time it saves.
+#define SORTING_PARALLEL_CUTOFF 16384
+// The number of bits of an integer that radixSort sorts by in each pass.
+#define SORTING_RADIX_BITS 8
+
+// --------------- //
+// Insertion Sort //
+// --------------- //
+/**
+ * Sorts a range by moving each element back into place among the sorted
+ * elements before it.
+ *
+ * This takes quadratic time in general, but is the fastest sort for very
+ * short ranges and ranges that are already nearly sorted.
+ *
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void insertionSort(RandomIt first, RandomIt last, Compare compare) {
+	if (last - first < 2) {
+		return;
+	}
+	
+	for (RandomIt i = first + 1; i != last; ++i) {
+		auto value = std::move(*i);
+		RandomIt j = i;
+		while (j != first && compare(value, *(j - 1))) {
+			*j = std::move(*(j - 1));
+			--j;
+		}
+		*j = std::move(value);
+	}
+}
+template <typename RandomIt>
+void insertionSort(RandomIt first, RandomIt last) {
+	insertionSort(first, last, std::less<>());
+}
+
+// ---------- //
+// Heap Sort //
+// ---------- //
+/**
+ * Moves an element of a max-heap down until neither of its children is
+ * greater than it.
+ * @param	first	The start of the heap
+ * @param	index	The position of the element to move down
+ * @param	size	The number of elements in the heap
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void heapSiftDown(RandomIt first, size_t index, size_t size, Compare& compare) {
+	auto value = std::move(first[index]);
+	
+	while (2 * index + 1 < size) {
+		size_t child = 2 * index + 1;
+		if (child + 1 < size && compare(first[child], first[child + 1])) {
+			++child;
+		}
+		if (!compare(value, first[child])) {
+			break;
+		}
+		first[index] = std::move(first[child]);
+		index = child;
+	}
+	
+	first[index] = std::move(value);
+}
+
+/**
+ * Sorts a range by arranging it into a max-heap, then repeatedly swapping
+ * the greatest element left in the heap to the end of it.
+ *
+ * This always takes O(n log n) time and no extra memory, but jumps around the
+ * range too much to be as fast as introsort on large ranges.
+ *
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void heapSort(RandomIt first, RandomIt last, Compare compare) {
+	const size_t size = last - first;
+	if (size < 2) {
+		return;
+	}
+	
+	for (size_t i = size / 2; i > 0; --i) {
+		heapSiftDown(first, i - 1, size, compare);
+	}
+	for (size_t end = size - 1; end > 0; --end) {
+		std::iter_swap(first, first + end);
+		heapSiftDown(first, 0, end, compare);
+	}
+}
+template <typename RandomIt>
+void heapSort(RandomIt first, RandomIt last) {
+	heapSort(first, last, std::less<>());
+}
+
+// ---------- //
+// Introsort //
+// ---------- //
+/**
+ * Partitions a range around the median of three of its elements.
+ *
+ * The median of the second, middle and last elements is moved to the front
+ * as the pivot. Sorting those three first also means there is an element no
+ * less than the pivot at the end, so the scans can't run off the range.
+ * Elements equal to the pivot are split between the two sides, so ranges
+ * with many equal elements still partition evenly.
+ *
+ * @param	first	The start of the range, which has at least 3 elements
+ * @param	last	The end of the range
+ * @param	compare	Gives whether its first argument goes before its second
+ * @return	The position the pivot ends up at. Nothing before it goes after
+ * 	it, and nothing after it goes before it.
+ */
+template <typename RandomIt, typename Compare>
+RandomIt introsortPartition(RandomIt first, RandomIt last, Compare& compare) {
+	RandomIt low = first + 1;
+	RandomIt mid = first + (last - first) / 2;
+	RandomIt high = last - 1;
+	if (compare(*mid, *low)) {
+		std::iter_swap(mid, low);
+	}
+	if (compare(*high, *mid)) {
+		std::iter_swap(high, mid);
+		if (compare(*mid, *low)) {
+			std::iter_swap(mid, low);
+		}
+	}
+	std::iter_swap(first, mid);
+	
+	RandomIt left = first + 1;
+	RandomIt right = last - 1;
+	while (true) {
+		while (compare(*left, *first)) {
+			++left;
+		}
+		while (compare(*first, *right)) {
+			--right;
+		}
+		if (!(left < right)) {
+			break;
+		}
+		std::iter_swap(left, right);
+		++left;
+		--right;
+	}
+	
+	std::iter_swap(first, right);
+	return right;
+}
+
+/**
+ * Sorts a range with introsort, giving up on quicksort after a number of
+ * partitions.
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ * @param	depth	How many more times the range may be partitioned before
+ * 	it is heap sorted instead
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void introsortLoop(RandomIt first, RandomIt last, size_t depth, Compare& compare) {
+	while (last - first > SORTING_INSERTION_CUTOFF) {
+		if (depth == 0) {
+			heapSort(first, last, compare);
+			return;
+		}
+		--depth;
+		
+		// Recursing on the smaller side and looping on the larger keeps the
+		// stack to O(log n) deep
+		RandomIt pivot = introsortPartition(first, last, compare);
+		if (pivot - first < last - pivot) {
+			introsortLoop(first, pivot, depth, compare);
+			first = pivot + 1;
+		}
+		else {
+			introsortLoop(pivot + 1, last, depth, compare);
+			last = pivot;
+		}
+	}
+	
+	insertionSort(first, last, compare);
+}
+
+/**
+ * Sorts a range with introsort.
+ *
+ * The range is heap sorted once it has been partitioned twice as many times
+ * as it would take to split perfectly down to single elements.
+ *
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void introsort(RandomIt first, RandomIt last, Compare compare) {
+	size_t depth = 0;
+	for (size_t size = last - first; size > 1; size >>= 1) {
+		depth += 2;
+	}
+	
+	introsortLoop(first, last, depth, compare);
+}
+template <typename RandomIt>
+void introsort(RandomIt first, RandomIt last) {
+	introsort(first, last, std::less<>());
+}
+
+// ----------- //
+// Merge Sort //
+// ----------- //
+/**
+ * Merges part of two sorted runs, moving the elements to a destination.
+ *
+ * Where elements of the two runs are equal, those from the left run go
+ * first, which is what makes the merge sorts stable.
+ *
+ * @param	left	The next element of the left run
+ * @param	leftEnd	The end of the part of the left run to merge
+ * @param	right	The next element of the right run
+ * @param	rightEnd	The end of the part of the right run to merge
+ * @param	to	Where to move the first merged element to
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename FromIt, typename ToIt, typename Compare>
+void mergeRuns(FromIt left, FromIt leftEnd, FromIt right, FromIt rightEnd, ToIt to, Compare& compare) {
+	while (left != leftEnd && right != rightEnd) {
+		if (compare(*right, *left)) {
+			*to = std::move(*right);
+			++right;
+		}
+		else {
+			*to = std::move(*left);
+			++left;
+		}
+		++to;
+	}
+	
+	for (; left != leftEnd; ++left, ++to) {
+		*to = std::move(*left);
+	}
+	for (; right != rightEnd; ++right, ++to) {
+		*to = std::move(*right);
+	}
+}
+
+/**
+ * Finds how many elements of the left run are among the first elements of
+ * the merge of two sorted runs.
+ * @param	left	The start of the left run
+ * @param	leftSize	The number of elements in the left run
+ * @param	right	The start of the right run
+ * @param	rightSize	The number of elements in the right run
+ * @param	count	The number of merged elements, at most leftSize + rightSize
+ * @param	compare	Gives whether its first argument goes before its second
+ * @return	The number of the first count merged elements that are from the
+ * 	left run. The rest are from the right run.
+ */
+template <typename FromIt, typename Compare>
+size_t mergeSplit(FromIt left, size_t leftSize, FromIt right, size_t rightSize, size_t count, Compare& compare) {
+	size_t low = count > rightSize ? count - rightSize : 0;
+	size_t high = count < leftSize ? count : leftSize;
+	
+	// Taking i from the left means taking count - i from the right. Too few
+	// are taken from the left while the last one taken from the right doesn't
+	// go strictly before the next one left in the left run.
+	while (low < high) {
+		size_t i = low + (high - low) / 2;
+		if (!compare(right[count - i - 1], left[i])) {
+			low = i + 1;
+		}
+		else {
+			high = i;
+		}
+	}
+	
+	return low;
+}
+
+/**
+ * Merge sorts a range, using a buffer of the same size.
+ * @param	first	The start of the range to sort
+ * @param	size	The number of elements in the range
+ * @param	buffer	The start of the buffer, whose elements are overwritten
+ * @param	compare	Gives whether its first argument goes before its second
+ * @return	Whether the sorted elements ended up in the buffer, rather than
+ * 	the range
+ */
+template <typename RandomIt, typename BufferIt, typename Compare>
+bool mergeSortInto(RandomIt first, size_t size, BufferIt buffer, Compare& compare) {
+	for (size_t start = 0; start < size; start += SORTING_INSERTION_CUTOFF) {
+		size_t end = size - start < SORTING_INSERTION_CUTOFF ? size : start + SORTING_INSERTION_CUTOFF;
+		insertionSort(first + start, first + end, compare);
+	}
+	
+	bool inBuffer = false;
+	for (size_t width = SORTING_INSERTION_CUTOFF; width < size; width *= 2) {
+		for (size_t start = 0; start < size; start += 2 * width) {
+			size_t mid = size - start < width ? size : start + width;
+			size_t end = size - mid < width ? size : mid + width;
+			if (inBuffer) {
+				mergeRuns(buffer + start, buffer + mid, buffer + mid, buffer + end, first + start, compare);
+			}
+			else {
+				mergeRuns(first + start, first + mid, first + mid, first + end, buffer + start, compare);
+			}
+		}
+		inBuffer = !inBuffer;
+	}
+	
+	return inBuffer;
+}
+
+/**
+ * Sorts a range with a bottom-up merge sort.
+ *
+ * This needs a buffer as large as the range, which the elements are moved
+ * into to start with.
+ *
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void mergeSort(RandomIt first, RandomIt last, Compare compare) {
+	typedef typename std::iterator_traits<RandomIt>::value_type T;
+	
+	const size_t size = last - first;
+	if (size <= SORTING_INSERTION_CUTOFF) {
+		insertionSort(first, last, compare);
+		return;
+	}
+	
+	// The elements are sorted in the buffer, with the range as the other
+	// half, so the buffer can be built from the elements themselves
+	std::vector<T> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+	if (!mergeSortInto(buffer.begin(), size, first, compare)) {
+		for (size_t i = 0; i < size; ++i) {
+			first[i] = std::move(buffer[i]);
+		}
+	}
+}
+template <typename RandomIt>
+void mergeSort(RandomIt first, RandomIt last) {
+	mergeSort(first, last, std::less<>());
+}
+
+/**
+ * Merges pairs of neighbouring sorted runs, with each of several threads
+ * filling an equal stretch of the output.
+ *
+ * Every thread first finds where its stretch starts in the runs, and only
+ * once they all have do any of them start moving elements, so that none of
+ * them compares an element another has already moved away.
+ *
+ * @param	source	The start of the sorted runs
+ * @param	dest	The start of where to move the merged runs to
+ * @param	size	The total number of elements in the runs
+ * @param	threads	The number of threads to use
+ * @param	runs	The boundaries of the sorted runs, from 0 to size
+ * @param	merged	The boundaries of the merged runs, which are every other
+ * 	boundary in runs, and size
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename SourceIt, typename DestIt, typename Compare>
+void mergeSortRound(SourceIt source, DestIt dest, size_t size, size_t threads, const std::vector<size_t>& runs, const std::vector<size_t>& merged, Compare& compare) {
+	// For each thread, the merged run its stretch starts in, and how many of
+	// the elements of that run before the stretch are from its left half
+	std::vector<size_t> startRuns(threads);
+	std::vector<size_t> startLefts(threads);
+	runThreads(threads, [&](size_t thread) {
+		const size_t outStart = thread * size / threads;
+		size_t r = 0;
+		while (merged[r + 1] <= outStart) {
+			++r;
+		}
+		const size_t start = merged[r];
+		const size_t end = merged[r + 1];
+		const size_t mid = 2 * r + 1 < runs.size() ? runs[2 * r + 1] : end;
+		
+		startRuns[thread] = r;
+		startLefts[thread] = mergeSplit(source + start, mid - start, source + mid, end - mid, outStart - start, compare);
+	});
+	
+	runThreads(threads, [&](size_t thread) {
+		const size_t outStart = thread * size / threads;
+		const size_t outEnd = (thread + 1) * size / threads;
+		
+		// Fill this thread's stretch one merged run at a time
+		for (size_t r = startRuns[thread]; r + 1 < merged.size() && merged[r] < outEnd; ++r) {
+			const size_t start = merged[r];
+			const size_t end = merged[r + 1];
+			// The last merged run may have no right half
+			const size_t mid = 2 * r + 1 < runs.size() ? runs[2 * r + 1] : end;
+			
+			const size_t from = outStart > start ? outStart - start : 0;
+			const size_t fromLeft = outStart > start ? startLefts[thread] : 0;
+			const size_t to = outEnd < end ? outEnd - start : end - start;
+			const size_t toLeft = outEnd < end ? startLefts[thread + 1] : mid - start;
+			
+			mergeRuns(source + start + fromLeft, source + start + toLeft, source + mid + (from - fromLeft), source + mid + (to - toLeft), dest + start + from, compare);
+		}
+	});
+}
+
+/**
+ * Sorts a range with a merge sort split between several threads.
+ *
+ * The range is split into one share per thread, but never into shares
+ * smaller than SORTING_PARALLEL_CUTOFF, so short ranges are sorted on the
+ * calling thread alone.
+ *
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ * @param	threads	The number of threads to use, or 0 for one per hardware
+ * 	thread
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename RandomIt, typename Compare>
+void parallelMergeSort(RandomIt first, RandomIt last, size_t threads, Compare compare) {
+	typedef typename std::iterator_traits<RandomIt>::value_type T;
+	
+	const size_t size = last - first;
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads > size / SORTING_PARALLEL_CUTOFF) {
+		threads = size / SORTING_PARALLEL_CUTOFF;
+	}
+	if (threads < 2) {
+		mergeSort(first, last, compare);
+		return;
+	}
+	
+	std::vector<T> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+	
+	// Each thread sorts its share into either the buffer or the range, so the
+	// shares that land in the range are moved to the buffer to catch up
+	std::vector<size_t> runs(threads + 1);
+	for (size_t t = 0; t <= threads; ++t) {
+		runs[t] = t * size / threads;
+	}
+	runThreads(threads, [&](size_t thread) {
+		size_t start = runs[thread];
+		size_t count = runs[thread + 1] - start;
+		if (mergeSortInto(buffer.begin() + start, count, first + start, compare)) {
+			for (size_t i = start; i < start + count; ++i) {
+				buffer[i] = std::move(first[i]);
+			}
+		}
+	});
+	
+	// Each round merges pairs of neighbouring runs, with every thread filling
+	// an equal stretch of the merged output
+	bool inBuffer = true;
+	while (runs.size() > 2) {
+		std::vector<size_t> merged;
+		merged.reserve(runs.size() / 2 + 2);
+		for (size_t r = 0; r < runs.size(); r += 2) {
+			merged.push_back(runs[r]);
+		}
+		if (merged.back() != size) {
+			merged.push_back(size);
+		}
+		
+		if (inBuffer) {
+			mergeSortRound(buffer.begin(), first, size, threads, runs, merged, compare);
+		}
+		else {
+			mergeSortRound(first, buffer.begin(), size, threads, runs, merged, compare);
+		}
+		
+		runs.swap(merged);
+		inBuffer = !inBuffer;
+	}
+	
+	if (inBuffer) {
+		runThreads(threads, [&](size_t thread) {
+			for (size_t i = thread * size / threads; i < (thread + 1) * size / threads; ++i) {
+				first[i] = std::move(buffer[i]);
+			}
+		});
+	}
+}
+template <typename RandomIt>
+void parallelMergeSort(RandomIt first, RandomIt last, size_t threads = 0) {
+	parallelMergeSort(first, last, threads, std::less<>());
+}
+
+// ----------- //
+// Radix Sort //
+// ----------- //
+/**
+ * Gives the bits of an integer in an order where unsigned comparison sorts
+ * them the same way as the integers themselves.
+ *
+ * For unsigned integers these are just the integer. For signed ones, the sign
+ * bit is flipped, so that negative numbers come before positive ones.
+ *
+ * @param	value	The integer
+ * @return	The bits to sort it by
+ */
+template <typename T>
+typename std::make_unsigned<T>::type radixKey(T value) {
+	typedef typename std::make_unsigned<T>::type U;
+	
+	U key = static_cast<U>(value);
+	if (std::is_signed<T>::value) {
+		key ^= static_cast<U>(U(1) << (std::numeric_limits<U>::digits - 1));
+	}
+	return key;
+}
+
+/**
+ * Sorts a range of integers by their bytes, from the lowest to the highest.
+ *
+ * Each pass is a stable counting sort of one byte, which moves the elements
+ * between the range and a buffer as large as it. All of the counts are made
+ * in one read of the range before any elements move, and any pass where
+ * every element has the same byte is skipped, so integers with empty high
+ * bytes (such as small sizes or indices) take fewer passes.
+ *
+ * @param	first	The start of the range to sort
+ * @param	last	The end of the range to sort
+ */
+template <typename RandomIt>
+void radixSort(RandomIt first, RandomIt last) {
+	typedef typename std::iterator_traits<RandomIt>::value_type T;
+	static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "radixSort only sorts integers");
+	
+	const size_t buckets = size_t(1) << SORTING_RADIX_BITS;
+	const size_t passes = (sizeof(T) * 8 + SORTING_RADIX_BITS - 1) / SORTING_RADIX_BITS;
+	const size_t size = last - first;
+	if (size <= SORTING_INSERTION_CUTOFF) {
+		insertionSort(first, last);
+		return;
+	}
+	
+	std::vector<size_t> counts(passes * buckets, 0);
+	for (RandomIt i = first; i != last; ++i) {
+		auto key = radixKey(*i);
+		for (size_t pass = 0; pass < passes; ++pass) {
+			++counts[pass * buckets + ((key >> (pass * SORTING_RADIX_BITS)) & (buckets - 1))];
+		}
+	}
+	
+	std::vector<T> buffer(size);
+	bool inBuffer = false;
+	for (size_t pass = 0; pass < passes; ++pass) {
+		size_t* offsets = counts.data() + pass * buckets;
+		const size_t shift = pass * SORTING_RADIX_BITS;
+		
+		// Turn the counts into where each byte value starts, skipping the pass
+		// if they are all the same
+		bool trivial = false;
+		size_t total = 0;
+		for (size_t b = 0; b < buckets; ++b) {
+			size_t count = offsets[b];
+			trivial = trivial || count == size;
+			offsets[b] = total;
+			total += count;
+		}
+		if (trivial) {
+			continue;
+		}
+		
+		if (inBuffer) {
+			for (size_t i = 0; i < size; ++i) {
+				first[offsets[(radixKey(buffer[i]) >> shift) & (buckets - 1)]++] = buffer[i];
+			}
+		}
+		else {
+			for (size_t i = 0; i < size; ++i) {
+				buffer[offsets[(radixKey(first[i]) >> shift) & (buckets - 1)]++] = first[i];
+			}
+		}
+		inBuffer = !inBuffer;
+	}
+	
+	if (inBuffer) {
+		for (size_t i = 0; i < size; ++i) {
+			first[i] = buffer[i];
+		}
+	}
+}
+
+#endif // Fundamentals_Sorting_hpp_
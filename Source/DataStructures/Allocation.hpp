@@ -0,0 +1,106 @@
+/**
+ * Fundamentals :: Data Structures :: Allocation
+ * Author: Quinn Mortimer
+ *
+ * This file contains a small utility for the data structures that take an
+ * Allocator parameter.
+ *
+ * An allocator here is anything that works with std::allocator_traits, which
+ * includes std::allocator and std::pmr::polymorphic_allocator. The data
+ * structures get all of their memory through the allocator, and construct
+ * their elements through it as well. That way an allocator like
+ * polymorphic_allocator can pass itself on to elements that take an
+ * allocator of their own, such as a std::pmr::string.
+ *
+ * Allocators that use fancy pointer types (anything other than a plain T*)
+ * aren't supported.
+ */
+
+#include <memory>
+#include <utility>
+
+#ifndef Fundamentals_Allocation_hpp_
+#define Fundamentals_Allocation_hpp_
+
+/**
+ * Stores an allocator without using any space when it is empty.
+ *
+ * This works the same way as HashHolder in Hashing.hpp. std::allocator has
+ * no data members, so the data structures privately inherit from this class
+ * rather than keeping the allocator as a member.
+ */
+template <typename Allocator>
+class AllocatorHolder : private Allocator {
+	public:
+		// Constructors
+		AllocatorHolder();
+		AllocatorHolder(const Allocator& allocator);
+		AllocatorHolder(Allocator&& allocator);
+		
+		// Access to the stored allocator
+		const Allocator& allocator() const;
+		Allocator& allocator();
+};
+
+// ------------------------- //
+// AllocatorHolder Methods //
+// ------------------------- //
+/**
+ * Stores a default-constructed allocator.
+ */
+template <typename Allocator>
+AllocatorHolder<Allocator>::AllocatorHolder()
+	: Allocator()
+{}
+/**
+ * Stores a copy of the provided allocator.
+ * @param	allocator	The allocator to copy
+ */
+template <typename Allocator>
+AllocatorHolder<Allocator>::AllocatorHolder(const Allocator& allocator)
+	: Allocator(allocator)
+{}
+/**
+ * Stores the provided allocator by moving it.
+ * @param	allocator	The allocator to move from
+ */
+template <typename Allocator>
+AllocatorHolder<Allocator>::AllocatorHolder(Allocator&& allocator)
+	: Allocator(std::move(allocator))
+{}
+/**
+ * Provides a constant reference to the stored allocator.
+ * @return	The stored allocator
+ */
+template <typename Allocator>
+const Allocator& AllocatorHolder<Allocator>::allocator() const {
+	return *this;
+}
+/**
+ * Provides a reference to the stored allocator.
+ * @return	The stored allocator
+ */
+template <typename Allocator>
+Allocator& AllocatorHolder<Allocator>::allocator() {
+	return *this;
+}
+
+/**
+ * Swaps two allocators when the containers holding them are swapped.
+ *
+ * This only happens if the allocator's propagate_on_container_swap is true.
+ * Otherwise each container keeps its own allocator, and the two allocators
+ * have to compare equal for the contents to be swapped.
+ *
+ * @param	a	The allocator of one container
+ * @param	b	The allocator of the other container
+ */
+template <typename Allocator>
+void swapAllocators(Allocator& a, Allocator& b) {
+	if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+		using std::swap;
+		swap(a, b);
+	}
+}
+
+#endif // Fundamentals_Allocation_hpp_
@@ -0,0 +1,1704 @@
+/**
+ * Fundamentals :: Data Structures :: B-Tree Map
+ * Author: Quinn Mortimer
+ *
+ * This is an implementation of an ordered map as a B+ tree, which keeps its
+ * keys in sorted order so that they can be walked through in order, and
+ * searched for by range.
+ * It is intended as a reference for those looking to brush up on important
+ * data structures.
+ */
+/**
+ * A binary search tree has one key per node, and every step down the tree
+ * follows a pointer to a node somewhere else in memory, which is usually a
+ * wait for the cache. A B-tree puts many keys in each node instead, so the
+ * tree is only a few levels deep, and most of the work of a search is a
+ * binary search over one node's keys, which are next to each other.
+ *
+ * This is the B+ tree variant. Every key and value is kept in a leaf, and the
+ * leaves are linked together in order, so iterating over the map or over a
+ * range of keys walks along arrays of them. Each branch above the leaves has
+ * up to BTREEMAP_ORDER children, and one key fewer to tell them apart: the
+ * key between two children is the least key under the one on the right.
+ *
+ * Every node but the root stays at least half full. Inserting splits the
+ * full nodes it passes on the way down, and removing fills up the half full
+ * ones it passes, from a neighbour or by merging with it, so both only go
+ * down the tree once.
+ *
+ * Building a map from a whole range at once sorts the range (unless it is
+ * sorted already) and then fills the leaves and branches from left to right,
+ * without searching the tree at all. Copies are built the same way.
+ *
+ * The map has the same insert, remove, set, unset, hasKey and getValue as
+ * HashMap, so the two can be swapped for one another, with an ordering in
+ * place of a hash function. The entries of each leaf are kept in raw arrays,
+ * and a key and value are only constructed when their entry is added, as in
+ * HashMap's nodes. The branches keep their keys in plain arrays, though, so
+ * keys have to be default constructible. The nodes are allocated with new.
+ *
+ * We will be using std::vector for building trees from ranges.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Checks.hpp"
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_BTreeMap_hpp_
+#define Fundamentals_BTreeMap_hpp_
+
+// The most entries a leaf holds, and the most children a branch has.
+#define BTREEMAP_ORDER 64
+
+// Forward declaration of the BTreeMap class.
+template <typename Key, typename Value, typename Compare = std::less<Key>> class BTreeMap;
+// Forward declaration of our two iterator classes.
+template <typename Key, typename Value> class BTreeMap_Iterator;
+template <typename Key, typename Value> class BTreeMap_ConstIterator;
+
+/**
+ * The part of a BTreeMap's nodes that leaves and branches share.
+ */
+struct BTreeMap_Node {
+	// The number of entries in a leaf, or of children of a branch.
+	size_t count;
+};
+
+/**
+ * A node at the bottom of a BTreeMap, which holds keys and their values in
+ * order.
+ *
+ * Only the first count keys and values are constructed. The rest of the
+ * arrays are raw storage, so an empty leaf doesn't construct anything.
+ */
+template <typename Key, typename Value>
+struct BTreeMap_Leaf : BTreeMap_Node {
+	// The leaf with the next keys in order, or nullptr for the last leaf.
+	BTreeMap_Leaf<Key, Value>* next;
+	
+	// Constructor and destructor for a leaf.
+	// A new leaf is empty, and destroying a leaf destroys its entries.
+	BTreeMap_Leaf();
+	~BTreeMap_Leaf();
+	
+	// Leaves are only ever made by the map, so they aren't copied.
+	BTreeMap_Leaf(const BTreeMap_Leaf<Key, Value>& other) = delete;
+	
+	// Access to the entries, in order.
+	Key* keys();
+	const Key* keys() const;
+	Value* values();
+	const Value* values() const;
+	
+	// Adding and removing entries, keeping the others in order.
+	template <typename K, typename V>
+	void insert(size_t index, K&& key, V&& value);
+	void erase(size_t index);
+	void take(BTreeMap_Leaf<Key, Value>& other, size_t first);
+	
+private:
+	// Storage for the keys and values of the entries.
+	alignas(Key) unsigned char m_keyStorage[sizeof(Key) * BTREEMAP_ORDER];
+	alignas(Value) unsigned char m_valueStorage[sizeof(Value) * BTREEMAP_ORDER];
+};
+
+/**
+ * A node above the leaves of a BTreeMap, which holds its children in order.
+ *
+ * keys[i] is the least key under children[i + 1].
+ */
+template <typename Key>
+struct BTreeMap_Branch : BTreeMap_Node {
+	Key keys[BTREEMAP_ORDER - 1];
+	BTreeMap_Node* children[BTREEMAP_ORDER];
+};
+
+/**
+ * An ordered map of keys to values, kept in a B+ tree.
+ *
+ * Compare gives whether one key goes before another, as for std::map.
+ */
+template <typename Key, typename Value, typename Compare>
+class BTreeMap {
+	static_assert(BTREEMAP_ORDER >= 4, "BTREEMAP_ORDER must be at least 4");
+	
+	public:
+		typedef size_t size_type;
+		typedef Compare key_compare;
+		typedef BTreeMap_Iterator<Key, Value> iterator;
+		typedef BTreeMap_ConstIterator<Key, Value> const_iterator;
+		
+		// Constructors
+		BTreeMap();
+		explicit BTreeMap(const key_compare& compare);
+		BTreeMap(BTreeMap<Key, Value, Compare>&& other);
+		BTreeMap(const BTreeMap<Key, Value, Compare>& other);
+		template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+		BTreeMap(InputIt first, InputIt last, const key_compare& compare = key_compare());
+		BTreeMap(std::initializer_list<std::pair<Key, Value>> list, const key_compare& compare = key_compare());
+		
+		// Destructor
+		~BTreeMap();
+		
+		// Assignment
+		BTreeMap<Key, Value, Compare>& operator=(const BTreeMap<Key, Value, Compare>& other);
+		BTreeMap<Key, Value, Compare>& operator=(BTreeMap<Key, Value, Compare>&& other);
+		
+		// Equality Testing
+		bool operator==(const BTreeMap<Key, Value, Compare>& other) const;
+		bool operator!=(const BTreeMap<Key, Value, Compare>& other) const;
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Element insertion and deletion
+		// - Functions that can throw exceptions
+		void insert(const Key& k, const Value& v);
+		template <typename InputIt>
+		void insert_range(InputIt first, InputIt last);
+		void remove(const Key& k);
+		// - Function that will not throw exceptions
+		void set(const Key& k, const Value& v);
+		void unset(const Key& k);
+		
+		// Data Access
+		// - Check for a key
+		bool hasKey(const Key& k) const;
+		// - Get elements by key
+		Value& operator[](const Key& k);
+		const Value& operator[](const Key& k) const;
+		Value& getValue(const Key& k);
+		const Value& getValue(const Key& k) const;
+		// - Look up keys that might be missing without exceptions
+		Value* find(const Key& k);
+		const Value* find(const Key& k) const;
+		bool try_get(const Key& k, Value& value) const;
+		// - Get all keys or all values, in order
+		std::vector<Key> keys() const;
+		std::vector<Value> values() const;
+		
+		// Ordered access
+		// - Iterators over every key in order
+		iterator begin();
+		const_iterator begin() const;
+		iterator end();
+		const_iterator end() const;
+		// - Iterators to the first key at least, or greater than, a key
+		iterator lower_bound(const Key& k);
+		const_iterator lower_bound(const Key& k) const;
+		iterator upper_bound(const Key& k);
+		const_iterator upper_bound(const Key& k) const;
+		// - Visiting every key in a range
+		template <typename Function>
+		void scan(const Key& low, const Key& high, Function function) const;
+		
+	private:
+		typedef BTreeMap_Node Node;
+		typedef BTreeMap_Leaf<Key, Value> Leaf;
+		typedef BTreeMap_Branch<Key> Branch;
+		
+		// The fewest entries or children a node other than the root can have.
+		static constexpr size_type s_minimum = BTREEMAP_ORDER / 2;
+		
+		// The root of the tree, or nullptr if nothing has been added yet.
+		Node* mp_root;
+		// The leaf with the least keys.
+		Leaf* mp_first;
+		// The number of keys in the map.
+		size_type m_size;
+		// The number of levels of branches above the leaves.
+		size_type m_height;
+		// The ordering of the keys.
+		key_compare m_compare;
+		
+		// These are utilites for internal use.
+		// - Searching down the tree.
+		size_type m_childIndex(const Branch* branch, const Key& key) const;
+		size_type m_leafIndex(const Leaf* leaf, const Key& key) const;
+		Leaf* m_findLeaf(const Key& key) const;
+		bool m_matches(const Leaf* leaf, size_type index, const Key& key) const;
+		// - Finding where a key goes, splitting full nodes on the way down.
+		std::pair<Leaf*, size_type> m_insertPosition(const Key& key);
+		void m_insertAt(Leaf* leaf, size_type index, const Key& key, const Value& value);
+		void m_splitChild(Branch* branch, size_type index, size_type level);
+		// - Removing a key, filling half full nodes on the way down.
+		bool m_erase(const Key& key);
+		size_type m_refill(Branch* branch, size_type index, size_type level);
+		void m_borrowLeft(Branch* branch, size_type index, size_type level);
+		void m_borrowRight(Branch* branch, size_type index, size_type level);
+		void m_merge(Branch* branch, size_type index, size_type level);
+		// - Building the whole tree from sorted entries.
+		template <typename InputIt>
+		static std::vector<std::pair<Key, Value>> m_sorted(InputIt first, InputIt last, const key_compare& compare);
+		void m_build(std::vector<std::pair<Key, Value>>& entries);
+		// - Freeing nodes.
+		static void m_destroy(Node* node, size_type level);
+		
+		// Positions in the leaves.
+		static std::pair<Leaf*, size_type> m_normalize(Leaf* leaf, size_type index);
+};
+
+/**
+ * An iterator over a BTreeMap that provides read-write access to the values.
+ *
+ * The keys and values are in separate arrays, so rather than a pair, an
+ * iterator gives its key and value with key() and value(). Inserting or
+ * removing any key invalidates every iterator.
+ */
+template <typename Key, typename Value>
+class BTreeMap_Iterator {
+	public:
+		// Constructor
+		BTreeMap_Iterator();
+		
+		// Equality test operators
+		bool operator==(const BTreeMap_Iterator<Key, Value>& other) const;
+		bool operator!=(const BTreeMap_Iterator<Key, Value>& other) const;
+		bool operator==(const BTreeMap_ConstIterator<Key, Value>& other) const;
+		bool operator!=(const BTreeMap_ConstIterator<Key, Value>& other) const;
+		
+		// Data access
+		const Key& key() const;
+		Value& value() const;
+		
+		// Increment operators
+		BTreeMap_Iterator<Key, Value>& operator++();
+		BTreeMap_Iterator<Key, Value> operator++(int);
+	private:
+		typedef BTreeMap_Leaf<Key, Value> Leaf;
+		// The leaf this iterator is in, or nullptr at the end.
+		Leaf* r_leaf;
+		// The position of the entry in the leaf.
+		size_t r_index;
+		
+		// Position constructor
+		// This is on its own in the private section because
+		// the user should not call it, but it is used by the BTreeMap class.
+		BTreeMap_Iterator(Leaf* leaf, size_t index);
+		
+	// BTreeMap and BTreeMap_ConstIterator both need access to private
+	// members of this class.
+	template <typename, typename, typename> friend class BTreeMap;
+	friend class BTreeMap_ConstIterator<Key, Value>;
+};
+
+/**
+ * An iterator over a BTreeMap that provides read-only access to the values.
+ */
+template <typename Key, typename Value>
+class BTreeMap_ConstIterator {
+	public:
+		// Constructors
+		BTreeMap_ConstIterator();
+		BTreeMap_ConstIterator(const BTreeMap_Iterator<Key, Value>& other);
+		
+		// Equality test operators
+		bool operator==(const BTreeMap_ConstIterator<Key, Value>& other) const;
+		bool operator!=(const BTreeMap_ConstIterator<Key, Value>& other) const;
+		bool operator==(const BTreeMap_Iterator<Key, Value>& other) const;
+		bool operator!=(const BTreeMap_Iterator<Key, Value>& other) const;
+		
+		// Data access
+		const Key& key() const;
+		const Value& value() const;
+		
+		// Increment operators
+		BTreeMap_ConstIterator<Key, Value>& operator++();
+		BTreeMap_ConstIterator<Key, Value> operator++(int);
+	private:
+		typedef BTreeMap_Leaf<Key, Value> Leaf;
+		const Leaf* r_leaf;
+		size_t r_index;
+		
+		// Position constructor
+		// This is on its own in the private section because
+		// the user should not call it, but it is used by the BTreeMap class.
+		BTreeMap_ConstIterator(const Leaf* leaf, size_t index);
+		
+	// BTreeMap and BTreeMap_Iterator both need access to private
+	// members of this class.
+	template <typename, typename, typename> friend class BTreeMap;
+	friend class BTreeMap_Iterator<Key, Value>;
+};
+
+// ---------------------- //
+// BTreeMap_Leaf Methods //
+// ---------------------- //
+/**
+ * Creates an empty leaf, with no leaf after it.
+ */
+template <typename Key, typename Value>
+BTreeMap_Leaf<Key, Value>::BTreeMap_Leaf()
+	: next(nullptr)
+{
+	count = 0;
+}
+/**
+ * Destroys the keys and values of the entries left in the leaf.
+ */
+template <typename Key, typename Value>
+BTreeMap_Leaf<Key, Value>::~BTreeMap_Leaf() {
+	for (size_t i = 0; i < count; ++i) {
+		keys()[i].~Key();
+		values()[i].~Value();
+	}
+}
+
+/**
+ * Provides the keys of the leaf's entries.
+ * @return	A pointer to the first key, followed by the other count - 1
+ */
+template <typename Key, typename Value>
+Key* BTreeMap_Leaf<Key, Value>::keys() {
+	return reinterpret_cast<Key*>(m_keyStorage);
+}
+/**
+ * Provides the keys of the leaf's entries.
+ * @return	A constant pointer to the first key, followed by the other count - 1
+ */
+template <typename Key, typename Value>
+const Key* BTreeMap_Leaf<Key, Value>::keys() const {
+	return reinterpret_cast<const Key*>(m_keyStorage);
+}
+/**
+ * Provides the values of the leaf's entries, in the same order as the keys.
+ * @return	A pointer to the first value, followed by the other count - 1
+ */
+template <typename Key, typename Value>
+Value* BTreeMap_Leaf<Key, Value>::values() {
+	return reinterpret_cast<Value*>(m_valueStorage);
+}
+/**
+ * Provides the values of the leaf's entries, in the same order as the keys.
+ * @return	A constant pointer to the first value, followed by the other
+ * 	count - 1
+ */
+template <typename Key, typename Value>
+const Value* BTreeMap_Leaf<Key, Value>::values() const {
+	return reinterpret_cast<const Value*>(m_valueStorage);
+}
+
+/**
+ * Adds an entry to a leaf that has room for it.
+ *
+ * The entry after the last one is constructed, by moving the last entry into
+ * it, and the entries from index on are moved along by one to make a gap.
+ * Only an entry added at the end is constructed from the new key and value.
+ *
+ * @param	index	The position for the entry, at most count
+ * @param	key	The key of the entry
+ * @param	value	The value of the entry
+ */
+template <typename Key, typename Value>
+template <typename K, typename V>
+void BTreeMap_Leaf<Key, Value>::insert(size_t index, K&& key, V&& value) {
+	if (index == count) {
+		::new (static_cast<void*>(keys() + count)) Key(std::forward<K>(key));
+		try {
+			::new (static_cast<void*>(values() + count)) Value(std::forward<V>(value));
+		}
+		catch (...) {
+			keys()[count].~Key();
+			throw;
+		}
+		++count;
+		return;
+	}
+	
+	::new (static_cast<void*>(keys() + count)) Key(std::move(keys()[count - 1]));
+	try {
+		::new (static_cast<void*>(values() + count)) Value(std::move(values()[count - 1]));
+	}
+	catch (...) {
+		keys()[count].~Key();
+		throw;
+	}
+	++count;
+	
+	std::move_backward(keys() + index, keys() + count - 2, keys() + count - 1);
+	std::move_backward(values() + index, values() + count - 2, values() + count - 1);
+	keys()[index] = std::forward<K>(key);
+	values()[index] = std::forward<V>(value);
+}
+/**
+ * Removes an entry from the leaf, moving the entries after it back by one.
+ * @param	index	The position of the entry, less than count
+ */
+template <typename Key, typename Value>
+void BTreeMap_Leaf<Key, Value>::erase(size_t index) {
+	std::move(keys() + index + 1, keys() + count, keys() + index);
+	std::move(values() + index + 1, values() + count, values() + index);
+	--count;
+	keys()[count].~Key();
+	values()[count].~Value();
+}
+/**
+ * Moves the entries of another leaf, from a position on, to the end of this
+ * one, which has room for them. The other leaf is left with the entries
+ * before that position.
+ * @param	other	The leaf to take the entries from
+ * @param	first	The position of the first entry to take
+ */
+template <typename Key, typename Value>
+void BTreeMap_Leaf<Key, Value>::take(BTreeMap_Leaf<Key, Value>& other, size_t first) {
+	for (size_t i = first; i < other.count; ++i) {
+		insert(count, std::move(other.keys()[i]), std::move(other.values()[i]));
+	}
+	while (other.count > first) {
+		--other.count;
+		other.keys()[other.count].~Key();
+		other.values()[other.count].~Value();
+	}
+}
+
+// ----------------- //
+// BTreeMap Methods //
+// ----------------- //
+/**
+ * Creates an empty map.
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>::BTreeMap()
+	: BTreeMap(key_compare())
+{}
+/**
+ * Creates an empty map with a given ordering of its keys.
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>::BTreeMap(const key_compare& compare)
+	: mp_root(nullptr), mp_first(nullptr), m_size(0), m_height(0), m_compare(compare)
+{}
+/**
+ * Moves the tree of another map into a new one, leaving the other empty.
+ * @param	other	The map to move from
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>::BTreeMap(BTreeMap<Key, Value, Compare>&& other)
+	: mp_root(other.mp_root), mp_first(other.mp_first), m_size(other.m_size), m_height(other.m_height), m_compare(other.m_compare)
+{
+	other.mp_root = nullptr;
+	other.mp_first = nullptr;
+	other.m_size = 0;
+	other.m_height = 0;
+}
+/**
+ * Copies another map.
+ *
+ * The copy is built from the other map's keys in order, like a map built
+ * from a sorted range, so its leaves are as full as they can be.
+ *
+ * @param	other	The map to copy
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>::BTreeMap(const BTreeMap<Key, Value, Compare>& other)
+	: BTreeMap(other.m_compare)
+{
+	std::vector<std::pair<Key, Value>> entries;
+	entries.reserve(other.m_size);
+	for (const Leaf* leaf = other.mp_first; leaf != nullptr; leaf = leaf->next) {
+		for (size_type i = 0; i < leaf->count; ++i) {
+			entries.emplace_back(leaf->keys()[i], leaf->values()[i]);
+		}
+	}
+	
+	m_build(entries);
+}
+/**
+ * Creates a map of the key-value pairs in a range.
+ *
+ * The range is sorted first, unless it is sorted already, and then the tree
+ * is built from the bottom up in one go, which is much faster than inserting
+ * the pairs one at a time.
+ *
+ * @throws	DuplicateKeyError	When the range holds the same key twice
+ * @param	first	The start of the range, of pairs with the key as their
+ * 	first member and the value as their second
+ * @param	last	The end of the range
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt, typename>
+BTreeMap<Key, Value, Compare>::BTreeMap(InputIt first, InputIt last, const key_compare& compare)
+	: BTreeMap(compare)
+{
+	std::vector<std::pair<Key, Value>> entries = m_sorted(first, last, m_compare);
+	m_build(entries);
+}
+/**
+ * Creates a map of the key-value pairs in a list.
+ * @throws	DuplicateKeyError	When the list holds the same key twice
+ * @param	list	The key-value pairs
+ * @param	compare	Gives whether its first argument goes before its second
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>::BTreeMap(std::initializer_list<std::pair<Key, Value>> list, const key_compare& compare)
+	: BTreeMap(list.begin(), list.end(), compare)
+{}
+
+/**
+ * Frees every node of the tree.
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>::~BTreeMap() {
+	m_destroy(mp_root, m_height);
+}
+
+/**
+ * Replaces the contents of this map with a copy of another's.
+ * @param	other	The map to copy
+ * @return	This map
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>& BTreeMap<Key, Value, Compare>::operator=(const BTreeMap<Key, Value, Compare>& other) {
+	if (this != &other) {
+		*this = BTreeMap<Key, Value, Compare>(other);
+	}
+	
+	return *this;
+}
+/**
+ * Replaces the contents of this map with another's, leaving the other empty.
+ * @param	other	The map to move from
+ * @return	This map
+ */
+template <typename Key, typename Value, typename Compare>
+BTreeMap<Key, Value, Compare>& BTreeMap<Key, Value, Compare>::operator=(BTreeMap<Key, Value, Compare>&& other) {
+	if (this != &other) {
+		m_destroy(mp_root, m_height);
+		
+		mp_root = other.mp_root;
+		mp_first = other.mp_first;
+		m_size = other.m_size;
+		m_height = other.m_height;
+		m_compare = other.m_compare;
+		
+		other.mp_root = nullptr;
+		other.mp_first = nullptr;
+		other.m_size = 0;
+		other.m_height = 0;
+	}
+	
+	return *this;
+}
+
+/**
+ * Checks if two maps hold the same keys, with equal values.
+ *
+ * The keys are walked through in order in both maps at once, so the maps are
+ * equal even when their trees are shaped differently.
+ *
+ * @param	other	The map to compare with
+ * @return	Whether the maps are equal
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::operator==(const BTreeMap<Key, Value, Compare>& other) const {
+	if (m_size != other.m_size) {
+		return false;
+	}
+	
+	for (const_iterator a = begin(), b = other.begin(); a != end(); ++a, ++b) {
+		if (m_compare(a.key(), b.key()) || m_compare(b.key(), a.key()) || !(a.value() == b.value())) {
+			return false;
+		}
+	}
+	
+	return true;
+}
+/**
+ * Checks if two maps differ in their keys or values.
+ * @param	other	The map to compare with
+ * @return	Whether the maps are not equal
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::operator!=(const BTreeMap<Key, Value, Compare>& other) const {
+	return !(*this == other);
+}
+
+/**
+ * Reports the number of keys in the map.
+ * @return	The number of key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::size_type BTreeMap<Key, Value, Compare>::size() const {
+	return m_size;
+}
+/**
+ * Reports whether or not the map is empty.
+ * @return	Whether there are any keys in the map
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Inserts a key, and a value for it, into the map.
+ * @throws	DuplicateKeyError	When the key is already in the map
+ * @param	key	The key to insert a value for
+ * @param	value	The value that corresponds to the key
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::insert(const Key& key, const Value& value) {
+	std::pair<Leaf*, size_type> position = m_insertPosition(key);
+	
+	if (m_matches(position.first, position.second, key)) {
+		throw DuplicateKeyError();
+	}
+	
+	m_insertAt(position.first, position.second, key, value);
+}
+/**
+ * Inserts every key-value pair in a range into the map.
+ *
+ * When the map is empty, it is built from the range in one go, as with the
+ * range constructor, and nothing is added if the range holds the same key
+ * twice. Otherwise the pairs are inserted one at a time, and the pairs before
+ * a key that is already in the map are still added.
+ *
+ * @throws	DuplicateKeyError	When a key in the range is already in the map
+ * @param	first	The start of the range, of pairs with the key as their
+ * 	first member and the value as their second
+ * @param	last	The end of the range
+ */
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt>
+void BTreeMap<Key, Value, Compare>::insert_range(InputIt first, InputIt last) {
+	if (m_size == 0) {
+		std::vector<std::pair<Key, Value>> entries = m_sorted(first, last, m_compare);
+		m_destroy(mp_root, m_height);
+		mp_root = nullptr;
+		mp_first = nullptr;
+		m_height = 0;
+		m_build(entries);
+		return;
+	}
+	
+	for (; first != last; ++first) {
+		insert((*first).first, (*first).second);
+	}
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ * @throws	MissingKeyError	When the key is not in the map
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::remove(const Key& key) {
+	if (!m_erase(key)) {
+		throw MissingKeyError();
+	}
+}
+/**
+ * Sets the value corresponding to a key in this map.
+ *
+ * This can be used as a permissive version of insert.
+ * If the key was already in the map, it will just overwrite the old value.
+ *
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::set(const Key& key, const Value& value) {
+	std::pair<Leaf*, size_type> position = m_insertPosition(key);
+	
+	if (m_matches(position.first, position.second, key)) {
+		position.first->values()[position.second] = value;
+	}
+	else {
+		m_insertAt(position.first, position.second, key, value);
+	}
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ *
+ * This is the permissiver version of remove. If the key was not in the map
+ * in the first place, it just won't do anything.
+ *
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::unset(const Key& key) {
+	m_erase(key);
+}
+
+/**
+ * Checks if a key is currently in the map.
+ * @param	key	The key to check for
+ * @return	A boolean representing whether or not the key exists
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::hasKey(const Key& key) const {
+	return find(key) != nullptr;
+}
+/**
+ * Gets a reference to the value stored at a given key.
+ *
+ * If the key isn't in the map, it is added with a default constructed value.
+ *
+ * @param	key	The key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Compare>
+Value& BTreeMap<Key, Value, Compare>::operator[](const Key& key) {
+	std::pair<Leaf*, size_type> position = m_insertPosition(key);
+	
+	if (!m_matches(position.first, position.second, key)) {
+		m_insertAt(position.first, position.second, key, Value());
+	}
+	
+	return position.first->values()[position.second];
+}
+/**
+ * Gets the value stored at a given key.
+ *
+ * A missing key can't be added to a constant map, so this throws instead.
+ *
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Compare>
+const Value& BTreeMap<Key, Value, Compare>::operator[](const Key& key) const {
+	return getValue(key);
+}
+/**
+ * Gets a reference to the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Compare>
+Value& BTreeMap<Key, Value, Compare>::getValue(const Key& key) {
+	Value* value = find(key);
+	if (value == nullptr) {
+		throw MissingKeyError();
+	}
+	
+	return *value;
+}
+/**
+ * Gets the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Compare>
+const Value& BTreeMap<Key, Value, Compare>::getValue(const Key& key) const {
+	const Value* value = find(key);
+	if (value == nullptr) {
+		throw MissingKeyError();
+	}
+	
+	return *value;
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ * @param	key	The key to get the mapped value for
+ * @return	A pointer to the value key refers to, or nullptr if it's missing.
+ * 	It is invalidated by inserting or removing any key.
+ */
+template <typename Key, typename Value, typename Compare>
+Value* BTreeMap<Key, Value, Compare>::find(const Key& key) {
+	if (mp_root == nullptr) {
+		return nullptr;
+	}
+	
+	Leaf* leaf = m_findLeaf(key);
+	size_type index = m_leafIndex(leaf, key);
+	return m_matches(leaf, index, key) ? &leaf->values()[index] : nullptr;
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ * @param	key	The key to get the mapped value for
+ * @return	A constant pointer to the value key refers to, or nullptr if it's
+ * 	missing. It is invalidated by inserting or removing any key.
+ */
+template <typename Key, typename Value, typename Compare>
+const Value* BTreeMap<Key, Value, Compare>::find(const Key& key) const {
+	if (mp_root == nullptr) {
+		return nullptr;
+	}
+	
+	const Leaf* leaf = m_findLeaf(key);
+	size_type index = m_leafIndex(leaf, key);
+	return m_matches(leaf, index, key) ? &leaf->values()[index] : nullptr;
+}
+/**
+ * Copies out the value stored at a key, if the key is in the map.
+ * @param	key	The key to get the mapped value for
+ * @param	value	Set to a copy of the mapped value when the key is found,
+ * 	and left alone otherwise
+ * @return	Whether the key was found
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::try_get(const Key& key, Value& value) const {
+	const Value* found = find(key);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	value = *found;
+	return true;
+}
+
+/**
+ * Gets a sequence of all the keys in this map, in order.
+ * @return	A vector containing all keys in this map
+ */
+template <typename Key, typename Value, typename Compare>
+std::vector<Key> BTreeMap<Key, Value, Compare>::keys() const {
+	std::vector<Key> keys(0);
+	keys.reserve(m_size);
+	
+	for (const Leaf* leaf = mp_first; leaf != nullptr; leaf = leaf->next) {
+		keys.insert(keys.end(), leaf->keys(), leaf->keys() + leaf->count);
+	}
+	
+	return keys;
+}
+/**
+ * Gets a sequence of all the values in this map, in the order of their keys.
+ * @return	A vector containing all values in this map
+ */
+template <typename Key, typename Value, typename Compare>
+std::vector<Value> BTreeMap<Key, Value, Compare>::values() const {
+	std::vector<Value> values(0);
+	values.reserve(m_size);
+	
+	for (const Leaf* leaf = mp_first; leaf != nullptr; leaf = leaf->next) {
+		values.insert(values.end(), leaf->values(), leaf->values() + leaf->count);
+	}
+	
+	return values;
+}
+
+/**
+ * Creates an iterator at the least key in the map.
+ * @return	An iterator at the first key, or the end if the map is empty
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::iterator BTreeMap<Key, Value, Compare>::begin() {
+	std::pair<Leaf*, size_type> position = m_normalize(mp_first, 0);
+	return iterator(position.first, position.second);
+}
+/**
+ * Creates a constant iterator at the least key in the map.
+ * @return	An iterator at the first key, or the end if the map is empty
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::const_iterator BTreeMap<Key, Value, Compare>::begin() const {
+	std::pair<Leaf*, size_type> position = m_normalize(mp_first, 0);
+	return const_iterator(position.first, position.second);
+}
+/**
+ * Creates an iterator past the greatest key in the map.
+ * @return	The end iterator
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::iterator BTreeMap<Key, Value, Compare>::end() {
+	return iterator(nullptr, 0);
+}
+/**
+ * Creates a constant iterator past the greatest key in the map.
+ * @return	The end iterator
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::const_iterator BTreeMap<Key, Value, Compare>::end() const {
+	return const_iterator(nullptr, 0);
+}
+/**
+ * Finds the first key that doesn't go before a given key.
+ * @param	key	The key to search for
+ * @return	An iterator at key if it is in the map, or else at the next key
+ * 	after it, or the end if there is none
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::iterator BTreeMap<Key, Value, Compare>::lower_bound(const Key& key) {
+	if (mp_root == nullptr) {
+		return end();
+	}
+	
+	Leaf* leaf = m_findLeaf(key);
+	std::pair<Leaf*, size_type> position = m_normalize(leaf, m_leafIndex(leaf, key));
+	return iterator(position.first, position.second);
+}
+/**
+ * Finds the first key that doesn't go before a given key.
+ * @param	key	The key to search for
+ * @return	A constant iterator at key if it is in the map, or else at the
+ * 	next key after it, or the end if there is none
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::const_iterator BTreeMap<Key, Value, Compare>::lower_bound(const Key& key) const {
+	return const_cast<BTreeMap<Key, Value, Compare>*>(this)->lower_bound(key);
+}
+/**
+ * Finds the first key that goes after a given key.
+ * @param	key	The key to search for
+ * @return	An iterator at the next key after key, or the end if there is none
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::iterator BTreeMap<Key, Value, Compare>::upper_bound(const Key& key) {
+	if (mp_root == nullptr) {
+		return end();
+	}
+	
+	Leaf* leaf = m_findLeaf(key);
+	size_type index = std::upper_bound(leaf->keys(), leaf->keys() + leaf->count, key, m_compare) - leaf->keys();
+	std::pair<Leaf*, size_type> position = m_normalize(leaf, index);
+	return iterator(position.first, position.second);
+}
+/**
+ * Finds the first key that goes after a given key.
+ * @param	key	The key to search for
+ * @return	A constant iterator at the next key after key, or the end if
+ * 	there is none
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::const_iterator BTreeMap<Key, Value, Compare>::upper_bound(const Key& key) const {
+	return const_cast<BTreeMap<Key, Value, Compare>*>(this)->upper_bound(key);
+}
+/**
+ * Calls a function on every key in a range, and its value, in order.
+ *
+ * This searches the tree once for the start of the range, then walks along
+ * the leaves' arrays, which is faster than stepping an iterator.
+ *
+ * @param	low	The least key of the range
+ * @param	high	The key just past the range, which isn't included
+ * @param	function	Called with each key and a constant reference to its
+ * 	value
+ */
+template <typename Key, typename Value, typename Compare>
+template <typename Function>
+void BTreeMap<Key, Value, Compare>::scan(const Key& low, const Key& high, Function function) const {
+	if (mp_root == nullptr) {
+		return;
+	}
+	
+	const Leaf* leaf = m_findLeaf(low);
+	size_type index = m_leafIndex(leaf, low);
+	while (leaf != nullptr) {
+		for (; index < leaf->count; ++index) {
+			if (!m_compare(leaf->keys()[index], high)) {
+				return;
+			}
+			function(leaf->keys()[index], static_cast<const Value&>(leaf->values()[index]));
+		}
+		leaf = leaf->next;
+		index = 0;
+	}
+}
+
+/**
+ * Finds which child of a branch a key would be under.
+ * @param	branch	The branch
+ * @param	key	The key
+ * @return	The number of keys in the branch that don't go after key
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::size_type BTreeMap<Key, Value, Compare>::m_childIndex(const Branch* branch, const Key& key) const {
+	return std::upper_bound(branch->keys, branch->keys + branch->count - 1, key, m_compare) - branch->keys;
+}
+/**
+ * Finds where in a leaf a key is, or would go.
+ * @param	leaf	The leaf
+ * @param	key	The key
+ * @return	The number of keys in the leaf that go before key
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::size_type BTreeMap<Key, Value, Compare>::m_leafIndex(const Leaf* leaf, const Key& key) const {
+	return std::lower_bound(leaf->keys(), leaf->keys() + leaf->count, key, m_compare) - leaf->keys();
+}
+/**
+ * Finds the leaf that a key is in, or would go in. The tree can't be empty.
+ * @param	key	The key
+ * @return	The leaf
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::Leaf* BTreeMap<Key, Value, Compare>::m_findLeaf(const Key& key) const {
+	Node* node = mp_root;
+	for (size_type level = m_height; level > 0; --level) {
+		Branch* branch = static_cast<Branch*>(node);
+		node = branch->children[m_childIndex(branch, key)];
+	}
+	
+	return static_cast<Leaf*>(node);
+}
+/**
+ * Checks whether the entry at a position in a leaf has a key.
+ * @param	leaf	The leaf
+ * @param	index	The position from m_leafIndex
+ * @param	key	The key
+ * @return	Whether the entry is there and its key is equivalent to key
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::m_matches(const Leaf* leaf, size_type index, const Key& key) const {
+	return index < leaf->count && !m_compare(key, leaf->keys()[index]);
+}
+
+/**
+ * Finds the leaf and position that a key is at, or would be inserted at.
+ *
+ * Every full node on the way down is split first, including the root, so the
+ * leaf has room for another entry and a split never has to go back up.
+ *
+ * @param	key	The key
+ * @return	The leaf, and the position in it from m_leafIndex
+ */
+template <typename Key, typename Value, typename Compare>
+std::pair<typename BTreeMap<Key, Value, Compare>::Leaf*, typename BTreeMap<Key, Value, Compare>::size_type> BTreeMap<Key, Value, Compare>::m_insertPosition(const Key& key) {
+	if (mp_root == nullptr) {
+		Leaf* leaf = new Leaf();
+		mp_root = leaf;
+		mp_first = leaf;
+	}
+	if (mp_root->count == BTREEMAP_ORDER) {
+		Branch* root = new Branch();
+		root->count = 1;
+		root->children[0] = mp_root;
+		try {
+			m_splitChild(root, 0, m_height);
+		}
+		catch (...) {
+			delete root;
+			throw;
+		}
+		mp_root = root;
+		++m_height;
+	}
+	
+	Node* node = mp_root;
+	for (size_type level = m_height; level > 0; --level) {
+		Branch* branch = static_cast<Branch*>(node);
+		size_type index = m_childIndex(branch, key);
+		if (branch->children[index]->count == BTREEMAP_ORDER) {
+			m_splitChild(branch, index, level - 1);
+			if (!m_compare(key, branch->keys[index])) {
+				++index;
+			}
+		}
+		node = branch->children[index];
+	}
+	
+	Leaf* leaf = static_cast<Leaf*>(node);
+	return std::pair<Leaf*, size_type>(leaf, m_leafIndex(leaf, key));
+}
+/**
+ * Puts a new entry into a leaf that has room for it.
+ * @param	leaf	The leaf
+ * @param	index	The position for the entry, from m_insertPosition
+ * @param	key	The key of the entry
+ * @param	value	The value of the entry
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_insertAt(Leaf* leaf, size_type index, const Key& key, const Value& value) {
+	leaf->insert(index, key, value);
+	++m_size;
+}
+/**
+ * Splits a full child of a branch in two, adding the new right half to the
+ * branch, which must have room for another child.
+ * @param	branch	The branch
+ * @param	index	Which of its children to split
+ * @param	level	The level of the child, where 0 is a leaf
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_splitChild(Branch* branch, size_type index, size_type level) {
+	const size_type half = BTREEMAP_ORDER / 2;
+	Node* right;
+	Key separator;
+	
+	if (level == 0) {
+		Leaf* left = static_cast<Leaf*>(branch->children[index]);
+		Leaf* leaf = new Leaf();
+		try {
+			leaf->take(*left, half);
+		}
+		catch (...) {
+			delete leaf;
+			throw;
+		}
+		leaf->next = left->next;
+		left->next = leaf;
+		separator = leaf->keys()[0];
+		right = leaf;
+	}
+	else {
+		// The key between the two halves moves up into the branch
+		Branch* left = static_cast<Branch*>(branch->children[index]);
+		Branch* split = new Branch();
+		std::move(left->keys + half, left->keys + BTREEMAP_ORDER - 1, split->keys);
+		std::copy(left->children + half, left->children + BTREEMAP_ORDER, split->children);
+		split->count = BTREEMAP_ORDER - half;
+		left->count = half;
+		separator = std::move(left->keys[half - 1]);
+		right = split;
+	}
+	
+	std::move_backward(branch->keys + index, branch->keys + branch->count - 1, branch->keys + branch->count);
+	std::copy_backward(branch->children + index + 1, branch->children + branch->count, branch->children + branch->count + 1);
+	branch->keys[index] = std::move(separator);
+	branch->children[index + 1] = right;
+	++branch->count;
+}
+
+/**
+ * Removes a key from the tree, if it's there.
+ *
+ * Every child on the way down that is only half full is filled up first, so
+ * the leaf can lose an entry without becoming less than half full, and a
+ * merge never has to go back up. When the root is left with one child, that
+ * child becomes the root.
+ *
+ * @param	key	The key to remove
+ * @return	Whether the key was in the tree
+ */
+template <typename Key, typename Value, typename Compare>
+bool BTreeMap<Key, Value, Compare>::m_erase(const Key& key) {
+	if (mp_root == nullptr) {
+		return false;
+	}
+	
+	Node* node = mp_root;
+	for (size_type level = m_height; level > 0; --level) {
+		Branch* branch = static_cast<Branch*>(node);
+		size_type index = m_childIndex(branch, key);
+		if (branch->children[index]->count == s_minimum) {
+			index = m_refill(branch, index, level - 1);
+		}
+		node = branch->children[index];
+	}
+	
+	while (m_height > 0 && mp_root->count == 1) {
+		Branch* root = static_cast<Branch*>(mp_root);
+		mp_root = root->children[0];
+		delete root;
+		--m_height;
+	}
+	
+	Leaf* leaf = static_cast<Leaf*>(node);
+	size_type index = m_leafIndex(leaf, key);
+	if (!m_matches(leaf, index, key)) {
+		return false;
+	}
+	
+	leaf->erase(index);
+	--m_size;
+	return true;
+}
+/**
+ * Gives a half full child of a branch another entry or child, from one of
+ * its neighbours if either has more than half, or else by merging it with
+ * one of them.
+ * @param	branch	The branch
+ * @param	index	Which of its children to fill
+ * @param	level	The level of the child, where 0 is a leaf
+ * @return	Which of the branch's children now holds what the child did
+ */
+template <typename Key, typename Value, typename Compare>
+typename BTreeMap<Key, Value, Compare>::size_type BTreeMap<Key, Value, Compare>::m_refill(Branch* branch, size_type index, size_type level) {
+	if (index > 0 && branch->children[index - 1]->count > s_minimum) {
+		m_borrowLeft(branch, index, level);
+		return index;
+	}
+	if (index + 1 < branch->count && branch->children[index + 1]->count > s_minimum) {
+		m_borrowRight(branch, index, level);
+		return index;
+	}
+	
+	if (index + 1 < branch->count) {
+		m_merge(branch, index, level);
+		return index;
+	}
+	m_merge(branch, index - 1, level);
+	return index - 1;
+}
+/**
+ * Moves the last entry or child of a branch's child to the start of the
+ * child after it.
+ * @param	branch	The branch
+ * @param	index	Which of its children to move to
+ * @param	level	The level of the children, where 0 is a leaf
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_borrowLeft(Branch* branch, size_type index, size_type level) {
+	if (level == 0) {
+		Leaf* left = static_cast<Leaf*>(branch->children[index - 1]);
+		Leaf* leaf = static_cast<Leaf*>(branch->children[index]);
+		leaf->insert(0, std::move(left->keys()[left->count - 1]), std::move(left->values()[left->count - 1]));
+		left->erase(left->count - 1);
+		branch->keys[index - 1] = leaf->keys()[0];
+	}
+	else {
+		// The moved child goes past the key between the two in the branch
+		Branch* left = static_cast<Branch*>(branch->children[index - 1]);
+		Branch* child = static_cast<Branch*>(branch->children[index]);
+		std::move_backward(child->keys, child->keys + child->count - 1, child->keys + child->count);
+		std::copy_backward(child->children, child->children + child->count, child->children + child->count + 1);
+		child->keys[0] = std::move(branch->keys[index - 1]);
+		child->children[0] = left->children[left->count - 1];
+		branch->keys[index - 1] = std::move(left->keys[left->count - 2]);
+		--left->count;
+		++child->count;
+	}
+}
+/**
+ * Moves the first entry or child of the child after a branch's child to the
+ * end of that child.
+ * @param	branch	The branch
+ * @param	index	Which of its children to move to
+ * @param	level	The level of the children, where 0 is a leaf
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_borrowRight(Branch* branch, size_type index, size_type level) {
+	if (level == 0) {
+		Leaf* leaf = static_cast<Leaf*>(branch->children[index]);
+		Leaf* right = static_cast<Leaf*>(branch->children[index + 1]);
+		leaf->insert(leaf->count, std::move(right->keys()[0]), std::move(right->values()[0]));
+		right->erase(0);
+		branch->keys[index] = right->keys()[0];
+	}
+	else {
+		Branch* child = static_cast<Branch*>(branch->children[index]);
+		Branch* right = static_cast<Branch*>(branch->children[index + 1]);
+		child->keys[child->count - 1] = std::move(branch->keys[index]);
+		child->children[child->count] = right->children[0];
+		++child->count;
+		branch->keys[index] = std::move(right->keys[0]);
+		std::move(right->keys + 1, right->keys + right->count - 1, right->keys);
+		std::copy(right->children + 1, right->children + right->count, right->children);
+		--right->count;
+	}
+}
+/**
+ * Merges a branch's child with the child after it, which is freed.
+ * @param	branch	The branch
+ * @param	index	Which of its children to merge into
+ * @param	level	The level of the children, where 0 is a leaf
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_merge(Branch* branch, size_type index, size_type level) {
+	if (level == 0) {
+		Leaf* leaf = static_cast<Leaf*>(branch->children[index]);
+		Leaf* right = static_cast<Leaf*>(branch->children[index + 1]);
+		leaf->take(*right, 0);
+		leaf->next = right->next;
+		delete right;
+	}
+	else {
+		// The key between the two comes down from the branch between them
+		Branch* child = static_cast<Branch*>(branch->children[index]);
+		Branch* right = static_cast<Branch*>(branch->children[index + 1]);
+		child->keys[child->count - 1] = std::move(branch->keys[index]);
+		std::move(right->keys, right->keys + right->count - 1, child->keys + child->count);
+		std::copy(right->children, right->children + right->count, child->children + child->count);
+		child->count += right->count;
+		delete right;
+	}
+	
+	std::move(branch->keys + index + 1, branch->keys + branch->count - 1, branch->keys + index);
+	std::copy(branch->children + index + 2, branch->children + branch->count, branch->children + index + 1);
+	--branch->count;
+}
+
+/**
+ * Copies the key-value pairs of a range into a vector, sorted by key.
+ * @throws	DuplicateKeyError	When the range holds the same key twice
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ * @param	compare	The ordering of the keys
+ * @return	The sorted pairs
+ */
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt>
+std::vector<std::pair<Key, Value>> BTreeMap<Key, Value, Compare>::m_sorted(InputIt first, InputIt last, const key_compare& compare) {
+	std::vector<std::pair<Key, Value>> entries;
+	for (; first != last; ++first) {
+		entries.emplace_back((*first).first, (*first).second);
+	}
+	
+	auto byKey = [&compare](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) {
+		return compare(a.first, b.first);
+	};
+	if (!std::is_sorted(entries.begin(), entries.end(), byKey)) {
+		std::sort(entries.begin(), entries.end(), byKey);
+	}
+	for (size_type i = 1; i < entries.size(); ++i) {
+		if (!compare(entries[i - 1].first, entries[i].first)) {
+			throw DuplicateKeyError();
+		}
+	}
+	
+	return entries;
+}
+/**
+ * Builds the tree of an empty map from entries in order of their keys, with
+ * no key twice.
+ *
+ * The entries are split evenly between as few leaves as can hold them, so
+ * each is at least half full. Then each level of branches is built over the
+ * one below in the same way, until one node is left to be the root.
+ *
+ * @param	entries	The entries, which are moved from
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_build(std::vector<std::pair<Key, Value>>& entries) {
+	const size_type size = entries.size();
+	if (size == 0) {
+		return;
+	}
+	
+	// Every node made so far, so they can be freed if making another fails
+	std::vector<Leaf*> leaves;
+	std::vector<Branch*> branches;
+	// The nodes of the level being built, and the least key under each
+	std::vector<Node*> level;
+	std::vector<Key> least;
+	
+	try {
+		const size_type leafCount = (size + BTREEMAP_ORDER - 1) / BTREEMAP_ORDER;
+		leaves.reserve(leafCount);
+		level.reserve(leafCount);
+		least.reserve(leafCount);
+		
+		size_type entry = 0;
+		for (size_type i = 0; i < leafCount; ++i) {
+			Leaf* leaf = new Leaf();
+			leaves.push_back(leaf);
+			const size_type count = size / leafCount + (i < size % leafCount ? 1 : 0);
+			for (size_type j = 0; j < count; ++j, ++entry) {
+				leaf->insert(j, std::move(entries[entry].first), std::move(entries[entry].second));
+			}
+			if (i > 0) {
+				leaves[i - 1]->next = leaf;
+			}
+			level.push_back(leaf);
+			least.push_back(leaf->keys()[0]);
+		}
+		
+		size_type height = 0;
+		while (level.size() > 1) {
+			const size_type count = level.size();
+			const size_type branchCount = (count + BTREEMAP_ORDER - 1) / BTREEMAP_ORDER;
+			std::vector<Node*> above;
+			std::vector<Key> aboveLeast;
+			above.reserve(branchCount);
+			aboveLeast.reserve(branchCount);
+			
+			size_type child = 0;
+			for (size_type i = 0; i < branchCount; ++i) {
+				branches.push_back(nullptr);
+				Branch* branch = new Branch();
+				branches.back() = branch;
+				branch->count = count / branchCount + (i < count % branchCount ? 1 : 0);
+				aboveLeast.push_back(std::move(least[child]));
+				for (size_type j = 0; j < branch->count; ++j, ++child) {
+					branch->children[j] = level[child];
+					if (j > 0) {
+						branch->keys[j - 1] = std::move(least[child]);
+					}
+				}
+				above.push_back(branch);
+			}
+			
+			level.swap(above);
+			least.swap(aboveLeast);
+			++height;
+		}
+		
+		mp_root = level[0];
+		mp_first = leaves[0];
+		m_height = height;
+		m_size = size;
+	}
+	catch (...) {
+		for (Leaf* leaf : leaves) {
+			delete leaf;
+		}
+		for (Branch* branch : branches) {
+			delete branch;
+		}
+		throw;
+	}
+}
+
+/**
+ * Frees a node and every node under it.
+ * @param	node	The node, or nullptr
+ * @param	level	The level of the node, where 0 is a leaf
+ */
+template <typename Key, typename Value, typename Compare>
+void BTreeMap<Key, Value, Compare>::m_destroy(Node* node, size_type level) {
+	if (node == nullptr) {
+		return;
+	}
+	
+	if (level == 0) {
+		delete static_cast<Leaf*>(node);
+		return;
+	}
+	
+	Branch* branch = static_cast<Branch*>(node);
+	for (size_type i = 0; i < branch->count; ++i) {
+		m_destroy(branch->children[i], level - 1);
+	}
+	delete branch;
+}
+
+/**
+ * Moves a position in a leaf that is past its last entry to the start of the
+ * next leaf, so that every position past the last key is the end.
+ *
+ * Only the root can be an empty leaf, so the next leaf always has an entry.
+ *
+ * @param	leaf	The leaf, or nullptr
+ * @param	index	The position in the leaf
+ * @return	The same position, or the start of the next leaf, or nullptr and
+ * 	0 for the end
+ */
+template <typename Key, typename Value, typename Compare>
+std::pair<typename BTreeMap<Key, Value, Compare>::Leaf*, typename BTreeMap<Key, Value, Compare>::size_type> BTreeMap<Key, Value, Compare>::m_normalize(Leaf* leaf, size_type index) {
+	if (leaf != nullptr && index == leaf->count) {
+		leaf = leaf->next;
+		index = 0;
+	}
+	
+	return std::pair<Leaf*, size_type>(leaf, index);
+}
+
+// -------------------------- //
+// BTreeMap_Iterator Methods //
+// -------------------------- //
+/**
+ * Creates an iterator at no position, equal to the end of any map.
+ */
+template <typename Key, typename Value>
+BTreeMap_Iterator<Key, Value>::BTreeMap_Iterator()
+	: r_leaf(nullptr), r_index(0)
+{}
+/**
+ * Creates an iterator at an entry of a leaf.
+ * @param	leaf	The leaf, or nullptr for the end
+ * @param	index	The position of the entry in the leaf
+ */
+template <typename Key, typename Value>
+BTreeMap_Iterator<Key, Value>::BTreeMap_Iterator(Leaf* leaf, size_t index)
+	: r_leaf(leaf), r_index(index)
+{}
+
+/**
+ * Checks if two iterators are at the same entry.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at the same entry
+ */
+template <typename Key, typename Value>
+bool BTreeMap_Iterator<Key, Value>::operator==(const BTreeMap_Iterator<Key, Value>& other) const {
+	return r_leaf == other.r_leaf && r_index == other.r_index;
+}
+/**
+ * Checks if two iterators are at different entries.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at different entries
+ */
+template <typename Key, typename Value>
+bool BTreeMap_Iterator<Key, Value>::operator!=(const BTreeMap_Iterator<Key, Value>& other) const {
+	return !(*this == other);
+}
+/**
+ * Checks if this iterator is at the same entry as a constant iterator.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at the same entry
+ */
+template <typename Key, typename Value>
+bool BTreeMap_Iterator<Key, Value>::operator==(const BTreeMap_ConstIterator<Key, Value>& other) const {
+	return r_leaf == other.r_leaf && r_index == other.r_index;
+}
+/**
+ * Checks if this iterator is at a different entry to a constant iterator.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at different entries
+ */
+template <typename Key, typename Value>
+bool BTreeMap_Iterator<Key, Value>::operator!=(const BTreeMap_ConstIterator<Key, Value>& other) const {
+	return !(*this == other);
+}
+
+/**
+ * Gives the key of the entry this iterator is at.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	A constant reference to the key
+ */
+template <typename Key, typename Value>
+const Key& BTreeMap_Iterator<Key, Value>::key() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_leaf != nullptr);
+	
+	return r_leaf->keys()[r_index];
+}
+/**
+ * Gives the value of the entry this iterator is at.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	A reference to the value, which can be changed
+ */
+template <typename Key, typename Value>
+Value& BTreeMap_Iterator<Key, Value>::value() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_leaf != nullptr);
+	
+	return r_leaf->values()[r_index];
+}
+
+/**
+ * Moves this iterator to the next key in order.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	This, after it has been moved
+ */
+template <typename Key, typename Value>
+BTreeMap_Iterator<Key, Value>& BTreeMap_Iterator<Key, Value>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_leaf != nullptr);
+	
+	if (++r_index == r_leaf->count) {
+		r_leaf = r_leaf->next;
+		r_index = 0;
+	}
+	
+	return *this;
+}
+/**
+ * Moves this iterator to the next key in order.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	A copy of this before it was moved
+ */
+template <typename Key, typename Value>
+BTreeMap_Iterator<Key, Value> BTreeMap_Iterator<Key, Value>::operator++(int) {
+	BTreeMap_Iterator<Key, Value> tmp(*this);
+	++*this;
+	return tmp;
+}
+
+// ------------------------------- //
+// BTreeMap_ConstIterator Methods //
+// ------------------------------- //
+/**
+ * Creates an iterator at no position, equal to the end of any map.
+ */
+template <typename Key, typename Value>
+BTreeMap_ConstIterator<Key, Value>::BTreeMap_ConstIterator()
+	: r_leaf(nullptr), r_index(0)
+{}
+/**
+ * Creates a constant iterator at the same entry as another iterator.
+ * @param	other	The iterator to copy
+ */
+template <typename Key, typename Value>
+BTreeMap_ConstIterator<Key, Value>::BTreeMap_ConstIterator(const BTreeMap_Iterator<Key, Value>& other)
+	: r_leaf(other.r_leaf), r_index(other.r_index)
+{}
+/**
+ * Creates an iterator at an entry of a leaf.
+ * @param	leaf	The leaf, or nullptr for the end
+ * @param	index	The position of the entry in the leaf
+ */
+template <typename Key, typename Value>
+BTreeMap_ConstIterator<Key, Value>::BTreeMap_ConstIterator(const Leaf* leaf, size_t index)
+	: r_leaf(leaf), r_index(index)
+{}
+
+/**
+ * Checks if two iterators are at the same entry.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at the same entry
+ */
+template <typename Key, typename Value>
+bool BTreeMap_ConstIterator<Key, Value>::operator==(const BTreeMap_ConstIterator<Key, Value>& other) const {
+	return r_leaf == other.r_leaf && r_index == other.r_index;
+}
+/**
+ * Checks if two iterators are at different entries.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at different entries
+ */
+template <typename Key, typename Value>
+bool BTreeMap_ConstIterator<Key, Value>::operator!=(const BTreeMap_ConstIterator<Key, Value>& other) const {
+	return !(*this == other);
+}
+/**
+ * Checks if this iterator is at the same entry as a read-write iterator.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at the same entry
+ */
+template <typename Key, typename Value>
+bool BTreeMap_ConstIterator<Key, Value>::operator==(const BTreeMap_Iterator<Key, Value>& other) const {
+	return r_leaf == other.r_leaf && r_index == other.r_index;
+}
+/**
+ * Checks if this iterator is at a different entry to a read-write iterator.
+ * @param	other	The iterator to compare with
+ * @return	Whether they are at different entries
+ */
+template <typename Key, typename Value>
+bool BTreeMap_ConstIterator<Key, Value>::operator!=(const BTreeMap_Iterator<Key, Value>& other) const {
+	return !(*this == other);
+}
+
+/**
+ * Gives the key of the entry this iterator is at.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	A constant reference to the key
+ */
+template <typename Key, typename Value>
+const Key& BTreeMap_ConstIterator<Key, Value>::key() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_leaf != nullptr);
+	
+	return r_leaf->keys()[r_index];
+}
+/**
+ * Gives the value of the entry this iterator is at.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	A constant reference to the value
+ */
+template <typename Key, typename Value>
+const Value& BTreeMap_ConstIterator<Key, Value>::value() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_leaf != nullptr);
+	
+	return r_leaf->values()[r_index];
+}
+
+/**
+ * Moves this iterator to the next key in order.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	This, after it has been moved
+ */
+template <typename Key, typename Value>
+BTreeMap_ConstIterator<Key, Value>& BTreeMap_ConstIterator<Key, Value>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_leaf != nullptr);
+	
+	if (++r_index == r_leaf->count) {
+		r_leaf = r_leaf->next;
+		r_index = 0;
+	}
+	
+	return *this;
+}
+/**
+ * Moves this iterator to the next key in order.
+ * @throws	OutOfBoundsError	when this is the end
+ * @return	A copy of this before it was moved
+ */
+template <typename Key, typename Value>
+BTreeMap_ConstIterator<Key, Value> BTreeMap_ConstIterator<Key, Value>::operator++(int) {
+	BTreeMap_ConstIterator<Key, Value> tmp(*this);
+	++*this;
+	return tmp;
+}
+
+#endif // Fundamentals_BTreeMap_hpp_
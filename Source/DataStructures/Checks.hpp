@@ -0,0 +1,52 @@
+/**
+ * Fundamentals :: Data Structures :: Checks
+ * Author: Quinn Mortimer
+ *
+ * This file contains the policy for how the data structures check that
+ * accesses are in bounds.
+ *
+ * By default every such check throws an OutOfBoundsError, as documented on
+ * each method. That safety isn't free, though. A branch that might throw on
+ * every `array[i]` keeps the compiler from vectorizing loops over the array,
+ * and it has to be paid again on every access.
+ *
+ * Defining FUNDAMENTALS_BOUNDS_CHECKS before including any of the data
+ * structures (or on the compiler's command line) picks another policy:
+ * - FUNDAMENTALS_CHECKS_THROW: Throw an OutOfBoundsError. This is the default.
+ * - FUNDAMENTALS_CHECKS_ASSERT: Use assert, so the checks are only made when
+ *   NDEBUG isn't defined, and a failed check aborts the program.
+ * - FUNDAMENTALS_CHECKS_NONE: Don't check at all. An access that is out of
+ *   bounds is then undefined behaviour, like it is for the std containers.
+ *
+ * The policy has to be the same everywhere in a program, or the containers
+ * would be defined differently in different places.
+ */
+
+#include <cassert>
+
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_Checks_hpp_
+#define Fundamentals_Checks_hpp_
+
+// The available policies.
+#define FUNDAMENTALS_CHECKS_NONE 0
+#define FUNDAMENTALS_CHECKS_ASSERT 1
+#define FUNDAMENTALS_CHECKS_THROW 2
+
+#ifndef FUNDAMENTALS_BOUNDS_CHECKS
+#define FUNDAMENTALS_BOUNDS_CHECKS FUNDAMENTALS_CHECKS_THROW
+#endif
+
+// Checks that a condition for an access being in bounds holds.
+#if FUNDAMENTALS_BOUNDS_CHECKS == FUNDAMENTALS_CHECKS_THROW
+#define FUNDAMENTALS_CHECK_BOUNDS(condition) do { if (!(condition)) { throw OutOfBoundsError(); } } while (false)
+#elif FUNDAMENTALS_BOUNDS_CHECKS == FUNDAMENTALS_CHECKS_ASSERT
+#define FUNDAMENTALS_CHECK_BOUNDS(condition) assert(condition)
+#elif FUNDAMENTALS_BOUNDS_CHECKS == FUNDAMENTALS_CHECKS_NONE
+#define FUNDAMENTALS_CHECK_BOUNDS(condition) ((void)0)
+#else
+#error "FUNDAMENTALS_BOUNDS_CHECKS must be FUNDAMENTALS_CHECKS_THROW, FUNDAMENTALS_CHECKS_ASSERT or FUNDAMENTALS_CHECKS_NONE"
+#endif
+
+#endif // Fundamentals_Checks_hpp_
@@ -0,0 +1,1074 @@
+/**
+ * Fundamentals :: Data Structures :: Circular Array
+ * Author: Quinn Mortimer
+ *
+ * This is an implementation of a circular array (or ring buffer), which works
+ * like a DynamicArray that can also grow and shrink at the front cheaply.
+ * It is intended as a reference for those looking to brush up on important
+ * data structures.
+ */
+/**
+ * A DynamicArray always keeps its first element at the start of its memory,
+ * so adding or removing at the front has to shift every other element.
+ * Here the first element can be anywhere in the memory instead, and the
+ * elements wrap around from the end of the memory back to the start. Adding
+ * at the front just means moving where the first element is back by one.
+ *
+ * The capacity is always a power of two, so wrapping an index around is done
+ * with a mask instead of a division.
+ *
+ * We will be using std::allocator for the memory, along with std::move and
+ * the uninitialized memory algorithms from the standard library.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Checks.hpp"
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_CircularArray_hpp_
+#define Fundamentals_CircularArray_hpp_
+
+// Capacities are always powers of two, so both of these must be as well
+#define CIRCULARARRAY_DEFAULT_CAPACITY 8
+#define CIRCULARARRAY_GROWTH_FACTOR 2
+
+// Forward declaration of the CircularArray class.
+template <typename T> class CircularArray;
+
+/**
+ * A random-access iterator over a CircularArray.
+ *
+ * Element is T for an iterator with read-write access, and const T for one
+ * with read-only access.
+ *
+ * The position is kept as an offset from the start of the memory that hasn't
+ * been wrapped yet, and is only wrapped with the mask when an element is
+ * accessed. That way iterators can be compared and subtracted directly.
+ */
+template <typename T, typename Element>
+class CircularArray_Iterator {
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::remove_const<Element>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Element* pointer;
+		typedef Element& reference;
+		
+		// Constructors
+		CircularArray_Iterator();
+		CircularArray_Iterator(const CircularArray_Iterator<T, Element>& other) = default;
+		// Converts an iterator into a const iterator
+		template <typename OtherElement, typename = typename std::enable_if<std::is_const<Element>::value && std::is_same<OtherElement, T>::value>::type>
+		CircularArray_Iterator(const CircularArray_Iterator<T, OtherElement>& other);
+		
+		// Assignment
+		CircularArray_Iterator<T, Element>& operator=(const CircularArray_Iterator<T, Element>& other) = default;
+		
+		// Data access
+		Element& operator*() const;
+		Element* operator->() const;
+		Element& operator[](difference_type n) const;
+		
+		// Increment and Decrement operators
+		CircularArray_Iterator<T, Element>& operator++();
+		CircularArray_Iterator<T, Element> operator++(int);
+		CircularArray_Iterator<T, Element>& operator--();
+		CircularArray_Iterator<T, Element> operator--(int);
+		
+		// Arithmetic operators
+		CircularArray_Iterator<T, Element>& operator+=(difference_type n);
+		CircularArray_Iterator<T, Element>& operator-=(difference_type n);
+		CircularArray_Iterator<T, Element> operator+(difference_type n) const;
+		CircularArray_Iterator<T, Element> operator-(difference_type n) const;
+		template <typename OtherElement>
+		difference_type operator-(const CircularArray_Iterator<T, OtherElement>& other) const;
+		
+		// Comparison operators
+		template <typename OtherElement>
+		bool operator==(const CircularArray_Iterator<T, OtherElement>& other) const;
+		template <typename OtherElement>
+		bool operator!=(const CircularArray_Iterator<T, OtherElement>& other) const;
+		template <typename OtherElement>
+		bool operator<(const CircularArray_Iterator<T, OtherElement>& other) const;
+		template <typename OtherElement>
+		bool operator>(const CircularArray_Iterator<T, OtherElement>& other) const;
+		template <typename OtherElement>
+		bool operator<=(const CircularArray_Iterator<T, OtherElement>& other) const;
+		template <typename OtherElement>
+		bool operator>=(const CircularArray_Iterator<T, OtherElement>& other) const;
+		
+	private:
+		// The memory of the array, the mask for wrapping positions, and the
+		// unwrapped position of the element this iterator points to.
+		Element* mp_data;
+		size_t m_mask;
+		size_t m_position;
+		
+		// Data-and-position constructor
+		// This is on its own in the private section because
+		// the user should not call it, but it is used by the CircularArray class.
+		CircularArray_Iterator(Element* data, size_t mask, size_t position);
+		
+	// CircularArray and the other kind of iterator need access to private
+	// members of this class.
+	friend class CircularArray<T>;
+	template <typename, typename> friend class CircularArray_Iterator;
+};
+
+/**
+ * A dynamically-sized array with cheap insertion and removal at both ends.
+ */
+template <typename T>
+class CircularArray {
+	public:
+		typedef size_t size_type;
+		typedef CircularArray_Iterator<T, T> iterator;
+		typedef CircularArray_Iterator<T, const T> const_iterator;
+		
+		// Constructors and Destructor
+		CircularArray();
+		CircularArray(size_type a_size);
+		CircularArray(size_type a_size, const T& a_value);
+		CircularArray(const CircularArray<T>& other);
+		CircularArray(CircularArray<T>&& other);
+		~CircularArray();
+		
+		// Access to current size and capacity
+		size_type size() const;
+		size_type capacity() const;
+		bool empty() const;
+		
+		// Bulk-memory affecting methods
+		void resize(size_type size);
+		void reserve(size_type size);
+		
+		// Element insertion and deletion
+		// - Back
+		void push_back(const T& value);
+		void push_back(T&& value);
+		template <typename... Args>
+		T& emplace_back(Args&&... args);
+		void pop_back();
+		// - Front
+		void push_front(const T& value);
+		void push_front(T&& value);
+		template <typename... Args>
+		T& emplace_front(Args&&... args);
+		void pop_front();
+		// - Arbitrary
+		void insert(const_iterator position, const T& value);
+		void insert(const_iterator position, T&& value);
+		void remove(const_iterator position);
+		
+		// Iterators
+		iterator begin();
+		const_iterator begin() const;
+		iterator end();
+		const_iterator end() const;
+		
+		// Data Access at notable indices
+		T& front();
+		const T& front() const;
+		T& back();
+		const T& back() const;
+		
+		// Operators
+		// - Assignment
+		CircularArray<T>& operator=(const CircularArray<T>& other);
+		CircularArray<T>& operator=(CircularArray<T>&& other);
+		// - Indexing
+		T& operator[](size_type index);
+		const T& operator[](size_type index) const;
+		// - Equality testing
+		bool operator==(const CircularArray<T>& other) const;
+		bool operator!=(const CircularArray<T>& other) const;
+		
+	private:
+		T* m_data;
+		size_type m_capacity;
+		// The index in m_data of the first element.
+		size_type m_head;
+		size_type m_size;
+		
+		// Swap function for a CircularArray.
+		void m_swap(CircularArray<T>& other);
+		
+		// Finds the memory for the element at an index.
+		T* m_slot(size_type index) const;
+		// Makes room for one more element, growing if needed.
+		void m_reserveOne();
+		// Adds an element at an index, shifting whichever side is shorter.
+		void m_insertAt(size_type index, T&& value);
+		
+		// Rounds a capacity up to a power of two.
+		static size_type m_roundCapacity(size_type capacity);
+		// Moves elements into raw memory, leaving the originals destroyed.
+		static void m_relocate(T* from, size_type count, T* to);
+		static void m_relocate(T* from, size_type count, T* to, std::true_type);
+		static void m_relocate(T* from, size_type count, T* to, std::false_type);
+};
+
+// ---------------------- //
+// Circular Array Methods //
+// ---------------------- //
+/**
+ * Constructs an empty array.
+ *
+ * This reserves a small implementation-defined amount of space, as with
+ * DynamicArray.
+ */
+template <typename T>
+CircularArray<T>::CircularArray() {
+	m_data = std::allocator<T>().allocate(CIRCULARARRAY_DEFAULT_CAPACITY);
+	m_capacity = CIRCULARARRAY_DEFAULT_CAPACITY;
+	m_head = 0;
+	m_size = 0;
+}
+/**
+ * Constructs an array with a specified starting size.
+ *
+ * Initial elements are made with the default constructor.
+ *
+ * @param	a_size	The initial size of the array
+ */
+template <typename T>
+CircularArray<T>::CircularArray(size_type size) {
+	m_capacity = m_roundCapacity(size);
+	m_data = std::allocator<T>().allocate(m_capacity);
+	m_head = 0;
+	
+	try {
+		std::uninitialized_value_construct_n(m_data, size);
+	}
+	catch (...) {
+		std::allocator<T>().deallocate(m_data, m_capacity);
+		throw;
+	}
+	
+	m_size = size;
+}
+/**
+ * Constructs an array filled with the specified value.
+ * @param	a_size	The initial size of the array
+ * @param	a_value	The value used to fill the elements
+ */
+template <typename T>
+CircularArray<T>::CircularArray(size_type size, const T& value) {
+	m_capacity = m_roundCapacity(size);
+	m_data = std::allocator<T>().allocate(m_capacity);
+	m_head = 0;
+	
+	try {
+		std::uninitialized_fill_n(m_data, size, value);
+	}
+	catch (...) {
+		std::allocator<T>().deallocate(m_data, m_capacity);
+		throw;
+	}
+	
+	m_size = size;
+}
+/**
+ * Constructs an array by copying another.
+ *
+ * The copy starts at the beginning of its memory, wherever the first element
+ * of the other array was.
+ *
+ * @param	other	The CircularArray to copy data from
+ */
+template <typename T>
+CircularArray<T>::CircularArray(const CircularArray<T>& other) {
+	m_capacity = other.m_capacity;
+	m_data = std::allocator<T>().allocate(m_capacity);
+	m_head = 0;
+	
+	try {
+		std::uninitialized_copy(other.begin(), other.end(), m_data);
+	}
+	catch (...) {
+		std::allocator<T>().deallocate(m_data, m_capacity);
+		throw;
+	}
+	
+	m_size = other.m_size;
+}
+/**
+ * Constructs an array by swapping contents with another array.
+ *
+ * The other array is left empty and without any memory after the swap.
+ *
+ * @param	other	The CircularArray to swap contents with
+ */
+template <typename T>
+CircularArray<T>::CircularArray(CircularArray<T>&& other)
+	: m_data(nullptr), m_capacity(0), m_head(0), m_size(0)
+{
+	m_swap(other);
+}
+/**
+ * Destructor for a CircularArray, destroys the elements and frees the
+ * underlying array from the heap.
+ */
+template <typename T>
+CircularArray<T>::~CircularArray() {
+	std::destroy(begin(), end());
+	if (m_data != nullptr) {
+		std::allocator<T>().deallocate(m_data, m_capacity);
+	}
+}
+
+/**
+ * Gets the size of the array for the user.
+ * @return	The number of elements in the array
+ */
+template <typename T>
+typename CircularArray<T>::size_type CircularArray<T>::size() const {
+	return m_size;
+}
+/**
+ * Gets the capacity of the array for the user.
+ * @return	The number of elements (used and unused) allocated in the array
+ */
+template <typename T>
+typename CircularArray<T>::size_type CircularArray<T>::capacity() const {
+	return m_capacity;
+}
+/**
+ * Reports on whether or not this CircularArray is empty.
+ * @return	Whether or not this array has any in-use elements
+ */
+template <typename T>
+bool CircularArray<T>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Set the size of the CircularArray to the specified value.
+ *
+ * Elements are added or removed at the back. If elements need to be added,
+ * uses the default constructor for T.
+ *
+ * @param	size	The desired size for the array
+ */
+template <typename T>
+void CircularArray<T>::resize(size_type size) {
+	reserve(size);
+	
+	while (m_size < size) {
+		emplace_back();
+	}
+	while (m_size > size) {
+		pop_back();
+	}
+}
+/**
+ * Reserves a specific amount of memory for use.
+ *
+ * This will only ensure that enough memory has been allocated, rounded up to
+ * a power of two. This method will not shrink the capacity of the array.
+ *
+ * The elements are moved into the start of the new memory, as two blocks if
+ * they wrapped around the end of the old memory.
+ *
+ * @param	capacity	Desired capacity for this array
+ */
+template <typename T>
+void CircularArray<T>::reserve(size_type capacity) {
+	if (m_capacity >= capacity) {
+		return;
+	}
+	
+	capacity = m_roundCapacity(capacity);
+	T* next_data = std::allocator<T>().allocate(capacity);
+	
+	size_type first_block = m_capacity - m_head < m_size ? m_capacity - m_head : m_size;
+	
+	// Nothing has been moved until both blocks have, so the array is still
+	// intact if a copy throws
+	try {
+		m_relocate(m_data + m_head, first_block, next_data);
+		try {
+			m_relocate(m_data, m_size - first_block, next_data + first_block);
+		}
+		catch (...) {
+			std::destroy_n(next_data, first_block);
+			throw;
+		}
+	}
+	catch (...) {
+		std::allocator<T>().deallocate(next_data, capacity);
+		throw;
+	}
+	
+	if (m_data != nullptr) {
+		std::allocator<T>().deallocate(m_data, m_capacity);
+	}
+	m_data = next_data;
+	m_capacity = capacity;
+	m_head = 0;
+}
+
+/**
+ * Adds the provided element to the back of the array.
+ * @param	value	The value to place at the back of the array
+ */
+template <typename T>
+void CircularArray<T>::push_back(const T& value) {
+	emplace_back(value);
+}
+/**
+ * Moves the provided element onto the back of the array.
+ * @param	value	The value to place at the back of the array
+ */
+template <typename T>
+void CircularArray<T>::push_back(T&& value) {
+	emplace_back(std::move(value));
+}
+/**
+ * Constructs a new element in place at the back of the array.
+ * @param	args	The arguments for the constructor of T
+ * @return	A reference to the new element
+ */
+template <typename T>
+template <typename... Args>
+T& CircularArray<T>::emplace_back(Args&&... args) {
+	if (m_size == m_capacity) {
+		// The arguments could refer to an element of this array,
+		// so they're used up before the elements are moved
+		T value(std::forward<Args>(args)...);
+		m_reserveOne();
+		return *new (m_slot(m_size++)) T(std::move(value));
+	}
+	
+	T* slot = new (m_slot(m_size)) T(std::forward<Args>(args)...);
+	++m_size;
+	return *slot;
+}
+/**
+ * Removes one element from the back of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ */
+template <typename T>
+void CircularArray<T>::pop_back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	--m_size;
+	m_slot(m_size)->~T();
+}
+/**
+ * Adds the provided element to the front of the array.
+ *
+ * Unlike DynamicArray, this takes constant time, apart from when the array
+ * needs to grow.
+ *
+ * @param	value	The value to place at the front of the array
+ */
+template <typename T>
+void CircularArray<T>::push_front(const T& value) {
+	emplace_front(value);
+}
+/**
+ * Moves the provided element onto the front of the array.
+ * @param	value	The value to place at the front of the array
+ */
+template <typename T>
+void CircularArray<T>::push_front(T&& value) {
+	emplace_front(std::move(value));
+}
+/**
+ * Constructs a new element in place at the front of the array.
+ * @param	args	The arguments for the constructor of T
+ * @return	A reference to the new element
+ */
+template <typename T>
+template <typename... Args>
+T& CircularArray<T>::emplace_front(Args&&... args) {
+	if (m_size == m_capacity) {
+		T value(std::forward<Args>(args)...);
+		m_reserveOne();
+		return emplace_front(std::move(value));
+	}
+	
+	// Moving the head back by one wraps around to the end of the memory
+	size_type head = (m_head - 1) & (m_capacity - 1);
+	T* slot = new (m_data + head) T(std::forward<Args>(args)...);
+	
+	m_head = head;
+	++m_size;
+	return *slot;
+}
+/**
+ * Removes an element from the front of the array.
+ *
+ * Unlike DynamicArray, this takes constant time.
+ *
+ * @throws	OutOfBoundsError	when the array is empty
+ */
+template <typename T>
+void CircularArray<T>::pop_front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	m_data[m_head].~T();
+	m_head = (m_head + 1) & (m_capacity - 1);
+	--m_size;
+}
+/**
+ * Inserts an element before an arbitrary iterator in the array.
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	The location to insert the element before
+ * @param	value	The value to insert into the array
+ */
+template <typename T>
+void CircularArray<T>::insert(const_iterator position, const T& value) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= begin() && position <= end());
+	
+	m_insertAt(position - begin(), T(value));
+}
+/**
+ * Moves an element into the array before an arbitrary iterator.
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	The location to insert the element before
+ * @param	value	The value to move into the array
+ */
+template <typename T>
+void CircularArray<T>::insert(const_iterator position, T&& value) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= begin() && position <= end());
+	
+	m_insertAt(position - begin(), std::move(value));
+}
+/**
+ * Removes an element from an arbitrary point in the array.
+ *
+ * Whichever side of the element has fewer elements is shifted to fill the
+ * gap, so at most half of the array is moved.
+ *
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	An iterator pointing to the element to remove
+ */
+template <typename T>
+void CircularArray<T>::remove(const_iterator position) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= begin() && position < end());
+	
+	size_type index = position - begin();
+	
+	if (index < m_size / 2) {
+		std::move_backward(begin(), begin() + index, begin() + index + 1);
+		pop_front();
+	}
+	else {
+		std::move(begin() + index + 1, end(), begin() + index);
+		pop_back();
+	}
+}
+
+/**
+ * Provides an iterator pointing to the first element of the array.
+ * @return	An iterator at the start of this CircularArray
+ */
+template <typename T>
+typename CircularArray<T>::iterator CircularArray<T>::begin() {
+	return iterator(m_data, m_capacity - 1, m_head);
+}
+/**
+ * Provides a const_iterator pointing to the first element of the array.
+ * @return	A const_iterator at the start of this CircularArray
+ */
+template <typename T>
+typename CircularArray<T>::const_iterator CircularArray<T>::begin() const {
+	return const_iterator(m_data, m_capacity - 1, m_head);
+}
+/**
+ * Provides an iterator pointing just past the last element of the array.
+ * @return	An iterator at the end of this CircularArray
+ */
+template <typename T>
+typename CircularArray<T>::iterator CircularArray<T>::end() {
+	return iterator(m_data, m_capacity - 1, m_head + m_size);
+}
+/**
+ * Provides a const_iterator pointing just past the last element of the array.
+ * @return	A const_iterator at the end of this CircularArray
+ */
+template <typename T>
+typename CircularArray<T>::const_iterator CircularArray<T>::end() const {
+	return const_iterator(m_data, m_capacity - 1, m_head + m_size);
+}
+
+/**
+ * Provides a reference to the first element in the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A reference to the first element of the array
+ */
+template <typename T>
+T& CircularArray<T>::front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return *m_slot(0);
+}
+/**
+ * Provides a constant reference to the first element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A constant reference to the first element of the array
+ */
+template <typename T>
+const T& CircularArray<T>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return *m_slot(0);
+}
+/**
+ * Provides a reference to the last element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A reference to the last element of the array
+ */
+template <typename T>
+T& CircularArray<T>::back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return *m_slot(m_size - 1);
+}
+/**
+ * Provides a constant reference to the last element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A constant reference to the last element of the array
+ */
+template <typename T>
+const T& CircularArray<T>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return *m_slot(m_size - 1);
+}
+
+/**
+ * Copy-assigns the contents of another array to this array.
+ *
+ * As with DynamicArray, this uses the copy-and-swap idiom.
+ *
+ * @param	other	The array to copy data from
+ * @return	A reference to this after copying
+ */
+template <typename T>
+CircularArray<T>& CircularArray<T>::operator=(const CircularArray<T>& other) {
+	CircularArray<T> tmp(other);
+	m_swap(tmp);
+	return *this;
+}
+/**
+ * Move-assigns the contents of another array to this array.
+ * @param	other	The array to swap data with
+ * @return	A reference to this after the swap has happened
+ */
+template <typename T>
+CircularArray<T>& CircularArray<T>::operator=(CircularArray<T>&& other) {
+	m_swap(other);
+	return *this;
+}
+/**
+ * Provides a reference to an element at any index of the array.
+ *
+ * Index 0 is always the front of the array, wherever it is in memory.
+ *
+ * @throws	OutOfBoundsError	when the requested index is >= m_size
+ * @param	index	The index in the array to retrieve data from
+ * @return A reference to the data at the requested index
+ */
+template <typename T>
+T& CircularArray<T>::operator[](size_type index) {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
+	
+	return *m_slot(index);
+}
+/**
+ * Provides a constant reference to an element at any index of the array.
+ * @throws	OutOfBoundsError	when the requested index is >= m_size
+ * @param	index	The index in the array to retrieve data from
+ * @return A constant reference to the data at the requested index
+ */
+template <typename T>
+const T& CircularArray<T>::operator[](size_type index) const {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
+	
+	return *m_slot(index);
+}
+/**
+ * Check if two arrays are equal.
+ *
+ * In this context, that will mean they are the same size and the contents
+ * compare equal index-by-index, regardless of where they are in memory.
+ *
+ * @param	other	The array to compare this against
+ * @return	Boolean representing whether these arrays are equal
+ */
+template <typename T>
+bool CircularArray<T>::operator==(const CircularArray<T>& other) const {
+	if (m_size != other.m_size) {
+		return false;
+	}
+	
+	for (size_type i = 0; i < m_size; ++i) {
+		if (*m_slot(i) != *other.m_slot(i)) {
+			return false;
+		}
+	}
+	
+	return true;
+}
+/**
+ * Check if two arrays are not equal.
+ * @param	other	The array to compare this against
+ * @return	Boolean representing whether these arrays are not equal
+ */
+template <typename T>
+bool CircularArray<T>::operator!=(const CircularArray<T>& other) const {
+	return !(*this == other);
+}
+
+/**
+ * Swaps the member variables of this with those of another CircularArray.
+ * @param	other	The array to swap contents with
+ */
+template <typename T>
+void CircularArray<T>::m_swap(CircularArray<T>& other) {
+	std::swap(m_data, other.m_data);
+	std::swap(m_capacity, other.m_capacity);
+	std::swap(m_head, other.m_head);
+	std::swap(m_size, other.m_size);
+}
+
+/**
+ * Finds the memory for the element at an index, wrapping around if needed.
+ * @param	index	The index of the element, from the front of the array
+ * @return	A pointer to where that element is (or would be) in memory
+ */
+template <typename T>
+T* CircularArray<T>::m_slot(size_type index) const {
+	return m_data + ((m_head + index) & (m_capacity - 1));
+}
+/**
+ * Makes sure there is room for at least one more element.
+ */
+template <typename T>
+void CircularArray<T>::m_reserveOne() {
+	if (m_size == m_capacity) {
+		size_type next_capacity = m_capacity * CIRCULARARRAY_GROWTH_FACTOR;
+		reserve(next_capacity == 0 ? 1 : next_capacity);
+	}
+}
+/**
+ * Adds an element at an index, shifting the elements on one side of it.
+ *
+ * If the index is in the front half, the elements before it move forward
+ * into a new slot at the front. Otherwise, the elements after it move back
+ * into a new slot at the back.
+ *
+ * @param	index	Where the new element should end up, at most m_size
+ * @param	value	The value to move into the array
+ */
+template <typename T>
+void CircularArray<T>::m_insertAt(size_type index, T&& value) {
+	if (index == 0) {
+		emplace_front(std::move(value));
+	}
+	else if (index == m_size) {
+		emplace_back(std::move(value));
+	}
+	else if (index < m_size / 2) {
+		// Everything shifts forward one index into the new front slot
+		emplace_front(std::move(front()));
+		std::move(begin() + 2, begin() + index + 1, begin() + 1);
+		*(begin() + index) = std::move(value);
+	}
+	else {
+		emplace_back(std::move(back()));
+		std::move_backward(begin() + index, end() - 2, end() - 1);
+		*(begin() + index) = std::move(value);
+	}
+}
+
+/**
+ * Rounds a capacity up to a power of two, so indices can be wrapped by mask.
+ * @param	capacity	The smallest acceptable capacity
+ * @return	The smallest power of two that is at least capacity
+ */
+template <typename T>
+typename CircularArray<T>::size_type CircularArray<T>::m_roundCapacity(size_type capacity) {
+	size_type rounded = 1;
+	while (rounded < capacity) {
+		rounded <<= 1;
+	}
+	return rounded;
+}
+/**
+ * Moves elements into raw memory, destroying the originals.
+ *
+ * This works the same way as the one in DynamicArray.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T>
+void CircularArray<T>::m_relocate(T* from, size_type count, T* to) {
+	m_relocate(from, count, to, std::is_trivially_copyable<T>());
+}
+/**
+ * Moves trivially copyable elements into raw memory with memcpy.
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T>
+void CircularArray<T>::m_relocate(T* from, size_type count, T* to, std::true_type) {
+	if (count > 0) {
+		std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+	}
+}
+/**
+ * Moves elements into raw memory one at a time, copying them instead if
+ * moving might throw.
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T>
+void CircularArray<T>::m_relocate(T* from, size_type count, T* to, std::false_type) {
+	size_type moved = 0;
+	
+	try {
+		for (; moved < count; ++moved) {
+			new (to + moved) T(std::move_if_noexcept(from[moved]));
+		}
+	}
+	catch (...) {
+		std::destroy_n(to, moved);
+		throw;
+	}
+	
+	std::destroy_n(from, count);
+}
+
+// ------------------------------ //
+// CircularArray_Iterator methods //
+// ------------------------------ //
+/**
+ * Constructs an iterator that doesn't point into any array.
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element>::CircularArray_Iterator()
+	: mp_data(nullptr), m_mask(0), m_position(0)
+{}
+/**
+ * Converts an iterator into a const iterator.
+ * @param	other	The iterator to convert
+ */
+template <typename T, typename Element>
+template <typename OtherElement, typename>
+CircularArray_Iterator<T, Element>::CircularArray_Iterator(const CircularArray_Iterator<T, OtherElement>& other)
+	: mp_data(other.mp_data), m_mask(other.m_mask), m_position(other.m_position)
+{}
+/**
+ * Constructs an iterator at a position in an array's memory.
+ * @param	data	The memory of the array
+ * @param	mask	One less than the capacity of the array
+ * @param	position	The unwrapped position of the element
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element>::CircularArray_Iterator(Element* data, size_t mask, size_t position)
+	: mp_data(data), m_mask(mask), m_position(position)
+{}
+
+/**
+ * Provides access to the element this iterator points to.
+ * @return	A reference to the element
+ */
+template <typename T, typename Element>
+Element& CircularArray_Iterator<T, Element>::operator*() const {
+	return mp_data[m_position & m_mask];
+}
+/**
+ * Provides member access to the element this iterator points to.
+ * @return	A pointer to the element
+ */
+template <typename T, typename Element>
+Element* CircularArray_Iterator<T, Element>::operator->() const {
+	return mp_data + (m_position & m_mask);
+}
+/**
+ * Provides access to an element relative to this iterator.
+ * @param	n	How many elements past this one to look
+ * @return	A reference to that element
+ */
+template <typename T, typename Element>
+Element& CircularArray_Iterator<T, Element>::operator[](difference_type n) const {
+	return mp_data[(m_position + n) & m_mask];
+}
+
+/**
+ * Moves this iterator to the next element.
+ * @return	This iterator, after moving it
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element>& CircularArray_Iterator<T, Element>::operator++() {
+	++m_position;
+	return *this;
+}
+/**
+ * Moves this iterator to the next element.
+ * @return	A copy of this iterator from before it moved
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element> CircularArray_Iterator<T, Element>::operator++(int) {
+	CircularArray_Iterator<T, Element> previous(*this);
+	++m_position;
+	return previous;
+}
+/**
+ * Moves this iterator to the previous element.
+ * @return	This iterator, after moving it
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element>& CircularArray_Iterator<T, Element>::operator--() {
+	--m_position;
+	return *this;
+}
+/**
+ * Moves this iterator to the previous element.
+ * @return	A copy of this iterator from before it moved
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element> CircularArray_Iterator<T, Element>::operator--(int) {
+	CircularArray_Iterator<T, Element> previous(*this);
+	--m_position;
+	return previous;
+}
+
+/**
+ * Moves this iterator forward by a number of elements.
+ * @param	n	The number of elements to move by, which can be negative
+ * @return	This iterator, after moving it
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element>& CircularArray_Iterator<T, Element>::operator+=(difference_type n) {
+	m_position += n;
+	return *this;
+}
+/**
+ * Moves this iterator back by a number of elements.
+ * @param	n	The number of elements to move by, which can be negative
+ * @return	This iterator, after moving it
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element>& CircularArray_Iterator<T, Element>::operator-=(difference_type n) {
+	m_position -= n;
+	return *this;
+}
+/**
+ * Makes an iterator a number of elements past this one.
+ * @param	n	The number of elements to move by, which can be negative
+ * @return	The moved iterator
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element> CircularArray_Iterator<T, Element>::operator+(difference_type n) const {
+	return CircularArray_Iterator<T, Element>(mp_data, m_mask, m_position + n);
+}
+/**
+ * Makes an iterator a number of elements before this one.
+ * @param	n	The number of elements to move by, which can be negative
+ * @return	The moved iterator
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element> CircularArray_Iterator<T, Element>::operator-(difference_type n) const {
+	return CircularArray_Iterator<T, Element>(mp_data, m_mask, m_position - n);
+}
+/**
+ * Finds the distance between two iterators over the same array.
+ * @param	other	The iterator to measure from
+ * @return	The number of elements from other to this iterator
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+typename CircularArray_Iterator<T, Element>::difference_type CircularArray_Iterator<T, Element>::operator-(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return static_cast<difference_type>(m_position - other.m_position);
+}
+
+/**
+ * Checks whether two iterators point to the same element.
+ * @param	other	The iterator to compare against
+ * @return	Whether the iterators are at the same position
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+bool CircularArray_Iterator<T, Element>::operator==(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return m_position == other.m_position;
+}
+/**
+ * Checks whether two iterators point to different elements.
+ * @param	other	The iterator to compare against
+ * @return	Whether the iterators are at different positions
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+bool CircularArray_Iterator<T, Element>::operator!=(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return m_position != other.m_position;
+}
+/**
+ * Checks whether this iterator comes before another.
+ * @param	other	The iterator to compare against
+ * @return	Whether this iterator is closer to the front of the array
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+bool CircularArray_Iterator<T, Element>::operator<(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return *this - other < 0;
+}
+/**
+ * Checks whether this iterator comes after another.
+ * @param	other	The iterator to compare against
+ * @return	Whether this iterator is closer to the back of the array
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+bool CircularArray_Iterator<T, Element>::operator>(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return *this - other > 0;
+}
+/**
+ * Checks whether this iterator doesn't come after another.
+ * @param	other	The iterator to compare against
+ * @return	Whether this iterator is at or before other
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+bool CircularArray_Iterator<T, Element>::operator<=(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return *this - other <= 0;
+}
+/**
+ * Checks whether this iterator doesn't come before another.
+ * @param	other	The iterator to compare against
+ * @return	Whether this iterator is at or after other
+ */
+template <typename T, typename Element>
+template <typename OtherElement>
+bool CircularArray_Iterator<T, Element>::operator>=(const CircularArray_Iterator<T, OtherElement>& other) const {
+	return *this - other >= 0;
+}
+
+/**
+ * Makes an iterator a number of elements past another, as in `n + itr`.
+ * @param	n	The number of elements to move by, which can be negative
+ * @param	itr	The iterator to move from
+ * @return	The moved iterator
+ */
+template <typename T, typename Element>
+CircularArray_Iterator<T, Element> operator+(typename CircularArray_Iterator<T, Element>::difference_type n, const CircularArray_Iterator<T, Element>& itr) {
+	return itr + n;
+}
+
+#endif // Fundamentals_CircularArray_hpp_
@@ -0,0 +1,325 @@
+/**
+ * Fundamentals :: Data Structures :: Concurrent Hash Map
+ * Author: Quinn Mortimer
+ *
+ * This is a hash map that can be used from several threads at once.
+ * It is built out of the ordinary HashMap, by splitting the keys between a
+ * number of smaller maps (called shards) that each have their own lock.
+ */
+/**
+ * Putting a single mutex around a HashMap works, but every thread has to wait
+ * for every other thread, so adding threads stops helping very quickly.
+ * With shards, two threads only wait for each other when their keys happen
+ * to be in the same shard. The locks are also reader-writer locks, so two
+ * lookups never wait for each other even when they are in the same shard.
+ *
+ * We will be using std::shared_mutex and its lock guards from the standard
+ * library, along with std::allocator for the memory of the shards.
+ */
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+
+#include "HashMap.hpp"
+#include "Hashing.hpp"
+#include "HashProbes.hpp"
+
+#ifndef Fundamentals_ConcurrentHashMap_hpp_
+#define Fundamentals_ConcurrentHashMap_hpp_
+
+// Shard counts are always powers of two, so this must be as well
+#define CONCURRENTHASHMAP_DEFAULT_SHARDS 64
+// Shards are spaced apart by this many bytes, so that locking one shard
+// doesn't bounce the cache line holding its neighbour's lock between cores
+#define CONCURRENTHASHMAP_SHARD_ALIGNMENT 64
+
+/**
+ * One shard of a ConcurrentHashMap, which is a HashMap and its lock.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+struct alignas(CONCURRENTHASHMAP_SHARD_ALIGNMENT) ConcurrentHashMap_Shard {
+	mutable std::shared_mutex mutex;
+	HashMap<Key, Value, Probe, Hash> map;
+	
+	ConcurrentHashMap_Shard(const Hash& hash);
+};
+
+/**
+ * A hash map with independently locked shards.
+ *
+ * Every key belongs to exactly one shard, picked using the high bits of its
+ * hash. Each shard's HashMap picks slots using the low bits of the same
+ * hash, so the keys in a shard still spread out over its whole table.
+ *
+ * Values are copied out by find rather than returned by reference, since a
+ * reference could be invalidated by another thread as soon as the shard's
+ * lock is released.
+ *
+ * The Probe and Hash parameters are passed on to the HashMap of each shard.
+ */
+template <typename Key, typename Value, typename Probe = PerturbProbe, typename Hash = DefaultHashFor<Key>>
+class ConcurrentHashMap : private HashHolder<Hash> {
+	public:
+		typedef size_t size_type;
+		typedef Hash hash_type;
+		
+		// Constructors
+		ConcurrentHashMap();
+		ConcurrentHashMap(const hash_type& hash);
+		ConcurrentHashMap(const hash_type& hash, size_type shards);
+		
+		// The locks can't be copied or moved, so neither can the map
+		ConcurrentHashMap(const ConcurrentHashMap<Key, Value, Probe, Hash>& other) = delete;
+		ConcurrentHashMap<Key, Value, Probe, Hash>& operator=(const ConcurrentHashMap<Key, Value, Probe, Hash>& other) = delete;
+		
+		// Destructor
+		~ConcurrentHashMap();
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		size_type shardCount() const;
+		
+		// Element insertion and deletion
+		bool insert_or_assign(const Key& key, const Value& value);
+		bool erase(const Key& key);
+		
+		// Data Access
+		bool contains(const Key& key) const;
+		bool find(const Key& key, Value& out) const;
+		
+	private:
+		typedef ConcurrentHashMap_Shard<Key, Value, Probe, Hash> Shard;
+		
+		// The number of shards, which is a power of two.
+		size_type m_shardCount;
+		// How far to shift a hash to the right to get its shard index.
+		int m_shardShift;
+		// The shards themselves.
+		Shard* mp_shards;
+		
+		// Finds the shard that a key belongs to.
+		Shard& m_shardFor(const Key& key) const;
+};
+
+// -------------------------------- //
+// ConcurrentHashMap_Shard Methods //
+// -------------------------------- //
+/**
+ * Constructs an empty shard.
+ * @param	hash	The hash function for the shard's map to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ConcurrentHashMap_Shard<Key, Value, Probe, Hash>::ConcurrentHashMap_Shard(const Hash& hash)
+	: mutex(), map(hash)
+{}
+
+// -------------------------- //
+// ConcurrentHashMap Methods //
+// -------------------------- //
+/**
+ * Constructs a ConcurrentHashMap with a default-constructed hash function.
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ConcurrentHashMap<Key, Value, Probe, Hash>::ConcurrentHashMap()
+	: ConcurrentHashMap(hash_type())
+{}
+/**
+ * Constructs a ConcurrentHashMap with the default number of shards.
+ * @param	hash	The hash function for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ConcurrentHashMap<Key, Value, Probe, Hash>::ConcurrentHashMap(const hash_type& hash)
+	: ConcurrentHashMap(hash, CONCURRENTHASHMAP_DEFAULT_SHARDS)
+{}
+/**
+ * Constructs a ConcurrentHashMap with a minimum number of shards.
+ *
+ * The number of shards is rounded up to a power of two. More shards means
+ * less waiting between threads, at the cost of a little memory per shard.
+ * A few times the number of threads that will use the map is plenty.
+ *
+ * @param	hash	The hash function for this to use
+ * @param	shards	The smallest number of shards to split the keys between
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ConcurrentHashMap<Key, Value, Probe, Hash>::ConcurrentHashMap(const hash_type& hash, size_type shards)
+	: HashHolder<Hash>(hash)
+{
+	requireHashFunction(hash);
+	
+	m_shardCount = hashTableSize(shards);
+	
+	m_shardShift = std::numeric_limits<size_type>::digits;
+	for (size_type count = m_shardCount; count > 1; count >>= 1) {
+		--m_shardShift;
+	}
+	
+	// The locks can't be copied, so the shards are built in place
+	std::allocator<Shard> allocator;
+	mp_shards = allocator.allocate(m_shardCount);
+	size_type built = 0;
+	
+	try {
+		for (; built < m_shardCount; ++built) {
+			new (mp_shards + built) Shard(hash);
+		}
+	}
+	catch (...) {
+		while (built > 0) {
+			mp_shards[--built].~Shard();
+		}
+		allocator.deallocate(mp_shards, m_shardCount);
+		throw;
+	}
+}
+/**
+ * Destroys every shard, along with its contents.
+ *
+ * No other thread can be using the map while it is destroyed.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ConcurrentHashMap<Key, Value, Probe, Hash>::~ConcurrentHashMap() {
+	for (size_type i = 0; i < m_shardCount; ++i) {
+		mp_shards[i].~Shard();
+	}
+	std::allocator<Shard>().deallocate(mp_shards, m_shardCount);
+}
+
+/**
+ * Reports the number of key-value pairs in the map.
+ *
+ * Each shard is locked in turn while it is counted, so if other threads are
+ * changing the map this is only a snapshot. It might not match the size the
+ * map had at any single moment.
+ *
+ * @return	The number of key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename ConcurrentHashMap<Key, Value, Probe, Hash>::size_type ConcurrentHashMap<Key, Value, Probe, Hash>::size() const {
+	size_type total = 0;
+	for (size_type i = 0; i < m_shardCount; ++i) {
+		std::shared_lock<std::shared_mutex> lock(mp_shards[i].mutex);
+		total += mp_shards[i].map.size();
+	}
+	return total;
+}
+/**
+ * Reports whether or not the map is empty.
+ *
+ * Like size, this is only a snapshot when other threads are changing the map.
+ *
+ * @return	Whether there are any key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ConcurrentHashMap<Key, Value, Probe, Hash>::empty() const {
+	for (size_type i = 0; i < m_shardCount; ++i) {
+		std::shared_lock<std::shared_mutex> lock(mp_shards[i].mutex);
+		if (!mp_shards[i].map.empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+/**
+ * Reports the number of shards the keys are split between.
+ * @return	The number of shards, which is a power of two
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename ConcurrentHashMap<Key, Value, Probe, Hash>::size_type ConcurrentHashMap<Key, Value, Probe, Hash>::shardCount() const {
+	return m_shardCount;
+}
+
+/**
+ * Sets the value corresponding to a key in this map.
+ *
+ * If the key was already in the map, the old value is overwritten.
+ *
+ * @param	key	The key to insert a value for
+ * @param	value	The value that corresponds to the key
+ * @return	true if the key was newly added, false if it was already there
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ConcurrentHashMap<Key, Value, Probe, Hash>::insert_or_assign(const Key& key, const Value& value) {
+	Shard& shard = m_shardFor(key);
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+	
+	// Comparing sizes tells us whether the key was new without a second probe
+	size_type before = shard.map.size();
+	shard.map.set(key, value);
+	return shard.map.size() != before;
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ * @param	key	The key to remove
+ * @return	true if the key was removed, false if it wasn't in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ConcurrentHashMap<Key, Value, Probe, Hash>::erase(const Key& key) {
+	Shard& shard = m_shardFor(key);
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+	
+	size_type before = shard.map.size();
+	shard.map.unset(key);
+	return shard.map.size() != before;
+}
+
+/**
+ * Checks if a key is currently in the map.
+ * @param	key	The key to check for
+ * @return	A boolean representing whether or not the key exists
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ConcurrentHashMap<Key, Value, Probe, Hash>::contains(const Key& key) const {
+	Shard& shard = m_shardFor(key);
+	std::shared_lock<std::shared_mutex> lock(shard.mutex);
+	
+	return shard.map.hasKey(key);
+}
+/**
+ * Copies out the value stored at a key, if there is one.
+ * @param	key	The key to get the mapped value for
+ * @param	out	Where the value is copied to when the key is found
+ * @return	true if the key was found, in which case out has been assigned
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ConcurrentHashMap<Key, Value, Probe, Hash>::find(const Key& key, Value& out) const {
+	Shard& shard = m_shardFor(key);
+	std::shared_lock<std::shared_mutex> lock(shard.mutex);
+	
+	const HashMap<Key, Value, Probe, Hash>& map = shard.map;
+	const Value* found = map.find(key);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	out = *found;
+	return true;
+}
+
+/**
+ * Finds the shard that a key belongs to.
+ *
+ * This uses the top bits of the hash, since the shard's own HashMap uses
+ * the bottom ones. A shift by the full width of a size_t isn't allowed, so
+ * the case of a single shard is handled separately.
+ *
+ * @param	key	The key to find the shard for
+ * @return	The shard that key belongs to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename ConcurrentHashMap<Key, Value, Probe, Hash>::Shard& ConcurrentHashMap<Key, Value, Probe, Hash>::m_shardFor(const Key& key) const {
+	if (m_shardCount == 1) {
+		return mp_shards[0];
+	}
+	
+	size_type hashValue = hashKey(this->hashFunction(), key);
+	return mp_shards[hashValue >> m_shardShift];
+}
+
+#endif // Fundamentals_ConcurrentHashMap_hpp_
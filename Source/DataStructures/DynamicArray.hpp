@@ -6,10 +6,36 @@
  * It is intended as a reference for those looking to brush up on�important
  * data structures.
  */
+/**
+ * The elements are kept in raw memory from the Allocator, and each one is only
+ * constructed when it becomes part of the array. That way reserving space
+ * doesn't construct elements nobody asked for, and growing the array moves
+ * the existing elements across rather than copying them.
+ *
+ * The Allocator defaults to std::allocator, and can be any allocator that
+ * works with std::allocator_traits (see Allocation.hpp).
+ *
+ * We will be using std::move, std::forward and std::allocator_traits from the
+ * standard library.
+ */
+/**
+ * An array of a trivially copyable type can be saved to a file with save, and
+ * the file mapped back into memory as a MappedArray without reading it in
+ * (see MappedFile.hpp).
+ */
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
 
+#include "Allocation.hpp"
+#include "Checks.hpp"
 #include "Exceptions.hpp"
+#include "MappedFile.hpp"
 
 #ifndef Fundamentals_DynamicArray_hpp_
 #define Fundamentals_DynamicArray_hpp_
@@ -20,21 +46,27 @@
 /**
  * A dynamically-sized array.
  */
-template <typename T>
-class DynamicArray {
+template <typename T, typename Allocator = std::allocator<T>>
+class DynamicArray : private AllocatorHolder<Allocator> {
 	public:
 		typedef size_t size_type;
+		typedef Allocator allocator_type;
 		typedef T* iterator;
 		typedef const T* const_iterator;
 		
 		// Constructors and Destructor
 		DynamicArray();
-		DynamicArray(size_type a_size);
-		DynamicArray(size_type a_size, const T& a_value);
-		DynamicArray(const DynamicArray<T>& other);
-		DynamicArray(DynamicArray<T>&& other);
+		explicit DynamicArray(const allocator_type& allocator);
+		DynamicArray(size_type a_size, const allocator_type& allocator = allocator_type());
+		DynamicArray(size_type a_size, const T& a_value, const allocator_type& allocator = allocator_type());
+		DynamicArray(const DynamicArray<T, Allocator>& other);
+		DynamicArray(const DynamicArray<T, Allocator>& other, const allocator_type& allocator);
+		DynamicArray(DynamicArray<T, Allocator>&& other);
 		~DynamicArray();
 		
+		// Access to the allocator
+		allocator_type get_allocator() const;
+		
 		// Access to current size and capacity
 		size_type size() const;
 		size_type capacity() const;
@@ -47,12 +79,16 @@ class DynamicArray {
 		// Element insertion and deletion
 		// - Back
 		void push_back(const T& value);
+		void push_back(T&& value);
+		template <typename... Args>
+		T& emplace_back(Args&&... args);
 		void pop_back();
 		// - Front
 		void push_front(const T& value);
 		void pop_front();
 		// - Arbitrary
 		void insert(const_iterator position, const T& value);
+		void insert(const_iterator position, T&& value);
 		void remove(const_iterator position);
 		
 		// Iterators
@@ -69,22 +105,53 @@ class DynamicArray {
 		
 		// Operators
 		// - Assignment
-		DynamicArray<T>& operator=(const DynamicArray<T>& other);
-		DynamicArray<T>& operator=(DynamicArray<T>&& other);
+		DynamicArray<T, Allocator>& operator=(const DynamicArray<T, Allocator>& other);
+		DynamicArray<T, Allocator>& operator=(DynamicArray<T, Allocator>&& other);
 		// - Indexing
 		T& operator[](size_type index);
 		const T& operator[](size_type index) const;
 		// - Equality testing
-		bool operator==(const DynamicArray<T>& other) const;
-		bool operator!=(const DynamicArray<T>& other) const;
-	
+		bool operator==(const DynamicArray<T, Allocator>& other) const;
+		bool operator!=(const DynamicArray<T, Allocator>& other) const;
+		
+		// Saving to a file that MappedArray can read
+		void save(const std::string& path) const;
+		
 	private:
+		typedef std::allocator_traits<Allocator> allocator_traits;
+		
 		T* m_data;
 		size_type m_capacity;
 		size_type m_size;
 		
-		// Swap function for a DynamicArray.
-		void m_swap(DynamicArray<T>& other);
+		// Swap function for a DynamicArray, which must have an equal allocator
+		// unless propagate_on_container_swap is true.
+		void m_swap(DynamicArray<T, Allocator>& other);
+		// Copies the elements of another array into this empty one.
+		void m_copyFrom(const DynamicArray<T, Allocator>& other);
+		
+		// The capacity to grow to when the array is full.
+		size_type m_nextCapacity() const;
+		// Adds an element at the back when there is no room left for it.
+		template <typename... Args>
+		T& m_emplaceBackGrow(Args&&... args);
+		// Adds an element at an index, shifting the later elements back.
+		void m_insertAt(size_type index, T&& value);
+		
+		// Raw memory for elements, which are constructed separately.
+		T* m_allocate(size_type capacity);
+		void m_deallocate(T* data, size_type capacity);
+		// Constructs and destroys elements through the allocator.
+		template <typename... Args>
+		void m_construct(T* to, Args&&... args);
+		void m_destroy(T* first, size_type count);
+		// Constructs a number of elements from the same arguments.
+		template <typename... Args>
+		void m_fill(T* to, size_type count, const Args&... args);
+		// Moves elements into raw memory, leaving the originals destroyed.
+		void m_relocate(T* from, size_type count, T* to);
+		void m_relocate(T* from, size_type count, T* to, std::true_type);
+		void m_relocate(T* from, size_type count, T* to, std::false_type);
 };
 
 /**
@@ -95,9 +162,19 @@ class DynamicArray {
  * control over how much space is initially allocated, either the `reserve`
  * method or a constructor specifying an initial size should be used.
  */
-template <typename T>
-DynamicArray<T>::DynamicArray() {
-	m_data = new T[DYNAMICARRAY_DEFAULT_CAPACITY];
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray()
+	: DynamicArray(allocator_type())
+{}
+/**
+ * Constructs an empty array that gets its memory from an allocator.
+ * @param	allocator	The allocator for the array to use
+ */
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray(const allocator_type& allocator)
+	: AllocatorHolder<Allocator>(allocator)
+{
+	m_data = m_allocate(DYNAMICARRAY_DEFAULT_CAPACITY);
 	m_capacity = DYNAMICARRAY_DEFAULT_CAPACITY;
 	m_size = 0;
 }
@@ -107,84 +184,129 @@ DynamicArray<T>::DynamicArray() {
  * Initial elements are made with the default constructor.
  *
  * @param	a_size	The initial size of the array
+ * @param	allocator	The allocator for the array to use
  */
-template <typename T>
-DynamicArray<T>::DynamicArray(size_type size) {
-	m_data = new T[size];
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray(size_type size, const allocator_type& allocator)
+	: AllocatorHolder<Allocator>(allocator)
+{
+	m_data = m_allocate(size);
 	m_capacity = size;
-	m_size = size;
 	
-	for (T* p = m_data; p != m_data + m_size; ++p) {
-		*p = T();
+	try {
+		m_fill(m_data, size);
+	}
+	catch (...) {
+		m_deallocate(m_data, m_capacity);
+		throw;
 	}
+	
+	m_size = size;
 }
 /**
  * Constructs an array filled with the specified value.
  * @param	a_size	The initial size of the array
  * @param	a_value	The value used to fill the elements
+ * @param	allocator	The allocator for the array to use
  */
-template <typename T>
-DynamicArray<T>::DynamicArray(size_type size, const T& value) {
-	m_data = new T[size];
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray(size_type size, const T& value, const allocator_type& allocator)
+	: AllocatorHolder<Allocator>(allocator)
+{
+	m_data = m_allocate(size);
 	m_capacity = size;
-	m_size = size;
 	
-	for (T* p = m_data; p != m_data + m_size; ++p) {
-		*p = value;
+	try {
+		m_fill(m_data, size, value);
+	}
+	catch (...) {
+		m_deallocate(m_data, m_capacity);
+		throw;
 	}
+	
+	m_size = size;
 }
 /**
  * Constructs an array by copying from a constant reference to another array.
+ *
+ * The allocator is copied the way std::allocator_traits says it should be
+ * for a container copy.
+ *
  * @param	other	The DynamicArray to copy data from
  */
-template <typename T>
-DynamicArray<T>::DynamicArray(const DynamicArray<T>& other) {
-	this->m_capacity = other.m_capacity;
-	this->m_size = other.m_size;
-	this->m_data = new T[this->m_capacity];
-	
-	for (size_type i = 0; i < this->m_size; ++i) {
-		this->m_data[i] = other.m_data[i];
-	}
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray(const DynamicArray<T, Allocator>& other)
+	: AllocatorHolder<Allocator>(allocator_traits::select_on_container_copy_construction(other.allocator()))
+{
+	m_copyFrom(other);
+}
+/**
+ * Constructs an array by copying another, using a different allocator.
+ * @param	other	The DynamicArray to copy data from
+ * @param	allocator	The allocator for the copy to use
+ */
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray(const DynamicArray<T, Allocator>& other, const allocator_type& allocator)
+	: AllocatorHolder<Allocator>(allocator)
+{
+	m_copyFrom(other);
 }
 /**
  * Constructs an array by swapping contents with another array.
+ *
+ * This starts out with no memory at all, so the other array is left empty
+ * and without any memory after the swap. The allocator is copied from the
+ * other array, so the memory can be freed by either of them.
+ *
  * @param	other	The DynamicArray to swap contents with
  */
-template <typename T>
-DynamicArray<T>::DynamicArray(DynamicArray<T>&& other) {
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray(DynamicArray<T, Allocator>&& other)
+	: AllocatorHolder<Allocator>(other.allocator()), m_data(nullptr), m_capacity(0), m_size(0)
+{
 	this->m_swap(other);
 }
 /**
- * Destructor for a DynamicArray, frees the underlying array from the heap.
+ * Destructor for a DynamicArray, destroys the elements and frees the
+ * underlying array from the heap.
+ */
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::~DynamicArray() {
+	m_destroy(m_data, m_size);
+	m_deallocate(m_data, m_capacity);
+}
+
+/**
+ * Provides a copy of the allocator this array uses for its memory.
+ * @return	The allocator of the array
  */
-template <typename T>
-DynamicArray<T>::~DynamicArray() {
-	delete [] m_data;
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::allocator_type DynamicArray<T, Allocator>::get_allocator() const {
+	return this->allocator();
 }
 
 /**
  * Gets the size of the array for the user.
  * @return	The number of elements in the array
  */
-template <typename T>
-typename DynamicArray<T>::size_type DynamicArray<T>::size() const {
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::size_type DynamicArray<T, Allocator>::size() const {
 	return m_size;
 }
 /**
  * Gets the capacity of the array for the user.
  * @return	The number of elements (used and unused) allocated in the array
  */
-template <typename T>
-typename DynamicArray<T>::size_type DynamicArray<T>::capacity() const {
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::size_type DynamicArray<T, Allocator>::capacity() const {
 	return m_capacity;
 }
 /**
  * Reports on whether or not this DynamicArray is empty.
  * @return	Whether or not this array has any in-use elements
  */
-template <typename T>
-bool DynamicArray<T>::empty() const {
+template <typename T, typename Allocator>
+bool DynamicArray<T, Allocator>::empty() const {
 	return m_size == 0;
 }
 
@@ -192,19 +314,21 @@ bool DynamicArray<T>::empty() const {
  * Set the size of the DynamicArray to the specified value.
  *
  * If elements need to be added, uses the default constructor for T.
+ * If elements need to be removed, they are destroyed.
  *
  * @param	size	The desired size for the array
  */
-template <typename T>
-void DynamicArray<T>::resize(size_type size) {
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::resize(size_type size) {
 	if (m_capacity < size) {
 		reserve(size);
 	}
 	
 	if (m_size < size) {
-		for (size_type i = m_size; i < size; ++i) {
-			m_data[i] = T();
-		}
+		m_fill(m_data + m_size, size - m_size);
+	}
+	else {
+		m_destroy(m_data + size, m_size - size);
 	}
 	
 	m_size = size;
@@ -216,18 +340,25 @@ void DynamicArray<T>::resize(size_type size) {
  * This will only ensure that enough memory has been allocated.
  * This method will not shrink the capacity of the array.
  *
+ * The elements are moved into the new memory if that can't throw, and
+ * copied otherwise, so that the array is unchanged if a copy does throw.
+ *
  * @param	capacity	Desired capacity for this array
  */
-template <typename T>
-void DynamicArray<T>::reserve(size_type capacity) {
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::reserve(size_type capacity) {
 	if (m_capacity < capacity) {
-		T* next_data = new T[capacity];
+		T* next_data = m_allocate(capacity);
 		
-		for (size_type i = 0; i < m_size; ++i) {
-			next_data[i] = m_data[i];
+		try {
+			m_relocate(m_data, m_size, next_data);
+		}
+		catch (...) {
+			m_deallocate(next_data, capacity);
+			throw;
 		}
 		
-		delete [] m_data;
+		m_deallocate(m_data, m_capacity);
 		m_data = next_data;
 		m_capacity = capacity;
 	}
@@ -237,31 +368,49 @@ void DynamicArray<T>::reserve(size_type capacity) {
  * Adds the provided element to the back of the array.
  * @param	value	The value to place at the back of the array
  */
-template <typename T>
-void DynamicArray<T>::push_back(const T& value) {
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::push_back(const T& value) {
+	emplace_back(value);
+}
+/**
+ * Moves the provided element onto the back of the array.
+ * @param	value	The value to place at the back of the array
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::push_back(T&& value) {
+	emplace_back(std::move(value));
+}
+/**
+ * Constructs a new element in place at the back of the array.
+ *
+ * The arguments are passed straight on to a constructor of T, so the element
+ * is built where it will live, without a temporary to copy or move from.
+ *
+ * @param	args	The arguments for the constructor of T
+ * @return	A reference to the new element
+ */
+template <typename T, typename Allocator>
+template <typename... Args>
+T& DynamicArray<T, Allocator>::emplace_back(Args&&... args) {
 	if (m_size == m_capacity) {
-		size_type next_capacity = m_capacity * DYNAMICARRAY_GROWTH_FACTOR;
-		if (next_capacity == 0) {
-			next_capacity = 1;
-		}
-		
-		reserve(next_capacity);
+		return m_emplaceBackGrow(std::forward<Args>(args)...);
 	}
 	
-	m_data[m_size] = value;
+	m_construct(m_data + m_size, std::forward<Args>(args)...);
 	++m_size;
+	
+	return m_data[m_size - 1];
 }
 /**
  * Removes one element from the back of the array.
  * @throws	OutOfBoundsError	when the array is empty
  */
-template <typename T>
-void DynamicArray<T>::pop_back() {
-	if (m_size <= 0) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::pop_back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
 	
 	--m_size;
+	m_destroy(m_data + m_size, 1);
 }
 /**
  * Adds the provided element to the front of the array.
@@ -271,18 +420,9 @@ void DynamicArray<T>::pop_back() {
  *
  * @param	value	The value to place at the front of the array
  */
-template <typename T>
-void DynamicArray<T>::push_front(const T& value) {
-	if (m_size == 0) {
-		push_back(value);
-	}
-	else {
-		push_back(m_data[m_size-1]);
-		for (size_type i = m_size - 2; i > 1; --i) {
-			m_data[i] = m_data[i-1];
-		}
-		m_data[0] = value;
-	}
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::push_front(const T& value) {
+	m_insertAt(0, T(value));
 }
 /**
  * Removes an element from the front of the array.
@@ -292,17 +432,14 @@ void DynamicArray<T>::push_front(const T& value) {
  *
  * @throws	OutOfBoundsError	when the array is empty
  */
-template <typename T>
-void DynamicArray<T>::pop_front() {
-	if (m_size <= 0) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::pop_front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
 	
-	for (size_type i = 1; i < m_size; ++i) {
-		m_data[i-1] = m_data[i];
-	}
+	std::move(m_data + 1, m_data + m_size, m_data);
 	
 	m_size--;
+	m_destroy(m_data + m_size, 1);
 }
 /**
  * Inserts an element before an arbitrary iterator in the array.
@@ -310,45 +447,38 @@ void DynamicArray<T>::pop_front() {
  * @param	position	The location to insert the element before
  * @param	value	The value to insert into the array
  */
-template <typename T>
-void DynamicArray<T>::insert(const_iterator position, const T& value) {
-	size_type index = position - m_data;
-	
-	if (m_size == m_capacity) {
-		size_type next_capacity = m_capacity * DYNAMICARRAY_GROWTH_FACTOR;
-		if (next_capacity == 0) {
-			next_capacity = 1;
-		}
-		
-		reserve(next_capacity);
-	}
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::insert(const_iterator position, const T& value) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= m_data && position <= m_data + m_size);
 	
-	for (size_type i = m_size; i > index; --i) {
-		m_data[i] = m_data[i-1];
-	}
+	m_insertAt(position - m_data, T(value));
+}
+/**
+ * Moves an element into the array before an arbitrary iterator.
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	The location to insert the element before
+ * @param	value	The value to move into the array
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::insert(const_iterator position, T&& value) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= m_data && position <= m_data + m_size);
 	
-	m_data[index = value];
-	++m_size;
+	m_insertAt(position - m_data, std::move(value));
 }
 /**
  * Removes an element from an arbitrary point in the array.
  * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
  * @param	position	An iterator pointing to the element to remove
  */
-template <typename T>
-void DynamicArray<T>::remove(const_iterator position) {
-	if (m_size == 0) {
-		throw OutOfBoundsError();
-	}
-	if (position < m_data || position >= m_data + m_size) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::remove(const_iterator position) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= m_data && position < m_data + m_size);
 	
-	for (T* itr = position + 1; itr < m_data + m_size; ++itr) {
-		*itr = *(itr+1);
-	}
+	T* removed = m_data + (position - m_data);
+	std::move(removed + 1, m_data + m_size, removed);
 	
 	--m_size;
+	m_destroy(m_data + m_size, 1);
 }
 
 /**
@@ -356,11 +486,9 @@ void DynamicArray<T>::remove(const_iterator position) {
  * @throws	OutOfBoundsError	when the array is empty
  * @return	A reference to the first element of the array
  */
-template <typename T>
-T& DynamicArray<T>::front() {
-	if (m_size == 0) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+T& DynamicArray<T, Allocator>::front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
 	
 	return m_data[0];
 }
@@ -369,11 +497,9 @@ T& DynamicArray<T>::front() {
  * @throws	OutOfBoundsError	when the array is empty
  * @return	A constant reference to the first element of the array
  */
-template <typename T>
-const T& DynamicArray<T>::front() const {
-	if (m_size == 0) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+const T& DynamicArray<T, Allocator>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
 	
 	return m_data[0];
 }
@@ -382,11 +508,9 @@ const T& DynamicArray<T>::front() const {
  * @throws	OutOfBoundsError	when the array is empty
  * @return	A reference to the last element of the array
  */
-template <typename T>
-T& DynamicArray<T>::back() {
-	if (m_size == 0) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+T& DynamicArray<T, Allocator>::back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
 	
 	return m_data[m_size - 1];
 }
@@ -395,11 +519,9 @@ T& DynamicArray<T>::back() {
  * @throws	OutOfBoundsError	when the array is empty
  * @return	A constant reference to the last element of the array
  */
-template <typename T>
-const T& DynamicArray<T>::back() const {
-	if (m_size == 0) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+const T& DynamicArray<T, Allocator>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
 	
 	return m_data[m_size - 1];
 }
@@ -411,8 +533,8 @@ const T& DynamicArray<T>::back() const {
  *
  * @return	An iterator at the start of this DynamicArray
  */
-template <typename T>
-typename DynamicArray<T>::iterator DynamicArray<T>::begin() {
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::iterator DynamicArray<T, Allocator>::begin() {
 	return m_data;
 }
 /**
@@ -423,8 +545,8 @@ typename DynamicArray<T>::iterator DynamicArray<T>::begin() {
  *
  * @return	A const_iterator to the start of this DynamicArray
  */
-template <typename T>
-typename DynamicArray<T>::const_iterator DynamicArray<T>::begin() const {
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::const_iterator DynamicArray<T, Allocator>::begin() const {
 	return m_data;
 }
 /**
@@ -435,8 +557,8 @@ typename DynamicArray<T>::const_iterator DynamicArray<T>::begin() const {
  *
  * @return	An iterator at the start of this DynamicArray
  */
-template <typename T>
-typename DynamicArray<T>::iterator DynamicArray<T>::end() {
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::iterator DynamicArray<T, Allocator>::end() {
 	return m_data + m_size;
 }
 /**
@@ -447,8 +569,8 @@ typename DynamicArray<T>::iterator DynamicArray<T>::end() {
  *
  * @return	A const_iterator to the end of this DynamicArray
  */
-template <typename T>
-typename DynamicArray<T>::const_iterator DynamicArray<T>::end() const {
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::const_iterator DynamicArray<T, Allocator>::end() const {
 	return m_data + m_size;
 }
 
@@ -459,50 +581,75 @@ typename DynamicArray<T>::const_iterator DynamicArray<T>::end() const {
  * This means it relies on the copy constructor and a swap method
  * (provided as member function m_swap in this class).
  *
+ * The copy is made with this array's allocator, so this array keeps its
+ * allocator and the swap is between arrays that can free each other's memory.
+ *
  * @param	other	The array to copy data from
  * @return	A reference to this after copying
  */
-template <typename T>
-DynamicArray<T>& DynamicArray<T>::operator=(const DynamicArray<T>& other) {
-	DynamicArray<T> tmp(other);
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>& DynamicArray<T, Allocator>::operator=(const DynamicArray<T, Allocator>& other) {
+	DynamicArray<T, Allocator> tmp(other, this->allocator());
 	this->m_swap(tmp);
 	return *this;
 }
 /**
  * Move-assigns the contents of another array to this array.
+ *
+ * If the allocator's propagate_on_container_move_assignment is true, this
+ * array frees its own elements and takes the other array's allocator along
+ * with its memory. Otherwise, if the allocators compare unequal, this array
+ * can't free the other array's memory, so the elements are moved across one
+ * at a time instead of swapping.
+ *
  * @param	other	The vector to swap data with
  * @return	A reference to this after the swap has happened
  */
-template <typename T>
-DynamicArray<T>& DynamicArray<T>::operator=(DynamicArray<T>&& other) {
-	this->m_swap(other);
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>& DynamicArray<T, Allocator>::operator=(DynamicArray<T, Allocator>&& other) {
+	if (allocator_traits::propagate_on_container_move_assignment::value) {
+		DynamicArray<T, Allocator> old(std::move(*this));
+		this->allocator() = other.allocator();
+		this->m_swap(other);
+	}
+	else if (this->allocator() == other.allocator()) {
+		this->m_swap(other);
+	}
+	else {
+		DynamicArray<T, Allocator> tmp(this->allocator());
+		tmp.reserve(other.m_size);
+		for (size_type i = 0; i < other.m_size; ++i) {
+			tmp.emplace_back(std::move(other.m_data[i]));
+		}
+		this->m_swap(tmp);
+	}
 	return *this;
 }
 /**
  * Provides a reference to an element at any index of the array.
- * @throws	OutOfBoundsError	when the requested index is < 0 or > m_size
+ *
+ * The index is checked according to the policy in Checks.hpp, which can
+ * turn the check into an assertion or leave it out.
+ *
+ * @throws	OutOfBoundsError	when the requested index is >= m_size
  * @param	index	The index in the array to retrieve data from
  * @return A reference to the data at the requested index
  */
-template <typename T>
-T& DynamicArray<T>::operator[](size_type index) {
-	if (index < 0 || index >= m_size) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+T& DynamicArray<T, Allocator>::operator[](size_type index) {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
 	
 	return m_data[index];
 }
 /**
  * Provides a consant reference to an element at any index of the array.
- * @throws	OutOfBoundsError	when the requested index is < 0 or > m_size
+ * @throws	OutOfBoundsError	when the requested index is >= m_size
  * @param	index	The index in the array to retrieve data from
  * @return A constant reference to the data at the requested index
  */
-template <typename T>
-const T& DynamicArray<T>::operator[](size_type index) const {
-	if (index < 0 || index >= m_size) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+const T& DynamicArray<T, Allocator>::operator[](size_type index) const {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
 	
 	return m_data[index];
 }
@@ -515,8 +662,8 @@ const T& DynamicArray<T>::operator[](size_type index) const {
  * @param	other	The array to compare this against
  * @return	Boolean representing whether these arrays are equal
  */
-template <typename T>
-bool DynamicArray<T>::operator==(const DynamicArray<T>& other) const {
+template <typename T, typename Allocator>
+bool DynamicArray<T, Allocator>::operator==(const DynamicArray<T, Allocator>& other) const {
 	if (this->m_size != other.m_size) {
 		return false;
 	}
@@ -538,35 +685,279 @@ bool DynamicArray<T>::operator==(const DynamicArray<T>& other) const {
  * @param	other	The array to compare this against
  * @return	Boolean representing whether these arrays are not equal
  */
-template <typename T>
-bool DynamicArray<T>::operator!=(const DynamicArray<T>& other) const {
+template <typename T, typename Allocator>
+bool DynamicArray<T, Allocator>::operator!=(const DynamicArray<T, Allocator>& other) const {
 	return (!(*this == other));
 }
 
+/**
+ * Saves the elements of the array to a file, for MappedArray to read.
+ *
+ * The elements are written exactly as they are in memory. Only the elements
+ * in use are saved, not the spare capacity.
+ *
+ * @throws	FileError	when the file can't be written
+ * @param	path	The path to save the file at, replacing any file there
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::save(const std::string& path) const {
+	static_assert(std::is_trivially_copyable<T>::value, "Only arrays of trivially copyable types can be saved");
+	
+	MappedFile_Writer writer(path, mappedFileHeader(MAPPEDFILE_KIND_ARRAY, sizeof(T), sizeof(T), 0, m_size, m_size, 0));
+	writer.write(m_data, m_size * sizeof(T));
+	writer.commit();
+}
+
 /**
  * Swaps the member variables of this with those of another DynamicArray.
+ *
+ * The allocators are swapped too if propagate_on_container_swap says so.
+ * Otherwise they must compare equal, so that each array can free the memory
+ * it ends up with.
+ *
  * @param	other	The array to swap contents with
  */
-template <typename T>
-void DynamicArray<T>::m_swap(DynamicArray<T>& other) {
-	T* tmp_data;
-	size_type tmp_size;
-	size_type tmp_capacity;
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_swap(DynamicArray<T, Allocator>& other) {
+	swapAllocators(this->allocator(), other.allocator());
+	std::swap(this->m_data, other.m_data);
+	std::swap(this->m_size, other.m_size);
+	std::swap(this->m_capacity, other.m_capacity);
+}
+/**
+ * Copies the elements of another array into this one, which has no memory yet.
+ *
+ * The copy is only as large as the other array's capacity.
+ *
+ * @param	other	The array to copy data from
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_copyFrom(const DynamicArray<T, Allocator>& other) {
+	this->m_capacity = other.m_capacity;
+	this->m_data = m_allocate(this->m_capacity);
+	
+	size_type copied = 0;
 	
-	// Swap the data pointers.
-	tmp_data = this->m_data;
-	this->m_data = other.m_data;
-	other.m_data = tmp_data;
+	try {
+		for (; copied < other.m_size; ++copied) {
+			m_construct(this->m_data + copied, other.m_data[copied]);
+		}
+	}
+	catch (...) {
+		m_destroy(this->m_data, copied);
+		m_deallocate(this->m_data, this->m_capacity);
+		throw;
+	}
 	
-	// Swap the sizes.
-	tmp_size = this->m_size;
 	this->m_size = other.m_size;
-	other.m_size = tmp_size;
+}
+
+/**
+ * Works out the capacity to grow to when the array is full.
+ * @return	The current capacity times the growth factor, and at least 1
+ */
+template <typename T, typename Allocator>
+typename DynamicArray<T, Allocator>::size_type DynamicArray<T, Allocator>::m_nextCapacity() const {
+	size_type next_capacity = m_capacity * DYNAMICARRAY_GROWTH_FACTOR;
+	if (next_capacity == 0) {
+		next_capacity = 1;
+	}
+	return next_capacity;
+}
+/**
+ * Adds an element to the back of a full array, growing it first.
+ *
+ * The arguments might refer to an element of this array (for example
+ * `array.push_back(array[0])`), so the new element is constructed in the new
+ * memory before the old elements are moved out from under it.
+ *
+ * @param	args	The arguments for the constructor of T
+ * @return	A reference to the new element
+ */
+template <typename T, typename Allocator>
+template <typename... Args>
+T& DynamicArray<T, Allocator>::m_emplaceBackGrow(Args&&... args) {
+	size_type next_capacity = m_nextCapacity();
+	T* next_data = m_allocate(next_capacity);
 	
-	// Swap the capacities.
-	tmp_capacity = this->m_capacity;
-	this->m_capacity = other.m_capacity;
-	other.m_capacity = tmp_capacity;
+	try {
+		m_construct(next_data + m_size, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		m_deallocate(next_data, next_capacity);
+		throw;
+	}
+	
+	try {
+		m_relocate(m_data, m_size, next_data);
+	}
+	catch (...) {
+		m_destroy(next_data + m_size, 1);
+		m_deallocate(next_data, next_capacity);
+		throw;
+	}
+	
+	m_deallocate(m_data, m_capacity);
+	m_data = next_data;
+	m_capacity = next_capacity;
+	++m_size;
+	
+	return m_data[m_size - 1];
+}
+/**
+ * Adds an element at an index, shifting every later element back by one.
+ *
+ * The value is taken by the caller before this is called, so it's safe for it
+ * to have come from an element of this array.
+ *
+ * @param	index	Where the new element should end up, at most m_size
+ * @param	value	The value to move into the array
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_insertAt(size_type index, T&& value) {
+	if (index == m_size) {
+		emplace_back(std::move(value));
+		return;
+	}
+	
+	// The last element moves into the unconstructed slot past the end, and
+	// everything else between index and there shifts back by assignment
+	emplace_back(std::move(m_data[m_size - 1]));
+	std::move_backward(m_data + index, m_data + m_size - 2, m_data + m_size - 1);
+	m_data[index] = std::move(value);
+}
+
+/**
+ * Allocates memory for elements from the allocator, without constructing any.
+ *
+ * std::allocator takes care of types that need more alignment than usual.
+ *
+ * @param	capacity	The number of elements the memory should fit
+ * @return	A pointer to the memory, or nullptr if capacity is 0
+ */
+template <typename T, typename Allocator>
+T* DynamicArray<T, Allocator>::m_allocate(size_type capacity) {
+	if (capacity == 0) {
+		return nullptr;
+	}
+	
+	return allocator_traits::allocate(this->allocator(), capacity);
+}
+/**
+ * Frees memory from m_allocate. Any elements in it must be destroyed first.
+ * @param	data	The memory to free
+ * @param	capacity	The capacity the memory was allocated with
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_deallocate(T* data, size_type capacity) {
+	if (data == nullptr) {
+		return;
+	}
+	
+	allocator_traits::deallocate(this->allocator(), data, capacity);
+}
+/**
+ * Constructs an element in raw memory through the allocator.
+ * @param	to	Raw memory for the element
+ * @param	args	The arguments for the constructor of T
+ */
+template <typename T, typename Allocator>
+template <typename... Args>
+void DynamicArray<T, Allocator>::m_construct(T* to, Args&&... args) {
+	allocator_traits::construct(this->allocator(), to, std::forward<Args>(args)...);
+}
+/**
+ * Destroys elements through the allocator, leaving their memory raw.
+ * @param	first	The first element to destroy
+ * @param	count	The number of elements to destroy
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_destroy(T* first, size_type count) {
+	for (size_type i = 0; i < count; ++i) {
+		allocator_traits::destroy(this->allocator(), first + i);
+	}
+}
+/**
+ * Constructs a number of elements in raw memory from the same arguments.
+ *
+ * If one of the constructors throws, the elements made so far are destroyed
+ * before the exception is passed on.
+ *
+ * @param	to	Raw memory with room for count elements
+ * @param	count	The number of elements to construct
+ * @param	args	The arguments for each constructor of T
+ */
+template <typename T, typename Allocator>
+template <typename... Args>
+void DynamicArray<T, Allocator>::m_fill(T* to, size_type count, const Args&... args) {
+	size_type made = 0;
+	
+	try {
+		for (; made < count; ++made) {
+			m_construct(to + made, args...);
+		}
+	}
+	catch (...) {
+		m_destroy(to, made);
+		throw;
+	}
+}
+/**
+ * Moves elements into raw memory, destroying the originals.
+ *
+ * Trivially copyable types are moved all at once with memcpy, and other
+ * types are moved (or copied) one at a time.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_relocate(T* from, size_type count, T* to) {
+	m_relocate(from, count, to, std::is_trivially_copyable<T>());
+}
+/**
+ * Moves trivially copyable elements into raw memory with memcpy.
+ *
+ * For these types copying the bytes is exactly what the copy constructor
+ * does, and there is nothing for a destructor to do afterwards.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_relocate(T* from, size_type count, T* to, std::true_type) {
+	if (count > 0) {
+		std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+	}
+}
+/**
+ * Moves elements into raw memory one at a time.
+ *
+ * If T's move constructor might throw, the elements are copied instead. Then
+ * if one of the copies throws, the originals are all still intact, and the
+ * copies made so far are destroyed before the exception is passed on.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::m_relocate(T* from, size_type count, T* to, std::false_type) {
+	size_type moved = 0;
+	
+	try {
+		for (; moved < count; ++moved) {
+			m_construct(to + moved, std::move_if_noexcept(from[moved]));
+		}
+	}
+	catch (...) {
+		m_destroy(to, moved);
+		throw;
+	}
+	
+	m_destroy(from, count);
 }
 
 #endif // Fundamentals_DynamicArray_hpp_
@@ -29,6 +29,18 @@ class OutOfBoundsError : public Exception {
  */
 class MismatchedIteratorError : public Exception {
 };
+/**
+ * Exception thrown when linking an object into an intrusive list while it is
+ * already linked, or unlinking an object that isn't in the list.
+ */
+class MismatchedObjectError : public Exception {
+};
+/**
+ * Exception thrown when moving nodes between two linked lists whose
+ * allocators don't compare equal.
+ */
+class MismatchedAllocatorError : public Exception {
+};
 /**
  * Exception thrown when trying to construct a Hashed data structure without
  * providing a hash function.
@@ -55,5 +67,36 @@ class DuplicateElementError : public Exception {
  */
 class MissingElementError : public Exception {
 };
+/**
+ * Exception thrown when giving a hash table a maximum load factor that isn't
+ * between 0 and 1.
+ */
+class InvalidLoadFactorError : public Exception {
+};
+/**
+ * Exception thrown when a file can't be opened, mapped or written.
+ */
+class FileError : public Exception {
+};
+/**
+ * Exception thrown when mapping a file that wasn't saved by the same kind of
+ * data structure, with the same types, on the same kind of machine, or when
+ * reading a file that isn't in the format expected.
+ */
+class FileFormatError : public Exception {
+};
+/**
+ * Exception thrown when looking for shortest paths in a graph with a cycle
+ * whose weights add up to less than zero, so that some paths have no
+ * shortest length.
+ */
+class NegativeCycleError : public Exception {
+};
+/**
+ * Exception thrown when finding modular inverses for a modulus of zero, or
+ * one too large for the arithmetic they are found with.
+ */
+class InvalidModulusError : public Exception {
+};
 
 #endif // Fundamentals_DS_Exceptions_hpp_
@@ -0,0 +1,116 @@
+/**
+ * Fundamentals :: Data Structures :: Hash Build
+ * Author: Quinn Mortimer
+ *
+ * This file contains the part of building a HashMap or HashSet from a range
+ * of elements that can be shared between several threads.
+ */
+/**
+ * Adding a lot of keys to a big table one at a time is slow for two reasons.
+ * Every key has to be hashed, which for strings means reading the whole
+ * string. And every key lands somewhere random in the table, so once the
+ * table is bigger than the cache, nearly every insertion waits on memory.
+ *
+ * hashPartition spreads the hashing over several threads. While it's at it,
+ * it sorts the elements into partitions by the top bits of their home slot
+ * (the first slot of their probe sequence), so each partition covers one
+ * stretch of the table. The table is then filled one partition at a time,
+ * and each run of insertions starts its probes in a region of the table small
+ * enough to stay in cache.
+ *
+ * The filling itself happens on one thread. A probe sequence can go anywhere
+ * in the table after its first slot, so no part of the table belongs to just
+ * one partition, and threads filling it at the same time would write over
+ * each other's slots.
+ *
+ * The hash function is called from all of the threads at once, so it must be
+ * safe to call concurrently. Every hash function in Hashing.hpp is.
+ */
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "Threads.hpp"
+
+#ifndef Fundamentals_HashBuild_hpp_
+#define Fundamentals_HashBuild_hpp_
+
+// The most partitions the elements are sorted into. This must be a power of
+// two. Each partition covers 1/HASHBUILD_PARTITIONS of the table, so a table
+// of up to this many times the cache size is filled one cached region at a
+// time.
+#define HASHBUILD_PARTITIONS 256
+
+/**
+ * Hashes a range of elements and sorts them into partitions of the table.
+ *
+ * Each thread takes one contiguous share of the range. First every thread
+ * hashes its elements and counts how many fall in each partition. Those
+ * counts say exactly where each thread's elements in each partition go in
+ * the output, so the threads can then write out their elements without
+ * waiting on each other. Within a partition, elements stay in the order they
+ * are in the range.
+ *
+ * @param	first	The start of the range of elements
+ * @param	count	The number of elements in the range
+ * @param	capacity	The number of slots in the table, a power of two
+ * @param	threads	The number of threads to use, or 0 for one per hardware
+ * 	thread
+ * @param	hashOf	Gives the hash of an element of the range
+ * @param	hashes	Set to the hash of each element, by position in the range
+ * @param	order	Set to the position in the range of each element, with
+ * 	the elements of each partition together and the partitions in the order
+ * 	of the table
+ */
+template <typename RandomIt, typename HashOf>
+void hashPartition(RandomIt first, size_t count, size_t capacity, size_t threads, const HashOf& hashOf, std::vector<size_t>& hashes, std::vector<size_t>& order) {
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads > count) {
+		threads = count;
+	}
+	if (threads == 0) {
+		threads = 1;
+	}
+	
+	// The partition of a hash is the top bits of its home slot
+	size_t partitions = capacity < HASHBUILD_PARTITIONS ? capacity : HASHBUILD_PARTITIONS;
+	size_t shift = 0;
+	while ((partitions << shift) < capacity) {
+		++shift;
+	}
+	const size_t mask = capacity - 1;
+	
+	hashes.resize(count);
+	order.resize(count);
+	std::vector<size_t> offsets(threads * partitions, 0);
+	
+	runThreads(threads, [&](size_t thread) {
+		size_t* counts = offsets.data() + thread * partitions;
+		for (size_t i = thread * count / threads; i < (thread + 1) * count / threads; ++i) {
+			hashes[i] = hashOf(first[i]);
+			++counts[(hashes[i] & mask) >> shift];
+		}
+	});
+	
+	// Turn the counts into where each thread starts writing each partition
+	size_t total = 0;
+	for (size_t p = 0; p < partitions; ++p) {
+		for (size_t t = 0; t < threads; ++t) {
+			size_t partitionCount = offsets[t * partitions + p];
+			offsets[t * partitions + p] = total;
+			total += partitionCount;
+		}
+	}
+	
+	runThreads(threads, [&](size_t thread) {
+		size_t* next = offsets.data() + thread * partitions;
+		for (size_t i = thread * count / threads; i < (thread + 1) * count / threads; ++i) {
+			order[next[(hashes[i] & mask) >> shift]++] = i;
+		}
+	});
+}
+
+#endif // Fundamentals_HashBuild_hpp_
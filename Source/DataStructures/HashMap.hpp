@@ -10,36 +10,88 @@
 /**
  * In this data structure, memory management is not something we're trying to
  * demonstrate. As such, we'll allow the use of some of the standard library.
- * We will be using std::vector and std::swap in the code.
+ * We will be using std::vector, std::move and std::swap in the code.
+ */
+/**
+ * Keys can be looked up by any type the hash function is transparent for
+ * (see Hashing.hpp), such as a std::string_view for std::string keys. The
+ * key stored on a node is compared against it with ==.
+ *
+ * For lookups of a lot of keys at once, find_many hashes a batch of keys
+ * and starts loading each of their slots before comparing any of them. A
+ * single lookup in a big table usually waits on memory, and this way the
+ * waits for a whole batch happen at the same time instead of one by one.
+ */
+/**
+ * A map can be built from a whole range of key-value pairs at once, with the
+ * range constructor, an initializer list or insert_range. When the number of
+ * pairs can be counted up front, the underlying array is sized for all of
+ * them before any are added, so it never has to be rehashed along the way.
+ * insert_range can also hash the keys on several threads, and adds them in
+ * the order of their slots so that the table is filled one region at a time
+ * (see HashBuild.hpp).
+ */
+/**
+ * A map with trivially copyable keys and values can be saved to a file with
+ * save, and the file mapped back into memory as a MappedHashMap, which looks
+ * keys up in the saved table where it is without rebuilding it (see
+ * MappedFile.hpp and MappedHashMap.hpp).
+ */
+/**
+ * When FUNDAMENTALS_HASH_STATS is defined to 1, the map also counts its
+ * rehashes, and the stats method reports how well its keys are spread out
+ * (see HashStats.hpp).
  */
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "Exceptions.hpp"
+#include "HashBuild.hpp"
+#include "Hashing.hpp"
+#include "HashProbes.hpp"
+#include "HashStats.hpp"
+#include "MappedFile.hpp"
 
 #ifndef Fundamentals_HashMap_hpp_
 #define Fundamentals_HashMap_hpp_
 
+// Table sizes are always powers of two, so both of these must be as well
 #define HASHMAP_DEFAULT_CAPACITY 8
 #define HASHMAP_GROWTH_FACTOR 2
+// The maximum load factor a new map starts with (see HashMap::max_load_factor)
 #define HASHMAP_MAX_LOAD_FACTOR 0.75
-#define HASHMAP_COLLISION_SHIFT 4
+// The number of keys that find_many hashes and prefetches at a time
+#define HASHMAP_BATCH_SIZE 16
 
 /**
  * A Node class for the slots in our HashMap.
  *
- * Stores the key and value, as well as some flags for internal properties of
- * the node.
+ * Stores the key, value and hash of the key, as well as a flag for the state
+ * of the node.
+ *
+ * The key and value live inside the node itself, in raw storage that is only
+ * constructed while the node is in use. This way the whole table is a single
+ * contiguous allocation, and looking at a key never needs to chase a pointer.
  */
 template <typename Key, typename Value>
 class HashMap_Node {
 public:
 	// Constructor and destructor for a node.
+	// The map clears its nodes before destroying them, so the destructor
+	// doesn't destroy the key and value itself.
 	HashMap_Node();
-	~HashMap_Node();
+	~HashMap_Node() = default;
 	
 	// Using the default copy constructor leads to unsafe situations,
 	// and copying Values could be expensive.
@@ -47,61 +99,130 @@ public:
 	HashMap_Node(const HashMap_Node& other) = delete;
 	
 	// Set or clear the values on this node.
-	void set(const Key& k, const Value& v);
-	void clear();
+	// The allocator is the one for the table, and is only used to construct
+	// and destroy the key and value.
+	template <typename Allocator>
+	void set(Allocator allocator, const Key& k, const Value& v, size_t hash);
+	template <typename Allocator>
+	void moveFrom(Allocator allocator, HashMap_Node& other);
+	template <typename Allocator>
+	void clear(Allocator allocator);
 	
 	// Informational queries on this node.
 	bool empty() const;
 	bool unused() const;
-	bool keyEqual(const Key& k) const;
+	template <typename K>
+	bool keyEqual(const K& k, size_t hash) const;
 	
 	// Access to this node's important data members.
 	const Key& key() const;
 	const Value& value() const;
 	Value& value();
+	size_t hash() const;
+	
+	// Copy the bytes of this node for a saved file.
+	void writeImage(unsigned char* to) const;
 private:
-	// Key and value for the node.
-	Key* mp_key;
-	Value* mp_value;
-	// A flag indicating whether or not this node has ever been used.
-	bool m_unused;
+	// The states a node can be in.
+	// - STATE_EMPTY: No key has ever been set on this node.
+	// - STATE_TOMBSTONE: A key was set on this node, but has been cleared.
+	// - STATE_FULL: The node currently holds a key and a value.
+	enum State : unsigned char {
+		STATE_EMPTY,
+		STATE_TOMBSTONE,
+		STATE_FULL
+	};
+	
+	// Storage for the key and value of the node.
+	// These are only constructed while the node is in the full state.
+	alignas(Key) unsigned char m_keyStorage[sizeof(Key)];
+	alignas(Value) unsigned char m_valueStorage[sizeof(Value)];
+	// The hash of the key, kept so the table can be resized without
+	// hashing every key again.
+	size_t m_hashValue;
+	// The current state of this node.
+	unsigned char m_state;
 };
 
+// IncrementalHashMap is built out of HashMaps, and needs to move nodes
+// between them directly (see IncrementalHashMap.hpp).
+template <typename Key, typename Value, typename Probe, typename Hash>
+class IncrementalHashMap;
+
 /**
  * A HashMap data structure.
+ *
+ * The Probe parameter is the policy used to search the underlying array for
+ * the slot of a key. The default, PerturbProbe, checks one slot at a time.
+ * SimdProbe checks sixteen slots at a time using a separate array of control
+ * bytes. Both are in HashProbes.hpp, along with a description of what a
+ * probing policy needs to provide.
+ *
+ * The Hash parameter is the class of the hash function for keys, which is
+ * described in Hashing.hpp.
+ *
+ * The Allocator parameter provides the memory for the underlying array, and
+ * is used to construct the keys and values in it (see Allocation.hpp). Like
+ * std::unordered_map, it is an allocator of key-value pairs, which is rebound
+ * to the node type. Any state kept by the probing policy is still allocated
+ * with std::allocator.
  */
-template <typename Key, typename Value>
-class HashMap {
+template <typename Key, typename Value, typename Probe = PerturbProbe, typename Hash = DefaultHashFor<Key>, typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class HashMap : private HashHolder<Hash> {
 	public:
 		typedef size_t size_type;
-		typedef size_type (*hash_type)(const Key&);
+		typedef Hash hash_type;
+		typedef Allocator allocator_type;
 		
 		// Constructors
 		HashMap();
-		HashMap(const hash_type& hash);
-		HashMap(const hash_type& hash, size_type size);
-		HashMap(HashMap<Key, Value>&& other);
-		HashMap(const HashMap<Key, Value>& other);
+		explicit HashMap(const allocator_type& allocator);
+		HashMap(const hash_type& hash, const allocator_type& allocator = allocator_type());
+		HashMap(const hash_type& hash, size_type size, const allocator_type& allocator = allocator_type());
+		HashMap(HashMap<Key, Value, Probe, Hash, Allocator>&& other);
+		HashMap(const HashMap<Key, Value, Probe, Hash, Allocator>& other);
+		HashMap(const HashMap<Key, Value, Probe, Hash, Allocator>& other, const allocator_type& allocator);
+		template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+		HashMap(InputIt first, InputIt last, const hash_type& hash = hash_type(), const allocator_type& allocator = allocator_type());
+		HashMap(std::initializer_list<std::pair<Key, Value>> list, const hash_type& hash = hash_type(), const allocator_type& allocator = allocator_type());
 		
-		// Dynamic memory isn't directly allocated,
-		// so the default destructor is fine
-		~HashMap() = default;
+		// Destructor
+		~HashMap();
 		
 		// Assignment
-		HashMap<Key, Value>& operator=(const HashMap<Key, Value>& other);
-		HashMap<Key, Value>& operator=(HashMap<Key, Value>&& other);
+		HashMap<Key, Value, Probe, Hash, Allocator>& operator=(const HashMap<Key, Value, Probe, Hash, Allocator>& other);
+		HashMap<Key, Value, Probe, Hash, Allocator>& operator=(HashMap<Key, Value, Probe, Hash, Allocator>&& other);
 		
 		// Equality Testing
-		bool operator==(const HashMap<Key, Value>& other) const;
-		bool operator!=(const HashMap<Key, Value>& other) const;
+		bool operator==(const HashMap<Key, Value, Probe, Hash, Allocator>& other) const;
+		bool operator!=(const HashMap<Key, Value, Probe, Hash, Allocator>& other) const;
+		
+		// Access to the allocator
+		allocator_type get_allocator() const;
 		
 		// Access to current size
 		size_type size() const;
 		bool empty() const;
 		
+		// Control over the size of the underlying array
+		size_type capacity() const;
+		void reserve(size_type size);
+		void shrink_to_fit();
+		float max_load_factor() const;
+		void max_load_factor(float factor);
+
+#if FUNDAMENTALS_HASH_STATS
+		// Statistics about the underlying array
+		HashStats stats() const;
+#endif
+
 		// Element insertion and deletion
 		// - Functions that can throw exceptions
 		void insert(const Key& k, const Value& v);
+		template <typename InputIt>
+		void insert_range(InputIt first, InputIt last);
+		template <typename RandomIt>
+		void insert_range(RandomIt first, RandomIt last, size_type threads);
 		void remove(const Key& k);
 		// - Function that will not throw exceptions
 		void set(const Key& k, const Value& v);
@@ -115,61 +236,143 @@ class HashMap {
 		const Value& operator[](const Key& k) const;
 		Value& getValue(const Key& k);
 		const Value& getValue(const Key& k) const;
+		// - Look up keys that might be missing without exceptions
+		Value* find(const Key& k);
+		const Value* find(const Key& k) const;
+		bool try_get(const Key& k, Value& value) const;
+		// - Look up keys of other types, when the hash function allows it
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		bool hasKey(const K& k) const;
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		Value& getValue(const K& k);
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		const Value& getValue(const K& k) const;
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		Value* find(const K& k);
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		const Value* find(const K& k) const;
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		bool try_get(const K& k, Value& value) const;
+		// - Look up many keys at once
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		void find_many(const K* keys, size_type count, Value** results);
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		void find_many(const K* keys, size_type count, const Value** results) const;
 		// - Get all keys or all values
 		std::vector<Key> keys() const;
 		std::vector<Value> values() const;
 		
+		// Saving to a file that MappedHashMap can read
+		void save(const std::string& path) const;
+		
 	private:
 		typedef HashMap_Node<Key, Value> Node;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+		
+		friend class IncrementalHashMap<Key, Value, Probe, Hash>;
+		
+		// Constructs an empty map with a particular maximum load factor.
+		HashMap(const hash_type& hash, size_type size, float maxLoadFactor, const allocator_type& allocator);
 		
-		// The hash function for finding slot indices.
-		hash_type m_hash;
 		// The number of used slots in the underlying array.
 		size_type m_size;
+		// The number of slots whose key has been removed. These still have to be
+		// probed past, so they count towards the load just like used slots.
+		size_type m_tombstones;
 		// The size at which we will consider our HashMap too crowded.
 		size_type m_loadThreshold;
+		// The fraction of the slots that can be used before rehashing.
+		float m_maxLoadFactor;
 		// The underlying array of nodes for our HashMap.
-		std::vector<Node> m_nodes;
-		
+		std::vector<Node, NodeAllocator> m_nodes;
+		// The probing policy, along with any state it keeps about the nodes.
+		Probe m_probe;
+#if FUNDAMENTALS_HASH_STATS
+		// The rehashes this map has done, for its stats.
+		HashStats_Counters m_counters;
+#endif
+
 		// These are utilites for internal use.
 		// - Used to resize and rehash when the load factor is too big.
+		bool m_crowded() const;
+		size_type m_rehashSize() const;
 		void m_rehash();
+		void m_rehash(size_type size);
+		// - Moves a node from another table into this one during a rehash,
+		//   either leaving it full for its table to destroy, or clearing it.
+		void m_moveIn(Node& node);
+		void m_moveIn(Node& node, const NodeAllocator& from);
+		// - Destroys the key and value of every node, through the allocator.
+		void m_clearNodes();
 		// - Swaps contents with another HashMap.
-		void m_swap(HashMap<Key, Value>& other);
+		void m_swap(HashMap<Key, Value, Probe, Hash, Allocator>& other);
 		// - Adds all keys in another HashMap to the current map.
-		void m_update(const HashMap<Key, Value>& other);
+		void m_update(const HashMap<Key, Value, Probe, Hash, Allocator>& other);
+		// - Adds a key that is known to fit without rehashing.
+		void m_insert(const Key& key, const Value& value, size_type hashValue);
+		// - Adds a range of keys, sizing the array first if they can be counted.
+		template <typename InputIt>
+		void m_insertRange(InputIt first, InputIt last, std::input_iterator_tag);
+		template <typename ForwardIt>
+		void m_insertRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+		
+		// The size of the underlying array for holding a number of keys.
+		static size_type m_tableSize(size_type size, float maxLoadFactor);
+		
+		// Applies the hash function to a key.
+		template <typename K>
+		size_type m_hash(const K& key) const;
 		
 		// This is in some ways the real workhorse function for this class.
 		// It's how every other member function knows where keys should end up.
-		size_type m_findIndex(const Key& key) const;
+		template <typename K>
+		size_type m_findIndex(const K& key) const;
+		template <typename K>
+		size_type m_findIndex(const K& key, size_type hashValue) const;
+		// Finds the slots for up to HASHMAP_BATCH_SIZE keys at once.
+		template <typename K>
+		void m_findBatch(const K* keys, size_type count, size_type* indices) const;
+		// A lighter version of the above for keys known not to be in the map.
+		size_type m_findFreeIndex(size_type hashValue) const;
 };
 
 // ----------------//
 // HashMap Methods //
 // ----------------//
 /**
- * Default HashMap constructor - Invalid
+ * Constructs a HashMap with a default-constructed hash function.
  *
- * A HashMap requires at least a hash function to be constructed.
+ * For the default Hash parameter this is the built-in hash for the key
+ * type. A HashFunction has no function pointer when default-constructed, so
+ * that case still requires a hash function to be provided.
  *
- * @throws	MissingHashFunctionError	always
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
  */
-template <typename Key, typename Value>
-HashMap<Key, Value>::HashMap() {
-	throw MissingHashFunctionError();
-}
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap()
+	: HashMap(hash_type())
+{}
+/**
+ * Constructs a HashMap that gets its memory from an allocator.
+ *
+ * The hash function is default-constructed, as with the constructor above.
+ *
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(const allocator_type& allocator)
+	: HashMap(hash_type(), allocator)
+{}
 /**
  * Constucts a HashMap with a hash function for the key type.
  * @param	hash	The hash function for this to use
+ * @param	allocator	The allocator for this to use
  */
-template <typename Key, typename Value>
-HashMap<Key, Value>::HashMap(const hash_type& hash) {
-	m_hash = hash;
-	m_size = 0;
-	m_loadThreshold = HASHMAP_DEFAULT_CAPACITY * HASHMAP_MAX_LOAD_FACTOR;
-	
-	m_nodes = std::vector<Node>(HASHMAP_DEFAULT_CAPACITY);
-}
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(const hash_type& hash, const allocator_type& allocator)
+	: HashMap(hash, 0, allocator)
+{}
 /**
  * Constructs a HashMap from a hash function and a minimum load.
  *
@@ -179,70 +382,182 @@ HashMap<Key, Value>::HashMap(const hash_type& hash) {
  *
  * @param	hash	The hash function for this to use
  * @param	size	An amount of elements the table should be able to hold
+ * @param	allocator	The allocator for this to use
  */
-template <typename Key, typename Value>
-HashMap<Key, Value>::HashMap(const hash_type& hash, size_type size) {
-	m_hash = hash;
-	m_size = 0;
-	
-	size = size / HASHMAP_MAX_LOAD_FACTOR;
-	size_type tableSize;
-	
-	if (size < HASHMAP_DEFAULT_CAPACITY) {
-		tableSize = HASHMAP_DEFAULT_CAPACITY;
-	}
-	else {
-		tableSize = 1;
-		while (size > tableSize) {
-			tableSize <<= 1;
-		}
-	}
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(const hash_type& hash, size_type size, const allocator_type& allocator)
+	: HashMap(hash, size, HASHMAP_MAX_LOAD_FACTOR, allocator)
+{}
+/**
+ * Constructs a HashMap from a hash function, a minimum load and a maximum
+ * load factor.
+ *
+ * This is for rehashing, where the new array has to keep the load factor
+ * the map was given, so the size is worked out with it from the start.
+ *
+ * @param	hash	The hash function for this to use
+ * @param	size	An amount of elements the table should be able to hold
+ * @param	maxLoadFactor	The maximum load factor for this to use
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(const hash_type& hash, size_type size, float maxLoadFactor, const allocator_type& allocator)
+	: HashHolder<Hash>(hash), m_maxLoadFactor(maxLoadFactor), m_nodes(m_tableSize(size, maxLoadFactor), NodeAllocator(allocator))
+{
+	requireHashFunction(hash);
 	
-	m_loadThreshold = tableSize * HASHMAP_MAX_LOAD_FACTOR;
+	m_size = 0;
+	m_tombstones = 0;
+	m_loadThreshold = m_nodes.size() * static_cast<double>(m_maxLoadFactor);
 	
-	m_nodes = std::vector<Node>(tableSize);
+	m_probe.resize(m_nodes.size());
 }
 /**
  * Constructs a HashMap by copying the contents of another.
+ *
+ * The allocator is copied the way std::allocator_traits says it should be
+ * for a container copy.
+ *
  * @param	other	The HashMap to copy
  */
-template <typename Key, typename Value>
-HashMap<Key, Value>::HashMap(const HashMap<Key, Value>& other) {
-	m_hash = other.m_hash;
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(const HashMap<Key, Value, Probe, Hash, Allocator>& other)
+	: HashMap(other, allocator_type(std::allocator_traits<NodeAllocator>::select_on_container_copy_construction(other.m_nodes.get_allocator())))
+{}
+/**
+ * Constructs a HashMap by copying the contents of another, using a different
+ * allocator.
+ * @param	other	The HashMap to copy
+ * @param	allocator	The allocator for the copy to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(const HashMap<Key, Value, Probe, Hash, Allocator>& other, const allocator_type& allocator)
+	: HashHolder<Hash>(other.hashFunction()), m_maxLoadFactor(other.m_maxLoadFactor), m_nodes(other.m_nodes.size(), NodeAllocator(allocator))
+{
 	m_loadThreshold = other.m_loadThreshold;
-	m_nodes = std::vector<Node>(other.m_nodes.size());
+	m_probe.resize(m_nodes.size());
 	m_size = 0;
-	m_update(other);
+	m_tombstones = 0;
+	
+	// The destructor won't run if this throws, so the nodes that were
+	// already copied have to be cleared here
+	try {
+		m_update(other);
+	}
+	catch (...) {
+		m_clearNodes();
+		throw;
+	}
 }
 /**
 * Constructs a HashMap by swapping in the contents of another.
+*
+* The allocator is copied from the other map, so the memory can be freed by
+* either of them. The other map is left with an empty table of the default
+* capacity rather than none at all, so it can still be used.
+*
 * @param	other	The map to swap contents with.
 */
-template <typename Key, typename Value>
-HashMap<Key, Value>::HashMap(HashMap<Key, Value>&& other) {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(HashMap<Key, Value, Probe, Hash, Allocator>&& other)
+	: HashMap(other.hashFunction(), 0, other.m_maxLoadFactor, allocator_type(other.m_nodes.get_allocator()))
+{
 	m_swap(other);
 }
+/**
+ * Constructs a HashMap holding the key-value pairs in a range.
+ *
+ * The range can be of anything with the key as its first member and the
+ * value as its second, such as a std::pair or the entries of a std::map.
+ * When the iterators are at least forward iterators, the underlying array is
+ * sized for the whole range before anything is added.
+ *
+ * @throws	DuplicateKeyError	When the same key is in the range twice
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ * @param	hash	The hash function for this to use
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename InputIt, typename>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(InputIt first, InputIt last, const hash_type& hash, const allocator_type& allocator)
+	: HashMap(hash, allocator)
+{
+	insert_range(first, last);
+}
+/**
+ * Constructs a HashMap holding the key-value pairs in an initializer list.
+ * @throws	DuplicateKeyError	When the same key is in the list twice
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	list	The key-value pairs to add
+ * @param	hash	The hash function for this to use
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::HashMap(std::initializer_list<std::pair<Key, Value>> list, const hash_type& hash, const allocator_type& allocator)
+	: HashMap(hash, list.size(), allocator)
+{
+	insert_range(list.begin(), list.end());
+}
+/**
+ * Destructor for a HashMap.
+ *
+ * The keys and values were constructed through the allocator, so they are
+ * destroyed through it too, before the underlying array is freed.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>::~HashMap() {
+	m_clearNodes();
+}
 
 /**
  * Copy-assigns the contents of one HashMap to another.
+ *
+ * The copy is made with this map's allocator, so this map keeps its
+ * allocator and the swap is between maps that can free each other's memory.
+ *
  * @param	other	The map to copy from
  * @return	The modified version of this, after copying
  */
-template <typename Key, typename Value>
-HashMap<Key, Value>& HashMap<Key, Value>::operator=(const HashMap<Key, Value>& other) {
-	HashMap<Key, Value> tmp(other);
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>& HashMap<Key, Value, Probe, Hash, Allocator>::operator=(const HashMap<Key, Value, Probe, Hash, Allocator>& other) {
+	HashMap<Key, Value, Probe, Hash, Allocator> tmp(other, get_allocator());
 	m_swap(tmp);
-	m_hash = other.m_hash;
 	return *this;
 }
 /**
  * Move-assigns the contents of one HashMap to another.
+ *
+ * If the allocator's propagate_on_container_move_assignment is true, this
+ * map frees its own nodes and takes the other map's allocator along with its
+ * table. Otherwise, if the allocators compare unequal, this map can't free
+ * the other map's memory, so the nodes are moved into a new table from this
+ * map's allocator instead of swapping.
+ *
  * @param	other	The map to swap contents with
  * @return	The modified version of this, after the content swap
  */
-template <typename Key, typename Value>
-HashMap<Key, Value>& HashMap<Key, Value>::operator=(HashMap<Key, Value>&& other) {
-	m_swap(other);
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashMap<Key, Value, Probe, Hash, Allocator>& HashMap<Key, Value, Probe, Hash, Allocator>::operator=(HashMap<Key, Value, Probe, Hash, Allocator>&& other) {
+	if (std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value) {
+		HashMap<Key, Value, Probe, Hash, Allocator> taken(std::move(other));
+		m_clearNodes();
+		m_nodes = std::vector<Node, NodeAllocator>(taken.m_nodes.get_allocator());
+		m_swap(taken);
+	}
+	else if (m_nodes.get_allocator() == other.m_nodes.get_allocator()) {
+		m_swap(other);
+	}
+	else {
+		HashMap<Key, Value, Probe, Hash, Allocator> tmp(other.hashFunction(), other.m_size, other.m_maxLoadFactor, get_allocator());
+		for (size_type i = 0; i < other.m_nodes.size(); i++) {
+			if (!other.m_nodes[i].empty()) {
+				tmp.m_moveIn(other.m_nodes[i]);
+			}
+		}
+		m_swap(tmp);
+	}
 	return *this;
 }
 
@@ -257,8 +572,8 @@ HashMap<Key, Value>& HashMap<Key, Value>::operator=(HashMap<Key, Value>&& other)
  * @param	other	The HashMap to compare against
  * @return	true if all keys of both map to the same values, otherwise false
  */
-template <typename Key, typename Value>
-bool HashMap<Key, Value>::operator==(const HashMap<Key, Value>& other) const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::operator==(const HashMap<Key, Value, Probe, Hash, Allocator>& other) const {
 	if (m_size != other.m_size) {
 		return false;
 	}
@@ -280,64 +595,223 @@ bool HashMap<Key, Value>::operator==(const HashMap<Key, Value>& other) const {
  * @param	other	The HashMap to compare against
  * @return	false if all keys of both map to the same values, otherwise true
  */
-template <typename Key, typename Value>
-bool HashMap<Key, Value>::operator!=(const HashMap<Key, Value>& other) const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::operator!=(const HashMap<Key, Value, Probe, Hash, Allocator>& other) const {
 	return !(*this == other);
 }
- 
+
+/**
+ * Provides a copy of the allocator this map uses for its memory.
+ * @return	The allocator of the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::allocator_type HashMap<Key, Value, Probe, Hash, Allocator>::get_allocator() const {
+	return allocator_type(m_nodes.get_allocator());
+}
 /**
  * Reports the number of slots currently in-use in the HashMap.
  * @return	The number of valid key-value pairs in the map
  */
-template <typename Key, typename Value>
-typename HashMap<Key, Value>::size_type HashMap<Key, Value>::size() const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::size() const {
 	return m_size;
 }
 /**
  * Reports whether or not the HashMap is empty.
  * @return	Whether there are any used slots in the map
  */
-template <typename Key, typename Value>
-bool HashMap<Key, Value>::empty() const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::empty() const {
 	return m_size == 0;
 }
 
+/**
+ * Reports the number of slots in the underlying array.
+ *
+ * This is always a power of two, and the map is rehashed before more than
+ * the maximum load factor of the slots are in use.
+ *
+ * @return	The number of slots in the underlying array
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::capacity() const {
+	return m_nodes.size();
+}
+/**
+ * Makes sure the map can hold a number of keys without rehashing.
+ *
+ * This is worth calling before adding a lot of keys at once, since the table
+ * is resized once rather than every time it fills up along the way.
+ *
+ * @param	size	The number of keys the map should be able to hold
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::reserve(size_type size) {
+	// Tombstones are cleared out by a rehash, but the array never shrinks here
+	if (size > m_loadThreshold - m_tombstones) {
+		m_rehash(size > m_loadThreshold ? size : m_loadThreshold);
+	}
+}
+/**
+ * Shrinks the underlying array to the smallest size that fits the contents.
+ *
+ * A map that grew during a burst of insertions keeps its large array after
+ * the keys are removed again. This gives that memory back, and clears out
+ * every tombstone while it's at it.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::shrink_to_fit() {
+	m_rehash(m_size);
+}
+/**
+ * Reports the fraction of the slots that can be in use before rehashing.
+ * @return	The maximum load factor
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+float HashMap<Key, Value, Probe, Hash, Allocator>::max_load_factor() const {
+	return m_maxLoadFactor;
+}
+/**
+ * Changes the fraction of the slots that can be in use before rehashing.
+ *
+ * Slots with tombstones count as in use. The default, HASHMAP_MAX_LOAD_FACTOR,
+ * suits PerturbProbe. SimdProbe finds keys in groups of sixteen slots, so it
+ * copes with fuller tables, and Swiss tables are usually run at 0.875.
+ *
+ * If the map is already over the new maximum, it is rehashed right away.
+ *
+ * @throws	InvalidLoadFactorError	when factor isn't between 0 and 1, since
+ * 	a probe only stops at a slot that has never been used
+ * @param	factor	The new maximum load factor
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::max_load_factor(float factor) {
+	if (!(factor > 0 && factor < 1)) {
+		throw InvalidLoadFactorError();
+	}
+	
+	m_maxLoadFactor = factor;
+	m_loadThreshold = m_nodes.size() * static_cast<double>(m_maxLoadFactor);
+	
+	if (m_size + m_tombstones > m_loadThreshold) {
+		m_rehash(m_size);
+	}
+}
+
+#if FUNDAMENTALS_HASH_STATS
+/**
+ * Reports statistics about how the keys are spread over the underlying array.
+ *
+ * The probe distance of every key is found by following its probe sequence
+ * from the start, so this takes time in proportion to the capacity, rather
+ * than being something to call on every lookup.
+ *
+ * The rehash counts are for this map object, so they aren't carried over to
+ * a copy of it or a map it is moved into.
+ *
+ * @return	The statistics for this map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+HashStats HashMap<Key, Value, Probe, Hash, Allocator>::stats() const {
+	HashStats stats = hashStatsStart(m_size, m_nodes.size(), m_tombstones, m_counters);
+	
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		if (!m_nodes[i].empty()) {
+			hashStatsAdd(stats, m_probe.probeLength(m_nodes.size(), i, m_nodes[i].hash()));
+		}
+	}
+	
+	hashStatsFinish(stats);
+	return stats;
+}
+#endif
+
 /**
  * Insert a key-value pair into the map.
  * @throws	DuplicateKeyError	When the key provided is already in the map
  * @param	key	The key to insert a value for
  * @param	value	The value that correspond to the key
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::insert(const Key& key, const Value& value) {
-	if (m_size >= m_loadThreshold) {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::insert(const Key& key, const Value& value) {
+	if (m_crowded()) {
 		m_rehash();
 	}
 	
-	size_type index = m_findIndex(key);
+	m_insert(key, value, m_hash(key));
+}
+/**
+ * Inserts every key-value pair in a range into the map.
+ *
+ * When the iterators are at least forward iterators, the range is counted
+ * first and the underlying array is grown once to fit all of it, rather than
+ * doubling several times along the way.
+ *
+ * If the range holds a key that is already in the map, or holds the same key
+ * twice, the pairs before it are still added.
+ *
+ * @throws	DuplicateKeyError	When a key in the range is already in the map
+ * @param	first	The start of the range, of pairs with the key as their
+ * 	first member and the value as their second
+ * @param	last	The end of the range
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename InputIt>
+void HashMap<Key, Value, Probe, Hash, Allocator>::insert_range(InputIt first, InputIt last) {
+	m_insertRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+/**
+ * Inserts every key-value pair in a range into the map, hashing the keys on
+ * several threads.
+ *
+ * Once the array has been grown to fit the whole range, the keys are hashed
+ * and sorted by the region of the array they start probing in, on several
+ * threads, and then added one region at a time (see HashBuild.hpp). For big
+ * ranges of keys that are slow to hash, such as long strings, this is much
+ * faster than adding them in the order they come in. The keys within each
+ * region are still added in the order of the range.
+ *
+ * As with the other version, the pairs added before a duplicate key stay in
+ * the map, though which ones they are depends on the hashes of the keys.
+ *
+ * @throws	DuplicateKeyError	When a key in the range is already in the map
+ * @param	first	The start of the range, of pairs with the key as their
+ * 	first member and the value as their second
+ * @param	last	The end of the range
+ * @param	threads	The number of threads to hash the keys on, or 0 for one
+ * 	per hardware thread
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename RandomIt>
+void HashMap<Key, Value, Probe, Hash, Allocator>::insert_range(RandomIt first, RandomIt last, size_type threads) {
+	size_type count = last - first;
+	reserve(m_size + count);
 	
-	if (!m_nodes[index].empty()) {
-		throw DuplicateKeyError();
-	}
+	std::vector<size_type> hashes;
+	std::vector<size_type> order;
+	hashPartition(first, count, m_nodes.size(), threads, [this](const auto& entry) { return m_hash(entry.first); }, hashes, order);
 	
-	m_nodes[index].set(key, value);
-	++m_size;
+	for (size_type i : order) {
+		m_insert(first[i].first, first[i].second, hashes[i]);
+	}
 }
 /**
  * Removes a key, and its associated value, from the map.
  * @throws	MissingKeyError	If the requested key is not in the map
  * @param	key	The key to remove
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::remove(const Key& key) {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::remove(const Key& key) {
 	size_type index = m_findIndex(key);
 	
 	if (m_nodes[index].empty()) {
 		throw MissingKeyError();
 	}
 	
-	m_nodes[index].clear();
+	m_nodes[index].clear(m_nodes.get_allocator());
+	m_probe.markCleared(index);
 	--m_size;
+	++m_tombstones;
 }
 /**
  * Sets the value corresponding to a key in this map.
@@ -348,21 +822,24 @@ void HashMap<Key, Value>::remove(const Key& key) {
  * @param	key	The key to insert a value for
  * @param	value	The value that correspond to the key
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::set(const Key& key, const Value& value) {
-	if (m_size >= m_loadThreshold) {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::set(const Key& key, const Value& value) {
+	if (m_crowded()) {
 		m_rehash();
 	}
 	
-	size_type index = m_findIndex(key);
+	size_type hashValue = m_hash(key);
+	size_type index = m_findIndex(key, hashValue);
 	
 	if (m_nodes[index].empty()) {
-		m_nodes[index].set(key, value);
+		if (!m_nodes[index].unused()) {
+			--m_tombstones;
+		}
 		++m_size;
 	}
-	else {
-		m_nodes[index].set(key, value);
-	}
+	
+	m_nodes[index].set(m_nodes.get_allocator(), key, value, hashValue);
+	m_probe.markFull(index, hashValue);
 }
 /**
  * Removes a key, and its associated value, from the map.
@@ -372,13 +849,15 @@ void HashMap<Key, Value>::set(const Key& key, const Value& value) {
  *
  * @param	key	The key to remove
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::unset(const Key& key) {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::unset(const Key& key) {
 	size_type index = m_findIndex(key);
 	
 	if (!m_nodes[index].empty()) {
-		m_nodes[index].clear();
+		m_nodes[index].clear(m_nodes.get_allocator());
+		m_probe.markCleared(index);
 		--m_size;
+		++m_tombstones;
 	}
 }
 
@@ -387,10 +866,9 @@ void HashMap<Key, Value>::unset(const Key& key) {
  * @param	key	The key to check for
  * @return	A boolean representing whether or not the key exists
  */
-template <typename Key, typename Value>
-bool HashMap<Key, Value>::hasKey(const Key& key) const {
-	size_type index = m_findIndex(key);
-	return !m_nodes[index].empty();
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::hasKey(const Key& key) const {
+	return hasKey<Key>(key);
 }
 
 /**
@@ -404,12 +882,24 @@ bool HashMap<Key, Value>::hasKey(const Key& key) const {
  * @param	key	The key to get the mapped value for
  * @return	A reference to the value key refers to
  */
-template <typename Key, typename Value>
-Value& HashMap<Key, Value>::operator[](const Key& key) {
-	size_type index = m_findIndex(key);
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+Value& HashMap<Key, Value, Probe, Hash, Allocator>::operator[](const Key& key) {
+	size_type hashValue = m_hash(key);
+	size_type index = m_findIndex(key, hashValue);
 	
 	if (m_nodes[index].empty()) {
-		m_nodes[index].set(key, Value());
+		if (m_crowded()) {
+			m_rehash();
+			index = m_findIndex(key, hashValue);
+		}
+		
+		if (!m_nodes[index].unused()) {
+			--m_tombstones;
+		}
+		
+		m_nodes[index].set(m_nodes.get_allocator(), key, Value(), hashValue);
+		m_probe.markFull(index, hashValue);
+		++m_size;
 	}
 	
 	return m_nodes[index].value();
@@ -426,8 +916,8 @@ Value& HashMap<Key, Value>::operator[](const Key& key) {
  * @param	key	The key to get the mapped value for
  * @return	A constant reference to the value key refers to
  */
-template <typename Key, typename Value>
-const Value& HashMap<Key, Value>::operator[](const Key& key) const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+const Value& HashMap<Key, Value, Probe, Hash, Allocator>::operator[](const Key& key) const {
 	size_type index = m_findIndex(key);
 	
 	if (m_nodes[index].empty()) {
@@ -446,15 +936,9 @@ const Value& HashMap<Key, Value>::operator[](const Key& key) const {
  * @param	key	The key to get the mapped value for
  * @return	A reference to the value key refers to
  */
-template <typename Key, typename Value>
-Value& HashMap<Key, Value>::getValue(const Key& key) {
-	size_type index = m_findIndex(key);
-	
-	if (m_nodes[index].empty()) {
-		throw MissingKeyError();
-	}
-	
-	return m_nodes[index].value();
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+Value& HashMap<Key, Value, Probe, Hash, Allocator>::getValue(const Key& key) {
+	return getValue<Key>(key);
 }
 /**
  * Gets a constant reference to the value stored at a given key.
@@ -467,8 +951,71 @@ Value& HashMap<Key, Value>::getValue(const Key& key) {
  * @param	key	The key to get the mapped value for
  * @return	A constant reference to the value key refers to
  */
-template <typename Key, typename Value>
-const Value& HashMap<Key, Value>::getValue(const Key& key) const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+const Value& HashMap<Key, Value, Probe, Hash, Allocator>::getValue(const Key& key) const {
+	return getValue<Key>(key);
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ *
+ * This is for lookups that are expected to miss some of the time, where
+ * hasKey followed by getValue would search for the key twice, and catching a
+ * MissingKeyError would be far slower than checking a pointer.
+ *
+ * The pointer is only valid until the map is next changed.
+ *
+ * @param	key	The key to get the mapped value for
+ * @return	A pointer to the value key refers to, or nullptr if it's missing
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+Value* HashMap<Key, Value, Probe, Hash, Allocator>::find(const Key& key) {
+	return find<Key>(key);
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ * @param	key	The key to get the mapped value for
+ * @return	A constant pointer to the value key refers to, or nullptr if it's
+ * 	missing
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+const Value* HashMap<Key, Value, Probe, Hash, Allocator>::find(const Key& key) const {
+	return find<Key>(key);
+}
+/**
+ * Copies out the value stored at a key, if the key is in the map.
+ * @param	key	The key to get the mapped value for
+ * @param	value	Set to a copy of the mapped value when the key is found,
+ * 	and left alone otherwise
+ * @return	Whether the key was found
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::try_get(const Key& key, Value& value) const {
+	return try_get<Key>(key, value);
+}
+/**
+ * Checks if a key is in the map, by a value of another type.
+ *
+ * This is for hash functions that are transparent (see Hashing.hpp). The
+ * value is hashed as it is, and compared with == against the stored keys.
+ *
+ * @param	key	A value equal to the key to check for
+ * @return	Whether or not the key exists
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::hasKey(const K& key) const {
+	size_type index = m_findIndex(key);
+	return !m_nodes[index].empty();
+}
+/**
+ * Gets a reference to the value stored at a key, by a value of another type.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+Value& HashMap<Key, Value, Probe, Hash, Allocator>::getValue(const K& key) {
 	size_type index = m_findIndex(key);
 	
 	if (m_nodes[index].empty()) {
@@ -477,6 +1024,119 @@ const Value& HashMap<Key, Value>::getValue(const Key& key) const {
 	
 	return m_nodes[index].value();
 }
+/**
+ * Gets a constant reference to the value stored at a key, by a value of
+ * another type.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+const Value& HashMap<Key, Value, Probe, Hash, Allocator>::getValue(const K& key) const {
+	size_type index = m_findIndex(key);
+	
+	if (m_nodes[index].empty()) {
+		throw MissingKeyError();
+	}
+	
+	return m_nodes[index].value();
+}
+/**
+ * Looks up the value stored at a key that might be missing, by a value of
+ * another type.
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A pointer to the value key refers to, or nullptr if it's missing
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+Value* HashMap<Key, Value, Probe, Hash, Allocator>::find(const K& key) {
+	size_type index = m_findIndex(key);
+	return m_nodes[index].empty() ? nullptr : &m_nodes[index].value();
+}
+/**
+ * Looks up the value stored at a key that might be missing, by a value of
+ * another type.
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A constant pointer to the value key refers to, or nullptr if it's
+ * 	missing
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+const Value* HashMap<Key, Value, Probe, Hash, Allocator>::find(const K& key) const {
+	size_type index = m_findIndex(key);
+	return m_nodes[index].empty() ? nullptr : &m_nodes[index].value();
+}
+/**
+ * Copies out the value stored at a key, by a value of another type.
+ * @param	key	A value equal to the key to get the mapped value for
+ * @param	value	Set to a copy of the mapped value when the key is found,
+ * 	and left alone otherwise
+ * @return	Whether the key was found
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::try_get(const K& key, Value& value) const {
+	const Value* found = find<K>(key);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	value = *found;
+	return true;
+}
+/**
+ * Looks up the values stored at a number of keys, any of which might be
+ * missing.
+ *
+ * The keys are looked up a batch at a time. All the keys in a batch are
+ * hashed and their slots prefetched, and only then are their slots searched.
+ *
+ * @param	keys	The keys to look up, which can be of another type when the
+ * 	hash function is transparent
+ * @param	count	The number of keys
+ * @param	results	Where to write a pointer to each key's value, or nullptr
+ * 	for each missing key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+void HashMap<Key, Value, Probe, Hash, Allocator>::find_many(const K* keys, size_type count, Value** results) {
+	size_type indices[HASHMAP_BATCH_SIZE];
+	
+	for (size_type start = 0; start < count; start += HASHMAP_BATCH_SIZE) {
+		size_type batch = std::min<size_type>(HASHMAP_BATCH_SIZE, count - start);
+		m_findBatch(keys + start, batch, indices);
+		
+		for (size_type i = 0; i < batch; ++i) {
+			Node& node = m_nodes[indices[i]];
+			results[start + i] = node.empty() ? nullptr : &node.value();
+		}
+	}
+}
+/**
+ * Looks up the values stored at a number of keys, any of which might be
+ * missing.
+ * @param	keys	The keys to look up, which can be of another type when the
+ * 	hash function is transparent
+ * @param	count	The number of keys
+ * @param	results	Where to write a constant pointer to each key's value, or
+ * 	nullptr for each missing key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K, typename>
+void HashMap<Key, Value, Probe, Hash, Allocator>::find_many(const K* keys, size_type count, const Value** results) const {
+	size_type indices[HASHMAP_BATCH_SIZE];
+	
+	for (size_type start = 0; start < count; start += HASHMAP_BATCH_SIZE) {
+		size_type batch = std::min<size_type>(HASHMAP_BATCH_SIZE, count - start);
+		m_findBatch(keys + start, batch, indices);
+		
+		for (size_type i = 0; i < batch; ++i) {
+			const Node& node = m_nodes[indices[i]];
+			results[start + i] = node.empty() ? nullptr : &node.value();
+		}
+	}
+}
 
 /**
  * Gets all a sequence of all the keys in this map.
@@ -486,8 +1146,8 @@ const Value& HashMap<Key, Value>::getValue(const Key& key) const {
  *
  * @return	A vector containing all keys in this map
  */
-template <typename Key, typename Value>
-std::vector<Key> HashMap<Key, Value>::keys() const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+std::vector<Key> HashMap<Key, Value, Probe, Hash, Allocator>::keys() const {
 	std::vector<Key> keys(0);
 	keys.reserve(m_size);
 	
@@ -511,8 +1171,8 @@ std::vector<Key> HashMap<Key, Value>::keys() const {
  *
  * @return	A vector containing all values in this map
  */
-template <typename Key, typename Value>
-std::vector<Value> HashMap<Key, Value>::values() const {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+std::vector<Value> HashMap<Key, Value, Probe, Hash, Allocator>::values() const {
 	std::vector<Value> values(0);
 	values.reserve(m_size);
 	
@@ -525,49 +1185,287 @@ std::vector<Value> HashMap<Key, Value>::values() const {
 	return values;
 }
 
+/**
+ * Saves the map to a file, for MappedHashMap to read.
+ *
+ * Every node of the underlying array is written as it is in memory, along
+ * with whether it is empty, full or a tombstone, so the saved table can be
+ * searched with exactly the same probe sequences as this one. Bytes that
+ * aren't part of a key, value or hash are written as zeroes, so saving the
+ * same map twice writes the same file.
+ *
+ * Only maps using PerturbProbe can be saved. Other probing policies can keep
+ * state outside of the nodes, which the file would have no room for.
+ *
+ * @throws	FileError	when the file can't be written
+ * @param	path	The path to save the file at, replacing any file there
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::save(const std::string& path) const {
+	static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value, "Only maps of trivially copyable keys and values can be saved");
+	static_assert(std::is_same<Probe, PerturbProbe>::value, "Only maps using PerturbProbe can be saved");
+	
+	MappedFile_Writer writer(path, mappedFileHeader(MAPPEDFILE_KIND_HASHMAP, sizeof(Node), sizeof(Key), sizeof(Value), m_nodes.size(), m_size, m_hash(Key())));
+	
+	unsigned char image[sizeof(Node)];
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		m_nodes[i].writeImage(image);
+		writer.write(image, sizeof(image));
+	}
+	
+	writer.commit();
+}
+
+/**
+ * Reports whether the underlying array is too crowded to add another key.
+ *
+ * Slots whose keys were removed count towards this, since probing still has
+ * to step past them. If they didn't count, a map with a lot of removals could
+ * end up with no slots that have never been used, and then a search for a key
+ * that isn't in the map would never stop.
+ *
+ * @return	Whether the map needs to be rehashed before adding a key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+bool HashMap<Key, Value, Probe, Hash, Allocator>::m_crowded() const {
+	return m_size + m_tombstones >= m_loadThreshold;
+}
+/**
+ * Decides how many keys the array should hold after rehashing a crowded map.
+ *
+ * If at least half of the used slots are tombstones, getting rid of them
+ * frees up enough room, so the array stays the same size. Otherwise the map
+ * is genuinely full, and the array grows.
+ *
+ * @return	The number of keys for the new array to be able to hold
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::m_rehashSize() const {
+	if (m_tombstones >= m_size) {
+		return m_loadThreshold;
+	}
+	return HASHMAP_GROWTH_FACTOR * m_size;
+}
 /**
  * Resizes the underlying array and moves all elements to their new positions.
  *
- * The method for doing this is close to a copy-and-swap technique.
- * The HashMap that we swap with is functionally identical to the one we copy
+ * The method for doing this is close to a move-and-swap technique.
+ * The HashMap that we swap with is functionally identical to the one we move
  * from, but the underlying vector will be larger.
+ *
+ * Since every key in this map is already unique, the nodes are moved over
+ * without going through insert and its duplicate check, and each node's
+ * stored hash is used rather than hashing the key again.
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::m_rehash() {
-	HashMap<Key, Value> other(m_hash, HASHMAP_GROWTH_FACTOR * m_size);
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_rehash() {
+	m_rehash(m_rehashSize());
+}
+/**
+ * Rehashes into an underlying array that can hold a number of keys.
+ *
+ * This is the same as the version above, except that the caller picks the
+ * size. It can be smaller than the current array, as long as there is room
+ * for every key.
+ *
+ * @param	size	The number of keys the new array should be able to hold
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_rehash(size_type size) {
+#if FUNDAMENTALS_HASH_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+	HashMap<Key, Value, Probe, Hash, Allocator> other(this->hashFunction(), size, m_maxLoadFactor, get_allocator());
 	
 	for (size_type i = 0; i < m_nodes.size(); i++) {
 		if (!m_nodes[i].empty()) {
-			other.insert(m_nodes[i].key(), m_nodes[i].value());
+			other.m_moveIn(m_nodes[i]);
 		}
 	}
 	
 	m_swap(other);
+#if FUNDAMENTALS_HASH_STATS
+	++m_counters.rehashCount;
+	m_counters.rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+#endif
+}
+/**
+ * Moves the contents of a node from another table into this map.
+ *
+ * The key on the node must not already be in this map, and this map must
+ * have room for it without needing to be rehashed.
+ *
+ * The node is left full, holding whatever its key and value were left as,
+ * for its own table to destroy. When moving them might throw they are copied
+ * instead (see HashMap_Node::moveFrom), so if a rehash fails part of the way
+ * through, the table being rehashed still has every key and value intact.
+ *
+ * @param	node	The node to move from
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_moveIn(Node& node) {
+	size_type hashValue = node.hash();
+	size_type index = m_findFreeIndex(hashValue);
+	
+	bool tombstone = !m_nodes[index].unused();
+	
+	m_nodes[index].moveFrom(m_nodes.get_allocator(), node);
+	if (tombstone) {
+		--m_tombstones;
+	}
+	m_probe.markFull(index, hashValue);
+	++m_size;
+}
+/**
+ * Moves the contents of a node from another table into this map, then clears
+ * the node, leaving a tombstone.
+ *
+ * Each node is moved or not as a whole, so if this throws the node is still
+ * intact in its own table.
+ *
+ * @param	node	The node to move from, which will be left empty
+ * @param	from	The allocator of the table the node is in
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_moveIn(Node& node, const NodeAllocator& from) {
+	m_moveIn(node);
+	node.clear(from);
+}
+/**
+ * Destroys the key and value of every full node in the underlying array.
+ *
+ * The nodes are left as tombstones, but the counts aren't updated, so this
+ * is only for when the array is about to be freed.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_clearNodes() {
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		m_nodes[i].clear(m_nodes.get_allocator());
+	}
 }
 
 /**
  * Swaps the contents of this HashMap with that of another.
+ *
+ * The node arrays are swapped with std::vector's swap, which also swaps their
+ * allocators if propagate_on_container_swap says so. Otherwise the
+ * allocators must compare equal.
+ *
  * @param	other	Another HashMap to swap contents with
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::m_swap(HashMap<Key, Value>& other) {
-	std::swap(m_hash, other.m_hash);
-	std::swap(m_nodes, other.m_nodes);
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_swap(HashMap<Key, Value, Probe, Hash, Allocator>& other) {
+	std::swap(this->hashFunction(), other.hashFunction());
+	m_nodes.swap(other.m_nodes);
 	std::swap(m_size, other.m_size);
+	std::swap(m_tombstones, other.m_tombstones);
 	std::swap(m_loadThreshold, other.m_loadThreshold);
+	std::swap(m_maxLoadFactor, other.m_maxLoadFactor);
+	m_probe.swap(other.m_probe);
 }
 /**
  * Adds the contents of another HashMap into this map.
  * @param	other	The map to add the contents from
  */
-template <typename Key, typename Value>
-void HashMap<Key, Value>::m_update(const HashMap<Key, Value>& other) {
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_update(const HashMap<Key, Value, Probe, Hash, Allocator>& other) {
 	for (size_type i = 0; i < other.m_nodes.size(); i++) {
 		if (!other.m_nodes[i].empty()) {
 			insert(other.m_nodes[i].key(), other.m_nodes[i].value());
 		}
 	}
 }
+/**
+ * Adds a key that isn't already in the map, without checking the load.
+ *
+ * The caller must already have made sure there is room for the key, which is
+ * what lets a whole range be added after sizing the array just once.
+ *
+ * @throws	DuplicateKeyError	When the key provided is already in the map
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ * @param	hashValue	The result of the hash function for key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_insert(const Key& key, const Value& value, size_type hashValue) {
+	size_type index = m_findIndex(key, hashValue);
+	
+	if (!m_nodes[index].empty()) {
+		throw DuplicateKeyError();
+	}
+	
+	if (!m_nodes[index].unused()) {
+		--m_tombstones;
+	}
+	
+	m_nodes[index].set(m_nodes.get_allocator(), key, value, hashValue);
+	m_probe.markFull(index, hashValue);
+	++m_size;
+}
+/**
+ * Adds a range of key-value pairs that can only be read through once.
+ *
+ * There's no way to know how long the range is without using it up, so the
+ * pairs are just inserted one at a time.
+ *
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename InputIt>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_insertRange(InputIt first, InputIt last, std::input_iterator_tag) {
+	for (; first != last; ++first) {
+		insert(first->first, first->second);
+	}
+}
+/**
+ * Adds a range of key-value pairs that can be counted before adding them.
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename ForwardIt>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_insertRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+	reserve(m_size + std::distance(first, last));
+	
+	for (; first != last; ++first) {
+		m_insert(first->first, first->second, m_hash(first->first));
+	}
+}
+
+/**
+ * Works out the size of the underlying array for holding a number of keys.
+ *
+ * The array is always a power of two, and is big enough that the keys don't
+ * put it over the maximum load factor.
+ *
+ * @param	size	The number of keys the array should be able to hold
+ * @param	maxLoadFactor	The maximum load factor of the map
+ * @return	The number of slots for the array
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::m_tableSize(size_type size, float maxLoadFactor) {
+	size = size / static_cast<double>(maxLoadFactor);
+	
+	if (size < HASHMAP_DEFAULT_CAPACITY) {
+		return HASHMAP_DEFAULT_CAPACITY;
+	}
+	return hashTableSize(size);
+}
+/**
+ * Applies this map's hash function to a key.
+ *
+ * The hash function is a class type, so this call can be inlined. The result
+ * is mixed if the hash function doesn't say it is already (see Hashing.hpp).
+ *
+ * @param	key	The key to hash
+ * @return	The result of the hash function for key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::m_hash(const K& key) const {
+	return hashKey(this->hashFunction(), key);
+}
 
 /**
  * Finds the index in the underlying array that the key maps to.
@@ -583,49 +1481,71 @@ void HashMap<Key, Value>::m_update(const HashMap<Key, Value>& other) {
  * correct slot is not as straightforward as it could be with a two-dimensional
  * separate-chaining approach.
  *
- * Here we use probe sequence that is essentially identical to that used for
- * Python's dictionaries and sets.
+ * The probe sequence itself is up to the Probe policy. The default policy
+ * uses a probe sequence that is essentially identical to that used for
+ * Python's dictionaries and sets, which is explained in PerturbProbe::find.
  *
- * A full explanation of why this works is best not written in the comments of
- * this code, but the sequence is essentially defined by:
- * 	`idx = (idx * m + 1)  % sz`
- * where `idx` is the idx variable and `sz` is the size of our hashtable.
- * A constant `m` is what we wil call our probe multiplier.
- * In this function we'll use 5 as `m`.
+ * @param	key	The key to find the slot for
+ * @return	The current best valid index for key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::m_findIndex(const K& key) const {
+	return m_findIndex(key, m_hash(key));
+}
+/**
+ * Finds the index in the underlying array that the key maps to.
  *
- * Note as the writer: While it might seem that you can use any value for `m`
- * that satisfied `m%2 == 1`, a small amount of testing will reveal that this
- * is not the case. The necessary condition really seems to be `m%4 == 1`.
- * Why exactly this is is unknown to me. In particular, I tried at one point to
- * use 7, which spectacularly fails at the minimum table size I chose of 8.
+ * This is the same as the single-argument version of this method, for callers
+ * that have already computed the hash of the key.
  *
  * @param	key	The key to find the slot for
+ * @param	hashValue	The result of the hash function for key
  * @return	The current best valid index for key
  */
-template <typename Key, typename Value>
-typename HashMap<Key, Value>::size_type HashMap<Key, Value>::m_findIndex(const Key& key) const {
-	size_type hashValue = m_hash(key);
-	size_type perturb = hashValue;
-	
-	size_type idx_current = hashValue % m_nodes.size();
-	
-	while (!m_nodes[idx_current].empty() && m_nodes[idx_current].key() != key) {
-		idx_current = (idx_current * 5 + 1 + perturb) % m_nodes.size();
-		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
-	}
-	
-	size_type idx_firstCandidate = idx_current;
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::m_findIndex(const K& key, size_type hashValue) const {
+	return m_probe.find(m_nodes.data(), m_nodes.size(), key, hashValue);
+}
+/**
+ * Finds the indices in the underlying array that a batch of keys map to.
+ *
+ * Every key is hashed and the probe policy is asked to prefetch its first
+ * slot before any slot is searched, so the memory for the later keys is
+ * already on its way while the earlier ones are compared.
+ *
+ * @param	keys	The keys to find the slots for
+ * @param	count	The number of keys, at most HASHMAP_BATCH_SIZE
+ * @param	indices	Where to write the current best valid index for each key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+template <typename K>
+void HashMap<Key, Value, Probe, Hash, Allocator>::m_findBatch(const K* keys, size_type count, size_type* indices) const {
+	size_type hashes[HASHMAP_BATCH_SIZE];
 	
-	while (!m_nodes[idx_current].unused() && !m_nodes[idx_current].keyEqual(key)) {
-		idx_current = (idx_current * 5 + 1 + perturb) % m_nodes.size();
-		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
+	for (size_type i = 0; i < count; ++i) {
+		hashes[i] = m_hash(keys[i]);
+		m_probe.prefetch(m_nodes.data(), m_nodes.size(), hashes[i]);
 	}
 	
-	if (!m_nodes[idx_current].unused()) {
-		return idx_current;
+	for (size_type i = 0; i < count; ++i) {
+		indices[i] = m_findIndex(keys[i], hashes[i]);
 	}
-	
-	return idx_firstCandidate;
+}
+/**
+ * Finds the first slot without a key on the probe sequence for a hash value.
+ *
+ * This follows the same probe sequence as m_findIndex, but it never compares
+ * keys. It is only valid to use the result for a key which is known not to be
+ * in the map already.
+ *
+ * @param	hashValue	The result of the hash function for the key
+ * @return	The index of the first empty slot for that hash value
+ */
+template <typename Key, typename Value, typename Probe, typename Hash, typename Allocator>
+typename HashMap<Key, Value, Probe, Hash, Allocator>::size_type HashMap<Key, Value, Probe, Hash, Allocator>::m_findFreeIndex(size_type hashValue) const {
+	return m_probe.findFree(m_nodes.data(), m_nodes.size(), hashValue);
 }
 
 // ---------------------//
@@ -638,49 +1558,95 @@ typename HashMap<Key, Value>::size_type HashMap<Key, Value>::m_findIndex(const K
  */
 template <typename Key, typename Value>
 HashMap_Node<Key, Value>::HashMap_Node()
-	: mp_key(nullptr), mp_value(nullptr), m_unused(true)
+	: m_state(STATE_EMPTY)
 {}
-	/**
-	 * Destructor for a HashMap node.
-	 *
-	 * Deallocates the key and value on this node, if they exist.
-	 */
-template <typename Key, typename Value>
-HashMap_Node<Key, Value>::~HashMap_Node() {
-	clear();
-}
 /**
  * Sets the key and value of a node.
  *
- * Additionally, sets the unused flag on the node to false. This is relevant
- * for the HashMap when looking for an index for a particular key.
+ * If the node is not full, the key and value are constructed in place in the
+ * node's storage. Otherwise the existing key and value are assigned to.
+ * Either way, the node is full afterwards. This is relevant for the HashMap
+ * when looking for an index for a particular key.
  *
+ * @param	allocator	The allocator to construct the key and value with
  * @param	k	The key that will be assigned to this node
  * @param	v	The value that will be assigned to this node
+ * @param	hash	The result of the map's hash function for k
  */
 template <typename Key, typename Value>
-void HashMap_Node<Key, Value>::set(const Key& k, const Value& v) {
-	if (mp_key == nullptr) {
-		mp_key = new Key(k);
-		mp_value = new Value(v);
+template <typename Allocator>
+void HashMap_Node<Key, Value>::set(Allocator allocator, const Key& k, const Value& v, size_t hash) {
+	if (m_state != STATE_FULL) {
+		std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Key*>(m_keyStorage), k);
+		try {
+			std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Value*>(m_valueStorage), v);
+		}
+		catch (...) {
+			std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Key*>(m_keyStorage));
+			throw;
+		}
+		m_state = STATE_FULL;
 	}
 	else {
-		*mp_key = k;
-		*mp_value = v;
+		*reinterpret_cast<Key*>(m_keyStorage) = k;
+		*reinterpret_cast<Value*>(m_valueStorage) = v;
 	}
 	
-	m_unused = false;
+	m_hashValue = hash;
+}
+/**
+ * Moves the key, value and hash of another node into this node.
+ *
+ * This node must be empty beforehand. The other node is left full, holding
+ * whatever its key and value were left as by the move, and has to be cleared
+ * separately.
+ *
+ * As in DynamicArray, the key and value are copied instead when moving them
+ * might throw. Then if constructing either throws, the other node is still
+ * intact and this one is left empty. That means copying both when either
+ * move might throw, since moving the key and then failing to copy the value
+ * would leave the other node with a moved-from key.
+ *
+ * @param	allocator	The allocator to construct the key and value with
+ * @param	other	The full node to take the contents of
+ */
+template <typename Key, typename Value>
+template <typename Allocator>
+void HashMap_Node<Key, Value>::moveFrom(Allocator allocator, HashMap_Node& other) {
+	constexpr bool move = (std::is_nothrow_move_constructible<Key>::value && std::is_nothrow_move_constructible<Value>::value)
+		|| !std::is_copy_constructible<Key>::value || !std::is_copy_constructible<Value>::value;
+	typedef typename std::conditional<move, Key&&, const Key&>::type KeySource;
+	typedef typename std::conditional<move, Value&&, const Value&>::type ValueSource;
+	
+	Key& otherKey = *reinterpret_cast<Key*>(other.m_keyStorage);
+	Value& otherValue = *reinterpret_cast<Value*>(other.m_valueStorage);
+	
+	std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Key*>(m_keyStorage), static_cast<KeySource>(otherKey));
+	try {
+		std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Value*>(m_valueStorage), static_cast<ValueSource>(otherValue));
+	}
+	catch (...) {
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Key*>(m_keyStorage));
+		throw;
+	}
+	m_hashValue = other.m_hashValue;
+	m_state = STATE_FULL;
 }
 /**
- * Removes the key and value of this node, leaving an empty node.
+ * Removes the key and value of this node, leaving a tombstone.
+ *
+ * The tombstone is what distinguishes a cleared node from one that has never
+ * been used, which matters to the probe sequence in HashMap::m_findIndex.
+ *
+ * @param	allocator	The allocator to destroy the key and value with
  */
 template <typename Key, typename Value>
-void HashMap_Node<Key, Value>::clear() {
-	if (mp_key != nullptr) {
-		delete mp_key;
-		delete mp_value;
-		mp_key = nullptr;
-		mp_value = nullptr;
+template <typename Allocator>
+void HashMap_Node<Key, Value>::clear(Allocator allocator) {
+	if (m_state == STATE_FULL) {
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Key*>(m_keyStorage));
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Value*>(m_valueStorage));
+		m_state = STATE_TOMBSTONE;
 	}
 }
 /**
@@ -689,70 +1655,110 @@ void HashMap_Node<Key, Value>::clear() {
  */
 template <typename Key, typename Value>
 bool HashMap_Node<Key, Value>::empty() const {
-	return mp_key == nullptr;
+	return m_state != STATE_FULL;
 }
 /**
  * Reports whether the node has ever had a key (and value) set.
- * @return The value of the unused flag on the node
+ * @return	true if the node has never been full, otherwise false
  */
 template <typename Key, typename Value>
 bool HashMap_Node<Key, Value>::unused() const {
-	return m_unused;
+	return m_state == STATE_EMPTY;
 }
 /**
  * Checks if the provided key is equal to this node's key (if any).
  *
  * This is false if this node has no key or if its key and the argument differ.
  *
+ * The stored hash is compared first. Keys with different hashes can't be
+ * equal, so most mismatches along a probe sequence are rejected without ever
+ * comparing the keys themselves.
+ *
  * @param	k	The key to check against
+ * @param	hash	The result of the map's hash function for k
  * @return	Whether or not this node refers to that key
  */
 template <typename Key, typename Value>
-bool HashMap_Node<Key, Value>::keyEqual(const Key& k) const {
-	if (mp_key == nullptr) {
+template <typename K>
+bool HashMap_Node<Key, Value>::keyEqual(const K& k, size_t hash) const {
+	if (m_state != STATE_FULL || m_hashValue != hash) {
 		return false;
 	}
 	
-	return k == *mp_key;
+	return k == key();
 }
 /**
  * Provides a constant reference to the key on this node.
  *
  * It's unsafe to use this method if this node is empty. That condition should
- * always be checked before use, as this method dereferences mp_key
- * whether or not it is a null pointer.
+ * always be checked before use, as this method reinterprets the key storage
+ * whether or not a key has been constructed there.
  *
  * @return	The key for this node
  */
 template <typename Key, typename Value>
 const Key& HashMap_Node<Key, Value>::key() const {
-	return *mp_key;
+	return *reinterpret_cast<const Key*>(m_keyStorage);
 }
 /**
  * Provides a constant reference to the value on this node.
  *
  * It's unsafe to use this method if this node is empty. That condition should
- * always be checked before use, as this method dereferences mp_value
- * whether or not it is a null pointer.
+ * always be checked before use, as this method reinterprets the value storage
+ * whether or not a value has been constructed there.
  *
  * @return	The value for this node
  */
 template <typename Key, typename Value>
 const Value& HashMap_Node<Key, Value>::value() const {
-	return *mp_value;
+	return *reinterpret_cast<const Value*>(m_valueStorage);
 }
 /**
  * Provides a reference to the value on this node.
  *
  * It's unsafe to use this method if this node is empty. That condition should
- * always be checked before use, as this method dereferences mp_value
- * whether or not it is a null pointer.
+ * always be checked before use, as this method reinterprets the value storage
+ * whether or not a value has been constructed there.
  *
  * @return	The value for this node
  */
 template <typename Key, typename Value>
 Value& HashMap_Node<Key, Value>::value() {
-	return *mp_value;
+	return *reinterpret_cast<Value*>(m_valueStorage);
+}
+/**
+ * Provides the stored hash of the key on this node.
+ *
+ * Like the other accessors, this is only meaningful when the node is full.
+ *
+ * @return	The result of the hash function for this node's key
+ */
+template <typename Key, typename Value>
+size_t HashMap_Node<Key, Value>::hash() const {
+	return m_hashValue;
+}
+/**
+ * Copies the bytes of this node, for a saved file.
+ *
+ * The copy has the same layout as the node, so it can be used as one once
+ * it is mapped back into memory. Everything that isn't set on this node is
+ * zeroed rather than copied, since it has never been written. This is only
+ * valid for keys and values that are trivially copyable.
+ *
+ * @param	to	Where to write the copy, with room for a whole node
+ */
+template <typename Key, typename Value>
+void HashMap_Node<Key, Value>::writeImage(unsigned char* to) const {
+	std::memset(to, 0, sizeof(HashMap_Node));
+	
+	if (m_state == STATE_FULL) {
+		std::memcpy(to + offsetof(HashMap_Node, m_keyStorage), m_keyStorage, sizeof(Key));
+		std::memcpy(to + offsetof(HashMap_Node, m_valueStorage), m_valueStorage, sizeof(Value));
+	}
+	if (m_state != STATE_EMPTY) {
+		std::memcpy(to + offsetof(HashMap_Node, m_hashValue), &m_hashValue, sizeof(m_hashValue));
+	}
+	to[offsetof(HashMap_Node, m_state)] = m_state;
 }
 
 #endif // Fundamentals_HashMap_hpp_
@@ -0,0 +1,534 @@
+/**
+ * Fundamentals :: Data Structures :: Hash Probes
+ * Author: Quinn Mortimer
+ *
+ * This file contains the probing policies that a HashMap can use to find the
+ * slot for a key in its underlying array.
+ *
+ * A probing policy is a class with the following members:
+ * - `resize(capacity)` is called whenever the map gets a new, empty array.
+ * - `swap(other)` is called whenever the map swaps contents with another.
+ * - `markFull(index, hash)` and `markCleared(index)` are called whenever a
+ *   slot has a key set on it or removed from it.
+ * - `find(nodes, capacity, key, hash)` gives the index of the slot that
+ *   either holds the key or is the best place to put it.
+ * - `findFree(nodes, capacity, hash)` gives the index of the first slot
+ *   without a key for a hash, for keys known not to be in the map.
+ * - `prefetch(nodes, capacity, hash)` starts loading the memory that find
+ *   will look at first for a hash, ahead of a batch of lookups.
+ * - `probeLength(capacity, index, hash)` gives how many steps along the probe
+ *   sequence for a hash the slot at an index is, for the stats in
+ *   HashStats.hpp.
+ *
+ * The capacity is always a power of two.
+ */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Hashing.hpp"
+
+#ifndef Fundamentals_HashProbes_hpp_
+#define Fundamentals_HashProbes_hpp_
+
+#define HASHMAP_COLLISION_SHIFT 4
+
+#define SIMDPROBE_GROUP_WIDTH 16
+#define SIMDPROBE_CTRL_EMPTY 0x80
+#define SIMDPROBE_CTRL_DELETED 0xFE
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMDPROBE_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SIMDPROBE_USE_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * The default probing policy for a HashMap.
+ *
+ * This probes a single slot at a time, and all the information it needs is
+ * already stored on the nodes, so it keeps no state of its own.
+ */
+class PerturbProbe {
+	public:
+		typedef size_t size_type;
+		
+		// Notifications from the map, none of which this policy needs.
+		void resize(size_type) {}
+		void swap(PerturbProbe&) {}
+		void markFull(size_type, size_type) {}
+		void markCleared(size_type) {}
+		
+		// Slot lookup
+		template <typename Node, typename K>
+		size_type find(const Node* nodes, size_type capacity, const K& key, size_type hashValue) const;
+		template <typename Node>
+		size_type findFree(const Node* nodes, size_type capacity, size_type hashValue) const;
+		template <typename Node>
+		void prefetch(const Node* nodes, size_type capacity, size_type hashValue) const;
+		
+		// Distance along the probe sequence
+		size_type probeLength(size_type capacity, size_type index, size_type hashValue) const;
+};
+
+/**
+ * A probing policy that checks a group of slots at a time.
+ *
+ * This is the approach taken by "Swiss tables". Alongside the nodes we keep
+ * an array with one control byte per slot. A control byte is either one of
+ * two special values for empty and deleted slots, or the low seven bits of
+ * the hash for a full slot. The probe loads sixteen control bytes at once and
+ * compares them all against the byte it is looking for in a single SIMD
+ * instruction (SSE2 or NEON, with a plain loop when neither is available).
+ *
+ * Only the slots whose control byte matches need their keys looked at, and a
+ * single empty byte in a group is enough to end the search.
+ */
+class SimdProbe {
+	public:
+		typedef size_t size_type;
+		
+		// Constructor
+		SimdProbe();
+		
+		// Notifications from the map, which keep the control bytes correct.
+		void resize(size_type capacity);
+		void swap(SimdProbe& other);
+		void markFull(size_type index, size_type hashValue);
+		void markCleared(size_type index);
+		
+		// Slot lookup
+		template <typename Node, typename K>
+		size_type find(const Node* nodes, size_type capacity, const K& key, size_type hashValue) const;
+		template <typename Node>
+		size_type findFree(const Node* nodes, size_type capacity, size_type hashValue) const;
+		template <typename Node>
+		void prefetch(const Node* nodes, size_type capacity, size_type hashValue) const;
+		
+		// Distance along the probe sequence
+		size_type probeLength(size_type capacity, size_type index, size_type hashValue) const;
+		
+	private:
+		// One control byte for each slot, followed by copies of the first
+		// SIMDPROBE_GROUP_WIDTH - 1 bytes, so that a whole group can be loaded
+		// starting at any slot without wrapping around.
+		std::vector<unsigned char> m_ctrl;
+		// The number of slots in the table this policy is for.
+		size_type m_capacity;
+		
+		// Sets the control byte for a slot, as well as any copies of it.
+		void m_setCtrl(size_type index, unsigned char value);
+		
+		// Group operations, giving a bitmask with one bit per slot in a group.
+		static unsigned m_matchByte(const unsigned char* group, unsigned char value);
+		static unsigned m_matchEmptyOrDeleted(const unsigned char* group);
+		static unsigned m_lowestBit(unsigned mask);
+};
+
+// --------------------- //
+// PerturbProbe Methods //
+// --------------------- //
+/**
+ * Finds the index in the array of nodes that the key maps to.
+ *
+ * The index refers to the position of the slot in the array that this method
+ * will tell whatever calls is where the provided key should be or should go.
+ * We will refer to that slot at this index as 'slot_k' from here forth.
+ *
+ * slot_k is guaranteed to either be empty or already contain the key.
+ *
+ * Here we use probe sequence that is essentially identical to that used for
+ * Python's dictionaries and sets.
+ *
+ * A full explanation of why this works is best not written in the comments of
+ * this code, but the sequence is essentially defined by:
+ * 	`idx = (idx * m + 1)  % sz`
+ * where `idx` is the idx variable and `sz` is the size of our hashtable.
+ * A constant `m` is what we wil call our probe multiplier.
+ * In this function we'll use 5 as `m`.
+ *
+ * The size of the table is always a power of two, so `% sz` is the same as
+ * keeping the low bits, and we write it as `& (sz - 1)` to avoid a division
+ * on every step.
+ *
+ * Note as the writer: While it might seem that you can use any value for `m`
+ * that satisfied `m%2 == 1`, a small amount of testing will reveal that this
+ * is not the case. The necessary condition really seems to be `m%4 == 1`.
+ * Why exactly this is is unknown to me. In particular, I tried at one point to
+ * use 7, which spectacularly fails at the minimum table size I chose of 8.
+ *
+ * @param	nodes	The array of nodes to search
+ * @param	capacity	The number of nodes in the array
+ * @param	key	The key to find the slot for
+ * @param	hashValue	The result of the hash function for key
+ * @return	The current best valid index for key
+ */
+template <typename Node, typename K>
+PerturbProbe::size_type PerturbProbe::find(const Node* nodes, size_type capacity, const K& key, size_type hashValue) const {
+	size_type perturb = hashValue;
+	
+	const size_type mask = capacity - 1;
+	
+	size_type idx_current = hashValue & mask;
+	
+	while (!nodes[idx_current].empty() && !nodes[idx_current].keyEqual(key, hashValue)) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
+	}
+	
+	size_type idx_firstCandidate = idx_current;
+	
+	while (!nodes[idx_current].unused() && !nodes[idx_current].keyEqual(key, hashValue)) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
+	}
+	
+	if (!nodes[idx_current].unused()) {
+		return idx_current;
+	}
+	
+	return idx_firstCandidate;
+}
+/**
+ * Finds the first slot without a key on the probe sequence for a hash value.
+ *
+ * This follows the same probe sequence as find, but it never compares keys.
+ * It is only valid to use the result for a key which is known not to be in
+ * the array already.
+ *
+ * @param	nodes	The array of nodes to search
+ * @param	capacity	The number of nodes in the array
+ * @param	hashValue	The result of the hash function for the key
+ * @return	The index of the first empty slot for that hash value
+ */
+template <typename Node>
+PerturbProbe::size_type PerturbProbe::findFree(const Node* nodes, size_type capacity, size_type hashValue) const {
+	size_type perturb = hashValue;
+	
+	const size_type mask = capacity - 1;
+	
+	size_type idx_current = hashValue & mask;
+	
+	while (!nodes[idx_current].empty()) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
+	}
+	
+	return idx_current;
+}
+/**
+ * Starts loading the first slot that find will look at for a hash value.
+ * @param	nodes	The array of nodes that will be searched
+ * @param	capacity	The number of nodes in the array
+ * @param	hashValue	The result of the hash function for a key
+ */
+template <typename Node>
+void PerturbProbe::prefetch(const Node* nodes, size_type capacity, size_type hashValue) const {
+	hashPrefetch(nodes + (hashValue & (capacity - 1)));
+}
+/**
+ * Counts the steps along the probe sequence for a hash value that it takes
+ * to reach a slot.
+ *
+ * The slot must be on the probe sequence, which it is for every slot that
+ * holds a key with this hash.
+ *
+ * @param	capacity	The number of nodes in the array
+ * @param	index	The index of the slot
+ * @param	hashValue	The result of the hash function for the slot's key
+ * @return	The number of slots probed before reaching the slot
+ */
+inline PerturbProbe::size_type PerturbProbe::probeLength(size_type capacity, size_type index, size_type hashValue) const {
+	size_type perturb = hashValue;
+	
+	const size_type mask = capacity - 1;
+	
+	size_type idx_current = hashValue & mask;
+	size_type length = 0;
+	
+	while (idx_current != index) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
+		++length;
+	}
+	
+	return length;
+}
+
+// ------------------ //
+// SimdProbe Methods //
+// ------------------ //
+/**
+ * Constructs a probing policy for a table with no slots.
+ *
+ * The map calls resize once it has created its underlying array.
+ */
+inline SimdProbe::SimdProbe()
+	: m_capacity(0)
+{}
+/**
+ * Resets the control bytes for a new, empty table.
+ * @param	capacity	The number of slots in the table
+ */
+inline void SimdProbe::resize(size_type capacity) {
+	m_ctrl.assign(capacity + SIMDPROBE_GROUP_WIDTH - 1, SIMDPROBE_CTRL_EMPTY);
+	m_capacity = capacity;
+}
+/**
+ * Swaps the control bytes of this policy with those of another.
+ * @param	other	The policy to swap with
+ */
+inline void SimdProbe::swap(SimdProbe& other) {
+	std::swap(m_ctrl, other.m_ctrl);
+	std::swap(m_capacity, other.m_capacity);
+}
+/**
+ * Records that a slot now holds a key with the given hash.
+ * @param	index	The index of the slot
+ * @param	hashValue	The result of the hash function for the slot's key
+ */
+inline void SimdProbe::markFull(size_type index, size_type hashValue) {
+	m_setCtrl(index, static_cast<unsigned char>(hashValue & 0x7F));
+}
+/**
+ * Records that the key in a slot has been removed.
+ *
+ * The slot becomes deleted rather than empty, so that searches for keys
+ * further along the probe sequence don't stop early at it.
+ *
+ * @param	index	The index of the slot
+ */
+inline void SimdProbe::markCleared(size_type index) {
+	m_setCtrl(index, SIMDPROBE_CTRL_DELETED);
+}
+
+/**
+ * Finds the index in the array of nodes that the key maps to.
+ *
+ * This gives the same result as PerturbProbe::find, which means the slot is
+ * guaranteed to either be empty or already contain the key.
+ *
+ * The upper bits of the hash choose which group to start at, and the low
+ * seven bits are the byte to look for. Groups are visited in a triangular
+ * sequence (offsets of 1, 2, 3... groups from the last), which reaches every
+ * group when the capacity is a power of two. Along the way we remember the
+ * first empty or deleted slot we pass, as that is where the key would go.
+ *
+ * @param	nodes	The array of nodes to search
+ * @param	capacity	The number of nodes in the array
+ * @param	key	The key to find the slot for
+ * @param	hashValue	The result of the hash function for key
+ * @return	The current best valid index for key
+ */
+template <typename Node, typename K>
+SimdProbe::size_type SimdProbe::find(const Node* nodes, size_type capacity, const K& key, size_type hashValue) const {
+	const size_type mask = capacity - 1;
+	const unsigned char fingerprint = static_cast<unsigned char>(hashValue & 0x7F);
+	
+	size_type groupCount = capacity / SIMDPROBE_GROUP_WIDTH;
+	if (groupCount == 0) {
+		groupCount = 1;
+	}
+	
+	size_type position = (hashValue >> 7) & mask;
+	size_type stride = 0;
+	size_type idx_firstCandidate = capacity;
+	
+	for (size_type i = 0; i < groupCount; ++i) {
+		const unsigned char* group = &m_ctrl[position];
+		
+		unsigned matches = m_matchByte(group, fingerprint);
+		while (matches != 0) {
+			size_type index = (position + m_lowestBit(matches)) & mask;
+			if (nodes[index].keyEqual(key, hashValue)) {
+				return index;
+			}
+			matches &= matches - 1;
+		}
+		
+		if (idx_firstCandidate == capacity) {
+			unsigned free = m_matchEmptyOrDeleted(group);
+			if (free != 0) {
+				idx_firstCandidate = (position + m_lowestBit(free)) & mask;
+			}
+		}
+		
+		if (m_matchByte(group, SIMDPROBE_CTRL_EMPTY) != 0) {
+			break;
+		}
+		
+		stride += SIMDPROBE_GROUP_WIDTH;
+		position = (position + stride) & mask;
+	}
+	
+	return idx_firstCandidate;
+}
+/**
+ * Finds the first slot without a key on the probe sequence for a hash value.
+ *
+ * This follows the same sequence of groups as find, but only ever looks at
+ * the control bytes.
+ *
+ * @param	nodes	The array of nodes to search (unused by this policy)
+ * @param	capacity	The number of nodes in the array
+ * @param	hashValue	The result of the hash function for the key
+ * @return	The index of the first empty or deleted slot for that hash value
+ */
+template <typename Node>
+SimdProbe::size_type SimdProbe::findFree(const Node*, size_type capacity, size_type hashValue) const {
+	const size_type mask = capacity - 1;
+	
+	size_type position = (hashValue >> 7) & mask;
+	size_type stride = 0;
+	
+	while (true) {
+		unsigned free = m_matchEmptyOrDeleted(&m_ctrl[position]);
+		if (free != 0) {
+			return (position + m_lowestBit(free)) & mask;
+		}
+		
+		stride += SIMDPROBE_GROUP_WIDTH;
+		position = (position + stride) & mask;
+	}
+}
+/**
+ * Starts loading the first group of control bytes that find will look at for
+ * a hash value, along with the slot at the start of that group.
+ * @param	nodes	The array of nodes that will be searched
+ * @param	capacity	The number of nodes in the array
+ * @param	hashValue	The result of the hash function for a key
+ */
+template <typename Node>
+void SimdProbe::prefetch(const Node* nodes, size_type capacity, size_type hashValue) const {
+	if (m_ctrl.empty()) {
+		return;
+	}
+	
+	size_type position = (hashValue >> 7) & (capacity - 1);
+	hashPrefetch(m_ctrl.data() + position);
+	hashPrefetch(nodes + position);
+}
+/**
+ * Counts the groups along the probe sequence for a hash value that come
+ * before the one a slot was found in.
+ *
+ * Groups overlap when they wrap around the table, so this is the first group
+ * in the sequence that covers the slot. A key is always put in the first
+ * group with room for it, so that is the group where it was placed.
+ *
+ * @param	capacity	The number of nodes in the array
+ * @param	index	The index of the slot
+ * @param	hashValue	The result of the hash function for the slot's key
+ * @return	The number of groups probed before reaching the slot's group
+ */
+inline SimdProbe::size_type SimdProbe::probeLength(size_type capacity, size_type index, size_type hashValue) const {
+	const size_type mask = capacity - 1;
+	
+	size_type position = (hashValue >> 7) & mask;
+	size_type stride = 0;
+	size_type length = 0;
+	
+	while (((index - position) & mask) >= SIMDPROBE_GROUP_WIDTH) {
+		stride += SIMDPROBE_GROUP_WIDTH;
+		position = (position + stride) & mask;
+		++length;
+	}
+	
+	return length;
+}
+
+/**
+ * Sets the control byte for a slot.
+ *
+ * Slots near the start of the table have copies of their control byte past
+ * the end of the table, and those are updated here too. For tables smaller
+ * than a group there can be more than one copy.
+ *
+ * @param	index	The index of the slot
+ * @param	value	The new control byte for the slot
+ */
+inline void SimdProbe::m_setCtrl(size_type index, unsigned char value) {
+	for (size_type i = index; i < m_ctrl.size(); i += m_capacity) {
+		m_ctrl[i] = value;
+	}
+}
+/**
+ * Compares every control byte in a group against a value.
+ * @param	group	A pointer to the first control byte of the group
+ * @param	value	The control byte to look for
+ * @return	A bitmask with bit i set when byte i of the group matches
+ */
+inline unsigned SimdProbe::m_matchByte(const unsigned char* group, unsigned char value) {
+#if defined(SIMDPROBE_USE_SSE2)
+	__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	__m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(value)));
+	return static_cast<unsigned>(_mm_movemask_epi8(match));
+#elif defined(SIMDPROBE_USE_NEON)
+	static const unsigned char bits[SIMDPROBE_GROUP_WIDTH] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+	};
+	uint8x16_t match = vceqq_u8(vld1q_u8(group), vdupq_n_u8(value));
+	uint8x16_t masked = vandq_u8(match, vld1q_u8(bits));
+	return vaddv_u8(vget_low_u8(masked)) | (vaddv_u8(vget_high_u8(masked)) << 8);
+#else
+	unsigned mask = 0;
+	for (unsigned i = 0; i < SIMDPROBE_GROUP_WIDTH; ++i) {
+		if (group[i] == value) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+#endif
+}
+/**
+ * Finds every control byte in a group for an empty or deleted slot.
+ *
+ * Both special control bytes have their high bit set, while no byte for a
+ * full slot does, so this is just a check of the high bit of each byte.
+ *
+ * @param	group	A pointer to the first control byte of the group
+ * @return	A bitmask with bit i set when slot i of the group has no key
+ */
+inline unsigned SimdProbe::m_matchEmptyOrDeleted(const unsigned char* group) {
+#if defined(SIMDPROBE_USE_SSE2)
+	__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	return static_cast<unsigned>(_mm_movemask_epi8(ctrl));
+#elif defined(SIMDPROBE_USE_NEON)
+	static const unsigned char bits[SIMDPROBE_GROUP_WIDTH] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+	};
+	uint8x16_t high = vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(group)));
+	uint8x16_t masked = vandq_u8(high, vld1q_u8(bits));
+	return vaddv_u8(vget_low_u8(masked)) | (vaddv_u8(vget_high_u8(masked)) << 8);
+#else
+	unsigned mask = 0;
+	for (unsigned i = 0; i < SIMDPROBE_GROUP_WIDTH; ++i) {
+		if (group[i] & 0x80) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+#endif
+}
+/**
+ * Finds the position of the lowest set bit in a non-zero bitmask.
+ * @param	mask	The bitmask to look at
+ * @return	The index of the lowest set bit
+ */
+inline unsigned SimdProbe::m_lowestBit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+	unsigned index = 0;
+	while ((mask & 1u) == 0) {
+		mask >>= 1;
+		++index;
+	}
+	return index;
+#endif
+}
+
+#endif // Fundamentals_HashProbes_hpp_
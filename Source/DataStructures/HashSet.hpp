@@ -11,96 +11,178 @@
 /**
  * In this data structure, memory management is not something we're trying to
  * demonstrate. As such, we'll allow the use of some of the standard library.
- * We will be using std::vector and std::swap in the code.
+ * We will be using std::vector, std::move and std::swap in the code.
+ */
+/**
+ * As with HashMap, elements can be looked up by any type the hash function
+ * is transparent for, and contains_many prefetches the slots for a batch of
+ * elements before searching any of them.
+ */
+/**
+ * Like HashMap, a set can be built from a whole range of elements at once,
+ * sizing the underlying array for all of them first when they can be
+ * counted, and insert_range can hash them on several threads.
+ */
+/**
+ * When FUNDAMENTALS_HASH_STATS is defined to 1, the set also counts its
+ * rehashes, and the stats method reports how well its elements are spread
+ * out (see HashStats.hpp).
  */
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <utility>
 #include <vector>
 
 #include "Exceptions.hpp"
+#include "HashBuild.hpp"
+#include "Hashing.hpp"
+#include "HashStats.hpp"
 
 #ifndef Fundamentals_HashSet_hpp_
 #define Fundamentals_HashSet_hpp_
 
+// Table sizes are always powers of two, so both of these must be as well
 #define HASHSET_DEFAULT_CAPACITY 8
 #define HASHSET_GROWTH_FACTOR 2
 #define HASHSET_MAX_LOAD_FACTOR 0.75
 #define HASHSET_COLLISION_SHIFT 4
+// The number of elements that contains_many hashes and prefetches at a time
+#define HASHSET_BATCH_SIZE 16
 
 /**
  * A Node class for the slots in our HashSet.
  *
- * Stores an element, as well as some flags for internal properties of
- * the node.
+ * Stores an element and its hash, as well as a flag for the state of the node.
+ *
+ * The element lives inside the node itself, in raw storage that is only
+ * constructed while the node is in use. This way the whole table is a single
+ * contiguous allocation, and looking at an element never chases a pointer.
  */
 template <typename T>
 class HashSet_Node {
 public:
 	// Constructor and destructor for a node.
+	// The set clears its nodes before destroying them, so the destructor
+	// doesn't destroy the element itself.
 	HashSet_Node();
-	~HashSet_Node();
+	~HashSet_Node() = default;
 	
-	// The default copy constructor can potentially copy a pointer to
-	// dynamically-allocated memory, and when the copy goes out of scope
-	// that memory is freed prematurely. Node copying is avoided easily enough
-	// and deleting the copy constructor will stop anyone mistakenly using it.
+	// The default copy constructor would copy the raw storage of the element
+	// without running its copy constructor. Node copying is avoided easily
+	// enough and deleting the copy constructor will stop anyone mistakenly
+	// using it.
 	HashSet_Node(const HashSet_Node<T>& other) = delete;
 	
 	// Set or clear the element on this node.
-	void set(const T& elem);
-	void clear();
+	// The allocator is the one for the table, and is only used to construct
+	// and destroy the element.
+	template <typename Allocator>
+	void set(Allocator allocator, const T& elem, size_t hash);
+	template <typename Allocator>
+	void moveFrom(Allocator allocator, HashSet_Node<T>& other);
+	template <typename Allocator>
+	void clear(Allocator allocator);
 	
 	// Informational queries on this node.
 	bool empty() const;
 	bool unused() const;
-	bool elemEqual(const T& elem) const;
+	template <typename K>
+	bool elemEqual(const K& elem, size_t hash) const;
 	
-	// Access to this node's data member.
+	// Access to this node's data members.
 	const T& elem() const;
+	size_t hash() const;
 private:
-	// The element in the node.
-	T* mp_elem;
-	// A flag indicating whether or not this node has ever been used.
-	bool m_unused;
+	// The states a node can be in.
+	// - STATE_EMPTY: No element has ever been set on this node.
+	// - STATE_TOMBSTONE: An element was set on this node, but has been cleared.
+	// - STATE_FULL: The node currently holds an element.
+	enum State : unsigned char {
+		STATE_EMPTY,
+		STATE_TOMBSTONE,
+		STATE_FULL
+	};
+	
+	// Storage for the element in the node.
+	// This is only constructed while the node is in the full state.
+	alignas(T) unsigned char m_elemStorage[sizeof(T)];
+	// The hash of the element, kept so the table can be resized without
+	// hashing every element again.
+	size_t m_hashValue;
+	// The current state of this node.
+	unsigned char m_state;
 };
 
 /**
  * A HashSet data structure.
+ *
+ * The Hash parameter is the class of the hash function for elements, which is
+ * described in Hashing.hpp.
+ *
+ * The Allocator parameter provides the memory for the underlying array, and
+ * is used to construct the elements in it (see Allocation.hpp). It is an
+ * allocator of elements, which is rebound to the node type.
  */
-template <typename T>
-class HashSet {
+template <typename T, typename Hash = DefaultHashFor<T>, typename Allocator = std::allocator<T>>
+class HashSet : private HashHolder<Hash> {
 	public:
 		typedef size_t size_type;
-		typedef size_type (*hash_type)(const T&);
+		typedef Hash hash_type;
+		typedef Allocator allocator_type;
 		
 		// Constructors
 		HashSet();
-		HashSet(const hash_type& hash);
-		HashSet(const hash_type& hash, size_type size);
-		HashSet(HashSet<T>&& other);
-		HashSet(const HashSet<T>& other);
+		explicit HashSet(const allocator_type& allocator);
+		HashSet(const hash_type& hash, const allocator_type& allocator = allocator_type());
+		HashSet(const hash_type& hash, size_type size, const allocator_type& allocator = allocator_type());
+		HashSet(HashSet<T, Hash, Allocator>&& other);
+		HashSet(const HashSet<T, Hash, Allocator>& other);
+		HashSet(const HashSet<T, Hash, Allocator>& other, const allocator_type& allocator);
+		template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+		HashSet(InputIt first, InputIt last, const hash_type& hash = hash_type(), const allocator_type& allocator = allocator_type());
+		HashSet(std::initializer_list<T> list, const hash_type& hash = hash_type(), const allocator_type& allocator = allocator_type());
 		
-		// Dynamic memory isn't directly allocated,
-		// so the default destructor is fine.
-		~HashSet() = default;
+		// Destructor
+		~HashSet();
 		
 		// Assignment
-		HashSet<T>& operator=(const HashSet<T>& other);
-		HashSet<T>& operator=(HashSet<T>&& other);
+		HashSet<T, Hash, Allocator>& operator=(const HashSet<T, Hash, Allocator>& other);
+		HashSet<T, Hash, Allocator>& operator=(HashSet<T, Hash, Allocator>&& other);
 		
 		// Equality Testing
-		bool operator==(const HashSet<T>& other) const;
-		bool operator!=(const HashSet<T>& other) const;
+		bool operator==(const HashSet<T, Hash, Allocator>& other) const;
+		bool operator!=(const HashSet<T, Hash, Allocator>& other) const;
+		
+		// Access to the allocator
+		allocator_type get_allocator() const;
 		
 		// Access to current size
 		size_type size() const;
 		bool empty() const;
 		
+		// Control over the size of the underlying array
+		size_type capacity() const;
+		void reserve(size_type size);
+		void shrink_to_fit();
+
+#if FUNDAMENTALS_HASH_STATS
+		// Statistics about the underlying array
+		HashStats stats() const;
+#endif
+
 		// Element insertion and deletion
 		// - Functions that can throw exceptions
 		void insert(const T& elem);
+		template <typename InputIt>
+		void insert_range(InputIt first, InputIt last);
+		template <typename RandomIt>
+		void insert_range(RandomIt first, RandomIt last, size_type threads);
 		void remove(const T& elem);
 		// - Function that will not throw exceptions
 		void add(const T& elem);
@@ -109,60 +191,121 @@ class HashSet {
 		// Data Access
 		// - Checks if an element is in the set
 		bool contains(const T& elem) const;
+		// - Looks up the stored copy of an element without exceptions
+		const T* find(const T& elem) const;
+		bool try_get(const T& elem, T& stored) const;
+		// - Looks up elements by other types, when the hash function allows it
+		template <typename K, typename = HashLookupEnable<Hash, T, K>>
+		bool contains(const K& elem) const;
+		template <typename K, typename = HashLookupEnable<Hash, T, K>>
+		const T* find(const K& elem) const;
+		template <typename K, typename = HashLookupEnable<Hash, T, K>>
+		bool try_get(const K& elem, T& stored) const;
+		// - Checks for many elements at once
+		template <typename K, typename = HashLookupEnable<Hash, T, K>>
+		void contains_many(const K* elems, size_type count, bool* results) const;
 		// - Gets all elements in the set.
 		std::vector<T> elements() const;
 		
 	private:
 		typedef HashSet_Node<T> Node;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
 		
-		// The hash function for finding slot indices.
-		hash_type m_hash;
 		// The number of used slots in the underlying array.
 		size_type m_size;
+		// The number of slots whose element has been removed. These still have to be
+		// probed past, so they count towards the load just like used slots.
+		size_type m_tombstones;
 		// The size at which we will consider our HashSet too crowded.
 		size_type m_loadThreshold;
 		// The underlying array of nodes for our HashSet.
-		std::vector<Node> m_nodes;
-		
+		std::vector<Node, NodeAllocator> m_nodes;
+#if FUNDAMENTALS_HASH_STATS
+		// The rehashes this set has done, for its stats.
+		HashStats_Counters m_counters;
+#endif
+
 		// These are utilites for internal use.
 		// - Used to resize and rehash when the load factor is too big.
+		bool m_crowded() const;
+		size_type m_rehashSize() const;
 		void m_rehash();
+		void m_rehash(size_type size);
+		// - Moves a node from another table into this one during a rehash.
+		void m_moveIn(Node& node);
+		// - Destroys the element of every node, through the allocator.
+		void m_clearNodes();
 		// - Swaps contents with another HashSet.
-		void m_swap(HashSet<T>& other);
+		void m_swap(HashSet<T, Hash, Allocator>& other);
 		// - Adds all elements in another HashSet to the current set.
-		void m_update(const HashSet<T>& other);
+		void m_update(const HashSet<T, Hash, Allocator>& other);
+		// - Adds an element that is known to fit without rehashing.
+		void m_insert(const T& elem, size_type hashValue);
+		// - Adds a range of elements, sizing the array first if they can be counted.
+		template <typename InputIt>
+		void m_insertRange(InputIt first, InputIt last, std::input_iterator_tag);
+		template <typename ForwardIt>
+		void m_insertRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+		
+		// The size of the underlying array for holding a number of elements.
+		static size_type m_tableSize(size_type size);
+		
+		// Applies the hash function to a element.
+		template <typename K>
+		size_type m_hash(const K& elem) const;
 		
 		// This is in some ways the real workhorse function for this class.
 		// It's how every other member function finds where elements should be.
-		size_type m_findIndex(const T& elem) const;
+		template <typename K>
+		size_type m_findIndex(const K& elem) const;
+		template <typename K>
+		size_type m_findIndex(const K& elem, size_type hashValue) const;
+		// Finds the slots for up to HASHSET_BATCH_SIZE elements at once.
+		template <typename K>
+		void m_findBatch(const K* elems, size_type count, size_type* indices) const;
+		// A lighter version of the above for elements known not to be in the set.
+		size_type m_findFreeIndex(size_type hashValue) const;
+		// How far along its probe sequence a slot is, for the stats.
+		size_type m_probeLength(size_type index, size_type hashValue) const;
 };
 
 // ----------------//
 // HashSet Methods //
 // ----------------//
 /**
- * Default HashSet constructor - Invalid
+ * Constructs a HashSet with a default-constructed hash function.
  *
- * A HashSet requires at least a hash function to be constructed.
+ * For the default Hash parameter this is the built-in hash for the element
+ * type. A HashFunction has no function pointer when default-constructed, so
+ * that case still requires a hash function to be provided.
  *
- * @throws	MissingHashFunctionError	always.
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
  */
-template <typename T>
-HashSet<T>::HashSet() {
-	throw MissingHashFunctionError();
-}
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet()
+	: HashSet(hash_type())
+{}
+/**
+ * Constructs a HashSet that gets its memory from an allocator.
+ *
+ * The hash function is default-constructed, as with the constructor above.
+ *
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ * @param	allocator	The allocator for this to use.
+ */
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(const allocator_type& allocator)
+	: HashSet(hash_type(), allocator)
+{}
 /**
  * Constucts a HashSet with a hash function for the element type.
  * @param	hash	The hash function for this to use.
+ * @param	allocator	The allocator for this to use.
  */
-template <typename T>
-HashSet<T>::HashSet(const hash_type& hash) {
-	m_hash = hash;
-	m_size = 0;
-	m_loadThreshold = HASHSET_DEFAULT_CAPACITY * HASHSET_MAX_LOAD_FACTOR;
-	
-	m_nodes = std::vector<Node>(HASHSET_DEFAULT_CAPACITY);
-}
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(const hash_type& hash, const allocator_type& allocator)
+	: HashSet(hash, 0, allocator)
+{}
 /**
  * Constructs a HashSet from a hash function and a minimum load.
  *
@@ -172,69 +315,161 @@ HashSet<T>::HashSet(const hash_type& hash) {
  *
  * @param	hash	The hash function for this to use.
  * @param	size	An amount of elements the table should be able to hold.
+ * @param	allocator	The allocator for this to use.
  */
-template <typename T>
-HashSet<T>::HashSet(const hash_type& hash, size_type size) {
-	m_hash = hash;
-	m_size = 0;
-	
-	size = size / HASHSET_MAX_LOAD_FACTOR;
-	size_type tableSize;
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(const hash_type& hash, size_type size, const allocator_type& allocator)
+	: HashHolder<Hash>(hash), m_nodes(m_tableSize(size), NodeAllocator(allocator))
+{
+	requireHashFunction(hash);
 	
-	if (size < HASHSET_DEFAULT_CAPACITY) {
-		tableSize = HASHSET_DEFAULT_CAPACITY;
-	}
-	else {
-		tableSize = 1;
-		while (size > tableSize) {
-			tableSize <<= 1;
-		}
-	}
-	
-	m_loadThreshold = tableSize * HASHSET_MAX_LOAD_FACTOR;
-	
-	m_nodes = std::vector<Node>(tableSize);
+	m_size = 0;
+	m_tombstones = 0;
+	m_loadThreshold = m_nodes.size() * HASHSET_MAX_LOAD_FACTOR;
 }
 /**
  * Constructs a HashSet by copying the contents of another.
+ *
+ * The allocator is copied the way std::allocator_traits says it should be
+ * for a container copy.
+ *
  * @param	other	The HashSet to copy.
  */
-template <typename T>
-HashSet<T>::HashSet(const HashSet<T>& other) {
-	m_hash = other.m_hash;
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(const HashSet<T, Hash, Allocator>& other)
+	: HashSet(other, allocator_type(std::allocator_traits<NodeAllocator>::select_on_container_copy_construction(other.m_nodes.get_allocator())))
+{}
+/**
+ * Constructs a HashSet by copying the contents of another, using a different
+ * allocator.
+ * @param	other	The HashSet to copy.
+ * @param	allocator	The allocator for the copy to use.
+ */
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(const HashSet<T, Hash, Allocator>& other, const allocator_type& allocator)
+	: HashHolder<Hash>(other.hashFunction()), m_nodes(other.m_nodes.size(), NodeAllocator(allocator))
+{
 	m_loadThreshold = other.m_loadThreshold;
-	m_nodes = std::vector<Node>(other.m_nodes.size());
 	m_size = 0;
-	m_update(other);
+	m_tombstones = 0;
+	
+	// The destructor won't run if this throws, so the nodes that were
+	// already copied have to be cleared here
+	try {
+		m_update(other);
+	}
+	catch (...) {
+		m_clearNodes();
+		throw;
+	}
 }
 /**
 * Constructs a HashSet by swapping in the contents of another.
+*
+* The allocator is copied from the other set, so the memory can be freed by
+* either of them. The other set is left with an empty table of the default
+* capacity rather than none at all, so it can still be used.
+*
 * @param	other	The set to swap contents with.
 */
-template <typename T>
-HashSet<T>::HashSet(HashSet<T>&& other) {
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(HashSet<T, Hash, Allocator>&& other)
+	: HashSet(other.hashFunction(), 0, allocator_type(other.m_nodes.get_allocator()))
+{
 	m_swap(other);
 }
+/**
+ * Constructs a HashSet holding the elements in a range.
+ *
+ * When the iterators are at least forward iterators, the underlying array is
+ * sized for the whole range before anything is added.
+ *
+ * @throws	DuplicateElementError	When the same element is in the range twice
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ * @param	hash	The hash function for this to use
+ * @param	allocator	The allocator for this to use
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename InputIt, typename>
+HashSet<T, Hash, Allocator>::HashSet(InputIt first, InputIt last, const hash_type& hash, const allocator_type& allocator)
+	: HashSet(hash, allocator)
+{
+	insert_range(first, last);
+}
+/**
+ * Constructs a HashSet holding the elements in an initializer list.
+ * @throws	DuplicateElementError	When the same element is in the list twice
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	list	The elements to add
+ * @param	hash	The hash function for this to use
+ * @param	allocator	The allocator for this to use
+ */
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::HashSet(std::initializer_list<T> list, const hash_type& hash, const allocator_type& allocator)
+	: HashSet(hash, list.size(), allocator)
+{
+	insert_range(list.begin(), list.end());
+}
+/**
+ * Destructor for a HashSet.
+ *
+ * The elements were constructed through the allocator, so they are destroyed
+ * through it too, before the underlying array is freed.
+ */
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>::~HashSet() {
+	m_clearNodes();
+}
 
 /**
  * Copy-assigns the contents of one HashSet to another.
+ *
+ * The copy is made with this set's allocator, so this set keeps its
+ * allocator and the swap is between sets that can free each other's memory.
+ *
  * @param	other	The set to copy from.
  * @return	The modified version of this, after copying.
  */
-template <typename T>
-HashSet<T>& HashSet<T>::operator=(const HashSet<T>& other) {
-	HashSet<T> tmp(other);
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>& HashSet<T, Hash, Allocator>::operator=(const HashSet<T, Hash, Allocator>& other) {
+	HashSet<T, Hash, Allocator> tmp(other, get_allocator());
 	m_swap(tmp);
 	return *this;
 }
 /**
  * Move-assigns the contents of one HashSet to another.
+ *
+ * If the allocator's propagate_on_container_move_assignment is true, this
+ * set frees its own nodes and takes the other set's allocator along with its
+ * table. Otherwise, if the allocators compare unequal, this set can't free
+ * the other set's memory, so the nodes are moved into a new table from this
+ * set's allocator instead of swapping.
+ *
  * @param	other	The set to swap contents with.
  * @return	The modified version of this, after the content swap.
  */
-template <typename T>
-HashSet<T>& HashSet<T>::operator=(HashSet<T>&& other) {
-	m_swap(other);
+template <typename T, typename Hash, typename Allocator>
+HashSet<T, Hash, Allocator>& HashSet<T, Hash, Allocator>::operator=(HashSet<T, Hash, Allocator>&& other) {
+	if (std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value) {
+		HashSet<T, Hash, Allocator> taken(std::move(other));
+		m_clearNodes();
+		m_nodes = std::vector<Node, NodeAllocator>(taken.m_nodes.get_allocator());
+		m_swap(taken);
+	}
+	else if (m_nodes.get_allocator() == other.m_nodes.get_allocator()) {
+		m_swap(other);
+	}
+	else {
+		HashSet<T, Hash, Allocator> tmp(other.hashFunction(), other.m_size, get_allocator());
+		for (size_type i = 0; i < other.m_nodes.size(); i++) {
+			if (!other.m_nodes[i].empty()) {
+				tmp.m_moveIn(other.m_nodes[i]);
+			}
+		}
+		m_swap(tmp);
+	}
 	return *this;
 }
 
@@ -249,8 +484,8 @@ HashSet<T>& HashSet<T>::operator=(HashSet<T>&& other) {
  * @param	other	The HashSet to compare against.
  * @return	Whether or not all elements of both sets are the same.
  */
-template <typename T>
-bool HashSet<T>::operator==(const HashSet<T>& other) const {
+template <typename T, typename Hash, typename Allocator>
+bool HashSet<T, Hash, Allocator>::operator==(const HashSet<T, Hash, Allocator>& other) const {
 	if (m_size != other.m_size) {
 		return false;
 	}
@@ -272,63 +507,180 @@ bool HashSet<T>::operator==(const HashSet<T>& other) const {
  * @param	other	The HashSet to compare against.
  * @return	false if both sets contain the same elements, else true.
  */
-template <typename T>
-bool HashSet<T>::operator!=(const HashSet<T>& other) const {
+template <typename T, typename Hash, typename Allocator>
+bool HashSet<T, Hash, Allocator>::operator!=(const HashSet<T, Hash, Allocator>& other) const {
 	return !(*this == other);
 }
- 
+
+/**
+ * Provides a copy of the allocator this set uses for its memory.
+ * @return	The allocator of the set.
+ */
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::allocator_type HashSet<T, Hash, Allocator>::get_allocator() const {
+	return allocator_type(m_nodes.get_allocator());
+}
 /**
  * Reports the number of slots currently in-use in the HashSet.
  * @return	The number of elements in the set.
  */
-template <typename T>
-typename HashSet<T>::size_type HashSet<T>::size() const {
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::size() const {
 	return m_size;
 }
 /**
  * Reports whether or not the HashSet is empty.
  * @return	Whether there are any used slots in the set.
  */
-template <typename T>
-bool HashSet<T>::empty() const {
+template <typename T, typename Hash, typename Allocator>
+bool HashSet<T, Hash, Allocator>::empty() const {
 	return m_size == 0;
 }
 
+/**
+ * Reports the number of slots in the underlying array.
+ *
+ * This is always a power of two, and the set is rehashed before more than
+ * HASHSET_MAX_LOAD_FACTOR of the slots are in use.
+ *
+ * @return	The number of slots in the underlying array.
+ */
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::capacity() const {
+	return m_nodes.size();
+}
+/**
+ * Makes sure the set can hold a number of elements without rehashing.
+ *
+ * This is worth calling before adding a lot of elements at once, since the
+ * table is resized once rather than every time it fills up along the way.
+ *
+ * @param	size	The number of elements the set should be able to hold.
+ */
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::reserve(size_type size) {
+	// Tombstones are cleared out by a rehash, but the array never shrinks here
+	if (size > m_loadThreshold - m_tombstones) {
+		m_rehash(size > m_loadThreshold ? size : m_loadThreshold);
+	}
+}
+/**
+ * Shrinks the underlying array to the smallest size that fits the contents.
+ *
+ * A set that grew during a burst of insertions keeps its large array after
+ * the elements are removed again. This gives that memory back, and clears
+ * out every tombstone while it's at it.
+ */
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::shrink_to_fit() {
+	m_rehash(m_size);
+}
+
+#if FUNDAMENTALS_HASH_STATS
+/**
+ * Reports statistics about how the elements are spread over the underlying
+ * array.
+ *
+ * The probe distance of every element is found by following its probe
+ * sequence from the start, so this takes time in proportion to the capacity,
+ * rather than being something to call on every lookup.
+ *
+ * The rehash counts are for this set object, so they aren't carried over to
+ * a copy of it or a set it is moved into.
+ *
+ * @return	The statistics for this set
+ */
+template <typename T, typename Hash, typename Allocator>
+HashStats HashSet<T, Hash, Allocator>::stats() const {
+	HashStats stats = hashStatsStart(m_size, m_nodes.size(), m_tombstones, m_counters);
+	
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		if (!m_nodes[i].empty()) {
+			hashStatsAdd(stats, m_probeLength(i, m_nodes[i].hash()));
+		}
+	}
+	
+	hashStatsFinish(stats);
+	return stats;
+}
+#endif
+
 /**
  * Adds an element to the set.
  * @throws	DuplicateElementError	When the input is already in the set.
  * @param	elem	The element to add.
  */
-template <typename T>
-void HashSet<T>::insert(const T& elem) {
-	if (m_size >= m_loadThreshold) {
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::insert(const T& elem) {
+	if (m_crowded()) {
 		m_rehash();
 	}
 	
-	size_type index = m_findIndex(elem);
+	m_insert(elem, m_hash(elem));
+}
+/**
+ * Inserts every element in a range into the set.
+ *
+ * When the iterators are at least forward iterators, the range is counted
+ * first and the underlying array is grown once to fit all of it, rather than
+ * doubling several times along the way.
+ *
+ * If the range holds an element that is already in the set, or holds the
+ * same element twice, the elements before it are still added.
+ *
+ * @throws	DuplicateElementError	When an element in the range is already in
+ * 	the set
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename InputIt>
+void HashSet<T, Hash, Allocator>::insert_range(InputIt first, InputIt last) {
+	m_insertRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+/**
+ * Inserts every element in a range into the set, hashing the elements on
+ * several threads.
+ *
+ * This works the same way as HashMap::insert_range with a thread count.
+ *
+ * @throws	DuplicateElementError	When an element in the range is already in
+ * 	the set
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ * @param	threads	The number of threads to hash the elements on, or 0 for one
+ * 	per hardware thread
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename RandomIt>
+void HashSet<T, Hash, Allocator>::insert_range(RandomIt first, RandomIt last, size_type threads) {
+	size_type count = last - first;
+	reserve(m_size + count);
 	
-	if (!m_nodes[index].empty()) {
-		throw DuplicateElementError();
-	}
+	std::vector<size_type> hashes;
+	std::vector<size_type> order;
+	hashPartition(first, count, m_nodes.size(), threads, [this](const T& elem) { return m_hash(elem); }, hashes, order);
 	
-	m_nodes[index].set(elem);
-	++m_size;
+	for (size_type i : order) {
+		m_insert(first[i], hashes[i]);
+	}
 }
 /**
  * Removes a element from the set.
  * @throws	MissingElementError	If the requested element is not in the set.
  * @param	elem	The element to remove.
  */
-template <typename T>
-void HashSet<T>::remove(const T& elem) {
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::remove(const T& elem) {
 	size_type index = m_findIndex(elem);
 	
 	if (m_nodes[index].empty()) {
 		throw MissingElementError();
 	}
 	
-	m_nodes[index].clear();
+	m_nodes[index].clear(m_nodes.get_allocator());
 	--m_size;
+	++m_tombstones;
 }
 /**
  * Ensures that an element is in the set.
@@ -338,16 +690,21 @@ void HashSet<T>::remove(const T& elem) {
  *
  * @param	elem	The element to add.
  */
-template <typename T>
-void HashSet<T>::add(const T& elem) {
-	if (m_size >= m_loadThreshold) {
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::add(const T& elem) {
+	if (m_crowded()) {
 		m_rehash();
 	}
 	
-	size_type index = m_findIndex(elem);
+	size_type hashValue = m_hash(elem);
+	size_type index = m_findIndex(elem, hashValue);
 	
 	if (m_nodes[index].empty()) {
-		m_nodes[index].set(elem);
+		if (!m_nodes[index].unused()) {
+			--m_tombstones;
+		}
+		
+		m_nodes[index].set(m_nodes.get_allocator(), elem, hashValue);
 		++m_size;
 	}
 }
@@ -359,13 +716,14 @@ void HashSet<T>::add(const T& elem) {
  *
  * @param	elem	The element to remove.
  */
-template <typename T>
-void HashSet<T>::discard(const T& elem) {
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::discard(const T& elem) {
 	size_type index = m_findIndex(elem);
 	
 	if (!m_nodes[index].empty()) {
-		m_nodes[index].clear();
+		m_nodes[index].clear(m_nodes.get_allocator());
 		--m_size;
+		++m_tombstones;
 	}
 }
 
@@ -374,11 +732,104 @@ void HashSet<T>::discard(const T& elem) {
  * @param	elem	The element to check for.
  * @return	A boolean representing whether or not the element exists.
  */
-template <typename T>
-bool HashSet<T>::contains(const T& elem) const {
+template <typename T, typename Hash, typename Allocator>
+bool HashSet<T, Hash, Allocator>::contains(const T& elem) const {
+	return contains<T>(elem);
+}
+/**
+ * Looks up the copy of an element that is stored in the set.
+ *
+ * Elements that compare equal aren't always identical, so this gives access
+ * to the one the set actually holds. The pointer is only valid until the set
+ * is next changed.
+ *
+ * @param	elem	The element to look for
+ * @return	A pointer to the stored element, or nullptr if it's missing
+ */
+template <typename T, typename Hash, typename Allocator>
+const T* HashSet<T, Hash, Allocator>::find(const T& elem) const {
+	return find<T>(elem);
+}
+/**
+ * Copies out the stored copy of an element, if it is in the set.
+ * @param	elem	The element to look for
+ * @param	stored	Set to a copy of the stored element when it is found, and
+ * 	left alone otherwise
+ * @return	Whether the element was found
+ */
+template <typename T, typename Hash, typename Allocator>
+bool HashSet<T, Hash, Allocator>::try_get(const T& elem, T& stored) const {
+	return try_get<T>(elem, stored);
+}
+/**
+ * Checks if an element is in the set, by a value of another type.
+ *
+ * This is for hash functions that are transparent (see Hashing.hpp). The
+ * value is hashed as it is, and compared with == against the stored elements.
+ *
+ * @param	elem	A value equal to the element to check for
+ * @return	Whether or not the element exists
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K, typename>
+bool HashSet<T, Hash, Allocator>::contains(const K& elem) const {
 	size_type index = m_findIndex(elem);
 	return !m_nodes[index].empty();
 }
+/**
+ * Looks up the stored copy of an element, by a value of another type.
+ * @param	elem	A value equal to the element to look for
+ * @return	A pointer to the stored element, or nullptr if it's missing
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K, typename>
+const T* HashSet<T, Hash, Allocator>::find(const K& elem) const {
+	size_type index = m_findIndex(elem);
+	return m_nodes[index].empty() ? nullptr : &m_nodes[index].elem();
+}
+/**
+ * Copies out the stored copy of an element, by a value of another type.
+ * @param	elem	A value equal to the element to look for
+ * @param	stored	Set to a copy of the stored element when it is found, and
+ * 	left alone otherwise
+ * @return	Whether the element was found
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K, typename>
+bool HashSet<T, Hash, Allocator>::try_get(const K& elem, T& stored) const {
+	const T* found = find<K>(elem);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	stored = *found;
+	return true;
+}
+/**
+ * Checks whether each of a number of elements is in the set.
+ *
+ * The elements are checked a batch at a time. All the elements in a batch
+ * are hashed and their slots prefetched, and only then are the slots searched.
+ *
+ * @param	elems	The elements to check for, which can be of another type
+ * 	when the hash function is transparent
+ * @param	count	The number of elements
+ * @param	results	Where to write whether each element is in the set
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K, typename>
+void HashSet<T, Hash, Allocator>::contains_many(const K* elems, size_type count, bool* results) const {
+	size_type indices[HASHSET_BATCH_SIZE];
+	
+	for (size_type start = 0; start < count; start += HASHSET_BATCH_SIZE) {
+		size_type batch = std::min<size_type>(HASHSET_BATCH_SIZE, count - start);
+		m_findBatch(elems + start, batch, indices);
+		
+		for (size_type i = 0; i < batch; ++i) {
+			results[start + i] = !m_nodes[indices[i]].empty();
+		}
+	}
+}
 
 /**
  * Gets all a sequence of all the elements in this set.
@@ -388,8 +839,8 @@ bool HashSet<T>::contains(const T& elem) const {
  *
  * @return	A vector containing all elements in this set
  */
-template <typename T>
-std::vector<T> HashSet<T>::elements() const {
+template <typename T, typename Hash, typename Allocator>
+std::vector<T> HashSet<T, Hash, Allocator>::elements() const {
 	std::vector<T> elements(0);
 	elements.reserve(m_size);
 	
@@ -402,49 +853,228 @@ std::vector<T> HashSet<T>::elements() const {
 	return elements;
 }
 
+/**
+ * Reports whether the underlying array is too crowded to add another element.
+ *
+ * Slots whose elements were removed count towards this, since probing still
+ * has to step past them. If they didn't count, a set with a lot of removals
+ * could end up with no slots that have never been used, and then a search for
+ * an element that isn't in the set would never stop.
+ *
+ * @return	Whether the set needs to be rehashed before adding an element.
+ */
+template <typename T, typename Hash, typename Allocator>
+bool HashSet<T, Hash, Allocator>::m_crowded() const {
+	return m_size + m_tombstones >= m_loadThreshold;
+}
+/**
+ * Decides how many elements the array should hold after rehashing.
+ *
+ * If at least half of the used slots are tombstones, getting rid of them
+ * frees up enough room, so the array stays the same size. Otherwise the set
+ * is genuinely full, and the array grows.
+ *
+ * @return	The number of elements for the new array to be able to hold.
+ */
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_rehashSize() const {
+	if (m_tombstones >= m_size) {
+		return m_loadThreshold;
+	}
+	return HASHSET_GROWTH_FACTOR * m_size;
+}
 /**
  * Resizes the underlying array and moves all elements to their new positions.
  *
- * The method for doing this is close to a copy-and-swap technique.
- * The HashSet that we swap with is functionally identical to the one we copy
+ * The method for doing this is close to a move-and-swap technique.
+ * The HashSet that we swap with is functionally identical to the one we move
  * from, but the underlying vector will be larger.
+ *
+ * Since every element in this set is already unique, the nodes are moved over
+ * without going through insert and its duplicate check, and each node's
+ * stored hash is used rather than hashing the element again.
  */
-template <typename T>
-void HashSet<T>::m_rehash() {
-	HashSet<T> other(m_hash, HASHSET_GROWTH_FACTOR * m_size);
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_rehash() {
+	m_rehash(m_rehashSize());
+}
+/**
+ * Rehashes into an underlying array that can hold a number of elements.
+ *
+ * This is the same as the version above, except that the caller picks the
+ * size. It can be smaller than the current array, as long as there is room
+ * for every element.
+ *
+ * @param	size	The number of elements the new array should be able to hold.
+ */
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_rehash(size_type size) {
+#if FUNDAMENTALS_HASH_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+	HashSet<T, Hash, Allocator> other(this->hashFunction(), size, get_allocator());
 	
 	for (size_type i = 0; i < m_nodes.size(); i++) {
 		if (!m_nodes[i].empty()) {
-			other.insert(m_nodes[i].elem());
+			other.m_moveIn(m_nodes[i]);
 		}
 	}
 	
 	m_swap(other);
+#if FUNDAMENTALS_HASH_STATS
+	++m_counters.rehashCount;
+	m_counters.rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+#endif
+}
+/**
+ * Moves the contents of a node from another table into this set.
+ *
+ * The element on the node must not already be in this set, and this set must
+ * have room for it without needing to be rehashed.
+ *
+ * The node is left full, holding whatever its element was left as, for its
+ * own table to destroy. When moving the element might throw it is copied
+ * instead (see HashSet_Node::moveFrom), so if a rehash fails part of the way
+ * through, the table being rehashed still has every element intact.
+ *
+ * @param	node	The node to move from
+ */
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_moveIn(Node& node) {
+	size_type index = m_findFreeIndex(node.hash());
+	bool tombstone = !m_nodes[index].unused();
+	
+	m_nodes[index].moveFrom(m_nodes.get_allocator(), node);
+	if (tombstone) {
+		--m_tombstones;
+	}
+	++m_size;
+}
+/**
+ * Destroys the element of every full node in the underlying array.
+ *
+ * The nodes are left as tombstones, but the counts aren't updated, so this
+ * is only for when the array is about to be freed.
+ */
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_clearNodes() {
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		m_nodes[i].clear(m_nodes.get_allocator());
+	}
 }
 
 /**
  * Swaps the contents of this HashSet with that of another.
+ *
+ * The node arrays are swapped with std::vector's swap, which also swaps their
+ * allocators if propagate_on_container_swap says so. Otherwise the
+ * allocators must compare equal.
+ *
  * @param	other	Another HashSet to swap contents with
  */
-template <typename T>
-void HashSet<T>::m_swap(HashSet<T>& other) {
-	std::swap(m_hash, other.m_hash);
-	std::swap(m_nodes, other.m_nodes);
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_swap(HashSet<T, Hash, Allocator>& other) {
+	std::swap(this->hashFunction(), other.hashFunction());
+	m_nodes.swap(other.m_nodes);
 	std::swap(m_size, other.m_size);
+	std::swap(m_tombstones, other.m_tombstones);
 	std::swap(m_loadThreshold, other.m_loadThreshold);
 }
 /**
  * Adds the contents of another HashSet into this set.
  * @param	other	The set to add the contents from.
  */
-template <typename T>
-void HashSet<T>::m_update(const HashSet<T>& other) {
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_update(const HashSet<T, Hash, Allocator>& other) {
 	for (size_type i = 0; i < other.m_nodes.size(); i++) {
 		if (!other.m_nodes[i].empty()) {
 			insert(other.m_nodes[i].elem());
 		}
 	}
 }
+/**
+ * Adds an element that isn't already in the set, without checking the load.
+ *
+ * The caller must already have made sure there is room for the element.
+ *
+ * @throws	DuplicateElementError	When the element is already in the set
+ * @param	elem	The element to insert
+ * @param	hashValue	The result of the hash function for elem
+ */
+template <typename T, typename Hash, typename Allocator>
+void HashSet<T, Hash, Allocator>::m_insert(const T& elem, size_type hashValue) {
+	size_type index = m_findIndex(elem, hashValue);
+	
+	if (!m_nodes[index].empty()) {
+		throw DuplicateElementError();
+	}
+	
+	if (!m_nodes[index].unused()) {
+		--m_tombstones;
+	}
+	
+	m_nodes[index].set(m_nodes.get_allocator(), elem, hashValue);
+	++m_size;
+}
+/**
+ * Adds a range of elements that can only be read through once.
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename InputIt>
+void HashSet<T, Hash, Allocator>::m_insertRange(InputIt first, InputIt last, std::input_iterator_tag) {
+	for (; first != last; ++first) {
+		insert(*first);
+	}
+}
+/**
+ * Adds a range of elements that can be counted before adding them.
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename ForwardIt>
+void HashSet<T, Hash, Allocator>::m_insertRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+	reserve(m_size + std::distance(first, last));
+	
+	for (; first != last; ++first) {
+		m_insert(*first, m_hash(*first));
+	}
+}
+
+/**
+ * Works out the size of the underlying array for holding a number of elements.
+ *
+ * The array is always a power of two, and is big enough that the elements
+ * don't put it over the maximum load factor.
+ *
+ * @param	size	The number of elements the array should be able to hold
+ * @return	The number of slots for the array
+ */
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_tableSize(size_type size) {
+	size = size / HASHSET_MAX_LOAD_FACTOR;
+	
+	if (size < HASHSET_DEFAULT_CAPACITY) {
+		return HASHSET_DEFAULT_CAPACITY;
+	}
+	return hashTableSize(size);
+}
+/**
+ * Applies this set's hash function to a element.
+ *
+ * The hash function is a class type, so this call can be inlined. The result
+ * is mixed if the hash function doesn't say it is already (see Hashing.hpp).
+ *
+ * @param	elem	The element to hash
+ * @return	The result of the hash function for elem
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_hash(const K& elem) const {
+	return hashKey(this->hashFunction(), elem);
+}
 
 /**
  * Finds the index in the underlying array for an element.
@@ -470,6 +1100,10 @@ void HashSet<T>::m_update(const HashSet<T>& other) {
  * A constant `m` is what we wil call our probe multiplier.
  * In this function we'll use 5 as `m`.
  *
+ * The size of the table is always a power of two, so `% sz` is the same as
+ * keeping the low bits, and we write it as `& (sz - 1)` to avoid a division
+ * on every step.
+ *
  * Note as the writer: While it might seem that you can use any value for `m`
  * that satisfied `m%2 == 1`, a small amount of testing will reveal that this
  * is not the case. The necessary condition really seems to be `m%4 == 1`.
@@ -479,22 +1113,39 @@ void HashSet<T>::m_update(const HashSet<T>& other) {
  * @param	elem	The element to find the slot for
  * @return	The current best valid index for the element
  */
-template <typename T>
-typename HashSet<T>::size_type HashSet<T>::m_findIndex(const T& elem) const {
-	size_type hashValue = m_hash(elem);
+template <typename T, typename Hash, typename Allocator>
+template <typename K>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_findIndex(const K& elem) const {
+	return m_findIndex(elem, m_hash(elem));
+}
+/**
+ * Finds the index in the underlying array for an element.
+ *
+ * This is the same as the single-argument version of this method, for callers
+ * that have already computed the hash of the element.
+ *
+ * @param	elem	The element to find the slot for
+ * @param	hashValue	The result of the hash function for elem
+ * @return	The current best valid index for the element
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_findIndex(const K& elem, size_type hashValue) const {
 	size_type perturb = hashValue;
 	
-	size_type idx_current = hashValue % m_nodes.size();
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type idx_current = hashValue & mask;
 	
-	while (!m_nodes[idx_current].empty() && m_nodes[idx_current].elem() != elem) {
-		idx_current = (idx_current * 5 + 1 + perturb) % m_nodes.size();
+	while (!m_nodes[idx_current].empty() && !m_nodes[idx_current].elemEqual(elem, hashValue)) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
 		perturb = perturb >> HASHSET_COLLISION_SHIFT;
 	}
 	
 	size_type idx_firstCandidate = idx_current;
 	
-	while (!m_nodes[idx_current].unused() && !m_nodes[idx_current].elemEqual(elem)) {
-		idx_current = (idx_current * 5 + 1 + perturb) % m_nodes.size();
+	while (!m_nodes[idx_current].unused() && !m_nodes[idx_current].elemEqual(elem, hashValue)) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
 		perturb = perturb >> HASHSET_COLLISION_SHIFT;
 	}
 	
@@ -504,6 +1155,85 @@ typename HashSet<T>::size_type HashSet<T>::m_findIndex(const T& elem) const {
 	
 	return idx_firstCandidate;
 }
+/**
+ * Finds the indices in the underlying array for a batch of elements.
+ *
+ * Every element is hashed and its first slot prefetched before any slot is
+ * searched, so the memory for the later elements is already on its way while
+ * the earlier ones are compared.
+ *
+ * @param	elems	The elements to find the slots for
+ * @param	count	The number of elements, at most HASHSET_BATCH_SIZE
+ * @param	indices	Where to write the current best valid index for each one
+ */
+template <typename T, typename Hash, typename Allocator>
+template <typename K>
+void HashSet<T, Hash, Allocator>::m_findBatch(const K* elems, size_type count, size_type* indices) const {
+	size_type hashes[HASHSET_BATCH_SIZE];
+	const size_type mask = m_nodes.size() - 1;
+	
+	for (size_type i = 0; i < count; ++i) {
+		hashes[i] = m_hash(elems[i]);
+		hashPrefetch(m_nodes.data() + (hashes[i] & mask));
+	}
+	
+	for (size_type i = 0; i < count; ++i) {
+		indices[i] = m_findIndex(elems[i], hashes[i]);
+	}
+}
+/**
+ * Finds the first slot without an element on the probe sequence for a hash.
+ *
+ * This follows the same probe sequence as m_findIndex, but it never compares
+ * elements. It is only valid to use the result for an element which is known
+ * not to be in the set already.
+ *
+ * @param	hashValue	The result of the hash function for the element
+ * @return	The index of the first empty slot for that hash value
+ */
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_findFreeIndex(size_type hashValue) const {
+	size_type perturb = hashValue;
+	
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type idx_current = hashValue & mask;
+	
+	while (!m_nodes[idx_current].empty()) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHSET_COLLISION_SHIFT;
+	}
+	
+	return idx_current;
+}
+/**
+ * Counts the steps along the probe sequence for a hash value that it takes
+ * to reach a slot.
+ *
+ * The slot must be on the probe sequence, which it is for every slot that
+ * holds an element with this hash.
+ *
+ * @param	index	The index of the slot
+ * @param	hashValue	The result of the hash function for the slot's element
+ * @return	The number of slots probed before reaching the slot
+ */
+template <typename T, typename Hash, typename Allocator>
+typename HashSet<T, Hash, Allocator>::size_type HashSet<T, Hash, Allocator>::m_probeLength(size_type index, size_type hashValue) const {
+	size_type perturb = hashValue;
+	
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type idx_current = hashValue & mask;
+	size_type length = 0;
+	
+	while (idx_current != index) {
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHSET_COLLISION_SHIFT;
+		++length;
+	}
+	
+	return length;
+}
 
 // ---------------------//
 // HashSet_Node Methods //
@@ -515,44 +1245,67 @@ typename HashSet<T>::size_type HashSet<T>::m_findIndex(const T& elem) const {
  */
 template <typename T>
 HashSet_Node<T>::HashSet_Node()
-	: mp_elem(nullptr), m_unused(true)
+	: m_state(STATE_EMPTY)
 {}
-	/**
-	 * Destructor for a HashSet node.
-	 *
-	 * Deallocates the element on this node, if it exists.
-	 */
-template <typename T>
-HashSet_Node<T>::~HashSet_Node() {
-	clear();
-}
 /**
  * Sets the element on a node.
  *
- * Additionally, sets the unused flag on the node to false. This is relevant
- * for the HashSet when looking for an index for a particular element.
+ * If the node is not full, the element is constructed in place in the node's
+ * storage. Otherwise the existing element is assigned to. Either way, the node
+ * is full afterwards. This is relevant for the HashSet when looking for an
+ * index for a particular element.
  *
+ * @param	allocator	The allocator to construct the element with
  * @param	elem	The element that will be assigned to this node
+ * @param	hash	The result of the set's hash function for elem
  */
 template <typename T>
-void HashSet_Node<T>::set(const T& elem) {
-	if (mp_elem == nullptr) {
-		mp_elem = new T(elem);
+template <typename Allocator>
+void HashSet_Node<T>::set(Allocator allocator, const T& elem, size_t hash) {
+	if (m_state != STATE_FULL) {
+		std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<T*>(m_elemStorage), elem);
+		m_state = STATE_FULL;
 	}
 	else {
-		*mp_elem = elem;
+		*reinterpret_cast<T*>(m_elemStorage) = elem;
 	}
 	
-	m_unused = false;
+	m_hashValue = hash;
 }
 /**
- * Removes the element on this node, leaving an empty node.
+ * Moves the element and hash of another node into this node.
+ *
+ * This node must be empty beforehand. The other node is left full, holding
+ * whatever its element was left as by the move, and has to be cleared
+ * separately.
+ *
+ * As in DynamicArray, an element whose move constructor might throw is
+ * copied instead, so if this throws the other node is still intact.
+ *
+ * @param	allocator	The allocator to construct the element with
+ * @param	other	The full node to take the contents of
  */
 template <typename T>
-void HashSet_Node<T>::clear() {
-	if (mp_elem != nullptr) {
-		delete mp_elem;
-		mp_elem = nullptr;
+template <typename Allocator>
+void HashSet_Node<T>::moveFrom(Allocator allocator, HashSet_Node<T>& other) {
+	std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<T*>(m_elemStorage), std::move_if_noexcept(*reinterpret_cast<T*>(other.m_elemStorage)));
+	m_hashValue = other.m_hashValue;
+	m_state = STATE_FULL;
+}
+/**
+ * Removes the element on this node, leaving a tombstone.
+ *
+ * The tombstone is what distinguishes a cleared node from one that has never
+ * been used, which matters to the probe sequence in HashSet::m_findIndex.
+ *
+ * @param	allocator	The allocator to destroy the element with
+ */
+template <typename T>
+template <typename Allocator>
+void HashSet_Node<T>::clear(Allocator allocator) {
+	if (m_state == STATE_FULL) {
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<T*>(m_elemStorage));
+		m_state = STATE_TOMBSTONE;
 	}
 }
 /**
@@ -561,15 +1314,15 @@ void HashSet_Node<T>::clear() {
  */
 template <typename T>
 bool HashSet_Node<T>::empty() const {
-	return mp_elem == nullptr;
+	return m_state != STATE_FULL;
 }
 /**
  * Reports whether the node has ever had an element.
- * @return The value of the unused flag on the node.
+ * @return	true if the node has never been full, otherwise false
  */
 template <typename T>
 bool HashSet_Node<T>::unused() const {
-	return m_unused;
+	return m_state == STATE_EMPTY;
 }
 /**
  * Checks if the provided element is equal to this node's element (if any).
@@ -577,29 +1330,46 @@ bool HashSet_Node<T>::unused() const {
  * This is false if this node is empty or if its element is not equal to the
  * argument.
  *
+ * The stored hash is compared first. Elements with different hashes can't be
+ * equal, so most mismatches along a probe sequence are rejected without ever
+ * comparing the elements themselves.
+ *
  * @param	elem	The element to check against
+ * @param	hash	The result of the set's hash function for elem
  * @return	Whether or not this node refers to that element
  */
 template <typename T>
-bool HashSet_Node<T>::elemEqual(const T& elem) const {
-	if (mp_elem == nullptr) {
+template <typename K>
+bool HashSet_Node<T>::elemEqual(const K& elem, size_t hash) const {
+	if (m_state != STATE_FULL || m_hashValue != hash) {
 		return false;
 	}
 	
-	return elem == *mp_elem;
+	return elem == this->elem();
 }
 /**
  * Provides a constant reference to the element on this node.
  *
  * It's unsafe to use this method if this node is empty. That condition should
- * always be checked before use, as this method dereferences mp_elem
- * whether or not it is a null pointer.
+ * always be checked before use, as this method reinterprets the element
+ * storage whether or not an element has been constructed there.
  *
  * @return	The element at this node
  */
 template <typename T>
 const T& HashSet_Node<T>::elem() const {
-	return *mp_elem;
+	return *reinterpret_cast<const T*>(m_elemStorage);
+}
+/**
+ * Provides the stored hash of the element on this node.
+ *
+ * Like the element accessor, this is only meaningful when the node is full.
+ *
+ * @return	The result of the hash function for this node's element
+ */
+template <typename T>
+size_t HashSet_Node<T>::hash() const {
+	return m_hashValue;
 }
 
 #endif // Fundamentals_HashSet_hpp_
@@ -0,0 +1,129 @@
+/**
+ * Fundamentals :: Data Structures :: Hash Stats
+ * Author: Quinn Mortimer
+ *
+ * This file contains the statistics that HashMap and HashSet can report about
+ * their tables, for working out why a map has become slow.
+ *
+ * A table can be slow for a few different reasons. The hash function might be
+ * putting lots of keys on the same probe sequence, removed keys might have
+ * left tombstones that every search has to step past, or the table might just
+ * be close to full. The stats tell these apart:
+ * - The probe distance of a key is how many steps along its probe sequence
+ *   it is stored from where the sequence starts. With a good hash function
+ *   most keys are at distance 0 or 1, and a long tail in the histogram of
+ *   distances means the hash function is clustering keys together.
+ * - The tombstone count is the number of slots whose keys were removed.
+ * - The load factor counts both full slots and tombstones, since that is what
+ *   decides when the table is rehashed.
+ * - The rehash count and time show how much work has gone into growing and
+ *   cleaning up the table.
+ *
+ * None of this is compiled in unless FUNDAMENTALS_HASH_STATS is defined to 1
+ * before including any of the hash containers (or on the compiler's command
+ * line). It adds a counter and a clock reading to every rehash, and the
+ * stats method works out the probe distances by walking the probe sequence
+ * of every key, so it takes time in proportion to the size of the table.
+ *
+ * Like the bounds check policy in Checks.hpp, the setting has to be the same
+ * everywhere in a program, because it changes what a HashMap holds.
+ */
+
+#include <chrono>
+#include <cstddef>
+
+#ifndef Fundamentals_HashStats_hpp_
+#define Fundamentals_HashStats_hpp_
+
+#ifndef FUNDAMENTALS_HASH_STATS
+#define FUNDAMENTALS_HASH_STATS 0
+#endif
+
+// The number of buckets in the histogram of probe distances. The last bucket
+// counts every key at that distance or further.
+#define HASHSTATS_HISTOGRAM_SIZE 16
+
+/**
+ * A snapshot of the statistics of a hash table.
+ */
+struct HashStats {
+	// The number of keys in the table.
+	size_t size;
+	// The number of slots in the table.
+	size_t capacity;
+	// The number of slots whose key has been removed.
+	size_t tombstones;
+	// The fraction of slots that are full or tombstones.
+	double loadFactor;
+	
+	// The number of keys at each probe distance, with the last bucket
+	// holding every key at HASHSTATS_HISTOGRAM_SIZE - 1 or further.
+	size_t probeHistogram[HASHSTATS_HISTOGRAM_SIZE];
+	// The average and longest probe distance over every key.
+	double averageProbeDistance;
+	size_t maxProbeDistance;
+	
+	// The number of times the table has been rehashed, and the total time
+	// spent doing so.
+	size_t rehashCount;
+	std::chrono::nanoseconds rehashTime;
+};
+
+/**
+ * The running counters a hash table keeps for its stats.
+ */
+struct HashStats_Counters {
+	size_t rehashCount = 0;
+	std::chrono::nanoseconds rehashTime = std::chrono::nanoseconds(0);
+};
+
+/**
+ * Starts a snapshot of the stats for a table, before any keys are counted.
+ * @param	size	The number of keys in the table
+ * @param	capacity	The number of slots in the table
+ * @param	tombstones	The number of slots whose key has been removed
+ * @param	counters	The table's running counters
+ * @return	The stats, with no probe distances counted yet
+ */
+inline HashStats hashStatsStart(size_t size, size_t capacity, size_t tombstones, const HashStats_Counters& counters) {
+	HashStats stats;
+	stats.size = size;
+	stats.capacity = capacity;
+	stats.tombstones = tombstones;
+	stats.loadFactor = capacity == 0 ? 0.0 : static_cast<double>(size + tombstones) / capacity;
+	for (size_t i = 0; i < HASHSTATS_HISTOGRAM_SIZE; ++i) {
+		stats.probeHistogram[i] = 0;
+	}
+	stats.averageProbeDistance = 0.0;
+	stats.maxProbeDistance = 0;
+	stats.rehashCount = counters.rehashCount;
+	stats.rehashTime = counters.rehashTime;
+	return stats;
+}
+/**
+ * Counts the probe distance of one key in a snapshot of stats.
+ *
+ * The average is kept as a total until hashStatsFinish is called.
+ *
+ * @param	stats	The stats to add to
+ * @param	distance	The probe distance of the key
+ */
+inline void hashStatsAdd(HashStats& stats, size_t distance) {
+	size_t bucket = distance < HASHSTATS_HISTOGRAM_SIZE ? distance : HASHSTATS_HISTOGRAM_SIZE - 1;
+	++stats.probeHistogram[bucket];
+	stats.averageProbeDistance += distance;
+	if (distance > stats.maxProbeDistance) {
+		stats.maxProbeDistance = distance;
+	}
+}
+/**
+ * Finishes a snapshot of stats once every key has been counted.
+ * @param	stats	The stats to finish
+ */
+inline void hashStatsFinish(HashStats& stats) {
+	if (stats.size != 0) {
+		stats.averageProbeDistance /= stats.size;
+	}
+}
+
+#endif // Fundamentals_HashStats_hpp_
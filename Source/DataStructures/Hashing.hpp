@@ -0,0 +1,513 @@
+/**
+ * Fundamentals :: Data Structures :: Hashing
+ * Author: Quinn Mortimer
+ *
+ * This file contains the hash functions used by the hashed data structures,
+ * along with a couple of small utilities for storing them.
+ *
+ * A hash function here is any class with a const call operator that takes a
+ * key and returns a size_t. Using a class rather than a function pointer
+ * means the compiler can see exactly which function is being called, so it
+ * can be inlined into the code that probes the table.
+ *
+ * The hashed data structures have power-of-two table sizes and pick slots
+ * using the low bits of a hash, so a hash whose low bits don't vary much
+ * (the identity function on integers, for instance) would pile keys into a
+ * few slots. To avoid this, every hash is passed through hashMix64 before it
+ * is used, unless the hash function class declares that its results are
+ * already well mixed with a member `typedef void is_avalanching;`.
+ *
+ * A hash function class can also declare `typedef void is_transparent;` to
+ * say that it can hash other types that compare equal to the key type, and
+ * that an equal key and value hash the same. The hashed data structures then
+ * allow lookups with those types, without building a key first. The default
+ * hash for strings does this for std::string_view and C strings.
+ *
+ * The hashed data structures take their hash function class as a template
+ * parameter, which defaults to DefaultHashFor<Key>. That is the default hash
+ * for the key types that have one, and HashFunction<Key> for the rest. Both
+ * can be constructed from a function pointer, so code written when the
+ * structures only took function pointers, such as
+ * `HashMap<MyKey, Value> map(&myHash)`, still compiles.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_Hashing_hpp_
+#define Fundamentals_Hashing_hpp_
+
+/**
+ * The default hash function for a type.
+ *
+ * Only integers, enumerations and strings have a default hash function.
+ * Other key types need to provide their own (see HashFunction below for
+ * using a plain function). This version, for every other type, is marked
+ * with an is_missing member so that DefaultHashFor can tell it apart, and
+ * can't be called.
+ */
+template <typename T, typename Enable = void>
+struct DefaultHash {
+	typedef void is_missing;
+	
+	template <typename U>
+	size_t operator()(const U&) const {
+		static_assert(sizeof(U) == 0, "There is no default hash for this type, a Hash parameter must be provided.");
+		return 0;
+	}
+};
+
+/**
+ * Mixes the bits of a 64-bit integer.
+ *
+ * This is the finalizer from the SplitMix64 generator. Every bit of the input
+ * affects every bit of the output, so keys that only differ in a few bits end
+ * up with very different hashes.
+ *
+ * @param	x	The integer to mix
+ * @return	The mixed integer
+ */
+inline uint64_t hashMix64(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ull;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBull;
+	x ^= x >> 31;
+	return x;
+}
+
+/**
+ * Rounds a table size up to a power of two.
+ *
+ * The hashed data structures only ever use power-of-two table sizes, so that
+ * a hash can be turned into a slot index with a mask instead of a division.
+ *
+ * @param	size	The smallest acceptable table size
+ * @return	The smallest power of two that is at least size
+ */
+inline size_t hashTableSize(size_t size) {
+	size_t tableSize = 1;
+	while (size > tableSize) {
+		tableSize <<= 1;
+	}
+	return tableSize;
+}
+
+/**
+ * Hashes a sequence of bytes.
+ *
+ * This is a version of MurmurHash64A, which consumes the input eight bytes at
+ * a time with a multiply and a few shifts for each word.
+ *
+ * @param	data	A pointer to the first byte to hash
+ * @param	length	The number of bytes to hash
+ * @return	The hash of the bytes
+ */
+inline uint64_t hashBytes(const void* data, size_t length) {
+	const uint64_t m = 0xC6A4A7935BD1E995ull;
+	const int r = 47;
+	
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t h = 0x9E3779B97F4A7C15ull ^ (length * m);
+	
+	size_t words = length / 8;
+	for (size_t i = 0; i < words; ++i) {
+		uint64_t k;
+		std::memcpy(&k, bytes + i * 8, 8);
+		
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		
+		h ^= k;
+		h *= m;
+	}
+	
+	const unsigned char* tail = bytes + words * 8;
+	switch (length & 7) {
+		case 7: h ^= uint64_t(tail[6]) << 48; // fall through
+		case 6: h ^= uint64_t(tail[5]) << 40; // fall through
+		case 5: h ^= uint64_t(tail[4]) << 32; // fall through
+		case 4: h ^= uint64_t(tail[3]) << 24; // fall through
+		case 3: h ^= uint64_t(tail[2]) << 16; // fall through
+		case 2: h ^= uint64_t(tail[1]) << 8; // fall through
+		case 1: h ^= uint64_t(tail[0]);
+			h *= m;
+	}
+	
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	
+	return h;
+}
+
+/**
+ * The default hash for integer and enumeration types.
+ */
+template <typename T>
+struct DefaultHash<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type> {
+	typedef void is_avalanching;
+	
+	size_t operator()(const T& value) const {
+		return static_cast<size_t>(hashMix64(static_cast<uint64_t>(value)));
+	}
+};
+
+/**
+ * The default hash for strings.
+ *
+ * String views and C strings hash the same as a std::string with the same
+ * characters, so they can be used to look up string keys.
+ */
+template <>
+struct DefaultHash<std::string> {
+	typedef void is_avalanching;
+	typedef void is_transparent;
+	
+	size_t operator()(const std::string& value) const {
+		return static_cast<size_t>(hashBytes(value.data(), value.size()));
+	}
+	size_t operator()(std::string_view value) const {
+		return static_cast<size_t>(hashBytes(value.data(), value.size()));
+	}
+	size_t operator()(const char* value) const {
+		return static_cast<size_t>(hashBytes(value, std::strlen(value)));
+	}
+};
+
+/**
+ * Used to detect whether a hash function class has an is_avalanching member.
+ */
+template <typename T>
+struct HashVoid {
+	typedef void type;
+};
+/**
+ * Reports whether the results of a hash function class are already mixed.
+ *
+ * This is false unless the class has an is_avalanching member type.
+ */
+template <typename Hash, typename Enable = void>
+struct HashIsAvalanching : std::false_type {
+};
+template <typename Hash>
+struct HashIsAvalanching<Hash, typename HashVoid<typename Hash::is_avalanching>::type> : std::true_type {
+};
+/**
+ * Reports whether a hash function class can hash types besides the key type.
+ *
+ * This is false unless the class has an is_transparent member type.
+ */
+template <typename Hash, typename Enable = void>
+struct HashIsTransparent : std::false_type {
+};
+template <typename Hash>
+struct HashIsTransparent<Hash, typename HashVoid<typename Hash::is_transparent>::type> : std::true_type {
+};
+/**
+ * Reports whether a type has a default hash function.
+ *
+ * This is true unless DefaultHash for the type has an is_missing member type.
+ */
+template <typename T, typename Enable = void>
+struct HashHasDefault : std::true_type {
+};
+template <typename T>
+struct HashHasDefault<T, typename HashVoid<typename DefaultHash<T>::is_missing>::type> : std::false_type {
+};
+/**
+ * Allows a lookup with a K in a table of Keys, as a default template argument.
+ *
+ * K has to be the key type itself, unless the hash function is transparent.
+ */
+template <typename Hash, typename Key, typename K>
+using HashLookupEnable = typename std::enable_if<std::is_same<Key, K>::value || HashIsTransparent<Hash>::value>::type;
+
+/**
+ * Finishes off a hash that is already well mixed, which needs no more work.
+ * @param	hash	The result of a hash function
+ * @return	The same hash
+ */
+inline size_t hashFinalize(size_t hash, std::true_type) {
+	return hash;
+}
+/**
+ * Finishes off a hash that might not be well mixed, by mixing it.
+ * @param	hash	The result of a hash function
+ * @return	The mixed hash
+ */
+inline size_t hashFinalize(size_t hash, std::false_type) {
+	return static_cast<size_t>(hashMix64(hash));
+}
+/**
+ * Applies a hash function to a key, mixing the result when needed.
+ *
+ * This is what the hashed data structures use to hash their keys.
+ *
+ * @param	hash	The hash function to apply
+ * @param	key	The key to hash
+ * @return	A well-mixed hash for the key
+ */
+template <typename Hash, typename K>
+inline size_t hashKey(const Hash& hash, const K& key) {
+	return hashFinalize(hash(key), HashIsAvalanching<Hash>());
+}
+
+/**
+ * Asks for the memory at an address to be loaded into the cache.
+ *
+ * This is only a hint, and does nothing on compilers without a way to give
+ * it. The batched lookups use it to start loading the slots for a number of
+ * keys before looking at any of them, so that the waits for memory overlap.
+ *
+ * @param	address	The address that will be read soon
+ */
+inline void hashPrefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(address);
+#else
+	(void)address;
+#endif
+}
+
+/**
+ * A hash function class that calls through a function pointer.
+ *
+ * This is here for code that already has a hash written as a plain function,
+ * from when the hashed data structures only accepted function pointers.
+ * For example:
+ * 	HashMap<Key, Value, PerturbProbe, HashFunction<Key>> map(&myHash);
+ * Keys without a default hash use this class by default (see DefaultHashFor),
+ * so for those keys the Hash parameter can be left out.
+ *
+ * Calls through the pointer can't be inlined, so a class with a call operator
+ * should be preferred for new code.
+ */
+template <typename T>
+class HashFunction {
+	public:
+		typedef size_t (*pointer_type)(const T&);
+		
+		// Constructors
+		HashFunction();
+		HashFunction(pointer_type function);
+		
+		// Checks whether there is a function to call
+		bool valid() const;
+		
+		// Calls the function
+		size_t operator()(const T& value) const;
+		
+	private:
+		pointer_type mp_function;
+};
+
+/**
+ * The default hash for a type, which can be swapped for a function pointer.
+ *
+ * This is so that code from when the hashed data structures only accepted
+ * function pointers, such as `HashMap<int, Value> map(&myHash)`, still
+ * compiles and uses its own function for keys that also have a default hash.
+ * A default-constructed one is the default hash.
+ *
+ * The results of the function are mixed, so this is avalanching either way,
+ * and transparent lookups with another type build a key to pass to it. The
+ * one cost over DefaultHash is the check for a function on each call, which
+ * is always predicted once a table is in use.
+ */
+template <typename T>
+class DefaultHashOrFunction : public DefaultHash<T> {
+	public:
+		typedef size_t (*pointer_type)(const T&);
+		
+		// Constructors
+		DefaultHashOrFunction();
+		DefaultHashOrFunction(const DefaultHash<T>& hash);
+		DefaultHashOrFunction(pointer_type function);
+		
+		// Calls the function, or the default hash when there isn't one
+		template <typename U>
+		size_t operator()(const U& value) const;
+		
+	private:
+		pointer_type mp_function;
+};
+
+/**
+ * The hash function class the hashed data structures use when none is given.
+ *
+ * This is the default hash for keys that have one, which can be given a
+ * function pointer in its place. Keys without one fall back to a
+ * HashFunction, which has to be given a function pointer when the data
+ * structure is constructed.
+ */
+template <typename T>
+using DefaultHashFor = typename std::conditional<HashHasDefault<T>::value, DefaultHashOrFunction<T>, HashFunction<T>>::type;
+
+/**
+ * Stores a hash function object without using any space when it is empty.
+ *
+ * Hash function classes usually have no data members, but a data member of
+ * an empty class still takes up at least one byte (and often more, due to
+ * padding). An empty base class, on the other hand, can take up no space at
+ * all. The hashed data structures privately inherit from this class to take
+ * advantage of that.
+ */
+template <typename Hash>
+class HashHolder : private Hash {
+	public:
+		// Constructors
+		HashHolder();
+		HashHolder(const Hash& hash);
+		
+		// Access to the stored hash function
+		const Hash& hashFunction() const;
+		Hash& hashFunction();
+};
+
+/**
+ * Checks that a hash function can be used.
+ *
+ * Any hash function class can be used, except a HashFunction with no pointer.
+ * This is overloaded for that case below.
+ */
+template <typename Hash>
+inline void requireHashFunction(const Hash&) {
+}
+/**
+ * Checks that a HashFunction has a function pointer to call.
+ * @throws	MissingHashFunctionError	when the pointer is null
+ * @param	hash	The hash function to check
+ */
+template <typename T>
+inline void requireHashFunction(const HashFunction<T>& hash) {
+	if (!hash.valid()) {
+		throw MissingHashFunctionError();
+	}
+}
+
+// ---------------------- //
+// HashFunction Methods //
+// ---------------------- //
+/**
+ * Constructs a HashFunction with no function to call.
+ */
+template <typename T>
+HashFunction<T>::HashFunction()
+	: mp_function(nullptr)
+{}
+/**
+ * Constructs a HashFunction that calls the provided function.
+ * @param	function	A pointer to the hash function
+ */
+template <typename T>
+HashFunction<T>::HashFunction(pointer_type function)
+	: mp_function(function)
+{}
+/**
+ * Reports whether this has a function to call.
+ * @return	Whether or not the function pointer is set
+ */
+template <typename T>
+bool HashFunction<T>::valid() const {
+	return mp_function != nullptr;
+}
+/**
+ * Calls the hash function.
+ * @param	value	The value to hash
+ * @return	The hash of value
+ */
+template <typename T>
+size_t HashFunction<T>::operator()(const T& value) const {
+	return mp_function(value);
+}
+
+// ------------------------------- //
+// DefaultHashOrFunction Methods //
+// ------------------------------- //
+/**
+ * Constructs the default hash for T.
+ */
+template <typename T>
+DefaultHashOrFunction<T>::DefaultHashOrFunction()
+	: mp_function(nullptr)
+{}
+/**
+ * Constructs the default hash for T, from the class for it.
+ * @param	hash	The default hash to copy
+ */
+template <typename T>
+DefaultHashOrFunction<T>::DefaultHashOrFunction(const DefaultHash<T>& hash)
+	: DefaultHash<T>(hash), mp_function(nullptr)
+{}
+/**
+ * Constructs a hash that calls the provided function instead of the default.
+ * @param	function	A pointer to the hash function, or nullptr for the default
+ */
+template <typename T>
+DefaultHashOrFunction<T>::DefaultHashOrFunction(pointer_type function)
+	: mp_function(function)
+{}
+/**
+ * Hashes a value with the function, if there is one, or the default hash.
+ * @param	value	The value to hash, a T or a type the default hash accepts
+ * @return	The hash of value
+ */
+template <typename T>
+template <typename U>
+size_t DefaultHashOrFunction<T>::operator()(const U& value) const {
+	if (mp_function != nullptr) {
+		if constexpr (std::is_same<U, T>::value) {
+			return static_cast<size_t>(hashMix64(mp_function(value)));
+		}
+		else {
+			return static_cast<size_t>(hashMix64(mp_function(T(value))));
+		}
+	}
+	
+	return DefaultHash<T>::operator()(value);
+}
+
+// -------------------- //
+// HashHolder Methods //
+// -------------------- //
+/**
+ * Stores a default-constructed hash function.
+ */
+template <typename Hash>
+HashHolder<Hash>::HashHolder()
+	: Hash()
+{}
+/**
+ * Stores a copy of the provided hash function.
+ * @param	hash	The hash function to copy
+ */
+template <typename Hash>
+HashHolder<Hash>::HashHolder(const Hash& hash)
+	: Hash(hash)
+{}
+/**
+ * Provides a constant reference to the stored hash function.
+ * @return	The stored hash function
+ */
+template <typename Hash>
+const Hash& HashHolder<Hash>::hashFunction() const {
+	return *this;
+}
+/**
+ * Provides a reference to the stored hash function.
+ * @return	The stored hash function
+ */
+template <typename Hash>
+Hash& HashHolder<Hash>::hashFunction() {
+	return *this;
+}
+
+#endif // Fundamentals_Hashing_hpp_
@@ -0,0 +1,563 @@
+/**
+ * Fundamentals :: Data Structures :: Incremental Hash Map
+ * Author: Quinn Mortimer
+ *
+ * This is a hash map that never rehashes all of its contents at once.
+ * It is built out of two ordinary HashMaps, and spreads the work of moving
+ * keys from one to the other over many operations.
+ */
+/**
+ * When a HashMap gets too crowded, the next insertion moves every key into a
+ * larger table before it returns. On average that is cheap, since it only
+ * happens after the number of keys has doubled, but the one insertion that
+ * triggers it can take a very long time on a large map.
+ *
+ * Here, when the table gets too crowded, it becomes the old table and an
+ * empty larger one is made to take its place. New keys always go into the
+ * new table. Every operation that changes the map also moves the keys in
+ * a few slots of the old table across, so the old table is emptied well
+ * before the new one fills up. Until then, lookups check both tables.
+ *
+ * Making the larger table still takes time in proportion to its size, since
+ * its slots have to be marked empty, but that's much less work than hashing
+ * and moving every key.
+ */
+
+#include <cstddef>
+#include <utility>
+
+#include "Exceptions.hpp"
+#include "HashMap.hpp"
+#include "Hashing.hpp"
+#include "HashProbes.hpp"
+
+#ifndef Fundamentals_IncrementalHashMap_hpp_
+#define Fundamentals_IncrementalHashMap_hpp_
+
+// The fewest slots of the old table moved across on each change.
+// The step used for a resize can be larger (see m_pickStep), since the move
+// has to finish before the new table is crowded. With a load factor f and an
+// old table of C slots, the new table has room for about f * C / 2 more keys
+// than it will get from the old one, both when it grows (the old table held
+// more than f * C / 2 keys, and the new one has room for twice as many) and
+// when it stays the same size (at least half of the old table's load was
+// tombstones, which are not moved). At the default load factor that is
+// 0.375 * C changes, so four slots at a time is enough.
+#define INCREMENTALHASHMAP_MIGRATE_STEP 4
+
+/**
+ * A HashMap that resizes gradually rather than all in one go.
+ *
+ * Each key is only ever in one of the two tables. Keys are looked up in the
+ * new table first, since that is where keys that were recently added or
+ * changed will be.
+ *
+ * The Probe and Hash parameters are passed on to the HashMaps that hold the
+ * contents, and are described there.
+ */
+template <typename Key, typename Value, typename Probe = PerturbProbe, typename Hash = DefaultHashFor<Key>>
+class IncrementalHashMap {
+	public:
+		typedef size_t size_type;
+		typedef Hash hash_type;
+		typedef HashMap<Key, Value, Probe, Hash> table_type;
+		
+		// Constructors
+		IncrementalHashMap();
+		IncrementalHashMap(const hash_type& hash);
+		IncrementalHashMap(const hash_type& hash, size_type size);
+		
+		IncrementalHashMap(IncrementalHashMap<Key, Value, Probe, Hash>&& other);
+		IncrementalHashMap(const IncrementalHashMap<Key, Value, Probe, Hash>& other);
+		
+		// The tables manage their own memory,
+		// so the default destructor is fine
+		~IncrementalHashMap() = default;
+		
+		// Assignment
+		IncrementalHashMap<Key, Value, Probe, Hash>& operator=(const IncrementalHashMap<Key, Value, Probe, Hash>& other);
+		IncrementalHashMap<Key, Value, Probe, Hash>& operator=(IncrementalHashMap<Key, Value, Probe, Hash>&& other);
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Access to the state of a resize
+		bool migrating() const;
+		void finishMigration();
+		
+		// Element insertion and deletion
+		// - Functions that can throw exceptions
+		void insert(const Key& k, const Value& v);
+		void remove(const Key& k);
+		// - Function that will not throw exceptions
+		void set(const Key& k, const Value& v);
+		void unset(const Key& k);
+		
+		// Data Access
+		// - Check for a key
+		bool hasKey(const Key& k) const;
+		// - Get elements by key
+		Value& operator[](const Key& k);
+		Value& getValue(const Key& k);
+		const Value& getValue(const Key& k) const;
+		
+	private:
+		typedef HashMap_Node<Key, Value> Node;
+		
+		// The table that new keys go into.
+		table_type m_current;
+		// The table being emptied during a resize.
+		table_type m_old;
+		// The next slot of the old table to move across.
+		size_type m_migrateIndex;
+		// The number of slots to move across on each change.
+		size_type m_migrateSlots;
+		// Whether there is a resize in progress.
+		bool m_migrating;
+		
+		// Makes room for one more key, starting a resize if needed.
+		void m_reserveOne();
+		// Moves the keys in the next few slots of the old table across.
+		void m_migrateStep(size_type slots);
+		// Picks how many slots to move on each change so a resize finishes in time.
+		size_type m_pickStep() const;
+		
+		// Finds the node holding a key in either table, if there is one.
+		Node* m_findNode(const Key& key, size_type hashValue) const;
+		// Adds a key known not to be in either table to the current table.
+		Value& m_insertNew(const Key& key, const Value& value, size_type hashValue);
+		// Removes a key from whichever table it is in.
+		bool m_erase(const Key& key, size_type hashValue);
+};
+
+// ---------------------------//
+// IncrementalHashMap Methods //
+// ---------------------------//
+/**
+ * Constructs an IncrementalHashMap with a default-constructed hash function.
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>::IncrementalHashMap()
+	: IncrementalHashMap(hash_type())
+{}
+/**
+ * Constructs an IncrementalHashMap with a hash function for the key type.
+ * @param	hash	The hash function for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>::IncrementalHashMap(const hash_type& hash)
+	: m_current(hash), m_old(hash), m_migrateIndex(0), m_migrateSlots(INCREMENTALHASHMAP_MIGRATE_STEP), m_migrating(false)
+{}
+/**
+ * Constructs an IncrementalHashMap from a hash function and a minimum load.
+ * @param	hash	The hash function for this to use
+ * @param	size	An amount of elements the table should be able to hold
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>::IncrementalHashMap(const hash_type& hash, size_type size)
+	: m_current(hash, size), m_old(hash), m_migrateIndex(0), m_migrateSlots(INCREMENTALHASHMAP_MIGRATE_STEP), m_migrating(false)
+{}
+/**
+ * Constructs an IncrementalHashMap by moving the tables of another.
+ *
+ * The other map is left with two empty tables and no resize in progress, so
+ * it can still be used.
+ *
+ * @param	other	The IncrementalHashMap to move from
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>::IncrementalHashMap(IncrementalHashMap<Key, Value, Probe, Hash>&& other)
+	: m_current(std::move(other.m_current)), m_old(std::move(other.m_old)), m_migrateIndex(other.m_migrateIndex), m_migrateSlots(other.m_migrateSlots), m_migrating(other.m_migrating)
+{
+	other.m_migrateIndex = 0;
+	other.m_migrateSlots = INCREMENTALHASHMAP_MIGRATE_STEP;
+	other.m_migrating = false;
+}
+/**
+ * Constructs an IncrementalHashMap by copying the contents of another.
+ *
+ * A copied HashMap doesn't keep its keys in the same slots as the original,
+ * so if a resize is in progress the copy starts moving its old table across
+ * from the beginning again.
+ *
+ * @param	other	The IncrementalHashMap to copy
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>::IncrementalHashMap(const IncrementalHashMap<Key, Value, Probe, Hash>& other)
+	: m_current(other.m_current), m_old(other.m_old), m_migrateIndex(0), m_migrateSlots(INCREMENTALHASHMAP_MIGRATE_STEP), m_migrating(other.m_migrating)
+{
+	if (m_migrating) {
+		m_migrateSlots = m_pickStep();
+	}
+}
+
+/**
+ * Assigns the contents of another IncrementalHashMap to this one.
+ * @param	other	The IncrementalHashMap to copy
+ * @return	A reference to this map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>& IncrementalHashMap<Key, Value, Probe, Hash>::operator=(const IncrementalHashMap<Key, Value, Probe, Hash>& other) {
+	IncrementalHashMap<Key, Value, Probe, Hash> copy(other);
+	*this = std::move(copy);
+	return *this;
+}
+/**
+ * Moves the tables of another IncrementalHashMap into this one.
+ *
+ * As with the move constructor, the other map is left empty and usable.
+ *
+ * @param	other	The IncrementalHashMap to move from
+ * @return	A reference to this map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+IncrementalHashMap<Key, Value, Probe, Hash>& IncrementalHashMap<Key, Value, Probe, Hash>::operator=(IncrementalHashMap<Key, Value, Probe, Hash>&& other) {
+	if (this != &other) {
+		m_current = std::move(other.m_current);
+		m_old = std::move(other.m_old);
+		m_migrateIndex = other.m_migrateIndex;
+		m_migrateSlots = other.m_migrateSlots;
+		m_migrating = other.m_migrating;
+		
+		other.m_current = table_type(m_current.hashFunction());
+		other.m_old = table_type(m_current.hashFunction());
+		other.m_migrateIndex = 0;
+		other.m_migrateSlots = INCREMENTALHASHMAP_MIGRATE_STEP;
+		other.m_migrating = false;
+	}
+	return *this;
+}
+
+/**
+ * Reports the number of key-value pairs in the map, across both tables.
+ * @return	The number of valid key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename IncrementalHashMap<Key, Value, Probe, Hash>::size_type IncrementalHashMap<Key, Value, Probe, Hash>::size() const {
+	return m_current.size() + m_old.size();
+}
+/**
+ * Reports whether or not the map is empty.
+ * @return	Whether there are any used slots in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool IncrementalHashMap<Key, Value, Probe, Hash>::empty() const {
+	return size() == 0;
+}
+
+/**
+ * Reports whether there is a resize in progress.
+ * @return	Whether some keys are still in the old table
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool IncrementalHashMap<Key, Value, Probe, Hash>::migrating() const {
+	return m_migrating;
+}
+/**
+ * Moves every remaining key out of the old table.
+ *
+ * This is for when there is time to spare, like between requests, so that
+ * lookups only need to check one table again.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::finishMigration() {
+	if (m_migrating) {
+		m_migrateStep(m_old.m_nodes.size());
+	}
+}
+
+/**
+ * Insert a key-value pair into the map.
+ * @throws	DuplicateKeyError	When the key provided is already in the map
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::insert(const Key& key, const Value& value) {
+	m_reserveOne();
+	
+	size_type hashValue = m_current.m_hash(key);
+	if (m_findNode(key, hashValue) != nullptr) {
+		throw DuplicateKeyError();
+	}
+	
+	m_insertNew(key, value, hashValue);
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ * @throws	MissingKeyError	If the requested key is not in the map
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::remove(const Key& key) {
+	m_migrateStep(m_migrateSlots);
+	
+	if (!m_erase(key, m_current.m_hash(key))) {
+		throw MissingKeyError();
+	}
+}
+/**
+ * Sets the value corresponding to a key in this map.
+ *
+ * If the key was already in the map, it will just overwrite the old value,
+ * in whichever table it is in.
+ *
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::set(const Key& key, const Value& value) {
+	m_reserveOne();
+	
+	size_type hashValue = m_current.m_hash(key);
+	Node* node = m_findNode(key, hashValue);
+	
+	if (node != nullptr) {
+		node->value() = value;
+	}
+	else {
+		m_insertNew(key, value, hashValue);
+	}
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ *
+ * If the key was not in the map in the first place, it just won't do
+ * anything.
+ *
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::unset(const Key& key) {
+	m_migrateStep(m_migrateSlots);
+	
+	m_erase(key, m_current.m_hash(key));
+}
+
+/**
+ * Checks if a key is currently in the map.
+ * @param	key	The key to check for
+ * @return	A boolean representing whether or not the key exists
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool IncrementalHashMap<Key, Value, Probe, Hash>::hasKey(const Key& key) const {
+	return m_findNode(key, m_current.m_hash(key)) != nullptr;
+}
+
+/**
+ * Gets a reference to the value stored at a given key.
+ *
+ * As with HashMap, a missing key is added with a default-constructed value.
+ *
+ * @param	key	The key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+Value& IncrementalHashMap<Key, Value, Probe, Hash>::operator[](const Key& key) {
+	m_reserveOne();
+	
+	size_type hashValue = m_current.m_hash(key);
+	Node* node = m_findNode(key, hashValue);
+	
+	if (node != nullptr) {
+		return node->value();
+	}
+	
+	return m_insertNew(key, Value(), hashValue);
+}
+/**
+ * Gets a reference to the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+Value& IncrementalHashMap<Key, Value, Probe, Hash>::getValue(const Key& key) {
+	Node* node = m_findNode(key, m_current.m_hash(key));
+	if (node == nullptr) {
+		throw MissingKeyError();
+	}
+	
+	return node->value();
+}
+/**
+ * Gets a constant reference to the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+const Value& IncrementalHashMap<Key, Value, Probe, Hash>::getValue(const Key& key) const {
+	const Node* node = m_findNode(key, m_current.m_hash(key));
+	if (node == nullptr) {
+		throw MissingKeyError();
+	}
+	
+	return node->value();
+}
+
+/**
+ * Makes room in the current table for one more key.
+ *
+ * If the current table is as full as it is allowed to get, it becomes the
+ * old table, and its place is taken by an empty table with room for twice
+ * as many keys. When most of the crowding is from tombstones, the new table
+ * is the same size instead (see HashMap::m_rehashSize). The step size is
+ * picked so that any resize has finished before the new table gets crowded,
+ * so the call to finishMigration only has work to do for a copied map, which
+ * starts its move over from the beginning.
+ *
+ * Otherwise, this moves the next few slots of the old table across.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::m_reserveOne() {
+	if (!m_current.m_crowded()) {
+		m_migrateStep(m_migrateSlots);
+		return;
+	}
+	
+	finishMigration();
+	
+	table_type larger(m_current.hashFunction(), m_current.m_rehashSize(), m_current.m_maxLoadFactor, m_current.get_allocator());
+	m_old.m_swap(m_current);
+	m_current.m_swap(larger);
+	
+	m_migrateIndex = 0;
+	m_migrating = true;
+	m_migrateSlots = m_pickStep();
+}
+/**
+ * Moves the keys in the next few slots of the old table into the current one.
+ *
+ * The nodes are moved with their stored hashes, so no key is hashed again.
+ * Once the last slot has been moved, the old table is replaced by an empty
+ * one to give its memory back.
+ *
+ * @param	slots	The most slots to look at
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void IncrementalHashMap<Key, Value, Probe, Hash>::m_migrateStep(size_type slots) {
+	if (!m_migrating) {
+		return;
+	}
+	
+	size_type capacity = m_old.m_nodes.size();
+	size_type end = capacity - m_migrateIndex < slots ? capacity : m_migrateIndex + slots;
+	
+	for (; m_migrateIndex < end; ++m_migrateIndex) {
+		Node& node = m_old.m_nodes[m_migrateIndex];
+		if (!node.empty()) {
+			m_current.m_moveIn(node, m_old.m_nodes.get_allocator());
+			m_old.m_probe.markCleared(m_migrateIndex);
+			--m_old.m_size;
+			++m_old.m_tombstones;
+		}
+	}
+	
+	if (m_migrateIndex == capacity) {
+		table_type emptied(m_old.hashFunction());
+		m_old.m_swap(emptied);
+		m_migrating = false;
+	}
+}
+
+/**
+ * Picks how many slots of the old table to move across on each change.
+ *
+ * Each change adds at most one key or tombstone to the current table, besides
+ * the keys moved into it, so the current table can take headroom more changes
+ * before it is crowded. Moving enough slots each time to cover the rest of the
+ * old table in fewer changes than that means a resize never has to be
+ * finished all in one go.
+ *
+ * @return	The number of slots to move on each change, at least INCREMENTALHASHMAP_MIGRATE_STEP
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename IncrementalHashMap<Key, Value, Probe, Hash>::size_type IncrementalHashMap<Key, Value, Probe, Hash>::m_pickStep() const {
+	size_type remaining = m_old.m_nodes.size() - m_migrateIndex;
+	size_type load = m_current.m_size + m_current.m_tombstones + m_old.m_size;
+	if (load + 1 >= m_current.m_loadThreshold) {
+		return remaining;
+	}
+	
+	size_type headroom = m_current.m_loadThreshold - load - 1;
+	size_type step = remaining / headroom + 1;
+	return step < INCREMENTALHASHMAP_MIGRATE_STEP ? INCREMENTALHASHMAP_MIGRATE_STEP : step;
+}
+
+/**
+ * Finds the node holding a key, in whichever table it is in.
+ * @param	key	The key to look for
+ * @param	hashValue	The hash of key
+ * @return	A pointer to the node holding key, or nullptr if there isn't one
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename IncrementalHashMap<Key, Value, Probe, Hash>::Node* IncrementalHashMap<Key, Value, Probe, Hash>::m_findNode(const Key& key, size_type hashValue) const {
+	size_type index = m_current.m_findIndex(key, hashValue);
+	if (!m_current.m_nodes[index].empty()) {
+		return const_cast<Node*>(&m_current.m_nodes[index]);
+	}
+	
+	if (m_migrating) {
+		index = m_old.m_findIndex(key, hashValue);
+		if (!m_old.m_nodes[index].empty()) {
+			return const_cast<Node*>(&m_old.m_nodes[index]);
+		}
+	}
+	
+	return nullptr;
+}
+/**
+ * Adds a key to the current table.
+ *
+ * The key must not be in either table, and m_reserveOne must have been called.
+ *
+ * @param	key	The key to add
+ * @param	value	The value for key
+ * @param	hashValue	The hash of key
+ * @return	A reference to the value now stored in the table
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+Value& IncrementalHashMap<Key, Value, Probe, Hash>::m_insertNew(const Key& key, const Value& value, size_type hashValue) {
+	size_type index = m_current.m_findFreeIndex(hashValue);
+	
+	if (!m_current.m_nodes[index].unused()) {
+		--m_current.m_tombstones;
+	}
+	
+	m_current.m_nodes[index].set(m_current.m_nodes.get_allocator(), key, value, hashValue);
+	m_current.m_probe.markFull(index, hashValue);
+	++m_current.m_size;
+	
+	return m_current.m_nodes[index].value();
+}
+/**
+ * Removes a key, along with its value, from whichever table it is in.
+ * @param	key	The key to remove
+ * @param	hashValue	The hash of key
+ * @return	Whether the key was found and removed
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool IncrementalHashMap<Key, Value, Probe, Hash>::m_erase(const Key& key, size_type hashValue) {
+	table_type* tables[2] = { &m_current, &m_old };
+	size_type count = m_migrating ? 2 : 1;
+	
+	for (size_type i = 0; i < count; ++i) {
+		table_type& table = *tables[i];
+		size_type index = table.m_findIndex(key, hashValue);
+		
+		if (!table.m_nodes[index].empty()) {
+			table.m_nodes[index].clear(table.m_nodes.get_allocator());
+			table.m_probe.markCleared(index);
+			--table.m_size;
+			++table.m_tombstones;
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+#endif // Fundamentals_IncrementalHashMap_hpp_
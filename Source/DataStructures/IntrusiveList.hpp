@@ -0,0 +1,983 @@
+/**
+ * Fundamentals :: Data Structures :: Intrusive List
+ * Author: Quinn Mortimer
+ *
+ * This is an implementation of an intrusive doubly-linked list.
+ * It is intended as a reference for those looking to brush up on important
+ * data structures.
+ */
+/**
+ * A LinkedList copies each value into a node that it allocates itself. An
+ * IntrusiveList doesn't have nodes of its own. Instead, the objects it holds
+ * each have an IntrusiveList_Hook member, which carries the same prev and
+ * next pointers that a LinkedList_Node does. Linking an object into the list
+ * just sets those pointers, so it never allocates or copies anything.
+ *
+ * That means the list doesn't own its objects. They have to outlive their
+ * time in the list, and the list never constructs or destroys them. An
+ * object can be in as many lists at once as it has hooks, but only one list
+ * per hook.
+ *
+ * Being able to get at the hook from the object also means an object can be
+ * removed from the list knowing only the object, without searching for it.
+ *
+ * There are no standard library containers used here.
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "Checks.hpp"
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_IntrusiveList_hpp_
+#define Fundamentals_IntrusiveList_hpp_
+
+// Whether insert and remove check that an iterator belongs to the list, and
+// throw a MismatchedIteratorError when it doesn't. This also turns on the
+// checks that can be made from an object's hook in constant time: that an
+// object being linked in isn't already linked, and that an object being
+// removed looks like it is in this list. Those throw a MismatchedObjectError.
+// The checks are on unless NDEBUG is defined, and they can be turned on or
+// off by defining this as 1 or 0 before including this file.
+#ifndef INTRUSIVELIST_CHECK_OWNERS
+#ifdef NDEBUG
+#define INTRUSIVELIST_CHECK_OWNERS 0
+#else
+#define INTRUSIVELIST_CHECK_OWNERS 1
+#endif
+#endif
+
+/**
+ * The links that an object needs to be put into an IntrusiveList.
+ *
+ * Objects include one of these as a member for each list they can be in.
+ * Copying an object shouldn't copy its place in a list, so a copied hook
+ * starts unlinked and assigning to a hook leaves it as it was.
+ */
+template <typename T>
+struct IntrusiveList_Hook {
+	T* prev;
+	T* next;
+	
+	IntrusiveList_Hook() : prev(nullptr), next(nullptr) {}
+	IntrusiveList_Hook(const IntrusiveList_Hook<T>&) : prev(nullptr), next(nullptr) {}
+	IntrusiveList_Hook<T>& operator=(const IntrusiveList_Hook<T>&) { return *this; }
+};
+
+// Forward declaration of the IntrusiveList class.
+template <typename T, IntrusiveList_Hook<T> T::* Hook> class IntrusiveList;
+// Forward declaration of our two iterator classes.
+template <typename T, IntrusiveList_Hook<T> T::* Hook> class IntrusiveList_Iterator;
+template <typename T, IntrusiveList_Hook<T> T::* Hook> class IntrusiveList_ConstIterator;
+
+/**
+ * A doubly-linked list of objects that carry their own links.
+ *
+ * Hook is the member of T that holds the links for this list. For example,
+ * `IntrusiveList<Task, &Task::queueHook>`.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+class IntrusiveList {
+	public:
+		typedef size_t size_type;
+		typedef IntrusiveList_Iterator<T, Hook> iterator;
+		typedef IntrusiveList_ConstIterator<T, Hook> const_iterator;
+		
+		// Constructors and Destructor
+		IntrusiveList();
+		IntrusiveList(IntrusiveList<T, Hook>&& other);
+		~IntrusiveList();
+		
+		// An object can only be in one list per hook, so lists can't be copied
+		IntrusiveList(const IntrusiveList<T, Hook>& other) = delete;
+		IntrusiveList<T, Hook>& operator=(const IntrusiveList<T, Hook>& other) = delete;
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Linking and unlinking objects.
+		// - Front
+		void push_front(T& object);
+		void pop_front();
+		// - Back
+		void push_back(T& object);
+		void pop_back();
+		// - Arbitrary
+		void insert(iterator location, T& object);
+		void remove(iterator location);
+		void remove(T& object);
+		// - Everything
+		void clear();
+		
+		// Iterators to the start and end of the list
+		iterator begin();
+		const_iterator begin() const;
+		iterator end();
+		const_iterator end() const;
+		// An iterator to an object that is already in this list
+		iterator iteratorTo(T& object);
+		
+		// Direct object access at the front and the back.
+		T& front();
+		const T& front() const;
+		T& back();
+		const T& back() const;
+		
+		// Operators
+		// - Asssignment
+		IntrusiveList<T, Hook>& operator=(IntrusiveList<T, Hook>&& other);
+		
+	private:
+		T* m_firstNode;
+		T* m_lastNode;
+		size_type m_size;
+		
+		void m_swap(IntrusiveList<T, Hook>& other);
+		
+		// Checks an object's hook before linking or unlinking it.
+		void m_checkUnlinked(T& object) const;
+		void m_checkLinked(T& object) const;
+		
+		// Provides the links of an object.
+		static IntrusiveList_Hook<T>& m_hook(T* object);
+		static const IntrusiveList_Hook<T>& m_hook(const T* object);
+		
+	// The iterators need to see the ends of their owner.
+	friend class IntrusiveList_Iterator<T, Hook>;
+	friend class IntrusiveList_ConstIterator<T, Hook>;
+};
+
+/**
+ * An iterator over an IntrusiveList that provides read-write access.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+class IntrusiveList_Iterator {
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* pointer;
+		typedef T& reference;
+		
+		// Constructors
+		IntrusiveList_Iterator();
+		IntrusiveList_Iterator(const IntrusiveList_Iterator<T, Hook>& other);
+		
+		// Assignement operator
+		IntrusiveList_Iterator<T, Hook>& operator=(const IntrusiveList_Iterator<T, Hook>& other);
+		
+		// Equality test operators
+		bool operator==(const IntrusiveList_Iterator<T, Hook>& other) const;
+		bool operator!=(const IntrusiveList_Iterator<T, Hook>& other) const;
+		bool operator==(const IntrusiveList_ConstIterator<T, Hook>& other) const;
+		bool operator!=(const IntrusiveList_ConstIterator<T, Hook>& other) const;
+		
+		// Data access
+		T& operator*() const;
+		T* operator->() const;
+		
+		// Increment and Decrement operators
+		IntrusiveList_Iterator<T, Hook>& operator++();
+		IntrusiveList_Iterator<T, Hook> operator++(int);
+		IntrusiveList_Iterator<T, Hook>& operator--();
+		IntrusiveList_Iterator<T, Hook> operator--(int);
+	private:
+		// The intrusive list which the object in this iterator belongs to.
+		IntrusiveList<T, Hook>* r_owner;
+		// The object this iterator is pointing to.
+		T* r_node;
+		
+		// Object-and-owner constructor
+		// This is on its own in the private section because
+		// the user should not call it, but it is used by the IntrusiveList class.
+		IntrusiveList_Iterator(T* n, IntrusiveList<T, Hook>* owner);
+		
+	// IntrusiveList and IntrusiveList_ConstIterator both need access to
+	// private members of this class.
+	friend class IntrusiveList<T, Hook>;
+	friend class IntrusiveList_ConstIterator<T, Hook>;
+};
+
+/**
+ * An iterator over an IntrusiveList that provides read-only access.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+class IntrusiveList_ConstIterator {
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+		
+		// Constructors
+		IntrusiveList_ConstIterator();
+		IntrusiveList_ConstIterator(const IntrusiveList_ConstIterator<T, Hook>& other);
+		IntrusiveList_ConstIterator(const IntrusiveList_Iterator<T, Hook>& other);
+		
+		// Assignemnt operators
+		IntrusiveList_ConstIterator<T, Hook>& operator=(const IntrusiveList_ConstIterator<T, Hook>& other);
+		IntrusiveList_ConstIterator<T, Hook>& operator=(const IntrusiveList_Iterator<T, Hook>& other);
+		
+		// Equality test operators
+		bool operator==(const IntrusiveList_ConstIterator<T, Hook>& other) const;
+		bool operator!=(const IntrusiveList_ConstIterator<T, Hook>& other) const;
+		bool operator==(const IntrusiveList_Iterator<T, Hook>& other) const;
+		bool operator!=(const IntrusiveList_Iterator<T, Hook>& other) const;
+		
+		// Data access operators
+		const T& operator*() const;
+		const T* operator->() const;
+		
+		// Increment and Decrement operators
+		IntrusiveList_ConstIterator<T, Hook>& operator++();
+		IntrusiveList_ConstIterator<T, Hook> operator++(int);
+		IntrusiveList_ConstIterator<T, Hook>& operator--();
+		IntrusiveList_ConstIterator<T, Hook> operator--(int);
+	private:
+		const IntrusiveList<T, Hook>* r_owner;
+		const T* r_node;
+		
+		// Object-and-owner constructor
+		// This is on its own in the private section because
+		// the user should not call it, but it is used by the IntrusiveList class.
+		IntrusiveList_ConstIterator(const T* n, const IntrusiveList<T, Hook>* owner);
+		
+	// IntrusiveList and IntrusiveList_Iterator both need access to private
+	// members of this class.
+	friend class IntrusiveList<T, Hook>;
+	friend class IntrusiveList_Iterator<T, Hook>;
+};
+
+// ---------------------- //
+// Intrusive List Methods //
+// ---------------------- //
+/**
+ * Constructs an empty IntrusiveList.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList<T, Hook>::IntrusiveList()
+	: m_firstNode(nullptr), m_lastNode(nullptr), m_size(0)
+{}
+/**
+ * Constructs an IntrusiveList by taking over the objects of another one.
+ *
+ * Only the ends of the list change hands, since the links between objects
+ * stay the same. Iterators into the other list still name it as their owner.
+ *
+ * @param	other	The list to move from, which is left empty
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList<T, Hook>::IntrusiveList(IntrusiveList<T, Hook>&& other)
+	: IntrusiveList()
+{
+	m_swap(other);
+}
+/**
+ * Unlinks every object still in the list. The objects themselves are left
+ * alone, since the list doesn't own them.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList<T, Hook>::~IntrusiveList() {
+	clear();
+}
+
+/**
+ * Reports the number of objects in the list.
+ * @return	The size of the list
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+typename IntrusiveList<T, Hook>::size_type IntrusiveList<T, Hook>::size() const {
+	return m_size;
+}
+/**
+ * Reports whether the list has no objects.
+ * @return	Whether the size is 0
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList<T, Hook>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Links an object in at the start of the list.
+ *
+ * The object must not already be in a list through this hook.
+ *
+ * @throws	MismatchedObjectError	when INTRUSIVELIST_CHECK_OWNERS is on and
+ * 	the object's hook is already linked
+ * @param	object	The object to link in
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::push_front(T& object) {
+	m_checkUnlinked(object);
+	
+	T* tmp = m_firstNode;
+	m_firstNode = &object;
+	m_hook(m_firstNode).prev = nullptr;
+	m_hook(m_firstNode).next = tmp;
+	
+	if (tmp != nullptr) {
+		m_hook(tmp).prev = m_firstNode;
+	}
+	
+	if (m_lastNode == nullptr) {
+		m_lastNode = m_firstNode;
+	}
+	
+	++m_size;
+}
+/**
+ * Unlinks the first object from the list.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::pop_front() {
+	if (m_firstNode != nullptr) {
+		remove(*m_firstNode);
+	}
+}
+/**
+ * Links an object in at the end of the list.
+ *
+ * The object must not already be in a list through this hook.
+ *
+ * @throws	MismatchedObjectError	when INTRUSIVELIST_CHECK_OWNERS is on and
+ * 	the object's hook is already linked
+ * @param	object	The object to link in
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::push_back(T& object) {
+	m_checkUnlinked(object);
+	
+	T* tmp = m_lastNode;
+	m_lastNode = &object;
+	m_hook(m_lastNode).prev = tmp;
+	m_hook(m_lastNode).next = nullptr;
+	
+	if (tmp != nullptr) {
+		m_hook(tmp).next = m_lastNode;
+	}
+	
+	if (m_firstNode == nullptr) {
+		m_firstNode = m_lastNode;
+	}
+	
+	++m_size;
+}
+/**
+ * Unlinks the last object from the list.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::pop_back() {
+	if (m_lastNode != nullptr) {
+		remove(*m_lastNode);
+	}
+}
+/**
+ * Links an object into the list before the provided iterator's object.
+ *
+ * When INTRUSIVELIST_CHECK_OWNERS is on and the provided iterator's owner is
+ * not this, an exception is thrown.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this
+ * @throws	MismatchedObjectError	when the object's hook is already linked
+ * @param	location	The position to link the object in front of
+ * @param	object	The object to link in
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::insert(iterator location, T& object) {
+#if INTRUSIVELIST_CHECK_OWNERS
+	if (location.r_owner != this) {
+		throw MismatchedIteratorError();
+	}
+#endif
+	m_checkUnlinked(object);
+
+	if (location.r_node == nullptr) {
+		push_back(object);
+	}
+	else if (location.r_node == m_firstNode) {
+		push_front(object);
+	}
+	else {
+		T* n = &object;
+		m_hook(n).prev = m_hook(location.r_node).prev;
+		m_hook(n).next = location.r_node;
+		m_hook(m_hook(n).prev).next = n;
+		m_hook(location.r_node).prev = n;
+		++m_size;
+	}
+}
+/**
+ * Unlinks the provided iterator's object from the list.
+ *
+ * When INTRUSIVELIST_CHECK_OWNERS is on and the provided iterator's owner is
+ * not this, an exception is thrown.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this
+ * @throws	OutOfBoundsError	when location is the end of the list
+ * @param	location	The object to unlink
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::remove(iterator location) {
+#if INTRUSIVELIST_CHECK_OWNERS
+	if (location.r_owner != this) {
+		throw MismatchedIteratorError();
+	}
+#endif
+
+	FUNDAMENTALS_CHECK_BOUNDS(location.r_node != nullptr);
+	
+	remove(*location.r_node);
+}
+/**
+ * Unlinks an object from the list, straight from its hook.
+ *
+ * The object must be in this list. That can't be fully checked without
+ * walking the list, which would defeat the point, but an object that isn't
+ * linked at all is caught (see m_checkLinked).
+ *
+ * @throws	MismatchedObjectError	when INTRUSIVELIST_CHECK_OWNERS is on and
+ * 	the object can't be in this list
+ * @param	object	The object to unlink
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::remove(T& object) {
+	m_checkLinked(object);
+	
+	IntrusiveList_Hook<T>& hook = m_hook(&object);
+	
+	if (hook.prev != nullptr) {
+		m_hook(hook.prev).next = hook.next;
+	}
+	else {
+		m_firstNode = hook.next;
+	}
+	
+	if (hook.next != nullptr) {
+		m_hook(hook.next).prev = hook.prev;
+	}
+	else {
+		m_lastNode = hook.prev;
+	}
+	
+	hook.prev = nullptr;
+	hook.next = nullptr;
+	--m_size;
+}
+/**
+ * Unlinks every object from the list, leaving their hooks unlinked.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::clear() {
+	T* n = m_firstNode;
+	while (n != nullptr) {
+		T* next = m_hook(n).next;
+		m_hook(n).prev = nullptr;
+		m_hook(n).next = nullptr;
+		n = next;
+	}
+	
+	m_firstNode = nullptr;
+	m_lastNode = nullptr;
+	m_size = 0;
+}
+
+/**
+ * Provides an iterator to the first object of the list.
+ * @return	An iterator to the first object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::begin() {
+	return iterator(m_firstNode, this);
+}
+/**
+ * Provides a read-only iterator to the first object of the list.
+ * @return	A const iterator to the first object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+typename IntrusiveList<T, Hook>::const_iterator IntrusiveList<T, Hook>::begin() const {
+	return const_iterator(m_firstNode, this);
+}
+/**
+ * Provides an iterator to the position after the last object of the list.
+ * @return	An iterator to the end of the list
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::end() {
+	return iterator(nullptr, this);
+}
+/**
+ * Provides a read-only iterator to the position after the last object.
+ * @return	A const iterator to the end of the list
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+typename IntrusiveList<T, Hook>::const_iterator IntrusiveList<T, Hook>::end() const {
+	return const_iterator(nullptr, this);
+}
+/**
+ * Provides an iterator to an object that is already in this list.
+ *
+ * Since the object carries its own links, this doesn't need to search.
+ *
+ * @param	object	An object in this list
+ * @return	An iterator to the object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::iteratorTo(T& object) {
+	return iterator(&object, this);
+}
+
+/**
+ * Provides the first object of the list.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A reference to the first object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+T& IntrusiveList<T, Hook>::front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_firstNode != nullptr);
+	return *m_firstNode;
+}
+/**
+ * Provides the first object of the list, read-only.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A const reference to the first object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+const T& IntrusiveList<T, Hook>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_firstNode != nullptr);
+	return *m_firstNode;
+}
+/**
+ * Provides the last object of the list.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A reference to the last object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+T& IntrusiveList<T, Hook>::back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_lastNode != nullptr);
+	return *m_lastNode;
+}
+/**
+ * Provides the last object of the list, read-only.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A const reference to the last object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+const T& IntrusiveList<T, Hook>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_lastNode != nullptr);
+	return *m_lastNode;
+}
+
+/**
+ * Unlinks this list's objects and takes over another list's.
+ * @param	other	The list to move from, which is left empty
+ * @return	This, after the move
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList<T, Hook>& IntrusiveList<T, Hook>::operator=(IntrusiveList<T, Hook>&& other) {
+	if (this != &other) {
+		clear();
+		m_swap(other);
+	}
+	return *this;
+}
+
+/**
+ * Swaps the member variables of this with those of another IntrusiveList.
+ * @param	other	The list to swap contents with
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::m_swap(IntrusiveList<T, Hook>& other) {
+	std::swap(m_firstNode, other.m_firstNode);
+	std::swap(m_lastNode, other.m_lastNode);
+	std::swap(m_size, other.m_size);
+}
+/**
+ * Checks that an object isn't linked into a list through this hook.
+ *
+ * A hook with a prev or next pointer is in a list. A hook with neither could
+ * still be the only object in a list, which can only be seen for this list.
+ * Nothing is checked unless INTRUSIVELIST_CHECK_OWNERS is on.
+ *
+ * @throws	MismatchedObjectError	when the object is linked
+ * @param	object	The object about to be linked in
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::m_checkUnlinked(T& object) const {
+#if INTRUSIVELIST_CHECK_OWNERS
+	const IntrusiveList_Hook<T>& hook = m_hook(&object);
+	if (hook.prev != nullptr || hook.next != nullptr || m_firstNode == &object) {
+		throw MismatchedObjectError();
+	}
+#else
+	(void)object;
+#endif
+}
+/**
+ * Checks that an object could be linked into this list.
+ *
+ * An object with no prev pointer has to be the first object of this list,
+ * and one with no next pointer has to be the last. This catches objects that
+ * aren't linked at all, and the first and last objects of other lists.
+ * Nothing is checked unless INTRUSIVELIST_CHECK_OWNERS is on.
+ *
+ * @throws	MismatchedObjectError	when the object can't be in this list
+ * @param	object	The object about to be unlinked
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+void IntrusiveList<T, Hook>::m_checkLinked(T& object) const {
+#if INTRUSIVELIST_CHECK_OWNERS
+	const IntrusiveList_Hook<T>& hook = m_hook(&object);
+	if ((hook.prev == nullptr && m_firstNode != &object) || (hook.next == nullptr && m_lastNode != &object)) {
+		throw MismatchedObjectError();
+	}
+#else
+	(void)object;
+#endif
+}
+/**
+ * Provides the links of an object for this list.
+ * @param	object	The object to get the hook of
+ * @return	A reference to the object's hook
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Hook<T>& IntrusiveList<T, Hook>::m_hook(T* object) {
+	return object->*Hook;
+}
+/**
+ * Provides the links of an object for this list, read-only.
+ * @param	object	The object to get the hook of
+ * @return	A const reference to the object's hook
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+const IntrusiveList_Hook<T>& IntrusiveList<T, Hook>::m_hook(const T* object) {
+	return object->*Hook;
+}
+
+// ------------------------------ //
+// IntrusiveList_Iterator methods //
+// ------------------------------ //
+/**
+ * Creates an iterator with no object or owner.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook>::IntrusiveList_Iterator()
+	: r_owner(nullptr), r_node(nullptr)
+{}
+/**
+ * The copy constructor for an intrusive list iterator.
+ * @param	other	The iterator to copy from
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook>::IntrusiveList_Iterator(const IntrusiveList_Iterator<T, Hook>& other)
+	: r_owner(other.r_owner), r_node(other.r_node)
+{}
+/**
+ * Assignement operator from an IntrusiveList_Iterator.
+ * @param	other	The iterator to copy from
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook>& IntrusiveList_Iterator<T, Hook>::operator=(const IntrusiveList_Iterator<T, Hook>& other) {
+	r_owner = other.r_owner;
+	r_node = other.r_node;
+	return *this;
+}
+/**
+ * Constructs an iterator from an object and an owning list.
+ *
+ * This method is private and expected to only be called by an IntrusiveList
+ * in order to create an iterator to one of its objects.
+ *
+ * @param	n	A pointer to the object this iterator should point to
+ * @param	owner	A pointer to the list that this iterator will belong to
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook>::IntrusiveList_Iterator(T* n, IntrusiveList<T, Hook>* owner)
+	: r_owner(owner), r_node(n)
+{}
+
+/**
+ * Dereferences this iterator to get the object it points to.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A reference to the object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+T& IntrusiveList_Iterator<T, Hook>::operator*() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	return *r_node;
+}
+/**
+ * Provides access to the members of the object this iterator points to.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A pointer to the object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+T* IntrusiveList_Iterator<T, Hook>::operator->() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	return r_node;
+}
+
+/**
+ * Moves this iterator to the next object in the list.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	This, after it has moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook>& IntrusiveList_Iterator<T, Hook>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	r_node = (r_node->*Hook).next;
+	
+	return *this;
+}
+/**
+ * Moves this iterator to the next object in the list.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A copy of this before it moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook> IntrusiveList_Iterator<T, Hook>::operator++(int) {
+	IntrusiveList_Iterator<T, Hook> tmp(*this);
+	++(*this);
+	return tmp;
+}
+/**
+ * Moves this iterator to the previous object in the list. From the end of
+ * the list, it moves to the last object.
+ * @throws	OutOfBoundsError	when this is the start of the list
+ * @return	This, after it has moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook>& IntrusiveList_Iterator<T, Hook>::operator--() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != r_owner->m_firstNode);
+	
+	if (r_node == nullptr) {
+		r_node = r_owner->m_lastNode;
+	}
+	else {
+		r_node = (r_node->*Hook).prev;
+	}
+	return *this;
+}
+/**
+ * Moves this iterator to the previous object in the list.
+ * @throws	OutOfBoundsError	when this is the start of the list
+ * @return	A copy of this before it moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_Iterator<T, Hook> IntrusiveList_Iterator<T, Hook>::operator--(int) {
+	IntrusiveList_Iterator<T, Hook> tmp(*this);
+	--(*this);
+	return tmp;
+}
+
+/**
+ * Checks if two iterators are equal.
+ * @return	true if they point to the same owner and object, false otherwise
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_Iterator<T, Hook>::operator==(const IntrusiveList_Iterator<T, Hook>& other) const {
+	return (r_owner == other.r_owner && r_node == other.r_node);
+}
+/**
+ * Checks if two iterators are unequal.
+ * @return	true if they point to different owners or different objects
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_Iterator<T, Hook>::operator!=(const IntrusiveList_Iterator<T, Hook>& other) const {
+	return (r_owner != other.r_owner || r_node != other.r_node);
+}
+/**
+ * Checks if an iterator and a const_iterator are equal.
+ * @return	true if they point to the same owner and object, false otherwise
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_Iterator<T, Hook>::operator==(const IntrusiveList_ConstIterator<T, Hook>& other) const {
+	return (r_owner == other.r_owner && r_node == other.r_node);
+}
+/**
+ * Checks if an iterator and a const_iterator are not equal.
+ * @return	true if they point to different owners or different objects
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_Iterator<T, Hook>::operator!=(const IntrusiveList_ConstIterator<T, Hook>& other) const {
+	return (r_owner != other.r_owner || r_node != other.r_node);
+}
+
+// ----------------------------------- //
+// IntrusiveList_ConstIterator methods //
+// ----------------------------------- //
+/**
+ * Creates a const_iterator with no object or owner.
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>::IntrusiveList_ConstIterator()
+	: r_owner(nullptr), r_node(nullptr)
+{}
+/**
+ * The copy constructor for an intrusive list const_iterator.
+ * @param	other	The const_iterator to copy from
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>::IntrusiveList_ConstIterator(const IntrusiveList_ConstIterator<T, Hook>& other)
+	: r_owner(other.r_owner), r_node(other.r_node)
+{}
+/**
+ * Constructs a const_iterator from an iterator.
+ * @param	other	The iterator to copy from
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>::IntrusiveList_ConstIterator(const IntrusiveList_Iterator<T, Hook>& other)
+	: r_owner(other.r_owner), r_node(other.r_node)
+{}
+/**
+ * Constructs a const_iterator from an object and an owning list.
+ *
+ * This method is private and expected to only be called by an IntrusiveList
+ * in order to create a const_iterator to one of its objects.
+ *
+ * @param	n	A pointer to the object this iterator should point to
+ * @param	owner	A pointer to the list that this iterator will belong to
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>::IntrusiveList_ConstIterator(const T* n, const IntrusiveList<T, Hook>* owner)
+	: r_owner(owner), r_node(n)
+{}
+/**
+ * Assignment operator from an IntrusiveList_ConstIterator.
+ * @param	other	A const_iterator to copy from
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>& IntrusiveList_ConstIterator<T, Hook>::operator=(const IntrusiveList_ConstIterator<T, Hook>& other) {
+	r_owner = other.r_owner;
+	r_node = other.r_node;
+	return *this;
+}
+/**
+ * Assignemnt operator from an IntrusiveList_Iterator.
+ * @param	other	An iterator to copy from
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>& IntrusiveList_ConstIterator<T, Hook>::operator=(const IntrusiveList_Iterator<T, Hook>& other) {
+	r_owner = other.r_owner;
+	r_node = other.r_node;
+	return *this;
+}
+
+/**
+ * Dereferences this const_iterator to get the object it points to.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A const reference to the object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+const T& IntrusiveList_ConstIterator<T, Hook>::operator*() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	return *r_node;
+}
+/**
+ * Provides read-only access to the members of the object this points to.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A const pointer to the object
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+const T* IntrusiveList_ConstIterator<T, Hook>::operator->() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	return r_node;
+}
+
+/**
+ * Moves this const_iterator to the next object in the list.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	This, after it has moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>& IntrusiveList_ConstIterator<T, Hook>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	r_node = (r_node->*Hook).next;
+	
+	return *this;
+}
+/**
+ * Moves this const_iterator to the next object in the list.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A copy of this before it moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook> IntrusiveList_ConstIterator<T, Hook>::operator++(int) {
+	IntrusiveList_ConstIterator<T, Hook> tmp(*this);
+	++(*this);
+	return tmp;
+}
+/**
+ * Moves this const_iterator to the previous object in the list. From the end
+ * of the list, it moves to the last object.
+ * @throws	OutOfBoundsError	when this is the start of the list
+ * @return	This, after it has moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook>& IntrusiveList_ConstIterator<T, Hook>::operator--() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != r_owner->m_firstNode);
+	
+	if (r_node == nullptr) {
+		r_node = r_owner->m_lastNode;
+	}
+	else {
+		r_node = (r_node->*Hook).prev;
+	}
+	return *this;
+}
+/**
+ * Moves this const_iterator to the previous object in the list.
+ * @throws	OutOfBoundsError	when this is the start of the list
+ * @return	A copy of this before it moved
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+IntrusiveList_ConstIterator<T, Hook> IntrusiveList_ConstIterator<T, Hook>::operator--(int) {
+	IntrusiveList_ConstIterator<T, Hook> tmp(*this);
+	--(*this);
+	return tmp;
+}
+
+/**
+ * Checks if two const_iterators are equal.
+ * @return	true if they point to the same owner and object, false otherwise
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_ConstIterator<T, Hook>::operator==(const IntrusiveList_ConstIterator<T, Hook>& other) const {
+	return (r_owner == other.r_owner && r_node == other.r_node);
+}
+/**
+ * Checks if two const_iterators are unequal.
+ * @return	true if they point to different owners or different objects
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_ConstIterator<T, Hook>::operator!=(const IntrusiveList_ConstIterator<T, Hook>& other) const {
+	return (r_owner != other.r_owner || r_node != other.r_node);
+}
+/**
+ * Checks if a const_iterator and an iterator are equal.
+ * @return	true if they point to the same owner and object, false otherwise
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_ConstIterator<T, Hook>::operator==(const IntrusiveList_Iterator<T, Hook>& other) const {
+	return (r_owner == other.r_owner && r_node == other.r_node);
+}
+/**
+ * Checks if a const_iterator and an iterator are not equal.
+ * @return	true if they point to different owners or different objects
+ */
+template <typename T, IntrusiveList_Hook<T> T::* Hook>
+bool IntrusiveList_ConstIterator<T, Hook>::operator!=(const IntrusiveList_Iterator<T, Hook>& other) const {
+	return (r_owner != other.r_owner || r_node != other.r_node);
+}
+
+#endif // Fundamentals_IntrusiveList_hpp_
@@ -6,19 +6,42 @@
  * It is intended as a reference for those looking to brush up on important
  * data structures.
  */
+/**
+ * The nodes are allocated with a rebound copy of the Allocator, which
+ * defaults to std::allocator. The data on each node is constructed through
+ * the allocator as well (see Allocation.hpp).
+ *
+ * Rather than allocating each node on its own, a list gets its nodes from a
+ * LinkedList_NodePool. The pool allocates nodes in blocks (slabs), and keeps
+ * nodes that have been removed from the list on a free list to be used
+ * again. Nodes that are made around the same time end up next to each other
+ * in memory, which makes walking the list much friendlier to the cache.
+ *
+ * We will be using std::shared_ptr and std::vector for the pool.
+ */
 
 #include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
 
+#include "Allocation.hpp"
+#include "Checks.hpp"
 #include "Exceptions.hpp"
 
 #ifndef Fundamentals_LinkedList_hpp_
 #define Fundamentals_LinkedList_hpp_
 
+// The number of nodes in the first slab of a pool. Each slab after that is
+// twice as big as the last, up to the maximum.
+#define LINKEDLIST_POOL_MIN_SLAB 16
+#define LINKEDLIST_POOL_MAX_SLAB 4096
+
 // Forward declaration of the LinkedList class.
-template <typename T> class LinkedList;
+template <typename T, typename Allocator = std::allocator<T>> class LinkedList;
 // Forward declaration of our two iterator classes.
-template <typename T> class LinkedList_Iterator;
-template <typename T> class LinkedList_ConstIterator;
+template <typename T, typename Allocator = std::allocator<T>> class LinkedList_Iterator;
+template <typename T, typename Allocator = std::allocator<T>> class LinkedList_ConstIterator;
 
 /**
  * A small simple structure that LinkedLists can use.
@@ -33,24 +56,111 @@ struct LinkedList_Node {
 	struct LinkedList_Node<T>* next;
 };
 
+/**
+ * A pool of memory for the nodes of one or more LinkedLists.
+ *
+ * The pool only deals in memory. The list constructs and destroys the data
+ * on each node, and the pool hands out and takes back the memory for them.
+ * Free nodes are linked together through their next pointers.
+ *
+ * The slabs are kept in a separately reference-counted block of memory, so
+ * that a pool can adopt the slabs of another pool. A list that takes nodes
+ * out of another list uses this to keep the memory for those nodes alive
+ * after the other list (and its pool) are gone.
+ *
+ * A pool can be shared between lists (see LinkedList::nodePool), but none of
+ * its methods are thread-safe.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class LinkedList_NodePool {
+	public:
+		typedef size_t size_type;
+		typedef LinkedList_Node<T> Node;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+		
+		// Constructor
+		LinkedList_NodePool(const NodeAllocator& allocator);
+		
+		// A pool owns its slabs, so it can't be copied
+		LinkedList_NodePool(const LinkedList_NodePool<T, Allocator>& other) = delete;
+		LinkedList_NodePool<T, Allocator>& operator=(const LinkedList_NodePool<T, Allocator>& other) = delete;
+		
+		// Handing out and taking back nodes
+		Node* allocate();
+		void deallocate(Node* node);
+		
+		// Makes sure there are enough free nodes, with at most one new slab
+		void reserve(size_type count);
+		// Keeps the slabs of another pool alive for as long as this pool
+		void adopt(const LinkedList_NodePool<T, Allocator>& other);
+		
+		// The number of nodes that can be handed out without a new slab
+		size_type available() const;
+		// The allocator the slabs come from
+		const NodeAllocator& get_allocator() const;
+		
+	private:
+		typedef std::allocator_traits<NodeAllocator> node_traits;
+		
+		/**
+		 * The slabs allocated by one pool, freed when no pool refers to them.
+		 */
+		struct Slabs {
+			typedef typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<Node*, size_type>> BlockAllocator;
+			
+			NodeAllocator allocator;
+			std::vector<std::pair<Node*, size_type>, BlockAllocator> blocks;
+			
+			Slabs(const NodeAllocator& a_allocator);
+			~Slabs();
+		};
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Slabs> SlabsAllocator;
+		typedef std::shared_ptr<Slabs> SlabsPointer;
+		
+		// The free list, made of nodes that were handed back.
+		Node* mp_free;
+		size_type m_freeCount;
+		// The part of the newest slab that hasn't been handed out yet.
+		Node* mp_unused;
+		size_type m_unusedCount;
+		// The size of the next slab to allocate.
+		size_type m_nextSlab;
+		// The slabs this pool allocated, followed by any it adopted.
+		std::vector<SlabsPointer> m_slabs;
+		
+		// Allocates a new slab for this pool.
+		void m_grow(size_type count);
+};
+
 /**
  * A doubly-linked list with bidirectional iterators.
  */
-template <typename T>
-class LinkedList {
+template <typename T, typename Allocator>
+class LinkedList : private AllocatorHolder<typename std::allocator_traits<Allocator>::template rebind_alloc<LinkedList_Node<T>>> {
 	public:
 		typedef size_t size_type;
-		typedef LinkedList_Iterator<T> iterator;
-		typedef LinkedList_ConstIterator<T> const_iterator;
+		typedef Allocator allocator_type;
+		typedef LinkedList_Iterator<T, Allocator> iterator;
+		typedef LinkedList_ConstIterator<T, Allocator> const_iterator;
 		
 		// Constructors and Destructor
 		LinkedList();
-		LinkedList(size_type size);
-		LinkedList(size_type size, const T& value);
-		LinkedList(const LinkedList<T>& other);
-		LinkedList(LinkedList<T>&& other);
+		explicit LinkedList(const allocator_type& allocator);
+		LinkedList(size_type size, const allocator_type& allocator = allocator_type());
+		LinkedList(size_type size, const T& value, const allocator_type& allocator = allocator_type());
+		LinkedList(const LinkedList<T, Allocator>& other);
+		LinkedList(const LinkedList<T, Allocator>& other, const allocator_type& allocator);
+		LinkedList(LinkedList<T, Allocator>&& other);
 		~LinkedList();
 		
+		// Access to the allocator
+		allocator_type get_allocator() const;
+		
+		// Sharing the pool that nodes are allocated from
+		typedef LinkedList_NodePool<T, Allocator> pool_type;
+		explicit LinkedList(const std::shared_ptr<pool_type>& pool);
+		std::shared_ptr<pool_type> nodePool();
+		
 		// Access to current size
 		size_type size() const;
 		bool empty() const;
@@ -66,6 +176,19 @@ class LinkedList {
 		void insert(iterator location, const T& value);
 		void remove(iterator location);
 		
+		// Moving nodes from another list without copying them.
+		void splice(iterator location, LinkedList<T, Allocator>& other);
+		void splice(iterator location, LinkedList<T, Allocator>& other, iterator element);
+		void splice(iterator location, LinkedList<T, Allocator>& other, iterator first, iterator last);
+		
+		// Reordering by relinking nodes.
+		void merge(LinkedList<T, Allocator>& other);
+		template <typename Compare>
+		void merge(LinkedList<T, Allocator>& other, Compare compare);
+		void sort();
+		template <typename Compare>
+		void sort(Compare compare);
+		
 		// Iterators to the start and end of the list
 		iterator begin();
 		const_iterator begin() const;
@@ -80,113 +203,143 @@ class LinkedList {
 		
 		// Operators
 		// - Asssignment
-		LinkedList<T>& operator=(const LinkedList<T>& other);
-		LinkedList<T>& operator=(LinkedList<T>&& other);
+		LinkedList<T, Allocator>& operator=(const LinkedList<T, Allocator>& other);
+		LinkedList<T, Allocator>& operator=(LinkedList<T, Allocator>&& other);
 		// - Equality testing
-		bool operator==(const LinkedList<T>& other) const;
-		bool operator!=(const LinkedList<T>& other) const;
+		bool operator==(const LinkedList<T, Allocator>& other) const;
+		bool operator!=(const LinkedList<T, Allocator>& other) const;
 		
 	private:
 		typedef LinkedList_Node<T> Node;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+		typedef std::allocator_traits<NodeAllocator> node_traits;
 		
 		Node* m_firstNode;
 		Node* m_lastNode;
 		size_type m_size;
+		// The pool for this list's nodes, made when the first node is.
+		std::shared_ptr<pool_type> mp_pool;
+		
+		// Provides the pool, making one if this list doesn't have one yet.
+		pool_type& m_pool();
 		
 		void m_initialize(size_type a_size, const T& a_value);
-		void m_swap(LinkedList<T>& other);
+		void m_copyFrom(const LinkedList<T, Allocator>& other);
+		void m_swap(LinkedList<T, Allocator>& other);
+		
+		// Gets a node from the pool and constructs its data.
+		Node* m_createNode(const T& value, Node* prev, Node* next);
+		// Destroys a node's data and gives the node back to the pool.
+		void m_destroyNode(Node* node);
+		
+		// Utilities for moving nodes around without copying them.
+		// - Makes sure nodes from another list can be kept by this one.
+		void m_adopt(const LinkedList<T, Allocator>& other);
+		// - Takes a run of nodes out of this list, from first to last inclusive.
+		void m_unlink(Node* first, Node* last);
+		// - Puts a run of unlinked nodes into this list before a node.
+		void m_link(Node* before, Node* first, Node* last);
+		// - Merges two runs that are only linked by their next pointers.
+		template <typename Compare>
+		static Node* m_mergeRuns(Node*& a, Node*& b, Compare& compare);
+		// - Rebuilds the prev pointers of this list from a run of next pointers.
+		void m_relink(Node* first);
+		
+	// The iterators need to see the ends of their owner.
+	friend class LinkedList_Iterator<T, Allocator>;
+	friend class LinkedList_ConstIterator<T, Allocator>;
 };
 
 /**
  * An iterator over a LinkedList that provides read-write data access.
  */
-template <typename T>
+template <typename T, typename Allocator>
 class LinkedList_Iterator {
 	public:
 		// Constructors
 		LinkedList_Iterator();
-		LinkedList_Iterator(const LinkedList_Iterator<T>& other);
+		LinkedList_Iterator(const LinkedList_Iterator<T, Allocator>& other);
 		
 		// Assignement operator
-		LinkedList_Iterator<T>& operator=(const LinkedList_Iterator<T>& other);
+		LinkedList_Iterator<T, Allocator>& operator=(const LinkedList_Iterator<T, Allocator>& other);
 		
 		// Equality test operators
-		bool operator==(const LinkedList_Iterator<T>& other) const;
-		bool operator!=(const LinkedList_Iterator<T>& other) const;
-		bool operator==(const LinkedList_ConstIterator<T>& other) const;
-		bool operator!=(const LinkedList_ConstIterator<T>& other) const;
+		bool operator==(const LinkedList_Iterator<T, Allocator>& other) const;
+		bool operator!=(const LinkedList_Iterator<T, Allocator>& other) const;
+		bool operator==(const LinkedList_ConstIterator<T, Allocator>& other) const;
+		bool operator!=(const LinkedList_ConstIterator<T, Allocator>& other) const;
 		
 		// Data access
 		T& operator*() const;
 		T* operator->() const;
 		
 		// Increment and Decrement operators
-		LinkedList_Iterator<T>& operator++();
-		LinkedList_Iterator<T> operator++(int);
-		LinkedList_Iterator<T>& operator--();
-		LinkedList_Iterator<T> operator--(int);
+		LinkedList_Iterator<T, Allocator>& operator++();
+		LinkedList_Iterator<T, Allocator> operator++(int);
+		LinkedList_Iterator<T, Allocator>& operator--();
+		LinkedList_Iterator<T, Allocator> operator--(int);
 	private:
 		typedef struct LinkedList_Node<T> Node;
 		// The linked list which the node in this iterator belongs to.
-		LinkedList<T>* r_owner;
+		LinkedList<T, Allocator>* r_owner;
 		// The node this iterator is pointing to.
 		Node* r_node;
 		
 		// Node-and-owner constructor
 		// This is on its own in the private section because
 		// the user should not call it, but it is used by the LinkedList class.
-		LinkedList_Iterator(Node* n, LinkedList<T>* owner);
-	
+		LinkedList_Iterator(Node* n, LinkedList<T, Allocator>* owner);
+		
 	// LinkedList and LinkedList_ConstIterator both need access to private
 	// members of this class.
-	friend class LinkedList<T>;
-	friend class LinkedList_ConstIterator<T>;
+	friend class LinkedList<T, Allocator>;
+	friend class LinkedList_ConstIterator<T, Allocator>;
 };
 
 /**
  * An iterator over a LinkedList that provides read-only data access.
  */
-template <typename T>
+template <typename T, typename Allocator>
 class LinkedList_ConstIterator {
 	public:
 		// Constructors
 		LinkedList_ConstIterator();
-		LinkedList_ConstIterator(const LinkedList_ConstIterator<T>& other);
-		LinkedList_ConstIterator(const LinkedList_Iterator<T> &other);
+		LinkedList_ConstIterator(const LinkedList_ConstIterator<T, Allocator>& other);
+		LinkedList_ConstIterator(const LinkedList_Iterator<T, Allocator> &other);
 		
 		// Assignemnt operators
-		LinkedList_ConstIterator<T>& operator=(const LinkedList_ConstIterator<T>& other);
-		LinkedList_ConstIterator<T>& operator=(const LinkedList_Iterator<T>& other);
+		LinkedList_ConstIterator<T, Allocator>& operator=(const LinkedList_ConstIterator<T, Allocator>& other);
+		LinkedList_ConstIterator<T, Allocator>& operator=(const LinkedList_Iterator<T, Allocator>& other);
 		
 		// Equality test operators
-		bool operator==(const LinkedList_ConstIterator<T>& other) const;
-		bool operator!=(const LinkedList_ConstIterator<T>& other) const;
-		bool operator==(const LinkedList_Iterator<T>& other) const;
-		bool operator!=(const LinkedList_Iterator<T>& other) const;
+		bool operator==(const LinkedList_ConstIterator<T, Allocator>& other) const;
+		bool operator!=(const LinkedList_ConstIterator<T, Allocator>& other) const;
+		bool operator==(const LinkedList_Iterator<T, Allocator>& other) const;
+		bool operator!=(const LinkedList_Iterator<T, Allocator>& other) const;
 		
 		// Data access operators
 		const T& operator*() const;
 		const T* operator->() const;
 		
 		// Increment and Decrement operators
-		LinkedList_ConstIterator<T>& operator++();
-		LinkedList_ConstIterator<T> operator++(int);
-		LinkedList_ConstIterator<T>& operator--();
-		LinkedList_ConstIterator<T> operator--(int);
+		LinkedList_ConstIterator<T, Allocator>& operator++();
+		LinkedList_ConstIterator<T, Allocator> operator++(int);
+		LinkedList_ConstIterator<T, Allocator>& operator--();
+		LinkedList_ConstIterator<T, Allocator> operator--(int);
 	private:
 		typedef struct LinkedList_Node<T> Node;
-		const LinkedList<T>* r_owner;
+		const LinkedList<T, Allocator>* r_owner;
 		const Node* r_node;
 		
 		// Node-and-owner constructor
 		// This is on its own in the private section because
 		// the user should not call it, but it is used by the LinkedList class.
-		LinkedList_ConstIterator(const Node* n, const LinkedList<T>* owner);
-	
+		LinkedList_ConstIterator(const Node* n, const LinkedList<T, Allocator>* owner);
+		
 	// LinkedList and LinkedList_Iterator both need access to private
 	// members of this class.
-	friend class LinkedList<T>;
-	friend class LinkedList_Iterator<T>;
+	friend class LinkedList<T, Allocator>;
+	friend class LinkedList_Iterator<T, Allocator>;
 };
 
 // ------------------- //
@@ -195,21 +348,42 @@ class LinkedList_ConstIterator {
 /**
  * Constructs an empty LinkedList
  */
-template <typename T>
-LinkedList<T>::LinkedList() {
-	m_firstNode = nullptr;
-	m_lastNode = nullptr;
-	m_size = 0;
-}
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList()
+	: LinkedList(allocator_type())
+{}
+/**
+ * Constructs an empty LinkedList that gets its nodes from an allocator.
+ * @param	allocator	The allocator for the list to use
+ */
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(const allocator_type& allocator)
+	: AllocatorHolder<NodeAllocator>(NodeAllocator(allocator)), m_firstNode(nullptr), m_lastNode(nullptr), m_size(0)
+{}
+/**
+ * Constructs an empty LinkedList that gets its nodes from an existing pool.
+ *
+ * Lists that share a pool share their free nodes, and can move nodes between
+ * each other without adopting any slabs. The list uses the pool's allocator.
+ *
+ * @param	pool	The pool for the list to allocate nodes from
+ */
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(const std::shared_ptr<pool_type>& pool)
+	: AllocatorHolder<NodeAllocator>(pool->get_allocator()), m_firstNode(nullptr), m_lastNode(nullptr), m_size(0), mp_pool(pool)
+{}
 /**
  * Constructs a LinkedList with a known starting size.
  *
  * Nodes initially in the list will have default-constructed data.
  *
  * @param	size	The number of nodes to be created initially
+ * @param	allocator	The allocator for the list to use
  */
-template <typename T>
-LinkedList<T>::LinkedList(size_type size) {
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(size_type size, const allocator_type& allocator)
+	: LinkedList(allocator)
+{
 	m_initialize(size, T());
 }
 /**
@@ -219,49 +393,51 @@ LinkedList<T>::LinkedList(size_type size) {
  *
  * @param	size	The number of nodes to create
  * @param	value	The value to copy to the starting nodes
+ * @param	allocator	The allocator for the list to use
  */
-template <typename T>
-LinkedList<T>::LinkedList(size_type size, const T& value) {
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(size_type size, const T& value, const allocator_type& allocator)
+	: LinkedList(allocator)
+{
 	m_initialize(size, value);
 }
 /**
  * Constructs a LinkedList by copying another element-wise.
+ *
+ * The allocator is copied the way std::allocator_traits says it should be
+ * for a container copy.
+ *
  * @param	other	The LinkedList to copy from
  */
-template <typename T>
-LinkedList<T>::LinkedList(const LinkedList<T>& other) {
-	if (other.m_firstNode != nullptr) {
-		// Initialize our two swap variables.
-		Node* curr = nullptr;
-		Node* prev;
-		
-		// Iterate forward, link backwards
-		for (const Node* n_other = other.m_firstNode; n_other != nullptr; n_other = n_other->next) {
-			prev = curr;
-			curr = new Node { n_other->data, prev, nullptr };
-		}
-		
-		m_lastNode = curr;
-		
-		// Iterate backwards, link forwards
-		while (curr->prev != nullptr) {
-			curr->prev->next = curr;
-			curr = curr->prev;
-		}
-		
-		m_firstNode = curr;
-	}
-	
-	m_size = other.m_size;
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(const LinkedList<T, Allocator>& other)
+	: LinkedList(allocator_type(node_traits::select_on_container_copy_construction(other.allocator())))
+{
+	m_copyFrom(other);
+}
+/**
+ * Constructs a LinkedList by copying another, using a different allocator.
+ * @param	other	The LinkedList to copy from
+ * @param	allocator	The allocator for the copy to use
+ */
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(const LinkedList<T, Allocator>& other, const allocator_type& allocator)
+	: LinkedList(allocator)
+{
+	m_copyFrom(other);
 }
 /**
  * Constructs a LinkedList by swapping members with another.
+ *
+ * The allocator is copied from the other list, so the nodes can be freed by
+ * either of them.
+ *
  * @param	other	The LinkedList to swap with
  */
-template <typename T>
-LinkedList<T>::LinkedList(LinkedList<T>&& other) {
-	m_firstNode = nullptr;
-	
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::LinkedList(LinkedList<T, Allocator>&& other)
+	: LinkedList(allocator_type(other.allocator()))
+{
 	m_swap(other);
 }
 /**
@@ -269,29 +445,51 @@ LinkedList<T>::LinkedList(LinkedList<T>&& other) {
  *
  * Clears the contents of this list so memory is not leaked.
  */
-template <typename T>
-LinkedList<T>::~LinkedList() {
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>::~LinkedList() {
 	while (m_firstNode != nullptr) {
 		Node* tmp = m_firstNode;
 		m_firstNode = m_firstNode->next;
-		delete tmp;
+		m_destroyNode(tmp);
 	}
 }
 
+/**
+ * Provides the pool this list allocates its nodes from.
+ *
+ * The pool can be passed to the constructor of another list, so that both
+ * lists share it.
+ *
+ * @return	A shared pointer to the pool of this list
+ */
+template <typename T, typename Allocator>
+std::shared_ptr<typename LinkedList<T, Allocator>::pool_type> LinkedList<T, Allocator>::nodePool() {
+	m_pool();
+	return mp_pool;
+}
+/**
+ * Provides a copy of the allocator this list uses for its nodes.
+ * @return	The allocator of the list
+ */
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::allocator_type LinkedList<T, Allocator>::get_allocator() const {
+	return allocator_type(this->allocator());
+}
+
 /**
  * Gets the size of the linked list for the user.
  * @return	The number of nodes in the list
  */
-template <typename T>
-typename LinkedList<T>::size_type LinkedList<T>::size() const {
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::size_type LinkedList<T, Allocator>::size() const {
 	return m_size;
 }
 /**
  * Reports whether or not the list is empty.
  * @return	Whether or not there are any nodes in the list
  */
-template <typename T>
-bool LinkedList<T>::empty() const {
+template <typename T, typename Allocator>
+bool LinkedList<T, Allocator>::empty() const {
 	return m_firstNode == nullptr;
 }
 
@@ -299,13 +497,14 @@ bool LinkedList<T>::empty() const {
  * Adds a new node at the start of the list with specified data.
  * @param	value	The data that the new node should hold
  */
-template <typename T>
-void LinkedList<T>::push_front(const T& value) {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::push_front(const T& value) {
 	Node* tmp = m_firstNode;
-	m_firstNode = new Node;
-	m_firstNode->data = value;
-	m_firstNode->prev = nullptr;
-	m_firstNode->next = tmp;
+	m_firstNode = m_createNode(value, nullptr, tmp);
+	
+	if (tmp != nullptr) {
+		tmp->prev = m_firstNode;
+	}
 	
 	if (m_lastNode == nullptr) {
 		m_lastNode = m_firstNode;
@@ -316,8 +515,8 @@ void LinkedList<T>::push_front(const T& value) {
 /**
  * Removes the first node from the list.
  */
-template <typename T>
-void LinkedList<T>::pop_front() {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::pop_front() {
 	if (m_firstNode != nullptr) {
 		Node* tmp = m_firstNode;
 		m_firstNode = m_firstNode->next;
@@ -331,20 +530,17 @@ void LinkedList<T>::pop_front() {
 		}
 		
 		--m_size;
-		delete tmp;
+		m_destroyNode(tmp);
 	}
 }
 /**
  * Adds a new node at the end of the list with specified data.
  * @param	value	The data that the new node should hold
  */
-template <typename T>
-void LinkedList<T>::push_back(const T& value) {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::push_back(const T& value) {
 	Node* tmp = m_lastNode;
-	m_lastNode = new Node;
-	m_lastNode->data = value;
-	m_lastNode->prev = tmp;
-	m_lastNode->next = nullptr;
+	m_lastNode = m_createNode(value, tmp, nullptr);
 	
 	if (tmp != nullptr) {
 		tmp->next = m_lastNode;
@@ -359,8 +555,8 @@ void LinkedList<T>::push_back(const T& value) {
 /**
  * Removes a node from the end of the list.
  */
-template <typename T>
-void LinkedList<T>::pop_back() {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::pop_back() {
 	if (m_lastNode != nullptr) {
 		Node* tmp = m_lastNode;
 		m_lastNode = m_lastNode->prev;
@@ -374,7 +570,7 @@ void LinkedList<T>::pop_back() {
 		}
 		
 		--m_size;
-		delete tmp;
+		m_destroyNode(tmp);
 	}
 }
 /**
@@ -387,8 +583,8 @@ void LinkedList<T>::pop_back() {
  * This check is not performed by std::list, which can result in a
  * std::list having an inconsistent state (size != number of nodes).
  */
-template <typename T>
-void LinkedList<T>::insert(iterator location, const T& value) {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::insert(iterator location, const T& value) {
 	if (location.r_owner != this) {
 		throw MismatchedIteratorError();
 	}
@@ -400,17 +596,14 @@ void LinkedList<T>::insert(iterator location, const T& value) {
 		push_front(value);
 	}
 	else {
-		Node* n = new Node;
-		n->data = value;
-		n->next = location.r_node;
-		n->prev = n->next->prev;
+		Node* n = m_createNode(value, location.r_node->prev, location.r_node);
 		n->next->prev = n;
 		n->prev->next = n;
 		++m_size;
 	}
 }
 /**
- * Removes the node before the provided iterator's node from the list.
+ * Removes the provided iterator's node from the list.
  *
  * If the provided iterator is the end or the beginning of the list,
  * this will use the dedicated method to adding to those locations.
@@ -419,8 +612,8 @@ void LinkedList<T>::insert(iterator location, const T& value) {
  * This check is not performed by std::list, which can result in a
  * std::list having an inconsistent state (size != number of nodes).
  */
-template <typename T>
-void LinkedList<T>::remove(iterator location) {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::remove(iterator location) {
 	if (location.r_owner != this) {
 		throw MismatchedIteratorError();
 	}
@@ -439,24 +632,280 @@ void LinkedList<T>::remove(iterator location) {
 		if (n->next != nullptr) {
 			n->next->prev = n->prev;
 		}
-		delete n;
+		--m_size;
+		m_destroyNode(n);
 	}
 }
 
+/**
+ * Moves every node of another list into this one, before an iterator.
+ *
+ * No nodes are copied or allocated, they are just relinked. The other list
+ * is left empty, and this takes constant time. Iterators to the moved nodes
+ * still name the other list as their owner, so they can't be passed to this
+ * list's methods. Splicing a list into itself does nothing.
+ *
+ * The lists must have equal allocators, so that this list can destroy the
+ * data of nodes the other list constructed.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this
+ * @throws	MismatchedAllocatorError	when the allocators aren't equal
+ * @param	location	The position to move the nodes in front of
+ * @param	other	The list to take the nodes from
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::splice(iterator location, LinkedList<T, Allocator>& other) {
+	if (location.r_owner != this) {
+		throw MismatchedIteratorError();
+	}
+	
+	if (&other == this || other.m_firstNode == nullptr) {
+		return;
+	}
+	
+	m_adopt(other);
+	
+	// The other list already knows how many nodes it has, so unlike a range
+	// splice there's nothing to count
+	Node* firstNode = other.m_firstNode;
+	Node* lastNode = other.m_lastNode;
+	
+	m_size += other.m_size;
+	other.m_firstNode = nullptr;
+	other.m_lastNode = nullptr;
+	other.m_size = 0;
+	
+	m_link(location.r_node, firstNode, lastNode);
+}
+/**
+ * Moves one node of another list into this one, before an iterator.
+ *
+ * The other list can be this list, in which case the node is moved within it.
+ * Moving a node to where it already is (in front of itself or of the node
+ * after it) does nothing.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this or
+ * 	element's owner is not other
+ * @throws	MismatchedAllocatorError	when the allocators aren't equal
+ * @throws	OutOfBoundsError	when element is the end of other
+ * @param	location	The position to move the node in front of
+ * @param	other	The list to take the node from
+ * @param	element	The node to move
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::splice(iterator location, LinkedList<T, Allocator>& other, iterator element) {
+	if (location.r_owner != this || element.r_owner != &other) {
+		throw MismatchedIteratorError();
+	}
+	FUNDAMENTALS_CHECK_BOUNDS(element.r_node != nullptr);
+	
+	iterator next = element;
+	++next;
+	
+	if (location == element || location == next) {
+		return;
+	}
+	
+	splice(location, other, element, next);
+}
+/**
+ * Moves a range of nodes of another list into this one, before an iterator.
+ *
+ * The range runs from first up to, but not including, last. The other list
+ * can be this list, as long as location isn't strictly inside the range.
+ * Moving a range to in front of its own first node or the node after it
+ * does nothing.
+ *
+ * Moving nodes between different lists takes time proportional to the
+ * length of the range, since it has to be counted to keep both sizes right.
+ * The relinking itself only touches the ends of the range.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this or
+ * 	the range's owner is not other
+ * @throws	MismatchedAllocatorError	when the allocators aren't equal
+ * @param	location	The position to move the nodes in front of
+ * @param	other	The list to take the nodes from
+ * @param	first	The first node to move
+ * @param	last	The node after the last one to move
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::splice(iterator location, LinkedList<T, Allocator>& other, iterator first, iterator last) {
+	if (location.r_owner != this || first.r_owner != &other || last.r_owner != &other) {
+		throw MismatchedIteratorError();
+	}
+	
+	if (first == last || location == last || (&other == this && location == first)) {
+		return;
+	}
+	
+	Node* firstNode = first.r_node;
+	Node* lastNode = (last.r_node == nullptr) ? other.m_lastNode : last.r_node->prev;
+	
+	if (&other != this) {
+		m_adopt(other);
+		
+		size_type count = 1;
+		for (Node* n = firstNode; n != lastNode; n = n->next) {
+			++count;
+		}
+		
+		other.m_size -= count;
+		m_size += count;
+	}
+	
+	other.m_unlink(firstNode, lastNode);
+	m_link(location.r_node, firstNode, lastNode);
+}
+
+/**
+ * Merges another sorted list into this sorted list, using operator<.
+ * @throws	MismatchedAllocatorError	when the allocators aren't equal
+ * @param	other	The list to merge in, which is left empty
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::merge(LinkedList<T, Allocator>& other) {
+	merge(other, [](const T& a, const T& b) { return a < b; });
+}
+/**
+ * Merges another sorted list into this sorted list.
+ *
+ * Both lists must already be sorted by the comparison. The merge is stable:
+ * nodes that compare equal keep their order, with this list's nodes first.
+ * Only the links between nodes change, so no data is copied or moved.
+ *
+ * If the comparison throws, every node ends up in this list, but not
+ * necessarily in order.
+ *
+ * @throws	MismatchedAllocatorError	when the allocators aren't equal
+ * @param	other	The list to merge in, which is left empty
+ * @param	compare	A function object that returns whether a < b
+ */
+template <typename T, typename Allocator>
+template <typename Compare>
+void LinkedList<T, Allocator>::merge(LinkedList<T, Allocator>& other, Compare compare) {
+	if (&other == this || other.m_firstNode == nullptr) {
+		return;
+	}
+	
+	m_adopt(other);
+	
+	Node* a = m_firstNode;
+	Node* b = other.m_firstNode;
+	
+	m_size += other.m_size;
+	other.m_firstNode = nullptr;
+	other.m_lastNode = nullptr;
+	other.m_size = 0;
+	
+	try {
+		m_relink(m_mergeRuns(a, b, compare));
+	}
+	catch (...) {
+		// m_mergeRuns leaves every node in a when it throws
+		m_relink(a);
+		throw;
+	}
+}
+/**
+ * Sorts this list using operator<.
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::sort() {
+	sort([](const T& a, const T& b) { return a < b; });
+}
+/**
+ * Sorts this list with a stable merge sort that only relinks the nodes.
+ *
+ * This works bottom-up, like a binary counter. Each node is added to the
+ * run in the first bin, and whenever a bin already has a run the two are
+ * merged and carried up to the next bin. Bin i holds a run of 2^i nodes, so
+ * 64 of them are enough for any list. The bins are merged together at the
+ * end. While sorting, only the next pointers are kept up to date, and the
+ * prev pointers are rebuilt in one pass afterwards.
+ *
+ * If the comparison throws, every node is still in the list, but not
+ * necessarily in order.
+ *
+ * @param	compare	A function object that returns whether a < b
+ */
+template <typename T, typename Allocator>
+template <typename Compare>
+void LinkedList<T, Allocator>::sort(Compare compare) {
+	if (m_size < 2) {
+		return;
+	}
+	
+	Node* bins[64] = {};
+	Node* carry = nullptr;
+	Node* rest = m_firstNode;
+	
+	try {
+		while (rest != nullptr) {
+			carry = rest;
+			rest = rest->next;
+			carry->next = nullptr;
+			
+			// Earlier nodes are always in the bins, so they go first
+			size_type i = 0;
+			for (; bins[i] != nullptr; ++i) {
+				carry = m_mergeRuns(bins[i], carry, compare);
+				bins[i] = nullptr;
+			}
+			bins[i] = carry;
+			carry = nullptr;
+		}
+		
+		for (size_type i = 0; i < 64; ++i) {
+			if (bins[i] != nullptr) {
+				carry = m_mergeRuns(bins[i], carry, compare);
+				bins[i] = nullptr;
+			}
+		}
+	}
+	catch (...) {
+		// Gather every run back up so no nodes are lost
+		for (size_type i = 0; i < 64; ++i) {
+			if (bins[i] != nullptr) {
+				Node* binLast = bins[i];
+				while (binLast->next != nullptr) {
+					binLast = binLast->next;
+				}
+				binLast->next = carry;
+				carry = bins[i];
+			}
+		}
+		if (carry == nullptr) {
+			carry = rest;
+		}
+		else {
+			Node* carryLast = carry;
+			while (carryLast->next != nullptr) {
+				carryLast = carryLast->next;
+			}
+			carryLast->next = rest;
+		}
+		
+		m_relink(carry);
+		throw;
+	}
+	
+	m_relink(carry);
+}
+
 /**
  * Provides an iterator pointing to the start of the list.
  * @return An iterator pointing at the list's first node
  */
-template <typename T>
-typename LinkedList<T>::iterator LinkedList<T>::begin() {
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::iterator LinkedList<T, Allocator>::begin() {
 	return iterator(m_firstNode, this);
 }
 /**
  * Provides a const_iterator point to the start of the list.
  * @return	A const_iterator pointing to the list's first node
  */
-template <typename T>
-typename LinkedList<T>::const_iterator LinkedList<T>::begin() const {
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::const_iterator LinkedList<T, Allocator>::begin() const {
 	return const_iterator(m_firstNode, this);
 }
 /**
@@ -467,8 +916,8 @@ typename LinkedList<T>::const_iterator LinkedList<T>::begin() const {
  *
  * @return An iterator to just past the end of the list
  */
-template <typename T>
-typename LinkedList<T>::iterator LinkedList<T>::end() {
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::iterator LinkedList<T, Allocator>::end() {
 	return iterator(nullptr, this);
 }
 /**
@@ -479,8 +928,8 @@ typename LinkedList<T>::iterator LinkedList<T>::end() {
  *
  * @return A const_iterator to just past the end of the list
  */
-template <typename T>
-typename LinkedList<T>::const_iterator LinkedList<T>::end() const {
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::const_iterator LinkedList<T, Allocator>::end() const {
 	return const_iterator(nullptr, this);
 }
 
@@ -489,11 +938,9 @@ typename LinkedList<T>::const_iterator LinkedList<T>::end() const {
  * @throws	OutOfBoundsError	when the list is empty
  * @return	A reference to the first element of the list
  */
-template <typename T>
-T& LinkedList<T>::front() {
-	if (m_firstNode == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+T& LinkedList<T, Allocator>::front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_firstNode != nullptr);
 	
 	return m_firstNode->data;
 }
@@ -502,11 +949,9 @@ T& LinkedList<T>::front() {
  * @throws	OutOfBoundsError	when the list is empty
  * @return	A constant reference to the first element of the list
  */
-template <typename T>
-const T& LinkedList<T>::front() const {
-	if (m_firstNode == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+const T& LinkedList<T, Allocator>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_firstNode != nullptr);
 	
 	return m_firstNode->data;
 }
@@ -515,11 +960,9 @@ const T& LinkedList<T>::front() const {
  * @throws	OutOfBoundsError	when the list is empty
  * @return	A reference to the last element of the list
  */
-template <typename T>
-T& LinkedList<T>::back() {
-	if (m_lastNode == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+T& LinkedList<T, Allocator>::back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_lastNode != nullptr);
 	
 	return m_lastNode->data;
 }
@@ -528,32 +971,50 @@ T& LinkedList<T>::back() {
  * @throws	OutOfBoundsError	when the list is empty
  * @return	A constant reference to the last element of the list
  */
-template <typename T>
-const T& LinkedList<T>::back() const {
-	if (m_lastNode == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+const T& LinkedList<T, Allocator>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_lastNode != nullptr);
 	
 	return m_lastNode->data;
 }
 
 /**
  * Uses the copy-and-swap technique to copy another list's contents into this.
+ *
+ * The copy is made with this list's allocator, so this list keeps its
+ * allocator and the swap is between lists that can free each other's nodes.
+ *
  * @return	This LinkedList, after copying
  */
-template <typename T>
-LinkedList<T>& LinkedList<T>::operator=(const LinkedList<T>& other) {
-	LinkedList<T> tmp(other);
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>& LinkedList<T, Allocator>::operator=(const LinkedList<T, Allocator>& other) {
+	LinkedList<T, Allocator> tmp(other, get_allocator());
 	this->m_swap(tmp);
 	return *this;
 }
 /**
  * Swaps the contents of this linked list with another.
+ *
+ * If the allocator's propagate_on_container_move_assignment is true, this
+ * list frees its own nodes and takes the other list's allocator along with
+ * its nodes. Otherwise, if the allocators compare unequal, this list can't
+ * free the other list's nodes, so the other list is copied instead.
+ *
  * @return	This LinkedList, after copying
  */
-template <typename T>
-LinkedList<T>& LinkedList<T>::operator=(LinkedList<T>&& other) {
-	this->m_swap(other);
+template <typename T, typename Allocator>
+LinkedList<T, Allocator>& LinkedList<T, Allocator>::operator=(LinkedList<T, Allocator>&& other) {
+	if (node_traits::propagate_on_container_move_assignment::value) {
+		LinkedList<T, Allocator> old(std::move(*this));
+		this->allocator() = other.allocator();
+		this->m_swap(other);
+	}
+	else if (this->allocator() == other.allocator()) {
+		this->m_swap(other);
+	}
+	else {
+		*this = static_cast<const LinkedList<T, Allocator>&>(other);
+	}
 	return *this;
 }
 /**
@@ -565,8 +1026,8 @@ LinkedList<T>& LinkedList<T>::operator=(LinkedList<T>&& other) {
  * @param	other	The linked list to compare this against
  * @return	Boolean representing whether these linked lists are equal
  */
-template <typename T>
-bool LinkedList<T>::operator==(const LinkedList<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList<T, Allocator>::operator==(const LinkedList<T, Allocator>& other) const {
 	if (this->m_size != other.m_size) {
 		return false;
 	}
@@ -594,45 +1055,62 @@ bool LinkedList<T>::operator==(const LinkedList<T>& other) const {
  * @param	other	The linked list to compare this against
  * @return	Boolean representing whether these linked lists are not equal
  */
-template <typename T>
-bool LinkedList<T>::operator!=(const LinkedList<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList<T, Allocator>::operator!=(const LinkedList<T, Allocator>& other) const {
 	return (!(*this == other));
 }
 
 /**
  * Creates the desired number of nodes with the specified value.
+ *
+ * All of the nodes come from a single slab of the pool.
+ *
  * @param	a_size	The number of nodes to create
  * @param	a_value	The data that should be stored on all nodes
  */
-template <typename T>
-void LinkedList<T>::m_initialize(size_type a_size, const T& a_value) {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_initialize(size_type a_size, const T& a_value) {
+	// The constructors delegate to the allocator constructor before calling
+	// this, so if a copy throws, the destructor frees the nodes made so far
 	if (a_size > 0) {
-		Node* tmpFirst;
-		Node* tmpLast;
-		Node* tmp;
-		
-		tmpFirst = new Node { a_value, nullptr, nullptr };
-		tmpLast = tmpFirst;
-		
-		for (size_type i = 1; i < a_size; i++) {
-			tmp = new Node { a_value, tmpLast, nullptr };
-			tmpLast->next = tmp;
-			tmpLast = tmp;
-			
-			++m_size;
-		}
-		
-		m_firstNode = tmpFirst;
-		m_lastNode = tmpLast;
-		m_size = a_size;
+		m_pool().reserve(a_size);
+	}
+	
+	for (size_type i = 0; i < a_size; i++) {
+		push_back(a_value);
+	}
+}
+/**
+ * Copies the nodes of another list onto the end of this one.
+ *
+ * All of the new nodes come from a single slab of the pool, so the copy is
+ * laid out in memory in list order.
+ *
+ * @param	other	The LinkedList to copy from
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_copyFrom(const LinkedList<T, Allocator>& other) {
+	if (other.m_size > 0) {
+		m_pool().reserve(other.m_size);
+	}
+	
+	for (const Node* n_other = other.m_firstNode; n_other != nullptr; n_other = n_other->next) {
+		push_back(n_other->data);
 	}
 }
 /**
  * Swaps the content of this LinkedList and another LinkedList.
+ *
+ * The allocators are swapped too if propagate_on_container_swap says so.
+ * Otherwise they must compare equal, since each list destroys the data of
+ * the nodes it ends up with through its own allocator.
+ *
  * @param	other	The LinkedList to swap with
  */
-template <typename T>
-void LinkedList<T>::m_swap(LinkedList<T>& other) {
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_swap(LinkedList<T, Allocator>& other) {
+	swapAllocators(this->allocator(), other.allocator());
+	
 	Node* tmp_firstNode;
 	Node* tmp_lastNode;
 	size_type tmp_size;
@@ -651,6 +1129,201 @@ void LinkedList<T>::m_swap(LinkedList<T>& other) {
 	tmp_size = this->m_size;
 	this->m_size = other.m_size;
 	other.m_size = tmp_size;
+	
+	// The nodes go wherever their pool goes.
+	this->mp_pool.swap(other.mp_pool);
+}
+/**
+ * Provides the pool for this list's nodes.
+ *
+ * An empty list doesn't need a pool, so one isn't made until a node is.
+ * The pool itself is allocated with this list's allocator.
+ *
+ * @return	The pool of this list
+ */
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::pool_type& LinkedList<T, Allocator>::m_pool() {
+	if (mp_pool == nullptr) {
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<pool_type> PoolAllocator;
+		mp_pool = std::allocate_shared<pool_type>(PoolAllocator(this->allocator()), this->allocator());
+	}
+	return *mp_pool;
+}
+
+/**
+ * Gets a node from the pool and constructs its data through the allocator.
+ *
+ * Only the data is constructed by the allocator, since that is the part
+ * that might want to use the allocator itself. The links are plain pointers.
+ *
+ * @param	value	The data that the new node should hold
+ * @param	prev	The node before the new one, which isn't changed
+ * @param	next	The node after the new one, which isn't changed
+ * @return	The new node
+ */
+template <typename T, typename Allocator>
+typename LinkedList<T, Allocator>::Node* LinkedList<T, Allocator>::m_createNode(const T& value, Node* prev, Node* next) {
+	Node* node = m_pool().allocate();
+	
+	try {
+		node_traits::construct(this->allocator(), std::addressof(node->data), value);
+	}
+	catch (...) {
+		mp_pool->deallocate(node);
+		throw;
+	}
+	
+	node->prev = prev;
+	node->next = next;
+	return node;
+}
+/**
+ * Destroys a node's data and gives the node back to the pool.
+ * @param	node	The node to free, which must already be unlinked
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_destroyNode(Node* node) {
+	node_traits::destroy(this->allocator(), std::addressof(node->data));
+	mp_pool->deallocate(node);
+}
+
+/**
+ * Makes sure this list can keep nodes that came from another list.
+ *
+ * The other list's data has to be destroyable by this list's allocator, and
+ * the memory for its nodes has to stay alive as long as this list's pool.
+ *
+ * @throws	MismatchedAllocatorError	when the allocators aren't equal
+ * @param	other	The list that nodes will be taken from
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_adopt(const LinkedList<T, Allocator>& other) {
+	if (!(this->allocator() == other.allocator())) {
+		throw MismatchedAllocatorError();
+	}
+	
+	if (other.mp_pool != nullptr && other.mp_pool != mp_pool) {
+		m_pool().adopt(*other.mp_pool);
+	}
+}
+/**
+ * Takes a run of nodes out of this list. The size isn't changed.
+ * @param	first	The first node of the run
+ * @param	last	The last node of the run, which can be first
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_unlink(Node* first, Node* last) {
+	if (first->prev != nullptr) {
+		first->prev->next = last->next;
+	}
+	else {
+		m_firstNode = last->next;
+	}
+	
+	if (last->next != nullptr) {
+		last->next->prev = first->prev;
+	}
+	else {
+		m_lastNode = first->prev;
+	}
+	
+	first->prev = nullptr;
+	last->next = nullptr;
+}
+/**
+ * Puts a run of nodes into this list. The size isn't changed.
+ * @param	before	The node to put the run in front of, or null for the end
+ * @param	first	The first node of the run
+ * @param	last	The last node of the run, which can be first
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_link(Node* before, Node* first, Node* last) {
+	Node* after = (before == nullptr) ? m_lastNode : before->prev;
+	
+	first->prev = after;
+	last->next = before;
+	
+	if (after != nullptr) {
+		after->next = first;
+	}
+	else {
+		m_firstNode = first;
+	}
+	
+	if (before != nullptr) {
+		before->prev = last;
+	}
+	else {
+		m_lastNode = last;
+	}
+}
+/**
+ * Merges two sorted runs of nodes, which are linked only by next pointers.
+ *
+ * Nodes from a go first when they compare equal to nodes from b, which is
+ * what makes merge and sort stable.
+ *
+ * If the comparison throws, a is left holding every node of both runs (not
+ * in order) and b is left empty, so that the caller doesn't lose any nodes.
+ *
+ * @param	a	The earlier run
+ * @param	b	The later run
+ * @param	compare	A function object that returns whether a < b
+ * @return	The first node of the merged run
+ */
+template <typename T, typename Allocator>
+template <typename Compare>
+typename LinkedList<T, Allocator>::Node* LinkedList<T, Allocator>::m_mergeRuns(Node*& a, Node*& b, Compare& compare) {
+	// tail points at the link the next node should be stored in
+	Node* head = nullptr;
+	Node** tail = &head;
+	
+	try {
+		while (a != nullptr && b != nullptr) {
+			if (compare(b->data, a->data)) {
+				*tail = b;
+				b = b->next;
+			}
+			else {
+				*tail = a;
+				a = a->next;
+			}
+			tail = &(*tail)->next;
+		}
+	}
+	catch (...) {
+		*tail = a;
+		while (*tail != nullptr) {
+			tail = &(*tail)->next;
+		}
+		*tail = b;
+		a = head;
+		b = nullptr;
+		throw;
+	}
+
+	*tail = (a != nullptr) ? a : b;
+	a = nullptr;
+	b = nullptr;
+	return head;
+}
+/**
+ * Makes a run of nodes linked by next pointers into the whole of this list.
+ *
+ * The prev pointers and the last node are worked out along the way. The size
+ * isn't changed, since the run has the same nodes as before.
+ *
+ * @param	first	The first node of the run
+ */
+template <typename T, typename Allocator>
+void LinkedList<T, Allocator>::m_relink(Node* first) {
+	m_firstNode = first;
+	m_lastNode = nullptr;
+	
+	for (Node* n = first; n != nullptr; n = n->next) {
+		n->prev = m_lastNode;
+		m_lastNode = n;
+	}
 }
 
 // --------------------------- //
@@ -659,8 +1332,8 @@ void LinkedList<T>::m_swap(LinkedList<T>& other) {
 /**
  * Creates an iterator with no node or owner.
  */
-template <typename T>
-LinkedList_Iterator<T>::LinkedList_Iterator()
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator>::LinkedList_Iterator()
 	: r_owner(nullptr), r_node(nullptr)
 {}
 /**
@@ -671,16 +1344,16 @@ LinkedList_Iterator<T>::LinkedList_Iterator()
  *
  * @param	other	The iterator to copy from
  */
-template <typename T>
-LinkedList_Iterator<T>::LinkedList_Iterator(const LinkedList_Iterator<T>& other)
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator>::LinkedList_Iterator(const LinkedList_Iterator<T, Allocator>& other)
 	: r_owner(other.r_owner), r_node(other.r_node)
 {}
 /**
  * Assignement operator from a LinkedList_Iterator.
  * @param	other	The iterator to copy from
  */
-template <typename T>
-LinkedList_Iterator<T>& LinkedList_Iterator<T>::operator=(const LinkedList_Iterator<T>& other) {
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator>& LinkedList_Iterator<T, Allocator>::operator=(const LinkedList_Iterator<T, Allocator>& other) {
 	r_owner = other.r_owner;
 	r_node = other.r_node;
 	return *this;
@@ -694,8 +1367,8 @@ LinkedList_Iterator<T>& LinkedList_Iterator<T>::operator=(const LinkedList_Itera
  * @param	n	A pointer to the node this iterator should point to
  * @param	owner	A pointer to the list that this iterator will belong to
  */
-template <typename T>
-LinkedList_Iterator<T>::LinkedList_Iterator(Node* n, LinkedList<T>* owner)
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator>::LinkedList_Iterator(Node* n, LinkedList<T, Allocator>* owner)
 	: r_owner(owner), r_node(n)
 {}
 
@@ -706,10 +1379,13 @@ LinkedList_Iterator<T>::LinkedList_Iterator(Node* n, LinkedList<T>* owner)
  * pointer to the data, which can be read from and written to using this
  * method.
  *
+ * @throws	OutOfBoundsError	when this is the end of the list
  * @return	A reference to the data object on the current node
  */
-template <typename T>
-T& LinkedList_Iterator<T>::operator*() const {
+template <typename T, typename Allocator>
+T& LinkedList_Iterator<T, Allocator>::operator*() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
 	return r_node->data;
 }
 /**
@@ -719,10 +1395,13 @@ T& LinkedList_Iterator<T>::operator*() const {
  * pointer to the data, which can be read from and written to using this
  * method.
  *
+ * @throws	OutOfBoundsError	when this is the end of the list
  * @return	A pointer to the data in question, used for member access
  */
-template <typename T>
-T* LinkedList_Iterator<T>::operator->() const {
+template <typename T, typename Allocator>
+T* LinkedList_Iterator<T, Allocator>::operator->() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
 	return &r_node->data;
 }
 /**
@@ -736,11 +1415,9 @@ T* LinkedList_Iterator<T>::operator->() const {
  *
  * @return	This, after the node pointer has been changed
  */
-template <typename T>
-LinkedList_Iterator<T>& LinkedList_Iterator<T>::operator++() {
-	if (r_node == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator>& LinkedList_Iterator<T, Allocator>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
 	
 	r_node = r_node->next;
 	
@@ -758,13 +1435,11 @@ LinkedList_Iterator<T>& LinkedList_Iterator<T>::operator++() {
  *
  * @return	A copy of this before the node pointer was changed
  */
-template <typename T>
-LinkedList_Iterator<T> LinkedList_Iterator<T>::operator++(int) {
-	if (r_node == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator> LinkedList_Iterator<T, Allocator>::operator++(int) {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
 	
-	LinkedList_Iterator<T> tmp(*this);
+	LinkedList_Iterator<T, Allocator> tmp(*this);
 	
 	r_node = r_node->next;
 	
@@ -781,11 +1456,9 @@ LinkedList_Iterator<T> LinkedList_Iterator<T>::operator++(int) {
  *
  * @return	This, after the node pointer has been changed
  */
-template <typename T>
-LinkedList_Iterator<T>& LinkedList_Iterator<T>::operator--() {
-	if (r_node == r_owner.m_firstNode) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator>& LinkedList_Iterator<T, Allocator>::operator--() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != r_owner->m_firstNode);
 	
 	if (r_node == nullptr) {
 		r_node = r_owner->m_lastNode;
@@ -808,13 +1481,11 @@ LinkedList_Iterator<T>& LinkedList_Iterator<T>::operator--() {
  *
  * @return	A copy of this before the node pointer was changed
  */
-template <typename T>
-LinkedList_Iterator<T> LinkedList_Iterator<T>::operator--(int) {
-	if (r_node == r_owner.m_firstNode) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_Iterator<T, Allocator> LinkedList_Iterator<T, Allocator>::operator--(int) {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != r_owner->m_firstNode);
 	
-	LinkedList_Iterator<T> tmp(*this);
+	LinkedList_Iterator<T, Allocator> tmp(*this);
 	
 	if (r_node == nullptr) {
 		r_node = r_owner->m_lastNode;
@@ -829,32 +1500,32 @@ LinkedList_Iterator<T> LinkedList_Iterator<T>::operator--(int) {
  * Checks if two iterators are equal.
  * @return	true if they point to the same owner and node, false otherwise
  */
-template <typename T>
-bool LinkedList_Iterator<T>::operator==(const LinkedList_Iterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_Iterator<T, Allocator>::operator==(const LinkedList_Iterator<T, Allocator>& other) const {
 	return (r_owner == other.r_owner && r_node == other.r_node);
 }
 /**
  * Checks if two iterators are unequal.
  * @return	true if they point to different owners or different nodes
  */
-template <typename T>
-bool LinkedList_Iterator<T>::operator!=(const LinkedList_Iterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_Iterator<T, Allocator>::operator!=(const LinkedList_Iterator<T, Allocator>& other) const {
 	return (r_owner != other.r_owner || r_node != other.r_node);
 }
 /**
  * Checks if an iterator and a const_iterator are equal.
  * @return	true if they point to the same owner and node, false otherwise
  */
-template <typename T>
-bool LinkedList_Iterator<T>::operator==(const LinkedList_ConstIterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_Iterator<T, Allocator>::operator==(const LinkedList_ConstIterator<T, Allocator>& other) const {
 	return (r_owner == other.r_owner && r_node == other.r_node);
 }
 /**
  * Checks if an iterator and a const_iterator are not equal.
  * @return	true if they point to different owners or different nodes
  */
-template <typename T>
-bool LinkedList_Iterator<T>::operator!=(const LinkedList_ConstIterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_Iterator<T, Allocator>::operator!=(const LinkedList_ConstIterator<T, Allocator>& other) const {
 	return (r_owner != other.r_owner || r_node != other.r_node);
 }
 
@@ -865,8 +1536,8 @@ bool LinkedList_Iterator<T>::operator!=(const LinkedList_ConstIterator<T>& other
  * The default constructor for a linked list const_iterator.
  * Creates an iterator with no node or owner.
  */
-template <typename T>
-LinkedList_ConstIterator<T>::LinkedList_ConstIterator()
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>::LinkedList_ConstIterator()
 	: r_owner(nullptr), r_node(nullptr)
 {}
 /**
@@ -877,8 +1548,8 @@ LinkedList_ConstIterator<T>::LinkedList_ConstIterator()
  *
  * @param	other	A const_iterator to copy
  */
-template <typename T>
-LinkedList_ConstIterator<T>::LinkedList_ConstIterator(const LinkedList_ConstIterator<T>& other)
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>::LinkedList_ConstIterator(const LinkedList_ConstIterator<T, Allocator>& other)
 	: r_owner(other.r_owner), r_node(other.r_node)
 {}
 /**
@@ -890,8 +1561,8 @@ LinkedList_ConstIterator<T>::LinkedList_ConstIterator(const LinkedList_ConstIter
  *
  * @param	other	An iterator to copy
  */
-template <typename T>
-LinkedList_ConstIterator<T>::LinkedList_ConstIterator(const LinkedList_Iterator<T> &other)
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>::LinkedList_ConstIterator(const LinkedList_Iterator<T, Allocator> &other)
 	: r_owner(other.r_owner), r_node(other.r_node)
 {}
 /**
@@ -903,16 +1574,16 @@ LinkedList_ConstIterator<T>::LinkedList_ConstIterator(const LinkedList_Iterator<
  * @param	n	A pointer to the node this iterator should point to
  * @param	owner	A pointer to the list that this iterator will belong to
  */
-template <typename T>
-LinkedList_ConstIterator<T>::LinkedList_ConstIterator(const Node* n, const LinkedList<T>* owner)
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>::LinkedList_ConstIterator(const Node* n, const LinkedList<T, Allocator>* owner)
 	: r_owner(owner), r_node(n)
 {}
 /**
  * Assignment operator from a LinkedList_ConstIterator.
  * @param	other	A const_iterator to copy from
  */
-template <typename T>
-LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator=(const LinkedList_ConstIterator<T>& other) {
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>& LinkedList_ConstIterator<T, Allocator>::operator=(const LinkedList_ConstIterator<T, Allocator>& other) {
 	r_owner = other.r_owner;
 	r_node = other.r_node;
 	return *this;
@@ -921,8 +1592,8 @@ LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator=(const Linked
  * Assignemnt operator from a LinkedList_Iterator.
  * @param	other	An iterator to copy from
  */
-template <typename T>
-LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator=(const LinkedList_Iterator<T>& other) {
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>& LinkedList_ConstIterator<T, Allocator>::operator=(const LinkedList_Iterator<T, Allocator>& other) {
 	r_owner = other.r_owner;
 	r_node = other.r_node;
 	return *this;
@@ -935,10 +1606,13 @@ LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator=(const Linked
  * pointer to the data, which can be read from and written to using this
  * method.
  *
+ * @throws	OutOfBoundsError	when this is the end of the list
  * @return	A reference to the data object on the current node
  */
-template <typename T>
-const T& LinkedList_ConstIterator<T>::operator*() const {
+template <typename T, typename Allocator>
+const T& LinkedList_ConstIterator<T, Allocator>::operator*() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
 	return r_node->data;
 }
 /**
@@ -948,10 +1622,13 @@ const T& LinkedList_ConstIterator<T>::operator*() const {
  * pointer to the data, which can be read from and written to using this
  * method.
  *
+ * @throws	OutOfBoundsError	when this is the end of the list
  * @return	A pointer to the data in question, used for member access
  */
-template <typename T>
-const T* LinkedList_ConstIterator<T>::operator->() const {
+template <typename T, typename Allocator>
+const T* LinkedList_ConstIterator<T, Allocator>::operator->() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
 	return &r_node->data;
 }
 /**
@@ -965,11 +1642,9 @@ const T* LinkedList_ConstIterator<T>::operator->() const {
  *
  * @return	This, after the node pointer has been changed
  */
-template <typename T>
-LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator++() {
-	if (r_node == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>& LinkedList_ConstIterator<T, Allocator>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
 	
 	r_node = r_node->next;
 	
@@ -987,13 +1662,11 @@ LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator++() {
  *
  * @return	A copy of this before the node pointer was changed
  */
-template <typename T>
-LinkedList_ConstIterator<T> LinkedList_ConstIterator<T>::operator++(int) {
-	if (r_node == nullptr) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator> LinkedList_ConstIterator<T, Allocator>::operator++(int) {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
 	
-	LinkedList_ConstIterator<T> tmp(*this);
+	LinkedList_ConstIterator<T, Allocator> tmp(*this);
 	
 	r_node = r_node->next;
 	
@@ -1010,11 +1683,9 @@ LinkedList_ConstIterator<T> LinkedList_ConstIterator<T>::operator++(int) {
  *
  * @return	This, after the node pointer has been changed
  */
-template <typename T>
-LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator--() {
-	if (r_node == r_owner.m_firstNode) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator>& LinkedList_ConstIterator<T, Allocator>::operator--() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != r_owner->m_firstNode);
 	
 	if (r_node == nullptr) {
 		r_node = r_owner->m_lastNode;
@@ -1037,13 +1708,11 @@ LinkedList_ConstIterator<T>& LinkedList_ConstIterator<T>::operator--() {
  *
  * @return	A copy of this before the node pointer was changed
  */
-template <typename T>
-LinkedList_ConstIterator<T> LinkedList_ConstIterator<T>::operator--(int) {
-	if (r_node == r_owner.m_firstNode) {
-		throw OutOfBoundsError();
-	}
+template <typename T, typename Allocator>
+LinkedList_ConstIterator<T, Allocator> LinkedList_ConstIterator<T, Allocator>::operator--(int) {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != r_owner->m_firstNode);
 	
-	LinkedList_ConstIterator<T> tmp(*this);
+	LinkedList_ConstIterator<T, Allocator> tmp(*this);
 	
 	if (r_node == nullptr) {
 		r_node = r_owner->m_lastNode;
@@ -1058,33 +1727,192 @@ LinkedList_ConstIterator<T> LinkedList_ConstIterator<T>::operator--(int) {
  * Checks if two const_iterators are equal.
  * @return	true if they point to the same owner and node, false otherwise
  */
-template <typename T>
-bool LinkedList_ConstIterator<T>::operator==(const LinkedList_ConstIterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_ConstIterator<T, Allocator>::operator==(const LinkedList_ConstIterator<T, Allocator>& other) const {
 	return (r_owner == other.r_owner && r_node == other.r_node);
 }
 /**
  * Checks if two const_iterators are unequal.
  * @return	true if they point to different owners or different nodes
  */
-template <typename T>
-bool LinkedList_ConstIterator<T>::operator!=(const LinkedList_ConstIterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_ConstIterator<T, Allocator>::operator!=(const LinkedList_ConstIterator<T, Allocator>& other) const {
 	return (r_owner != other.r_owner || r_node != other.r_node);
 }
 /**
  * Checks if a const_iterator and an are equal.
  * @return	true if they point to the same owner and node, false otherwise
  */
-template <typename T>
-bool LinkedList_ConstIterator<T>::operator==(const LinkedList_Iterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_ConstIterator<T, Allocator>::operator==(const LinkedList_Iterator<T, Allocator>& other) const {
 	return (r_owner == other.r_owner && r_node == other.r_node);
 }
 /**
  * Checks if a const_iterator and an iterator are not equal.
  * @return	true if they point to different owners or different nodes
  */
-template <typename T>
-bool LinkedList_ConstIterator<T>::operator!=(const LinkedList_Iterator<T>& other) const {
+template <typename T, typename Allocator>
+bool LinkedList_ConstIterator<T, Allocator>::operator!=(const LinkedList_Iterator<T, Allocator>& other) const {
 	return (r_owner != other.r_owner || r_node != other.r_node);
 }
 
+// ---------------------------- //
+// LinkedList_NodePool methods //
+// ---------------------------- //
+/**
+ * Creates an empty pool, which allocates slabs with the provided allocator.
+ *
+ * No slabs are allocated until the first node is asked for.
+ *
+ * @param	allocator	The allocator for the slabs
+ */
+template <typename T, typename Allocator>
+LinkedList_NodePool<T, Allocator>::LinkedList_NodePool(const NodeAllocator& allocator)
+	: mp_free(nullptr), m_freeCount(0), mp_unused(nullptr), m_unusedCount(0), m_nextSlab(LINKEDLIST_POOL_MIN_SLAB)
+{
+	m_slabs.push_back(std::allocate_shared<Slabs>(SlabsAllocator(allocator), allocator));
+}
+
+/**
+ * Hands out the memory for one node.
+ *
+ * Nodes on the free list are used first, so recently freed memory (which is
+ * likely still in the cache) is used again before any new memory.
+ *
+ * @return	Memory for a node, with nothing constructed in it
+ */
+template <typename T, typename Allocator>
+typename LinkedList_NodePool<T, Allocator>::Node* LinkedList_NodePool<T, Allocator>::allocate() {
+	if (mp_free != nullptr) {
+		Node* node = mp_free;
+		mp_free = node->next;
+		--m_freeCount;
+		return node;
+	}
+	
+	if (m_unusedCount == 0) {
+		m_grow(m_nextSlab);
+		if (m_nextSlab < LINKEDLIST_POOL_MAX_SLAB) {
+			m_nextSlab *= 2;
+		}
+	}
+	
+	--m_unusedCount;
+	return mp_unused++;
+}
+/**
+ * Takes back the memory for a node, putting it on the free list.
+ *
+ * The node's data must already have been destroyed. The memory must have
+ * come from this pool, or from a pool this pool has adopted.
+ *
+ * @param	node	The node to take back
+ */
+template <typename T, typename Allocator>
+void LinkedList_NodePool<T, Allocator>::deallocate(Node* node) {
+	node->next = mp_free;
+	mp_free = node;
+	++m_freeCount;
+}
+
+/**
+ * Makes sure a number of nodes can be handed out without a new slab.
+ *
+ * If a new slab is needed, it is made big enough for all of the nodes that
+ * are missing at once, so they are next to each other in memory.
+ *
+ * @param	count	The number of nodes that will be asked for
+ */
+template <typename T, typename Allocator>
+void LinkedList_NodePool<T, Allocator>::reserve(size_type count) {
+	if (available() < count) {
+		m_grow(count - m_freeCount);
+	}
+}
+/**
+ * Keeps the slabs of another pool alive for as long as this pool is.
+ *
+ * After this, nodes from the other pool can be given back to this one.
+ * The slabs themselves don't refer to any pool, so pools adopting each other
+ * don't keep each other alive forever.
+ *
+ * @param	other	The pool to adopt the slabs of
+ */
+template <typename T, typename Allocator>
+void LinkedList_NodePool<T, Allocator>::adopt(const LinkedList_NodePool<T, Allocator>& other) {
+	for (const SlabsPointer& slabs : other.m_slabs) {
+		bool found = false;
+		for (const SlabsPointer& mine : m_slabs) {
+			if (mine == slabs) {
+				found = true;
+				break;
+			}
+		}
+		
+		if (!found) {
+			m_slabs.push_back(slabs);
+		}
+	}
+}
+
+/**
+ * Reports how many nodes can be handed out without a new slab.
+ * @return	The number of free and never-used nodes in this pool
+ */
+template <typename T, typename Allocator>
+typename LinkedList_NodePool<T, Allocator>::size_type LinkedList_NodePool<T, Allocator>::available() const {
+	return m_freeCount + m_unusedCount;
+}
+/**
+ * Provides the allocator that this pool gets its slabs from.
+ * @return	The allocator of the pool
+ */
+template <typename T, typename Allocator>
+const typename LinkedList_NodePool<T, Allocator>::NodeAllocator& LinkedList_NodePool<T, Allocator>::get_allocator() const {
+	return m_slabs.front()->allocator;
+}
+
+/**
+ * Allocates a new slab, which becomes the place new nodes come from.
+ *
+ * Whatever was left of the previous slab goes on the free list first, so it
+ * isn't wasted.
+ *
+ * @param	count	The number of nodes in the new slab
+ */
+template <typename T, typename Allocator>
+void LinkedList_NodePool<T, Allocator>::m_grow(size_type count) {
+	Slabs& slabs = *m_slabs.front();
+	
+	slabs.blocks.reserve(slabs.blocks.size() + 1);
+	Node* block = node_traits::allocate(slabs.allocator, count);
+	slabs.blocks.push_back(std::make_pair(block, count));
+	
+	while (m_unusedCount > 0) {
+		deallocate(mp_unused++);
+		--m_unusedCount;
+	}
+	
+	mp_unused = block;
+	m_unusedCount = count;
+}
+
+/**
+ * Creates an empty set of slabs.
+ * @param	a_allocator	The allocator that the slabs come from
+ */
+template <typename T, typename Allocator>
+LinkedList_NodePool<T, Allocator>::Slabs::Slabs(const NodeAllocator& a_allocator)
+	: allocator(a_allocator), blocks(BlockAllocator(a_allocator))
+{}
+/**
+ * Frees every slab. Any data on the nodes must already have been destroyed.
+ */
+template <typename T, typename Allocator>
+LinkedList_NodePool<T, Allocator>::Slabs::~Slabs() {
+	for (size_type i = 0; i < blocks.size(); ++i) {
+		node_traits::deallocate(allocator, blocks[i].first, blocks[i].second);
+	}
+}
+
 #endif // Fundamentals_LinkedList_hpp_
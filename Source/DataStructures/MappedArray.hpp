@@ -0,0 +1,167 @@
+/**
+ * Fundamentals :: Data Structures :: Mapped Array
+ * Author: Quinn Mortimer
+ *
+ * This is a read-only view of a DynamicArray that was saved to a file, which
+ * uses the elements straight out of the file mapped into memory.
+ */
+/**
+ * Opening a MappedArray only maps the file and checks its header, so it takes
+ * the same time however many elements there are. The elements are read in
+ * from the file as they are first used (see MappedFile.hpp).
+ *
+ * The elements can't be changed, and only trivially copyable element types
+ * can be saved in the first place. For an array that can be changed, copy the
+ * elements into a DynamicArray.
+ */
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include "Checks.hpp"
+#include "Exceptions.hpp"
+#include "MappedFile.hpp"
+
+#ifndef Fundamentals_MappedArray_hpp_
+#define Fundamentals_MappedArray_hpp_
+
+/**
+ * A read-only array of the elements in a file saved by DynamicArray::save.
+ */
+template <typename T>
+class MappedArray {
+	static_assert(std::is_trivially_copyable<T>::value, "Only arrays of trivially copyable types can be saved");
+	
+	public:
+		typedef size_t size_type;
+		typedef const T* const_iterator;
+		
+		// Constructor
+		explicit MappedArray(const std::string& path);
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Iterators
+		const_iterator begin() const;
+		const_iterator end() const;
+		
+		// Data Access
+		const T& front() const;
+		const T& back() const;
+		const T& operator[](size_type index) const;
+		const T* data() const;
+		
+	private:
+		// The mapping of the file, which holds the elements.
+		MappedFile m_file;
+		// The first element in the mapping.
+		const T* mp_data;
+		// The number of elements.
+		size_type m_size;
+};
+
+// -------------------- //
+// MappedArray Methods //
+// -------------------- //
+/**
+ * Maps a file saved by DynamicArray::save.
+ * @throws	FileError	when the file can't be opened or mapped
+ * @throws	FileFormatError	when the file isn't an array of this element type
+ * @param	path	The path of the file
+ */
+template <typename T>
+MappedArray<T>::MappedArray(const std::string& path)
+	: m_file(path)
+{
+	m_file.check(MAPPEDFILE_KIND_ARRAY, sizeof(T), sizeof(T), 0);
+	
+	mp_data = static_cast<const T*>(m_file.slots());
+	m_size = m_file.header().size;
+}
+
+/**
+ * Reports the number of elements in the array.
+ * @return	The number of elements
+ */
+template <typename T>
+typename MappedArray<T>::size_type MappedArray<T>::size() const {
+	return m_size;
+}
+/**
+ * Reports whether the array is empty.
+ * @return	Whether there are no elements
+ */
+template <typename T>
+bool MappedArray<T>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Provides an iterator to the start of the array.
+ * @return	A pointer to the first element
+ */
+template <typename T>
+typename MappedArray<T>::const_iterator MappedArray<T>::begin() const {
+	return mp_data;
+}
+/**
+ * Provides an iterator to the end of the array.
+ * @return	A pointer just past the last element
+ */
+template <typename T>
+typename MappedArray<T>::const_iterator MappedArray<T>::end() const {
+	return mp_data + m_size;
+}
+
+/**
+ * Provides the first element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A constant reference to the first element
+ */
+template <typename T>
+const T& MappedArray<T>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return mp_data[0];
+}
+/**
+ * Provides the last element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A constant reference to the last element
+ */
+template <typename T>
+const T& MappedArray<T>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return mp_data[m_size - 1];
+}
+/**
+ * Provides an element at any index of the array.
+ *
+ * The index is checked according to the policy in Checks.hpp, as it is for
+ * DynamicArray.
+ *
+ * @throws	OutOfBoundsError	when the requested index is >= the size
+ * @param	index	The index in the array to retrieve data from
+ * @return	A constant reference to the element at the index
+ */
+template <typename T>
+const T& MappedArray<T>::operator[](size_type index) const {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
+	
+	return mp_data[index];
+}
+/**
+ * Provides the elements as a plain array.
+ * @return	A pointer to the first element, which is valid for as long as
+ * 	this MappedArray is
+ */
+template <typename T>
+const T* MappedArray<T>::data() const {
+	return mp_data;
+}
+
+#endif // Fundamentals_MappedArray_hpp_
@@ -0,0 +1,364 @@
+/**
+ * Fundamentals :: Data Structures :: Mapped File
+ * Author: Quinn Mortimer
+ *
+ * This file contains the file format that DynamicArray and HashMap can be
+ * saved in, and the memory mapping that MappedArray and MappedHashMap use to
+ * read those files back without loading them.
+ */
+/**
+ * A saved file is a header followed by the slots of the data structure,
+ * exactly as they are laid out in memory: the elements of a DynamicArray, or
+ * every node of a HashMap's underlying array, full or not. Loading a file is
+ * just mapping it into memory, and the slots are used where they are, so
+ * nothing is done per element and the cost doesn't grow with the size of
+ * the file. The operating system reads in pages of the file as they are
+ * first touched, and every process that maps the same file shares the same
+ * copy of those pages.
+ *
+ * That only works for types that are trivially copyable, since their bytes
+ * are all there is to them. Their bytes also depend on the compiler and the
+ * machine, so the header records enough to refuse a file that was written
+ * with different types or on a machine with a different byte order:
+ * - The kind of data structure, and the size of its slots, keys and values.
+ * - A marker written in the machine's byte order.
+ * - For maps, the hash of a value-initialized key. The hash functions in
+ *   Hashing.hpp aren't seeded, so this stands in for a seed: a map that is
+ *   opened with a different hash function than it was saved with would look
+ *   for its keys in the wrong slots, and the check catches that.
+ *
+ * None of this can catch a type that keeps the same size but changes what
+ * its bytes mean, so files are meant to be read by the same build of a
+ * program that wrote them, or one with the same types.
+ *
+ * Files are written to a temporary name and then renamed over the real one,
+ * so a process that maps the file never sees one that is only half written,
+ * and processes that already have the old file mapped keep the old copy.
+ *
+ * The mapping uses the POSIX mmap interface.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_MappedFile_hpp_
+#define Fundamentals_MappedFile_hpp_
+
+// Identifies the files, and the version of the layout described here
+#define MAPPEDFILE_MAGIC "FUNDMMAP"
+#define MAPPEDFILE_VERSION 1
+// Written in the byte order of the machine that saves the file
+#define MAPPEDFILE_BYTE_ORDER 0x01020304u
+// The kinds of data structure a file can hold
+#define MAPPEDFILE_KIND_ARRAY 1
+#define MAPPEDFILE_KIND_HASHMAP 2
+// Where the slots start. This is a cache line, which is as much alignment as
+// any slot type here needs, and mappings always start at a page boundary.
+#define MAPPEDFILE_DATA_OFFSET 128
+
+/**
+ * The header at the start of every saved file.
+ */
+struct MappedFile_Header {
+	// MAPPEDFILE_MAGIC, without a terminating null.
+	char magic[8];
+	// MAPPEDFILE_BYTE_ORDER, as the machine that saved the file stores it.
+	uint32_t byteOrder;
+	// MAPPEDFILE_VERSION.
+	uint32_t version;
+	// One of the MAPPEDFILE_KIND values.
+	uint32_t kind;
+	uint32_t reserved;
+	// The size of each slot, and of the keys and values in them. An array
+	// has its element type as the key type, and no values.
+	uint64_t slotSize;
+	uint64_t keySize;
+	uint64_t valueSize;
+	// The number of slots, and the number of them in use.
+	uint64_t capacity;
+	uint64_t size;
+	// For maps, the hash of a value-initialized key. Otherwise 0.
+	uint64_t hashCheck;
+};
+
+static_assert(sizeof(MappedFile_Header) <= MAPPEDFILE_DATA_OFFSET, "The header must fit before the slots");
+
+/**
+ * Writes a saved file for a data structure.
+ *
+ * The header is written by the constructor, and the slots are then written
+ * in order with write. Nothing is visible at the path until commit is called,
+ * and if it never is, the temporary file is removed.
+ */
+class MappedFile_Writer {
+	public:
+		MappedFile_Writer(const std::string& path, const MappedFile_Header& header);
+		~MappedFile_Writer();
+		
+		// Writing the file is a one-off, so there is no reason to copy it around.
+		MappedFile_Writer(const MappedFile_Writer& other) = delete;
+		MappedFile_Writer& operator=(const MappedFile_Writer& other) = delete;
+		
+		// Adds bytes to the file, after everything written before them.
+		void write(const void* data, size_t bytes);
+		// Finishes the file and moves it into place.
+		void commit();
+		
+	private:
+		// The path the file will end up at, and where it is written first.
+		std::string m_path;
+		std::string m_temporaryPath;
+		// The open temporary file, or nullptr once it has been closed.
+		std::FILE* mp_file;
+};
+
+/**
+ * A read-only mapping of a saved file.
+ */
+class MappedFile {
+	public:
+		explicit MappedFile(const std::string& path);
+		MappedFile(MappedFile&& other);
+		~MappedFile();
+		
+		// A mapping can only be unmapped once, so it can be moved but not copied.
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		MappedFile& operator=(MappedFile&& other);
+		
+		// Checks that the file holds what the caller expects.
+		void check(uint32_t kind, uint64_t slotSize, uint64_t keySize, uint64_t valueSize) const;
+		
+		// Access to the contents of the file.
+		const MappedFile_Header& header() const;
+		const void* slots() const;
+		
+	private:
+		// The start of the mapping, or nullptr once it has been unmapped.
+		void* mp_data;
+		// The size of the mapping, which is the size of the file.
+		size_t m_size;
+		
+		// Removes the mapping, if there is one.
+		void m_unmap();
+};
+
+/**
+ * Makes the header for a file about to be saved.
+ * @param	kind	One of the MAPPEDFILE_KIND values
+ * @param	slotSize	The size of each slot
+ * @param	keySize	The size of the keys, or of the elements of an array
+ * @param	valueSize	The size of the values, or 0 for an array
+ * @param	capacity	The number of slots
+ * @param	size	The number of slots in use
+ * @param	hashCheck	For maps, the hash of a value-initialized key
+ * @return	The header
+ */
+inline MappedFile_Header mappedFileHeader(uint32_t kind, uint64_t slotSize, uint64_t keySize, uint64_t valueSize, uint64_t capacity, uint64_t size, uint64_t hashCheck) {
+	MappedFile_Header header;
+	std::memcpy(header.magic, MAPPEDFILE_MAGIC, sizeof(header.magic));
+	header.byteOrder = MAPPEDFILE_BYTE_ORDER;
+	header.version = MAPPEDFILE_VERSION;
+	header.kind = kind;
+	header.reserved = 0;
+	header.slotSize = slotSize;
+	header.keySize = keySize;
+	header.valueSize = valueSize;
+	header.capacity = capacity;
+	header.size = size;
+	header.hashCheck = hashCheck;
+	return header;
+}
+
+// -------------------------- //
+// MappedFile_Writer Methods //
+// -------------------------- //
+/**
+ * Starts writing a file, by writing its header to a temporary file.
+ * @throws	FileError	when the temporary file can't be created or written
+ * @param	path	The path of the file to save
+ * @param	header	The header of the file
+ */
+inline MappedFile_Writer::MappedFile_Writer(const std::string& path, const MappedFile_Header& header)
+	: m_path(path), m_temporaryPath(path + ".tmp")
+{
+	mp_file = std::fopen(m_temporaryPath.c_str(), "wb");
+	if (mp_file == nullptr) {
+		throw FileError();
+	}
+	
+	unsigned char padding[MAPPEDFILE_DATA_OFFSET - sizeof(MappedFile_Header)] = {};
+	try {
+		write(&header, sizeof(header));
+		write(padding, sizeof(padding));
+	}
+	catch (...) {
+		std::fclose(mp_file);
+		std::remove(m_temporaryPath.c_str());
+		throw;
+	}
+}
+/**
+ * Removes the temporary file, unless the file was committed.
+ */
+inline MappedFile_Writer::~MappedFile_Writer() {
+	if (mp_file != nullptr) {
+		std::fclose(mp_file);
+		std::remove(m_temporaryPath.c_str());
+	}
+}
+/**
+ * Adds bytes to the end of the file.
+ * @throws	FileError	when the bytes can't be written
+ * @param	data	The bytes to write
+ * @param	bytes	The number of bytes
+ */
+inline void MappedFile_Writer::write(const void* data, size_t bytes) {
+	if (std::fwrite(data, 1, bytes, mp_file) != bytes) {
+		throw FileError();
+	}
+}
+/**
+ * Finishes writing the file, and renames it over anything at the path.
+ * @throws	FileError	when the file can't be finished or renamed
+ */
+inline void MappedFile_Writer::commit() {
+	std::FILE* file = mp_file;
+	mp_file = nullptr;
+	
+	if (std::fclose(file) != 0 || std::rename(m_temporaryPath.c_str(), m_path.c_str()) != 0) {
+		std::remove(m_temporaryPath.c_str());
+		throw FileError();
+	}
+}
+
+// ------------------- //
+// MappedFile Methods //
+// ------------------- //
+/**
+ * Maps a file into memory, read-only.
+ *
+ * The mapping is shared, so every process that maps the same file reads the
+ * same pages of the page cache.
+ *
+ * @throws	FileError	when the file can't be opened or mapped
+ * @throws	FileFormatError	when the file is too small to have a header
+ * @param	path	The path of the file to map
+ */
+inline MappedFile::MappedFile(const std::string& path)
+	: mp_data(nullptr), m_size(0)
+{
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) {
+		throw FileError();
+	}
+	
+	struct stat status;
+	if (::fstat(descriptor, &status) != 0) {
+		::close(descriptor);
+		throw FileError();
+	}
+	if (static_cast<uint64_t>(status.st_size) < MAPPEDFILE_DATA_OFFSET) {
+		::close(descriptor);
+		throw FileFormatError();
+	}
+	
+	m_size = status.st_size;
+	void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, descriptor, 0);
+	// The mapping keeps the file open by itself
+	::close(descriptor);
+	if (data == MAP_FAILED) {
+		throw FileError();
+	}
+	mp_data = data;
+}
+/**
+ * Takes over the mapping of another MappedFile.
+ * @param	other	The mapping to take, which is left without one
+ */
+inline MappedFile::MappedFile(MappedFile&& other)
+	: mp_data(other.mp_data), m_size(other.m_size)
+{
+	other.mp_data = nullptr;
+	other.m_size = 0;
+}
+/**
+ * Unmaps the file.
+ */
+inline MappedFile::~MappedFile() {
+	m_unmap();
+}
+/**
+ * Unmaps this file, and takes over the mapping of another.
+ * @param	other	The mapping to take, which is left without one
+ * @return	This, after taking the mapping
+ */
+inline MappedFile& MappedFile::operator=(MappedFile&& other) {
+	if (this != &other) {
+		m_unmap();
+		mp_data = other.mp_data;
+		m_size = other.m_size;
+		other.mp_data = nullptr;
+		other.m_size = 0;
+	}
+	return *this;
+}
+/**
+ * Checks that the file was saved by the expected kind of data structure,
+ * with the expected types, on a machine like this one, and that it holds all
+ * of the slots its header says it does.
+ * @throws	FileFormatError	when any of that isn't so
+ * @param	kind	The expected MAPPEDFILE_KIND value
+ * @param	slotSize	The expected size of each slot
+ * @param	keySize	The expected size of the keys
+ * @param	valueSize	The expected size of the values
+ */
+inline void MappedFile::check(uint32_t kind, uint64_t slotSize, uint64_t keySize, uint64_t valueSize) const {
+	const MappedFile_Header& h = header();
+	
+	if (std::memcmp(h.magic, MAPPEDFILE_MAGIC, sizeof(h.magic)) != 0 || h.byteOrder != MAPPEDFILE_BYTE_ORDER || h.version != MAPPEDFILE_VERSION) {
+		throw FileFormatError();
+	}
+	if (h.kind != kind || h.slotSize != slotSize || h.keySize != keySize || h.valueSize != valueSize) {
+		throw FileFormatError();
+	}
+	if (h.size > h.capacity || h.capacity > (m_size - MAPPEDFILE_DATA_OFFSET) / slotSize) {
+		throw FileFormatError();
+	}
+}
+/**
+ * Provides the header of the file.
+ * @return	The header
+ */
+inline const MappedFile_Header& MappedFile::header() const {
+	return *static_cast<const MappedFile_Header*>(mp_data);
+}
+/**
+ * Provides the slots in the file, which start after the header.
+ * @return	The first slot
+ */
+inline const void* MappedFile::slots() const {
+	return static_cast<const unsigned char*>(mp_data) + MAPPEDFILE_DATA_OFFSET;
+}
+/**
+ * Removes the mapping, if this still has one.
+ */
+inline void MappedFile::m_unmap() {
+	if (mp_data != nullptr) {
+		::munmap(mp_data, m_size);
+		mp_data = nullptr;
+		m_size = 0;
+	}
+}
+
+#endif // Fundamentals_MappedFile_hpp_
@@ -0,0 +1,301 @@
+/**
+ * Fundamentals :: Data Structures :: Mapped Hash Map
+ * Author: Quinn Mortimer
+ *
+ * This is a read-only view of a HashMap that was saved to a file, which looks
+ * keys up in the saved table straight out of the file mapped into memory.
+ */
+/**
+ * The file holds every node of the map's underlying array as it was in
+ * memory, so the table doesn't have to be rebuilt. Opening a MappedHashMap
+ * only maps the file and checks its header, which takes the same time however
+ * many keys there are, and each lookup follows the same probe sequence the
+ * HashMap would have (see MappedFile.hpp).
+ *
+ * Since the slots aren't checked when the file is opened, a damaged file
+ * could have no slot that ends a search, such as one where every slot is a
+ * tombstone. Lookups give up after enough steps to have visited every slot,
+ * so they treat the key as missing rather than searching forever.
+ *
+ * The map has to be opened with the same hash function it was saved with,
+ * since that is what decides which slots the keys are in. The header records
+ * the hash of a value-initialized key to check this, and the hash saved with
+ * the first key in the table is checked as well.
+ *
+ * The keys and values can't be changed. Only maps of trivially copyable keys
+ * and values, using the default PerturbProbe, can be saved in the first place.
+ */
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Exceptions.hpp"
+#include "HashMap.hpp"
+#include "HashProbes.hpp"
+#include "Hashing.hpp"
+#include "MappedFile.hpp"
+
+#ifndef Fundamentals_MappedHashMap_hpp_
+#define Fundamentals_MappedHashMap_hpp_
+
+/**
+ * A read-only map of the keys and values in a file saved by HashMap::save.
+ *
+ * The Hash parameter must be the same as that of the HashMap that was saved.
+ */
+template <typename Key, typename Value, typename Hash = DefaultHashFor<Key>>
+class MappedHashMap : private HashHolder<Hash> {
+	static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value, "Only maps of trivially copyable keys and values can be saved");
+	
+	public:
+		typedef size_t size_type;
+		typedef Hash hash_type;
+		
+		// Constructor
+		explicit MappedHashMap(const std::string& path, const hash_type& hash = hash_type());
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		size_type capacity() const;
+		
+		// Data Access
+		// - Check for a key
+		bool hasKey(const Key& k) const;
+		// - Get elements by key
+		const Value& operator[](const Key& k) const;
+		const Value& getValue(const Key& k) const;
+		// - Look up keys that might be missing without exceptions
+		const Value* find(const Key& k) const;
+		bool try_get(const Key& k, Value& value) const;
+		// - Get all keys or all values
+		std::vector<Key> keys() const;
+		std::vector<Value> values() const;
+		
+	private:
+		typedef HashMap_Node<Key, Value> Node;
+		
+		// The mapping of the file, which holds the nodes.
+		MappedFile m_file;
+		// The first node of the saved underlying array.
+		const Node* mp_nodes;
+		// The number of nodes, and the number of them with keys.
+		size_type m_capacity;
+		size_type m_size;
+		// Finds the slot that holds a key, or gives m_capacity when it's missing.
+		size_type m_findIndex(const Key& key) const;
+};
+
+// ---------------------- //
+// MappedHashMap Methods //
+// ---------------------- //
+/**
+ * Maps a file saved by HashMap::save.
+ * @throws	FileError	when the file can't be opened or mapped
+ * @throws	FileFormatError	when the file isn't a map of these key and value
+ * 	types, or was saved with a different hash function
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	path	The path of the file
+ * @param	hash	The hash function the map was saved with
+ */
+template <typename Key, typename Value, typename Hash>
+MappedHashMap<Key, Value, Hash>::MappedHashMap(const std::string& path, const hash_type& hash)
+	: HashHolder<Hash>(hash), m_file(path)
+{
+	requireHashFunction(hash);
+	
+	m_file.check(MAPPEDFILE_KIND_HASHMAP, sizeof(Node), sizeof(Key), sizeof(Value));
+	
+	const MappedFile_Header& header = m_file.header();
+	// A table that isn't a power of two, or has no empty slots, can't have
+	// come from a HashMap, and searching it might never stop
+	if (header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0 || header.size >= header.capacity) {
+		throw FileFormatError();
+	}
+	if (header.hashCheck != hashKey(this->hashFunction(), Key())) {
+		throw FileFormatError();
+	}
+	
+	mp_nodes = static_cast<const Node*>(m_file.slots());
+	m_capacity = header.capacity;
+	m_size = header.size;
+	
+	// Many hash functions agree on a value-initialized key, so also check the
+	// hash saved with the first key in the table
+	if (m_size > 0) {
+		size_type i = 0;
+		while (i < m_capacity && mp_nodes[i].empty()) {
+			++i;
+		}
+		if (i == m_capacity || mp_nodes[i].hash() != hashKey(this->hashFunction(), mp_nodes[i].key())) {
+			throw FileFormatError();
+		}
+	}
+}
+
+/**
+ * Reports the number of keys in the map.
+ * @return	The number of key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Hash>
+typename MappedHashMap<Key, Value, Hash>::size_type MappedHashMap<Key, Value, Hash>::size() const {
+	return m_size;
+}
+/**
+ * Reports whether or not the map is empty.
+ * @return	Whether there are any keys in the map
+ */
+template <typename Key, typename Value, typename Hash>
+bool MappedHashMap<Key, Value, Hash>::empty() const {
+	return m_size == 0;
+}
+/**
+ * Reports the number of slots in the saved underlying array.
+ * @return	The number of slots
+ */
+template <typename Key, typename Value, typename Hash>
+typename MappedHashMap<Key, Value, Hash>::size_type MappedHashMap<Key, Value, Hash>::capacity() const {
+	return m_capacity;
+}
+
+/**
+ * Checks if a key is in the map.
+ * @param	key	The key to check for
+ * @return	Whether or not the key exists
+ */
+template <typename Key, typename Value, typename Hash>
+bool MappedHashMap<Key, Value, Hash>::hasKey(const Key& key) const {
+	return m_findIndex(key) != m_capacity;
+}
+/**
+ * Gets the value stored at a given key.
+ *
+ * As with the constant version for HashMap, a missing key can't be added.
+ *
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash>
+const Value& MappedHashMap<Key, Value, Hash>::operator[](const Key& key) const {
+	return getValue(key);
+}
+/**
+ * Gets the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash>
+const Value& MappedHashMap<Key, Value, Hash>::getValue(const Key& key) const {
+	size_type index = m_findIndex(key);
+	
+	if (index == m_capacity) {
+		throw MissingKeyError();
+	}
+	
+	return mp_nodes[index].value();
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ * @param	key	The key to get the mapped value for
+ * @return	A constant pointer to the value key refers to, or nullptr if it's
+ * 	missing. It is valid for as long as this MappedHashMap is.
+ */
+template <typename Key, typename Value, typename Hash>
+const Value* MappedHashMap<Key, Value, Hash>::find(const Key& key) const {
+	size_type index = m_findIndex(key);
+	return index == m_capacity ? nullptr : &mp_nodes[index].value();
+}
+/**
+ * Copies out the value stored at a key, if the key is in the map.
+ * @param	key	The key to get the mapped value for
+ * @param	value	Set to a copy of the mapped value when the key is found,
+ * 	and left alone otherwise
+ * @return	Whether the key was found
+ */
+template <typename Key, typename Value, typename Hash>
+bool MappedHashMap<Key, Value, Hash>::try_get(const Key& key, Value& value) const {
+	const Value* found = find(key);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	value = *found;
+	return true;
+}
+
+/**
+ * Gets a sequence of all the keys in this map.
+ *
+ * This reads through the whole saved table, so it touches every page of it.
+ *
+ * @return	A vector containing all keys in this map
+ */
+template <typename Key, typename Value, typename Hash>
+std::vector<Key> MappedHashMap<Key, Value, Hash>::keys() const {
+	std::vector<Key> keys(0);
+	keys.reserve(m_size);
+	
+	for (size_type i = 0; i < m_capacity; ++i) {
+		if (!mp_nodes[i].empty()) {
+			keys.push_back(mp_nodes[i].key());
+		}
+	}
+	
+	return keys;
+}
+/**
+ * Gets a sequence of all the values in this map.
+ * @return	A vector containing all values in this map
+ */
+template <typename Key, typename Value, typename Hash>
+std::vector<Value> MappedHashMap<Key, Value, Hash>::values() const {
+	std::vector<Value> values(0);
+	values.reserve(m_size);
+	
+	for (size_type i = 0; i < m_capacity; ++i) {
+		if (!mp_nodes[i].empty()) {
+			values.push_back(mp_nodes[i].value());
+		}
+	}
+	
+	return values;
+}
+
+/**
+ * Finds the index in the saved array that a key is at.
+ *
+ * This follows the same probe sequence as PerturbProbe::find, on the saved
+ * nodes, but with a limit on the number of steps. Once the perturbation has
+ * been shifted away, the sequence visits every slot within m_capacity steps
+ * (see PerturbProbe::find), so a key that is in the table is always found
+ * before the limit.
+ *
+ * @param	key	The key to find the slot for
+ * @return	The index of the slot holding key, or m_capacity if it's missing
+ */
+template <typename Key, typename Value, typename Hash>
+typename MappedHashMap<Key, Value, Hash>::size_type MappedHashMap<Key, Value, Hash>::m_findIndex(const Key& key) const {
+	const size_type hashValue = hashKey(this->hashFunction(), key);
+	const size_type mask = m_capacity - 1;
+	const size_type limit = m_capacity + (sizeof(size_type) * 8 + HASHMAP_COLLISION_SHIFT - 1) / HASHMAP_COLLISION_SHIFT;
+	
+	size_type perturb = hashValue;
+	size_type idx_current = hashValue & mask;
+	
+	for (size_type step = 0; step < limit && !mp_nodes[idx_current].unused(); ++step) {
+		if (mp_nodes[idx_current].keyEqual(key, hashValue)) {
+			return idx_current;
+		}
+		
+		idx_current = (idx_current * 5 + 1 + perturb) & mask;
+		perturb = perturb >> HASHMAP_COLLISION_SHIFT;
+	}
+	
+	return m_capacity;
+}
+
+#endif // Fundamentals_MappedHashMap_hpp_
@@ -0,0 +1,559 @@
+/**
+ * Fundamentals :: Data Structures :: Priority Queue
+ * Author: Quinn Mortimer
+ *
+ * This is an implementation of a priority queue as a d-ary heap, which always
+ * gives back the highest priority element first.
+ * It is intended as a reference for those looking to brush up on important
+ * data structures.
+ */
+/**
+ * A heap is a tree kept in an array, where every element ranks at least as
+ * high as each of its children. The children of the element at index i are
+ * at indices D * i + 1 up to D * i + D, so no pointers are needed, and the
+ * top of the queue is always at index 0.
+ *
+ * Most heaps are binary (D = 2), but taking more children per element makes
+ * the tree shallower, so elements move through fewer levels. Moving an element
+ * down has to look at every child to find the highest, but those are next to
+ * each other in memory: with D = 4 or 8 and small elements, a whole group of
+ * siblings sits in one cache line, and is read with one wait on memory. D = 4
+ * is usually the fastest.
+ *
+ * Like std::priority_queue, an element ranks higher than another when Compare
+ * says the other goes before it, so with the default std::less the greatest
+ * element is on top. Use std::greater to have the least on top.
+ *
+ * IndexedPriorityQueue is a variant for numbered items, such as the vertices
+ * of a graph, that also knows where in the heap each item is. That lets an
+ * item's priority be changed in place with decrease_key, rather than adding
+ * the item again.
+ *
+ * The elements are kept in a DynamicArray.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "Checks.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_PriorityQueue_hpp_
+#define Fundamentals_PriorityQueue_hpp_
+
+// The default number of children of each element.
+#define PRIORITYQUEUE_DEFAULT_ARITY 4
+// The position IndexedPriorityQueue gives items that aren't in it.
+#define PRIORITYQUEUE_ABSENT SIZE_MAX
+
+/**
+ * A priority queue of elements, kept in a D-ary heap.
+ */
+template <typename T, typename Compare = std::less<T>, size_t D = PRIORITYQUEUE_DEFAULT_ARITY>
+class PriorityQueue {
+	static_assert(D >= 2, "A heap needs at least two children per element");
+	
+	public:
+		typedef size_t size_type;
+		typedef Compare value_compare;
+		
+		// Constructors
+		PriorityQueue();
+		explicit PriorityQueue(const value_compare& compare);
+		template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+		PriorityQueue(InputIt first, InputIt last, const value_compare& compare = value_compare());
+		PriorityQueue(std::initializer_list<T> list, const value_compare& compare = value_compare());
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		void reserve(size_type size);
+		
+		// Element insertion and deletion
+		void push(const T& value);
+		void push(T&& value);
+		template <typename... Args>
+		void emplace(Args&&... args);
+		void pop();
+		
+		// Data Access
+		const T& top() const;
+		
+	private:
+		// The heap, in the order described above.
+		DynamicArray<T> m_elements;
+		// The comparison that decides which elements rank higher.
+		value_compare m_compare;
+		
+		void m_heapify();
+		void m_siftUp(size_type position);
+		void m_siftDown(size_type position);
+};
+
+/**
+ * A priority queue of the items numbered from 0 up to a capacity, each with
+ * a priority, kept in a D-ary heap.
+ *
+ * Each item can be in the queue at most once.
+ */
+template <typename Priority, typename Compare = std::less<Priority>, size_t D = PRIORITYQUEUE_DEFAULT_ARITY>
+class IndexedPriorityQueue {
+	static_assert(D >= 2, "A heap needs at least two children per element");
+	
+	public:
+		typedef size_t size_type;
+		typedef Compare value_compare;
+		
+		// Constructors
+		explicit IndexedPriorityQueue(size_type capacity, const value_compare& compare = value_compare());
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		size_type capacity() const;
+		
+		// Item insertion and deletion
+		void push(size_type index, const Priority& priority);
+		void decrease_key(size_type index, const Priority& priority);
+		void pop();
+		
+		// Data Access
+		bool contains(size_type index) const;
+		const Priority& priority(size_type index) const;
+		size_type top() const;
+		const Priority& top_priority() const;
+		
+	private:
+		struct Entry {
+			Priority priority;
+			size_type index;
+		};
+		
+		// The heap, in the order described above.
+		DynamicArray<Entry> m_entries;
+		// Where in the heap each item is, or PRIORITYQUEUE_ABSENT.
+		DynamicArray<size_type> m_positions;
+		// The comparison that decides which priorities rank higher.
+		value_compare m_compare;
+		
+		void m_place(size_type position, Entry&& entry);
+		void m_siftUp(size_type position, Entry entry);
+		void m_siftDown(size_type position, Entry entry);
+};
+
+// ---------------------- //
+// PriorityQueue Methods //
+// ---------------------- //
+/**
+ * Creates an empty queue.
+ */
+template <typename T, typename Compare, size_t D>
+PriorityQueue<T, Compare, D>::PriorityQueue()
+	: PriorityQueue(value_compare())
+{}
+/**
+ * Creates an empty queue with a given comparison.
+ * @param	compare	Gives whether its first argument ranks lower than its
+ * 	second
+ */
+template <typename T, typename Compare, size_t D>
+PriorityQueue<T, Compare, D>::PriorityQueue(const value_compare& compare)
+	: m_elements(), m_compare(compare)
+{}
+/**
+ * Creates a queue of the elements of a range.
+ *
+ * The elements are all added first and then arranged into a heap from the
+ * bottom up, which takes O(n) time rather than the O(n log n) of pushing
+ * them one at a time.
+ *
+ * @param	first	The start of the range
+ * @param	last	The end of the range
+ * @param	compare	Gives whether its first argument ranks lower than its
+ * 	second
+ */
+template <typename T, typename Compare, size_t D>
+template <typename InputIt, typename>
+PriorityQueue<T, Compare, D>::PriorityQueue(InputIt first, InputIt last, const value_compare& compare)
+	: PriorityQueue(compare)
+{
+	for (; first != last; ++first) {
+		m_elements.push_back(*first);
+	}
+	m_heapify();
+}
+/**
+ * Creates a queue of the elements of a list.
+ * @param	list	The elements
+ * @param	compare	Gives whether its first argument ranks lower than its
+ * 	second
+ */
+template <typename T, typename Compare, size_t D>
+PriorityQueue<T, Compare, D>::PriorityQueue(std::initializer_list<T> list, const value_compare& compare)
+	: PriorityQueue(list.begin(), list.end(), compare)
+{}
+
+/**
+ * Reports the number of elements in the queue.
+ * @return	The number of elements
+ */
+template <typename T, typename Compare, size_t D>
+typename PriorityQueue<T, Compare, D>::size_type PriorityQueue<T, Compare, D>::size() const {
+	return m_elements.size();
+}
+/**
+ * Reports whether the queue is empty.
+ * @return	Whether there are no elements in the queue
+ */
+template <typename T, typename Compare, size_t D>
+bool PriorityQueue<T, Compare, D>::empty() const {
+	return m_elements.empty();
+}
+/**
+ * Reserves room for a number of elements, so that pushing that many doesn't
+ * have to grow the underlying array.
+ * @param	size	The number of elements to make room for
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::reserve(size_type size) {
+	m_elements.reserve(size);
+}
+
+/**
+ * Adds an element to the queue.
+ * @param	value	The element
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::push(const T& value) {
+	m_elements.push_back(value);
+	m_siftUp(m_elements.size() - 1);
+}
+/**
+ * Adds an element to the queue, moving it in.
+ * @param	value	The element
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::push(T&& value) {
+	m_elements.push_back(std::move(value));
+	m_siftUp(m_elements.size() - 1);
+}
+/**
+ * Adds an element to the queue, constructing it in place.
+ * @param	args	The arguments to construct the element with
+ */
+template <typename T, typename Compare, size_t D>
+template <typename... Args>
+void PriorityQueue<T, Compare, D>::emplace(Args&&... args) {
+	m_elements.emplace_back(std::forward<Args>(args)...);
+	m_siftUp(m_elements.size() - 1);
+}
+/**
+ * Removes the element at the top of the queue.
+ * @throws	OutOfBoundsError	when the queue is empty
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::pop() {
+	FUNDAMENTALS_CHECK_BOUNDS(!m_elements.empty());
+	
+	// The last element fills the hole at the top, then moves down into place
+	if (m_elements.size() > 1) {
+		m_elements[0] = std::move(m_elements.back());
+	}
+	m_elements.pop_back();
+	if (m_elements.size() > 1) {
+		m_siftDown(0);
+	}
+}
+
+/**
+ * Provides the element at the top of the queue.
+ * @throws	OutOfBoundsError	when the queue is empty
+ * @return	A constant reference to the highest ranking element
+ */
+template <typename T, typename Compare, size_t D>
+const T& PriorityQueue<T, Compare, D>::top() const {
+	FUNDAMENTALS_CHECK_BOUNDS(!m_elements.empty());
+	
+	return m_elements[0];
+}
+
+/**
+ * Arranges the underlying array into a heap.
+ *
+ * Each element with children is moved down into place, starting from the
+ * last of them, so that both of the subtrees under an element are already
+ * heaps when it is moved. Most elements are near the bottom and only move a
+ * short way, which is why this takes O(n) time.
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::m_heapify() {
+	const size_type size = m_elements.size();
+	if (size < 2) {
+		return;
+	}
+	
+	for (size_type position = (size - 2) / D + 1; position > 0; --position) {
+		m_siftDown(position - 1);
+	}
+}
+/**
+ * Moves an element up until its parent ranks at least as high as it.
+ *
+ * Rather than swapping at every level, the element is held aside while the
+ * parents it passes are moved down into the hole it leaves.
+ *
+ * @param	position	The position of the element
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::m_siftUp(size_type position) {
+	T value = std::move(m_elements[position]);
+	
+	while (position > 0) {
+		size_type parent = (position - 1) / D;
+		if (!m_compare(m_elements[parent], value)) {
+			break;
+		}
+		m_elements[position] = std::move(m_elements[parent]);
+		position = parent;
+	}
+	
+	m_elements[position] = std::move(value);
+}
+/**
+ * Moves an element down until none of its children rank higher than it.
+ * @param	position	The position of the element
+ */
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::m_siftDown(size_type position) {
+	const size_type size = m_elements.size();
+	T value = std::move(m_elements[position]);
+	
+	while (D * position + 1 < size) {
+		size_type first = D * position + 1;
+		size_type last = size - first < D ? size : first + D;
+		size_type highest = first;
+		for (size_type child = first + 1; child < last; ++child) {
+			if (m_compare(m_elements[highest], m_elements[child])) {
+				highest = child;
+			}
+		}
+		if (!m_compare(value, m_elements[highest])) {
+			break;
+		}
+		m_elements[position] = std::move(m_elements[highest]);
+		position = highest;
+	}
+	
+	m_elements[position] = std::move(value);
+}
+
+// ----------------------------- //
+// IndexedPriorityQueue Methods //
+// ----------------------------- //
+/**
+ * Creates an empty queue for the items numbered below a capacity.
+ * @param	capacity	One more than the greatest item number
+ * @param	compare	Gives whether its first argument ranks lower than its
+ * 	second
+ */
+template <typename Priority, typename Compare, size_t D>
+IndexedPriorityQueue<Priority, Compare, D>::IndexedPriorityQueue(size_type capacity, const value_compare& compare)
+	: m_entries(), m_positions(capacity, PRIORITYQUEUE_ABSENT), m_compare(compare)
+{}
+
+/**
+ * Reports the number of items in the queue.
+ * @return	The number of items
+ */
+template <typename Priority, typename Compare, size_t D>
+typename IndexedPriorityQueue<Priority, Compare, D>::size_type IndexedPriorityQueue<Priority, Compare, D>::size() const {
+	return m_entries.size();
+}
+/**
+ * Reports whether the queue is empty.
+ * @return	Whether there are no items in the queue
+ */
+template <typename Priority, typename Compare, size_t D>
+bool IndexedPriorityQueue<Priority, Compare, D>::empty() const {
+	return m_entries.empty();
+}
+/**
+ * Reports how many items the queue is for.
+ * @return	One more than the greatest item number
+ */
+template <typename Priority, typename Compare, size_t D>
+typename IndexedPriorityQueue<Priority, Compare, D>::size_type IndexedPriorityQueue<Priority, Compare, D>::capacity() const {
+	return m_positions.size();
+}
+
+/**
+ * Adds an item to the queue.
+ * @throws	OutOfBoundsError	when index is not below the capacity
+ * @throws	DuplicateKeyError	when the item is already in the queue
+ * @param	index	The number of the item
+ * @param	priority	The priority of the item
+ */
+template <typename Priority, typename Compare, size_t D>
+void IndexedPriorityQueue<Priority, Compare, D>::push(size_type index, const Priority& priority) {
+	if (m_positions[index] != PRIORITYQUEUE_ABSENT) {
+		throw DuplicateKeyError();
+	}
+	
+	m_entries.push_back(Entry{priority, index});
+	m_siftUp(m_entries.size() - 1, Entry{priority, index});
+}
+/**
+ * Changes the priority of an item in the queue.
+ *
+ * This is meant for raising an item's rank, which with std::greater means
+ * lowering its priority (hence the name), such as when dijkstra finds a
+ * shorter path to a vertex. An item whose rank is lowered instead moves down
+ * the heap, so this works either way.
+ *
+ * @throws	OutOfBoundsError	when index is not below the capacity
+ * @throws	MissingKeyError	when the item isn't in the queue
+ * @param	index	The number of the item
+ * @param	priority	The new priority of the item
+ */
+template <typename Priority, typename Compare, size_t D>
+void IndexedPriorityQueue<Priority, Compare, D>::decrease_key(size_type index, const Priority& priority) {
+	size_type position = m_positions[index];
+	if (position == PRIORITYQUEUE_ABSENT) {
+		throw MissingKeyError();
+	}
+	
+	if (m_compare(m_entries[position].priority, priority)) {
+		m_siftUp(position, Entry{priority, index});
+	}
+	else {
+		m_siftDown(position, Entry{priority, index});
+	}
+}
+/**
+ * Removes the item at the top of the queue.
+ * @throws	OutOfBoundsError	when the queue is empty
+ */
+template <typename Priority, typename Compare, size_t D>
+void IndexedPriorityQueue<Priority, Compare, D>::pop() {
+	FUNDAMENTALS_CHECK_BOUNDS(!m_entries.empty());
+	
+	m_positions[m_entries[0].index] = PRIORITYQUEUE_ABSENT;
+	Entry last = std::move(m_entries.back());
+	m_entries.pop_back();
+	if (!m_entries.empty()) {
+		m_siftDown(0, std::move(last));
+	}
+}
+
+/**
+ * Checks if an item is in the queue.
+ * @throws	OutOfBoundsError	when index is not below the capacity
+ * @param	index	The number of the item
+ * @return	Whether the item is in the queue
+ */
+template <typename Priority, typename Compare, size_t D>
+bool IndexedPriorityQueue<Priority, Compare, D>::contains(size_type index) const {
+	return m_positions[index] != PRIORITYQUEUE_ABSENT;
+}
+/**
+ * Gives the priority of an item in the queue.
+ * @throws	OutOfBoundsError	when index is not below the capacity
+ * @throws	MissingKeyError	when the item isn't in the queue
+ * @param	index	The number of the item
+ * @return	A constant reference to its priority
+ */
+template <typename Priority, typename Compare, size_t D>
+const Priority& IndexedPriorityQueue<Priority, Compare, D>::priority(size_type index) const {
+	size_type position = m_positions[index];
+	if (position == PRIORITYQUEUE_ABSENT) {
+		throw MissingKeyError();
+	}
+	
+	return m_entries[position].priority;
+}
+/**
+ * Gives the item at the top of the queue.
+ * @throws	OutOfBoundsError	when the queue is empty
+ * @return	The number of the highest ranking item
+ */
+template <typename Priority, typename Compare, size_t D>
+typename IndexedPriorityQueue<Priority, Compare, D>::size_type IndexedPriorityQueue<Priority, Compare, D>::top() const {
+	FUNDAMENTALS_CHECK_BOUNDS(!m_entries.empty());
+	
+	return m_entries[0].index;
+}
+/**
+ * Gives the priority of the item at the top of the queue.
+ * @throws	OutOfBoundsError	when the queue is empty
+ * @return	A constant reference to the highest ranking priority
+ */
+template <typename Priority, typename Compare, size_t D>
+const Priority& IndexedPriorityQueue<Priority, Compare, D>::top_priority() const {
+	FUNDAMENTALS_CHECK_BOUNDS(!m_entries.empty());
+	
+	return m_entries[0].priority;
+}
+
+/**
+ * Puts an entry at a position in the heap, and records where it is.
+ * @param	position	The position
+ * @param	entry	The entry
+ */
+template <typename Priority, typename Compare, size_t D>
+void IndexedPriorityQueue<Priority, Compare, D>::m_place(size_type position, Entry&& entry) {
+	m_positions[entry.index] = position;
+	m_entries[position] = std::move(entry);
+}
+/**
+ * Moves an entry up from a position until its parent ranks at least as high.
+ * @param	position	The position it starts at, whose old entry is dropped
+ * @param	entry	The entry
+ */
+template <typename Priority, typename Compare, size_t D>
+void IndexedPriorityQueue<Priority, Compare, D>::m_siftUp(size_type position, Entry entry) {
+	while (position > 0) {
+		size_type parent = (position - 1) / D;
+		if (!m_compare(m_entries[parent].priority, entry.priority)) {
+			break;
+		}
+		m_place(position, std::move(m_entries[parent]));
+		position = parent;
+	}
+	
+	m_place(position, std::move(entry));
+}
+/**
+ * Moves an entry down from a position until none of its children rank
+ * higher than it.
+ * @param	position	The position it starts at, whose old entry is dropped
+ * @param	entry	The entry
+ */
+template <typename Priority, typename Compare, size_t D>
+void IndexedPriorityQueue<Priority, Compare, D>::m_siftDown(size_type position, Entry entry) {
+	const size_type size = m_entries.size();
+	
+	while (D * position + 1 < size) {
+		size_type first = D * position + 1;
+		size_type last = size - first < D ? size : first + D;
+		size_type highest = first;
+		for (size_type child = first + 1; child < last; ++child) {
+			if (m_compare(m_entries[highest].priority, m_entries[child].priority)) {
+				highest = child;
+			}
+		}
+		if (!m_compare(entry.priority, m_entries[highest].priority)) {
+			break;
+		}
+		m_place(position, std::move(m_entries[highest]));
+		position = highest;
+	}
+	
+	m_place(position, std::move(entry));
+}
+
+#endif // Fundamentals_PriorityQueue_hpp_
@@ -0,0 +1,454 @@
+/**
+ * Fundamentals :: Data Structures :: Read-Mostly Hash Map
+ * Author: Quinn Mortimer
+ *
+ * This is a hash map for tables that are read from many threads far more
+ * often than they are changed, like a table of configuration settings.
+ * Lookups never take a lock, and never wait for a writer.
+ */
+/**
+ * The idea is that the map is never changed while anyone might be reading
+ * it. Instead, a writer copies the current HashMap, changes the copy, and then
+ * publishes it by swapping an atomic pointer. Readers that started before the
+ * swap carry on using the old table, while readers that start afterwards see
+ * the new one.
+ *
+ * The tricky part is knowing when the old table can be deleted. For that we
+ * use two generations (epochs) of reader counts. A reader adds itself to the
+ * count for the current epoch before loading the pointer, and removes itself
+ * when it is done. After publishing a new table, a writer moves on to the next
+ * epoch and waits for the count of the previous one to drain to zero. Any
+ * reader that could have seen the old table was counted in that epoch, so
+ * once it is zero the old table can be deleted.
+ *
+ * Every change copies the whole table, so changes are slow. The update method
+ * makes any number of changes on a single copy, which helps when there are
+ * several to make at once.
+ *
+ * We will be using std::atomic and std::mutex from the standard library.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Exceptions.hpp"
+#include "HashMap.hpp"
+#include "Hashing.hpp"
+#include "HashProbes.hpp"
+
+#ifndef Fundamentals_ReadMostlyHashMap_hpp_
+#define Fundamentals_ReadMostlyHashMap_hpp_
+
+// Reader counts are spread over this many cache lines, so that readers on
+// different cores mostly update different lines
+#define READMOSTLYHASHMAP_READER_SLOTS 16
+#define READMOSTLYHASHMAP_SLOT_ALIGNMENT 64
+
+/**
+ * The reader counts for both epochs, for one slot of readers.
+ */
+struct alignas(READMOSTLYHASHMAP_SLOT_ALIGNMENT) ReadMostlyHashMap_Slot {
+	std::atomic<size_t> readers[2];
+	
+	ReadMostlyHashMap_Slot();
+};
+
+/**
+ * A hash map with lock-free lookups, for tables that rarely change.
+ *
+ * Values are returned by copy, since the table a reference pointed into
+ * could be deleted as soon as the lookup finished.
+ *
+ * The Probe and Hash parameters are passed on to the HashMap that holds the
+ * contents, and are described there.
+ */
+template <typename Key, typename Value, typename Probe = PerturbProbe, typename Hash = DefaultHashFor<Key>>
+class ReadMostlyHashMap {
+	public:
+		typedef size_t size_type;
+		typedef Hash hash_type;
+		typedef HashMap<Key, Value, Probe, Hash> table_type;
+		
+		// Constructors
+		ReadMostlyHashMap();
+		ReadMostlyHashMap(const hash_type& hash);
+		ReadMostlyHashMap(const table_type& table);
+		
+		// Readers could be using the table, so it can't be copied or moved
+		ReadMostlyHashMap(const ReadMostlyHashMap<Key, Value, Probe, Hash>& other) = delete;
+		ReadMostlyHashMap<Key, Value, Probe, Hash>& operator=(const ReadMostlyHashMap<Key, Value, Probe, Hash>& other) = delete;
+		
+		// Destructor
+		~ReadMostlyHashMap();
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Element insertion and deletion
+		// - Functions that can throw exceptions
+		void insert(const Key& k, const Value& v);
+		void remove(const Key& k);
+		// - Function that will not throw exceptions
+		void set(const Key& k, const Value& v);
+		void unset(const Key& k);
+		// - Makes any number of changes to a single copy of the table
+		template <typename Function>
+		void update(Function function);
+		
+		// Data Access
+		// - Check for a key
+		bool hasKey(const Key& k) const;
+		// - Get elements by key
+		Value getValue(const Key& k) const;
+		bool find(const Key& k, Value& out) const;
+		// - Get a copy of the whole table
+		table_type snapshot() const;
+		
+	private:
+		/**
+		 * Counts a reader in for as long as it exists.
+		 *
+		 * While one of these exists, the table it loaded won't be deleted.
+		 */
+		class Reader {
+			public:
+				Reader(const ReadMostlyHashMap<Key, Value, Probe, Hash>& owner);
+				~Reader();
+				
+				const table_type& table() const;
+				
+			private:
+				std::atomic<size_t>& r_count;
+				const table_type* mp_table;
+				
+				static std::atomic<size_t>& m_enter(const ReadMostlyHashMap<Key, Value, Probe, Hash>& owner);
+		};
+		
+		// The table readers should use.
+		std::atomic<const table_type*> mp_table;
+		// The current epoch, only the lowest bit of which is used by readers.
+		std::atomic<size_t> m_epoch;
+		// The reader counts.
+		mutable ReadMostlyHashMap_Slot m_slots[READMOSTLYHASHMAP_READER_SLOTS];
+		// Only one writer at a time.
+		std::mutex m_writeMutex;
+		
+		// Replaces the published table, and deletes the old one when it's safe.
+		void m_publish(const table_type* table);
+		// Waits for every reader counted in an epoch to be done.
+		void m_drain(size_t epoch) const;
+		
+		// Picks the slot that the calling thread counts itself in.
+		static size_type m_slotIndex();
+};
+
+// ------------------------------- //
+// ReadMostlyHashMap_Slot Methods //
+// ------------------------------- //
+/**
+ * Constructs a slot with no readers.
+ */
+inline ReadMostlyHashMap_Slot::ReadMostlyHashMap_Slot() {
+	readers[0].store(0);
+	readers[1].store(0);
+}
+
+// -------------------------- //
+// ReadMostlyHashMap Methods //
+// -------------------------- //
+/**
+ * Constructs an empty ReadMostlyHashMap with a default-constructed hash.
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ReadMostlyHashMap<Key, Value, Probe, Hash>::ReadMostlyHashMap()
+	: ReadMostlyHashMap(hash_type())
+{}
+/**
+ * Constructs an empty ReadMostlyHashMap.
+ * @param	hash	The hash function for this to use
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ReadMostlyHashMap<Key, Value, Probe, Hash>::ReadMostlyHashMap(const hash_type& hash)
+	: mp_table(new table_type(hash)), m_epoch(0)
+{}
+/**
+ * Constructs a ReadMostlyHashMap holding a copy of a HashMap.
+ *
+ * This is the quickest way to fill in a table, since the contents are only
+ * copied once.
+ *
+ * @param	table	The HashMap to copy
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ReadMostlyHashMap<Key, Value, Probe, Hash>::ReadMostlyHashMap(const table_type& table)
+	: mp_table(new table_type(table)), m_epoch(0)
+{}
+/**
+ * Deletes the table.
+ *
+ * No other thread can be using the map while it is destroyed.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ReadMostlyHashMap<Key, Value, Probe, Hash>::~ReadMostlyHashMap() {
+	delete mp_table.load();
+}
+
+/**
+ * Reports the number of key-value pairs in the map.
+ * @return	The number of valid key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename ReadMostlyHashMap<Key, Value, Probe, Hash>::size_type ReadMostlyHashMap<Key, Value, Probe, Hash>::size() const {
+	Reader reader(*this);
+	return reader.table().size();
+}
+/**
+ * Reports whether or not the map is empty.
+ * @return	Whether there are any key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ReadMostlyHashMap<Key, Value, Probe, Hash>::empty() const {
+	Reader reader(*this);
+	return reader.table().empty();
+}
+
+/**
+ * Insert a key-value pair into the map.
+ * @throws	DuplicateKeyError	When the key provided is already in the map
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::insert(const Key& key, const Value& value) {
+	update([&](table_type& table) { table.insert(key, value); });
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ * @throws	MissingKeyError	If the requested key is not in the map
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::remove(const Key& key) {
+	update([&](table_type& table) { table.remove(key); });
+}
+/**
+ * Sets the value corresponding to a key in this map.
+ *
+ * If the key was already in the map, it will just overwrite the old value.
+ *
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::set(const Key& key, const Value& value) {
+	update([&](table_type& table) { table.set(key, value); });
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ *
+ * If the key was not in the map in the first place, nothing is published.
+ *
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::unset(const Key& key) {
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+	
+	// Writers are serialised, so the table can't change under us here
+	const table_type* current = mp_table.load();
+	if (!current->hasKey(key)) {
+		return;
+	}
+	
+	table_type* next = new table_type(*current);
+	next->unset(key);
+	m_publish(next);
+}
+/**
+ * Makes changes to a copy of the table, then publishes the copy.
+ *
+ * The function is called with a reference to the copy, which it can change
+ * in any way. Readers will either see none of the changes or all of them.
+ * If the function throws, nothing is published and the exception is passed
+ * on to the caller.
+ *
+ * The function must not use this map, as the write lock is held while it runs.
+ *
+ * @param	function	Called with a HashMap& to make the changes
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+template <typename Function>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::update(Function function) {
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+	
+	table_type* next = new table_type(*mp_table.load());
+	try {
+		function(*next);
+	}
+	catch (...) {
+		delete next;
+		throw;
+	}
+	
+	m_publish(next);
+}
+
+/**
+ * Checks if a key is currently in the map.
+ * @param	key	The key to check for
+ * @return	A boolean representing whether or not the key exists
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ReadMostlyHashMap<Key, Value, Probe, Hash>::hasKey(const Key& key) const {
+	Reader reader(*this);
+	return reader.table().hasKey(key);
+}
+/**
+ * Gets a copy of the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A copy of the value key refers to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+Value ReadMostlyHashMap<Key, Value, Probe, Hash>::getValue(const Key& key) const {
+	Reader reader(*this);
+	return reader.table().getValue(key);
+}
+/**
+ * Copies out the value stored at a key, if there is one.
+ * @param	key	The key to get the mapped value for
+ * @param	out	Where the value is copied to when the key is found
+ * @return	true if the key was found, in which case out has been assigned
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+bool ReadMostlyHashMap<Key, Value, Probe, Hash>::find(const Key& key, Value& out) const {
+	Reader reader(*this);
+	
+	const table_type& table = reader.table();
+	const Value* found = table.find(key);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	out = *found;
+	return true;
+}
+/**
+ * Copies the whole table as it is right now.
+ *
+ * This is useful for looking at several keys at once and knowing that no
+ * writer changed anything in between.
+ *
+ * @return	A copy of the current table
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename ReadMostlyHashMap<Key, Value, Probe, Hash>::table_type ReadMostlyHashMap<Key, Value, Probe, Hash>::snapshot() const {
+	Reader reader(*this);
+	return reader.table();
+}
+
+/**
+ * Replaces the published table, then deletes the old one.
+ *
+ * Once the new table is stored, readers that start from now on can only get
+ * the new one. Moving to the next epoch and waiting for the previous epoch to
+ * drain waits out every reader that could still be using the old one.
+ *
+ * The write lock must be held.
+ *
+ * @param	table	The new table, which this map takes ownership of
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::m_publish(const table_type* table) {
+	const table_type* old = mp_table.exchange(table);
+	
+	size_t epoch = m_epoch.fetch_add(1);
+	m_drain(epoch);
+	
+	delete old;
+}
+/**
+ * Waits for every reader counted in an epoch to be done.
+ * @param	epoch	The epoch to wait for
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+void ReadMostlyHashMap<Key, Value, Probe, Hash>::m_drain(size_t epoch) const {
+	for (size_type i = 0; i < READMOSTLYHASHMAP_READER_SLOTS; ++i) {
+		while (m_slots[i].readers[epoch & 1].load() != 0) {
+			std::this_thread::yield();
+		}
+	}
+}
+/**
+ * Picks the slot that the calling thread counts itself in.
+ *
+ * Threads are handed slots in turn the first time they read, and keep using
+ * the same one afterwards.
+ *
+ * @return	The index of the slot for this thread
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+typename ReadMostlyHashMap<Key, Value, Probe, Hash>::size_type ReadMostlyHashMap<Key, Value, Probe, Hash>::m_slotIndex() {
+	static std::atomic<size_type> nextSlot(0);
+	thread_local size_type slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % READMOSTLYHASHMAP_READER_SLOTS;
+	return slot;
+}
+
+// ---------------------------------- //
+// ReadMostlyHashMap::Reader Methods //
+// ---------------------------------- //
+/**
+ * Counts a reader in and loads the current table.
+ * @param	owner	The map to read from
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ReadMostlyHashMap<Key, Value, Probe, Hash>::Reader::Reader(const ReadMostlyHashMap<Key, Value, Probe, Hash>& owner)
+	: r_count(m_enter(owner)), mp_table(owner.mp_table.load())
+{}
+/**
+ * Counts the reader out again, allowing the table to be deleted.
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+ReadMostlyHashMap<Key, Value, Probe, Hash>::Reader::~Reader() {
+	r_count.fetch_sub(1);
+}
+/**
+ * Provides the table that was loaded.
+ * @return	The table, which stays valid for as long as the reader exists
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+const typename ReadMostlyHashMap<Key, Value, Probe, Hash>::table_type& ReadMostlyHashMap<Key, Value, Probe, Hash>::Reader::table() const {
+	return *mp_table;
+}
+/**
+ * Adds a reader to the count for the current epoch.
+ *
+ * If a writer moves to the next epoch between reading the epoch and adding to
+ * its count, the writer might have already checked that count. So we check
+ * that the epoch is still the same afterwards, and try again if it isn't.
+ *
+ * @param	owner	The map to read from
+ * @return	The count that the reader was added to
+ */
+template <typename Key, typename Value, typename Probe, typename Hash>
+std::atomic<size_t>& ReadMostlyHashMap<Key, Value, Probe, Hash>::Reader::m_enter(const ReadMostlyHashMap<Key, Value, Probe, Hash>& owner) {
+	ReadMostlyHashMap_Slot& slot = owner.m_slots[m_slotIndex()];
+	
+	while (true) {
+		size_t epoch = owner.m_epoch.load();
+		std::atomic<size_t>& count = slot.readers[epoch & 1];
+		
+		count.fetch_add(1);
+		if (owner.m_epoch.load() == epoch) {
+			return count;
+		}
+		count.fetch_sub(1);
+	}
+}
+
+#endif // Fundamentals_ReadMostlyHashMap_hpp_
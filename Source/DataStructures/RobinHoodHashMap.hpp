@@ -0,0 +1,1417 @@
+/**
+ * Fundamentals :: Data Structures :: Robin Hood Hash Map
+ * Author: Quinn Mortimer
+ *
+ * This is a hash map that uses Robin Hood hashing, a version of linear
+ * probing that keeps every key close to where its probe sequence starts.
+ * It has the same interface as HashMap, and throws the same errors.
+ */
+/**
+ * With linear probing, a key that can't go in its home slot (the slot its hash
+ * picks) goes in the next free slot after it. The distance of a key is how
+ * many slots past its home it ended up. Left alone, some keys end up a long
+ * way from home while others sit right in theirs, and lookups for the far
+ * ones are slow.
+ *
+ * Robin Hood hashing evens this out. While a new key walks along looking for
+ * a free slot, it passes keys that are already there. As soon as it reaches a
+ * key that is closer to its home than the new key is to its own, the new key
+ * takes that slot, and everything from there up to the next free slot moves
+ * along by one. This keeps the keys in each run of full slots in the order of
+ * their home slots, and the distances stay short and alike even when the
+ * table is nearly full. That's why this map can be allowed to get fuller than
+ * HashMap before it grows, which makes its table smaller for the same keys.
+ *
+ * It also means a lookup can stop early. If it reaches a key that is closer
+ * to its home than the key being looked for would be at that slot, the key
+ * being looked for would have taken that slot, so it can't be in the map.
+ *
+ * Removing a key doesn't leave a tombstone behind. Instead, the keys after it
+ * in the same run move back by one slot (a backward shift), until reaching a
+ * free slot or a key that is already in its home slot. The table is then
+ * exactly as it would have been if the key had never been added, so removals
+ * never slow down later lookups.
+ *
+ * As with HashMap, we will be using std::vector, std::move and std::swap from
+ * the standard library.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Exceptions.hpp"
+#include "Hashing.hpp"
+#include "HashStats.hpp"
+
+#ifndef Fundamentals_RobinHoodHashMap_hpp_
+#define Fundamentals_RobinHoodHashMap_hpp_
+
+// Table sizes are always powers of two, so both of these must be as well
+#define ROBINHOODHASHMAP_DEFAULT_CAPACITY 8
+#define ROBINHOODHASHMAP_GROWTH_FACTOR 2
+// This must leave at least one slot free in the smallest table, so that every
+// probe sequence reaches a free slot
+#define ROBINHOODHASHMAP_MAX_LOAD_FACTOR 0.9
+// The number of keys that find_many hashes and prefetches at a time
+#define ROBINHOODHASHMAP_BATCH_SIZE 16
+
+/**
+ * A Node class for the slots in a RobinHoodHashMap.
+ *
+ * Stores the key, value and hash of the key, and whether the node is full.
+ * There are no tombstones, so a node is only ever full or empty.
+ *
+ * The hash is what the map works out each key's distance from, since the
+ * home slot of a key is just its hash masked to the size of the table.
+ */
+template <typename Key, typename Value>
+class RobinHoodHashMap_Node {
+public:
+	// Constructor and destructor for a node.
+	// The map clears its nodes before destroying them, so the destructor
+	// doesn't destroy the key and value itself.
+	RobinHoodHashMap_Node();
+	~RobinHoodHashMap_Node() = default;
+	
+	// As with HashMap_Node, copying nodes is never needed, and copying
+	// the raw storage wouldn't be safe.
+	RobinHoodHashMap_Node(const RobinHoodHashMap_Node& other) = delete;
+	
+	// Set or clear the values on this node.
+	// The allocator is the one for the table, and is only used to construct
+	// and destroy the key and value.
+	template <typename Allocator>
+	void set(Allocator allocator, const Key& k, const Value& v, size_t hash);
+	template <typename Allocator>
+	void take(Allocator allocator, RobinHoodHashMap_Node& other, Allocator otherAllocator);
+	template <typename Allocator>
+	void clear(Allocator allocator);
+	
+	// Informational queries on this node.
+	bool empty() const;
+	template <typename K>
+	bool keyEqual(const K& k, size_t hash) const;
+	
+	// Access to this node's important data members.
+	const Key& key() const;
+	const Value& value() const;
+	Value& value();
+	size_t hash() const;
+private:
+	// Storage for the key and value of the node.
+	// These are only constructed while the node is full.
+	alignas(Key) unsigned char m_keyStorage[sizeof(Key)];
+	alignas(Value) unsigned char m_valueStorage[sizeof(Value)];
+	// The hash of the key, kept so that distances can be worked out and the
+	// table can be resized without hashing every key again.
+	size_t m_hashValue;
+	// Whether the node currently holds a key and a value.
+	bool m_full;
+};
+
+/**
+ * A hash map using Robin Hood hashing with backward-shift deletion.
+ *
+ * The Hash and Allocator parameters are the same as for HashMap. There is no
+ * Probe parameter, since Robin Hood hashing moves keys around as it inserts
+ * and removes them, which a probing policy has no way to do.
+ */
+template <typename Key, typename Value, typename Hash = DefaultHashFor<Key>, typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class RobinHoodHashMap : private HashHolder<Hash> {
+	public:
+		typedef size_t size_type;
+		typedef Hash hash_type;
+		typedef Allocator allocator_type;
+		
+		// Constructors
+		RobinHoodHashMap();
+		explicit RobinHoodHashMap(const allocator_type& allocator);
+		RobinHoodHashMap(const hash_type& hash, const allocator_type& allocator = allocator_type());
+		RobinHoodHashMap(const hash_type& hash, size_type size, const allocator_type& allocator = allocator_type());
+		RobinHoodHashMap(RobinHoodHashMap<Key, Value, Hash, Allocator>&& other);
+		RobinHoodHashMap(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other);
+		RobinHoodHashMap(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other, const allocator_type& allocator);
+		
+		// Destructor
+		~RobinHoodHashMap();
+		
+		// Assignment
+		RobinHoodHashMap<Key, Value, Hash, Allocator>& operator=(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other);
+		RobinHoodHashMap<Key, Value, Hash, Allocator>& operator=(RobinHoodHashMap<Key, Value, Hash, Allocator>&& other);
+		
+		// Equality Testing
+		bool operator==(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other) const;
+		bool operator!=(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other) const;
+		
+		// Access to the allocator
+		allocator_type get_allocator() const;
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Control over the size of the underlying array
+		size_type capacity() const;
+		void reserve(size_type size);
+		void shrink_to_fit();
+
+#if FUNDAMENTALS_HASH_STATS
+		// Statistics about the underlying array
+		HashStats stats() const;
+#endif
+
+		// Element insertion and deletion
+		// - Functions that can throw exceptions
+		void insert(const Key& k, const Value& v);
+		void remove(const Key& k);
+		// - Function that will not throw exceptions
+		void set(const Key& k, const Value& v);
+		void unset(const Key& k);
+		
+		// Data Access
+		// - Check for a key
+		bool hasKey(const Key& k) const;
+		// - Get elements by key
+		Value& operator[](const Key& k);
+		const Value& operator[](const Key& k) const;
+		Value& getValue(const Key& k);
+		const Value& getValue(const Key& k) const;
+		// - Look up keys that might be missing without exceptions
+		Value* find(const Key& k);
+		const Value* find(const Key& k) const;
+		bool try_get(const Key& k, Value& value) const;
+		// - Look up keys of other types, when the hash function allows it
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		bool hasKey(const K& k) const;
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		Value& getValue(const K& k);
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		const Value& getValue(const K& k) const;
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		Value* find(const K& k);
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		const Value* find(const K& k) const;
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		bool try_get(const K& k, Value& value) const;
+		// - Look up many keys at once
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		void find_many(const K* keys, size_type count, Value** results);
+		template <typename K, typename = HashLookupEnable<Hash, Key, K>>
+		void find_many(const K* keys, size_type count, const Value** results) const;
+		// - Get all keys or all values
+		std::vector<Key> keys() const;
+		std::vector<Value> values() const;
+		
+	private:
+		typedef RobinHoodHashMap_Node<Key, Value> Node;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+		
+		// The number of used slots in the underlying array.
+		size_type m_size;
+		// The size at which we will consider our map too crowded.
+		size_type m_loadThreshold;
+		// The underlying array of nodes for our map.
+		std::vector<Node, NodeAllocator> m_nodes;
+#if FUNDAMENTALS_HASH_STATS
+		// The rehashes this map has done, for its stats.
+		HashStats_Counters m_counters;
+#endif
+
+		// These are utilites for internal use.
+		// - Used to resize and rehash when the load factor is too big.
+		bool m_crowded() const;
+		void m_rehash();
+		void m_rehash(size_type size);
+		// - Moves a node from another table into this one during a rehash.
+		void m_moveIn(Node& node, const NodeAllocator& from);
+		// - Destroys the key and value of every node, through the allocator.
+		void m_clearNodes();
+		// - Swaps contents with another map.
+		void m_swap(RobinHoodHashMap<Key, Value, Hash, Allocator>& other);
+		// - Adds all keys in another map to the current map.
+		void m_update(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other);
+		
+		// The size of the underlying array for holding a number of keys.
+		static size_type m_tableSize(size_type size);
+		
+		// Applies the hash function to a key.
+		template <typename K>
+		size_type m_hash(const K& key) const;
+		// How far the key in a full slot is from its home slot.
+		size_type m_distance(size_type index) const;
+		
+		// Finds the slot holding a key, or the capacity if it's missing.
+		template <typename K>
+		size_type m_findIndex(const K& key) const;
+		template <typename K>
+		size_type m_findIndex(const K& key, size_type hashValue) const;
+		// Finds the slots for up to ROBINHOODHASHMAP_BATCH_SIZE keys at once.
+		template <typename K>
+		void m_findBatch(const K* keys, size_type count, size_type* indices) const;
+		// Finds the slot holding a key, or the slot it should be put in.
+		size_type m_findInsertIndex(const Key& key, size_type hashValue, bool& found) const;
+		// A lighter version of the above for keys known not to be in the map.
+		size_type m_findFreeIndex(size_type hashValue) const;
+		
+		// Moves keys forward to free a slot for a new key, or back to fill
+		// the slot of a removed one.
+		void m_shiftForward(size_type index);
+		void m_shiftBackward(size_type index);
+		// Puts a new key in the slot that m_findInsertIndex chose for it.
+		Value& m_insertAt(size_type index, const Key& key, const Value& value, size_type hashValue);
+		// Removes the key in a full slot.
+		void m_eraseAt(size_type index);
+};
+
+// ------------------------- //
+// RobinHoodHashMap Methods //
+// ------------------------- //
+/**
+ * Constructs a RobinHoodHashMap with a default-constructed hash function.
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap()
+	: RobinHoodHashMap(hash_type())
+{}
+/**
+ * Constructs a RobinHoodHashMap that gets its memory from an allocator.
+ * @throws	MissingHashFunctionError	when Hash is a HashFunction
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap(const allocator_type& allocator)
+	: RobinHoodHashMap(hash_type(), allocator)
+{}
+/**
+ * Constructs a RobinHoodHashMap from a hash function.
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	hash	The hash function for this to use
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap(const hash_type& hash, const allocator_type& allocator)
+	: RobinHoodHashMap(hash, 0, allocator)
+{}
+/**
+ * Constructs a RobinHoodHashMap from a hash function and a minimum load.
+ *
+ * The size is a number of keys that can be added to the map without needing
+ * to enlarge the underlying array and rehash.
+ *
+ * @throws	MissingHashFunctionError	when the hash function is not valid
+ * @param	hash	The hash function for this to use
+ * @param	size	An amount of elements the table should be able to hold
+ * @param	allocator	The allocator for this to use
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap(const hash_type& hash, size_type size, const allocator_type& allocator)
+	: HashHolder<Hash>(hash), m_nodes(m_tableSize(size), NodeAllocator(allocator))
+{
+	requireHashFunction(hash);
+	
+	m_size = 0;
+	m_loadThreshold = m_nodes.size() * ROBINHOODHASHMAP_MAX_LOAD_FACTOR;
+}
+/**
+ * Constructs a RobinHoodHashMap by copying the contents of another.
+ *
+ * The allocator is copied the way std::allocator_traits says it should be
+ * for a container copy.
+ *
+ * @param	other	The map to copy
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other)
+	: RobinHoodHashMap(other, allocator_type(std::allocator_traits<NodeAllocator>::select_on_container_copy_construction(other.m_nodes.get_allocator())))
+{}
+/**
+ * Constructs a RobinHoodHashMap by copying the contents of another, using a
+ * different allocator.
+ * @param	other	The map to copy
+ * @param	allocator	The allocator for the copy to use
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other, const allocator_type& allocator)
+	: HashHolder<Hash>(other.hashFunction()), m_nodes(other.m_nodes.size(), NodeAllocator(allocator))
+{
+	m_loadThreshold = other.m_loadThreshold;
+	m_size = 0;
+	
+	// The destructor won't run if this throws, so the nodes that were
+	// already copied have to be cleared here
+	try {
+		m_update(other);
+	}
+	catch (...) {
+		m_clearNodes();
+		throw;
+	}
+}
+/**
+ * Constructs a RobinHoodHashMap by swapping in the contents of another.
+ *
+ * The allocator is copied from the other map, so the memory can be freed by
+ * either of them. The other map is left with an empty table of the default
+ * capacity rather than none at all, so it can still be used.
+ *
+ * @param	other	The map to swap contents with
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::RobinHoodHashMap(RobinHoodHashMap<Key, Value, Hash, Allocator>&& other)
+	: RobinHoodHashMap(other.hashFunction(), 0, allocator_type(other.m_nodes.get_allocator()))
+{
+	m_swap(other);
+}
+/**
+ * Destructor for a RobinHoodHashMap.
+ *
+ * The keys and values were constructed through the allocator, so they are
+ * destroyed through it too, before the underlying array is freed.
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>::~RobinHoodHashMap() {
+	m_clearNodes();
+}
+
+/**
+ * Copy-assigns the contents of one RobinHoodHashMap to another.
+ *
+ * The copy is made with this map's allocator, so this map keeps its
+ * allocator and the swap is between maps that can free each other's memory.
+ *
+ * @param	other	The map to copy from
+ * @return	The modified version of this, after copying
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>& RobinHoodHashMap<Key, Value, Hash, Allocator>::operator=(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other) {
+	RobinHoodHashMap<Key, Value, Hash, Allocator> tmp(other, get_allocator());
+	m_swap(tmp);
+	return *this;
+}
+/**
+ * Move-assigns the contents of one RobinHoodHashMap to another.
+ *
+ * If the allocator's propagate_on_container_move_assignment is true, this
+ * map frees its own nodes and takes the other map's allocator along with its
+ * table. Otherwise, if the allocators compare unequal, this map can't free
+ * the other map's memory, so the nodes are moved into a new table from this
+ * map's allocator instead of swapping.
+ *
+ * @param	other	The map to swap contents with
+ * @return	The modified version of this, after the content swap
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+RobinHoodHashMap<Key, Value, Hash, Allocator>& RobinHoodHashMap<Key, Value, Hash, Allocator>::operator=(RobinHoodHashMap<Key, Value, Hash, Allocator>&& other) {
+	if (std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value) {
+		RobinHoodHashMap<Key, Value, Hash, Allocator> taken(std::move(other));
+		m_clearNodes();
+		m_nodes = std::vector<Node, NodeAllocator>(taken.m_nodes.get_allocator());
+		m_swap(taken);
+	}
+	else if (m_nodes.get_allocator() == other.m_nodes.get_allocator()) {
+		m_swap(other);
+	}
+	else {
+		RobinHoodHashMap<Key, Value, Hash, Allocator> tmp(other.hashFunction(), other.m_size, get_allocator());
+		for (size_type i = 0; i < other.m_nodes.size(); i++) {
+			if (!other.m_nodes[i].empty()) {
+				tmp.m_moveIn(other.m_nodes[i], other.m_nodes.get_allocator());
+			}
+		}
+		other.m_size = 0;
+		m_swap(tmp);
+	}
+	return *this;
+}
+
+/**
+ * Checks to see if two RobinHoodHashMaps are equal.
+ *
+ * As with HashMap, keys can be in different slots in the two maps even when
+ * they hold the same contents, so every key of this map is looked up in the
+ * other.
+ *
+ * @param	other	The map to compare against
+ * @return	true if all keys of both map to the same values, otherwise false
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::operator==(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other) const {
+	if (m_size != other.m_size) {
+		return false;
+	}
+	
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		const Node& n = m_nodes[i];
+		if (!n.empty()) {
+			const Value* found = other.find(n.key());
+			if (found == nullptr || *found != n.value()) {
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+/**
+ * Checks to see if two RobinHoodHashMaps are unequal.
+ * @param	other	The map to compare against
+ * @return	false if all keys of both map to the same values, otherwise true
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::operator!=(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other) const {
+	return !(*this == other);
+}
+
+/**
+ * Provides a copy of the allocator this map uses for its memory.
+ * @return	The allocator of the map
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::allocator_type RobinHoodHashMap<Key, Value, Hash, Allocator>::get_allocator() const {
+	return allocator_type(m_nodes.get_allocator());
+}
+/**
+ * Reports the number of keys in the map.
+ * @return	The number of valid key-value pairs in the map
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::size() const {
+	return m_size;
+}
+/**
+ * Reports whether or not the map is empty.
+ * @return	Whether there are any keys in the map
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Reports the number of slots in the underlying array.
+ *
+ * This is always a power of two, and the map is rehashed before more than
+ * ROBINHOODHASHMAP_MAX_LOAD_FACTOR of the slots are in use.
+ *
+ * @return	The number of slots in the underlying array
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::capacity() const {
+	return m_nodes.size();
+}
+/**
+ * Makes sure the map can hold a number of keys without rehashing.
+ * @param	size	The number of keys the map should be able to hold
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::reserve(size_type size) {
+	if (size > m_loadThreshold) {
+		m_rehash(size);
+	}
+}
+/**
+ * Shrinks the underlying array to the smallest size that fits the contents.
+ *
+ * There are no tombstones to clear out, so this only ever gives memory back
+ * after keys have been removed.
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::shrink_to_fit() {
+	m_rehash(m_size);
+}
+
+#if FUNDAMENTALS_HASH_STATS
+/**
+ * Reports statistics about how the keys are spread over the underlying array.
+ *
+ * The probe distance of a key is its distance from its home slot, which is
+ * worked out from its stored hash, so this doesn't need to follow any probe
+ * sequences. There are never any tombstones.
+ *
+ * The rehash counts are for this map object, so they aren't carried over to
+ * a copy of it or a map it is moved into.
+ *
+ * @return	The statistics for this map
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+HashStats RobinHoodHashMap<Key, Value, Hash, Allocator>::stats() const {
+	HashStats stats = hashStatsStart(m_size, m_nodes.size(), 0, m_counters);
+	
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		if (!m_nodes[i].empty()) {
+			hashStatsAdd(stats, m_distance(i));
+		}
+	}
+	
+	hashStatsFinish(stats);
+	return stats;
+}
+#endif
+
+/**
+ * Insert a key-value pair into the map.
+ * @throws	DuplicateKeyError	When the key provided is already in the map
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::insert(const Key& key, const Value& value) {
+	if (m_crowded()) {
+		m_rehash();
+	}
+	
+	size_type hashValue = m_hash(key);
+	bool found;
+	size_type index = m_findInsertIndex(key, hashValue, found);
+	
+	if (found) {
+		throw DuplicateKeyError();
+	}
+	
+	m_insertAt(index, key, value, hashValue);
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ * @throws	MissingKeyError	If the requested key is not in the map
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::remove(const Key& key) {
+	size_type index = m_findIndex(key);
+	
+	if (index == m_nodes.size()) {
+		throw MissingKeyError();
+	}
+	
+	m_eraseAt(index);
+}
+/**
+ * Sets the value corresponding to a key in this map.
+ *
+ * This can be used as a permissive version of insert.
+ * If the key was already in the map, it will just overwrite the old value.
+ *
+ * @param	key	The key to insert a value for
+ * @param	value	The value that correspond to the key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::set(const Key& key, const Value& value) {
+	if (m_crowded()) {
+		m_rehash();
+	}
+	
+	size_type hashValue = m_hash(key);
+	bool found;
+	size_type index = m_findInsertIndex(key, hashValue, found);
+	
+	if (found) {
+		m_nodes[index].set(m_nodes.get_allocator(), key, value, hashValue);
+	}
+	else {
+		m_insertAt(index, key, value, hashValue);
+	}
+}
+/**
+ * Removes a key, and its associated value, from the map.
+ *
+ * This is the permissiver version of remove. If the key was not in the map
+ * in the first place, it just won't do anything.
+ *
+ * @param	key	The key to remove
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::unset(const Key& key) {
+	size_type index = m_findIndex(key);
+	
+	if (index != m_nodes.size()) {
+		m_eraseAt(index);
+	}
+}
+
+/**
+ * Checks if a key is currently in the map.
+ * @param	key	The key to check for
+ * @return	A boolean representing whether or not the key exists
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::hasKey(const Key& key) const {
+	return hasKey<Key>(key);
+}
+
+/**
+ * Gets a reference to the value stored at a given key.
+ *
+ * As with HashMap, a key that isn't in the map yet is added with a
+ * default-constructed value.
+ *
+ * @param	key	The key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::operator[](const Key& key) {
+	size_type hashValue = m_hash(key);
+	bool found;
+	size_type index = m_findInsertIndex(key, hashValue, found);
+	
+	if (found) {
+		return m_nodes[index].value();
+	}
+	
+	if (m_crowded()) {
+		m_rehash();
+		index = m_findFreeIndex(hashValue);
+	}
+	
+	return m_insertAt(index, key, Value(), hashValue);
+}
+/**
+ * Gets a constant reference to the value stored at a given key.
+ *
+ * Since this reference can't be assigned to, it's not possible to add the
+ * key when it's missing.
+ *
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+const Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::operator[](const Key& key) const {
+	return getValue<Key>(key);
+}
+/**
+ * Gets a reference to the value stored at a given key.
+ *
+ * Unlike the indexing operator, this won't add keys that are missing.
+ *
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::getValue(const Key& key) {
+	return getValue<Key>(key);
+}
+/**
+ * Gets a constant reference to the value stored at a given key.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	The key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+const Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::getValue(const Key& key) const {
+	return getValue<Key>(key);
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ *
+ * The pointer is only valid until the map is next changed. Keys move between
+ * slots when other keys are added or removed, not only when the map rehashes.
+ *
+ * @param	key	The key to get the mapped value for
+ * @return	A pointer to the value key refers to, or nullptr if it's missing
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+Value* RobinHoodHashMap<Key, Value, Hash, Allocator>::find(const Key& key) {
+	return find<Key>(key);
+}
+/**
+ * Looks up the value stored at a key that might not be in the map.
+ * @param	key	The key to get the mapped value for
+ * @return	A constant pointer to the value key refers to, or nullptr if it's
+ * 	missing
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+const Value* RobinHoodHashMap<Key, Value, Hash, Allocator>::find(const Key& key) const {
+	return find<Key>(key);
+}
+/**
+ * Copies out the value stored at a key, if the key is in the map.
+ * @param	key	The key to get the mapped value for
+ * @param	value	Set to a copy of the mapped value when the key is found,
+ * 	and left alone otherwise
+ * @return	Whether the key was found
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::try_get(const Key& key, Value& value) const {
+	return try_get<Key>(key, value);
+}
+/**
+ * Checks if a key is in the map, by a value of another type.
+ * @param	key	A value equal to the key to check for
+ * @return	Whether or not the key exists
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::hasKey(const K& key) const {
+	return m_findIndex(key) != m_nodes.size();
+}
+/**
+ * Gets a reference to the value stored at a key, by a value of another type.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::getValue(const K& key) {
+	size_type index = m_findIndex(key);
+	
+	if (index == m_nodes.size()) {
+		throw MissingKeyError();
+	}
+	
+	return m_nodes[index].value();
+}
+/**
+ * Gets a constant reference to the value stored at a key, by a value of
+ * another type.
+ * @throws	MissingKeyError	When the requested key is not in the map
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A constant reference to the value key refers to
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+const Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::getValue(const K& key) const {
+	size_type index = m_findIndex(key);
+	
+	if (index == m_nodes.size()) {
+		throw MissingKeyError();
+	}
+	
+	return m_nodes[index].value();
+}
+/**
+ * Looks up the value stored at a key that might be missing, by a value of
+ * another type.
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A pointer to the value key refers to, or nullptr if it's missing
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+Value* RobinHoodHashMap<Key, Value, Hash, Allocator>::find(const K& key) {
+	size_type index = m_findIndex(key);
+	return index == m_nodes.size() ? nullptr : &m_nodes[index].value();
+}
+/**
+ * Looks up the value stored at a key that might be missing, by a value of
+ * another type.
+ * @param	key	A value equal to the key to get the mapped value for
+ * @return	A constant pointer to the value key refers to, or nullptr if it's
+ * 	missing
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+const Value* RobinHoodHashMap<Key, Value, Hash, Allocator>::find(const K& key) const {
+	size_type index = m_findIndex(key);
+	return index == m_nodes.size() ? nullptr : &m_nodes[index].value();
+}
+/**
+ * Copies out the value stored at a key, by a value of another type.
+ * @param	key	A value equal to the key to get the mapped value for
+ * @param	value	Set to a copy of the mapped value when the key is found,
+ * 	and left alone otherwise
+ * @return	Whether the key was found
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::try_get(const K& key, Value& value) const {
+	const Value* found = find<K>(key);
+	if (found == nullptr) {
+		return false;
+	}
+	
+	value = *found;
+	return true;
+}
+/**
+ * Looks up the values stored at a number of keys, any of which might be
+ * missing.
+ *
+ * This works the same way as HashMap::find_many, hashing a batch of keys and
+ * prefetching their home slots before searching any of them.
+ *
+ * @param	keys	The keys to look up, which can be of another type when the
+ * 	hash function is transparent
+ * @param	count	The number of keys
+ * @param	results	Where to write a pointer to each key's value, or nullptr
+ * 	for each missing key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::find_many(const K* keys, size_type count, Value** results) {
+	size_type indices[ROBINHOODHASHMAP_BATCH_SIZE];
+	
+	for (size_type start = 0; start < count; start += ROBINHOODHASHMAP_BATCH_SIZE) {
+		size_type batch = std::min<size_type>(ROBINHOODHASHMAP_BATCH_SIZE, count - start);
+		m_findBatch(keys + start, batch, indices);
+		
+		for (size_type i = 0; i < batch; ++i) {
+			results[start + i] = indices[i] == m_nodes.size() ? nullptr : &m_nodes[indices[i]].value();
+		}
+	}
+}
+/**
+ * Looks up the values stored at a number of keys, any of which might be
+ * missing.
+ * @param	keys	The keys to look up, which can be of another type when the
+ * 	hash function is transparent
+ * @param	count	The number of keys
+ * @param	results	Where to write a constant pointer to each key's value, or
+ * 	nullptr for each missing key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K, typename>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::find_many(const K* keys, size_type count, const Value** results) const {
+	size_type indices[ROBINHOODHASHMAP_BATCH_SIZE];
+	
+	for (size_type start = 0; start < count; start += ROBINHOODHASHMAP_BATCH_SIZE) {
+		size_type batch = std::min<size_type>(ROBINHOODHASHMAP_BATCH_SIZE, count - start);
+		m_findBatch(keys + start, batch, indices);
+		
+		for (size_type i = 0; i < batch; ++i) {
+			results[start + i] = indices[i] == m_nodes.size() ? nullptr : &m_nodes[indices[i]].value();
+		}
+	}
+}
+
+/**
+ * Gets a sequence of all the keys in this map.
+ * @return	A vector containing all keys in this map
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+std::vector<Key> RobinHoodHashMap<Key, Value, Hash, Allocator>::keys() const {
+	std::vector<Key> keys(0);
+	keys.reserve(m_size);
+	
+	for (size_type i = 0; keys.size() < m_size; i++) {
+		if (!m_nodes[i].empty()) {
+			keys.push_back(m_nodes[i].key());
+		}
+	}
+	
+	return keys;
+}
+/**
+ * Gets a sequence of all the values in this map.
+ * @return	A vector containing all values in this map
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+std::vector<Value> RobinHoodHashMap<Key, Value, Hash, Allocator>::values() const {
+	std::vector<Value> values(0);
+	values.reserve(m_size);
+	
+	for (size_type i = 0; values.size() < m_size; ++i) {
+		if (!m_nodes[i].empty()) {
+			values.push_back(m_nodes[i].value());
+		}
+	}
+	
+	return values;
+}
+
+/**
+ * Checks whether adding another key would put the map over its load factor.
+ * @return	Whether the map needs to be rehashed before adding a key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool RobinHoodHashMap<Key, Value, Hash, Allocator>::m_crowded() const {
+	return m_size >= m_loadThreshold;
+}
+/**
+ * Grows the underlying array and moves every key to its new position.
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_rehash() {
+	m_rehash(ROBINHOODHASHMAP_GROWTH_FACTOR * m_size);
+}
+/**
+ * Rehashes into an underlying array that can hold a number of keys.
+ *
+ * As with HashMap, the nodes are moved into a new map and then the contents
+ * are swapped. Each node's stored hash is used rather than hashing the key
+ * again.
+ *
+ * @param	size	The number of keys the new array should be able to hold
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_rehash(size_type size) {
+#if FUNDAMENTALS_HASH_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+	RobinHoodHashMap<Key, Value, Hash, Allocator> other(this->hashFunction(), size, get_allocator());
+	
+	for (size_type i = 0; i < m_nodes.size(); i++) {
+		if (!m_nodes[i].empty()) {
+			other.m_moveIn(m_nodes[i], m_nodes.get_allocator());
+		}
+	}
+	
+	m_swap(other);
+#if FUNDAMENTALS_HASH_STATS
+	++m_counters.rehashCount;
+	m_counters.rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+#endif
+}
+/**
+ * Moves the contents of a node from another table into this map.
+ *
+ * The key on the node must not already be in this map, and this map must
+ * have room for it without needing to be rehashed.
+ *
+ * @param	node	The node to move from, which will be left empty
+ * @param	from	The allocator of the table the node is in
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_moveIn(Node& node, const NodeAllocator& from) {
+	size_type index = m_findFreeIndex(node.hash());
+	
+	m_shiftForward(index);
+	m_nodes[index].take(m_nodes.get_allocator(), node, from);
+	++m_size;
+}
+/**
+ * Destroys the key and value of every full node in the underlying array.
+ *
+ * The size isn't updated, so this is only for when the array is about to be
+ * freed.
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_clearNodes() {
+	for (size_type i = 0; i < m_nodes.size(); ++i) {
+		m_nodes[i].clear(m_nodes.get_allocator());
+	}
+}
+/**
+ * Swaps the contents of this map with that of another.
+ *
+ * The node arrays are swapped with std::vector's swap, which also swaps their
+ * allocators if propagate_on_container_swap says so. Otherwise the
+ * allocators must compare equal.
+ *
+ * @param	other	Another map to swap contents with
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_swap(RobinHoodHashMap<Key, Value, Hash, Allocator>& other) {
+	std::swap(this->hashFunction(), other.hashFunction());
+	m_nodes.swap(other.m_nodes);
+	std::swap(m_size, other.m_size);
+	std::swap(m_loadThreshold, other.m_loadThreshold);
+}
+/**
+ * Adds the contents of another map into this map.
+ * @param	other	The map to add the contents from
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_update(const RobinHoodHashMap<Key, Value, Hash, Allocator>& other) {
+	for (size_type i = 0; i < other.m_nodes.size(); i++) {
+		if (!other.m_nodes[i].empty()) {
+			insert(other.m_nodes[i].key(), other.m_nodes[i].value());
+		}
+	}
+}
+
+/**
+ * Works out the size of the underlying array for holding a number of keys.
+ *
+ * The array is always a power of two, and is big enough that the keys don't
+ * put it over the maximum load factor. The load factor isn't exact in
+ * binary, so the division is rounded up to make sure of that.
+ *
+ * @param	size	The number of keys the array should be able to hold
+ * @return	The number of slots for the array
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_tableSize(size_type size) {
+	size = std::ceil(size / ROBINHOODHASHMAP_MAX_LOAD_FACTOR);
+	
+	if (size < ROBINHOODHASHMAP_DEFAULT_CAPACITY) {
+		return ROBINHOODHASHMAP_DEFAULT_CAPACITY;
+	}
+	return hashTableSize(size);
+}
+/**
+ * Applies this map's hash function to a key.
+ * @param	key	The key to hash
+ * @return	The result of the hash function for key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_hash(const K& key) const {
+	return hashKey(this->hashFunction(), key);
+}
+/**
+ * Works out how far the key in a slot is from its home slot.
+ *
+ * The home slot is the low bits of the key's hash, and probing only ever
+ * moves forward one slot at a time (wrapping around at the end), so the
+ * distance is the difference of the two, wrapped the same way.
+ *
+ * @param	index	The index of a full slot
+ * @return	The number of slots past its home slot the key is
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_distance(size_type index) const {
+	return (index - m_nodes[index].hash()) & (m_nodes.size() - 1);
+}
+
+/**
+ * Finds the index in the underlying array that holds a key.
+ * @param	key	The key to find the slot for
+ * @return	The index of the key's slot, or the capacity if it's missing
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_findIndex(const K& key) const {
+	return m_findIndex(key, m_hash(key));
+}
+/**
+ * Finds the index in the underlying array that holds a key.
+ *
+ * We start at the key's home slot and step forward one slot at a time. The
+ * search ends when it finds the key, reaches an empty slot, or reaches a key
+ * that is closer to its home than the key we want would be here. In the last
+ * case, inserting the key we want would have taken that slot, so it can't be
+ * further along.
+ *
+ * @param	key	The key to find the slot for
+ * @param	hashValue	The result of the hash function for key
+ * @return	The index of the key's slot, or the capacity if it's missing
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_findIndex(const K& key, size_type hashValue) const {
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type index = hashValue & mask;
+	size_type distance = 0;
+	
+	while (!m_nodes[index].empty() && m_distance(index) >= distance) {
+		if (m_nodes[index].keyEqual(key, hashValue)) {
+			return index;
+		}
+		index = (index + 1) & mask;
+		++distance;
+	}
+	
+	return m_nodes.size();
+}
+/**
+ * Finds the indices in the underlying array that a batch of keys are in.
+ * @param	keys	The keys to find the slots for
+ * @param	count	The number of keys, at most ROBINHOODHASHMAP_BATCH_SIZE
+ * @param	indices	Where to write the index for each key, or the capacity
+ * 	for each missing key
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+template <typename K>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_findBatch(const K* keys, size_type count, size_type* indices) const {
+	size_type hashes[ROBINHOODHASHMAP_BATCH_SIZE];
+	
+	for (size_type i = 0; i < count; ++i) {
+		hashes[i] = m_hash(keys[i]);
+		hashPrefetch(m_nodes.data() + (hashes[i] & (m_nodes.size() - 1)));
+	}
+	
+	for (size_type i = 0; i < count; ++i) {
+		indices[i] = m_findIndex(keys[i], hashes[i]);
+	}
+}
+/**
+ * Finds the slot that holds a key, or the slot it belongs in if it's missing.
+ *
+ * This walks the same slots as m_findIndex. When the key is missing, the slot
+ * where the search ended is where it belongs: either an empty slot, or the
+ * slot of the first key closer to its home, which would have to move along
+ * to make room.
+ *
+ * @param	key	The key to find the slot for
+ * @param	hashValue	The result of the hash function for key
+ * @param	found	Set to whether the key is in the map
+ * @return	The index of the key's slot, or of the slot it belongs in
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_findInsertIndex(const Key& key, size_type hashValue, bool& found) const {
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type index = hashValue & mask;
+	size_type distance = 0;
+	
+	while (!m_nodes[index].empty() && m_distance(index) >= distance) {
+		if (m_nodes[index].keyEqual(key, hashValue)) {
+			found = true;
+			return index;
+		}
+		index = (index + 1) & mask;
+		++distance;
+	}
+	
+	found = false;
+	return index;
+}
+/**
+ * Finds the slot a key belongs in, for a key known not to be in the map.
+ *
+ * This is the same as m_findInsertIndex, without comparing any keys.
+ *
+ * @param	hashValue	The result of the hash function for the key
+ * @return	The index of the slot the key belongs in
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+typename RobinHoodHashMap<Key, Value, Hash, Allocator>::size_type RobinHoodHashMap<Key, Value, Hash, Allocator>::m_findFreeIndex(size_type hashValue) const {
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type index = hashValue & mask;
+	size_type distance = 0;
+	
+	while (!m_nodes[index].empty() && m_distance(index) >= distance) {
+		index = (index + 1) & mask;
+		++distance;
+	}
+	
+	return index;
+}
+
+/**
+ * Frees a slot by moving every key from it up to the next empty slot along
+ * by one.
+ *
+ * Each of those keys ends up one slot further from its home, but they stay
+ * in the same order, so every run of full slots is still in the order of
+ * its keys' home slots. The keys are moved starting from the far end, so
+ * there is always an empty slot to move into.
+ *
+ * @param	index	The slot to free, which is left empty
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_shiftForward(size_type index) {
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type free = index;
+	while (!m_nodes[free].empty()) {
+		free = (free + 1) & mask;
+	}
+	
+	while (free != index) {
+		size_type previous = (free - 1) & mask;
+		m_nodes[free].take(m_nodes.get_allocator(), m_nodes[previous], m_nodes.get_allocator());
+		free = previous;
+	}
+}
+/**
+ * Fills an empty slot by moving the keys after it back by one.
+ *
+ * This stops at the first slot that is empty or holds a key already in its
+ * home slot, since moving that key back would put it before its home. Every
+ * key moved ends up one slot closer to its home.
+ *
+ * @param	index	The empty slot to fill
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_shiftBackward(size_type index) {
+	const size_type mask = m_nodes.size() - 1;
+	
+	size_type next = (index + 1) & mask;
+	while (!m_nodes[next].empty() && m_distance(next) != 0) {
+		m_nodes[index].take(m_nodes.get_allocator(), m_nodes[next], m_nodes.get_allocator());
+		index = next;
+		next = (next + 1) & mask;
+	}
+}
+/**
+ * Puts a new key in its slot, moving the keys there along to make room.
+ *
+ * If constructing the key or value throws, the keys that were moved are put
+ * back, so the map is left as it was.
+ *
+ * @param	index	The slot m_findInsertIndex or m_findFreeIndex gave for the key
+ * @param	key	The key to add
+ * @param	value	The value for the key
+ * @param	hashValue	The result of the hash function for key
+ * @return	A reference to the new value
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+Value& RobinHoodHashMap<Key, Value, Hash, Allocator>::m_insertAt(size_type index, const Key& key, const Value& value, size_type hashValue) {
+	m_shiftForward(index);
+	
+	try {
+		m_nodes[index].set(m_nodes.get_allocator(), key, value, hashValue);
+	}
+	catch (...) {
+		m_shiftBackward(index);
+		throw;
+	}
+	
+	++m_size;
+	return m_nodes[index].value();
+}
+/**
+ * Removes the key in a slot, then shifts the keys after it back.
+ * @param	index	The index of a full slot
+ */
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void RobinHoodHashMap<Key, Value, Hash, Allocator>::m_eraseAt(size_type index) {
+	m_nodes[index].clear(m_nodes.get_allocator());
+	m_shiftBackward(index);
+	--m_size;
+}
+
+// ------------------------------ //
+// RobinHoodHashMap_Node Methods //
+// ------------------------------ //
+/**
+ * Constructor for a node, which starts out empty.
+ */
+template <typename Key, typename Value>
+RobinHoodHashMap_Node<Key, Value>::RobinHoodHashMap_Node()
+	: m_full(false)
+{}
+/**
+ * Sets the key and value of a node.
+ *
+ * If the node is empty, the key and value are constructed in place in the
+ * node's storage. Otherwise the existing key and value are assigned to.
+ *
+ * @param	allocator	The allocator to construct the key and value with
+ * @param	k	The key that will be assigned to this node
+ * @param	v	The value that will be assigned to this node
+ * @param	hash	The result of the map's hash function for k
+ */
+template <typename Key, typename Value>
+template <typename Allocator>
+void RobinHoodHashMap_Node<Key, Value>::set(Allocator allocator, const Key& k, const Value& v, size_t hash) {
+	if (!m_full) {
+		std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Key*>(m_keyStorage), k);
+		try {
+			std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Value*>(m_valueStorage), v);
+		}
+		catch (...) {
+			std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Key*>(m_keyStorage));
+			throw;
+		}
+		m_full = true;
+	}
+	else {
+		*reinterpret_cast<Key*>(m_keyStorage) = k;
+		*reinterpret_cast<Value*>(m_valueStorage) = v;
+	}
+	
+	m_hashValue = hash;
+}
+/**
+ * Moves the key, value and hash of another node into this node.
+ *
+ * This node must be empty beforehand, and the other node is left empty.
+ *
+ * @param	allocator	The allocator to construct the key and value with
+ * @param	other	The full node to take the contents of
+ * @param	otherAllocator	The allocator to destroy the other node's key
+ * 	and value with
+ */
+template <typename Key, typename Value>
+template <typename Allocator>
+void RobinHoodHashMap_Node<Key, Value>::take(Allocator allocator, RobinHoodHashMap_Node& other, Allocator otherAllocator) {
+	Key& otherKey = *reinterpret_cast<Key*>(other.m_keyStorage);
+	Value& otherValue = *reinterpret_cast<Value*>(other.m_valueStorage);
+	
+	std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Key*>(m_keyStorage), std::move(otherKey));
+	try {
+		std::allocator_traits<Allocator>::construct(allocator, reinterpret_cast<Value*>(m_valueStorage), std::move(otherValue));
+	}
+	catch (...) {
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Key*>(m_keyStorage));
+		throw;
+	}
+	m_hashValue = other.m_hashValue;
+	m_full = true;
+	
+	other.clear(otherAllocator);
+}
+/**
+ * Removes the key and value of this node, leaving it empty.
+ * @param	allocator	The allocator to destroy the key and value with
+ */
+template <typename Key, typename Value>
+template <typename Allocator>
+void RobinHoodHashMap_Node<Key, Value>::clear(Allocator allocator) {
+	if (m_full) {
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Key*>(m_keyStorage));
+		std::allocator_traits<Allocator>::destroy(allocator, reinterpret_cast<Value*>(m_valueStorage));
+		m_full = false;
+	}
+}
+/**
+ * Reports on whether or not this node is empty.
+ * @return	Whether or not this node currently has a key (and value) set
+ */
+template <typename Key, typename Value>
+bool RobinHoodHashMap_Node<Key, Value>::empty() const {
+	return !m_full;
+}
+/**
+ * Checks if the provided key is equal to this node's key (if any).
+ *
+ * As with HashMap_Node, the stored hash is compared first, so most keys that
+ * differ are rejected without comparing them.
+ *
+ * @param	k	The key to check against
+ * @param	hash	The result of the map's hash function for k
+ * @return	Whether or not this node refers to that key
+ */
+template <typename Key, typename Value>
+template <typename K>
+bool RobinHoodHashMap_Node<Key, Value>::keyEqual(const K& k, size_t hash) const {
+	if (!m_full || m_hashValue != hash) {
+		return false;
+	}
+	
+	return k == key();
+}
+/**
+ * Provides a constant reference to the key on this node.
+ *
+ * It's unsafe to use this method if this node is empty.
+ *
+ * @return	The key for this node
+ */
+template <typename Key, typename Value>
+const Key& RobinHoodHashMap_Node<Key, Value>::key() const {
+	return *reinterpret_cast<const Key*>(m_keyStorage);
+}
+/**
+ * Provides a constant reference to the value on this node.
+ *
+ * It's unsafe to use this method if this node is empty.
+ *
+ * @return	The value for this node
+ */
+template <typename Key, typename Value>
+const Value& RobinHoodHashMap_Node<Key, Value>::value() const {
+	return *reinterpret_cast<const Value*>(m_valueStorage);
+}
+/**
+ * Provides a reference to the value on this node.
+ *
+ * It's unsafe to use this method if this node is empty.
+ *
+ * @return	The value for this node
+ */
+template <typename Key, typename Value>
+Value& RobinHoodHashMap_Node<Key, Value>::value() {
+	return *reinterpret_cast<Value*>(m_valueStorage);
+}
+/**
+ * Provides the stored hash of the key on this node.
+ * @return	The result of the hash function for this node's key
+ */
+template <typename Key, typename Value>
+size_t RobinHoodHashMap_Node<Key, Value>::hash() const {
+	return m_hashValue;
+}
+
+#endif // Fundamentals_RobinHoodHashMap_hpp_
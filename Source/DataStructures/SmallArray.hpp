@@ -0,0 +1,862 @@
+/**
+ * Fundamentals :: Data Structures :: Small Array
+ * Author: Quinn Mortimer
+ *
+ * This is an implementation of a small-buffer-optimized dynamic array.
+ * It is intended as a reference for those looking to brush up on important
+ * data structures.
+ */
+/**
+ * A SmallArray works like a DynamicArray, except that it has room for its
+ * first N elements inside the object itself. An array that never holds more
+ * than N elements never touches the heap at all, which matters when lots of
+ * short arrays are made and thrown away.
+ *
+ * Once the array needs more than N elements, it moves them all into heap
+ * memory and carries on as a DynamicArray would. It doesn't move back into
+ * the inline space if it shrinks again.
+ *
+ * The catch is that moving a SmallArray can't always just hand over a
+ * pointer: if the elements are inline, they have to be moved one at a time.
+ *
+ * We will be using std::move, std::forward and the uninitialized memory
+ * algorithms from the standard library.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Checks.hpp"
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_SmallArray_hpp_
+#define Fundamentals_SmallArray_hpp_
+
+#define SMALLARRAY_GROWTH_FACTOR 2
+
+/**
+ * A dynamically-sized array with room for N elements before it allocates.
+ */
+template <typename T, size_t N>
+class SmallArray {
+	static_assert(N > 0, "A SmallArray needs room for at least one inline element");
+	
+	public:
+		typedef size_t size_type;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+		
+		// Constructors and Destructor
+		SmallArray();
+		SmallArray(size_type a_size);
+		SmallArray(size_type a_size, const T& a_value);
+		SmallArray(const SmallArray<T, N>& other);
+		SmallArray(SmallArray<T, N>&& other);
+		~SmallArray();
+		
+		// Access to current size and capacity
+		size_type size() const;
+		size_type capacity() const;
+		bool empty() const;
+		
+		// Whether the elements are still in the inline space
+		bool isInline() const;
+		
+		// Bulk-memory affecting methods
+		void resize(size_type size);
+		void reserve(size_type size);
+		
+		// Element insertion and deletion
+		// - Back
+		void push_back(const T& value);
+		void push_back(T&& value);
+		template <typename... Args>
+		T& emplace_back(Args&&... args);
+		void pop_back();
+		// - Front
+		void push_front(const T& value);
+		void pop_front();
+		// - Arbitrary
+		void insert(const_iterator position, const T& value);
+		void insert(const_iterator position, T&& value);
+		void remove(const_iterator position);
+		
+		// Iterators
+		iterator begin();
+		const_iterator begin() const;
+		iterator end();
+		const_iterator end() const;
+		
+		// Data Access at notable indices
+		T& front();
+		const T& front() const;
+		T& back();
+		const T& back() const;
+		
+		// Operators
+		// - Assignment
+		SmallArray<T, N>& operator=(const SmallArray<T, N>& other);
+		SmallArray<T, N>& operator=(SmallArray<T, N>&& other);
+		// - Indexing
+		T& operator[](size_type index);
+		const T& operator[](size_type index) const;
+		// - Equality testing
+		bool operator==(const SmallArray<T, N>& other) const;
+		bool operator!=(const SmallArray<T, N>& other) const;
+		
+	private:
+		T* m_data;
+		size_type m_capacity;
+		size_type m_size;
+		// Space for the first N elements, used until the array outgrows it.
+		alignas(T) unsigned char m_inline[N * sizeof(T)];
+		
+		// The inline space, as elements.
+		T* m_inlineData();
+		const T* m_inlineData() const;
+		// Takes the elements of another array, leaving it empty.
+		void m_takeFrom(SmallArray<T, N>& other);
+		// Frees m_data if it is on the heap, and goes back to the inline space.
+		void m_free();
+		
+		// The capacity to grow to when the array is full.
+		size_type m_nextCapacity() const;
+		// Adds an element at the back when there is no room left for it.
+		template <typename... Args>
+		T& m_emplaceBackGrow(Args&&... args);
+		// Adds an element at an index, shifting the later elements back.
+		void m_insertAt(size_type index, T&& value);
+		
+		// Raw heap memory for elements, which are constructed separately.
+		static T* m_allocate(size_type capacity);
+		static void m_deallocate(T* data, size_type capacity);
+		// Moves elements into raw memory, leaving the originals destroyed.
+		static void m_relocate(T* from, size_type count, T* to);
+		static void m_relocate(T* from, size_type count, T* to, std::true_type);
+		static void m_relocate(T* from, size_type count, T* to, std::false_type);
+};
+
+/**
+ * Constructs an empty array.
+ *
+ * Unlike DynamicArray this doesn't allocate anything, since there is already
+ * room for N elements inside the array.
+ */
+template <typename T, size_t N>
+SmallArray<T, N>::SmallArray() {
+	m_data = m_inlineData();
+	m_capacity = N;
+	m_size = 0;
+}
+/**
+ * Constructs an array with a specified starting size.
+ *
+ * Initial elements are made with the default constructor.
+ *
+ * @param	a_size	The initial size of the array
+ */
+template <typename T, size_t N>
+SmallArray<T, N>::SmallArray(size_type size) {
+	m_data = size > N ? m_allocate(size) : m_inlineData();
+	m_capacity = size > N ? size : N;
+	
+	try {
+		std::uninitialized_value_construct_n(m_data, size);
+	}
+	catch (...) {
+		m_free();
+		throw;
+	}
+	
+	m_size = size;
+}
+/**
+ * Constructs an array filled with the specified value.
+ * @param	a_size	The initial size of the array
+ * @param	a_value	The value used to fill the elements
+ */
+template <typename T, size_t N>
+SmallArray<T, N>::SmallArray(size_type size, const T& value) {
+	m_data = size > N ? m_allocate(size) : m_inlineData();
+	m_capacity = size > N ? size : N;
+	
+	try {
+		std::uninitialized_fill_n(m_data, size, value);
+	}
+	catch (...) {
+		m_free();
+		throw;
+	}
+	
+	m_size = size;
+}
+/**
+ * Constructs an array by copying from a constant reference to another array.
+ *
+ * The copy only allocates what the elements need, so a copy of a spilled
+ * array that has since shrunk back down to N elements will be inline again.
+ *
+ * @param	other	The SmallArray to copy data from
+ */
+template <typename T, size_t N>
+SmallArray<T, N>::SmallArray(const SmallArray<T, N>& other) {
+	this->m_capacity = other.m_size > N ? other.m_size : N;
+	this->m_data = other.m_size > N ? m_allocate(this->m_capacity) : m_inlineData();
+	
+	try {
+		std::uninitialized_copy_n(other.m_data, other.m_size, this->m_data);
+	}
+	catch (...) {
+		m_free();
+		throw;
+	}
+	
+	this->m_size = other.m_size;
+}
+/**
+ * Constructs an array by moving the contents of another array.
+ *
+ * Heap memory is just handed over, but inline elements are moved across
+ * one at a time. The other array is left empty and inline either way.
+ *
+ * @param	other	The SmallArray to move contents from
+ */
+template <typename T, size_t N>
+SmallArray<T, N>::SmallArray(SmallArray<T, N>&& other)
+	: m_data(m_inlineData()), m_capacity(N), m_size(0)
+{
+	m_takeFrom(other);
+}
+/**
+ * Destructor for a SmallArray, destroys the elements and frees the
+ * underlying array from the heap if it had spilled there.
+ */
+template <typename T, size_t N>
+SmallArray<T, N>::~SmallArray() {
+	std::destroy_n(m_data, m_size);
+	m_free();
+}
+
+/**
+ * Gets the size of the array for the user.
+ * @return	The number of elements in the array
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::size_type SmallArray<T, N>::size() const {
+	return m_size;
+}
+/**
+ * Gets the capacity of the array for the user.
+ * @return	The number of elements (used and unused) allocated in the array
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::size_type SmallArray<T, N>::capacity() const {
+	return m_capacity;
+}
+/**
+ * Reports on whether or not this SmallArray is empty.
+ * @return	Whether or not this array has any in-use elements
+ */
+template <typename T, size_t N>
+bool SmallArray<T, N>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Reports on whether the elements are still in the inline space.
+ * @return	Whether this array has avoided allocating so far
+ */
+template <typename T, size_t N>
+bool SmallArray<T, N>::isInline() const {
+	return m_data == m_inlineData();
+}
+
+/**
+ * Set the size of the SmallArray to the specified value.
+ *
+ * If elements need to be added, uses the default constructor for T.
+ * If elements need to be removed, they are destroyed.
+ *
+ * @param	size	The desired size for the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::resize(size_type size) {
+	if (m_capacity < size) {
+		reserve(size);
+	}
+	
+	if (m_size < size) {
+		std::uninitialized_value_construct(m_data + m_size, m_data + size);
+	}
+	else {
+		std::destroy(m_data + size, m_data + m_size);
+	}
+	
+	m_size = size;
+}
+
+/**
+ * Reserves a specific amount of memory for use.
+ *
+ * This will only ensure that enough memory has been allocated.
+ * This method will not shrink the capacity of the array.
+ *
+ * The elements are moved into the new memory if that can't throw, and
+ * copied otherwise, so that the array is unchanged if a copy does throw.
+ *
+ * @param	capacity	Desired capacity for this array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::reserve(size_type capacity) {
+	if (m_capacity < capacity) {
+		T* next_data = m_allocate(capacity);
+		
+		try {
+			m_relocate(m_data, m_size, next_data);
+		}
+		catch (...) {
+			m_deallocate(next_data, capacity);
+			throw;
+		}
+		
+		m_free();
+		m_data = next_data;
+		m_capacity = capacity;
+	}
+}
+
+/**
+ * Adds the provided element to the back of the array.
+ * @param	value	The value to place at the back of the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::push_back(const T& value) {
+	emplace_back(value);
+}
+/**
+ * Moves the provided element onto the back of the array.
+ * @param	value	The value to place at the back of the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::push_back(T&& value) {
+	emplace_back(std::move(value));
+}
+/**
+ * Constructs a new element in place at the back of the array.
+ *
+ * The arguments are passed straight on to a constructor of T, so the element
+ * is built where it will live, without a temporary to copy or move from.
+ *
+ * @param	args	The arguments for the constructor of T
+ * @return	A reference to the new element
+ */
+template <typename T, size_t N>
+template <typename... Args>
+T& SmallArray<T, N>::emplace_back(Args&&... args) {
+	if (m_size == m_capacity) {
+		return m_emplaceBackGrow(std::forward<Args>(args)...);
+	}
+	
+	new (m_data + m_size) T(std::forward<Args>(args)...);
+	++m_size;
+	
+	return m_data[m_size - 1];
+}
+/**
+ * Removes one element from the back of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::pop_back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	--m_size;
+	m_data[m_size].~T();
+}
+/**
+ * Adds the provided element to the front of the array.
+ *
+ * This method needs to shift every element of the array one index forward
+ * in order to work.
+ *
+ * @param	value	The value to place at the front of the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::push_front(const T& value) {
+	m_insertAt(0, T(value));
+}
+/**
+ * Removes an element from the front of the array.
+ *
+ * This method needs to shift every element of the array one index backward
+ * in order to work.
+ *
+ * @throws	OutOfBoundsError	when the array is empty
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::pop_front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	std::move(m_data + 1, m_data + m_size, m_data);
+	
+	m_size--;
+	m_data[m_size].~T();
+}
+/**
+ * Inserts an element before an arbitrary iterator in the array.
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	The location to insert the element before
+ * @param	value	The value to insert into the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::insert(const_iterator position, const T& value) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= m_data && position <= m_data + m_size);
+	
+	m_insertAt(position - m_data, T(value));
+}
+/**
+ * Moves an element into the array before an arbitrary iterator.
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	The location to insert the element before
+ * @param	value	The value to move into the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::insert(const_iterator position, T&& value) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= m_data && position <= m_data + m_size);
+	
+	m_insertAt(position - m_data, std::move(value));
+}
+/**
+ * Removes an element from an arbitrary point in the array.
+ * @throws	OutOfBoundsError	when the given iterator is beyond the array's end
+ * @param	position	An iterator pointing to the element to remove
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::remove(const_iterator position) {
+	FUNDAMENTALS_CHECK_BOUNDS(position >= m_data && position < m_data + m_size);
+	
+	T* removed = m_data + (position - m_data);
+	std::move(removed + 1, m_data + m_size, removed);
+	
+	--m_size;
+	m_data[m_size].~T();
+}
+
+/**
+ * Provides a reference to the first element in the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A reference to the first element of the array
+ */
+template <typename T, size_t N>
+T& SmallArray<T, N>::front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return m_data[0];
+}
+/**
+ * Provides a constant reference to the first element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A constant reference to the first element of the array
+ */
+template <typename T, size_t N>
+const T& SmallArray<T, N>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return m_data[0];
+}
+/**
+ * Provides a reference to the last element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A reference to the last element of the array
+ */
+template <typename T, size_t N>
+T& SmallArray<T, N>::back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return m_data[m_size - 1];
+}
+/**
+ * Provides a constant reference to the last element of the array.
+ * @throws	OutOfBoundsError	when the array is empty
+ * @return	A constant reference to the last element of the array
+ */
+template <typename T, size_t N>
+const T& SmallArray<T, N>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_size > 0);
+	
+	return m_data[m_size - 1];
+}
+
+/**
+ * Provides an iterator pointing to the start of the underlying array.
+ *
+ * For a SmallArray, this is a simple pointer (T*) to the start of m_data.
+ *
+ * @return	An iterator at the start of this SmallArray
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::iterator SmallArray<T, N>::begin() {
+	return m_data;
+}
+/**
+ * Provides a const_iterator to the start of the underlying array.
+ *
+ * For a SmallArray, this is a simple const pointer (const T*)
+ * to the start of m_data.
+ *
+ * @return	A const_iterator to the start of this SmallArray
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::const_iterator SmallArray<T, N>::begin() const {
+	return m_data;
+}
+/**
+ * Provides an iterator pointing to the end of the underlying array.
+ *
+ * For a SmallArray, this is a simple pointer (T*) to just past the end
+ * of m_data.
+ *
+ * @return	An iterator at the start of this SmallArray
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::iterator SmallArray<T, N>::end() {
+	return m_data + m_size;
+}
+/**
+ * Provides a const_iterator to the end of the underlying array.
+ *
+ * For a SmallArray, this is a simple const pointer (const T*)
+ * to just past the end of m_data.
+ *
+ * @return	A const_iterator to the end of this SmallArray
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::const_iterator SmallArray<T, N>::end() const {
+	return m_data + m_size;
+}
+
+/**
+ * Copy-assigns the contents of another array to this array.
+ *
+ * The other array is copied first and then moved in, so this array is left
+ * unchanged if one of the copies throws.
+ *
+ * @param	other	The array to copy data from
+ * @return	A reference to this after copying
+ */
+template <typename T, size_t N>
+SmallArray<T, N>& SmallArray<T, N>::operator=(const SmallArray<T, N>& other) {
+	SmallArray<T, N> tmp(other);
+	*this = std::move(tmp);
+	return *this;
+}
+/**
+ * Move-assigns the contents of another array to this array.
+ *
+ * The current elements are destroyed, then the other array's are taken in
+ * the same way as the move constructor.
+ *
+ * @param	other	The array to move data from
+ * @return	A reference to this after the move has happened
+ */
+template <typename T, size_t N>
+SmallArray<T, N>& SmallArray<T, N>::operator=(SmallArray<T, N>&& other) {
+	if (this != &other) {
+		std::destroy_n(m_data, m_size);
+		m_size = 0;
+		m_free();
+		m_takeFrom(other);
+	}
+	return *this;
+}
+/**
+ * Provides a reference to an element at any index of the array.
+ * @throws	OutOfBoundsError	when the requested index is < 0 or > m_size
+ * @param	index	The index in the array to retrieve data from
+ * @return A reference to the data at the requested index
+ */
+template <typename T, size_t N>
+T& SmallArray<T, N>::operator[](size_type index) {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
+	
+	return m_data[index];
+}
+/**
+ * Provides a consant reference to an element at any index of the array.
+ * @throws	OutOfBoundsError	when the requested index is < 0 or > m_size
+ * @param	index	The index in the array to retrieve data from
+ * @return A constant reference to the data at the requested index
+ */
+template <typename T, size_t N>
+const T& SmallArray<T, N>::operator[](size_type index) const {
+	FUNDAMENTALS_CHECK_BOUNDS(index < m_size);
+	
+	return m_data[index];
+}
+/**
+ * Check if two arrays are equal.
+ *
+ * In this context, that will mean they are the same size and the contents
+ * compare equal index-by-index.
+ *
+ * @param	other	The array to compare this against
+ * @return	Boolean representing whether these arrays are equal
+ */
+template <typename T, size_t N>
+bool SmallArray<T, N>::operator==(const SmallArray<T, N>& other) const {
+	if (this->m_size != other.m_size) {
+		return false;
+	}
+	
+	for (size_type i = 0; i < m_size; ++i) {
+		if (this->m_data[i] != other.m_data[i]) {
+			return false;
+		}
+	}
+	
+	return true;
+}
+/**
+ * Check if two arrays are not equal.
+ *
+ * In this context, that will mean either they are different sizes or they have
+ * at least one index at which the elements do not compare equal.
+ *
+ * @param	other	The array to compare this against
+ * @return	Boolean representing whether these arrays are not equal
+ */
+template <typename T, size_t N>
+bool SmallArray<T, N>::operator!=(const SmallArray<T, N>& other) const {
+	return (!(*this == other));
+}
+
+/**
+ * Provides the inline space of this array, as elements.
+ * @return	A pointer to the first inline element
+ */
+template <typename T, size_t N>
+T* SmallArray<T, N>::m_inlineData() {
+	return reinterpret_cast<T*>(m_inline);
+}
+/**
+ * Provides the inline space of this array, as constant elements.
+ * @return	A pointer to the first inline element
+ */
+template <typename T, size_t N>
+const T* SmallArray<T, N>::m_inlineData() const {
+	return reinterpret_cast<const T*>(m_inline);
+}
+/**
+ * Takes the elements of another array, which is left empty and inline.
+ *
+ * This array must be empty and inline when this is called. Heap memory is
+ * handed over as it is. Inline elements have to be moved one at a time, and
+ * are copied instead if moving them could throw.
+ *
+ * @param	other	The array to take elements from
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_takeFrom(SmallArray<T, N>& other) {
+	if (other.isInline()) {
+		m_relocate(other.m_data, other.m_size, m_data);
+	}
+	else {
+		m_data = other.m_data;
+		m_capacity = other.m_capacity;
+		other.m_data = other.m_inlineData();
+		other.m_capacity = N;
+	}
+	
+	m_size = other.m_size;
+	other.m_size = 0;
+}
+/**
+ * Frees the memory for the elements if it is on the heap, and points the
+ * array back at its inline space. Any elements must be destroyed first.
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_free() {
+	if (!isInline()) {
+		m_deallocate(m_data, m_capacity);
+		m_data = m_inlineData();
+		m_capacity = N;
+	}
+}
+
+/**
+ * Works out the capacity to grow to when the array is full.
+ * @return	The current capacity times the growth factor, and at least 1
+ */
+template <typename T, size_t N>
+typename SmallArray<T, N>::size_type SmallArray<T, N>::m_nextCapacity() const {
+	size_type next_capacity = m_capacity * SMALLARRAY_GROWTH_FACTOR;
+	if (next_capacity == 0) {
+		next_capacity = 1;
+	}
+	return next_capacity;
+}
+/**
+ * Adds an element to the back of a full array, growing it first.
+ *
+ * The arguments might refer to an element of this array (for example
+ * `array.push_back(array[0])`), so the new element is constructed in the new
+ * memory before the old elements are moved out from under it.
+ *
+ * @param	args	The arguments for the constructor of T
+ * @return	A reference to the new element
+ */
+template <typename T, size_t N>
+template <typename... Args>
+T& SmallArray<T, N>::m_emplaceBackGrow(Args&&... args) {
+	size_type next_capacity = m_nextCapacity();
+	T* next_data = m_allocate(next_capacity);
+	
+	try {
+		new (next_data + m_size) T(std::forward<Args>(args)...);
+	}
+	catch (...) {
+		m_deallocate(next_data, next_capacity);
+		throw;
+	}
+	
+	try {
+		m_relocate(m_data, m_size, next_data);
+	}
+	catch (...) {
+		next_data[m_size].~T();
+		m_deallocate(next_data, next_capacity);
+		throw;
+	}
+	
+	m_free();
+	m_data = next_data;
+	m_capacity = next_capacity;
+	++m_size;
+	
+	return m_data[m_size - 1];
+}
+/**
+ * Adds an element at an index, shifting every later element back by one.
+ *
+ * The value is taken by the caller before this is called, so it's safe for it
+ * to have come from an element of this array.
+ *
+ * @param	index	Where the new element should end up, at most m_size
+ * @param	value	The value to move into the array
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_insertAt(size_type index, T&& value) {
+	if (index == m_size) {
+		emplace_back(std::move(value));
+		return;
+	}
+	
+	// The last element moves into the unconstructed slot past the end, and
+	// everything else between index and there shifts back by assignment
+	emplace_back(std::move(m_data[m_size - 1]));
+	std::move_backward(m_data + index, m_data + m_size - 2, m_data + m_size - 1);
+	m_data[index] = std::move(value);
+}
+
+/**
+ * Allocates memory for elements, without constructing any.
+ *
+ * Types that need more alignment than operator new gives by default are
+ * allocated with the aligned form of operator new.
+ *
+ * @param	capacity	The number of elements the memory should fit
+ * @return	A pointer to the memory, or nullptr if capacity is 0
+ */
+template <typename T, size_t N>
+T* SmallArray<T, N>::m_allocate(size_type capacity) {
+	if (capacity == 0) {
+		return nullptr;
+	}
+	
+	if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+		return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+	}
+	return static_cast<T*>(::operator new(capacity * sizeof(T)));
+}
+/**
+ * Frees memory from m_allocate. Any elements in it must be destroyed first.
+ * @param	data	The memory to free
+ * @param	capacity	The capacity the memory was allocated with
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_deallocate(T* data, size_type capacity) {
+	if (data == nullptr) {
+		return;
+	}
+	
+	if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+		::operator delete(data, capacity * sizeof(T), std::align_val_t(alignof(T)));
+	}
+	else {
+		::operator delete(data, capacity * sizeof(T));
+	}
+}
+/**
+ * Moves elements into raw memory, destroying the originals.
+ *
+ * Trivially copyable types are moved all at once with memcpy, and other
+ * types are moved (or copied) one at a time.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_relocate(T* from, size_type count, T* to) {
+	m_relocate(from, count, to, std::is_trivially_copyable<T>());
+}
+/**
+ * Moves trivially copyable elements into raw memory with memcpy.
+ *
+ * For these types copying the bytes is exactly what the copy constructor
+ * does, and there is nothing for a destructor to do afterwards.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_relocate(T* from, size_type count, T* to, std::true_type) {
+	if (count > 0) {
+		std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+	}
+}
+/**
+ * Moves elements into raw memory one at a time.
+ *
+ * If T's move constructor might throw, the elements are copied instead. Then
+ * if one of the copies throws, the originals are all still intact, and the
+ * copies made so far are destroyed before the exception is passed on.
+ *
+ * @param	from	The first element to move
+ * @param	count	The number of elements to move
+ * @param	to	Raw memory with room for count elements
+ */
+template <typename T, size_t N>
+void SmallArray<T, N>::m_relocate(T* from, size_type count, T* to, std::false_type) {
+	size_type moved = 0;
+	
+	try {
+		for (; moved < count; ++moved) {
+			new (to + moved) T(std::move_if_noexcept(from[moved]));
+		}
+	}
+	catch (...) {
+		std::destroy_n(to, moved);
+		throw;
+	}
+	
+	std::destroy_n(from, count);
+}
+
+#endif // Fundamentals_SmallArray_hpp_
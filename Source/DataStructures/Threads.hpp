@@ -0,0 +1,62 @@
+/**
+ * Fundamentals :: Data Structures :: Threads
+ * Author: Quinn Mortimer
+ *
+ * This file contains a small utility for splitting a piece of work over
+ * several threads. It is shared by the data structures that build themselves
+ * on several threads (see HashBuild.hpp) and by the C++ algorithms that run
+ * on several threads.
+ */
+
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef Fundamentals_Threads_hpp_
+#define Fundamentals_Threads_hpp_
+
+/**
+ * Runs a piece of work on several threads, and waits for them all to finish.
+ *
+ * The calling thread does one share of the work itself, so only threads - 1
+ * new threads are started. If any share throws, the first exception caught is
+ * rethrown once every thread has finished.
+ *
+ * @param	threads	The number of threads to run the work on, at least 1
+ * @param	work	Called once on each thread with the index of that thread
+ */
+template <typename Work>
+void runThreads(size_t threads, const Work& work) {
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	
+	auto share = [&](size_t thread) {
+		try {
+			work(thread);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	};
+	
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (size_t t = 1; t < threads; ++t) {
+		workers.emplace_back(share, t);
+	}
+	share(0);
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+#endif // Fundamentals_Threads_hpp_
@@ -0,0 +1,962 @@
+/**
+ * Fundamentals :: Data Structures :: Unrolled List
+ * Author: Quinn Mortimer
+ *
+ * This is an implementation of an unrolled linked list, which is a
+ * doubly-linked list that keeps several elements in each node.
+ * It is intended as a reference for those looking to brush up on important
+ * data structures.
+ */
+/**
+ * Every node of a LinkedList holds one element and two pointers, so when the
+ * elements are small most of the memory goes to the pointers, and walking
+ * the list can miss the cache on every element. Each node of an UnrolledList
+ * holds up to K elements in a small array instead. Walking the list mostly
+ * moves through those arrays, and the pointers are shared by K elements.
+ *
+ * Inserting into a node shifts the elements after it along by one, and when
+ * the node is full it is split in half first. Removing from a node shifts
+ * the later elements back, and when that leaves a node less than half full
+ * it takes an element from the next node, or merges with it if the next node
+ * has none to spare. Both of these take time proportional to K, which is a
+ * constant, so they are O(1).
+ *
+ * Since elements move between and within nodes, inserting or removing can
+ * invalidate iterators into the nodes that were changed. The insert and
+ * remove methods return an iterator that is valid afterwards.
+ *
+ * We will be using std::allocator for the nodes, along with std::move and
+ * std::move_if_noexcept from the standard library.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Checks.hpp"
+#include "Exceptions.hpp"
+
+#ifndef Fundamentals_UnrolledList_hpp_
+#define Fundamentals_UnrolledList_hpp_
+
+// The number of elements each node has room for, when it isn't given.
+#define UNROLLEDLIST_DEFAULT_NODE_SIZE 16
+
+// Forward declaration of the UnrolledList class.
+template <typename T, size_t K = UNROLLEDLIST_DEFAULT_NODE_SIZE> class UnrolledList;
+
+/**
+ * A node of an UnrolledList.
+ *
+ * Contains room for K elements, of which the first count are constructed,
+ * as well as pointers to its neighbour nodes.
+ */
+template <typename T, size_t K>
+struct UnrolledList_Node {
+	alignas(T) unsigned char storage[K * sizeof(T)];
+	size_t count;
+	struct UnrolledList_Node<T, K>* prev;
+	struct UnrolledList_Node<T, K>* next;
+	
+	T* data() { return reinterpret_cast<T*>(storage); }
+	const T* data() const { return reinterpret_cast<const T*>(storage); }
+};
+
+/**
+ * A bidirectional iterator over an UnrolledList.
+ *
+ * Element is T for an iterator with read-write access, and const T for one
+ * with read-only access.
+ *
+ * The iterator keeps the node it is in and the index of its element in that
+ * node. The end of the list has no node.
+ */
+template <typename T, size_t K, typename Element>
+class UnrolledList_Iterator {
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef typename std::remove_const<Element>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Element* pointer;
+		typedef Element& reference;
+		
+		// Constructors
+		UnrolledList_Iterator();
+		UnrolledList_Iterator(const UnrolledList_Iterator<T, K, Element>& other) = default;
+		// Converts an iterator into a const iterator
+		template <typename OtherElement, typename = typename std::enable_if<std::is_const<Element>::value && std::is_same<OtherElement, T>::value>::type>
+		UnrolledList_Iterator(const UnrolledList_Iterator<T, K, OtherElement>& other);
+		
+		// Assignment
+		UnrolledList_Iterator<T, K, Element>& operator=(const UnrolledList_Iterator<T, K, Element>& other) = default;
+		
+		// Data access
+		Element& operator*() const;
+		Element* operator->() const;
+		
+		// Increment and Decrement operators
+		UnrolledList_Iterator<T, K, Element>& operator++();
+		UnrolledList_Iterator<T, K, Element> operator++(int);
+		UnrolledList_Iterator<T, K, Element>& operator--();
+		UnrolledList_Iterator<T, K, Element> operator--(int);
+		
+		// Equality test operators
+		template <typename OtherElement>
+		bool operator==(const UnrolledList_Iterator<T, K, OtherElement>& other) const;
+		template <typename OtherElement>
+		bool operator!=(const UnrolledList_Iterator<T, K, OtherElement>& other) const;
+		
+	private:
+		typedef UnrolledList_Node<T, K> Node;
+		// Const iterators only see const nodes and a const owner.
+		typedef typename std::conditional<std::is_const<Element>::value, const Node, Node>::type ElementNode;
+		typedef typename std::conditional<std::is_const<Element>::value, const UnrolledList<T, K>, UnrolledList<T, K>>::type Owner;
+		
+		// The list which this iterator belongs to.
+		Owner* r_owner;
+		// The node this iterator is in, and the index of its element there.
+		ElementNode* r_node;
+		size_t m_index;
+		
+		// Node-and-owner constructor
+		// This is on its own in the private section because
+		// the user should not call it, but it is used by the UnrolledList class.
+		UnrolledList_Iterator(ElementNode* n, size_t index, Owner* owner);
+		
+	// UnrolledList and the other kind of iterator need access to private
+	// members of this class.
+	friend class UnrolledList<T, K>;
+	template <typename, size_t, typename> friend class UnrolledList_Iterator;
+};
+
+/**
+ * A doubly-linked list that keeps up to K elements in each node.
+ */
+template <typename T, size_t K>
+class UnrolledList {
+	static_assert(K >= 2, "An UnrolledList needs room for at least two elements per node");
+	
+	public:
+		typedef size_t size_type;
+		typedef UnrolledList_Iterator<T, K, T> iterator;
+		typedef UnrolledList_Iterator<T, K, const T> const_iterator;
+		
+		// Constructors and Destructor
+		UnrolledList();
+		UnrolledList(size_type a_size);
+		UnrolledList(size_type a_size, const T& a_value);
+		UnrolledList(const UnrolledList<T, K>& other);
+		UnrolledList(UnrolledList<T, K>&& other);
+		~UnrolledList();
+		
+		// Access to current size
+		size_type size() const;
+		bool empty() const;
+		
+		// Element insertion and deletion.
+		// - Front
+		void push_front(const T& value);
+		void push_front(T&& value);
+		void pop_front();
+		// - Back
+		void push_back(const T& value);
+		void push_back(T&& value);
+		void pop_back();
+		// - Arbitrary
+		iterator insert(iterator location, const T& value);
+		iterator insert(iterator location, T&& value);
+		iterator remove(iterator location);
+		// - Everything
+		void clear();
+		
+		// Iterators to the start and end of the list
+		iterator begin();
+		const_iterator begin() const;
+		iterator end();
+		const_iterator end() const;
+		
+		// Direct element access at the front and the back.
+		T& front();
+		const T& front() const;
+		T& back();
+		const T& back() const;
+		
+		// Operators
+		// - Asssignment
+		UnrolledList<T, K>& operator=(const UnrolledList<T, K>& other);
+		UnrolledList<T, K>& operator=(UnrolledList<T, K>&& other);
+		// - Equality testing
+		bool operator==(const UnrolledList<T, K>& other) const;
+		bool operator!=(const UnrolledList<T, K>& other) const;
+		
+	private:
+		typedef UnrolledList_Node<T, K> Node;
+		
+		Node* m_firstNode;
+		Node* m_lastNode;
+		size_type m_size;
+		
+		void m_swap(UnrolledList<T, K>& other);
+		
+		// Adds an element at the back, constructed from the arguments.
+		template <typename... Args>
+		void m_emplaceBack(Args&&... args);
+		// Adds an element at an index of a node, or at the back for no node.
+		iterator m_insertAt(Node* n, size_type index, T&& value);
+		// Moves the later half of a full node into a new node after it.
+		Node* m_split(Node* n);
+		// Tops up a node that is less than half full from the node after it.
+		void m_rebalance(Node* n);
+		
+		// Makes an empty node and links it in front of another node, or at
+		// the back for no node.
+		Node* m_createNode(Node* before);
+		// Unlinks a node and frees it. Its elements must be destroyed first.
+		void m_destroyNode(Node* n);
+		
+	// The iterators need to see the ends of their owner.
+	template <typename, size_t, typename> friend class UnrolledList_Iterator;
+};
+
+// -------------------- //
+// UnrolledList Methods //
+// -------------------- //
+/**
+ * Constructs an empty UnrolledList.
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>::UnrolledList()
+	: m_firstNode(nullptr), m_lastNode(nullptr), m_size(0)
+{}
+/**
+ * Constructs an UnrolledList with a known starting size.
+ *
+ * Elements initially in the list will be default-constructed.
+ *
+ * @param	size	The number of elements to be created initially
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>::UnrolledList(size_type size)
+	: UnrolledList()
+{
+	// Delegating means the destructor runs if an element's constructor throws
+	for (size_type i = 0; i < size; ++i) {
+		m_emplaceBack();
+	}
+}
+/**
+ * Constructs an UnrolledList of a specific size with a given value.
+ * @param	size	The number of elements to be created initially
+ * @param	value	The value to fill every element with
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>::UnrolledList(size_type size, const T& value)
+	: UnrolledList()
+{
+	for (size_type i = 0; i < size; ++i) {
+		m_emplaceBack(value);
+	}
+}
+/**
+ * Constructs a copy of another UnrolledList.
+ *
+ * The copy has every node filled, however full the other list's nodes are.
+ *
+ * @param	other	The list to copy
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>::UnrolledList(const UnrolledList<T, K>& other)
+	: UnrolledList()
+{
+	for (const Node* n = other.m_firstNode; n != nullptr; n = n->next) {
+		for (size_type i = 0; i < n->count; ++i) {
+			m_emplaceBack(n->data()[i]);
+		}
+	}
+}
+/**
+ * Constructs an UnrolledList by taking the nodes of another one.
+ * @param	other	The list to move from, which is left empty
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>::UnrolledList(UnrolledList<T, K>&& other)
+	: UnrolledList()
+{
+	m_swap(other);
+}
+/**
+ * Destroys every element and frees every node.
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>::~UnrolledList() {
+	clear();
+}
+
+/**
+ * Reports the number of elements in the list.
+ * @return	The size of the list
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::size_type UnrolledList<T, K>::size() const {
+	return m_size;
+}
+/**
+ * Reports whether the list has no elements.
+ * @return	Whether the size is 0
+ */
+template <typename T, size_t K>
+bool UnrolledList<T, K>::empty() const {
+	return m_size == 0;
+}
+
+/**
+ * Adds a copy of a value at the start of the list.
+ * @param	value	The value to add
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::push_front(const T& value) {
+	// The copy is made first, since the value might be one of the elements
+	// that is about to be shifted
+	m_insertAt(m_firstNode, 0, T(value));
+}
+/**
+ * Moves a value to the start of the list.
+ * @param	value	The value to add
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::push_front(T&& value) {
+	m_insertAt(m_firstNode, 0, T(std::move(value)));
+}
+/**
+ * Removes the first element from the list, if there is one.
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::pop_front() {
+	if (m_firstNode != nullptr) {
+		remove(begin());
+	}
+}
+/**
+ * Adds a copy of a value at the end of the list.
+ * @param	value	The value to add
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::push_back(const T& value) {
+	m_emplaceBack(value);
+}
+/**
+ * Moves a value to the end of the list.
+ * @param	value	The value to add
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::push_back(T&& value) {
+	m_emplaceBack(std::move(value));
+}
+/**
+ * Removes the last element from the list, if there is one.
+ *
+ * Nothing has to be shifted, so the last node is left as it is unless it
+ * becomes empty.
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::pop_back() {
+	if (m_lastNode != nullptr) {
+		Node* n = m_lastNode;
+		
+		--n->count;
+		--m_size;
+		n->data()[n->count].~T();
+		
+		if (n->count == 0) {
+			m_destroyNode(n);
+		}
+	}
+}
+/**
+ * Inserts a copy of a value into the list before the provided iterator.
+ *
+ * Iterators into the node the value ends up in, and into a node it had to
+ * be split from, are invalidated.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this
+ * @param	location	The position to insert the value in front of
+ * @param	value	The value to insert
+ * @return	An iterator to the inserted element
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator UnrolledList<T, K>::insert(iterator location, const T& value) {
+	if (location.r_owner != this) {
+		throw MismatchedIteratorError();
+	}
+	
+	return m_insertAt(location.r_node, location.m_index, T(value));
+}
+/**
+ * Moves a value into the list before the provided iterator.
+ * @throws	MismatchedIteratorError	when location's owner is not this
+ * @param	location	The position to insert the value in front of
+ * @param	value	The value to insert
+ * @return	An iterator to the inserted element
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator UnrolledList<T, K>::insert(iterator location, T&& value) {
+	if (location.r_owner != this) {
+		throw MismatchedIteratorError();
+	}
+	
+	return m_insertAt(location.r_node, location.m_index, T(std::move(value)));
+}
+/**
+ * Removes the provided iterator's element from the list.
+ *
+ * Iterators into the element's node and the node after it are invalidated.
+ *
+ * @throws	MismatchedIteratorError	when location's owner is not this
+ * @throws	OutOfBoundsError	when location is the end of the list
+ * @param	location	The element to remove
+ * @return	An iterator to the element that came after the removed one
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator UnrolledList<T, K>::remove(iterator location) {
+	if (location.r_owner != this) {
+		throw MismatchedIteratorError();
+	}
+	FUNDAMENTALS_CHECK_BOUNDS(location.r_node != nullptr);
+	
+	Node* n = location.r_node;
+	size_type index = location.m_index;
+	T* data = n->data();
+	
+	std::move(data + index + 1, data + n->count, data + index);
+	--n->count;
+	--m_size;
+	data[n->count].~T();
+	
+	if (n->count == 0) {
+		Node* next = n->next;
+		m_destroyNode(n);
+		return iterator(next, 0, this);
+	}
+	
+	// Anything taken from the next node lands right after index, so index
+	// still names the element that came after the removed one
+	m_rebalance(n);
+	
+	if (index == n->count) {
+		return iterator(n->next, 0, this);
+	}
+	return iterator(n, index, this);
+}
+/**
+ * Removes every element from the list and frees every node.
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::clear() {
+	while (m_firstNode != nullptr) {
+		Node* n = m_firstNode;
+		std::destroy_n(n->data(), n->count);
+		n->count = 0;
+		m_destroyNode(n);
+	}
+	
+	m_size = 0;
+}
+
+/**
+ * Provides an iterator to the first element of the list.
+ * @return	An iterator to the first element
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator UnrolledList<T, K>::begin() {
+	return iterator(m_firstNode, 0, this);
+}
+/**
+ * Provides a read-only iterator to the first element of the list.
+ * @return	A const iterator to the first element
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::const_iterator UnrolledList<T, K>::begin() const {
+	return const_iterator(m_firstNode, 0, this);
+}
+/**
+ * Provides an iterator to the position after the last element of the list.
+ * @return	An iterator to the end of the list
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator UnrolledList<T, K>::end() {
+	return iterator(nullptr, 0, this);
+}
+/**
+ * Provides a read-only iterator to the position after the last element.
+ * @return	A const iterator to the end of the list
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::const_iterator UnrolledList<T, K>::end() const {
+	return const_iterator(nullptr, 0, this);
+}
+
+/**
+ * Provides the first element of the list.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A reference to the first element
+ */
+template <typename T, size_t K>
+T& UnrolledList<T, K>::front() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_firstNode != nullptr);
+	return m_firstNode->data()[0];
+}
+/**
+ * Provides the first element of the list, read-only.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A const reference to the first element
+ */
+template <typename T, size_t K>
+const T& UnrolledList<T, K>::front() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_firstNode != nullptr);
+	return m_firstNode->data()[0];
+}
+/**
+ * Provides the last element of the list.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A reference to the last element
+ */
+template <typename T, size_t K>
+T& UnrolledList<T, K>::back() {
+	FUNDAMENTALS_CHECK_BOUNDS(m_lastNode != nullptr);
+	return m_lastNode->data()[m_lastNode->count - 1];
+}
+/**
+ * Provides the last element of the list, read-only.
+ * @throws	OutOfBoundsError	when the list is empty
+ * @return	A const reference to the last element
+ */
+template <typename T, size_t K>
+const T& UnrolledList<T, K>::back() const {
+	FUNDAMENTALS_CHECK_BOUNDS(m_lastNode != nullptr);
+	return m_lastNode->data()[m_lastNode->count - 1];
+}
+
+/**
+ * Replaces the contents of this list with a copy of another's.
+ * @param	other	The list to copy
+ * @return	This, after the copy
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>& UnrolledList<T, K>::operator=(const UnrolledList<T, K>& other) {
+	if (this != &other) {
+		UnrolledList<T, K> tmp(other);
+		m_swap(tmp);
+	}
+	return *this;
+}
+/**
+ * Replaces the contents of this list by taking another's nodes.
+ * @param	other	The list to move from, which is left empty
+ * @return	This, after the move
+ */
+template <typename T, size_t K>
+UnrolledList<T, K>& UnrolledList<T, K>::operator=(UnrolledList<T, K>&& other) {
+	if (this != &other) {
+		clear();
+		m_swap(other);
+	}
+	return *this;
+}
+/**
+ * Tests whether two lists hold equal elements in the same order.
+ *
+ * The lists can have their elements split between nodes differently.
+ *
+ * @param	other	The list to compare against
+ * @return	Whether the lists are equal
+ */
+template <typename T, size_t K>
+bool UnrolledList<T, K>::operator==(const UnrolledList<T, K>& other) const {
+	if (m_size != other.m_size) {
+		return false;
+	}
+	
+	const_iterator a = begin();
+	const_iterator b = other.begin();
+	for (; a != end(); ++a, ++b) {
+		if (!(*a == *b)) {
+			return false;
+		}
+	}
+	return true;
+}
+/**
+ * Tests whether two lists differ in any element.
+ * @param	other	The list to compare against
+ * @return	Whether the lists are not equal
+ */
+template <typename T, size_t K>
+bool UnrolledList<T, K>::operator!=(const UnrolledList<T, K>& other) const {
+	return !(*this == other);
+}
+
+/**
+ * Swaps the member variables of this with those of another UnrolledList.
+ * @param	other	The list to swap contents with
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::m_swap(UnrolledList<T, K>& other) {
+	std::swap(m_firstNode, other.m_firstNode);
+	std::swap(m_lastNode, other.m_lastNode);
+	std::swap(m_size, other.m_size);
+}
+/**
+ * Adds an element at the back of the list, making a new node if needed.
+ *
+ * None of the existing elements move, so it's safe for the arguments to
+ * refer to one of them.
+ *
+ * @param	args	The arguments for the constructor of T
+ */
+template <typename T, size_t K>
+template <typename... Args>
+void UnrolledList<T, K>::m_emplaceBack(Args&&... args) {
+	if (m_lastNode != nullptr && m_lastNode->count < K) {
+		new (m_lastNode->data() + m_lastNode->count) T(std::forward<Args>(args)...);
+		++m_lastNode->count;
+	}
+	else {
+		Node* n = m_createNode(nullptr);
+		try {
+			new (n->data()) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			m_destroyNode(n);
+			throw;
+		}
+		n->count = 1;
+	}
+	
+	++m_size;
+}
+/**
+ * Adds an element in front of the element at an index of a node.
+ *
+ * The value is taken by the caller before this is called, so it's safe for
+ * it to have come from an element of this list. When the node is full, the
+ * element goes at the end of the node before it if that has room, or into a
+ * new node if it is going at the very front. Otherwise the node is split.
+ *
+ * @param	n	The node to insert into, or nullptr for the back of the list
+ * @param	index	Where the new element should end up in the node
+ * @param	value	The value to move into the list
+ * @return	An iterator to the new element
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::iterator UnrolledList<T, K>::m_insertAt(Node* n, size_type index, T&& value) {
+	if (n == nullptr) {
+		m_emplaceBack(std::move(value));
+		return iterator(m_lastNode, m_lastNode->count - 1, this);
+	}
+	
+	if (n->count == K) {
+		if (index == 0 && (n->prev == nullptr || n->prev->count < K)) {
+			Node* target = n->prev;
+			if (target == nullptr) {
+				target = m_createNode(n);
+			}
+			
+			try {
+				new (target->data() + target->count) T(std::move(value));
+			}
+			catch (...) {
+				if (target->count == 0) {
+					m_destroyNode(target);
+				}
+				throw;
+			}
+			++target->count;
+			++m_size;
+			return iterator(target, target->count - 1, this);
+		}
+		
+		Node* upper = m_split(n);
+		if (index > n->count) {
+			index -= n->count;
+			n = upper;
+		}
+	}
+	
+	T* data = n->data();
+	if (index == n->count) {
+		new (data + index) T(std::move(value));
+	}
+	else {
+		// The last element moves into the unconstructed slot past the end,
+		// and everything else between index and there shifts back by one
+		new (data + n->count) T(std::move(data[n->count - 1]));
+		std::move_backward(data + index, data + n->count - 1, data + n->count);
+		data[index] = std::move(value);
+	}
+	++n->count;
+	++m_size;
+	
+	return iterator(n, index, this);
+}
+/**
+ * Moves the later half of a full node into a new node right after it.
+ *
+ * If T's move constructor might throw, the elements are copied instead, so
+ * that the node is left as it was if one of the copies throws.
+ *
+ * @param	n	The full node to split
+ * @return	The new node, holding the later half of the elements
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::Node* UnrolledList<T, K>::m_split(Node* n) {
+	Node* upper = m_createNode(n->next);
+	size_type keep = K / 2;
+	T* from = n->data() + keep;
+	T* to = upper->data();
+	
+	try {
+		for (; upper->count < K - keep; ++upper->count) {
+			new (to + upper->count) T(std::move_if_noexcept(from[upper->count]));
+		}
+	}
+	catch (...) {
+		std::destroy_n(to, upper->count);
+		upper->count = 0;
+		m_destroyNode(upper);
+		throw;
+	}
+	
+	std::destroy_n(from, K - keep);
+	n->count = keep;
+	return upper;
+}
+/**
+ * Tops up a node that is less than half full from the node after it.
+ *
+ * If the next node has more than half of K elements, its first element is
+ * moved to the end of this node. Otherwise every element of the next node
+ * fits in this one, so they are all moved over and the next node is freed.
+ *
+ * @param	n	The node that an element was just removed from
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::m_rebalance(Node* n) {
+	Node* next = n->next;
+	if (n->count >= K / 2 || next == nullptr) {
+		return;
+	}
+	
+	T* data = n->data();
+	T* nextData = next->data();
+	
+	if (next->count > K / 2) {
+		new (data + n->count) T(std::move(nextData[0]));
+		++n->count;
+		std::move(nextData + 1, nextData + next->count, nextData);
+		--next->count;
+		nextData[next->count].~T();
+	}
+	else {
+		for (size_type i = 0; i < next->count; ++i) {
+			new (data + n->count) T(std::move(nextData[i]));
+			++n->count;
+		}
+		std::destroy_n(nextData, next->count);
+		next->count = 0;
+		m_destroyNode(next);
+	}
+}
+
+/**
+ * Allocates an empty node and links it into the list.
+ * @param	before	The node to link the new one in front of, or nullptr to
+ * 	link it at the back
+ * @return	The new node
+ */
+template <typename T, size_t K>
+typename UnrolledList<T, K>::Node* UnrolledList<T, K>::m_createNode(Node* before) {
+	Node* n = std::allocator<Node>().allocate(1);
+	new (n) Node;
+	
+	n->count = 0;
+	n->next = before;
+	n->prev = (before == nullptr) ? m_lastNode : before->prev;
+	
+	if (n->prev != nullptr) {
+		n->prev->next = n;
+	}
+	else {
+		m_firstNode = n;
+	}
+	
+	if (before != nullptr) {
+		before->prev = n;
+	}
+	else {
+		m_lastNode = n;
+	}
+	
+	return n;
+}
+/**
+ * Unlinks a node from the list and frees its memory.
+ * @param	n	The node to free, whose elements are already destroyed
+ */
+template <typename T, size_t K>
+void UnrolledList<T, K>::m_destroyNode(Node* n) {
+	if (n->prev != nullptr) {
+		n->prev->next = n->next;
+	}
+	else {
+		m_firstNode = n->next;
+	}
+	
+	if (n->next != nullptr) {
+		n->next->prev = n->prev;
+	}
+	else {
+		m_lastNode = n->prev;
+	}
+	
+	n->~Node();
+	std::allocator<Node>().deallocate(n, 1);
+}
+
+// ----------------------------- //
+// UnrolledList_Iterator methods //
+// ----------------------------- //
+/**
+ * Constructs an iterator that doesn't belong to any list.
+ */
+template <typename T, size_t K, typename Element>
+UnrolledList_Iterator<T, K, Element>::UnrolledList_Iterator()
+	: r_owner(nullptr), r_node(nullptr), m_index(0)
+{}
+/**
+ * Constructs a const iterator from a non-const one.
+ * @param	other	The iterator to convert
+ */
+template <typename T, size_t K, typename Element>
+template <typename OtherElement, typename>
+UnrolledList_Iterator<T, K, Element>::UnrolledList_Iterator(const UnrolledList_Iterator<T, K, OtherElement>& other)
+	: r_owner(other.r_owner), r_node(other.r_node), m_index(other.m_index)
+{}
+/**
+ * Constructs an iterator to an element of a list.
+ * @param	n	The node the element is in, or nullptr for the end
+ * @param	index	The index of the element in the node
+ * @param	owner	The list the node belongs to
+ */
+template <typename T, size_t K, typename Element>
+UnrolledList_Iterator<T, K, Element>::UnrolledList_Iterator(ElementNode* n, size_t index, Owner* owner)
+	: r_owner(owner), r_node(n), m_index(index)
+{}
+
+/**
+ * Provides the element this iterator points to.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A reference to the element
+ */
+template <typename T, size_t K, typename Element>
+Element& UnrolledList_Iterator<T, K, Element>::operator*() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	return r_node->data()[m_index];
+}
+/**
+ * Provides access to the members of the element this iterator points to.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A pointer to the element
+ */
+template <typename T, size_t K, typename Element>
+Element* UnrolledList_Iterator<T, K, Element>::operator->() const {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	return r_node->data() + m_index;
+}
+
+/**
+ * Moves this iterator to the next element, which may be in the next node.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	This, after it has moved
+ */
+template <typename T, size_t K, typename Element>
+UnrolledList_Iterator<T, K, Element>& UnrolledList_Iterator<T, K, Element>::operator++() {
+	FUNDAMENTALS_CHECK_BOUNDS(r_node != nullptr);
+	
+	++m_index;
+	if (m_index == r_node->count) {
+		r_node = r_node->next;
+		m_index = 0;
+	}
+	
+	return *this;
+}
+/**
+ * Moves this iterator to the next element.
+ * @throws	OutOfBoundsError	when this is the end of the list
+ * @return	A copy of this from before it moved
+ */
+template <typename T, size_t K, typename Element>
+UnrolledList_Iterator<T, K, Element> UnrolledList_Iterator<T, K, Element>::operator++(int) {
+	UnrolledList_Iterator<T, K, Element> copy = *this;
+	++(*this);
+	return copy;
+}
+/**
+ * Moves this iterator to the previous element, which may be in the previous
+ * node. From the end of the list, it moves to the last element.
+ * @throws	OutOfBoundsError	when this is the start of the list
+ * @return	This, after it has moved
+ */
+template <typename T, size_t K, typename Element>
+UnrolledList_Iterator<T, K, Element>& UnrolledList_Iterator<T, K, Element>::operator--() {
+	if (m_index > 0) {
+		--m_index;
+		return *this;
+	}
+	
+	ElementNode* prev = (r_node == nullptr) ? r_owner->m_lastNode : r_node->prev;
+	FUNDAMENTALS_CHECK_BOUNDS(prev != nullptr);
+	
+	r_node = prev;
+	m_index = prev->count - 1;
+	
+	return *this;
+}
+/**
+ * Moves this iterator to the previous element.
+ * @throws	OutOfBoundsError	when this is the start of the list
+ * @return	A copy of this from before it moved
+ */
+template <typename T, size_t K, typename Element>
+UnrolledList_Iterator<T, K, Element> UnrolledList_Iterator<T, K, Element>::operator--(int) {
+	UnrolledList_Iterator<T, K, Element> copy = *this;
+	--(*this);
+	return copy;
+}
+
+/**
+ * Tests whether two iterators point to the same element.
+ * @param	other	The iterator to compare against
+ * @return	Whether the iterators are equal
+ */
+template <typename T, size_t K, typename Element>
+template <typename OtherElement>
+bool UnrolledList_Iterator<T, K, Element>::operator==(const UnrolledList_Iterator<T, K, OtherElement>& other) const {
+	return r_owner == other.r_owner && r_node == other.r_node && m_index == other.m_index;
+}
+/**
+ * Tests whether two iterators point to different elements.
+ * @param	other	The iterator to compare against
+ * @return	Whether the iterators are not equal
+ */
+template <typename T, size_t K, typename Element>
+template <typename OtherElement>
+bool UnrolledList_Iterator<T, K, Element>::operator!=(const UnrolledList_Iterator<T, K, OtherElement>& other) const {
+	return !(*this == other);
+}
+
+#endif // Fundamentals_UnrolledList_hpp_
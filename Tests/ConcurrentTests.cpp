@@ -0,0 +1,234 @@
+/**
+ * Fundamentals :: Tests :: Concurrent Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the hash maps that can be shared between threads. Each one
+ * is checked against a plain HashMap on a single thread, and then hammered
+ * from several threads at once. The threaded tests are small enough to run
+ * under ThreadSanitizer.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ConcurrentHashMap.hpp"
+#include "HashMap.hpp"
+#include "ReadMostlyHashMap.hpp"
+
+// The number of threads the stress tests start.
+#define FUNDAMENTALS_TEST_THREADS 8
+// The number of keys each thread of a stress test works on.
+#define FUNDAMENTALS_TEST_THREAD_KEYS 2000
+
+TEST(ConcurrentHashMapTest, MatchesHashMapOnOneThread) {
+	ConcurrentHashMap<int, int> map;
+	HashMap<int, int> reference;
+	std::mt19937 random(7);
+	
+	for (int i = 0; i < 20000; ++i) {
+		int key = static_cast<int>(random() % 1000);
+		int value = 0;
+		switch (random() % 4) {
+			case 0:
+				EXPECT_EQ(map.insert_or_assign(key, i), !reference.hasKey(key));
+				reference.set(key, i);
+				break;
+			case 1:
+				EXPECT_EQ(map.erase(key), reference.hasKey(key));
+				reference.unset(key);
+				break;
+			case 2:
+				EXPECT_EQ(map.contains(key), reference.hasKey(key));
+				break;
+			default:
+				EXPECT_EQ(map.find(key, value), reference.hasKey(key));
+				if (reference.hasKey(key)) {
+					EXPECT_EQ(value, reference.getValue(key));
+				}
+		}
+	}
+	
+	EXPECT_EQ(map.size(), reference.size());
+	EXPECT_EQ(map.empty(), reference.empty());
+}
+
+TEST(ConcurrentHashMapTest, ShardCountIsAPowerOfTwo) {
+	ConcurrentHashMap<int, int> map(DefaultHash<int>(), 5);
+	EXPECT_EQ(map.shardCount(), 8u);
+	
+	ConcurrentHashMap<int, int> single(DefaultHash<int>(), 1);
+	EXPECT_EQ(single.shardCount(), 1u);
+	EXPECT_TRUE(single.insert_or_assign(1, 1));
+	EXPECT_FALSE(single.insert_or_assign(1, 2));
+	int value = 0;
+	EXPECT_TRUE(single.find(1, value));
+	EXPECT_EQ(value, 2);
+}
+
+TEST(ConcurrentHashMapTest, ThreadsInsertEraseAndFind) {
+	ConcurrentHashMap<int, int> map(DefaultHash<int>(), 4);
+	std::vector<std::thread> threads;
+	std::vector<int> failures(FUNDAMENTALS_TEST_THREADS, 0);
+	
+	// Each thread owns its own keys, and also reads and writes shared ones
+	for (int t = 0; t < FUNDAMENTALS_TEST_THREADS; ++t) {
+		threads.emplace_back([&map, &failures, t]() {
+			const int first = (t + 1) * FUNDAMENTALS_TEST_THREAD_KEYS;
+			for (int i = 0; i < FUNDAMENTALS_TEST_THREAD_KEYS; ++i) {
+				map.insert_or_assign(first + i, t);
+				map.insert_or_assign(i % 64, t);
+			}
+			for (int i = 0; i < FUNDAMENTALS_TEST_THREAD_KEYS; ++i) {
+				int value = -1;
+				if (!map.find(first + i, value) || value != t) {
+					++failures[t];
+				}
+				if (map.find(i % 64, value) && (value < 0 || value >= FUNDAMENTALS_TEST_THREADS)) {
+					++failures[t];
+				}
+				if (i % 2 == 1 && !map.erase(first + i)) {
+					++failures[t];
+				}
+				map.erase(i % 64 + 64);
+				map.contains(i % 64);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	
+	for (int t = 0; t < FUNDAMENTALS_TEST_THREADS; ++t) {
+		EXPECT_EQ(failures[t], 0);
+		const int first = (t + 1) * FUNDAMENTALS_TEST_THREAD_KEYS;
+		for (int i = 0; i < FUNDAMENTALS_TEST_THREAD_KEYS; ++i) {
+			EXPECT_EQ(map.contains(first + i), i % 2 == 0);
+		}
+	}
+	EXPECT_EQ(map.size(), 64u + FUNDAMENTALS_TEST_THREADS * FUNDAMENTALS_TEST_THREAD_KEYS / 2);
+}
+
+TEST(ReadMostlyHashMapTest, MatchesHashMapOnOneThread) {
+	ReadMostlyHashMap<int, int> map;
+	HashMap<int, int> reference;
+	std::mt19937 random(11);
+	
+	for (int i = 0; i < 5000; ++i) {
+		int key = static_cast<int>(random() % 200);
+		int value = 0;
+		switch (random() % 5) {
+			case 0:
+				if (reference.hasKey(key)) {
+					EXPECT_THROW(map.insert(key, i), DuplicateKeyError);
+				}
+				else {
+					map.insert(key, i);
+					reference.insert(key, i);
+				}
+				break;
+			case 1:
+				if (reference.hasKey(key)) {
+					map.remove(key);
+					reference.remove(key);
+				}
+				else {
+					EXPECT_THROW(map.remove(key), MissingKeyError);
+				}
+				break;
+			case 2:
+				map.set(key, i);
+				reference.set(key, i);
+				break;
+			case 3:
+				map.unset(key);
+				reference.unset(key);
+				break;
+			default:
+				EXPECT_EQ(map.hasKey(key), reference.hasKey(key));
+				EXPECT_EQ(map.find(key, value), reference.hasKey(key));
+				if (reference.hasKey(key)) {
+					EXPECT_EQ(value, reference.getValue(key));
+					EXPECT_EQ(map.getValue(key), reference.getValue(key));
+				}
+				else {
+					EXPECT_THROW(map.getValue(key), MissingKeyError);
+				}
+		}
+	}
+	
+	EXPECT_EQ(map.size(), reference.size());
+	EXPECT_TRUE(map.snapshot() == reference);
+}
+
+TEST(ReadMostlyHashMapTest, FailedUpdatePublishesNothing) {
+	ReadMostlyHashMap<int, int> map;
+	map.insert(1, 1);
+	
+	EXPECT_THROW(map.update([](HashMap<int, int>& table) {
+		table.set(2, 2);
+		table.insert(1, 3);
+	}), DuplicateKeyError);
+	EXPECT_FALSE(map.hasKey(2));
+	EXPECT_EQ(map.getValue(1), 1);
+	
+	map.update([](HashMap<int, int>& table) {
+		table.set(2, 2);
+		table.set(3, 3);
+	});
+	EXPECT_EQ(map.size(), 3u);
+}
+
+TEST(ReadMostlyHashMapTest, ReadersSeeWholeUpdates) {
+	ReadMostlyHashMap<int, int> map;
+	std::atomic<bool> done(false);
+	std::vector<std::thread> readers;
+	std::vector<int> failures(FUNDAMENTALS_TEST_THREADS, 0);
+	
+	// Every update sets keys 0 and 1 to the same value, so a reader that
+	// finds both should never see them differ within one snapshot
+	map.update([](HashMap<int, int>& table) {
+		table.set(0, 0);
+		table.set(1, 0);
+	});
+	for (int t = 0; t < FUNDAMENTALS_TEST_THREADS; ++t) {
+		readers.emplace_back([&map, &done, &failures, t]() {
+			int last = 0;
+			while (!done.load()) {
+				HashMap<int, int> table = map.snapshot();
+				if (table.getValue(0) != table.getValue(1) || table.getValue(0) < last) {
+					++failures[t];
+				}
+				last = table.getValue(0);
+				
+				int value = -1;
+				if (!map.find(0, value) || value < last) {
+					++failures[t];
+				}
+				map.hasKey(t + 2);
+			}
+		});
+	}
+	
+	for (int i = 1; i <= 500; ++i) {
+		map.update([i](HashMap<int, int>& table) {
+			table.set(0, i);
+			table.set(1, i);
+		});
+		map.set(i % 16 + 2, i);
+		map.unset((i + 8) % 16 + 2);
+	}
+	done.store(true);
+	for (std::thread& reader : readers) {
+		reader.join();
+	}
+	
+	for (int t = 0; t < FUNDAMENTALS_TEST_THREADS; ++t) {
+		EXPECT_EQ(failures[t], 0);
+	}
+	EXPECT_EQ(map.getValue(0), 500);
+}
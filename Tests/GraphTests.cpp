@@ -0,0 +1,255 @@
+/**
+ * Fundamentals :: Tests :: Graph Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the C++ graph algorithms against simple versions of them
+ * on random graphs, with one thread and with several.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "Graph.hpp"
+#include "GraphAlgorithms.hpp"
+
+/**
+ * Makes a random graph.
+ * @param	vertices	The number of vertices
+ * @param	edges	The number of edges
+ * @param	minWeight	The least weight an edge can have
+ * @param	maxWeight	The greatest weight an edge can have
+ * @param	seed	The seed for the edges
+ * @return	The edges of the graph
+ */
+template <typename Weight>
+DynamicArray<Graph_Edge<Weight>> randomEdges(uint32_t vertices, size_t edges, int minWeight, int maxWeight, unsigned seed) {
+	std::mt19937 random(seed);
+	DynamicArray<Graph_Edge<Weight>> result;
+	for (size_t i = 0; i < edges; ++i) {
+		uint32_t from = static_cast<uint32_t>(random() % vertices);
+		uint32_t to = static_cast<uint32_t>(random() % vertices);
+		Weight weight = static_cast<Weight>(minWeight + static_cast<int>(random() % (maxWeight - minWeight + 1)));
+		result.push_back(Graph_Edge<Weight>{from, to, weight});
+	}
+	return result;
+}
+/**
+ * Finds the shortest distances by relaxing every edge once per vertex, the
+ * way the textbook Bellman-Ford does.
+ * @param	vertices	The number of vertices
+ * @param	edges	The edges of the graph
+ * @param	start	The vertex the paths start at
+ * @param	negativeCycle	Set to whether a negative cycle can be reached
+ * @return	The distances, or the greatest Weight for unreachable vertices
+ */
+template <typename Weight>
+std::vector<Weight> referenceDistances(uint32_t vertices, const DynamicArray<Graph_Edge<Weight>>& edges, uint32_t start, bool& negativeCycle) {
+	const Weight unreached = std::numeric_limits<Weight>::max();
+	std::vector<Weight> distances(vertices, unreached);
+	distances[start] = Weight();
+	negativeCycle = false;
+	for (uint32_t round = 0; round <= vertices; ++round) {
+		bool changed = false;
+		for (const Graph_Edge<Weight>& edge : edges) {
+			if (distances[edge.from] != unreached && distances[edge.from] + edge.weight < distances[edge.to]) {
+				distances[edge.to] = distances[edge.from] + edge.weight;
+				changed = true;
+			}
+		}
+		if (!changed) {
+			return distances;
+		}
+	}
+	negativeCycle = true;
+	return distances;
+}
+/**
+ * Finds how many edges away each vertex is with a one-thread, forwards-only
+ * breadth-first search.
+ * @param	graph	The graph to search
+ * @param	start	The vertex to search from
+ * @return	The levels, or GRAPH_UNREACHED for unreachable vertices
+ */
+template <typename Weight>
+std::vector<uint32_t> referenceLevels(const Graph<Weight>& graph, uint32_t start) {
+	std::vector<uint32_t> levels(graph.vertexCount(), GRAPH_UNREACHED);
+	std::queue<uint32_t> queue;
+	levels[start] = 0;
+	queue.push(start);
+	while (!queue.empty()) {
+		uint32_t v = queue.front();
+		queue.pop();
+		for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+			if (levels[graph.target(e)] == GRAPH_UNREACHED) {
+				levels[graph.target(e)] = levels[v] + 1;
+				queue.push(graph.target(e));
+			}
+		}
+	}
+	return levels;
+}
+
+TEST(GraphTest, InAndOutEdgesMatch) {
+	DynamicArray<Graph_Edge<uint32_t>> edges = randomEdges<uint32_t>(50, 300, 1, 9, 1);
+	Graph<uint32_t> graph(50, edges);
+	EXPECT_EQ(graph.vertexCount(), 50u);
+	EXPECT_EQ(graph.edgeCount(), 300u);
+	
+	// Every edge appears once out of its source and once into its target
+	std::vector<size_t> outCounts(50 * 50, 0);
+	std::vector<size_t> inCounts(50 * 50, 0);
+	std::vector<size_t> expected(50 * 50, 0);
+	for (const Graph_Edge<uint32_t>& edge : edges) {
+		++expected[edge.from * 50 + edge.to];
+	}
+	for (uint32_t v = 0; v < 50; ++v) {
+		for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+			++outCounts[v * 50 + graph.target(e)];
+		}
+		for (size_t e = graph.inEdgesBegin(v); e < graph.inEdgesEnd(v); ++e) {
+			++inCounts[graph.source(e) * 50 + v];
+		}
+	}
+	EXPECT_EQ(outCounts, expected);
+	EXPECT_EQ(inCounts, expected);
+	
+	edges.push_back(Graph_Edge<uint32_t>{0, 50, 1});
+	EXPECT_THROW((Graph<uint32_t>(50, edges)), OutOfBoundsError);
+}
+
+TEST(GraphTest, BuilderNamesVertices) {
+	GraphBuilder<std::string> builder;
+	builder.addEdge("a", "b", 2);
+	builder.addEdge("b", "c", 3);
+	builder.addEdge("a", "c", 7);
+	EXPECT_EQ(builder.addVertex("b"), 1u);
+	EXPECT_EQ(builder.vertexCount(), 3u);
+	EXPECT_TRUE(builder.hasVertex("c"));
+	EXPECT_FALSE(builder.hasVertex("d"));
+	EXPECT_THROW(builder.index("d"), MissingKeyError);
+	
+	Graph<uint32_t> graph = builder.build();
+	GraphPaths<uint32_t> paths = dijkstra(graph, builder.index("a"));
+	EXPECT_EQ(paths.distances[builder.index("c")], 5u);
+	DynamicArray<uint32_t> path = shortestPath(paths, builder.index("c"));
+	ASSERT_EQ(path.size(), 3u);
+	EXPECT_EQ(builder.key(path[1]), "b");
+}
+
+TEST(GraphTest, DijkstraMatchesReference) {
+	for (unsigned seed = 0; seed < 5; ++seed) {
+		// Sparse enough that some vertices can't be reached
+		const uint32_t vertices = 400;
+		DynamicArray<Graph_Edge<uint64_t>> edges = randomEdges<uint64_t>(vertices, 600, 0, 100, seed);
+		Graph<uint64_t> graph(vertices, edges);
+		bool negativeCycle;
+		std::vector<uint64_t> expected = referenceDistances(vertices, edges, 0, negativeCycle);
+		
+		GraphPaths<uint64_t> paths = dijkstra(graph, 0);
+		for (uint32_t v = 0; v < vertices; ++v) {
+			ASSERT_EQ(paths.distances[v], expected[v]) << "vertex " << v << " seed " << seed;
+			
+			// The path to each vertex is made of edges and adds up to its distance
+			DynamicArray<uint32_t> path = shortestPath(paths, v);
+			if (expected[v] == std::numeric_limits<uint64_t>::max()) {
+				EXPECT_EQ(path.size(), 0u);
+				continue;
+			}
+			ASSERT_GT(path.size(), 0u);
+			EXPECT_EQ(path[0], 0u);
+			EXPECT_EQ(path[path.size() - 1], v);
+			uint64_t length = 0;
+			for (size_t i = 1; i < path.size(); ++i) {
+				uint64_t shortest = std::numeric_limits<uint64_t>::max();
+				for (size_t e = graph.edgesBegin(path[i - 1]); e < graph.edgesEnd(path[i - 1]); ++e) {
+					if (graph.target(e) == path[i] && graph.weight(e) < shortest) {
+						shortest = graph.weight(e);
+					}
+				}
+				ASSERT_NE(shortest, std::numeric_limits<uint64_t>::max());
+				length += shortest;
+			}
+			EXPECT_EQ(length, expected[v]);
+		}
+		
+		// Stopping at a target still gives its distance
+		GraphPaths<uint64_t> toTarget = dijkstra(graph, 0, vertices - 1);
+		EXPECT_EQ(toTarget.distances[vertices - 1], expected[vertices - 1]);
+	}
+	
+	Graph<uint64_t> graph(3, DynamicArray<Graph_Edge<uint64_t>>());
+	EXPECT_THROW(dijkstra(graph, 3), OutOfBoundsError);
+}
+
+TEST(GraphTest, BreadthFirstSearchMatchesReference) {
+	// Dense enough for the search to switch to searching backwards and back
+	const uint32_t vertices = 5000;
+	for (size_t edgeCount : { size_t(4000), size_t(60000) }) {
+		Graph<uint32_t> graph(vertices, randomEdges<uint32_t>(vertices, edgeCount, 1, 1, 7));
+		std::vector<uint32_t> expected = referenceLevels(graph, 0);
+		for (size_t threads : { 1, 3, 4 }) {
+			DynamicArray<uint32_t> levels = breadthFirstSearch(graph, 0, threads);
+			ASSERT_EQ(levels.size(), expected.size());
+			for (uint32_t v = 0; v < vertices; ++v) {
+				ASSERT_EQ(levels[v], expected[v]) << "vertex " << v << " with " << threads << " threads";
+			}
+		}
+	}
+}
+
+TEST(GraphTest, BellmanFordMatchesReference) {
+	for (unsigned seed = 0; seed < 5; ++seed) {
+		// Negative edges only go from lower to higher vertices, and an edge
+		// back down or to itself costs more than any path up can save, so
+		// there are no negative cycles
+		const uint32_t vertices = 300;
+		DynamicArray<Graph_Edge<int64_t>> edges = randomEdges<int64_t>(vertices, 1500, -20, 100, seed);
+		for (Graph_Edge<int64_t>& edge : edges) {
+			if (edge.from >= edge.to) {
+				edge.weight = 20 * int64_t(vertices) + (edge.weight < 0 ? -edge.weight : edge.weight);
+			}
+		}
+		Graph<int64_t> graph(vertices, edges);
+		bool negativeCycle;
+		std::vector<int64_t> expected = referenceDistances(vertices, edges, 0, negativeCycle);
+		ASSERT_FALSE(negativeCycle);
+		
+		for (size_t threads : { 1, 3, 4 }) {
+			DynamicArray<int64_t> distances = bellmanFord(graph, 0, threads);
+			for (uint32_t v = 0; v < vertices; ++v) {
+				ASSERT_EQ(distances[v], expected[v]) << "vertex " << v << " with " << threads << " threads";
+			}
+		}
+	}
+}
+
+TEST(GraphTest, BellmanFordNegativeCycles) {
+	// 0 -> 1 -> 2 -> 1 costs -1 around, and 3 -> 4 -> 3 can't be reached from 0
+	DynamicArray<Graph_Edge<int32_t>> edges;
+	edges.push_back(Graph_Edge<int32_t>{0, 1, 5});
+	edges.push_back(Graph_Edge<int32_t>{3, 4, -3});
+	edges.push_back(Graph_Edge<int32_t>{4, 3, 1});
+	Graph<int32_t> noCycle(5, edges);
+	for (size_t threads : { 1, 2 }) {
+		DynamicArray<int32_t> distances = bellmanFord(noCycle, 0, threads);
+		EXPECT_EQ(distances[1], 5);
+		EXPECT_EQ(distances[3], std::numeric_limits<int32_t>::max());
+		EXPECT_THROW(bellmanFord(noCycle, 3, threads), NegativeCycleError);
+	}
+	
+	edges.push_back(Graph_Edge<int32_t>{1, 2, 2});
+	edges.push_back(Graph_Edge<int32_t>{2, 1, -3});
+	Graph<int32_t> cycle(5, edges);
+	for (size_t threads : { 1, 2, 4 }) {
+		EXPECT_THROW(bellmanFord(cycle, 0, threads), NegativeCycleError);
+	}
+}
@@ -0,0 +1,163 @@
+/**
+ * Fundamentals :: Tests :: Hash Stats Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the stats that HashMap and HashSet report when they are
+ * built with FUNDAMENTALS_HASH_STATS set to 1.
+ *
+ * The setting changes what a HashMap holds, so these tests are built into
+ * their own executable with the setting on, rather than alongside the other
+ * tests, which are built with it off.
+ */
+
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include "HashMap.hpp"
+#include "HashSet.hpp"
+
+static_assert(FUNDAMENTALS_HASH_STATS, "These tests need FUNDAMENTALS_HASH_STATS set to 1");
+
+/**
+ * A hash that is used as it is, so a test can pick where each key's probe
+ * sequence starts.
+ */
+struct IdentityHash {
+	typedef void is_avalanching;
+	
+	size_t operator()(size_t key) const {
+		return key;
+	}
+};
+
+/**
+ * Checks that a histogram of probe distances adds up to the number of keys,
+ * and agrees with the average and maximum.
+ * @param	stats	The stats to check
+ */
+void checkHistogram(const HashStats& stats) {
+	size_t keys = 0;
+	size_t total = 0;
+	size_t longest = 0;
+	for (size_t i = 0; i < HASHSTATS_HISTOGRAM_SIZE; ++i) {
+		keys += stats.probeHistogram[i];
+		total += i * stats.probeHistogram[i];
+		if (stats.probeHistogram[i] != 0) {
+			longest = i;
+		}
+	}
+	EXPECT_EQ(keys, stats.size);
+	// The last bucket holds every longer distance, so only shorter ones can
+	// be checked exactly
+	if (stats.maxProbeDistance < HASHSTATS_HISTOGRAM_SIZE - 1) {
+		EXPECT_EQ(longest, stats.maxProbeDistance);
+		EXPECT_DOUBLE_EQ(stats.averageProbeDistance, stats.size == 0 ? 0.0 : static_cast<double>(total) / stats.size);
+	}
+}
+
+TEST(HashMapStatsTest, CountsKeysTombstonesAndRehashes) {
+	HashMap<int, int> map;
+	HashStats stats = map.stats();
+	EXPECT_EQ(stats.size, 0u);
+	EXPECT_EQ(stats.capacity, static_cast<size_t>(HASHMAP_DEFAULT_CAPACITY));
+	EXPECT_EQ(stats.tombstones, 0u);
+	EXPECT_EQ(stats.rehashCount, 0u);
+	EXPECT_DOUBLE_EQ(stats.averageProbeDistance, 0.0);
+	
+	// Growing from the default capacity doubles it each time
+	for (int i = 0; i < 1000; ++i) {
+		map.insert(i, i);
+	}
+	stats = map.stats();
+	size_t doublings = 0;
+	for (size_t capacity = HASHMAP_DEFAULT_CAPACITY; capacity < map.capacity(); capacity *= HASHMAP_GROWTH_FACTOR) {
+		++doublings;
+	}
+	EXPECT_EQ(stats.size, 1000u);
+	EXPECT_EQ(stats.capacity, map.capacity());
+	EXPECT_EQ(stats.rehashCount, doublings);
+	EXPECT_GE(stats.rehashTime.count(), 0);
+	checkHistogram(stats);
+	
+	for (int i = 0; i < 100; ++i) {
+		map.remove(i);
+	}
+	stats = map.stats();
+	EXPECT_EQ(stats.size, 900u);
+	EXPECT_EQ(stats.tombstones, 100u);
+	EXPECT_DOUBLE_EQ(stats.loadFactor, 1000.0 / map.capacity());
+	checkHistogram(stats);
+	
+	// A rehash clears out the tombstones and is counted
+	map.shrink_to_fit();
+	stats = map.stats();
+	EXPECT_EQ(stats.tombstones, 0u);
+	EXPECT_EQ(stats.rehashCount, doublings + 1);
+	EXPECT_DOUBLE_EQ(stats.loadFactor, 900.0 / map.capacity());
+	checkHistogram(stats);
+}
+
+TEST(HashMapStatsTest, ProbeDistances) {
+	// Keys that each start at a different slot are all where they start
+	HashMap<size_t, int, PerturbProbe, IdentityHash> spread;
+	spread.reserve(40);
+	for (size_t i = 0; i < 40; ++i) {
+		spread.insert(i, 0);
+	}
+	HashStats stats = spread.stats();
+	EXPECT_EQ(stats.probeHistogram[0], 40u);
+	EXPECT_EQ(stats.maxProbeDistance, 0u);
+	EXPECT_DOUBLE_EQ(stats.averageProbeDistance, 0.0);
+	
+	// Keys that all start at the same slot have to go further along, and
+	// only the first is where it starts
+	HashMap<size_t, int, PerturbProbe, IdentityHash> clustered;
+	clustered.reserve(40);
+	for (size_t i = 0; i < 40; ++i) {
+		clustered.insert(i << 20, 0);
+	}
+	stats = clustered.stats();
+	EXPECT_EQ(stats.probeHistogram[0], 1u);
+	EXPECT_GE(stats.maxProbeDistance, 1u);
+	EXPECT_GT(stats.averageProbeDistance, 0.0);
+	checkHistogram(stats);
+	
+	HashMap<size_t, int, SimdProbe, IdentityHash> groups;
+	for (size_t i = 0; i < 500; ++i) {
+		groups.insert(i * 7919, 0);
+	}
+	checkHistogram(groups.stats());
+}
+
+TEST(HashSetStatsTest, CountsElementsTombstonesAndRehashes) {
+	HashSet<int> set;
+	EXPECT_EQ(set.stats().rehashCount, 0u);
+	
+	for (int i = 0; i < 1000; ++i) {
+		set.insert(i);
+	}
+	HashStats stats = set.stats();
+	size_t doublings = 0;
+	for (size_t capacity = HASHSET_DEFAULT_CAPACITY; capacity < set.capacity(); capacity *= HASHSET_GROWTH_FACTOR) {
+		++doublings;
+	}
+	EXPECT_EQ(stats.size, 1000u);
+	EXPECT_EQ(stats.capacity, set.capacity());
+	EXPECT_EQ(stats.rehashCount, doublings);
+	checkHistogram(stats);
+	
+	for (int i = 0; i < 100; ++i) {
+		set.remove(i);
+	}
+	stats = set.stats();
+	EXPECT_EQ(stats.size, 900u);
+	EXPECT_EQ(stats.tombstones, 100u);
+	EXPECT_DOUBLE_EQ(stats.loadFactor, 1000.0 / set.capacity());
+	
+	set.shrink_to_fit();
+	stats = set.stats();
+	EXPECT_EQ(stats.tombstones, 0u);
+	EXPECT_EQ(stats.rehashCount, doublings + 1);
+	checkHistogram(stats);
+}
@@ -0,0 +1,1094 @@
+/**
+ * Fundamentals :: Tests :: Hash Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the hash tables: HashMap, HashSet, IncrementalHashMap and
+ * RobinHoodHashMap.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "HashMap.hpp"
+#include "HashSet.hpp"
+#include "IncrementalHashMap.hpp"
+#include "RobinHoodHashMap.hpp"
+#include "TestAllocators.hpp"
+
+/**
+ * A key type with no default hash, hashed by a plain function the way every
+ * key was before the hash function became a template parameter.
+ */
+struct PointKey {
+	int x;
+	int y;
+	
+	bool operator==(const PointKey& other) const {
+		return x == other.x && y == other.y;
+	}
+	bool operator!=(const PointKey& other) const {
+		return !(*this == other);
+	}
+};
+size_t hashPoint(const PointKey& point) {
+	return static_cast<size_t>(point.x) * 31 + static_cast<size_t>(point.y);
+}
+
+/**
+ * A hash that is used as it is, so that a test can pick which group a key
+ * starts probing at and which control byte it gets. SimdProbe takes the low
+ * seven bits of a hash as the control byte and the rest as the position.
+ */
+struct SlotHash {
+	typedef void is_avalanching;
+	
+	size_t operator()(int key) const {
+		return static_cast<size_t>(key);
+	}
+};
+int slotKey(int position, int fingerprint) {
+	return (position << 7) | fingerprint;
+}
+
+/**
+ * A slot for driving a probing policy directly, without a map around it.
+ */
+struct ProbeSlot {
+	bool full;
+	int key;
+	
+	bool empty() const {
+		return !full;
+	}
+	bool keyEqual(int other, size_t) const {
+		return full && key == other;
+	}
+};
+size_t probeInsert(SimdProbe& probe, std::vector<ProbeSlot>& slots, int key) {
+	size_t index = probe.findFree(slots.data(), slots.size(), static_cast<size_t>(key));
+	slots[index] = ProbeSlot{ true, key };
+	probe.markFull(index, static_cast<size_t>(key));
+	return index;
+}
+void probeErase(SimdProbe& probe, std::vector<ProbeSlot>& slots, size_t index) {
+	slots[index].full = false;
+	probe.markCleared(index);
+}
+
+/**
+ * A value whose move constructor isn't noexcept, and whose copy constructor
+ * can be made to throw after a number of copies.
+ */
+struct FragileValue {
+	static int copiesLeft;
+	static int moves;
+	
+	int value;
+	
+	FragileValue(int v)
+		: value(v)
+	{}
+	FragileValue(const FragileValue& other)
+		: value(other.value)
+	{
+		if (copiesLeft > 0 && --copiesLeft == 0) {
+			throw std::runtime_error("copy failed");
+		}
+	}
+	FragileValue(FragileValue&& other)
+		: value(other.value)
+	{
+		++moves;
+		other.value = -1;
+	}
+	FragileValue& operator=(const FragileValue& other) = default;
+	
+	bool operator==(const FragileValue& other) const {
+		return value == other.value;
+	}
+};
+int FragileValue::copiesLeft = 0;
+int FragileValue::moves = 0;
+struct FragileHash {
+	size_t operator()(const FragileValue& fragile) const {
+		return static_cast<size_t>(fragile.value);
+	}
+};
+
+/**
+ * A key that counts how many are made, with a transparent hash, so a test can
+ * check that lookups by name don't make one.
+ */
+struct NamedKey {
+	static int made;
+	
+	std::string name;
+	
+	explicit NamedKey(std::string_view n)
+		: name(n)
+	{
+		++made;
+	}
+	
+	bool operator==(const NamedKey& other) const {
+		return name == other.name;
+	}
+};
+int NamedKey::made = 0;
+bool operator==(std::string_view name, const NamedKey& key) {
+	return name == key.name;
+}
+struct NamedKeyHash {
+	typedef void is_transparent;
+	
+	size_t operator()(const NamedKey& key) const {
+		return std::hash<std::string_view>()(key.name);
+	}
+	size_t operator()(std::string_view name) const {
+		return std::hash<std::string_view>()(name);
+	}
+};
+
+TEST(HashMapTest, DestroysThroughAllocator) {
+	AllocatorCounts counts;
+	{
+		typedef CountingAllocator<std::pair<const std::string, std::string>> Allocator;
+		HashMap<std::string, std::string, PerturbProbe, DefaultHash<std::string>, Allocator> map((Allocator(&counts)));
+		for (int i = 0; i < 100; ++i) {
+			map.insert(std::to_string(i), std::to_string(i));
+		}
+		for (int i = 0; i < 100; i += 2) {
+			map.remove(std::to_string(i));
+		}
+		
+		HashMap<std::string, std::string, PerturbProbe, DefaultHash<std::string>, Allocator> copy(map);
+		EXPECT_EQ(copy.size(), 50u);
+	}
+	
+	EXPECT_GT(counts.constructs, 0u);
+	EXPECT_EQ(counts.constructs, counts.destroys);
+}
+
+TEST(HashSetTest, DestroysThroughAllocator) {
+	AllocatorCounts counts;
+	{
+		typedef CountingAllocator<std::string> Allocator;
+		HashSet<std::string, DefaultHash<std::string>, Allocator> set((Allocator(&counts)));
+		for (int i = 0; i < 100; ++i) {
+			set.insert(std::to_string(i));
+		}
+		for (int i = 0; i < 100; i += 2) {
+			set.remove(std::to_string(i));
+		}
+	}
+	
+	EXPECT_GT(counts.constructs, 0u);
+	EXPECT_EQ(counts.constructs, counts.destroys);
+}
+
+TEST(RobinHoodHashMapTest, DestroysThroughAllocator) {
+	AllocatorCounts counts;
+	{
+		typedef CountingAllocator<std::pair<const std::string, std::string>> Allocator;
+		RobinHoodHashMap<std::string, std::string, DefaultHash<std::string>, Allocator> map((Allocator(&counts)));
+		for (int i = 0; i < 100; ++i) {
+			map.insert(std::to_string(i), std::to_string(i));
+		}
+		for (int i = 0; i < 100; i += 2) {
+			map.remove(std::to_string(i));
+		}
+	}
+	
+	EXPECT_GT(counts.constructs, 0u);
+	EXPECT_EQ(counts.constructs, counts.destroys);
+}
+
+TEST(HashMapTest, MoveAssignTakesPropagatingAllocator) {
+	AllocatorCounts counts;
+	{
+		typedef PropagatingAllocator<std::pair<const std::string, std::string>> Allocator;
+		HashMap<std::string, std::string, PerturbProbe, DefaultHash<std::string>, Allocator> map((Allocator(&counts, 1)));
+		HashMap<std::string, std::string, PerturbProbe, DefaultHash<std::string>, Allocator> other((Allocator(&counts, 2)));
+		map.insert("kept", "no");
+		for (int i = 0; i < 100; ++i) {
+			other.insert(std::to_string(i), std::to_string(i));
+		}
+		
+		size_t constructs = counts.constructs;
+		map = std::move(other);
+		// Only the empty table left in other is constructed, not the entries
+		EXPECT_EQ(counts.constructs, constructs + HASHMAP_DEFAULT_CAPACITY);
+		EXPECT_EQ(map.get_allocator().id(), 2);
+		EXPECT_EQ(map.size(), 100u);
+		EXPECT_FALSE(map.hasKey("kept"));
+		EXPECT_EQ(map.getValue("42"), "42");
+	}
+	
+	EXPECT_EQ(counts.constructs, counts.destroys);
+	EXPECT_EQ(counts.allocations, counts.deallocations);
+}
+
+/**
+ * Checks that a map that was moved from is empty and can still be used.
+ * @param	map	The moved-from map
+ */
+template <typename Map>
+void expectUsableAfterMove(Map& map) {
+	EXPECT_EQ(map.size(), 0u);
+	EXPECT_FALSE(map.hasKey(1));
+	EXPECT_EQ(map.find(1), nullptr);
+	map.unset(1);
+	
+	for (int i = 0; i < 100; ++i) {
+		map.insert(i, i);
+	}
+	EXPECT_EQ(map.size(), 100u);
+	EXPECT_EQ(map.getValue(42), 42);
+}
+
+TEST(HashMapTest, MovedFromMapIsUsable) {
+	HashMap<int, int> perturb;
+	HashMap<int, int, SimdProbe> simd;
+	perturb.insert(1, 1);
+	simd.insert(1, 1);
+	
+	HashMap<int, int> perturbTo(std::move(perturb));
+	HashMap<int, int, SimdProbe> simdTo(std::move(simd));
+	EXPECT_TRUE(perturbTo.hasKey(1));
+	EXPECT_TRUE(simdTo.hasKey(1));
+	expectUsableAfterMove(perturb);
+	expectUsableAfterMove(simd);
+	
+	perturbTo = std::move(perturb);
+	EXPECT_EQ(perturbTo.size(), 100u);
+}
+
+TEST(HashMapTest, MovedFromByPropagatingAssignmentIsUsable) {
+	AllocatorCounts counts;
+	typedef PropagatingAllocator<std::pair<const int, int>> Allocator;
+	HashMap<int, int, PerturbProbe, DefaultHash<int>, Allocator> map((Allocator(&counts, 1)));
+	HashMap<int, int, PerturbProbe, DefaultHash<int>, Allocator> other((Allocator(&counts, 2)));
+	other.insert(1, 1);
+	
+	map = std::move(other);
+	EXPECT_TRUE(map.hasKey(1));
+	expectUsableAfterMove(other);
+}
+
+TEST(HashSetTest, MovedFromSetIsUsable) {
+	HashSet<int> set;
+	set.insert(1);
+	
+	HashSet<int> to(std::move(set));
+	EXPECT_TRUE(to.contains(1));
+	EXPECT_EQ(set.size(), 0u);
+	EXPECT_FALSE(set.contains(1));
+	for (int i = 0; i < 100; ++i) {
+		set.insert(i);
+	}
+	EXPECT_TRUE(set.contains(42));
+}
+
+TEST(RobinHoodHashMapTest, MovedFromMapIsUsable) {
+	RobinHoodHashMap<int, int> map;
+	map.insert(1, 1);
+	
+	RobinHoodHashMap<int, int> to(std::move(map));
+	EXPECT_TRUE(to.hasKey(1));
+	expectUsableAfterMove(map);
+}
+
+TEST(IncrementalHashMapTest, MovedFromMapIsUsable) {
+	IncrementalHashMap<int, int> map;
+	map.insert(1, 1);
+	
+	IncrementalHashMap<int, int> to(std::move(map));
+	EXPECT_TRUE(to.hasKey(1));
+	EXPECT_EQ(map.size(), 0u);
+	EXPECT_FALSE(map.hasKey(1));
+	for (int i = 0; i < 100; ++i) {
+		map.insert(i, i);
+	}
+	EXPECT_EQ(map.getValue(42), 42);
+	
+	// Moving in the middle of a resize leaves the source with none
+	while (!map.migrating()) {
+		map.insert(static_cast<int>(map.size()), 0);
+	}
+	IncrementalHashMap<int, int> moved(std::move(map));
+	EXPECT_TRUE(moved.migrating());
+	EXPECT_FALSE(map.migrating());
+	EXPECT_FALSE(map.hasKey(1));
+	map.set(1, 1);
+	EXPECT_EQ(map.getValue(1), 1);
+	
+	to = std::move(moved);
+	EXPECT_TRUE(to.migrating());
+	EXPECT_FALSE(moved.migrating());
+	EXPECT_EQ(moved.size(), 0u);
+	EXPECT_FALSE(moved.hasKey(1));
+	moved.set(1, 1);
+	EXPECT_EQ(moved.size(), 1u);
+}
+
+TEST(IncrementalHashMapTest, MatchesHashMap) {
+	IncrementalHashMap<int, int> map;
+	HashMap<int, int> reference;
+	std::mt19937 random(3);
+	
+	// Enough keys that the map resizes several times, with removals mixed in
+	for (int i = 0; i < 20000; ++i) {
+		int key = static_cast<int>(random() % 4000);
+		switch (random() % 6) {
+			case 0:
+				if (reference.hasKey(key)) {
+					EXPECT_THROW(map.insert(key, i), DuplicateKeyError);
+				}
+				else {
+					map.insert(key, i);
+					reference.insert(key, i);
+				}
+				break;
+			case 1:
+				if (reference.hasKey(key)) {
+					map.remove(key);
+					reference.remove(key);
+				}
+				else {
+					EXPECT_THROW(map.remove(key), MissingKeyError);
+				}
+				break;
+			case 2:
+				map.set(key, i);
+				reference.set(key, i);
+				break;
+			case 3:
+				map.unset(key);
+				reference.unset(key);
+				break;
+			case 4:
+				map[key] += 1;
+				reference[key] += 1;
+				break;
+			default:
+				EXPECT_EQ(map.hasKey(key), reference.hasKey(key));
+				if (reference.hasKey(key)) {
+					EXPECT_EQ(map.getValue(key), reference.getValue(key));
+				}
+				else {
+					EXPECT_THROW(map.getValue(key), MissingKeyError);
+				}
+		}
+		ASSERT_EQ(map.size(), reference.size());
+	}
+	
+	for (int key = 0; key < 4000; ++key) {
+		EXPECT_EQ(map.hasKey(key), reference.hasKey(key));
+	}
+}
+
+TEST(IncrementalHashMapTest, LookupsAndErasesDuringResize) {
+	IncrementalHashMap<int, int> map;
+	int count = 0;
+	while (!map.migrating()) {
+		map.insert(count, count * 10);
+		++count;
+	}
+	
+	// Keys are spread over both tables until the move finishes, and every
+	// change moves a few more of them across
+	int removed = 0;
+	for (int key = 0; map.migrating(); key += 2) {
+		ASSERT_LT(key, count);
+		EXPECT_TRUE(map.hasKey(key + 1));
+		EXPECT_EQ(map.getValue(key + 1), (key + 1) * 10);
+		const IncrementalHashMap<int, int>& view = map;
+		EXPECT_EQ(view.getValue(key), key * 10);
+		
+		if (key % 4 == 0) {
+			map.remove(key);
+		}
+		else {
+			map.unset(key);
+		}
+		++removed;
+		EXPECT_FALSE(map.hasKey(key));
+		EXPECT_THROW(map.remove(key), MissingKeyError);
+	}
+	
+	EXPECT_EQ(map.size(), static_cast<size_t>(count - removed));
+	for (int key = 0; key < count; ++key) {
+		bool erased = key % 2 == 0 && key < removed * 2;
+		EXPECT_EQ(map.hasKey(key), !erased);
+		if (!erased) {
+			EXPECT_EQ(map.getValue(key), key * 10);
+		}
+	}
+}
+
+TEST(IncrementalHashMapTest, FinishMigration) {
+	IncrementalHashMap<int, int> map;
+	int count = 0;
+	while (!map.migrating()) {
+		map.insert(count, count);
+		++count;
+	}
+	
+	map.finishMigration();
+	EXPECT_FALSE(map.migrating());
+	EXPECT_EQ(map.size(), static_cast<size_t>(count));
+	for (int key = 0; key < count; ++key) {
+		EXPECT_EQ(map.getValue(key), key);
+	}
+}
+
+TEST(HashMapTest, MaxLoadFactor) {
+	HashMap<int, int, SimdProbe> map;
+	EXPECT_FLOAT_EQ(map.max_load_factor(), HASHMAP_MAX_LOAD_FACTOR);
+	
+	map.max_load_factor(0.875f);
+	map.reserve(896);
+	EXPECT_EQ(map.capacity(), 1024u);
+	for (int i = 0; i < 896; ++i) {
+		map.insert(i, i);
+	}
+	EXPECT_EQ(map.capacity(), 1024u);
+	
+	// Lowering the maximum rehashes right away
+	map.max_load_factor(0.5f);
+	EXPECT_EQ(map.capacity(), 2048u);
+	for (int i = 0; i < 896; ++i) {
+		EXPECT_EQ(map.getValue(i), i);
+	}
+	
+	// A copy keeps the maximum
+	HashMap<int, int, SimdProbe> copy(map);
+	EXPECT_FLOAT_EQ(copy.max_load_factor(), 0.5f);
+	
+	EXPECT_THROW(map.max_load_factor(1.0f), InvalidLoadFactorError);
+	EXPECT_THROW(map.max_load_factor(0.0f), InvalidLoadFactorError);
+}
+
+TEST(HashMapTest, FunctionPointerForKeyWithoutDefaultHash) {
+	HashMap<PointKey, int> map(&hashPoint);
+	HashMap<PointKey, int> sized(&hashPoint, 100);
+	for (int i = 0; i < 100; ++i) {
+		map.insert(PointKey{ i, -i }, i);
+	}
+	EXPECT_EQ(map.size(), 100u);
+	EXPECT_EQ(map.getValue(PointKey{ 42, -42 }), 42);
+	EXPECT_FALSE(map.hasKey(PointKey{ 42, 42 }));
+	
+	EXPECT_THROW((HashMap<PointKey, int>()), MissingHashFunctionError);
+}
+
+TEST(HashSetTest, FunctionPointerForKeyWithoutDefaultHash) {
+	HashSet<PointKey> set(&hashPoint);
+	set.insert(PointKey{ 1, 2 });
+	EXPECT_TRUE(set.contains(PointKey{ 1, 2 }));
+	EXPECT_FALSE(set.contains(PointKey{ 2, 1 }));
+	
+	EXPECT_THROW((HashSet<PointKey>()), MissingHashFunctionError);
+}
+
+/**
+ * Hashes that count their calls, for keys that also have a default hash.
+ */
+size_t intHashCalls = 0;
+size_t hashIntByHand(const int& value) {
+	++intHashCalls;
+	return static_cast<size_t>(value) * 7;
+}
+size_t stringHashCalls = 0;
+size_t hashStringByHand(const std::string& value) {
+	++stringHashCalls;
+	return value.size();
+}
+
+TEST(HashMapTest, FunctionPointerForKeyWithDefaultHash) {
+	HashMap<int, int> map(&hashIntByHand);
+	HashMap<int, int> sized(&hashIntByHand, 100);
+	for (int i = 0; i < 100; ++i) {
+		map.insert(i, i);
+	}
+	EXPECT_GE(intHashCalls, 100u);
+	EXPECT_EQ(map.getValue(42), 42);
+	EXPECT_FALSE(map.hasKey(100));
+	
+	// Lookups with another type go through the function too
+	HashMap<std::string, int> strings(&hashStringByHand);
+	strings.insert("one", 1);
+	strings.insert("three", 3);
+	size_t calls = stringHashCalls;
+	EXPECT_EQ(*strings.find(std::string_view("three")), 3);
+	EXPECT_TRUE(strings.hasKey("one"));
+	EXPECT_EQ(stringHashCalls, calls + 2);
+	
+	// The old default still works when given as it was
+	HashMap<int, int> fromDefault(DefaultHash<int>(), 100);
+	fromDefault.insert(1, 1);
+	EXPECT_EQ(fromDefault.getValue(1), 1);
+}
+
+TEST(HashSetTest, FunctionPointerForKeyWithDefaultHash) {
+	HashSet<std::string> set(&hashStringByHand);
+	size_t calls = stringHashCalls;
+	set.insert("value");
+	EXPECT_TRUE(set.contains("value"));
+	EXPECT_FALSE(set.contains("other"));
+	EXPECT_EQ(stringHashCalls, calls + 3);
+}
+
+TEST(SimdProbeTest, MirroredControlBytes) {
+	std::vector<ProbeSlot> slots(32, ProbeSlot{ false, 0 });
+	SimdProbe probe;
+	probe.resize(slots.size());
+	
+	// The group starting at slot 28 runs past the end of the table, and its
+	// last bytes are the copies of slots 0 to 11
+	const size_t expected[] = { 28, 29, 30, 31, 0, 1 };
+	for (int i = 0; i < 6; ++i) {
+		EXPECT_EQ(probeInsert(probe, slots, slotKey(28, i + 1)), expected[i]);
+	}
+	for (int i = 0; i < 6; ++i) {
+		EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(28, i + 1), slotKey(28, i + 1)), expected[i]);
+	}
+	
+	// Clearing slot 0 must mark its copy deleted rather than empty, or the
+	// search for the key in slot 1 would stop there
+	probeErase(probe, slots, 0);
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(28, 6), slotKey(28, 6)), 1u);
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(28, 5), slotKey(28, 5)), 0u);
+	
+	// A key that starts at slot 0 sees the same control bytes as the copies
+	EXPECT_EQ(probeInsert(probe, slots, slotKey(0, 9)), 0u);
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(28, 6), slotKey(28, 6)), 1u);
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(0, 9), slotKey(0, 9)), 0u);
+}
+
+TEST(SimdProbeTest, FullGroupWrapsToNextGroup) {
+	std::vector<ProbeSlot> slots(64, ProbeSlot{ false, 0 });
+	SimdProbe probe;
+	probe.resize(slots.size());
+	
+	// Every key has the same control byte, so only the key comparisons tell
+	// them apart. The first sixteen fill the group at slot 56, which wraps
+	// around to slot 7, and the next goes to the group one stride on.
+	std::vector<size_t> indices;
+	for (int i = 0; i < 17; ++i) {
+		indices.push_back(probeInsert(probe, slots, slotKey(56 + 64 * i, 3)));
+	}
+	for (int i = 0; i < 16; ++i) {
+		EXPECT_EQ(indices[i], static_cast<size_t>((56 + i) % 64));
+		EXPECT_EQ(probe.probeLength(slots.size(), indices[i], slotKey(56 + 64 * i, 3)), 0u);
+	}
+	EXPECT_EQ(indices[16], 8u);
+	EXPECT_EQ(probe.probeLength(slots.size(), 8, slotKey(56 + 64 * 16, 3)), 1u);
+	
+	for (int i = 0; i < 17; ++i) {
+		EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(56 + 64 * i, 3), slotKey(56 + 64 * i, 3)), indices[i]);
+	}
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(56 + 64 * 17, 3), slotKey(56 + 64 * 17, 3)), 9u);
+	
+	// A deleted slot in the full group is reused, but doesn't end the search
+	// for the key that spilled into the next group
+	probeErase(probe, slots, indices[10]);
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(56 + 64 * 16, 3), slotKey(56 + 64 * 16, 3)), 8u);
+	EXPECT_EQ(probe.find(slots.data(), slots.size(), slotKey(56 + 64 * 17, 3), slotKey(56 + 64 * 17, 3)), indices[10]);
+	EXPECT_EQ(probeInsert(probe, slots, slotKey(56 + 64 * 17, 3)), indices[10]);
+}
+
+TEST(SimdProbeTest, MapAcrossGroupBoundaries) {
+	HashMap<int, int, SimdProbe, SlotHash> map;
+	map.reserve(40);
+	ASSERT_EQ(map.capacity(), 64u);
+	
+	// Thirty keys starting near the end of the table, with only four
+	// different control bytes between them, fill two groups and spill into
+	// a third
+	std::vector<int> keys;
+	for (int i = 0; i < 30; ++i) {
+		keys.push_back(slotKey(60 + 64 * i, i % 4));
+		map.insert(keys.back(), i);
+	}
+	for (int i = 0; i < 30; ++i) {
+		EXPECT_EQ(map.getValue(keys[i]), i);
+	}
+	
+	for (int i = 0; i < 30; i += 3) {
+		map.remove(keys[i]);
+	}
+	for (int i = 0; i < 30; ++i) {
+		EXPECT_EQ(map.hasKey(keys[i]), i % 3 != 0);
+	}
+	
+	// Put the keys back, along with new ones in the slots they left, without
+	// the table growing
+	for (int i = 0; i < 30; i += 3) {
+		map.insert(keys[i], -i);
+		map.insert(slotKey(60 + 64 * (i + 30), i % 4), i);
+	}
+	EXPECT_EQ(map.capacity(), 64u);
+	EXPECT_EQ(map.size(), 40u);
+	for (int i = 0; i < 30; ++i) {
+		EXPECT_EQ(map.getValue(keys[i]), i % 3 == 0 ? -i : i);
+	}
+	for (int i = 0; i < 30; i += 3) {
+		EXPECT_EQ(map.getValue(slotKey(60 + 64 * (i + 30), i % 4)), i);
+	}
+}
+
+TEST(HashMapTest, FailedRehashKeepsValues) {
+	HashMap<int, FragileValue> map;
+	int count = 0;
+	while (map.size() < map.capacity() * HASHMAP_MAX_LOAD_FACTOR) {
+		map.insert(count, FragileValue(count));
+		++count;
+	}
+	
+	// The values can't be moved without risk, so the rehash copies them, and
+	// the third copy fails
+	FragileValue::moves = 0;
+	FragileValue::copiesLeft = 3;
+	size_t capacity = map.capacity();
+	EXPECT_THROW(map.insert(count, FragileValue(count)), std::runtime_error);
+	EXPECT_EQ(FragileValue::moves, 0);
+	EXPECT_EQ(map.capacity(), capacity);
+	EXPECT_EQ(map.size(), static_cast<size_t>(count));
+	for (int i = 0; i < count; ++i) {
+		EXPECT_EQ(map.getValue(i).value, i);
+	}
+	
+	FragileValue::copiesLeft = 0;
+	for (int i = count; i < 100; ++i) {
+		map.insert(i, FragileValue(i));
+	}
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_EQ(map.getValue(i).value, i);
+	}
+}
+
+TEST(HashSetTest, FailedRehashKeepsElements) {
+	HashSet<FragileValue, FragileHash> set;
+	int count = 0;
+	while (set.size() < set.capacity() * HASHSET_MAX_LOAD_FACTOR) {
+		set.insert(FragileValue(count));
+		++count;
+	}
+	
+	FragileValue::moves = 0;
+	FragileValue::copiesLeft = 3;
+	EXPECT_THROW(set.insert(FragileValue(count)), std::runtime_error);
+	EXPECT_EQ(FragileValue::moves, 0);
+	EXPECT_EQ(set.size(), static_cast<size_t>(count));
+	for (int i = 0; i < count; ++i) {
+		EXPECT_TRUE(set.contains(FragileValue(i)));
+	}
+	
+	FragileValue::copiesLeft = 0;
+	for (int i = count; i < 100; ++i) {
+		set.insert(FragileValue(i));
+	}
+	EXPECT_EQ(set.size(), 100u);
+}
+
+TEST(HashMapTest, ChurnReusesTombstones) {
+	// A sliding window of keys leaves a tombstone behind for every key it
+	// drops, which would eventually fill every slot that has never been used.
+	// The table can grow once, if it first crowds with fewer tombstones than
+	// keys, but from then on it is rehashed at the same size.
+	HashMap<int, int> map;
+	for (int i = 0; i < 100; ++i) {
+		map.insert(i, i);
+	}
+	size_t capacity = HASHMAP_GROWTH_FACTOR * map.capacity();
+	for (int i = 0; i < 100000; ++i) {
+		map.remove(i);
+		map.insert(i + 100, i);
+		ASSERT_LE(map.capacity(), capacity) << "after " << i << " steps";
+	}
+	
+	// Lookups for missing keys still find an unused slot to stop at
+	EXPECT_EQ(map.size(), 100u);
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_FALSE(map.hasKey(-i));
+	}
+	for (int i = 100000; i < 100100; ++i) {
+		EXPECT_EQ(map.getValue(i), i - 100);
+	}
+	
+	IncrementalHashMap<int, int> incremental;
+	for (int i = 0; i < 100; ++i) {
+		incremental.insert(i, i);
+	}
+	for (int i = 0; i < 100000; ++i) {
+		incremental.remove(i);
+		incremental.insert(i + 100, i);
+	}
+	EXPECT_EQ(incremental.size(), 100u);
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_FALSE(incremental.hasKey(-i));
+	}
+	for (int i = 100000; i < 100100; ++i) {
+		EXPECT_EQ(incremental.getValue(i), i - 100);
+	}
+}
+
+TEST(HashSetTest, ChurnReusesTombstones) {
+	HashSet<int> set;
+	for (int i = 0; i < 100; ++i) {
+		set.insert(i);
+	}
+	size_t capacity = HASHSET_GROWTH_FACTOR * set.capacity();
+	for (int i = 0; i < 100000; ++i) {
+		set.remove(i);
+		set.insert(i + 100);
+		ASSERT_LE(set.capacity(), capacity) << "after " << i << " steps";
+	}
+	
+	EXPECT_EQ(set.size(), 100u);
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_FALSE(set.contains(-i));
+	}
+}
+
+TEST(HashMapTest, ReserveAndShrinkToFit) {
+	HashMap<int, int> map;
+	map.reserve(1000);
+	size_t capacity = map.capacity();
+	EXPECT_GE(capacity * HASHMAP_MAX_LOAD_FACTOR, 1000);
+	for (int i = 0; i < 1000; ++i) {
+		map.insert(i, i);
+	}
+	EXPECT_EQ(map.capacity(), capacity);
+	
+	// Reserving less than there is room for never shrinks the table
+	map.reserve(10);
+	EXPECT_EQ(map.capacity(), capacity);
+	
+	for (int i = 10; i < 1000; ++i) {
+		map.remove(i);
+	}
+	EXPECT_EQ(map.capacity(), capacity);
+	map.shrink_to_fit();
+	EXPECT_LT(map.capacity(), capacity);
+	EXPECT_GE(map.capacity() * HASHMAP_MAX_LOAD_FACTOR, 10);
+	EXPECT_EQ(map.size(), 10u);
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(map.getValue(i), i);
+	}
+	EXPECT_FALSE(map.hasKey(10));
+	
+	// An empty map shrinks too, and still works afterwards
+	HashMap<int, int> empty;
+	empty.reserve(5000);
+	empty.shrink_to_fit();
+	EXPECT_LT(empty.capacity(), 5000u);
+	empty.insert(1, 1);
+	EXPECT_EQ(empty.getValue(1), 1);
+}
+
+TEST(HashSetTest, ReserveAndShrinkToFit) {
+	HashSet<int> set;
+	set.reserve(1000);
+	size_t capacity = set.capacity();
+	EXPECT_GE(capacity * HASHSET_MAX_LOAD_FACTOR, 1000);
+	for (int i = 0; i < 1000; ++i) {
+		set.insert(i);
+	}
+	EXPECT_EQ(set.capacity(), capacity);
+	set.reserve(10);
+	EXPECT_EQ(set.capacity(), capacity);
+	
+	for (int i = 10; i < 1000; ++i) {
+		set.remove(i);
+	}
+	set.shrink_to_fit();
+	EXPECT_LT(set.capacity(), capacity);
+	EXPECT_EQ(set.size(), 10u);
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_TRUE(set.contains(i));
+	}
+	EXPECT_FALSE(set.contains(10));
+}
+
+TEST(HashMapTest, TransparentLookups) {
+	HashMap<std::string, int> map;
+	for (int i = 0; i < 100; ++i) {
+		map.insert("key" + std::to_string(i), i);
+	}
+	
+	// String views and C strings find std::string keys
+	std::string buffer = "key42 and more";
+	std::string_view view(buffer.data(), 5);
+	EXPECT_TRUE(map.hasKey(view));
+	EXPECT_EQ(map.getValue(view), 42);
+	ASSERT_NE(map.find(view), nullptr);
+	EXPECT_EQ(*map.find(view), 42);
+	EXPECT_EQ(map.getValue("key7"), 7);
+	int value = 0;
+	EXPECT_TRUE(map.try_get("key99", value));
+	EXPECT_EQ(value, 99);
+	
+	EXPECT_FALSE(map.hasKey(std::string_view(buffer.data(), 6)));
+	EXPECT_EQ(map.find("key100"), nullptr);
+	EXPECT_FALSE(map.try_get("key100", value));
+	EXPECT_THROW(map.getValue("key100"), MissingKeyError);
+	
+	// Lookups by name never make a key
+	HashMap<NamedKey, int, PerturbProbe, NamedKeyHash> named;
+	named.insert(NamedKey("a"), 1);
+	named.insert(NamedKey("b"), 2);
+	int made = NamedKey::made;
+	EXPECT_EQ(named.getValue(std::string_view("b")), 2);
+	EXPECT_FALSE(named.hasKey(std::string_view("c")));
+	const HashMap<NamedKey, int, PerturbProbe, NamedKeyHash>& constNamed = named;
+	ASSERT_NE(constNamed.find(std::string_view("a")), nullptr);
+	EXPECT_EQ(*constNamed.find(std::string_view("a")), 1);
+	EXPECT_EQ(NamedKey::made, made);
+}
+
+TEST(HashSetTest, TransparentLookups) {
+	HashSet<std::string> set;
+	for (int i = 0; i < 100; ++i) {
+		set.insert("key" + std::to_string(i));
+	}
+	
+	EXPECT_TRUE(set.contains(std::string_view("key42")));
+	EXPECT_TRUE(set.contains("key0"));
+	EXPECT_FALSE(set.contains("key100"));
+	ASSERT_NE(set.find(std::string_view("key5")), nullptr);
+	EXPECT_EQ(*set.find(std::string_view("key5")), "key5");
+	std::string stored;
+	EXPECT_TRUE(set.try_get("key9", stored));
+	EXPECT_EQ(stored, "key9");
+	EXPECT_FALSE(set.try_get("key100", stored));
+	
+	HashSet<NamedKey, NamedKeyHash> named;
+	named.insert(NamedKey("a"));
+	int made = NamedKey::made;
+	EXPECT_TRUE(named.contains(std::string_view("a")));
+	EXPECT_FALSE(named.contains(std::string_view("b")));
+	EXPECT_EQ(NamedKey::made, made);
+}
+
+/**
+ * Checks find_many against find for every key, on batch sizes either side of
+ * HASHMAP_BATCH_SIZE, with some keys missing.
+ */
+template <typename Probe>
+void checkFindMany() {
+	HashMap<int, int, Probe> map;
+	for (int i = 0; i < 2000; i += 2) {
+		map.insert(i, -i);
+	}
+	std::vector<int> keys;
+	for (int i = 0; i < 1000; ++i) {
+		keys.push_back((i * 37) % 2200);
+	}
+	
+	for (size_t count : { size_t(0), size_t(1), size_t(HASHMAP_BATCH_SIZE - 1), size_t(HASHMAP_BATCH_SIZE), size_t(HASHMAP_BATCH_SIZE + 1), keys.size() }) {
+		std::vector<int*> results(count + 1, nullptr);
+		int sentinel = 0;
+		results[count] = &sentinel;
+		map.find_many(keys.data(), count, results.data());
+		for (size_t i = 0; i < count; ++i) {
+			ASSERT_EQ(results[i], map.find(keys[i])) << "key " << keys[i] << " of " << count;
+		}
+		// Nothing past the end is written
+		EXPECT_EQ(results[count], &sentinel);
+		
+		const HashMap<int, int, Probe>& constMap = map;
+		std::vector<const int*> constResults(count);
+		constMap.find_many(keys.data(), count, constResults.data());
+		for (size_t i = 0; i < count; ++i) {
+			ASSERT_EQ(constResults[i], constMap.find(keys[i]));
+		}
+	}
+}
+
+TEST(HashMapTest, FindManyMatchesFind) {
+	checkFindMany<PerturbProbe>();
+	checkFindMany<SimdProbe>();
+	
+	// A transparent hash allows batches of other types too
+	HashMap<std::string, int> map;
+	map.insert("a", 1);
+	map.insert("c", 3);
+	std::string_view names[] = { "a", "b", "c" };
+	const int* results[3];
+	static_cast<const HashMap<std::string, int>&>(map).find_many(names, 3, results);
+	ASSERT_NE(results[0], nullptr);
+	EXPECT_EQ(*results[0], 1);
+	EXPECT_EQ(results[1], nullptr);
+	ASSERT_NE(results[2], nullptr);
+	EXPECT_EQ(*results[2], 3);
+}
+
+TEST(HashSetTest, ContainsManyMatchesContains) {
+	HashSet<int> set;
+	for (int i = 0; i < 2000; i += 3) {
+		set.insert(i);
+	}
+	std::vector<int> elems;
+	for (int i = 0; i < 1000; ++i) {
+		elems.push_back((i * 41) % 2100);
+	}
+	
+	for (size_t count : { size_t(0), size_t(1), size_t(HASHSET_BATCH_SIZE - 1), size_t(HASHSET_BATCH_SIZE), size_t(HASHSET_BATCH_SIZE + 1), elems.size() }) {
+		std::unique_ptr<bool[]> results(new bool[count + 1]);
+		results[count] = true;
+		set.contains_many(elems.data(), count, results.get());
+		for (size_t i = 0; i < count; ++i) {
+			ASSERT_EQ(results[i], set.contains(elems[i])) << "element " << elems[i] << " of " << count;
+		}
+		EXPECT_TRUE(results[count]);
+	}
+	
+	HashSet<std::string> names;
+	names.insert("b");
+	const char* lookups[] = { "a", "b" };
+	bool found[2];
+	names.contains_many(lookups, 2, found);
+	EXPECT_FALSE(found[0]);
+	EXPECT_TRUE(found[1]);
+}
+
+/**
+ * Makes key-value pairs with distinct string keys in a shuffled order.
+ * @param	count	The number of pairs
+ * @return	The pairs
+ */
+std::vector<std::pair<std::string, int>> shuffledPairs(size_t count) {
+	std::vector<std::pair<std::string, int>> pairs;
+	for (size_t i = 0; i < count; ++i) {
+		pairs.emplace_back("key" + std::to_string(i), static_cast<int>(i));
+	}
+	std::shuffle(pairs.begin(), pairs.end(), std::mt19937(6));
+	return pairs;
+}
+
+TEST(HashMapTest, InsertRangeMatchesInsert) {
+	for (size_t count : { size_t(0), size_t(1), size_t(5), size_t(10000) }) {
+		std::vector<std::pair<std::string, int>> pairs = shuffledPairs(count);
+		HashMap<std::string, int> expected;
+		for (const std::pair<std::string, int>& pair : pairs) {
+			expected.insert(pair.first, pair.second);
+		}
+		
+		// A counted range grows the array once, to what reserve would give
+		HashMap<std::string, int> serial;
+		serial.insert_range(pairs.begin(), pairs.end());
+		EXPECT_TRUE(serial == expected) << count;
+		HashMap<std::string, int> reserved;
+		reserved.reserve(count);
+		EXPECT_EQ(serial.capacity(), reserved.capacity()) << count;
+		
+		std::list<std::pair<std::string, int>> list(pairs.begin(), pairs.end());
+		HashMap<std::string, int> fromList(list.begin(), list.end());
+		EXPECT_TRUE(fromList == expected) << count;
+		
+		// More threads than keys, and shares that don't divide evenly
+		for (size_t threads : { 1, 3, 4, 0 }) {
+			HashMap<std::string, int> threaded;
+			threaded.insert_range(pairs.begin(), pairs.end(), threads);
+			EXPECT_TRUE(threaded == expected) << count << " keys on " << threads << " threads";
+		}
+	}
+	
+	// Adding to a map that already has keys
+	std::vector<std::pair<std::string, int>> pairs = shuffledPairs(3000);
+	HashMap<std::string, int> map{ { "first", -1 }, { "second", -2 } };
+	map.insert_range(pairs.begin(), pairs.begin() + 1000);
+	map.insert_range(pairs.begin() + 1000, pairs.end(), 3);
+	EXPECT_EQ(map.size(), 3002u);
+	EXPECT_EQ(map.getValue("first"), -1);
+	for (const std::pair<std::string, int>& pair : pairs) {
+		EXPECT_EQ(map.getValue(pair.first), pair.second);
+	}
+}
+
+TEST(HashMapTest, InsertRangeThrowsOnDuplicates) {
+	std::vector<std::pair<std::string, int>> pairs = shuffledPairs(1000);
+	for (size_t threads : { 0, 1, 3 }) {
+		// A key already in the map
+		HashMap<std::string, int> map;
+		map.insert(pairs[500].first, -1);
+		if (threads == 0) {
+			EXPECT_THROW(map.insert_range(pairs.begin(), pairs.end()), DuplicateKeyError);
+		}
+		else {
+			EXPECT_THROW(map.insert_range(pairs.begin(), pairs.end(), threads), DuplicateKeyError);
+		}
+		
+		// Whatever was added before the duplicate is intact, and the map
+		// still works
+		EXPECT_EQ(map.getValue(pairs[500].first), -1);
+		EXPECT_GE(map.size(), 1u);
+		size_t added = 0;
+		for (const std::pair<std::string, int>& pair : pairs) {
+			const int* value = map.find(pair.first);
+			if (value != nullptr && pair.first != pairs[500].first) {
+				EXPECT_EQ(*value, pair.second);
+				++added;
+			}
+		}
+		EXPECT_EQ(map.size(), added + 1);
+		map.insert("extra", 1);
+		EXPECT_EQ(map.getValue("extra"), 1);
+	}
+	
+	// The same key twice in the range
+	pairs.push_back(pairs[10]);
+	HashMap<std::string, int> serial;
+	EXPECT_THROW(serial.insert_range(pairs.begin(), pairs.end()), DuplicateKeyError);
+	EXPECT_EQ(serial.size(), 1000u);
+	HashMap<std::string, int> threaded;
+	EXPECT_THROW(threaded.insert_range(pairs.begin(), pairs.end(), 3), DuplicateKeyError);
+	EXPECT_THROW((HashMap<std::string, int>(pairs.begin(), pairs.end())), DuplicateKeyError);
+}
+
+TEST(HashSetTest, InsertRangeMatchesInsert) {
+	std::vector<int> elems(10000);
+	for (size_t i = 0; i < elems.size(); ++i) {
+		elems[i] = static_cast<int>(i * 7);
+	}
+	std::shuffle(elems.begin(), elems.end(), std::mt19937(7));
+	HashSet<int> expected;
+	for (int elem : elems) {
+		expected.insert(elem);
+	}
+	
+	HashSet<int> serial(elems.begin(), elems.end());
+	EXPECT_TRUE(serial == expected);
+	for (size_t threads : { 1, 3, 0 }) {
+		HashSet<int> threaded;
+		threaded.insert_range(elems.begin(), elems.end(), threads);
+		EXPECT_TRUE(threaded == expected) << threads << " threads";
+	}
+	
+	// A range that can only be read once can't be counted first
+	std::istringstream stream("5 3 9 1");
+	HashSet<int> read;
+	read.insert_range(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+	EXPECT_TRUE(read == (HashSet<int>{ 1, 3, 5, 9 }));
+	
+	elems.push_back(elems[0]);
+	HashSet<int> duplicated;
+	EXPECT_THROW(duplicated.insert_range(elems.begin(), elems.end()), DuplicateElementError);
+	EXPECT_EQ(duplicated.size(), 10000u);
+	EXPECT_THROW(duplicated.insert_range(elems.begin(), elems.begin() + 1, 2), DuplicateElementError);
+	EXPECT_THROW((HashSet<int>{ 1, 2, 1 }), DuplicateElementError);
+}
@@ -0,0 +1,283 @@
+/**
+ * Fundamentals :: Tests :: Mapped Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests saving data structures to files and mapping them back in,
+ * including files that are damaged or weren't saved by this library.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "HashMap.hpp"
+#include "MappedArray.hpp"
+#include "MappedFile.hpp"
+#include "MappedHashMap.hpp"
+
+/**
+ * Makes a path for a test file in the temporary directory.
+ * @param	name	The name of the file
+ * @return	The path
+ */
+std::string testPath(const std::string& name) {
+	return ::testing::TempDir() + "fundamentals_" + name;
+}
+
+/**
+ * Writes a map file by hand, with any header, and every slot a copy of the
+ * same node.
+ * @param	path	The path to write to
+ * @param	header	The header to write
+ * @param	node	The node to fill the table with
+ * @param	slots	The number of slots to write
+ */
+void writeMapFile(const std::string& path, const MappedFile_Header& header, const HashMap_Node<int, int>& node, size_t slots) {
+	MappedFile_Writer writer(path, header);
+	
+	unsigned char image[sizeof(HashMap_Node<int, int>)];
+	node.writeImage(image);
+	for (size_t i = 0; i < slots; ++i) {
+		writer.write(image, sizeof(image));
+	}
+	
+	writer.commit();
+}
+/**
+ * Makes the header that HashMap<int, int>::save would write.
+ * @param	capacity	The number of slots
+ * @param	size	The number of keys
+ * @return	The header
+ */
+MappedFile_Header intMapHeader(size_t capacity, size_t size) {
+	return mappedFileHeader(MAPPEDFILE_KIND_HASHMAP, sizeof(HashMap_Node<int, int>), sizeof(int), sizeof(int), capacity, size, hashKey(DefaultHashFor<int>(), 0));
+}
+/**
+ * Writes a map file by hand, with every slot a copy of the same node.
+ * @param	path	The path to write to
+ * @param	node	The node to fill the table with
+ * @param	capacity	The number of slots
+ */
+void writeUniformMap(const std::string& path, const HashMap_Node<int, int>& node, size_t capacity) {
+	writeMapFile(path, intMapHeader(capacity, 0), node, capacity);
+}
+
+/**
+ * A hash that agrees with the default one for 0, which is the key the header
+ * checks, but not for other keys.
+ */
+struct ShiftedHash : DefaultHash<int> {
+	size_t operator()(int key) const {
+		return DefaultHash<int>::operator()(key) + static_cast<size_t>(key);
+	}
+};
+
+TEST(MappedHashMapTest, LookupsStopInTableOfTombstones) {
+	std::allocator<int> allocator;
+	HashMap_Node<int, int> node;
+	node.set(allocator, 1, 1, hashKey(DefaultHashFor<int>(), 1));
+	node.clear(allocator);
+	
+	// No slot has never been used, so nothing ends a search early
+	std::string path = testPath("tombstones.map");
+	writeUniformMap(path, node, 64);
+	{
+		MappedHashMap<int, int> map(path);
+		EXPECT_TRUE(map.empty());
+		EXPECT_FALSE(map.hasKey(1));
+		EXPECT_FALSE(map.hasKey(12345));
+		EXPECT_EQ(map.find(1), nullptr);
+		EXPECT_THROW(map.getValue(1), MissingKeyError);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, LookupsStopInTableOfOtherKeys) {
+	std::allocator<int> allocator;
+	HashMap_Node<int, int> node;
+	node.set(allocator, 7, 70, hashKey(DefaultHashFor<int>(), 7));
+	
+	// The header says the table is empty, but every slot holds the same key
+	std::string path = testPath("full.map");
+	writeUniformMap(path, node, 32);
+	node.clear(allocator);
+	{
+		MappedHashMap<int, int> map(path);
+		EXPECT_FALSE(map.hasKey(8));
+		EXPECT_EQ(map.find(8), nullptr);
+		EXPECT_EQ(map.getValue(7), 70);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(MappedArrayTest, RoundTrip) {
+	DynamicArray<int64_t> array;
+	for (int64_t i = 0; i < 1000; ++i) {
+		array.push_back(i * i - 500);
+	}
+	std::string path = testPath("array.map");
+	array.save(path);
+	{
+		MappedArray<int64_t> mapped(path);
+		ASSERT_EQ(mapped.size(), array.size());
+		EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), array.begin()));
+		EXPECT_EQ(mapped.front(), -500);
+		EXPECT_EQ(mapped.back(), array[999]);
+		EXPECT_EQ(mapped[10], array[10]);
+		EXPECT_THROW(mapped[1000], OutOfBoundsError);
+		
+		// The element type has to match
+		EXPECT_THROW((MappedArray<int32_t>(path)), FileFormatError);
+		EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	}
+	
+	DynamicArray<int64_t> empty;
+	empty.save(path);
+	{
+		MappedArray<int64_t> mapped(path);
+		EXPECT_TRUE(mapped.empty());
+		EXPECT_EQ(mapped.begin(), mapped.end());
+		EXPECT_THROW(mapped.front(), OutOfBoundsError);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, RoundTrip) {
+	HashMap<int, double> map;
+	for (int i = 0; i < 1000; ++i) {
+		map.insert(i * 3, i * 0.5);
+	}
+	// Removed keys leave tombstones, which are saved as they are
+	for (int i = 0; i < 1000; i += 4) {
+		map.remove(i * 3);
+	}
+	
+	std::string path = testPath("roundtrip.map");
+	map.save(path);
+	{
+		MappedHashMap<int, double> mapped(path);
+		EXPECT_EQ(mapped.size(), map.size());
+		EXPECT_EQ(mapped.capacity(), map.capacity());
+		for (int i = 0; i < 1000; ++i) {
+			const double* value = mapped.find(i * 3);
+			if (i % 4 == 0) {
+				EXPECT_EQ(value, nullptr) << i;
+			}
+			else {
+				ASSERT_NE(value, nullptr) << i;
+				EXPECT_EQ(*value, i * 0.5);
+				EXPECT_EQ(mapped.getValue(i * 3), map.getValue(i * 3));
+			}
+			EXPECT_FALSE(mapped.hasKey(i * 3 + 1));
+		}
+		
+		std::vector<int> keys = mapped.keys();
+		std::vector<int> expected = map.keys();
+		std::sort(keys.begin(), keys.end());
+		std::sort(expected.begin(), expected.end());
+		EXPECT_EQ(keys, expected);
+		EXPECT_EQ(mapped.values().size(), map.size());
+		
+		// Opening with a different hash function is caught by the first key
+		EXPECT_THROW((MappedHashMap<int, double, ShiftedHash>(path)), FileFormatError);
+	}
+	
+	HashMap<int, double> empty;
+	empty.save(path);
+	{
+		MappedHashMap<int, double> mapped(path);
+		EXPECT_TRUE(mapped.empty());
+		EXPECT_FALSE(mapped.hasKey(0));
+		// An empty table has no first key to check the hash function with
+		MappedHashMap<int, double, ShiftedHash> shifted(path);
+		EXPECT_TRUE(shifted.empty());
+	}
+	std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, RejectsBadHeaders) {
+	std::allocator<int> allocator;
+	HashMap_Node<int, int> node;
+	std::string path = testPath("bad.map");
+	
+	// A well-formed empty table opens, so each change below is what fails
+	writeMapFile(path, intMapHeader(16, 0), node, 16);
+	EXPECT_NO_THROW((MappedHashMap<int, int>(path)));
+	
+	MappedFile_Header header = intMapHeader(16, 0);
+	std::memcpy(header.magic, "NOTAMAP!", sizeof(header.magic));
+	writeMapFile(path, header, node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	header = intMapHeader(16, 0);
+	header.version = MAPPEDFILE_VERSION + 1;
+	writeMapFile(path, header, node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	header = intMapHeader(16, 0);
+	header.byteOrder = 0x04030201u;
+	writeMapFile(path, header, node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	header = intMapHeader(16, 0);
+	header.kind = MAPPEDFILE_KIND_ARRAY;
+	writeMapFile(path, header, node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// Keys and values of other sizes
+	writeMapFile(path, intMapHeader(16, 0), node, 16);
+	EXPECT_THROW((MappedHashMap<int, int64_t>(path)), FileFormatError);
+	EXPECT_THROW((MappedHashMap<int64_t, int>(path)), FileFormatError);
+	
+	// More slots than the file holds
+	writeMapFile(path, intMapHeader(32, 0), node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// A capacity that isn't a power of two can't be masked into
+	writeMapFile(path, intMapHeader(24, 0), node, 24);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	writeMapFile(path, intMapHeader(0, 0), node, 0);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// A full table has no empty slot for a search to stop at
+	writeMapFile(path, intMapHeader(16, 16), node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	writeMapFile(path, intMapHeader(16, 17), node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// A hash function that disagrees about a value-initialized key
+	header = intMapHeader(16, 0);
+	header.hashCheck ^= 1;
+	writeMapFile(path, header, node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// A table that says it has keys, but has none
+	writeMapFile(path, intMapHeader(16, 1), node, 16);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// A key saved with a hash that its hash function doesn't give
+	node.set(allocator, 5, 50, hashKey(DefaultHashFor<int>(), 5) + 1);
+	writeMapFile(path, intMapHeader(16, 1), node, 16);
+	node.clear(allocator);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	
+	// Too short to have a header at all
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	ASSERT_NE(file, nullptr);
+	std::fputs("FUNDMMAP", file);
+	std::fclose(file);
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileFormatError);
+	EXPECT_THROW((MappedArray<int>(path)), FileFormatError);
+	
+	std::remove(path.c_str());
+	EXPECT_THROW((MappedHashMap<int, int>(path)), FileError);
+	EXPECT_THROW((MappedArray<int>(path)), FileError);
+}
@@ -0,0 +1,160 @@
+/**
+ * Fundamentals :: Tests :: Mathematical Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the C++ greatest common divisor and modular inverse
+ * functions on edge cases, and the array versions against the scalar ones on
+ * sizes that leave pairs over after the last full group of lanes.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "DynamicArray.hpp"
+#include "Euclidean.hpp"
+#include "Exceptions.hpp"
+
+// They can be worked out while compiling
+static_assert(gcd(12, 18) == 6, "gcd should be constexpr");
+static_assert(binaryGcd(12, 18) == 6, "binaryGcd should be constexpr");
+
+/**
+ * Makes a random number that often has factors of two, and is sometimes 0.
+ * @param	random	The generator to use
+ * @return	The number
+ */
+uint64_t randomOperand(std::mt19937_64& random) {
+	switch (random() % 8) {
+		case 0:
+			return 0;
+		case 1:
+			return std::numeric_limits<uint64_t>::max();
+		case 2:
+			return uint64_t(1) << (random() % 64);
+		default:
+			return (random() % 1000000) << (random() % 20);
+	}
+}
+
+TEST(EuclideanTest, GcdEdgeCases) {
+	EXPECT_EQ(gcd(0, 0), 0);
+	EXPECT_EQ(gcd(0, 7), 7);
+	EXPECT_EQ(gcd(7, 0), 7);
+	EXPECT_EQ(gcd(-12, 18), 6);
+	EXPECT_EQ(gcd(12, -18), 6);
+	EXPECT_EQ(gcd(-12, -18), 6);
+	EXPECT_EQ(gcd(0, -5), 5);
+	EXPECT_EQ(gcd(uint64_t(1) << 63, uint64_t(3) << 62), uint64_t(1) << 62);
+	
+	EXPECT_EQ(binaryGcd(0, 0), 0u);
+	EXPECT_EQ(binaryGcd(0, 12), 12u);
+	EXPECT_EQ(binaryGcd(12, 0), 12u);
+	EXPECT_EQ(binaryGcd(1, std::numeric_limits<uint64_t>::max()), 1u);
+	EXPECT_EQ(binaryGcd(std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max()), std::numeric_limits<uint64_t>::max());
+	EXPECT_EQ(binaryGcd(uint64_t(1) << 63, uint64_t(1) << 40), uint64_t(1) << 40);
+	
+	std::mt19937_64 random(1);
+	for (int i = 0; i < 10000; ++i) {
+		uint64_t a = randomOperand(random);
+		uint64_t b = randomOperand(random);
+		ASSERT_EQ(binaryGcd(a, b), gcd(a, b)) << a << " " << b;
+	}
+}
+
+TEST(EuclideanTest, ExtendedGcdCoefficients) {
+	EuclideanBezout<int64_t> zero = extendedGcd<int64_t>(0, 0);
+	EXPECT_EQ(zero.divisor, 0);
+	
+	std::mt19937_64 random(2);
+	for (int i = 0; i < 10000; ++i) {
+		int64_t a = static_cast<int64_t>(random() % 2000000) - 1000000;
+		int64_t b = static_cast<int64_t>(random() % 2000000) - 1000000;
+		EuclideanBezout<int64_t> result = extendedGcd(a, b);
+		ASSERT_EQ(result.divisor, gcd(a, b)) << a << " " << b;
+		ASSERT_EQ(a * result.x + b * result.y, result.divisor) << a << " " << b;
+	}
+}
+
+TEST(EuclideanTest, ModularInverseEdgeCases) {
+	const uint64_t largest = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+	EXPECT_THROW(modularInverse(3, 0), InvalidModulusError);
+	EXPECT_THROW(modularInverse(3, largest + 1), InvalidModulusError);
+	EXPECT_THROW(modularInverse(3, std::numeric_limits<uint64_t>::max()), InvalidModulusError);
+	
+	// Every number is 0 modulo 1
+	EXPECT_EQ(modularInverse(0, 1), 0u);
+	EXPECT_EQ(modularInverse(5, 1), 0u);
+	// 0 and numbers sharing a factor with the modulus have no inverse
+	EXPECT_EQ(modularInverse(0, 7), 0u);
+	EXPECT_EQ(modularInverse(6, 9), 0u);
+	// Numbers at or above the modulus are reduced first
+	EXPECT_EQ(modularInverse(3, 7), 5u);
+	EXPECT_EQ(modularInverse(10, 7), 5u);
+	EXPECT_EQ(modularInverse(std::numeric_limits<uint64_t>::max(), 7), modularInverse(std::numeric_limits<uint64_t>::max() % 7, 7));
+	// The largest modulus allowed, which is 7 * 7 * 73 * 127 * 337 * 92737 * 649657
+	EXPECT_EQ(modularInverse(largest - 1, largest), largest - 1);
+	EXPECT_EQ(modularInverse(7, largest), 0u);
+	
+	std::mt19937_64 random(3);
+	for (uint64_t modulus : { uint64_t(2), uint64_t(1000000007), uint64_t(1) << 40, largest }) {
+		for (int i = 0; i < 1000; ++i) {
+			uint64_t value = random();
+			uint64_t inverse = modularInverse(value, modulus);
+			ASSERT_LT(inverse, modulus);
+			if (gcd(value % modulus, modulus) == 1) {
+				ASSERT_EQ(static_cast<unsigned __int128>(value % modulus) * inverse % modulus, 1u) << value << " mod " << modulus;
+			}
+			else {
+				ASSERT_EQ(inverse, 0u) << value << " mod " << modulus;
+			}
+		}
+	}
+}
+
+TEST(EuclideanTest, GcdManyMatchesScalar) {
+	// Sizes either side of each multiple of the lanes, and sizes big enough
+	// to be split between threads with some pairs over in each share
+	const size_t sizes[] = { 0, 1, EUCLIDEAN_LANES - 1, EUCLIDEAN_LANES, EUCLIDEAN_LANES + 1, 2 * EUCLIDEAN_LANES + 3, 1001, 3 * EUCLIDEAN_PARALLEL_CUTOFF + 3 };
+	std::mt19937_64 random(4);
+	for (size_t size : sizes) {
+		DynamicArray<uint64_t> a;
+		DynamicArray<uint64_t> b;
+		for (size_t i = 0; i < size; ++i) {
+			a.push_back(randomOperand(random));
+			b.push_back(randomOperand(random));
+		}
+		for (size_t threads : { 1, 3, 0 }) {
+			DynamicArray<uint64_t> divisors = gcdMany(a, b, threads);
+			ASSERT_EQ(divisors.size(), size);
+			for (size_t i = 0; i < size; ++i) {
+				ASSERT_EQ(divisors[i], gcd(a[i], b[i])) << "pair " << i << " of " << size << " with " << threads << " threads";
+			}
+		}
+	}
+	
+	DynamicArray<uint64_t> shorter(3, 1);
+	DynamicArray<uint64_t> longer(4, 1);
+	EXPECT_THROW(gcdMany(shorter, longer), OutOfBoundsError);
+}
+
+TEST(EuclideanTest, ModularInverseManyMatchesScalar) {
+	const uint64_t modulus = 1000000;
+	std::mt19937_64 random(5);
+	DynamicArray<uint64_t> values;
+	for (size_t i = 0; i < 2 * EUCLIDEAN_PARALLEL_CUTOFF + 1; ++i) {
+		values.push_back(random());
+	}
+	for (size_t threads : { 1, 2, 0 }) {
+		DynamicArray<uint64_t> inverses = modularInverseMany(values, modulus, threads);
+		ASSERT_EQ(inverses.size(), values.size());
+		for (size_t i = 0; i < values.size(); ++i) {
+			ASSERT_EQ(inverses[i], modularInverse(values[i], modulus)) << i;
+		}
+	}
+	
+	EXPECT_THROW(modularInverseMany(values, 0), InvalidModulusError);
+}
@@ -0,0 +1,212 @@
+/**
+ * Fundamentals :: Tests :: Ordered Map Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests BTreeMap, mostly how its leaves construct and destroy the
+ * entries they hold as keys move between them, and that PriorityQueue and
+ * IndexedPriorityQueue give back elements in order.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BTreeMap.hpp"
+#include "Exceptions.hpp"
+#include "PriorityQueue.hpp"
+
+/**
+ * A value with no default constructor, which counts how many are alive.
+ */
+struct CountedValue {
+	static size_t alive;
+	
+	int value;
+	
+	explicit CountedValue(int v)
+		: value(v)
+	{
+		++alive;
+	}
+	CountedValue(const CountedValue& other)
+		: value(other.value)
+	{
+		++alive;
+	}
+	CountedValue& operator=(const CountedValue& other) = default;
+	~CountedValue() {
+		--alive;
+	}
+	
+	bool operator==(const CountedValue& other) const {
+		return value == other.value;
+	}
+};
+size_t CountedValue::alive = 0;
+
+TEST(BTreeMapTest, LeavesOnlyConstructEntriesInUse) {
+	{
+		BTreeMap<int, CountedValue> map;
+		EXPECT_EQ(CountedValue::alive, 0u);
+		
+		// Enough keys to split leaves, then enough removals to merge them
+		for (int i = 0; i < 1000; ++i) {
+			map.insert(i, CountedValue(i));
+		}
+		EXPECT_EQ(CountedValue::alive, map.size());
+		for (int i = 0; i < 1000; i += 3) {
+			map.remove(i);
+		}
+		for (int i = 1; i < 1000; i += 3) {
+			map.remove(i);
+		}
+		EXPECT_EQ(CountedValue::alive, map.size());
+		
+		int expected = 2;
+		for (auto it = map.begin(); it != map.end(); ++it, expected += 3) {
+			EXPECT_EQ(it.key(), expected);
+			EXPECT_EQ(it.value().value, expected);
+		}
+		EXPECT_EQ(expected, 1001);
+		
+		BTreeMap<int, CountedValue> copy(map);
+		EXPECT_EQ(CountedValue::alive, 2 * map.size());
+		EXPECT_TRUE(copy == map);
+	}
+	
+	EXPECT_EQ(CountedValue::alive, 0u);
+}
+
+TEST(BTreeMapTest, BuildFromRangeConstructsEachEntryOnce) {
+	std::vector<std::pair<int, CountedValue>> entries;
+	for (int i = 0; i < 500; ++i) {
+		entries.emplace_back(i, CountedValue(i));
+	}
+	
+	size_t before = CountedValue::alive;
+	{
+		BTreeMap<int, CountedValue> map(entries.begin(), entries.end());
+		EXPECT_EQ(CountedValue::alive, before + map.size());
+		EXPECT_EQ(map.getValue(250).value, 250);
+	}
+	EXPECT_EQ(CountedValue::alive, before);
+}
+
+/**
+ * Pushes random values, with repeats, into a queue and checks they come
+ * back out greatest first.
+ * @param	seed	The seed for the values
+ */
+template <size_t D>
+void checkPopsInOrder(unsigned seed) {
+	std::mt19937 random(seed);
+	std::vector<int> values(1000);
+	for (int& value : values) {
+		value = static_cast<int>(random() % 300);
+	}
+	
+	// Pushing one at a time and building from a range give the same order
+	PriorityQueue<int, std::less<int>, D> pushed;
+	for (int value : values) {
+		pushed.push(value);
+	}
+	PriorityQueue<int, std::less<int>, D> built(values.begin(), values.end());
+	ASSERT_EQ(pushed.size(), values.size());
+	ASSERT_EQ(built.size(), values.size());
+	
+	std::sort(values.begin(), values.end(), std::greater<int>());
+	for (int value : values) {
+		ASSERT_EQ(pushed.top(), value) << "arity " << D;
+		ASSERT_EQ(built.top(), value) << "arity " << D;
+		pushed.pop();
+		built.pop();
+	}
+	EXPECT_TRUE(pushed.empty());
+	EXPECT_TRUE(built.empty());
+}
+
+TEST(PriorityQueueTest, PopsInOrder) {
+	checkPopsInOrder<2>(1);
+	checkPopsInOrder<3>(2);
+	checkPopsInOrder<4>(3);
+	checkPopsInOrder<8>(4);
+	
+	// With std::greater the least is on top, and pops interleave with pushes
+	PriorityQueue<int, std::greater<int>> queue{ 5, 1, 4 };
+	EXPECT_EQ(queue.top(), 1);
+	queue.pop();
+	queue.push(0);
+	queue.emplace(3);
+	for (int expected : { 0, 3, 4, 5 }) {
+		EXPECT_EQ(queue.top(), expected);
+		queue.pop();
+	}
+	EXPECT_THROW(queue.top(), OutOfBoundsError);
+	EXPECT_THROW(queue.pop(), OutOfBoundsError);
+}
+
+TEST(IndexedPriorityQueueTest, DecreaseKeyMatchesReference) {
+	// The reference maps each item in the queue to its priority
+	const size_t capacity = 200;
+	IndexedPriorityQueue<int, std::greater<int>, 3> queue(capacity);
+	std::map<size_t, int> priorities;
+	std::mt19937 random(5);
+	
+	for (int step = 0; step < 20000; ++step) {
+		size_t index = random() % capacity;
+		int priority = static_cast<int>(random() % 1000);
+		switch (random() % 3) {
+			case 0:
+				if (priorities.count(index) == 0) {
+					queue.push(index, priority);
+					priorities[index] = priority;
+				}
+				else {
+					EXPECT_THROW(queue.push(index, priority), DuplicateKeyError);
+				}
+				break;
+			case 1:
+				// Either direction, since decrease_key handles both
+				if (priorities.count(index) != 0) {
+					queue.decrease_key(index, priority);
+					priorities[index] = priority;
+				}
+				else {
+					EXPECT_THROW(queue.decrease_key(index, priority), MissingKeyError);
+				}
+				break;
+			default:
+				if (!priorities.empty()) {
+					// Items with equal priorities can come out in any order
+					int least = priorities.begin()->second;
+					for (const std::pair<const size_t, int>& entry : priorities) {
+						least = std::min(least, entry.second);
+					}
+					ASSERT_EQ(queue.top_priority(), least);
+					ASSERT_EQ(priorities[queue.top()], least);
+					priorities.erase(queue.top());
+					queue.pop();
+				}
+				break;
+		}
+		
+		ASSERT_EQ(queue.size(), priorities.size());
+		ASSERT_EQ(queue.contains(index), priorities.count(index) != 0);
+		if (priorities.count(index) != 0) {
+			ASSERT_EQ(queue.priority(index), priorities[index]);
+		}
+	}
+	
+	EXPECT_THROW(queue.contains(capacity), OutOfBoundsError);
+	EXPECT_THROW(queue.push(capacity, 0), OutOfBoundsError);
+	while (!queue.empty()) {
+		queue.pop();
+	}
+	EXPECT_THROW(queue.top(), OutOfBoundsError);
+}
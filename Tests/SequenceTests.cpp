@@ -0,0 +1,551 @@
+/**
+ * Fundamentals :: Tests :: Sequence Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the sequence containers, mostly the ways of moving nodes
+ * and memory around that are easy to get wrong at the edges.
+ */
+
+#include <deque>
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// The tests are built with optimizations, which turn the checks off by default
+#define INTRUSIVELIST_CHECK_OWNERS 1
+
+#include "CircularArray.hpp"
+#include "DynamicArray.hpp"
+#include "IntrusiveList.hpp"
+#include "LinkedList.hpp"
+#include "SmallArray.hpp"
+#include "UnrolledList.hpp"
+#include "TestAllocators.hpp"
+
+/**
+ * Walks a list from front to back, giving up after a limit so that a list
+ * with a cycle in it fails the test instead of hanging it.
+ * @param	list	The list to walk
+ * @return	The elements, in order
+ */
+template <typename List>
+std::vector<int> contents(const List& list) {
+	std::vector<int> values;
+	for (auto it = list.begin(); it != list.end() && values.size() <= list.size(); ++it) {
+		values.push_back(*it);
+	}
+	return values;
+}
+
+TEST(LinkedListTest, SpliceElementInFrontOfItselfDoesNothing) {
+	LinkedList<int> list;
+	for (int i = 1; i <= 3; ++i) {
+		list.push_back(i);
+	}
+	
+	list.splice(list.begin(), list, list.begin());
+	EXPECT_EQ(contents(list), (std::vector<int>{ 1, 2, 3 }));
+	
+	LinkedList<int>::iterator last = list.begin();
+	++last;
+	++last;
+	list.splice(last, list, last);
+	EXPECT_EQ(contents(list), (std::vector<int>{ 1, 2, 3 }));
+	EXPECT_EQ(list.size(), 3u);
+}
+
+TEST(LinkedListTest, SpliceElementInFrontOfNextDoesNothing) {
+	LinkedList<int> list;
+	for (int i = 1; i <= 3; ++i) {
+		list.push_back(i);
+	}
+	
+	LinkedList<int>::iterator second = list.begin();
+	++second;
+	list.splice(second, list, list.begin());
+	EXPECT_EQ(contents(list), (std::vector<int>{ 1, 2, 3 }));
+	
+	LinkedList<int>::iterator last = second;
+	++last;
+	list.splice(list.end(), list, last);
+	EXPECT_EQ(contents(list), (std::vector<int>{ 1, 2, 3 }));
+}
+
+TEST(LinkedListTest, SpliceElementMovesToFront) {
+	LinkedList<int> list;
+	for (int i = 1; i <= 3; ++i) {
+		list.push_back(i);
+	}
+	
+	LinkedList<int>::iterator last = list.begin();
+	++last;
+	++last;
+	list.splice(list.begin(), list, last);
+	EXPECT_EQ(contents(list), (std::vector<int>{ 3, 1, 2 }));
+	EXPECT_EQ(list.back(), 2);
+}
+
+TEST(LinkedListTest, SpliceRangeInFrontOfItselfDoesNothing) {
+	LinkedList<int> list;
+	for (int i = 1; i <= 4; ++i) {
+		list.push_back(i);
+	}
+	
+	LinkedList<int>::iterator first = list.begin();
+	++first;
+	list.splice(first, list, first, list.end());
+	EXPECT_EQ(contents(list), (std::vector<int>{ 1, 2, 3, 4 }));
+}
+
+TEST(LinkedListTest, SpliceWholeList) {
+	LinkedList<int> a;
+	LinkedList<int> b;
+	for (int i = 1; i <= 2; ++i) {
+		a.push_back(i);
+		b.push_back(i + 2);
+	}
+	
+	LinkedList<int>::iterator second = a.begin();
+	++second;
+	a.splice(second, b);
+	EXPECT_EQ(contents(a), (std::vector<int>{ 1, 3, 4, 2 }));
+	EXPECT_EQ(a.size(), 4u);
+	EXPECT_EQ(b.size(), 0u);
+	EXPECT_EQ(b.begin(), b.end());
+	
+	b.push_back(5);
+	a.splice(a.end(), b);
+	EXPECT_EQ(contents(a), (std::vector<int>{ 1, 3, 4, 2, 5 }));
+	EXPECT_EQ(a.back(), 5);
+	
+	a.splice(a.begin(), a);
+	EXPECT_EQ(a.size(), 5u);
+}
+
+TEST(LinkedListTest, MoveAssignTakesPropagatingAllocator) {
+	AllocatorCounts counts;
+	{
+		typedef PropagatingAllocator<int> Allocator;
+		LinkedList<int, Allocator> list((Allocator(&counts, 1)));
+		LinkedList<int, Allocator> other((Allocator(&counts, 2)));
+		list.push_back(0);
+		for (int i = 1; i <= 3; ++i) {
+			other.push_back(i);
+		}
+		
+		size_t constructs = counts.constructs;
+		list = std::move(other);
+		EXPECT_EQ(counts.constructs, constructs);
+		EXPECT_EQ(list.get_allocator().id(), 2);
+		EXPECT_EQ(contents(list), (std::vector<int>{ 1, 2, 3 }));
+	}
+	
+	EXPECT_EQ(counts.constructs, counts.destroys);
+	EXPECT_EQ(counts.allocations, counts.deallocations);
+}
+
+TEST(DynamicArrayTest, MoveAssignTakesPropagatingAllocator) {
+	AllocatorCounts counts;
+	{
+		typedef PropagatingAllocator<int> Allocator;
+		DynamicArray<int, Allocator> array((Allocator(&counts, 1)));
+		DynamicArray<int, Allocator> other((Allocator(&counts, 2)));
+		array.push_back(0);
+		for (int i = 1; i <= 3; ++i) {
+			other.push_back(i);
+		}
+		
+		size_t constructs = counts.constructs;
+		array = std::move(other);
+		EXPECT_EQ(counts.constructs, constructs);
+		EXPECT_EQ(array.get_allocator().id(), 2);
+		EXPECT_EQ(contents(array), (std::vector<int>{ 1, 2, 3 }));
+	}
+	
+	EXPECT_EQ(counts.constructs, counts.destroys);
+	EXPECT_EQ(counts.allocations, counts.deallocations);
+}
+
+/**
+ * An object that can be put into an IntrusiveList.
+ */
+struct Linkable {
+	int value;
+	IntrusiveList_Hook<Linkable> hook;
+};
+typedef IntrusiveList<Linkable, &Linkable::hook> LinkableList;
+
+TEST(IntrusiveListTest, RemoveUnlinkedObjectThrows) {
+	Linkable a{ 1, {} };
+	Linkable b{ 2, {} };
+	Linkable loose{ 3, {} };
+	
+	LinkableList empty;
+	EXPECT_THROW(empty.remove(loose), MismatchedObjectError);
+	EXPECT_EQ(empty.size(), 0u);
+	
+	LinkableList list;
+	list.push_back(a);
+	list.push_back(b);
+	EXPECT_THROW(list.remove(loose), MismatchedObjectError);
+	EXPECT_EQ(list.size(), 2u);
+	EXPECT_EQ(&list.front(), &a);
+	EXPECT_EQ(&list.back(), &b);
+	
+	// The ends of another list can't be in this one either
+	LinkableList other;
+	EXPECT_THROW(other.remove(a), MismatchedObjectError);
+	EXPECT_THROW(other.remove(b), MismatchedObjectError);
+	
+	list.remove(a);
+	list.remove(b);
+	EXPECT_TRUE(list.empty());
+	EXPECT_THROW(list.remove(a), MismatchedObjectError);
+}
+
+TEST(IntrusiveListTest, LinkLinkedObjectThrows) {
+	Linkable a{ 1, {} };
+	Linkable b{ 2, {} };
+	
+	LinkableList list;
+	list.push_back(a);
+	EXPECT_THROW(list.push_back(a), MismatchedObjectError);
+	EXPECT_THROW(list.push_front(a), MismatchedObjectError);
+	EXPECT_THROW(list.insert(list.end(), a), MismatchedObjectError);
+	
+	list.push_front(b);
+	LinkableList other;
+	EXPECT_THROW(other.push_back(a), MismatchedObjectError);
+	EXPECT_THROW(other.push_front(b), MismatchedObjectError);
+	
+	EXPECT_EQ(list.size(), 2u);
+	EXPECT_EQ(other.size(), 0u);
+	
+	// Once unlinked, an object can be linked in again
+	list.remove(a);
+	other.push_back(a);
+	EXPECT_EQ(&other.front(), &a);
+	other.clear();
+	list.clear();
+}
+
+TEST(LinkedListTest, DereferenceEndThrows) {
+	LinkedList<std::string> list;
+	EXPECT_THROW(*list.end(), OutOfBoundsError);
+	EXPECT_THROW(list.end()->size(), OutOfBoundsError);
+	
+	list.push_back("value");
+	const LinkedList<std::string>& view = list;
+	EXPECT_EQ(*view.begin(), "value");
+	EXPECT_THROW(*view.end(), OutOfBoundsError);
+	EXPECT_THROW(view.end()->size(), OutOfBoundsError);
+}
+
+TEST(IntrusiveListTest, DereferenceEndThrows) {
+	Linkable a{ 1, {} };
+	LinkableList list;
+	EXPECT_THROW(*list.end(), OutOfBoundsError);
+	EXPECT_THROW(list.end()->value, OutOfBoundsError);
+	
+	list.push_back(a);
+	const LinkableList& view = list;
+	EXPECT_EQ(view.begin()->value, 1);
+	EXPECT_THROW(*view.end(), OutOfBoundsError);
+	EXPECT_THROW(view.end()->value, OutOfBoundsError);
+	list.clear();
+}
+
+TEST(CircularArrayTest, GrowsWhileWrappedAround) {
+	CircularArray<std::string> array;
+	std::deque<std::string> reference;
+	
+	// Pushing on both ends leaves the elements split across the end of the
+	// buffer each time it grows
+	for (int i = 0; i < 200; ++i) {
+		if (i % 3 == 0) {
+			array.push_back(std::to_string(i));
+			reference.push_back(std::to_string(i));
+		}
+		else {
+			array.push_front(std::to_string(i));
+			reference.push_front(std::to_string(i));
+		}
+		ASSERT_EQ(array.size(), reference.size());
+		EXPECT_EQ(array.front(), reference.front());
+		EXPECT_EQ(array.back(), reference.back());
+	}
+	EXPECT_GE(array.capacity(), 200u);
+	
+	for (size_t i = 0; i < reference.size(); ++i) {
+		EXPECT_EQ(array[i], reference[i]);
+	}
+	size_t index = 0;
+	for (const std::string& value : array) {
+		EXPECT_EQ(value, reference[index++]);
+	}
+	EXPECT_EQ(index, reference.size());
+	
+	// Wrap the head around again after popping, then grow from there
+	for (int i = 0; i < 150; ++i) {
+		array.pop_back();
+		reference.pop_back();
+	}
+	for (int i = 0; i < 300; ++i) {
+		array.push_front(std::to_string(-i));
+		reference.push_front(std::to_string(-i));
+	}
+	ASSERT_EQ(array.size(), reference.size());
+	for (size_t i = 0; i < reference.size(); ++i) {
+		EXPECT_EQ(array[i], reference[i]);
+	}
+}
+
+TEST(CircularArrayTest, InsertAndRemoveInMiddle) {
+	CircularArray<std::string> array;
+	std::vector<std::string> reference;
+	std::mt19937 random(5);
+	
+	for (int i = 0; i < 2000; ++i) {
+		size_t index = reference.empty() ? 0 : random() % (reference.size() + 1);
+		if (reference.size() > 8 && random() % 3 == 0) {
+			index = random() % reference.size();
+			array.remove(array.begin() + static_cast<std::ptrdiff_t>(index));
+			reference.erase(reference.begin() + static_cast<std::ptrdiff_t>(index));
+		}
+		else if (random() % 8 == 0) {
+			// Move the head along so that later shifts have to wrap around
+			array.pop_front();
+			reference.erase(reference.begin());
+			array.push_back(std::to_string(i));
+			reference.push_back(std::to_string(i));
+		}
+		else {
+			array.insert(array.begin() + static_cast<std::ptrdiff_t>(index), std::to_string(i));
+			reference.insert(reference.begin() + static_cast<std::ptrdiff_t>(index), std::to_string(i));
+		}
+		ASSERT_EQ(array.size(), reference.size());
+	}
+	
+	for (size_t i = 0; i < reference.size(); ++i) {
+		EXPECT_EQ(array[i], reference[i]);
+	}
+	
+	// The end is a valid place to insert, and removing the last element
+	// leaves an array that can be filled again
+	array.insert(array.end(), "end");
+	EXPECT_EQ(array.back(), "end");
+	while (!array.empty()) {
+		array.remove(array.begin() + static_cast<std::ptrdiff_t>(array.size() / 2));
+	}
+	array.insert(array.begin(), "only");
+	EXPECT_EQ(array.size(), 1u);
+	EXPECT_EQ(array.front(), "only");
+}
+
+/**
+ * Makes a string too long for the small string optimization, so that a
+ * leaked or doubly destroyed element shows up under the sanitizers.
+ * @param	i	The number to put in the string
+ * @return	The string
+ */
+std::string longString(int i) {
+	return "a string long enough to be on the heap: " + std::to_string(i);
+}
+
+TEST(SmallArrayTest, SpillsFromInlineToHeap) {
+	SmallArray<std::string, 4> array;
+	EXPECT_TRUE(array.isInline());
+	EXPECT_EQ(array.capacity(), 4u);
+	
+	for (int i = 0; i < 4; ++i) {
+		array.push_back(longString(i));
+	}
+	EXPECT_TRUE(array.isInline());
+	
+	// The new element refers to one that is about to be moved
+	array.push_back(array[0]);
+	EXPECT_FALSE(array.isInline());
+	EXPECT_GT(array.capacity(), 4u);
+	ASSERT_EQ(array.size(), 5u);
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(array[i], longString(i));
+	}
+	EXPECT_EQ(array.back(), longString(0));
+	
+	// Shrinking doesn't move back into the inline space
+	while (array.size() > 1) {
+		array.pop_back();
+	}
+	EXPECT_FALSE(array.isInline());
+	EXPECT_EQ(array.front(), longString(0));
+	
+	// Inserting in the middle spills just the same
+	SmallArray<std::string, 4> inserted;
+	for (int i = 0; i < 6; ++i) {
+		inserted.insert(inserted.begin() + inserted.size() / 2, longString(i));
+	}
+	EXPECT_FALSE(inserted.isInline());
+	const int expected[] = { 1, 3, 5, 4, 2, 0 };
+	for (int i = 0; i < 6; ++i) {
+		EXPECT_EQ(inserted[i], longString(expected[i]));
+	}
+	inserted.remove(inserted.begin() + 2);
+	inserted.remove(inserted.begin());
+	EXPECT_EQ(inserted.front(), longString(3));
+	EXPECT_EQ(inserted.size(), 4u);
+}
+
+TEST(SmallArrayTest, MoveInlineAndSpilled) {
+	SmallArray<std::string, 4> small;
+	small.push_back(longString(1));
+	small.push_back(longString(2));
+	
+	// Inline elements are moved one at a time
+	SmallArray<std::string, 4> movedSmall(std::move(small));
+	EXPECT_TRUE(movedSmall.isInline());
+	ASSERT_EQ(movedSmall.size(), 2u);
+	EXPECT_EQ(movedSmall[1], longString(2));
+	EXPECT_TRUE(small.empty());
+	EXPECT_TRUE(small.isInline());
+	small.push_back(longString(3));
+	EXPECT_EQ(small.front(), longString(3));
+	
+	// Heap memory is handed over as it is
+	SmallArray<std::string, 4> large;
+	for (int i = 0; i < 10; ++i) {
+		large.push_back(longString(i));
+	}
+	const std::string* data = &large[0];
+	SmallArray<std::string, 4> movedLarge(std::move(large));
+	EXPECT_FALSE(movedLarge.isInline());
+	EXPECT_EQ(&movedLarge[0], data);
+	EXPECT_EQ(movedLarge.size(), 10u);
+	EXPECT_TRUE(large.empty());
+	EXPECT_TRUE(large.isInline());
+	EXPECT_EQ(large.capacity(), 4u);
+	
+	// Assignment in each direction between inline and spilled arrays
+	movedSmall = std::move(movedLarge);
+	EXPECT_FALSE(movedSmall.isInline());
+	EXPECT_EQ(&movedSmall[0], data);
+	EXPECT_TRUE(movedLarge.isInline());
+	
+	movedSmall = std::move(small);
+	EXPECT_TRUE(movedSmall.isInline());
+	ASSERT_EQ(movedSmall.size(), 1u);
+	EXPECT_EQ(movedSmall[0], longString(3));
+	
+	SmallArray<std::string, 4> copy(movedSmall);
+	EXPECT_TRUE(copy == movedSmall);
+	for (int i = 0; i < 8; ++i) {
+		copy.push_back(longString(i));
+	}
+	movedSmall = copy;
+	EXPECT_TRUE(copy == movedSmall);
+	EXPECT_FALSE(movedSmall.isInline());
+}
+
+TEST(UnrolledListTest, InsertSplitsNodes) {
+	// Small nodes, so that a few elements are enough to split them
+	UnrolledList<std::string, 4> list;
+	std::list<std::string> reference;
+	
+	// Insert each value in the middle, keeping the returned iterator
+	auto it = list.begin();
+	auto referenceIt = reference.begin();
+	for (int i = 0; i < 100; ++i) {
+		it = list.insert(it, longString(i));
+		referenceIt = reference.insert(referenceIt, longString(i));
+		ASSERT_EQ(*it, longString(i));
+		
+		// Walk the returned iterator a little way to a new place to insert
+		for (int step = 0; step < i % 3 && referenceIt != reference.end(); ++step) {
+			++it;
+			++referenceIt;
+		}
+		EXPECT_EQ(it == list.end(), referenceIt == reference.end());
+	}
+	
+	ASSERT_EQ(list.size(), reference.size());
+	EXPECT_TRUE(std::equal(list.begin(), list.end(), reference.begin()));
+	
+	// Walk backwards too, through every node boundary
+	auto backward = list.end();
+	for (auto referenceBackward = reference.rbegin(); referenceBackward != reference.rend(); ++referenceBackward) {
+		--backward;
+		EXPECT_EQ(*backward, *referenceBackward);
+	}
+	EXPECT_TRUE(backward == list.begin());
+}
+
+TEST(UnrolledListTest, RemoveMergesNodes) {
+	UnrolledList<std::string, 4> list;
+	std::list<std::string> reference;
+	for (int i = 0; i < 200; ++i) {
+		list.push_back(longString(i));
+		reference.push_back(longString(i));
+	}
+	
+	// Remove in runs, which leaves nodes short enough to borrow from or
+	// merge with their neighbours, following the returned iterators
+	std::mt19937 random(9);
+	auto it = list.begin();
+	auto referenceIt = reference.begin();
+	while (!reference.empty()) {
+		if (referenceIt == reference.end()) {
+			it = list.begin();
+			referenceIt = reference.begin();
+		}
+		if (random() % 3 == 0) {
+			++it;
+			++referenceIt;
+		}
+		else {
+			it = list.remove(it);
+			referenceIt = reference.erase(referenceIt);
+		}
+		ASSERT_EQ(list.size(), reference.size());
+		ASSERT_EQ(it == list.end(), referenceIt == reference.end());
+		if (referenceIt != reference.end()) {
+			ASSERT_EQ(*it, *referenceIt);
+		}
+		if (reference.size() % 16 == 0) {
+			ASSERT_TRUE(std::equal(list.begin(), list.end(), reference.begin(), reference.end()));
+		}
+	}
+	
+	EXPECT_TRUE(list.empty());
+	EXPECT_TRUE(list.begin() == list.end());
+	list.push_front(longString(1));
+	EXPECT_EQ(list.back(), longString(1));
+}
+
+TEST(UnrolledListTest, InsertAndRemoveMatchList) {
+	UnrolledList<int, 4> list;
+	std::list<int> reference;
+	std::mt19937 random(13);
+	
+	for (int i = 0; i < 3000; ++i) {
+		size_t index = reference.empty() ? 0 : random() % (reference.size() + (i < 1500 ? 1 : 0));
+		auto it = std::next(list.begin(), static_cast<std::ptrdiff_t>(index));
+		auto referenceIt = std::next(reference.begin(), static_cast<std::ptrdiff_t>(index));
+		
+		if (random() % 2 == 0 && referenceIt != reference.end()) {
+			it = list.remove(it);
+			referenceIt = reference.erase(referenceIt);
+		}
+		else {
+			it = list.insert(it, i);
+			referenceIt = reference.insert(referenceIt, i);
+		}
+		ASSERT_EQ(it == list.end(), referenceIt == reference.end());
+		ASSERT_EQ(std::distance(list.begin(), it), std::distance(reference.begin(), referenceIt));
+	}
+	
+	ASSERT_EQ(list.size(), reference.size());
+	EXPECT_TRUE(std::equal(list.begin(), list.end(), reference.begin(), reference.end()));
+}
@@ -0,0 +1,174 @@
+/**
+ * Fundamentals :: Tests :: Sorting Tests
+ * Author: Quinn Mortimer
+ *
+ * This file tests the C++ sorting algorithms against std::stable_sort, on
+ * sizes around each algorithm's cutoffs, and checks that the merge sorts
+ * keep equal elements in order.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DynamicArray.hpp"
+#include "Sorting.hpp"
+
+/**
+ * An element with a key to sort by, and its position in the input to check
+ * stability with.
+ */
+struct Record {
+	int key;
+	size_t order;
+	
+	bool operator==(const Record& other) const {
+		return key == other.key && order == other.order;
+	}
+};
+struct ByKey {
+	bool operator()(const Record& left, const Record& right) const {
+		return left.key < right.key;
+	}
+};
+
+/**
+ * Makes records with few distinct keys, so that there are lots of ties.
+ * @param	size	The number of records
+ * @param	seed	The seed for the keys
+ * @return	The records, in input order
+ */
+std::vector<Record> makeRecords(size_t size, unsigned seed) {
+	std::mt19937 random(seed);
+	std::vector<Record> records(size);
+	for (size_t i = 0; i < size; ++i) {
+		records[i] = Record{ static_cast<int>(random() % 50) - 25, i };
+	}
+	return records;
+}
+/**
+ * Sorts records the way a stable sort must.
+ * @param	records	The records to sort
+ * @return	The sorted records
+ */
+std::vector<Record> stableSorted(std::vector<Record> records) {
+	std::stable_sort(records.begin(), records.end(), ByKey());
+	return records;
+}
+
+// The sizes to try: empty, tiny, either side of the insertion sort cutoff,
+// and large enough for several levels of merges and partitions
+const size_t sortSizes[] = { 0, 1, 2, 3, SORTING_INSERTION_CUTOFF - 1, SORTING_INSERTION_CUTOFF, SORTING_INSERTION_CUTOFF + 1, 100, 1000, 4097 };
+
+TEST(SortingTest, UnstableSortsMatchStdSort) {
+	for (size_t size : sortSizes) {
+		std::vector<Record> expected = stableSorted(makeRecords(size, 1));
+		
+		std::vector<Record> records = makeRecords(size, 1);
+		introsort(records.begin(), records.end(), ByKey());
+		ASSERT_TRUE(std::is_sorted(records.begin(), records.end(), ByKey())) << size;
+		std::sort(records.begin(), records.end(), [](const Record& left, const Record& right) { return left.order < right.order; });
+		EXPECT_EQ(records, makeRecords(size, 1)) << "introsort lost elements at size " << size;
+		
+		records = makeRecords(size, 1);
+		heapSort(records.begin(), records.end(), ByKey());
+		ASSERT_TRUE(std::is_sorted(records.begin(), records.end(), ByKey())) << size;
+		
+		std::vector<int> keys(size);
+		std::vector<int> expectedKeys(size);
+		for (size_t i = 0; i < size; ++i) {
+			keys[i] = makeRecords(size, 1)[i].key;
+			expectedKeys[i] = expected[i].key;
+		}
+		introsort(keys.begin(), keys.end());
+		EXPECT_EQ(keys, expectedKeys) << size;
+	}
+}
+
+TEST(SortingTest, IntrosortHandlesAdversarialInputs) {
+	// Already sorted, reversed, all equal and organ pipe inputs
+	std::vector<std::vector<int>> inputs(4, std::vector<int>(10000));
+	for (int i = 0; i < 10000; ++i) {
+		inputs[0][i] = i;
+		inputs[1][i] = 10000 - i;
+		inputs[2][i] = 7;
+		inputs[3][i] = i < 5000 ? i : 10000 - i;
+	}
+	for (std::vector<int>& input : inputs) {
+		std::vector<int> expected = input;
+		std::sort(expected.begin(), expected.end());
+		introsort(input.begin(), input.end());
+		EXPECT_EQ(input, expected);
+	}
+}
+
+TEST(SortingTest, MergeSortsAreStable) {
+	for (size_t size : sortSizes) {
+		std::vector<Record> expected = stableSorted(makeRecords(size, 2));
+		
+		std::vector<Record> records = makeRecords(size, 2);
+		insertionSort(records.begin(), records.end(), ByKey());
+		EXPECT_EQ(records, expected) << "insertionSort at size " << size;
+		
+		records = makeRecords(size, 2);
+		mergeSort(records.begin(), records.end(), ByKey());
+		EXPECT_EQ(records, expected) << "mergeSort at size " << size;
+		
+		records = makeRecords(size, 2);
+		parallelMergeSort(records.begin(), records.end(), 4, ByKey());
+		EXPECT_EQ(records, expected) << "parallelMergeSort at size " << size;
+	}
+}
+
+TEST(SortingTest, ParallelMergeSortWithUnevenShares) {
+	// Thread counts that don't divide the size, or the number of runs, evenly
+	const size_t size = SORTING_PARALLEL_CUTOFF * 7 + 12345;
+	std::vector<Record> expected = stableSorted(makeRecords(size, 3));
+	
+	for (size_t threads : { 2, 3, 5, 7, 0 }) {
+		std::vector<Record> records = makeRecords(size, 3);
+		parallelMergeSort(records.begin(), records.end(), threads, ByKey());
+		EXPECT_EQ(records, expected) << threads << " threads";
+	}
+	
+	// A DynamicArray's iterators work the same way
+	DynamicArray<int> array;
+	for (size_t i = 0; i < size; ++i) {
+		array.push_back(static_cast<int>((i * 7919) % 100003));
+	}
+	parallelMergeSort(array.begin(), array.end(), 3);
+	EXPECT_TRUE(std::is_sorted(array.begin(), array.end()));
+}
+
+TEST(SortingTest, RadixSortIntegers) {
+	std::mt19937_64 random(4);
+	for (size_t size : { size_t(0), size_t(5), size_t(SORTING_INSERTION_CUTOFF + 1), size_t(10000) }) {
+		std::vector<int64_t> signedValues(size);
+		std::vector<uint32_t> smallValues(size);
+		for (size_t i = 0; i < size; ++i) {
+			signedValues[i] = static_cast<int64_t>(random());
+			smallValues[i] = static_cast<uint32_t>(random() % 1000);
+		}
+		if (size > 2) {
+			signedValues[0] = std::numeric_limits<int64_t>::min();
+			signedValues[1] = std::numeric_limits<int64_t>::max();
+			signedValues[2] = -1;
+		}
+		
+		std::vector<int64_t> expectedSigned = signedValues;
+		std::sort(expectedSigned.begin(), expectedSigned.end());
+		radixSort(signedValues.begin(), signedValues.end());
+		EXPECT_EQ(signedValues, expectedSigned) << size;
+		
+		// Only the low bytes differ, so the high passes are skipped
+		std::vector<uint32_t> expectedSmall = smallValues;
+		std::sort(expectedSmall.begin(), expectedSmall.end());
+		radixSort(smallValues.begin(), smallValues.end());
+		EXPECT_EQ(smallValues, expectedSmall) << size;
+	}
+}
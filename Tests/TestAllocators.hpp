@@ -0,0 +1,114 @@
+/**
+ * Fundamentals :: Tests :: Test Allocators
+ * Author: Quinn Mortimer
+ *
+ * This file contains an allocator for the tests that counts what the
+ * containers do with it.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifndef Fundamentals_TestAllocators_hpp_
+#define Fundamentals_TestAllocators_hpp_
+
+/**
+ * The counts kept by a CountingAllocator and all of its copies.
+ */
+struct AllocatorCounts {
+	size_t constructs = 0;
+	size_t destroys = 0;
+	size_t allocations = 0;
+	size_t deallocations = 0;
+};
+
+/**
+ * An allocator that counts every call made to it.
+ *
+ * Each allocator has an id, and two allocators are only equal when their ids
+ * are, as with allocators from two different memory resources. Rebound
+ * copies share the id and the counts of the allocator they came from.
+ */
+template <typename T>
+class CountingAllocator {
+	public:
+		typedef T value_type;
+		
+		CountingAllocator(AllocatorCounts* counts, int id = 0)
+			: mp_counts(counts), m_id(id)
+		{}
+		template <typename U>
+		CountingAllocator(const CountingAllocator<U>& other)
+			: mp_counts(other.mp_counts), m_id(other.m_id)
+		{}
+		
+		T* allocate(size_t count) {
+			++mp_counts->allocations;
+			return std::allocator<T>().allocate(count);
+		}
+		void deallocate(T* pointer, size_t count) {
+			++mp_counts->deallocations;
+			std::allocator<T>().deallocate(pointer, count);
+		}
+		
+		template <typename U, typename... Args>
+		void construct(U* pointer, Args&&... args) {
+			++mp_counts->constructs;
+			::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+		}
+		template <typename U>
+		void destroy(U* pointer) {
+			++mp_counts->destroys;
+			pointer->~U();
+		}
+		
+		int id() const {
+			return m_id;
+		}
+		
+		template <typename U>
+		bool operator==(const CountingAllocator<U>& other) const {
+			return m_id == other.m_id;
+		}
+		template <typename U>
+		bool operator!=(const CountingAllocator<U>& other) const {
+			return m_id != other.m_id;
+		}
+		
+	private:
+		template <typename U> friend class CountingAllocator;
+		
+		AllocatorCounts* mp_counts;
+		int m_id;
+};
+
+/**
+ * A CountingAllocator that moves and swaps along with the container using it.
+ *
+ * With both propagate traits set, a container that is move-assigned or
+ * swapped should take the other container's allocator, rather than keeping
+ * its own and moving the elements one at a time.
+ */
+template <typename T>
+class PropagatingAllocator : public CountingAllocator<T> {
+	public:
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+		
+		template <typename U>
+		struct rebind {
+			typedef PropagatingAllocator<U> other;
+		};
+		
+		PropagatingAllocator(AllocatorCounts* counts, int id = 0)
+			: CountingAllocator<T>(counts, id)
+		{}
+		template <typename U>
+		PropagatingAllocator(const PropagatingAllocator<U>& other)
+			: CountingAllocator<T>(other)
+		{}
+};
+
+#endif // Fundamentals_TestAllocators_hpp_